@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "lib/allocator/ob_hugepage_arena.h"
+#include <sys/mman.h>
+#include "lib/utility/utility.h"
+#include "lib/oblog/ob_log.h"
+
+namespace oceanbase
+{
+namespace common
+{
+
+ObHugePageArena::ObHugePageArena()
+  : is_inited_(false), enable_hugetlb_(true), base_(NULL), limit_(0),
+    reserved_(NULL), reserved_size_(0), block_class_(NULL), pos_(NULL),
+    segment_end_(NULL), hold_(0), used_(0), block_count_(0), hugetlb_segment_count_(0),
+    lock_()
+{
+  MEMSET(free_list_, 0, sizeof(free_list_));
+}
+
+ObHugePageArena &ObHugePageArena::get_instance()
+{
+  static ObHugePageArena arena;
+  return arena;
+}
+
+int ObHugePageArena::init(const int64_t arena_size)
+{
+  int ret = OB_SUCCESS;
+  const int64_t limit = upper_align(arena_size, SEGMENT_SIZE);
+  const int64_t reserved_size = limit + SEGMENT_SIZE;
+  const int64_t class_map_size = limit >> MIN_BLOCK_SHIFT;
+  void *reserved = MAP_FAILED;
+  void *class_map = MAP_FAILED;
+  if (OB_UNLIKELY(is_inited_)) {
+    ret = OB_INIT_TWICE;
+    OB_LOG(WARN, "hugepage arena init twice", K(ret));
+  } else if (OB_UNLIKELY(arena_size <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    OB_LOG(WARN, "invalid argument", K(arena_size), K(ret));
+  } else if (MAP_FAILED == (reserved = ::mmap(NULL, reserved_size, PROT_NONE,
+                                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    OB_LOG(WARN, "fail to reserve hugepage arena", K(reserved_size), K(errno), K(ret));
+  } else if (MAP_FAILED == (class_map = ::mmap(NULL, class_map_size, PROT_READ | PROT_WRITE,
+                                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    OB_LOG(WARN, "fail to alloc hugepage arena class map", K(class_map_size), K(errno), K(ret));
+    ::munmap(reserved, reserved_size);
+  } else {
+    reserved_ = static_cast<char *>(reserved);
+    reserved_size_ = reserved_size;
+    base_ = reinterpret_cast<char *>(upper_align(reinterpret_cast<int64_t>(reserved), SEGMENT_SIZE));
+    limit_ = limit;
+    block_class_ = static_cast<int8_t *>(class_map);
+    pos_ = base_;
+    segment_end_ = base_;
+    is_inited_ = true;
+    OB_LOG(INFO, "succ to init hugepage arena", K(*this));
+  }
+  return ret;
+}
+
+void ObHugePageArena::destroy()
+{
+  if (is_inited_) {
+    OB_LOG(INFO, "hugepage arena destroy", K(*this));
+    ::munmap(block_class_, limit_ >> MIN_BLOCK_SHIFT);
+    ::munmap(reserved_, reserved_size_);
+    is_inited_ = false;
+    base_ = NULL;
+    limit_ = 0;
+    reserved_ = NULL;
+    reserved_size_ = 0;
+    block_class_ = NULL;
+    pos_ = NULL;
+    segment_end_ = NULL;
+    hold_ = 0;
+    used_ = 0;
+    block_count_ = 0;
+    hugetlb_segment_count_ = 0;
+    MEMSET(free_list_, 0, sizeof(free_list_));
+  }
+}
+
+int64_t ObHugePageArena::get_size_class(const int64_t size)
+{
+  int64_t size_class = 0;
+  while ((MIN_BLOCK_SIZE << size_class) < size) {
+    ++size_class;
+  }
+  return size_class;
+}
+
+int64_t ObHugePageArena::get_block_size(const int64_t size)
+{
+  int64_t block_size = 0;
+  if (size > 0 && size <= MAX_BLOCK_SIZE) {
+    block_size = MIN_BLOCK_SIZE << get_size_class(size);
+  }
+  return block_size;
+}
+
+int ObHugePageArena::map_segment(char *segment)
+{
+  int ret = OB_SUCCESS;
+  void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if (enable_hugetlb_) {
+    if (MAP_FAILED == (ptr = ::mmap(segment, SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0))) {
+      // no hugepage reserved in vm.nr_hugepages, transparent hugepage from now on
+      enable_hugetlb_ = false;
+      OB_LOG(INFO, "no explicit hugepage, use transparent hugepage", K(errno));
+    } else {
+      ++hugetlb_segment_count_;
+    }
+  }
+#endif
+  if (MAP_FAILED == ptr) {
+    if (MAP_FAILED == (ptr = ::mmap(segment, SEGMENT_SIZE, PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0))) {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      OB_LOG(WARN, "fail to map hugepage arena segment", KP(segment), K(errno), K(ret));
+    } else {
+#ifdef MADV_HUGEPAGE
+      (void)::madvise(ptr, SEGMENT_SIZE, MADV_HUGEPAGE);
+#endif
+    }
+  }
+  if (OB_SUCC(ret)) {
+    (void)ATOMIC_FAA(&hold_, SEGMENT_SIZE);
+  }
+  return ret;
+}
+
+void ObHugePageArena::retire_segment_tail()
+{
+  while (pos_ < segment_end_) {
+    int64_t size_class = SIZE_CLASS_COUNT - 1;
+    while ((MIN_BLOCK_SIZE << size_class) > segment_end_ - pos_) {
+      --size_class;
+    }
+    block_class_[(pos_ - base_) >> MIN_BLOCK_SHIFT] = static_cast<int8_t>(size_class);
+    *reinterpret_cast<void **>(pos_) = free_list_[size_class];
+    free_list_[size_class] = pos_;
+    pos_ += (MIN_BLOCK_SIZE << size_class);
+  }
+}
+
+void *ObHugePageArena::alloc(const int64_t size, const int64_t alignment)
+{
+  void *ptr = NULL;
+  if (is_inited_ && size > 0 && size <= MAX_BLOCK_SIZE && alignment <= MIN_BLOCK_SIZE) {
+    const int64_t size_class = get_size_class(size);
+    const int64_t block_size = MIN_BLOCK_SIZE << size_class;
+    ObSpinLockGuard guard(lock_);
+    if (NULL != free_list_[size_class]) {
+      ptr = free_list_[size_class];
+      free_list_[size_class] = *reinterpret_cast<void **>(ptr);
+    } else {
+      if (segment_end_ - pos_ < block_size) {
+        retire_segment_tail();
+        if (segment_end_ < base_ + limit_ && OB_SUCCESS == map_segment(segment_end_)) {
+          segment_end_ += SEGMENT_SIZE;
+        }
+      }
+      // blocks are carved in order, so every block is aligned to MIN_BLOCK_SIZE
+      if (segment_end_ - pos_ >= block_size) {
+        ptr = pos_;
+        block_class_[(pos_ - base_) >> MIN_BLOCK_SHIFT] = static_cast<int8_t>(size_class);
+        pos_ += block_size;
+      }
+    }
+    if (NULL != ptr) {
+      (void)ATOMIC_FAA(&used_, block_size);
+      (void)ATOMIC_FAA(&block_count_, 1);
+    }
+  }
+  return ptr;
+}
+
+void ObHugePageArena::free(void *ptr)
+{
+  if (OB_LIKELY(contains(ptr))) {
+    char *block = static_cast<char *>(ptr);
+    const int64_t size_class = block_class_[(block - base_) >> MIN_BLOCK_SHIFT];
+    ObSpinLockGuard guard(lock_);
+    *reinterpret_cast<void **>(block) = free_list_[size_class];
+    free_list_[size_class] = block;
+    (void)ATOMIC_FAA(&used_, -(MIN_BLOCK_SIZE << size_class));
+    (void)ATOMIC_FAA(&block_count_, -1);
+  } else {
+    OB_LOG(ERROR, "free ptr not in hugepage arena", KP(ptr), K(*this));
+  }
+}
+
+} // end of namespace common
+} // end of namespace oceanbase
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OCEANBASE_LIB_OB_HUGEPAGE_ARENA_
+#define OCEANBASE_LIB_OB_HUGEPAGE_ARENA_
+
+#include "lib/ob_define.h"
+#include "lib/atomic/ob_atomic.h"
+#include "lib/lock/ob_spin_lock.h"
+#include "lib/utility/ob_print_utils.h"
+
+namespace oceanbase
+{
+namespace common
+{
+
+/*
+ * A fixed size virtual range backed by 2MB pages, used for io buffer blocks
+ * and object pool chunks, which are long lived and touched by every request.
+ *
+ * The range is reserved at init and mapped segment by segment on demand, each
+ * segment with explicit hugepages (MAP_HUGETLB) if the host has some reserved,
+ * otherwise with normal pages and madvise(MADV_HUGEPAGE). Segments are never
+ * given back, the freed blocks are reused by power of two size class, from 4KB
+ * to 2MB. Anything bigger, or when the range is used up, returns NULL and the
+ * caller should fall back to ob_malloc.
+ */
+class ObHugePageArena
+{
+public:
+  static const int64_t SEGMENT_SIZE = 2L * 1024L * 1024L;
+  static const int64_t MIN_BLOCK_SHIFT = 12;
+  static const int64_t MIN_BLOCK_SIZE = 1L << MIN_BLOCK_SHIFT;
+  static const int64_t MAX_BLOCK_SIZE = SEGMENT_SIZE;
+  static const int64_t SIZE_CLASS_COUNT = 10; // 4KB, 8KB, ... 2MB
+
+  ObHugePageArena();
+  // blocks may still be freed by other statics at exit, the range is kept
+  ~ObHugePageArena() {}
+
+  int init(const int64_t arena_size);
+  void destroy();
+  bool is_inited() const { return is_inited_; }
+
+  // alignment must be no more than MIN_BLOCK_SIZE
+  void *alloc(const int64_t size, const int64_t alignment);
+  void free(void *ptr);
+  bool contains(const void *ptr) const
+  {
+    return static_cast<const char *>(ptr) >= base_ && static_cast<const char *>(ptr) < base_ + limit_;
+  }
+
+  // size of the block which serves @size, or 0 if it is too big
+  static int64_t get_block_size(const int64_t size);
+
+  int64_t get_limit() const { return limit_; }
+  int64_t get_hold() const { return ATOMIC_LOAD(&hold_); }
+  int64_t get_used() const { return ATOMIC_LOAD(&used_); }
+  int64_t get_block_count() const { return ATOMIC_LOAD(&block_count_); }
+  int64_t get_hugetlb_segment_count() const { return ATOMIC_LOAD(&hugetlb_segment_count_); }
+
+  static ObHugePageArena &get_instance();
+
+  TO_STRING_KV(KP_(base), K_(limit), K_(hold), K_(used), K_(block_count),
+               K_(hugetlb_segment_count), K_(enable_hugetlb));
+
+private:
+  static int64_t get_size_class(const int64_t size);
+  int map_segment(char *segment);
+  // carve the rest of current segment into smaller free blocks
+  void retire_segment_tail();
+
+private:
+  bool is_inited_;
+  // try MAP_HUGETLB until it fails once
+  bool enable_hugetlb_;
+  char *base_;
+  int64_t limit_;
+  // the whole reserved range, base_ is aligned up to SEGMENT_SIZE in it
+  char *reserved_;
+  int64_t reserved_size_;
+  // size class of each block, indexed by block offset >> MIN_BLOCK_SHIFT
+  int8_t *block_class_;
+  char *pos_;
+  char *segment_end_;
+  int64_t hold_;
+  int64_t used_;
+  int64_t block_count_;
+  int64_t hugetlb_segment_count_;
+  void *free_list_[SIZE_CLASS_COUNT];
+  ObSpinLock lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObHugePageArena);
+};
+
+} // end of namespace common
+} // end of namespace oceanbase
+
+#endif // OCEANBASE_LIB_OB_HUGEPAGE_ARENA_
@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OCEANBASE_LIB_OB_NUMA_NODE_
+#define OCEANBASE_LIB_OB_NUMA_NODE_
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "lib/ob_define.h"
+#include "lib/thread_local/ob_tsi_utils.h"
+
+namespace oceanbase
+{
+namespace common
+{
+
+/*
+ * cpu => numa node map of this host, it is filled once at startup by whoever
+ * parses the cpu topology. Before that, or on a single node host, all threads
+ * are on node 0 and nothing here has any effect.
+ */
+struct ObNumaNodeMap
+{
+  static const int64_t MAX_CPU_COUNT = 1024;
+  static const int64_t MAX_NODE_COUNT = 64;
+
+  int64_t cpu_count_;
+  int64_t node_count_;
+  // bind new object pool chunks to the node of the allocating thread
+  bool enable_local_alloc_;
+  int16_t cpu_node_[MAX_CPU_COUNT];
+};
+
+extern ObNumaNodeMap g_numa_node_map;
+
+inline int64_t get_numa_node_count()
+{
+  return g_numa_node_map.node_count_ > 1 ? g_numa_node_map.node_count_ : 1;
+}
+
+inline bool is_numa_local_alloc_enabled()
+{
+  return g_numa_node_map.enable_local_alloc_ && g_numa_node_map.node_count_ > 1;
+}
+
+inline int64_t &get_tl_numa_node()
+{
+  static __thread int64_t node_id = -1;
+  return node_id;
+}
+
+inline void set_thread_numa_node(const int64_t node_id)
+{
+  get_tl_numa_node() = node_id;
+}
+
+// threads which are not bound to a node are guessed by the cpu they first run on
+inline int64_t get_thread_numa_node()
+{
+  int64_t &node_id = get_tl_numa_node();
+  if (OB_UNLIKELY(node_id < 0)) {
+    const int64_t cpu_id = icpu_id();
+    if (g_numa_node_map.node_count_ > 1 && cpu_id >= 0 && cpu_id < ObNumaNodeMap::MAX_CPU_COUNT) {
+      node_id = g_numa_node_map.cpu_node_[cpu_id];
+    } else {
+      node_id = 0;
+    }
+  }
+  return node_id;
+}
+
+// allow current thread to run on all cpus of node
+inline int bind_thread_to_numa_node(const int64_t node_id)
+{
+  int ret = OB_SUCCESS;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  for (int64_t i = 0; i < g_numa_node_map.cpu_count_ && i < CPU_SETSIZE; ++i) {
+    if (node_id == g_numa_node_map.cpu_node_[i]) {
+      CPU_SET(i, &cpuset);
+    }
+  }
+  if (OB_UNLIKELY(node_id < 0) || OB_UNLIKELY(node_id >= get_numa_node_count())) {
+    ret = OB_INVALID_ARGUMENT;
+  } else if (OB_UNLIKELY(0 != pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset))) {
+    ret = OB_ERR_SYS;
+  } else {
+    set_thread_numa_node(node_id);
+  }
+  return ret;
+}
+
+// prefer node for the whole pages in [ptr, ptr + len), pages already touched
+// on other node are moved. MPOL_* are defined in numaif.h which may not be installed.
+inline void bind_memory_to_numa_node(void *ptr, const int64_t len, const int64_t node_id)
+{
+  static const int64_t NUMA_MPOL_PREFERRED = 1;
+  static const uint64_t NUMA_MPOL_MF_MOVE = (1 << 1);
+  static const int64_t page_size = sysconf(_SC_PAGESIZE);
+  const uint64_t start = (reinterpret_cast<uint64_t>(ptr) + page_size - 1) & ~(page_size - 1);
+  const uint64_t end = (reinterpret_cast<uint64_t>(ptr) + len) & ~(page_size - 1);
+  if (end > start && node_id >= 0 && node_id < ObNumaNodeMap::MAX_NODE_COUNT) {
+    unsigned long node_mask = 1UL << node_id;
+    (void)syscall(SYS_mbind, start, end - start, NUMA_MPOL_PREFERRED, &node_mask,
+                  sizeof(node_mask) * 8, NUMA_MPOL_MF_MOVE);
+  }
+}
+
+} // end namespace common
+} // end namespace oceanbase
+
+#endif // OCEANBASE_LIB_OB_NUMA_NODE_
@@ -11,6 +11,7 @@
  */
 
 #include "lib/objectpool/ob_concurrency_objpool.h"
+#include "lib/allocator/ob_hugepage_arena.h"
 
 namespace oceanbase
 {
@@ -67,7 +68,8 @@ ObObjFreeList::ObObjFreeList()
       thread_cache_idx_(0), name_(NULL), type_size_(0), type_size_base_(0),
       alignment_(0), obj_count_base_(0), obj_count_per_chunk_(0),
       chunk_byte_size_(0), chunk_count_(0), used_(0), allocated_(0),
-      allocated_base_(0), used_base_(0), nr_thread_cache_(0), thread_cache_(NULL)
+      allocated_base_(0), used_base_(0), cross_node_steal_count_(0),
+      nr_thread_cache_(0), thread_cache_(NULL)
 {
 
 }
@@ -125,6 +127,26 @@ inline void ObObjFreeList::clear_chunk_item_magic(ObChunkInfo *chunk_info, void
 }
 #endif
 
+// chunks come from the hugepage arena if it is enabled and not used up
+static inline void *chunk_malloc(const int64_t alignment, const int64_t size, const int64_t mod_id)
+{
+  void *ptr = ObHugePageArena::get_instance().alloc(size, alignment);
+  if (NULL == ptr) {
+    ptr = ob_malloc_align(alignment, size, mod_id);
+  }
+  return ptr;
+}
+
+static inline void chunk_free(void *ptr)
+{
+  ObHugePageArena &arena = ObHugePageArena::get_instance();
+  if (arena.contains(ptr)) {
+    arena.free(ptr);
+  } else {
+    ob_free_align(ptr);
+  }
+}
+
 inline ObChunkInfo *ObObjFreeList::chunk_create(ObThreadCache *thread_cache)
 {
   void *chunk_addr = NULL;
@@ -132,9 +154,14 @@ inline ObChunkInfo *ObObjFreeList::chunk_create(ObThreadCache *thread_cache)
   void *next = NULL;
   ObChunkInfo *chunk_info = NULL;
 
-  if (NULL == (chunk_addr = ob_malloc_align(alignment_, chunk_byte_size_, mod_id_))) {
+  if (NULL == (chunk_addr = chunk_malloc(alignment_, chunk_byte_size_, mod_id_))) {
     OB_LOG(ERROR, "failed to allocate chunk", K_(chunk_byte_size));
   } else {
+    // arena blocks may share a hugepage with other threads' chunks
+    if (is_numa_local_alloc_enabled() && !ObHugePageArena::get_instance().contains(chunk_addr)) {
+      // the chunk is only carved by its owner thread, keep it on the owner's node
+      bind_memory_to_numa_node(chunk_addr, chunk_byte_size_, thread_cache->numa_node_id_);
+    }
     chunk_info = new (reinterpret_cast<char *>(chunk_addr) + type_size_ * obj_count_per_chunk_) ObChunkInfo();
 #ifdef DOUBLE_FREE_CHECK
     memset(chunk_info->item_magic_, 0, chunk_byte_size_ - type_size_ * obj_count_per_chunk_ - sizeof(ObChunkInfo));
@@ -175,7 +202,7 @@ inline void ObObjFreeList::chunk_delete(ObThreadCache *thread_cache, ObChunkInfo
   }
   thread_cache->free_chunk_list_.remove(chunk_info);
   thread_cache->nr_free_chunks_--;
-  ob_free_align(chunk_addr);
+  chunk_free(chunk_addr);
   (void)ATOMIC_FAA(&allocated_, -obj_count_per_chunk_);
   (void)ATOMIC_FAA(&ObObjFreeListList::get_freelists().mem_total_, -chunk_byte_size_);
 }
@@ -365,6 +392,13 @@ int ObObjFreeList::init(const char *name, const int64_t obj_size,
                                      OB_MALLOC_NORMAL_BLOCK_SIZE);
     }
 
+    // arena blocks are power of two, let the chunk fill the whole block
+    const int64_t arena_block_size = ObHugePageArena::get_block_size(chunk_byte_size_);
+    if (ObHugePageArena::get_instance().is_inited() && arena_block_size > chunk_byte_size_) {
+      chunk_byte_size_ = arena_block_size;
+      obj_count_per_chunk_ = (chunk_byte_size_ - meta_size) / real_type_size;
+    }
+
     chunk_count_ = (obj_count_base_ + obj_count_per_chunk_ - 1) / obj_count_per_chunk_;
 
     used_ = 0;
@@ -389,7 +423,7 @@ void *ObObjFreeList::global_alloc()
 
   do {
     if (obj_free_list_.empty()) {
-      if (NULL == (chunk_addr = ob_malloc_align(alignment_, chunk_byte_size_, mod_id_))) {
+      if (NULL == (chunk_addr = chunk_malloc(alignment_, chunk_byte_size_, mod_id_))) {
         OB_LOG(ERROR, "failed to allocate chunk", K_(chunk_byte_size));
         break_loop = true;
       } else {
@@ -431,6 +465,7 @@ ObThreadCache *ObObjFreeList::init_thread_cache(ObChunkInfo *&chunk_info)
   } else {
     thread_cache->f_ = this;
     thread_cache->free_chunk_list_ = DLL<ObChunkInfo>();
+    thread_cache->numa_node_id_ = get_thread_numa_node();
 
     // this lock will only be accessed when initializing
     // thread cache, so it won't damage performance
@@ -524,16 +559,26 @@ void *ObObjFreeList::alloc()
       set_chunk_item_magic(NULL, ret);
     } else {
 
-      // try to steal memory from other thread's outer_free_list
-      int64_t steal_thread_count = reclaim_opt_.steal_thread_count_;
-      next_thread_cache = thread_cache->next_;
-      while (NULL == ret && next_thread_cache != thread_cache && steal_thread_count-- > 0) {
-        if (NULL != (ret = next_thread_cache->outer_free_list_.pop())) {
-          (void)ATOMIC_FAA(&next_thread_cache->nr_free_, -1);
-          (void)ATOMIC_FAA(&next_thread_cache->nr_malloc_, 1);
-          set_chunk_item_magic(NULL, ret);
-        } else {
-          next_thread_cache = next_thread_cache->next_;
+      // try to steal memory from other thread's outer_free_list, threads on the
+      // same numa node first, then any node if nothing stolen
+      const bool is_multi_node = get_numa_node_count() > 1;
+      for (int64_t pass = 0; NULL == ret && pass < (is_multi_node ? 2 : 1); ++pass) {
+        int64_t steal_thread_count = reclaim_opt_.steal_thread_count_;
+        next_thread_cache = thread_cache->next_;
+        while (NULL == ret && next_thread_cache != thread_cache && steal_thread_count-- > 0) {
+          if (is_multi_node && 0 == pass
+              && next_thread_cache->numa_node_id_ != thread_cache->numa_node_id_) {
+            next_thread_cache = next_thread_cache->next_;
+          } else if (NULL != (ret = next_thread_cache->outer_free_list_.pop())) {
+            (void)ATOMIC_FAA(&next_thread_cache->nr_free_, -1);
+            (void)ATOMIC_FAA(&next_thread_cache->nr_malloc_, 1);
+            set_chunk_item_magic(NULL, ret);
+            if (next_thread_cache->numa_node_id_ != thread_cache->numa_node_id_) {
+              (void)ATOMIC_FAA(&cross_node_steal_count_, 1);
+            }
+          } else {
+            next_thread_cache = next_thread_cache->next_;
+          }
         }
       }
 
@@ -20,6 +20,7 @@
 #include "lib/list/ob_intrusive_list.h"
 #include "lib/lock/ob_mutex.h"
 #include "lib/container/ob_vector.h"
+#include "lib/cpu/ob_numa_node.h"
 
 DEFINE_HAS_MEMBER(OP_LOCAL_NUM);
 
@@ -134,6 +135,9 @@ struct ObThreadCache
   int64_t nr_free_chunks_;
   DLL<ObChunkInfo> free_chunk_list_;
 
+  // numa node of the owner thread
+  int64_t numa_node_id_;
+
   ObThreadCache *prev_;
   ObThreadCache *next_;
 };
@@ -161,6 +165,7 @@ public:
   int64_t get_chunk_count() const { return chunk_count_; }
   int64_t get_chunk_byte_size() const { return chunk_byte_size_; }
   int64_t get_base_obj_size() const { return type_size_base_; }
+  int64_t get_cross_node_steal_count() const { return cross_node_steal_count_; }
 
 private:
   void show_info(const char *file, const int line,
@@ -222,6 +227,8 @@ private:
   int64_t allocated_;
   int64_t allocated_base_;
   int64_t used_base_;
+  // objects stolen from thread cache on other numa node
+  int64_t cross_node_steal_count_;
 
   // number of thread cache in one object freelist
   int64_t nr_thread_cache_;
@@ -49,6 +49,9 @@ enum
   OB_CC_ALIVE_LAST_FAIL_TIME,
   OB_CC_ALIVE_FAILURE_EVENTS,
   OB_CC_REF_COUNT,
+  OB_CC_CONCURRENCY_LIMIT,
+  OB_CC_INFLIGHT_REQUESTS,
+  OB_CC_CONCURRENCY_REJECTED,
   OB_CC_MAX_CONGESTION_COLUMN_ID,
 };
 
@@ -71,6 +74,9 @@ const ObProxyColumnSchema CONGESTION_COLUMN_ARRAY[OB_CC_MAX_CONGESTION_COLUMN_ID
     ObProxyColumnSchema::make_schema(OB_CC_ALIVE_LAST_FAIL_TIME,  "alive_last_fail_time", obmysql::OB_MYSQL_TYPE_VARCHAR),
     ObProxyColumnSchema::make_schema(OB_CC_ALIVE_FAILURE_EVENTS,  "alive_failure_events", obmysql::OB_MYSQL_TYPE_LONGLONG),
     ObProxyColumnSchema::make_schema(OB_CC_REF_COUNT,             "ref_count",            obmysql::OB_MYSQL_TYPE_LONGLONG),
+    ObProxyColumnSchema::make_schema(OB_CC_CONCURRENCY_LIMIT,     "concurrency_limit",    obmysql::OB_MYSQL_TYPE_LONGLONG),
+    ObProxyColumnSchema::make_schema(OB_CC_INFLIGHT_REQUESTS,     "inflight_requests",    obmysql::OB_MYSQL_TYPE_LONGLONG),
+    ObProxyColumnSchema::make_schema(OB_CC_CONCURRENCY_REJECTED,  "concurrency_rejected", obmysql::OB_MYSQL_TYPE_LONGLONG),
 };
 
 
@@ -359,6 +365,9 @@ int ObShowCongestionHandler::dump_item(const ObCongestionEntry *entry, const ObS
   if (OB_SUCC(ret)) {
     cells[OB_CC_ALIVE_FAILURE_EVENTS].set_int(entry->alive_fail_history_.events_);
     cells[OB_CC_REF_COUNT].set_int(entry->ref_count_);
+    cells[OB_CC_CONCURRENCY_LIMIT].set_int(entry->concurrency_limiter_.limit_);
+    cells[OB_CC_INFLIGHT_REQUESTS].set_int(entry->concurrency_limiter_.inflight_);
+    cells[OB_CC_CONCURRENCY_REJECTED].set_int(entry->concurrency_limiter_.rejected_count_);
   }
 
   if (OB_SUCC(ret)) {
@@ -66,6 +66,11 @@ enum
   OB_IC_GLOBAL_SESSION_INFO_SESSION_ID,
   OB_IC_GLOBAL_SESSION_INFO_SESSION_CREATE_TIME,
   OB_IC_GLOBAL_SESSION_INFO_SESSION_LAST_RELEASE_TIME,
+  OB_IC_GLOBAL_SESSION_INFO_TARGET_COUNT,
+  OB_IC_GLOBAL_SESSION_INFO_ACQUIRE_QPS,
+  OB_IC_GLOBAL_SESSION_INFO_AVG_HOLD_TIME,
+  OB_IC_GLOBAL_SESSION_INFO_AVG_WAIT_TIME,
+  OB_IC_GLOBAL_SESSION_INFO_AVG_CONNECT_TIME,
   OB_IC_GLOBAL_SESSION_INFO_MAX_COLUMN_ID,
 };
 const ObProxyColumnSchema LIST_INFO_COLUMN_ARRAY[OB_IC_GLOBAL_SESSION_INFO_MAX_COLUMN_ID] = {
@@ -79,6 +84,11 @@ const ObProxyColumnSchema LIST_INFO_COLUMN_ARRAY[OB_IC_GLOBAL_SESSION_INFO_MAX_C
   ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_SESSION_ID,    "session_id",     obmysql::OB_MYSQL_TYPE_LONGLONG),
   ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_SESSION_CREATE_TIME, "create_time",  obmysql::OB_MYSQL_TYPE_VARCHAR),
   ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_SESSION_LAST_RELEASE_TIME, "last_release_time",  obmysql::OB_MYSQL_TYPE_VARCHAR),
+  ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_TARGET_COUNT,    "target_count",     obmysql::OB_MYSQL_TYPE_LONGLONG),
+  ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_ACQUIRE_QPS,     "acquire_qps",      obmysql::OB_MYSQL_TYPE_LONGLONG),
+  ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_AVG_HOLD_TIME,   "avg_hold_us",      obmysql::OB_MYSQL_TYPE_LONGLONG),
+  ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_AVG_WAIT_TIME,   "avg_wait_us",      obmysql::OB_MYSQL_TYPE_LONGLONG),
+  ObProxyColumnSchema::make_schema(OB_IC_GLOBAL_SESSION_INFO_AVG_CONNECT_TIME, "avg_connect_us",  obmysql::OB_MYSQL_TYPE_LONGLONG),
 };
 
 ObShowGlobalSessionHandler::ObShowGlobalSessionHandler(event::ObContinuation *cont, event::ObMIOBuffer *buf,
@@ -213,6 +223,12 @@ int ObShowGlobalSessionHandler::dump_session_info_body(const common::ObString& d
             snprintf(last_release_time_buf, TMP_BUF_SIZE, "null");
           }
           cells[OB_IC_GLOBAL_SESSION_INFO_SESSION_LAST_RELEASE_TIME].set_varchar(last_release_time_buf);
+          const ObMysqlSessionPoolAdaptiveStat &adaptive_stat = spot->adaptive_stat_;
+          cells[OB_IC_GLOBAL_SESSION_INFO_TARGET_COUNT].set_int(adaptive_stat.get_target_conn());
+          cells[OB_IC_GLOBAL_SESSION_INFO_ACQUIRE_QPS].set_int(adaptive_stat.get_acquire_rate());
+          cells[OB_IC_GLOBAL_SESSION_INFO_AVG_HOLD_TIME].set_int(adaptive_stat.get_avg_hold_time_us());
+          cells[OB_IC_GLOBAL_SESSION_INFO_AVG_WAIT_TIME].set_int(adaptive_stat.get_avg_wait_time_us());
+          cells[OB_IC_GLOBAL_SESSION_INFO_AVG_CONNECT_TIME].set_int(adaptive_stat.get_avg_connect_time_us());
           if (OB_FAIL(encode_row_packet(row))) {
             WARN_ICMD("fail to encode row packet", K(row), K(ret));
           }
@@ -15,6 +15,7 @@
 #include "cmd/ob_show_memory_handler.h"
 #include <malloc.h>
 #include "lib/objectpool/ob_concurrency_objpool.h"
+#include "lib/allocator/ob_hugepage_arena.h"
 #include "iocore/eventsystem/ob_event_processor.h"
 #include "iocore/eventsystem/ob_task.h"
 #include "cmd/ob_show_sqlaudit_handler.h"
@@ -55,6 +56,7 @@ enum
   OB_OPC_TYPE_SIZE,
   OB_OPC_CHUNK_COUNT,
   OB_OPC_CHUNK_BYTE_SIZE,
+  OB_OPC_CROSS_NODE_STEAL,
   OB_OPC_MAX_OBJPOOL_COLUMN_ID,
 };
 
@@ -75,6 +77,7 @@ const ObProxyColumnSchema OBJPOOL_COLUMN_ARRAY[OB_OPC_MAX_OBJPOOL_COLUMN_ID] = {
     ObProxyColumnSchema::make_schema(OB_OPC_TYPE_SIZE,        "type_size",        obmysql::OB_MYSQL_TYPE_VARCHAR),
     ObProxyColumnSchema::make_schema(OB_OPC_CHUNK_COUNT,      "chunk_count",      obmysql::OB_MYSQL_TYPE_VARCHAR),
     ObProxyColumnSchema::make_schema(OB_OPC_CHUNK_BYTE_SIZE,  "chunk_byte_size",  obmysql::OB_MYSQL_TYPE_VARCHAR),
+    ObProxyColumnSchema::make_schema(OB_OPC_CROSS_NODE_STEAL, "cross_node_steal", obmysql::OB_MYSQL_TYPE_VARCHAR),
 };
 
 ObShowMemoryHandler::ObShowMemoryHandler(event::ObContinuation *cont, event::ObMIOBuffer *buf,
@@ -118,6 +121,14 @@ int ObShowMemoryHandler::handle_show_memory(int event, void *data)
         LOG_WARN("fail to dump memory info", K(ret));
       }
     }
+    if (OB_SUCC(ret)) {
+      // dump memory of hugepage arena, used by io buffers and object pool chunks
+      ObHugePageArena &arena = ObHugePageArena::get_instance();
+      if (OB_FAIL(dump_mod_memory("HUGEPAGE_ARENA", "allocator", arena.get_hold(),
+                                  arena.get_used(), arena.get_block_count()))) {
+        LOG_WARN("fail to dump memory info", K(ret));
+      }
+    }
     if (OB_SUCC(ret)) {
       // dump sqlaudit memory
       ObSqlauditRecordQueue *sqlaudit_record_queue_ = NULL;
@@ -330,6 +341,14 @@ int ObShowMemoryHandler::dump_objpool_memory(const ObObjFreeList *fl)
       pos = value.length();
     }
   }
+  if (OB_SUCC(ret)) {
+    if (OB_FAIL(format_int_to_str(fl->get_cross_node_steal_count(), value))) {
+      LOG_WARN("fail to format_int_to_str", K(ret));
+    } else {
+      cells[OB_OPC_CROSS_NODE_STEAL].set_varchar(value.ptr() + pos);
+      pos = value.length();
+    }
+  }
 
   if (OB_SUCC(ret)) {
     ObNewRow row;
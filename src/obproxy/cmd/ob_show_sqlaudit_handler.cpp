@@ -79,6 +79,21 @@ static inline void direct_free(void *p, const int64_t size)
   }
 }
 
+static const int64_t RECORD_ALIGN = 8;
+static const int64_t RECORD_FOOTER_LEN = static_cast<int64_t>(sizeof(int64_t));
+// a padding record is only a footer with this flag, it fills the tail of the ring
+static const int64_t RECORD_PADDING_FLAG = 1LL << 62;
+
+static int64_t g_sqlaudit_queue_id = 0;
+
+struct ObSqlauditRecordCmp
+{
+  bool operator()(const ObSqlauditRecord *l, const ObSqlauditRecord *r) const
+  {
+    return l->audit_id_ < r->audit_id_;
+  }
+};
+
 // ObSqlauditRecordQueue::Iterator
 ObSqlauditRecordQueue::Iterator::Iterator(ObSqlauditRecordQueue &sql_audit_record_queue,
                                           const int64_t audit_id_offset,
@@ -86,173 +101,319 @@ ObSqlauditRecordQueue::Iterator::Iterator(ObSqlauditRecordQueue &sql_audit_recor
     : sql_audit_record_queue_(sql_audit_record_queue),
       is_overlap_(false),
       sm_id_(LONG_MIN),
-      min_audit_id_(audit_id_offset),
-      max_audit_id_(audit_id_offset + audit_id_limit)
-{
-  reserved_len_ = static_cast<int64_t>(
-      RETAIN_RATIO * static_cast<double>(sql_audit_record_queue.current_records_list_len_));
-  int64_t cur_max_audit_id = sql_audit_record_queue.audit_id_;
-  int64_t cur_min_audit_id = std::max((cur_max_audit_id + reserved_len_
-      - sql_audit_record_queue.current_records_list_len_), 0L);
-
-  if (audit_id_offset >= 0) {
-    min_audit_id_ = std::max(min_audit_id_, cur_min_audit_id);
-    max_audit_id_ = std::min(max_audit_id_, cur_max_audit_id);
-  } else {
-    min_audit_id_ = std::max((cur_max_audit_id - audit_id_limit), cur_min_audit_id);
-    max_audit_id_ = cur_max_audit_id;
-  }
-
-  cur_index_ = min_audit_id_ % sql_audit_record_queue.current_records_list_len_;
-  ndone_ = 0;
-  INFO_ICMD("show sqlaudit limit m,n",
-            K(audit_id_offset), K(audit_id_limit),
-            K(cur_min_audit_id), K(cur_max_audit_id),
-            K(min_audit_id_), K(max_audit_id_),
-            K(cur_index_), K(ndone_),
-            K(sql_audit_record_queue.current_records_list_len_));
+      audit_id_offset_(audit_id_offset),
+      audit_id_limit_(audit_id_limit),
+      allocator_(ObModIds::OB_PROXY_STAT),
+      records_(),
+      cur_index_(0)
+{
 }
 
 ObSqlauditRecordQueue::Iterator::Iterator(ObSqlauditRecordQueue &sql_audit_record_queue,
-                                        const int64_t sm_id)
+                                          const int64_t sm_id)
     : sql_audit_record_queue_(sql_audit_record_queue),
       is_overlap_(false),
       sm_id_(sm_id),
-      min_audit_id_(-1),
-      max_audit_id_(-1)
+      audit_id_offset_(-1),
+      audit_id_limit_(-1),
+      allocator_(ObModIds::OB_PROXY_STAT),
+      records_(),
+      cur_index_(0)
+{
+}
+
+void ObSqlauditRecordQueue::Iterator::destroy()
 {
+  records_.reset();
+  allocator_.reset();
+  cur_index_ = 0;
+}
 
-  reserved_len_ = static_cast<int64_t>(
-      RETAIN_RATIO * static_cast<double>(sql_audit_record_queue.current_records_list_len_));
-  max_audit_id_ = sql_audit_record_queue.audit_id_;
-  min_audit_id_ = std::max((max_audit_id_ + reserved_len_
-      - sql_audit_record_queue.current_records_list_len_), 0L);
+bool ObSqlauditRecordQueue::Iterator::is_match(const ObSqlauditRecord &record,
+                                               const ObString &like_name) const
+{
+  bool bret = false;
+  if (LONG_MIN != sm_id_) {
+    bret = (record.sm_id_ == sm_id_);
+  } else if (audit_id_offset_ >= 0) {
+    bret = (record.audit_id_ >= audit_id_offset_ && record.audit_id_ < audit_id_offset_ + audit_id_limit_);
+  } else {
+    bret = true;
+  }
 
-  cur_index_ = min_audit_id_ % sql_audit_record_queue.current_records_list_len_;
-  ndone_ = 0;
-  INFO_ICMD("show sqlaudit n", K_(min_audit_id), K_(max_audit_id), K(cur_index_), K(sm_id));
+  if (bret && !like_name.empty()) {
+    ObString sql(static_cast<int32_t>(record.sql_len_), record.get_sql());
+    bret = common::ObCharset::wildcmp(CS_TYPE_UTF8MB4_BIN, sql, like_name, 0, '_', '%');
+  }
+  return bret;
 }
 
-ObSqlauditRecord *ObSqlauditRecordQueue::Iterator::next()
+int ObSqlauditRecordQueue::Iterator::collect_ring(const ObSqlauditRing &ring, const ObString &like_name)
 {
-  ObSqlauditRecord *record = NULL;
-  int64_t audit_id_ = -1;
-  int64_t ntodo = max_audit_id_ - min_audit_id_;
-  if (sql_audit_record_queue_.is_inited_ && ntodo > 0) {
-    int64_t critical_index = 0;
-    int64_t critical_audit_id = 0;
-    if (LONG_MIN == sm_id_) {
-      if (ndone_ >= ntodo) {
-        // do nothing
-      } else {
-        audit_id_ = sql_audit_record_queue_.sqlaudit_records_[cur_index_].audit_id_;
-        critical_index = std::max((audit_id_ - (reserved_len_ / 2)), 0L)
-                         % sql_audit_record_queue_.current_records_list_len_;
-        critical_audit_id = sql_audit_record_queue_.sqlaudit_records_[critical_index].audit_id_;
-
-        if (critical_audit_id <= max_audit_id_) {
-          record = &(sql_audit_record_queue_.sqlaudit_records_[cur_index_]);
-          ++ndone_;
-        } else {
-          is_overlap_ = true;
-        }
-        ++cur_index_;
-        cur_index_ = cur_index_ % sql_audit_record_queue_.current_records_list_len_;
-      }
+  int ret = OB_SUCCESS;
+  const int64_t capacity = ring.capacity_;
+  const int64_t inflight_len = sql_audit_record_queue_.get_inflight_len();
+  const int64_t tail = ATOMIC_LOAD(&ring.tail_);
+  const int64_t start = std::max(tail - capacity + inflight_len, 0L);
+  int64_t pos = tail;
+  int64_t ring_count = 0;
+  bool is_end = (NULL == ring.buf_ || capacity <= 0);
+  char *buf = NULL;
+
+  // walk backward from tail, audit_id is decreasing in one ring
+  while (OB_SUCC(ret) && !is_end && pos - RECORD_FOOTER_LEN >= start) {
+    int64_t record_len = 0;
+    MEMCPY(&record_len, ring.buf_ + (pos - RECORD_FOOTER_LEN) % capacity, RECORD_FOOTER_LEN);
+    const bool is_padding = (0 != (record_len & RECORD_PADDING_FLAG));
+    record_len &= ~RECORD_PADDING_FLAG;
+    if (OB_UNLIKELY(record_len <= 0) || OB_UNLIKELY(record_len > capacity)
+        || OB_UNLIKELY(0 != record_len % RECORD_ALIGN)) {
+      // overwritten while reading
+      is_overlap_ = (pos - RECORD_FOOTER_LEN < ATOMIC_LOAD(&ring.tail_) - capacity + inflight_len);
+      is_end = true;
+    } else if (pos - record_len < start) {
+      is_end = true;
+    } else if (is_padding) {
+      pos -= record_len;
+    } else if (OB_ISNULL(buf) && OB_ISNULL(buf = static_cast<char *>(allocator_.alloc(
+        sql_audit_record_queue_.max_record_len_)))) {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      WARN_ICMD("fail to alloc record buf", "size", sql_audit_record_queue_.max_record_len_, K(ret));
     } else {
-      if (OB_UNLIKELY(sm_id_ < 0)) {
-        // do nothing
+      MEMCPY(buf, ring.buf_ + (pos - record_len) % capacity, std::min(record_len, sql_audit_record_queue_.max_record_len_));
+      ObSqlauditRecord *record = reinterpret_cast<ObSqlauditRecord *>(buf);
+      if (pos - record_len < ATOMIC_LOAD(&ring.tail_) - capacity + inflight_len
+          || OB_UNLIKELY(record->record_len_ != record_len)) {
+        // writer has wrapped onto this record during the copy
+        is_overlap_ = true;
+        is_end = true;
+      } else if (audit_id_offset_ >= 0 && record->audit_id_ < audit_id_offset_) {
+        is_end = true;
       } else {
-        bool find = false;
-        while (!find && (ndone_ < ntodo + 1)) {
-          audit_id_ = sql_audit_record_queue_.sqlaudit_records_[cur_index_].audit_id_;
-          critical_index = std::max((audit_id_ - (reserved_len_ / 2)), 0L)
-                           % sql_audit_record_queue_.current_records_list_len_;
-          critical_audit_id = sql_audit_record_queue_.sqlaudit_records_[critical_index].audit_id_;
-          if (critical_audit_id <= max_audit_id_) {
-            if (sql_audit_record_queue_.sqlaudit_records_[cur_index_].sm_id_ == sm_id_) {
-              record = &(sql_audit_record_queue_.sqlaudit_records_[cur_index_]);
-              find = true;
-            }
+        if (is_match(*record, like_name)) {
+          if (OB_FAIL(records_.push_back(record))) {
+            WARN_ICMD("fail to push back record", K(ret));
           } else {
-            is_overlap_ = true;
-            find = true;
+            buf = NULL;
+            ++ring_count;
           }
-          ++ndone_;
-          ++cur_index_;
-          cur_index_ = cur_index_ % sql_audit_record_queue_.current_records_list_len_;
+        }
+        pos -= record_len;
+        // only the last n records are needed
+        if (LONG_MIN == sm_id_ && audit_id_offset_ < 0 && ring_count >= audit_id_limit_) {
+          is_end = true;
         }
       }
     }
   }
+  return ret;
+}
+
+int ObSqlauditRecordQueue::Iterator::open(const ObString &like_name)
+{
+  int ret = OB_SUCCESS;
+  destroy();
+  if (OB_UNLIKELY(!sql_audit_record_queue_.is_inited_)) {
+    // do nothing
+  } else if (LONG_MIN == sm_id_ && audit_id_limit_ <= 0) {
+    // do nothing
+  } else {
+    // the shared ring is the last one
+    for (int64_t i = 0; OB_SUCC(ret) && i <= sql_audit_record_queue_.ring_count_; ++i) {
+      if (OB_FAIL(collect_ring(sql_audit_record_queue_.rings_[i], like_name))) {
+        WARN_ICMD("fail to collect sqlaudit ring", K(i), K(ret));
+      }
+    }
+
+    if (OB_SUCC(ret) && records_.count() > 0) {
+      ObSqlauditRecord **first = &records_.at(0);
+      std::sort(first, first + records_.count(), ObSqlauditRecordCmp());
+      if (LONG_MIN == sm_id_ && audit_id_offset_ < 0 && records_.count() > audit_id_limit_) {
+        cur_index_ = records_.count() - audit_id_limit_;
+      }
+    }
+  }
+  INFO_ICMD("show sqlaudit", K_(audit_id_offset), K_(audit_id_limit), K_(sm_id),
+            "record_count", records_.count(), K_(cur_index), K_(is_overlap), K(ret));
+  return ret;
+}
+
+ObSqlauditRecord *ObSqlauditRecordQueue::Iterator::next()
+{
+  ObSqlauditRecord *record = NULL;
+  if (cur_index_ < records_.count()) {
+    record = records_.at(cur_index_);
+    ++cur_index_;
+  }
   return record;
 }
 
 // ObSqlauditRecordQueue
 ObSqlauditRecordQueue::ObSqlauditRecordQueue()
     : is_inited_(false),
+      queue_id_(0),
       audit_id_(0),
-      sqlaudit_records_(NULL),
-      current_memory_size_(0),
-      current_records_list_len_(0)
+      buf_(NULL),
+      rings_(NULL),
+      ring_count_(0),
+      claimed_ring_count_(0),
+      max_sql_len_(0),
+      max_record_len_(0),
+      drop_count_(0),
+      current_memory_size_(0)
 {
 }
 
-int ObSqlauditRecordQueue::init(const int64_t available_memory_size)
+int ObSqlauditRecordQueue::init(const int64_t available_memory_size, const int64_t ring_count)
 {
   int ret = OB_SUCCESS;
+  int64_t ring_capacity = 0;
   if (OB_UNLIKELY(is_inited_)) {
     ret = OB_INIT_TWICE;
     DEBUG_ICMD("init twice", K(available_memory_size), K(ret));
-  } else if (OB_UNLIKELY(available_memory_size <= 0)) {
+  } else if (OB_UNLIKELY(available_memory_size <= 0) || OB_UNLIKELY(ring_count <= 0)) {
     ret = OB_INVALID_ARGUMENT;
-    WARN_ICMD("invalid argument", K(available_memory_size), K(ret));
+    WARN_ICMD("invalid argument", K(available_memory_size), K(ring_count), K(ret));
   } else if ((current_memory_size_ = ob_roundup(available_memory_size, MMAP_BLOCK_ALIGN)) <=  0) {
     ret = OB_ERR_UNEXPECTED;
     WARN_ICMD("invalid current_memory_size", K(current_memory_size_), K(available_memory_size), K(MMAP_BLOCK_ALIGN));
-  } else if (OB_ISNULL(sqlaudit_records_ = reinterpret_cast<ObSqlauditRecord *>(direct_malloc(current_memory_size_)))) {
+  } else if ((ring_capacity = (current_memory_size_ / (ring_count + 1)) & ~(RECORD_ALIGN - 1))
+             < static_cast<int64_t>(8 * sizeof(ObSqlauditRecord))) {
+    ret = OB_INVALID_ARGUMENT;
+    WARN_ICMD("sqlaudit memory is too small for work threads", K(current_memory_size_), K(ring_count), K(ret));
+  } else if (OB_ISNULL(rings_ = new (std::nothrow) ObSqlauditRing[ring_count + 1])) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    WARN_ICMD("fail to new sqlaudit rings", K(ring_count), K(ret));
+  } else if (OB_ISNULL(buf_ = reinterpret_cast<char *>(direct_malloc(current_memory_size_)))) {
     ret = OB_ALLOCATE_MEMORY_FAILED;
     WARN_ICMD("fail to direct_malloc", K(current_memory_size_), K(ret));
   } else {
-    current_records_list_len_ = current_memory_size_ / sizeof(ObSqlauditRecord);
+    for (int64_t i = 0; i <= ring_count; ++i) {
+      rings_[i].buf_ = buf_ + i * ring_capacity;
+      rings_[i].capacity_ = ring_capacity;
+      rings_[i].tail_ = 0;
+    }
+    // a record never takes more than 1/8 of a ring, so the ring always keeps several records
+    max_sql_len_ = std::min(MAX_SQL_LENGTH,
+        ring_capacity / 8 - static_cast<int64_t>(sizeof(ObSqlauditRecord)) - RECORD_FOOTER_LEN - RECORD_ALIGN);
+    max_record_len_ = ob_roundup(static_cast<int64_t>(sizeof(ObSqlauditRecord)) + max_sql_len_ + RECORD_FOOTER_LEN,
+                                 RECORD_ALIGN);
+    ring_count_ = ring_count;
+    claimed_ring_count_ = 0;
+    drop_count_ = 0;
+    queue_id_ = ATOMIC_AAF(&g_sqlaudit_queue_id, 1);
     audit_id_ = 0;
     is_inited_ = true;
   }
+
+  if (OB_FAIL(ret) && NULL != rings_) {
+    delete []rings_;
+    rings_ = NULL;
+  }
   return ret;
 }
 
 void ObSqlauditRecordQueue::destroy()
 {
   if (is_inited_) {
-    if (OB_LIKELY(NULL != sqlaudit_records_)) {
-      direct_free(sqlaudit_records_, current_memory_size_);
-      sqlaudit_records_ = NULL;
+    if (OB_LIKELY(NULL != buf_)) {
+      direct_free(buf_, current_memory_size_);
+      buf_ = NULL;
+    }
+    if (OB_LIKELY(NULL != rings_)) {
+      delete []rings_;
+      rings_ = NULL;
     }
 
     audit_id_ = 0;
+    ring_count_ = 0;
+    claimed_ring_count_ = 0;
     current_memory_size_ = 0;
-    current_records_list_len_ = 0;
     is_inited_ = false;
   }
 }
 
+ObSqlauditRing *ObSqlauditRecordQueue::get_thread_ring()
+{
+  // queue may be rebuilt when sqlaudit_mem_limited changes, so cache the ring with queue id
+  static __thread int64_t thread_queue_id = 0;
+  static __thread int64_t thread_ring_index = -1;
+  if (OB_UNLIKELY(thread_queue_id != queue_id_)) {
+    // claim a ring only while any is left, so claimed_ring_count_ never grows past ring_count_
+    int64_t index = ATOMIC_LOAD(&claimed_ring_count_);
+    int64_t old_index = 0;
+    while (index < ring_count_
+           && index != (old_index = ATOMIC_VCAS(&claimed_ring_count_, index, index + 1))) {
+      index = old_index;
+    }
+    thread_ring_index = (index < ring_count_) ? index : -1;
+    thread_queue_id = queue_id_;
+  }
+  return (OB_LIKELY(thread_ring_index >= 0)) ? &rings_[thread_ring_index] : NULL;
+}
+
 void ObSqlauditRecordQueue::enqueue(const int64_t sm_id, const int64_t gmt_create,
-    const ObCmdTimeStat cmd_time_stat, const ObIpEndpoint &ip, const ObString &sql,
-    const obmysql::ObMySQLCmd sql_cmd)
+    const ObCmdTimeStat &cmd_time_stat, const ObIpEndpoint &ip, const ObString &sql,
+    const obmysql::ObMySQLCmd sql_cmd, const ObString &sql_id, const ObString &route_type,
+    const int64_t request_bytes, const int64_t response_bytes)
 {
-  if (is_inited_) {
-    int64_t audit_id = ATOMIC_FAA((int64_t *)&audit_id_, 1);
-    int64_t index = audit_id % current_records_list_len_;
-    sqlaudit_records_[index].audit_id_ = audit_id;
-    sqlaudit_records_[index].sm_id_ = sm_id;
-    sqlaudit_records_[index].gmt_create_ = gmt_create;
-    sqlaudit_records_[index].cmd_time_stat_ = cmd_time_stat;
-    ip.to_string(sqlaudit_records_[index].ip_, ObSqlauditRecord::IP_LENGTH);
-    sql.to_string(sqlaudit_records_[index].sql_, ObSqlauditRecord::SQL_LENGTH);
-
-    ObString cmd = ObString::make_string(get_mysql_cmd_str(sql_cmd));
-    cmd.to_string(sqlaudit_records_[index].sql_cmd_, ObSqlauditRecord::SQL_CMD_LENGTH);
+  ObSqlauditRing *ring = NULL;
+  if (!is_inited_) {
+    // do nothing
+  } else if (OB_LIKELY(NULL != (ring = get_thread_ring()))) {
+    write_record(*ring, sm_id, gmt_create, cmd_time_stat, ip, sql, sql_cmd,
+                 sql_id, route_type, request_bytes, response_bytes);
+  } else if (OB_SUCCESS == shared_ring_lock_.trylock()) {
+    // more threads than rings, the late ones share the last ring
+    write_record(rings_[ring_count_], sm_id, gmt_create, cmd_time_stat, ip, sql, sql_cmd,
+                 sql_id, route_type, request_bytes, response_bytes);
+    (void)shared_ring_lock_.unlock();
+  } else {
+    // never wait for the shared ring on the request path
+    (void)ATOMIC_FAA(&drop_count_, 1);
+  }
+}
+
+void ObSqlauditRecordQueue::write_record(ObSqlauditRing &ring, const int64_t sm_id,
+    const int64_t gmt_create, const ObCmdTimeStat &cmd_time_stat, const ObIpEndpoint &ip,
+    const ObString &sql, const obmysql::ObMySQLCmd sql_cmd, const ObString &sql_id,
+    const ObString &route_type, const int64_t request_bytes, const int64_t response_bytes)
+{
+  const int64_t sql_len = std::min(static_cast<int64_t>(sql.length()), max_sql_len_);
+  const int64_t record_len = ob_roundup(static_cast<int64_t>(sizeof(ObSqlauditRecord)) + sql_len + RECORD_FOOTER_LEN,
+                                        RECORD_ALIGN);
+  const int64_t capacity = ring.capacity_;
+  int64_t tail = ring.tail_;
+  int64_t pos = tail % capacity;
+
+  if (capacity - pos < record_len) {
+    // not enough space at the end of ring, pad it and start from the head
+    const int64_t padding_len = (capacity - pos) | RECORD_PADDING_FLAG;
+    MEMCPY(ring.buf_ + capacity - RECORD_FOOTER_LEN, &padding_len, RECORD_FOOTER_LEN);
+    tail += capacity - pos;
+    pos = 0;
   }
+
+  ObSqlauditRecord *record = reinterpret_cast<ObSqlauditRecord *>(ring.buf_ + pos);
+  record->audit_id_ = ATOMIC_FAA(&audit_id_, 1);
+  record->sm_id_ = sm_id;
+  record->gmt_create_ = gmt_create;
+  record->cmd_time_stat_ = cmd_time_stat;
+  record->request_bytes_ = request_bytes;
+  record->response_bytes_ = response_bytes;
+  record->record_len_ = record_len;
+  record->sql_len_ = sql_len;
+  ip.to_string(record->ip_, ObSqlauditRecord::IP_LENGTH);
+  ObString cmd = ObString::make_string(get_mysql_cmd_str(sql_cmd));
+  cmd.to_string(record->sql_cmd_, ObSqlauditRecord::SQL_CMD_LENGTH);
+  sql_id.to_string(record->sql_id_, ObSqlauditRecord::SQL_ID_LENGTH);
+  route_type.to_string(record->route_type_, ObSqlauditRecord::ROUTE_TYPE_LENGTH);
+  MEMCPY(record->get_sql(), sql.ptr(), sql_len);
+  MEMCPY(ring.buf_ + pos + record_len - RECORD_FOOTER_LEN, &record_len, RECORD_FOOTER_LEN);
+
+  // publish the record after it is completely written
+  MEM_BARRIER();
+  ATOMIC_STORE(&ring.tail_, tail + record_len);
 }
 
 // ObSqlauditProcessor
@@ -289,7 +450,8 @@ int ObSqlauditProcessor::init_sqlaudit_record_queue(int64_t sqlaudit_mem_limited
     if (OB_ISNULL(queue = new (std::nothrow) ObSqlauditRecordQueue())) {
       ret = OB_ALLOCATE_MEMORY_FAILED;
       WARN_ICMD("fail to new ObSqlauditRecordQueue", K(ret));
-    } else if (OB_FAIL(queue->init(sqlaudit_mem_limited))) {
+    } else if (OB_FAIL(queue->init(sqlaudit_mem_limited,
+        std::max(g_event_processor.thread_count_for_type_[ET_CALL], 1L)))) {
       delete queue;
       WARN_ICMD("fail to init ObSqlauditRecordQueue", K(ret));
     } else {
@@ -382,6 +544,10 @@ enum
   OB_SSA_OK_PACKET_TRIM_TIME,
   OB_SSA_CLIENT_RESPONSE_WRITE_TIME,
   OB_SSA_REQUEST_TOTAL_TIME,
+  OB_SSA_SQL_ID,
+  OB_SSA_ROUTE_TYPE,
+  OB_SSA_REQUEST_BYTES,
+  OB_SSA_RESPONSE_BYTES,
 
   OB_SSA_MAX_COLUMN_ID
 };
@@ -421,7 +587,11 @@ const ObProxyColumnSchema SSA_COLUMN_ARRAY[OB_SSA_MAX_COLUMN_ID] = {
     ObProxyColumnSchema::make_schema(OB_SSA_SERVER_RESPONSE_ANALYZE_TIME,        "server_response_analyze_ns", obmysql::OB_MYSQL_TYPE_LONG),
     ObProxyColumnSchema::make_schema(OB_SSA_OK_PACKET_TRIM_TIME,                 "ok_packet_trim_ns", obmysql::OB_MYSQL_TYPE_LONG),
     ObProxyColumnSchema::make_schema(OB_SSA_CLIENT_RESPONSE_WRITE_TIME,          "client_response_write_ns", obmysql::OB_MYSQL_TYPE_LONG),
-    ObProxyColumnSchema::make_schema(OB_SSA_REQUEST_TOTAL_TIME,                  "request_total_ns", obmysql::OB_MYSQL_TYPE_LONG)
+    ObProxyColumnSchema::make_schema(OB_SSA_REQUEST_TOTAL_TIME,                  "request_total_ns", obmysql::OB_MYSQL_TYPE_LONG),
+    ObProxyColumnSchema::make_schema(OB_SSA_SQL_ID,                              "sql_id", obmysql::OB_MYSQL_TYPE_VARCHAR),
+    ObProxyColumnSchema::make_schema(OB_SSA_ROUTE_TYPE,                          "route_type", obmysql::OB_MYSQL_TYPE_VARCHAR),
+    ObProxyColumnSchema::make_schema(OB_SSA_REQUEST_BYTES,                       "request_bytes", obmysql::OB_MYSQL_TYPE_LONGLONG),
+    ObProxyColumnSchema::make_schema(OB_SSA_RESPONSE_BYTES,                      "response_bytes", obmysql::OB_MYSQL_TYPE_LONGLONG)
 };
 
 ObShowSqlauditHandler::ObShowSqlauditHandler(ObContinuation *cont, ObMIOBuffer *buf,
@@ -478,8 +648,11 @@ int ObShowSqlauditHandler::handle_show_sqlaudit(int event, ObEvent *e)
       }
 
       if (sqlaudit_argument_valid && OB_SUCC(ret)) {
-        while ((NULL != (record = it->next())) && OB_SUCC(ret)) {
-          if (match_like(record->sql_, like_name_) && OB_FAIL(dump_sqlaudit_record(*record))) {
+        if (OB_FAIL(it->open(like_name_))) {
+          WARN_ICMD("fail to open sqlaudit iterator", K(ret));
+        }
+        while (OB_SUCC(ret) && (NULL != (record = it->next()))) {
+          if (OB_FAIL(dump_sqlaudit_record(*record))) {
             WARN_ICMD("fail to dump_sqlaudit_record");
           }
         }
@@ -540,7 +713,7 @@ int ObShowSqlauditHandler::dump_sqlaudit_record(ObSqlauditRecord &record)
   cells[OB_SSA_SM_ID].set_int(record.sm_id_);
   cells[OB_SSA_GMT_CREATE].set_timestamp(hrtime_to_usec(HRTIME_HOURS(8) + record.gmt_create_));
   cells[OB_SSA_SVR_IP_PORT].set_varchar(record.ip_);
-  cells[OB_SSA_SQL_CONTENT].set_varchar(record.sql_);
+  cells[OB_SSA_SQL_CONTENT].set_varchar(ObString(static_cast<int32_t>(record.sql_len_), record.get_sql()));
   cells[OB_SSA_SQL_CMD_CONTENT].set_varchar(record.sql_cmd_);
 
   cells[OB_SSA_PL_PROCESS_TIME].set_int(record.cmd_time_stat_.pl_process_time_);
@@ -573,6 +746,11 @@ int ObShowSqlauditHandler::dump_sqlaudit_record(ObSqlauditRecord &record)
   cells[OB_SSA_OK_PACKET_TRIM_TIME].set_int(record.cmd_time_stat_.ok_packet_trim_time_);
   cells[OB_SSA_REQUEST_TOTAL_TIME].set_int(record.cmd_time_stat_.request_total_time_);
 
+  cells[OB_SSA_SQL_ID].set_varchar(record.sql_id_);
+  cells[OB_SSA_ROUTE_TYPE].set_varchar(record.route_type_);
+  cells[OB_SSA_REQUEST_BYTES].set_int(record.request_bytes_);
+  cells[OB_SSA_RESPONSE_BYTES].set_int(record.response_bytes_);
+
   row.cells_ = cells;
   row.count_ = OB_SSA_MAX_COLUMN_ID;
   if (OB_FAIL(encode_row_packet(row))) {
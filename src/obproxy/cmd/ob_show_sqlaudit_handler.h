@@ -13,6 +13,7 @@
 #ifndef OBPROXY_SHOW_SQLAUDIT_HANDLER_H
 #define OBPROXY_SHOW_SQLAUDIT_HANDLER_H
 
+#include "lib/lock/ob_spin_lock.h"
 #include "cmd/ob_internal_cmd_handler.h"
 #include "proxy/mysql/ob_mysql_sm_time_stat.h"
 
@@ -23,29 +24,57 @@ namespace obproxy
 namespace proxy
 {
 
+/*
+ * Variable length record in ObSqlauditRing:
+ *   | ObSqlauditRecord | sql (sql_len_ bytes) | padding | footer (record_len_) |
+ * record_len_ is 8 bytes aligned, the footer lets reader walk the ring backward.
+ */
 struct ObSqlauditRecord
 {
-  static const int32_t RECORD_SIZE = 512;
-  static const int32_t MAX_CHAR_LENGTH = RECORD_SIZE
-                                       - sizeof(ObCmdTimeStat)
-                                       - (3 * sizeof(int64_t));
   static const int32_t IP_LENGTH = 24;
   static const int32_t SQL_CMD_LENGTH = 32;
+  static const int32_t SQL_ID_LENGTH = common::OB_MAX_SQL_ID_LENGTH + 1;
+  static const int32_t ROUTE_TYPE_LENGTH = 48;
+
+  const char *get_sql() const { return reinterpret_cast<const char *>(this + 1); }
+  char *get_sql() { return reinterpret_cast<char *>(this + 1); }
 
-  static const int32_t SQL_LENGTH = MAX_CHAR_LENGTH - IP_LENGTH - SQL_CMD_LENGTH;
+  TO_STRING_KV(K_(audit_id), K_(sm_id), K_(record_len), K_(sql_len), K_(sql_id), K_(route_type));
 
   int64_t audit_id_;
   int64_t sm_id_;
   ObHRTime gmt_create_;
   ObCmdTimeStat cmd_time_stat_;
+  int64_t request_bytes_;
+  int64_t response_bytes_;
+  int64_t record_len_;
+  int64_t sql_len_;
   char ip_[IP_LENGTH];
-  char sql_[SQL_LENGTH];
   char sql_cmd_[SQL_CMD_LENGTH];
+  char sql_id_[SQL_ID_LENGTH];
+  char route_type_[ROUTE_TYPE_LENGTH];
 };
 
+/*
+ * Byte ring written by only one work thread, so enqueue needs no lock or cas:
+ * the record is written first, then tail_ is published with a release store.
+ * The shared ring has many writers, they are serialized by a lock.
+ * Reader copies a record and checks tail_ again, the record is valid only if
+ * the writer has not wrapped onto it meanwhile.
+ */
+struct ObSqlauditRing
+{
+  ObSqlauditRing() : buf_(NULL), capacity_(0), tail_(0) {}
+
+  char *buf_;
+  int64_t capacity_;
+  volatile int64_t tail_; // total bytes ever written
+} CACHE_ALIGNED;
+
 class ObSqlauditRecordQueue : public common::ObRefCountObj
 {
 public:
+  // consistent snapshot of the matched records, ordered by audit_id
   class Iterator
   {
   public:
@@ -54,52 +83,79 @@ public:
              const int64_t audit_id_limit);
     Iterator(ObSqlauditRecordQueue &sql_audit_record_queue,
              const int64_t sm_id);
-    ~Iterator() { }
+    ~Iterator() { destroy(); }
 
+    int open(const common::ObString &like_name);
     ObSqlauditRecord *next();
     bool is_overlap() const { return is_overlap_; }
 
   private:
-    static const double RETAIN_RATIO = 0.1;
+    int collect_ring(const ObSqlauditRing &ring, const common::ObString &like_name);
+    bool is_match(const ObSqlauditRecord &record, const common::ObString &like_name) const;
+    void destroy();
 
+  private:
     ObSqlauditRecordQueue &sql_audit_record_queue_;
     bool is_overlap_;
 
     const int64_t sm_id_;
+    // only used in 'limit m,n', offset < 0 means the last n records
+    const int64_t audit_id_offset_;
+    const int64_t audit_id_limit_;
 
-    int64_t min_audit_id_;
-    int64_t max_audit_id_;
-
-    int64_t reserved_len_;
+    common::ObArenaAllocator allocator_;
+    common::ObSEArray<ObSqlauditRecord *, 64> records_;
     int64_t cur_index_;
-    int64_t ndone_;
 
   private:
     DISALLOW_COPY_AND_ASSIGN(Iterator);
   };
 
 public:
+  static const int64_t MAX_SQL_LENGTH = 16 * 1024;
+
   ObSqlauditRecordQueue();
   virtual ~ObSqlauditRecordQueue() { destroy(); }
 
   bool is_init() const { return is_inited_; }
   int64_t get_current_memory_size() const { return current_memory_size_; }
+  int64_t get_drop_count() const { return drop_count_; }
 
-  int init(const int64_t available_memory_size);
+  // the memory is split into ring_count rings, one ring for each work thread,
+  // and a shared ring for the threads coming after all rings are claimed
+  int init(const int64_t available_memory_size, const int64_t ring_count);
   void enqueue(const int64_t sm_id, const int64_t gmt_create,
-               const ObCmdTimeStat cmd_time_stat, const net::ObIpEndpoint &ip,
-               const ObString &sql, const obmysql::ObMySQLCmd sql_cmd);
+               const ObCmdTimeStat &cmd_time_stat, const net::ObIpEndpoint &ip,
+               const ObString &sql, const obmysql::ObMySQLCmd sql_cmd,
+               const ObString &sql_id, const ObString &route_type,
+               const int64_t request_bytes, const int64_t response_bytes);
 
 private:
   void destroy();
+  ObSqlauditRing *get_thread_ring();
+  void write_record(ObSqlauditRing &ring, const int64_t sm_id, const int64_t gmt_create,
+                    const ObCmdTimeStat &cmd_time_stat, const net::ObIpEndpoint &ip,
+                    const ObString &sql, const obmysql::ObMySQLCmd sql_cmd,
+                    const ObString &sql_id, const ObString &route_type,
+                    const int64_t request_bytes, const int64_t response_bytes);
+  // bytes before tail - capacity + get_inflight_len() may be overwritten by the writer
+  int64_t get_inflight_len() const { return 2 * max_record_len_; }
 
 private:
   bool is_inited_;
+  int64_t queue_id_;
   int64_t audit_id_;
-  ObSqlauditRecord *sqlaudit_records_;
+  char *buf_;
+  ObSqlauditRing *rings_;
+  int64_t ring_count_;
+  int64_t claimed_ring_count_;
+  // rings_[ring_count_] is shared by the late threads, writers take turns by the lock
+  common::ObSpinLock shared_ring_lock_;
+  int64_t max_sql_len_;
+  int64_t max_record_len_;
+  int64_t drop_count_; // records dropped when the shared ring is busy
 
   int64_t current_memory_size_;
-  int64_t current_records_list_len_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ObSqlauditRecordQueue);
@@ -15,6 +15,9 @@
 #include "cmd/ob_show_stat_handler.h"
 #include "iocore/eventsystem/ob_event_processor.h"
 #include "iocore/eventsystem/ob_task.h"
+#include "obutils/ob_latency_histogram.h"
+#include "obutils/ob_sql_digest.h"
+#include "obutils/ob_proxy_config.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obmysql;
@@ -72,6 +75,11 @@ int ObShowStatHandler::handle_show_stat(int event, void *data)
       }
       record = g_stat_processor.get_all_records_next(const_cast<ObRecRecord *>(record));
     }
+    if (OB_SUCC(ret) && OB_FAIL(dump_latency_items())) {
+      WARN_ICMD("fail to dump latency items", K(ret));
+    } else if (OB_SUCC(ret) && OB_FAIL(dump_digest_items())) {
+      WARN_ICMD("fail to dump digest items", K(ret));
+    }
   }
 
   if (OB_SUCC(ret)) {
@@ -108,6 +116,135 @@ int ObShowStatHandler::dump_stat_item(const obproxy::ObRecRecord *record)
   return ret;
 }
 
+int ObShowStatHandler::dump_named_item(const char *name, const int64_t value)
+{
+  int ret = OB_SUCCESS;
+  if (match_like(name, like_name_)) {
+    ObNewRow row;
+    ObObj cells[OB_SC_MAX_STAT_COLUMN_ID];
+    cells[OB_SC_STAT_NAME].set_varchar(name);
+    cells[OB_SC_VALUE].set_int(value);
+    cells[OB_SC_PERSIST_TYPE].set_varchar(get_persist_type_str(RECP_NULL));
+
+    row.cells_ = cells;
+    row.count_ = OB_SC_MAX_STAT_COLUMN_ID;
+    if (OB_FAIL(encode_row_packet(row))) {
+      WARN_ICMD("fail to encode row packet", K(row), K(ret));
+    }
+  }
+  return ret;
+}
+
+// rows are named latency_<type>_<percentile>:<cluster>/<tenant>/<sql type>,
+// of what is recorded in the last one or two latency_histogram_window
+int ObShowStatHandler::dump_latency_items()
+{
+  int ret = OB_SUCCESS;
+  static const int64_t PERCENTILE_COUNT = 7;
+  static const char *PERCENTILE_NAMES[PERCENTILE_COUNT] = {"count", "avg", "p50", "p90", "p99", "p999", "max"};
+  const int64_t MAX_NAME_LEN = OB_PROXY_MAX_CLUSTER_NAME_LENGTH + OB_MAX_TENANT_NAME_LENGTH + 128;
+  char name[MAX_NAME_LEN];
+  ObLatencyHistogramManager &mgr = get_global_latency_histogram_mgr();
+  for (int64_t i = 0; OB_SUCC(ret) && i < ObLatencyHistogramManager::TABLE_SIZE; ++i) {
+    ObLatencyHistogramItem *item = mgr.get_item(i);
+    if (NULL != item) {
+      ObLatencyHistogramSet set;
+      item->merge_window(set, get_global_proxy_config().latency_histogram_window);
+      const ObString &cluster_name = item->get_cluster_name();
+      const ObString &tenant_name = item->get_tenant_name();
+      for (int64_t type = 0; OB_SUCC(ret) && type < LATENCY_MAX_TYPE; ++type) {
+        ObLatencyPercentiles percentiles;
+        ObLatencyHistogramManager::get_percentiles(set.histograms_[type], percentiles);
+        const int64_t values[PERCENTILE_COUNT] = {percentiles.count_, percentiles.avg_, percentiles.p50_,
+                                                  percentiles.p90_, percentiles.p99_, percentiles.p999_,
+                                                  percentiles.max_};
+        for (int64_t j = 0; OB_SUCC(ret) && j < PERCENTILE_COUNT; ++j) {
+          snprintf(name, MAX_NAME_LEN, "latency_%s_%s:%.*s/%.*s/%s",
+                   get_latency_type_name(static_cast<ObLatencyType>(type)), PERCENTILE_NAMES[j],
+                   cluster_name.length(), cluster_name.ptr(), tenant_name.length(), tenant_name.ptr(),
+                   get_print_stmt_name(item->get_stmt_type()));
+          if (OB_FAIL(dump_named_item(name, values[j]))) {
+            WARN_ICMD("fail to dump latency item", K(name), K(ret));
+          }
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+struct ObSqlDigestTimeCmp
+{
+  bool operator()(const ObSqlDigestItem *left, const ObSqlDigestItem *right) const
+  {
+    return left->stat_.total_time_us_ > right->stat_.total_time_us_;
+  }
+};
+
+// rows are named digest_<metric>:<tenant>/<database>/<fingerprint>, only the
+// heaviest sql_digest_top_count fingerprints are shown, ordered by total time
+int ObShowStatHandler::dump_digest_items()
+{
+  int ret = OB_SUCCESS;
+  static const int64_t METRIC_COUNT = 10;
+  static const char *METRIC_NAMES[METRIC_COUNT] = {"exec_count", "error_count", "route_miss_count",
+                                                   "total_time_us", "avg_time_us", "max_time_us",
+                                                   "server_time_us", "request_bytes", "response_bytes",
+                                                   "weight_error_us"};
+  const int64_t MAX_NAME_LEN = OB_MAX_TENANT_NAME_LENGTH + OB_MAX_DATABASE_NAME_LENGTH
+                               + ObSqlFingerprint::MAX_FINGERPRINT_LENGTH + 64;
+  char name[MAX_NAME_LEN];
+  ObSqlDigestTable &table = get_global_sql_digest_table();
+  const int64_t item_limit = table.get_item_limit();
+  ObSqlDigestItem *items = NULL;
+  const ObSqlDigestItem **sorted_items = NULL;
+  if (!table.is_inited()) {
+    // nothing recorded
+  } else if (OB_ISNULL(items = static_cast<ObSqlDigestItem *>(
+                         ob_malloc(sizeof(ObSqlDigestItem) * item_limit, ObModIds::OB_PROXY_STAT)))
+             || OB_ISNULL(sorted_items = static_cast<const ObSqlDigestItem **>(
+                         ob_malloc(sizeof(ObSqlDigestItem *) * item_limit, ObModIds::OB_PROXY_STAT)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    WARN_ICMD("fail to alloc mem for sql digest items", K(item_limit), K(ret));
+  } else {
+    const int64_t count = table.copy_items(items, get_global_proxy_config().sql_digest_top_count);
+    for (int64_t i = 0; i < count; ++i) {
+      sorted_items[i] = &items[i];
+    }
+    std::sort(sorted_items, sorted_items + count, ObSqlDigestTimeCmp());
+    for (int64_t i = 0; OB_SUCC(ret) && i < count; ++i) {
+      const ObSqlDigestItem &item = *sorted_items[i];
+      const ObSqlDigestStat &stat = item.stat_;
+      const ObString tenant_name = item.get_tenant_name();
+      const ObString database_name = item.get_database_name();
+      const ObString fingerprint = item.get_fingerprint();
+      const int64_t values[METRIC_COUNT] = {stat.exec_count_, stat.error_count_, stat.route_miss_count_,
+                                            stat.total_time_us_,
+                                            stat.exec_count_ > 0 ? stat.total_time_us_ / stat.exec_count_ : 0,
+                                            stat.max_time_us_, stat.server_time_us_, stat.request_bytes_,
+                                            stat.response_bytes_, item.weight_error_};
+      for (int64_t j = 0; OB_SUCC(ret) && j < METRIC_COUNT; ++j) {
+        snprintf(name, MAX_NAME_LEN, "digest_%s:%.*s/%.*s/%.*s", METRIC_NAMES[j],
+                 tenant_name.length(), tenant_name.ptr(), database_name.length(), database_name.ptr(),
+                 fingerprint.length(), fingerprint.ptr());
+        if (OB_FAIL(dump_named_item(name, values[j]))) {
+          WARN_ICMD("fail to dump digest item", K(name), K(ret));
+        }
+      }
+    }
+  }
+
+  if (NULL != items) {
+    ob_free(items);
+    items = NULL;
+  }
+  if (NULL != sorted_items) {
+    ob_free(sorted_items);
+    sorted_items = NULL;
+  }
+  return ret;
+}
+
 int ObShowStatHandler::dump_stat_header()
 {
   int ret = OB_SUCCESS;
@@ -33,6 +33,9 @@ private:
   int handle_show_stat(int event, void *data);
   int dump_stat_header();
   int dump_stat_item(const obproxy::ObRecRecord *record);
+  int dump_named_item(const char *name, const int64_t value);
+  int dump_latency_items();
+  int dump_digest_items();
   const common::ObString get_persist_type_str(const obproxy::ObRecPersistType type) const;
 
 private:
@@ -472,6 +472,8 @@ int ObDbConfigTenantCont::add_logic_tenant(const ObString &tenant_name)
       CWLockGuard guard(dbconfig_cache.rwlock_);
       if (OB_FAIL(dbconfig_cache.lt_map_.unique_set(tenant_info))) {
         LOG_WARN("fail to add tenant info", K(db_info_key_), K(ret));
+      } else if (OB_FAIL(dbconfig_cache.publish_snapshot())) {
+        LOG_WARN("fail to publish dbconfig snapshot", K(db_info_key_), K(ret));
       } else {
         LOG_DEBUG("succ to add logic tenant info", KPC(tenant_info));
       }
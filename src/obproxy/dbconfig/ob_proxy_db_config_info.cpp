@@ -25,6 +25,7 @@
 #include "lib/encrypt/ob_encrypted_helper.h"
 #include "iocore/eventsystem/ob_buf_allocator.h"
 #include "opsql/func_expr_resolver/proxy_expr/ob_proxy_expr.h"
+#include "opsql/func_expr_resolver/proxy_expr/ob_proxy_shard_rule_evaluator.h"
 #include "obutils/ob_proxy_sequence_utils.h"
 
 using namespace obsys;
@@ -774,8 +775,6 @@ int ObDbConfigLogicDb::get_database_prop(const ObString &prop_name, ObDataBasePr
 {
   int ret = OB_SUCCESS;
   db_prop = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   if (OB_FAIL(dp_array_.ccr_map_.get_refactored(prop_name, db_prop))) {
     ret = OB_ENTRY_NOT_EXIST;
   } else if (OB_ISNULL(db_prop) || !db_prop->is_avail()) {
@@ -868,8 +867,6 @@ int ObDbConfigLogicDb::get_database_var(ObDataBaseVar *&db_var)
 {
   int ret = OB_SUCCESS;
   db_var = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   if (OB_FAIL(dv_array_.ccr_map_.get_refactored(DATABASE_VARS, db_var))) {
     LOG_DEBUG("database variables does not exist", K(ret));
   } else if (OB_ISNULL(db_var) || !db_var->is_avail()) {
@@ -1288,8 +1285,6 @@ int ObDbConfigLogicDb::get_shard_tpo(ObShardTpo *&shard_tpo)
 
 inline int64_t ObDbConfigLogicDb::get_shard_tpo_count() const
 {
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   return st_array_.ccr_map_.count();
 }
 
@@ -1297,8 +1292,6 @@ int ObDbConfigLogicDb::get_shard_tpo_by_zone(ObShardTpo *&shard_tpo, bool use_zo
 {
   int ret = OB_SUCCESS;
   shard_tpo = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObShardTpo>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObShardTpo>::CCRHashMap &>(st_array_.ccr_map_);
   bool found = false;
   for (ObDbConfigChildArrayInfo<ObShardTpo>::CCRHashMap::iterator it = map.begin(); !found && it != map.end(); ++it) {
@@ -1603,11 +1596,28 @@ int ObShardRule::get_physic_index(const SqlFieldResult &sql_result,
       ObObj result_obj;
       ObSEArray<ObObj, 4> result_array;
       int64_t tmp_index = OBPROXY_MAX_DBMESH_ID;
+      int eval_ret = OB_NOT_SUPPORTED;
 
       LOG_DEBUG("begin to calc rule", K(rule));
 
+      if (NULL != rule.evaluator_) {
+        ObProxyShardRuleEvaluator::ObProxyShardRuleCalcCtx rule_ctx(physic_size, type, is_elastic_index);
+        eval_ret = rule.evaluator_->calc_index(sql_result, rule_ctx, tmp_index);
+      }
+
       ObProxyExprCalcItem calc_item(const_cast<SqlFieldResult*>(&sql_result));
-      if (OB_ISNULL(proxy_expr)) {
+      if (OB_NOT_SUPPORTED != eval_ret) {
+        // compiled rule, OB_NOT_SUPPORTED means it should be calculated by expr
+        if (OB_EXPR_COLUMN_NOT_EXIST == eval_ret) {
+          continue;
+        } else if (OB_SUCCESS != eval_ret) {
+          ret = eval_ret;
+          LOG_WARN("calc compiled shard rule failed", K(ret));
+        } else if (tmp_index < 0 || tmp_index >= physic_size) {
+          ret = OB_EXPR_CALC_ERROR;
+          LOG_WARN("invalid index", K(tmp_index), K(physic_size), K(ret));
+        }
+      } else if (OB_ISNULL(proxy_expr)) {
         ret = OB_ERR_UNEXPECTED;
         LOG_WARN("proxy expr is null unexpected", K(ret));
       } else if (OB_FAIL(proxy_expr->calc(expr_ctx, calc_item, result_array)) || result_array.empty()) {
@@ -1682,11 +1692,39 @@ int ObShardRule::get_physic_index_array(const SqlFieldResult &sql_result,
     ObProxyExprCtx expr_ctx(physic_size, type, is_elastic_index, &allocator);
     ObProxyExpr *proxy_expr = rule.expr_;
     ObSEArray<ObObj, 4> result_obj_array;
+    ObSEArray<int64_t, 4> eval_index_array;
+    int eval_ret = OB_NOT_SUPPORTED;
+    bool is_calculated = false;
 
     LOG_DEBUG("begin to calc rule", K(rule));
 
+    if (NULL != rule.evaluator_) {
+      ObProxyShardRuleEvaluator::ObProxyShardRuleCalcCtx rule_ctx(physic_size, type, is_elastic_index);
+      eval_ret = rule.evaluator_->calc_index_array(sql_result, rule_ctx, eval_index_array);
+    }
+
     ObProxyExprCalcItem calc_item(const_cast<SqlFieldResult*>(&sql_result));
-    if (OB_ISNULL(proxy_expr)) {
+    if (OB_NOT_SUPPORTED != eval_ret) {
+      // compiled rule, OB_NOT_SUPPORTED means it should be calculated by expr
+      if (OB_EXPR_COLUMN_NOT_EXIST == eval_ret) {
+        continue;
+      } else if (OB_SUCCESS != eval_ret) {
+        ret = eval_ret;
+        LOG_WARN("calc compiled shard rule failed", K(ret));
+      } else {
+        is_calculated = true;
+        index_array.reset();
+        for (int64_t i = 0; OB_SUCC(ret) && i < eval_index_array.count(); i++) {
+          const int64_t tmp_index = eval_index_array.at(i);
+          if (tmp_index < 0 || tmp_index >= physic_size) {
+            ret = OB_EXPR_CALC_ERROR;
+            LOG_WARN("invalid index", K(tmp_index), K(physic_size), K(ret));
+          } else if (OB_FAIL(index_array.push_back(tmp_index))) {
+            LOG_WARN("push back index failed", K(ret));
+          }
+        }
+      }
+    } else if (OB_ISNULL(proxy_expr)) {
       ret = OB_ERR_UNEXPECTED;
       LOG_WARN("proxy expr is null unexpected", K(ret));
     } else if (OB_FAIL(proxy_expr->calc(expr_ctx, calc_item, result_obj_array))) {
@@ -1697,6 +1735,7 @@ int ObShardRule::get_physic_index_array(const SqlFieldResult &sql_result,
         LOG_WARN("calc proxy expr failed", K(ret));
       }
     } else {
+      is_calculated = true;
       index_array.reset();
       // get value from result_obj_array, covert to int, save to index_array
       for (int64_t i = 0; OB_SUCC(ret) && i < result_obj_array.count(); i++) {
@@ -1713,25 +1752,25 @@ int ObShardRule::get_physic_index_array(const SqlFieldResult &sql_result,
           LOG_WARN("push back index failed", K(ret));
         }
       }
+    }
 
-      if (OB_SUCC(ret)) {
-        if (!last_index_array.empty()) {
-          if (last_index_array.count() != index_array.count()) {
-            ret = OB_ERR_UNEXPECTED;
-            LOG_WARN("count not equal", K(ret), K(last_index_array.count()), K(index_array.count()));
-          }
-          for (int64_t i = 0; OB_SUCC(ret) && i < last_index_array.count(); i++) {
-            if (last_index_array.at(i) != index_array.at(i)) {
-              ret = OB_ERR_DISTRIBUTED_NOT_SUPPORTED;
-              LOG_WARN("different physcic index is not supported", K(ret), K(i),
-                                  K(last_index_array.at(i)), K(index_array.at(i)));
-            }
+    if (OB_SUCC(ret) && is_calculated) {
+      if (!last_index_array.empty()) {
+        if (last_index_array.count() != index_array.count()) {
+          ret = OB_ERR_UNEXPECTED;
+          LOG_WARN("count not equal", K(ret), K(last_index_array.count()), K(index_array.count()));
+        }
+        for (int64_t i = 0; OB_SUCC(ret) && i < last_index_array.count(); i++) {
+          if (last_index_array.at(i) != index_array.at(i)) {
+            ret = OB_ERR_DISTRIBUTED_NOT_SUPPORTED;
+            LOG_WARN("different physcic index is not supported", K(ret), K(i),
+                                K(last_index_array.at(i)), K(index_array.at(i)));
           }
-        } else if (rules.count() > 1) {
-          for (int64_t i = 0; OB_SUCC(ret) && i < index_array.count(); i++) {
-            if (OB_FAIL(last_index_array.push_back(index_array.at(i)))) {
-              LOG_WARN("push back index failed", K(index_array.at(i)), K(ret));
-            }
+        }
+      } else if (rules.count() > 1) {
+        for (int64_t i = 0; OB_SUCC(ret) && i < index_array.count(); i++) {
+          if (OB_FAIL(last_index_array.push_back(index_array.at(i)))) {
+            LOG_WARN("push back index failed", K(index_array.at(i)), K(ret));
           }
         }
       }
@@ -1905,8 +1944,6 @@ int ObShardRouter::get_shard_rule(const ObString &tb_name, ObShardRule *&shard_r
 bool ObDbConfigLogicDb::is_shard_rule_empty()
 {
   bool bret = true;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &>(sr_array_.ccr_map_);
   for (ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap::iterator it = map.begin(); bret && it != map.end(); ++it) {
     if (it->mr_map_.count() != 0) {
@@ -1922,8 +1959,6 @@ int ObDbConfigLogicDb::get_shard_router(const ObString &tb_name, ObShardRouter *
   shard_router = NULL;
   ObShardRule *shard_rule = NULL;
   bool found = false;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &>(sr_array_.ccr_map_);
   for (ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap::iterator it = map.begin(); !found && it != map.end(); ++it) {
     if (OB_FAIL(it->mr_map_.get_refactored(tb_name, shard_rule))) {
@@ -1949,8 +1984,6 @@ int ObDbConfigLogicDb::get_shard_router(const ObString &tb_name, ObShardRouter *
 int ObDbConfigLogicDb::get_all_shard_table(ObIArray<ObString> &all_table)
 {
   int ret = OB_SUCCESS;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &>(sr_array_.ccr_map_);
   for (ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap::iterator it = map.begin(); it != map.end(); ++it) {
     ObShardRouter::MarkedRuleHashMap &mr_map = it->mr_map_;
@@ -2307,8 +2340,6 @@ int ObDbConfigLogicDb::get_shard_connector(const ObString &shard_name, ObShardCo
 {
   int ret = OB_SUCCESS;
   shard_conn = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   if (OB_SUCC(sc_array_.ccr_map_.get_refactored(shard_name, shard_conn))) {
     if (NULL != shard_conn && shard_conn->is_avail()) {
       shard_conn->inc_ref();
@@ -2780,6 +2811,10 @@ int ObDbConfigLogicTenant::parse_from_json(const Value &json_value)
         inc_ref();
         is_new_tenant_version = true;
         is_new_tenant = true;
+        int tmp_ret = OB_SUCCESS;
+        if (OB_SUCCESS != (tmp_ret = dbconfig_cache.publish_snapshot())) {
+          LOG_WARN("fail to publish dbconfig snapshot", K(tenant_name_), K(tmp_ret));
+        }
       }
     } else if (cur_tenant_info->is_version_changed(version_.config_string_)) {
       is_new_tenant_version = true;
@@ -2793,6 +2828,10 @@ int ObDbConfigLogicTenant::parse_from_json(const Value &json_value)
         CWLockGuard guard(dbconfig_cache.rwlock_);
         tmp_tenant = dbconfig_cache.lt_map_.remove(tenant_name_.config_string_);
         if (NULL != tmp_tenant) {
+          int tmp_ret = OB_SUCCESS;
+          if (OB_SUCCESS != (tmp_ret = dbconfig_cache.publish_snapshot())) {
+            LOG_WARN("fail to publish dbconfig snapshot", K(tenant_name_), K(tmp_ret));
+          }
           tmp_tenant->dec_ref(); // remember to remove new add tenant info
           tmp_tenant = NULL;
         }
@@ -2893,31 +2932,7 @@ int ObDbConfigLogicTenant::load_local_db(const Value &json_value)
 
 int ObDbConfigLogicTenant::acquire_random_logic_db(ObDbConfigLogicDb *&db_info)
 {
-  db_info = NULL;
-  int64_t idx = 0;
-  int ret = OB_SUCCESS;
-  const int64_t max_idx = ld_map_.count() - 1;
-  if (OB_FAIL(ObRandomNumUtils::get_random_num(0, max_idx, idx))) {
-    LOG_DEBUG("fail to get random num", K(idx), K(max_idx), K(ret));
-  } else {
-    ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-    obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
-    LDHashMap::iterator begin = ld_map_.begin();
-    LDHashMap::iterator end = ld_map_.end();
-    int64_t i = 0;
-    while (i < idx && begin != end) {
-      ++begin;
-      ++i;
-    }
-    if (begin == end) {
-      ret = OB_ERR_UNEXPECTED;
-      LOG_WARN("it arrived the end, it should not happened", K(idx), K(i), K(ret));
-    } else {
-      db_info = &(*begin);
-      db_info->inc_ref();
-    }
-  }
-  return ret;
+  return get_global_dbconfig_cache().acquire_random_logic_db(tenant_name_.config_string_, db_info);
 }
 
 int ObDbConfigLogicTenant::acquire_random_logic_db_with_auth(
@@ -2926,26 +2941,8 @@ int ObDbConfigLogicTenant::acquire_random_logic_db_with_auth(
                            ObShardUserPrivInfo &up_info,
                            ObDbConfigLogicDb *&db_info)
 {
-  int ret = OB_SUCCESS;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
-  LDHashMap::iterator end = ld_map_.end();
-  bool found = false;
-  for (LDHashMap::iterator it = ld_map_.begin(); !found && it != end; ++it) {
-    if (OB_FAIL(it->get_user_priv_info(username, host, up_info))) {
-      LOG_DEBUG("user priv info does not exist", K(username), K(host));
-    } else {
-      found = true;
-      db_info = &(*it);
-    }
-  }
-  if (!found) {
-    ret = OB_ENTRY_NOT_EXIST;
-    LOG_WARN("fail to get random logic db", K(username), K(host), K(ret));
-  } else if (NULL != db_info) {
-    db_info->inc_ref();
-  }
-  return ret;
+  return get_global_dbconfig_cache().acquire_random_logic_db_with_auth(tenant_name_.config_string_,
+                                                                       username, host, up_info, db_info);
 }
 
 //------ ObDbConfigLogicDb------
@@ -3466,10 +3463,14 @@ int ObDbConfigLogicDb::check_and_get_testload_table(std::string origin_name, std
   int ret = OB_SUCCESS;
   ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
   std::string find_key;
-  if (test_load_table_map_.size() == 0) {
+  if (!ATOMIC_LOAD(&is_test_load_table_map_inited_)) {
     obsys::CWLockGuard guard(dbconfig_cache.rwlock_);
-    if (test_load_table_map_.size() == 0 && OB_FAIL(init_test_load_table_map())) {
+    if (is_test_load_table_map_inited_) {
+      // inited by others
+    } else if (OB_FAIL(init_test_load_table_map())) {
       LOG_WARN("init testload table map error", K(ret), K(db_name_));
+    } else {
+      ATOMIC_STORE(&is_test_load_table_map_inited_, true);
     }
   }
 
@@ -3488,7 +3489,6 @@ int ObDbConfigLogicDb::check_and_get_testload_table(std::string origin_name, std
     buf[len] = '\0';
     find_key = std::string(buf, len);
 
-    obsys::CRLockGuard guardr(dbconfig_cache.rwlock_); //change to r-lock
     std::map<std::string, std::string>::iterator iter;
     iter = test_load_table_map_.find(find_key);
     if (iter != test_load_table_map_.end()) {
@@ -3799,8 +3799,6 @@ const ObString ObDbConfigLogicDb::get_sequence_table_name_from_router()
 {
   ObString ret_str;
   bool found = false;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap &>(sr_array_.ccr_map_);
   for (ObDbConfigChildArrayInfo<ObShardRouter>::CCRHashMap::iterator it = map.begin(); !found && it != map.end(); ++it) {
     if (!it->get_sequence_table().empty()) {
@@ -3834,23 +3832,167 @@ const ObString ObDbConfigLogicDb::get_sequence_table_name_from_variables()
 int ObDbConfigCache::get_all_logic_tenant(ObIArray<common::ObString> &all_tenant)
 {
   int ret = OB_SUCCESS;
-  obsys::CRLockGuard guard(rwlock_);
-  LTHashMap &map = const_cast<LTHashMap &>(lt_map_);
-  for (LTHashMap::iterator it = map.begin(); OB_SUCC(ret) && it != map.end(); ++it) {
-    if (OB_FAIL(all_tenant.push_back(it->tenant_name_.config_string_))) {
-      LOG_WARN("fail to push back tenant name", K(it->tenant_name_), K(ret));
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  for (int64_t i = 0; OB_SUCC(ret) && NULL != snapshot && i < snapshot->get_tenant_count(); ++i) {
+    const ObString &tenant_name = snapshot->get_tenant(i)->tenant_name_.config_string_;
+    if (OB_FAIL(all_tenant.push_back(tenant_name))) {
+      LOG_WARN("fail to push back tenant name", K(tenant_name), K(ret));
     }
   }
   return ret;
 }
 
+int ObDbConfigCache::get_all_logic_db(const ObString &tenant_name, ObIArray<common::ObString> &all_db)
+{
+  int ret = OB_SUCCESS;
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL != snapshot && NULL != (tenant = snapshot->get_tenant(tenant_name))) {
+    for (int64_t i = tenant->db_start_; OB_SUCC(ret) && i < tenant->db_start_ + tenant->db_count_; ++i) {
+      const ObString &db_name = snapshot->get_db(i)->db_name_.config_string_;
+      if (OB_FAIL(all_db.push_back(db_name))) {
+        LOG_WARN("fail to push back db name", K(tenant_name), K(db_name), K(ret));
+      }
+    }
+  }
+  return ret;
+}
+
+int ObDbConfigCache::acquire_random_logic_db(const ObString &tenant_name, ObDbConfigLogicDb *&db_info)
+{
+  int ret = OB_SUCCESS;
+  int64_t idx = 0;
+  db_info = NULL;
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL == snapshot || NULL == (tenant = snapshot->get_tenant(tenant_name))
+      || tenant->db_count_ <= 0) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_DEBUG("logic tenant has no logic db", K(tenant_name), K(ret));
+  } else if (OB_FAIL(ObRandomNumUtils::get_random_num(0, tenant->db_count_ - 1, idx))) {
+    LOG_DEBUG("fail to get random num", K(idx), KPC(tenant), K(ret));
+  } else {
+    db_info = snapshot->get_db(tenant->db_start_ + idx);
+    db_info->inc_ref();
+  }
+  return ret;
+}
+
+int ObDbConfigCache::acquire_random_logic_db_with_auth(const ObString &tenant_name,
+                                                       const ObString &username,
+                                                       const ObString &host,
+                                                       ObShardUserPrivInfo &up_info,
+                                                       ObDbConfigLogicDb *&db_info)
+{
+  int ret = OB_SUCCESS;
+  bool found = false;
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL != snapshot && NULL != (tenant = snapshot->get_tenant(tenant_name))) {
+    for (int64_t i = tenant->db_start_; !found && i < tenant->db_start_ + tenant->db_count_; ++i) {
+      ObDbConfigLogicDb *tmp_db_info = snapshot->get_db(i);
+      if (OB_FAIL(tmp_db_info->get_user_priv_info(username, host, up_info))) {
+        LOG_DEBUG("user priv info does not exist", K(username), K(host));
+      } else {
+        found = true;
+        db_info = tmp_db_info;
+      }
+    }
+  }
+  if (!found) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_WARN("fail to get random logic db", K(username), K(host), K(ret));
+  } else if (NULL != db_info) {
+    db_info->inc_ref();
+  }
+  return ret;
+}
+
+int ObDbConfigCache::publish_snapshot()
+{
+  int ret = OB_SUCCESS;
+  ObDbConfigSnapshot *snapshot = NULL;
+  ObDbConfigSnapshot *old_snapshot = NULL;
+  const int64_t version = snapshot_version_ + 1;
+  if (OB_ISNULL(snapshot = op_alloc(ObDbConfigSnapshot))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc memory for dbconfig snapshot", K(ret));
+  } else if (OB_FAIL(snapshot->init(version, lt_map_))) {
+    LOG_WARN("fail to init dbconfig snapshot", K(version), K(ret));
+    op_free(snapshot);
+    snapshot = NULL;
+  } else {
+    old_snapshot = snapshot_;
+    MEM_BARRIER();
+    ATOMIC_STORE(&snapshot_, snapshot);
+    ATOMIC_STORE(&snapshot_version_, version);
+    // readers which may still see the old snapshot are all in critical section
+    WaitQuiescent(qsync_);
+    if (NULL != old_snapshot) {
+      op_free(old_snapshot);
+      old_snapshot = NULL;
+    }
+    LOG_DEBUG("succ to publish dbconfig snapshot", KPC(snapshot));
+  }
+  return ret;
+}
+
+//------ ObDbConfigSnapshot------
+int ObDbConfigSnapshot::init(const int64_t version, ObDbConfigCache::LTHashMap &lt_map)
+{
+  int ret = OB_SUCCESS;
+  version_ = version;
+  for (ObDbConfigCache::LTHashMap::iterator it = lt_map.begin(); OB_SUCC(ret) && it != lt_map.end(); ++it) {
+    ObDbConfigSnapshotTenant tenant;
+    tenant.hash_ = it->tenant_name_.config_string_.hash();
+    tenant.tenant_info_ = &(*it);
+    tenant.db_start_ = db_array_.count();
+    ObDbConfigLogicTenant::LDHashMap &ld_map = it->ld_map_;
+    for (ObDbConfigLogicTenant::LDHashMap::iterator db_it = ld_map.begin();
+         OB_SUCC(ret) && db_it != ld_map.end(); ++db_it) {
+      ObDbConfigSnapshotDb db;
+      db.hash_ = db_it->db_name_.config_string_.hash();
+      db.db_info_ = &(*db_it);
+      if (OB_FAIL(db_array_.push_back(db))) {
+        LOG_WARN("fail to push back db", K(db), K(ret));
+      } else {
+        db.db_info_->inc_ref();
+      }
+    }
+    if (OB_SUCC(ret)) {
+      tenant.db_count_ = db_array_.count() - tenant.db_start_;
+      if (OB_FAIL(tenant_array_.push_back(tenant))) {
+        LOG_WARN("fail to push back tenant", K(tenant), K(ret));
+      } else {
+        tenant.tenant_info_->inc_ref();
+      }
+    }
+  }
+  return ret;
+}
+
+void ObDbConfigSnapshot::destroy()
+{
+  for (int64_t i = 0; i < db_array_.count(); ++i) {
+    db_array_.at(i).db_info_->dec_ref();
+  }
+  for (int64_t i = 0; i < tenant_array_.count(); ++i) {
+    tenant_array_.at(i).tenant_info_->dec_ref();
+  }
+  db_array_.reset();
+  tenant_array_.reset();
+  version_ = 0;
+}
+
 int ObDbConfigLogicDb::get_shard_prop(const common::ObString& shard_name,
                       ObShardProp* &shard_prop)
 {
   int ret = OB_SUCCESS;
   ObShardProp *tmp_shard_prop = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   if (OB_FAIL(sp_array_.ccr_map_.get_refactored(shard_name, tmp_shard_prop))) {
     LOG_WARN("fail to get shard prop", K(shard_name), K(ret));
   } else if (OB_ISNULL(tmp_shard_prop)) {
@@ -3871,8 +4013,6 @@ int ObDbConfigLogicDb::get_user_priv_info(
   int ret = OB_SUCCESS;
   up_info.reset();
   bool found = false;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
   ObDbConfigChildArrayInfo<ObDataBaseAuth>::CCRHashMap &map = const_cast<ObDbConfigChildArrayInfo<ObDataBaseAuth>::CCRHashMap &>(da_array_.ccr_map_);
   for (ObDbConfigChildArrayInfo<ObDataBaseAuth>::CCRHashMap::iterator it = map.begin(); !found && it != map.end(); ++it) {
     if (OB_FAIL(it->get_user_priv_info(username, host, up_info))) {
@@ -3924,7 +4064,6 @@ ObDbConfigChild *ObDbConfigCache::get_child_info(const ObDataBaseKey &key,
   ObDbConfigChild *child_info = NULL;
   ObDbConfigLogicDb *db_info = NULL;
   if (NULL != (db_info = get_exist_db_info(key))) {
-    obsys::CRLockGuard guard(rwlock_);
     switch(type) {
       case TYPE_DATABASE_AUTH:
         db_info->da_array_.ccr_map_.get_refactored(name, reinterpret_cast<ObDataBaseAuth *&>(child_info));
@@ -4203,6 +4342,12 @@ int ObDbConfigCache::handle_new_db_info(ObDbConfigLogicDb &db_info, bool is_from
         db_info.set_need_dump_config(true);
       }
     }
+    // the replaced db info is still referenced by old snapshot,
+    // it is released after all readers of old snapshot leave
+    int tmp_ret = OB_SUCCESS;
+    if (OB_SUCCESS != (tmp_ret = publish_snapshot())) {
+      LOG_WARN("fail to publish dbconfig snapshot", K(db_name), K(tenant_name), K(tmp_ret));
+    }
   }
 
   if (NULL != tenant_info) {
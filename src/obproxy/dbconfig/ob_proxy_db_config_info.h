@@ -14,6 +14,8 @@
 #define OBPROXY_DB_CONFIG_INFO_H
 
 #include "lib/hash/ob_build_in_hashmap.h"
+#include "lib/allocator/ob_qsync.h"
+#include "lib/container/ob_se_array.h"
 #include "lib/json/ob_json.h"
 #include "share/schema/ob_priv_type.h"
 #include "dbconfig/ob_proxy_json_shard_config_info.h"
@@ -673,13 +675,14 @@ public:
   void set_shard_name(const common::ObString& str) {
     shard_name_.set_value(str);
   }
-  bool operator !=(const ObShardConnector &other) const
+  bool operator ==(const ObShardConnector &other) const
   {
-    return shard_name_ != other.shard_name_
-           || shard_type_ != other.shard_type_
-           || shard_url_ != other.shard_url_
-           || full_username_ != other.full_username_;
+    return shard_name_ == other.shard_name_
+           && shard_type_ == other.shard_type_
+           && shard_url_ == other.shard_url_
+           && full_username_ == other.full_username_;
   }
+  bool operator !=(const ObShardConnector &other) const { return !(*this == other); }
 
 public:
   static const int64_t OB_MAX_CONNECTOR_NAME_LENGTH = 128;
@@ -854,7 +857,8 @@ public:
                         testload_prefix_(), da_array_(),
                         dp_array_(), dv_array_(),
                         st_array_(), sr_array_(),
-                        sd_array_(), sc_array_(), sp_array_(), test_load_table_map_() {}
+                        sd_array_(), sc_array_(), sp_array_(),
+                        is_test_load_table_map_inited_(false), test_load_table_map_() {}
   virtual ~ObDbConfigLogicDb() {}
 
   virtual int to_json_str(common::ObSqlString &buf) const;
@@ -992,7 +996,8 @@ public:
   ObDbConfigChildArrayInfo<ObShardConnector> sc_array_;
   ObDbConfigChildArrayInfo<ObShardProp> sp_array_;
 
-  //testload table_map
+  //testload table_map, it is not changed after inited, so read it without lock
+  bool is_test_load_table_map_inited_;
   std::map<std::string, std::string> test_load_table_map_;
 
 private:
@@ -1058,10 +1063,11 @@ inline ObDbConfigLogicDb *ObDbConfigLogicTenant::get_exist_db(const common::ObSt
   return db_info;
 }
 
+class ObDbConfigSnapshot;
 class ObDbConfigCache
 {
 public:
-  ObDbConfigCache() : lt_map_(), rwlock_() {}
+  ObDbConfigCache() : lt_map_(), rwlock_(), qsync_(), snapshot_(NULL), snapshot_version_(0) {}
   ~ObDbConfigCache() {}
 
 public:
@@ -1086,8 +1092,15 @@ public:
   ObDbConfigLogicDb *get_exist_db_info(const ObDataBaseKey &key);
   ObDbConfigLogicDb *get_exist_db_info(const common::ObString &tenant_name,
                                        const common::ObString &db_name);
+  int acquire_random_logic_db(const common::ObString &tenant_name, ObDbConfigLogicDb *&db_info);
+  int acquire_random_logic_db_with_auth(const common::ObString &tenant_name,
+                                        const common::ObString &username,
+                                        const common::ObString &host,
+                                        ObShardUserPrivInfo &up_info,
+                                        ObDbConfigLogicDb *&db_info);
 
   int get_all_logic_tenant(common::ObIArray<common::ObString> &all_tenant);
+  int get_all_logic_db(const common::ObString &tenant_name, common::ObIArray<common::ObString> &all_db);
   ObDbConfigChild *get_child_info(const ObDataBaseKey &key, const common::ObString &name, const ObDDSCrdType type);
   ObDbConfigChild *get_avail_child_info(const ObDataBaseKey &key,
                                         const common::ObString &name, const ObDDSCrdType type);
@@ -1101,45 +1114,144 @@ public:
 
   int handle_new_db_info(ObDbConfigLogicDb &db_info, bool is_from_local=false);
 
+  // rebuild the snapshot from lt_map_ after lt_map_ or ld_map_ changed, rwlock_ must be wlocked
+  int publish_snapshot();
+  int64_t get_snapshot_version() const { return ATOMIC_LOAD(&snapshot_version_); }
 
 public:
+  // lt_map_ and ld_map_ of each tenant are only used by writer and admin cmd,
+  // requests look up in snapshot_ instead
   LTHashMap lt_map_;
   obsys::CRWLock rwlock_;
 
+private:
+  mutable common::ObQSync qsync_;
+  ObDbConfigSnapshot *snapshot_;
+  int64_t snapshot_version_;
+
 private:
   DISALLOW_COPY_AND_ASSIGN(ObDbConfigCache);
 };
 
-inline bool ObDbConfigCache::is_db_exist(const ObDataBaseKey &key) const
+/*
+ * Immutable copy of lt_map_ and the ld_map_ of each tenant, rebuilt by writer
+ * each time the maps change and published by swapping ObDbConfigCache::snapshot_.
+ *
+ * Readers look up within CriticalGuard(qsync_) and inc_ref the tenant or db they
+ * found. The snapshot holds a ref of each tenant and db, and the writer waits
+ * quiescent before freeing the old one, so nothing is freed under a reader.
+ *
+ * A published logic db is never changed (a new db info is built and replaced
+ * as a whole), so after a statement pins its db info, the children of the db
+ * are read without any lock.
+ */
+class ObDbConfigSnapshot
+{
+public:
+  struct ObDbConfigSnapshotTenant
+  {
+    ObDbConfigSnapshotTenant() : hash_(0), tenant_info_(NULL), db_start_(0), db_count_(0) {}
+    TO_STRING_KV(K_(hash), KP_(tenant_info), K_(db_start), K_(db_count));
+
+    uint64_t hash_;
+    ObDbConfigLogicTenant *tenant_info_;
+    // dbs of tenant are db_array_[db_start_, db_start_ + db_count_)
+    int64_t db_start_;
+    int64_t db_count_;
+  };
+
+  struct ObDbConfigSnapshotDb
+  {
+    ObDbConfigSnapshotDb() : hash_(0), db_info_(NULL) {}
+    TO_STRING_KV(K_(hash), KP_(db_info));
+
+    uint64_t hash_;
+    ObDbConfigLogicDb *db_info_;
+  };
+
+public:
+  ObDbConfigSnapshot() : version_(0), tenant_array_(), db_array_() {}
+  ~ObDbConfigSnapshot() { destroy(); }
+
+  int init(const int64_t version, ObDbConfigCache::LTHashMap &lt_map);
+  // release the refs of tenants and dbs
+  void destroy();
+
+  // tenant count is small, a linear search with hash is enough
+  const ObDbConfigSnapshotTenant *get_tenant(const common::ObString &tenant_name) const;
+  ObDbConfigLogicDb *get_db(const ObDbConfigSnapshotTenant &tenant, const common::ObString &db_name) const;
+  ObDbConfigLogicDb *get_db(const int64_t idx) const { return db_array_.at(idx).db_info_; }
+  int64_t get_version() const { return version_; }
+  int64_t get_tenant_count() const { return tenant_array_.count(); }
+  ObDbConfigLogicTenant *get_tenant(const int64_t idx) const { return tenant_array_.at(idx).tenant_info_; }
+
+  TO_STRING_KV(K_(version), "tenant_count", tenant_array_.count(), "db_count", db_array_.count());
+
+private:
+  int64_t version_;
+  common::ObSEArray<ObDbConfigSnapshotTenant, 4> tenant_array_;
+  common::ObSEArray<ObDbConfigSnapshotDb, 16> db_array_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObDbConfigSnapshot);
+};
+
+inline const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *ObDbConfigSnapshot::get_tenant(
+       const common::ObString &tenant_name) const
+{
+  const ObDbConfigSnapshotTenant *tenant = NULL;
+  const uint64_t hash = tenant_name.hash();
+  for (int64_t i = 0; NULL == tenant && i < tenant_array_.count(); ++i) {
+    const ObDbConfigSnapshotTenant &item = tenant_array_.at(i);
+    if (hash == item.hash_ && tenant_name == item.tenant_info_->tenant_name_.config_string_) {
+      tenant = &item;
+    }
+  }
+  return tenant;
+}
+
+inline ObDbConfigLogicDb *ObDbConfigSnapshot::get_db(const ObDbConfigSnapshotTenant &tenant,
+                                                     const common::ObString &db_name) const
 {
-  bool bret = false;
-  ObDbConfigLogicTenant *tenant_info = NULL;
   ObDbConfigLogicDb *db_info = NULL;
-  obsys::CRLockGuard guard(rwlock_);
-  if (common::OB_SUCCESS == lt_map_.get_refactored(key.tenant_name_.config_string_, tenant_info)) {
-    if (NULL != tenant_info
-       && common::OB_SUCCESS == tenant_info->ld_map_.get_refactored(key.database_name_.config_string_, db_info)) {
-      bret = true;
+  const uint64_t hash = db_name.hash();
+  for (int64_t i = tenant.db_start_; NULL == db_info && i < tenant.db_start_ + tenant.db_count_; ++i) {
+    const ObDbConfigSnapshotDb &item = db_array_.at(i);
+    if (hash == item.hash_ && db_name == item.db_info_->db_name_.config_string_) {
+      db_info = item.db_info_;
     }
   }
+  return db_info;
+}
+
+inline bool ObDbConfigCache::is_db_exist(const ObDataBaseKey &key) const
+{
+  bool bret = false;
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL != snapshot
+      && NULL != (tenant = snapshot->get_tenant(key.tenant_name_.config_string_))) {
+    bret = (NULL != snapshot->get_db(*tenant, key.database_name_.config_string_));
+  }
   return bret;
 }
 
 inline bool ObDbConfigCache::is_tenant_exist(const common::ObString &tenant_name) const
 {
-  ObDbConfigLogicTenant *tenant_info = NULL;
-  obsys::CRLockGuard guard(rwlock_);
-  return common::OB_SUCCESS == lt_map_.get_refactored(tenant_name, tenant_info);
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  return NULL != snapshot && NULL != snapshot->get_tenant(tenant_name);
 }
 
 inline ObDbConfigLogicTenant *ObDbConfigCache::get_exist_tenant(const common::ObString &tenant_name)
 {
   ObDbConfigLogicTenant *tenant_info = NULL;
-  obsys::CRLockGuard guard(rwlock_);
-  if (common::OB_SUCCESS == lt_map_.get_refactored(tenant_name, tenant_info)) {
-    if (NULL != tenant_info) {
-      tenant_info->inc_ref();
-    }
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL != snapshot && NULL != (tenant = snapshot->get_tenant(tenant_name))) {
+    tenant_info = tenant->tenant_info_;
+    tenant_info->inc_ref();
   }
   return tenant_info;
 }
@@ -1147,15 +1259,13 @@ inline ObDbConfigLogicTenant *ObDbConfigCache::get_exist_tenant(const common::Ob
 inline ObDbConfigLogicDb *ObDbConfigCache::get_exist_db_info(const ObDataBaseKey &key)
 {
   ObDbConfigLogicDb *db_info = NULL;
-  ObDbConfigLogicTenant *tenant_info = NULL;
-  obsys::CRLockGuard guard(rwlock_);
-  if (common::OB_SUCCESS == lt_map_.get_refactored(key.tenant_name_.config_string_, tenant_info)) {
-    if (NULL != tenant_info
-       && common::OB_SUCCESS == tenant_info->ld_map_.get_refactored(key.database_name_.config_string_, db_info)) {
-      if (NULL != db_info) {
-        db_info->inc_ref();
-      }
-    }
+  const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = NULL;
+  CriticalGuard(qsync_);
+  const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&snapshot_);
+  if (NULL != snapshot
+      && NULL != (tenant = snapshot->get_tenant(key.tenant_name_.config_string_))
+      && NULL != (db_info = snapshot->get_db(*tenant, key.database_name_.config_string_))) {
+    db_info->inc_ref();
   }
   return db_info;
 }
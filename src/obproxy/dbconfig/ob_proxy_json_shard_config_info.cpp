@@ -41,7 +41,7 @@ DEF_TO_STRING(ObProxyShardRuleInfo)
 }
 
 ObProxyShardRuleInfo::ObProxyShardRuleInfo()
-  : shard_rule_str_(), expr_(NULL)
+  : shard_rule_str_(), expr_(NULL), evaluator_(NULL)
 {
   reset();
 }
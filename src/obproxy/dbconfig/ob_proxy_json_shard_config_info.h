@@ -26,6 +26,7 @@ namespace obproxy
 namespace opsql
 {
 class ObProxyExpr;
+class ObProxyShardRuleEvaluator;
 }
 
 namespace dbconfig
@@ -44,6 +45,7 @@ public:
   {
     shard_rule_str_.reset();
     expr_ = NULL;
+    evaluator_ = NULL;
   }
 
   int assign(const ObProxyShardRuleInfo &other)
@@ -51,6 +53,7 @@ public:
     reset();
     shard_rule_str_.set_value(other.shard_rule_str_);
     expr_ = other.expr_;
+    evaluator_ = other.evaluator_;
     return common::OB_SUCCESS;
   }
 
@@ -61,6 +64,8 @@ public:
 
   obutils::ObProxyConfigString shard_rule_str_; //save sharding expr
   opsql::ObProxyExpr *expr_;
+  // compiled from expr_ if possible, NULL means calc with expr_
+  opsql::ObProxyShardRuleEvaluator *evaluator_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ObProxyShardRuleInfo);
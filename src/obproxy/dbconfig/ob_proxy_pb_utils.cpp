@@ -38,6 +38,7 @@
 #include "opsql/func_expr_parser/ob_func_expr_parse_result.h"
 #include "opsql/func_expr_parser/ob_func_expr_parser.h"
 #include "opsql/func_expr_resolver/ob_func_expr_resolver.h"
+#include "opsql/func_expr_resolver/proxy_expr/ob_proxy_shard_rule_evaluator.h"
 #include <google/protobuf/any.pb.h>
 #include <regex>
 
@@ -362,6 +363,12 @@ int ObProxyPbUtils::force_parse_groovy(const ObString &expr,
       LOG_WARN("parse failed", K(ret), K(parse_sql));
     } else if (OB_FAIL(resolver.resolve(result.param_node_, info.expr_))) {
       LOG_WARN("proxy expr resolve failed", K(ret));
+    } else {
+      int tmp_ret = OB_SUCCESS;
+      if (OB_SUCCESS != (tmp_ret = ObProxyShardRuleEvaluator::compile(info.expr_, allocator, info.evaluator_))) {
+        // rule is still calculated by expr
+        LOG_INFO("shard rule is not compiled", K(expr), K(tmp_ret));
+      }
     }
   }
 
@@ -281,12 +281,6 @@ int ObProxyAggOp::handle_response_result(void *data, bool is_final, ObProxyResul
   return ret;
 }
 
-int ObProxyHashAggOp::init() {
-  int ret = common::OB_SUCCESS;
-  result_rows_->nbuckets_ = BUCKET_BUF_SIZE;
-  return ret;
-}
-
 int ObProxyHashAggOp::handle_response_result(void *data, bool is_final, ObProxyResultResp *&result)
 {
   int ret = OB_SUCCESS;
@@ -316,7 +310,7 @@ int ObProxyHashAggOp::handle_response_result(void *data, bool is_final, ObProxyR
         LOG_DEBUG("ObProxyAggOp::handle_response_result fetched all rows", K(sum), K(ret));
       }
       LOG_DEBUG("ObProxyAggOp::handle_response_result fetch rows", K(row), K(*row), K(ret));
-      if (OB_FAIL(ob_agg_func_->add_row(row))) {
+      if (OB_FAIL(ob_agg_func_->add_hash_row(row))) {
         LOG_WARN("inner error to put rows", K(ret), K(op_name()));
         break;
       }
@@ -662,86 +656,43 @@ int ObAggregateFunction::handle_all_result(ResultRow *&row)
 int ObAggregateFunction::handle_all_hash_result(ResultRows *rows)
 {
   int ret = common::OB_SUCCESS;
-  bool has_inited_normal_cell = true;
-  void *buf = NULL;
   if (OB_ISNULL(rows)) {
     ret = common::OB_INVALID_ARGUMENT;
     LOG_WARN("invalid input", K(rows));
-  } else if (agg_rows_->count() > 0
-              && OB_NOT_NULL(agg_rows_->at(0))) {
-              //&& agg_rows_.at(0)->count == select_exprs_->count())) {
-    ObGbyHashCols *col = NULL;
-    int64_t rows_count = agg_rows_->count();
-    ResultRow *row = NULL;
-    for (int64_t i = 1; OB_SUCC(ret) && i < rows_count; i++) {
-      if (OB_ISNULL(row = rows->at(i))) {
-        ret = common::OB_ERROR;
-        LOG_WARN("invalid row to calc agg", K(ret));
-      } else {
-        buf = static_cast<ObGbyHashCols*>(allocator_.alloc(sizeof(ObGbyHashCols)));
-        col = new (buf) ObGbyHashCols();
-        if (OB_FAIL(col->init(row, group_col_idxs_, 0))) {
-          LOG_WARN("inner error to init hash_col", K(ret));
-        } else if (FALSE_IT(col->inner_hash())) {
-          // never be here
-        } else {
-          int loc = col->hash_val_ & BUCKET_MASK;
-          ObGbyHashCols* bucket = result_rows_->buckets_.at(loc);
-          if (OB_ISNULL(bucket)) {
-            result_rows_->buckets_.at(loc) = col;
-          } else {
-            ObGbyHashCols *head = result_rows_->buckets_[loc];
-            while (OB_NOT_NULL(head)) {
-              if (is_same_group(*head->row_, *col->row_)) {
-                if (OB_FAIL(cal_row_agg(*head->row_, *col->row_, has_inited_normal_cell))) { //TODO free col
-                  LOG_WARN("inner error to calc agg", K(ret));
-                }
-                break;
-              }
-              head = static_cast<ObGbyHashCols*>(head->next_);
-            }
-          }
-
-        }
-      }
+  } else if (OB_ISNULL(result_rows_)) {
+    ret = common::OB_NOT_INIT;
+    LOG_WARN("hash table is not inited", K(ret));
+  } else if (OB_FAIL(result_rows_->get_all_rows(*rows))) {
+    LOG_WARN("fail to get all group rows", K(ret));
+  } else {
+    /* rows were aggregated when they arrived, only sort groups here */
+    ObMemorySort *mem_sort_impl = NULL;
+    void *tmp_buf = NULL;
+    ResultRows *new_rows = NULL;
+    if (OB_ISNULL(tmp_buf = allocator_.alloc(sizeof(ResultRows)))) {
+      ret = common::OB_ALLOCATE_MEMORY_FAILED;
+      LOG_WARN("no have enough memory to init", K(ret), K(sizeof(ResultRows)));
+    } else if (OB_ISNULL(new_rows = new (tmp_buf) ResultRows(array_new_alloc_size, allocator_))) {
+      ret = common::OB_ERR_UNEXPECTED;
+      LOG_WARN("init ResultRows failed", K(ret), K(new_rows));
+    } else if (OB_ISNULL(tmp_buf = allocator_.alloc(sizeof(ObMemorySort)))) {
+      ret = common::OB_ALLOCATE_MEMORY_FAILED;
+      LOG_WARN("no have enough memory to init", K(ret), K(sizeof(ObMemorySort)));
+    } else {
+      mem_sort_impl = new (tmp_buf) ObMemorySort(*sort_columns_, allocator_, *new_rows);
     }
-
-    /* Get all result */
-    if (OB_SUCC(ret)) {
-      for (int i = 0; i < BUCKET_BUF_SIZE; i++) {
-        ObGbyHashCols *bucket = result_rows_->buckets_.at(i);
-        while (OB_NOT_NULL(bucket)) {
-            rows->push_back(bucket->row_);
-            bucket = static_cast<ObGbyHashCols*>(bucket->next_);
-        }
-      }
-      ObMemorySort *mem_sort_impl = NULL;//new ObMemorySort(sort_columns_);
-      void *tmp_buf = NULL;
-      ResultRows *new_rows = NULL;
-      if (OB_ISNULL(tmp_buf = allocator_.alloc(sizeof(ResultRows)))) {
-        ret = common::OB_ALLOCATE_MEMORY_FAILED;
-        LOG_WARN("no have enough memory to init", K(ret), K(sizeof(ResultRows)));
-      } else if (OB_ISNULL(new_rows = new (tmp_buf) ResultRows(array_new_alloc_size, allocator_))) {
-        ret = common::OB_ERR_UNEXPECTED;
-        LOG_WARN("init ResultRows failed", K(ret), K(new_rows));
-      } else if (OB_ISNULL(tmp_buf = allocator_.alloc(sizeof(ObMemorySort)))) {
-        ret = common::OB_ALLOCATE_MEMORY_FAILED;
-        LOG_WARN("no have enough memory to init", K(ret), K(sizeof(ObMemorySort)));
-      } else {
-        mem_sort_impl = new (tmp_buf) ObMemorySort(*sort_columns_, allocator_, *new_rows);
-      }
-      if (OB_ISNULL(mem_sort_impl)) {
-        ret = common::OB_ERROR;
-        LOG_WARN("inner error to init memory sort", K(ret));
-      } else {
-        mem_sort_impl->set_sort_rows(*rows);
-        if (OB_FAIL(mem_sort_impl->sort_rows())) {
-          LOG_WARN("memory sort error", K(ret));
-        } else if (OB_FAIL(mem_sort_impl->fetch_final_results(*rows))) {
-          LOG_WARN("memory sort error in ObProxySortOp", K(ret));
-        }
+    if (OB_ISNULL(mem_sort_impl)) {
+      ret = common::OB_ERROR;
+      LOG_WARN("inner error to init memory sort", K(ret));
+    } else {
+      mem_sort_impl->set_sort_rows(*rows);
+      if (OB_FAIL(mem_sort_impl->sort_rows())) {
+        LOG_WARN("memory sort error", K(ret));
+      } else if (OB_FAIL(mem_sort_impl->fetch_final_results(*rows))) {
+        LOG_WARN("memory sort error in ObProxySortOp", K(ret));
       }
     }
+    LOG_DEBUG("ObAggregateFunction::handle_all_hash_result end", K(ret), "group_count", result_rows_->size());
   }
   return ret;
 }
@@ -1143,6 +1094,119 @@ int ObAggregateFunction::add_row(ResultRow *row)
   return ret;
 }
 
+int ObAggregateFunction::add_hash_row(ResultRow *row)
+{
+  int ret = common::OB_SUCCESS;
+  // the first row of group keeps the normal cells
+  bool has_inited_normal_cell = true;
+  ResultRow *group_row = NULL;
+  if (OB_ISNULL(row)) {
+    ret = common::OB_INVALID_ARGUMENT;
+    LOG_WARN("inner error add_hash_row", K(row));
+  } else if (OB_ISNULL(result_rows_) || OB_ISNULL(group_col_idxs_)) {
+    ret = common::OB_NOT_INIT;
+    LOG_WARN("hash table is not inited", K(ret));
+  } else {
+    ObHashCols hash_cols(row, group_col_idxs_);
+    if (OB_FAIL(result_rows_->get_or_insert(hash_cols.hash(), row, *this, group_row))) {
+      LOG_WARN("fail to get or insert group", K(ret));
+    } else if (group_row != row
+               && OB_FAIL(cal_row_agg(*group_row, *row, has_inited_normal_cell))) {
+      LOG_WARN("inner error to calc agg", K(ret));
+    }
+  }
+  return ret;
+}
+
+void HashTable::reset()
+{
+  for (int64_t i = 0; i < PARTITION_COUNT; ++i) {
+    Partition &partition = partitions_[i];
+    if (OB_NOT_NULL(partition.buckets_)) {
+      allocator_.free(partition.buckets_);
+    }
+    partition.buckets_ = NULL;
+    partition.nbuckets_ = 0;
+    partition.size_ = 0;
+  }
+  size_ = 0;
+}
+
+int HashTable::extend(Partition &partition)
+{
+  int ret = common::OB_SUCCESS;
+  const int64_t new_nbuckets = (0 == partition.nbuckets_) ? PARTITION_INIT_BUCKET_COUNT : partition.nbuckets_ * 2;
+  Bucket *new_buckets = NULL;
+  if (OB_ISNULL(new_buckets = static_cast<Bucket *>(allocator_.alloc(sizeof(Bucket) * new_nbuckets)))) {
+    ret = common::OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("no have enough memory to extend hash partition", K(ret), K(new_nbuckets));
+  } else {
+    MEMSET(new_buckets, 0, sizeof(Bucket) * new_nbuckets);
+    const int64_t mask = new_nbuckets - 1;
+    for (int64_t i = 0; i < partition.nbuckets_; ++i) {
+      const Bucket &bucket = partition.buckets_[i];
+      if (OB_NOT_NULL(bucket.row_)) {
+        int64_t pos = static_cast<int64_t>(bucket.hash_val_) & mask;
+        while (OB_NOT_NULL(new_buckets[pos].row_)) {
+          pos = (pos + 1) & mask;
+        }
+        new_buckets[pos] = bucket;
+      }
+    }
+    if (OB_NOT_NULL(partition.buckets_)) {
+      allocator_.free(partition.buckets_);
+    }
+    partition.buckets_ = new_buckets;
+    partition.nbuckets_ = new_nbuckets;
+  }
+  return ret;
+}
+
+int HashTable::get_or_insert(const uint64_t hash_val, ResultRow *row,
+                             ObAggregateFunction &agg_func, ResultRow *&group_row)
+{
+  int ret = common::OB_SUCCESS;
+  Partition &partition = partitions_[get_partition_idx(hash_val)];
+  group_row = NULL;
+  // keep load factor under 1/2
+  if ((partition.size_ + 1) * 2 > partition.nbuckets_ && OB_FAIL(extend(partition))) {
+    LOG_WARN("fail to extend hash partition", K(ret));
+  } else {
+    const int64_t mask = partition.nbuckets_ - 1;
+    int64_t pos = static_cast<int64_t>(hash_val) & mask;
+    while (OB_ISNULL(group_row)) {
+      Bucket &bucket = partition.buckets_[pos];
+      if (OB_ISNULL(bucket.row_)) {
+        bucket.hash_val_ = hash_val;
+        bucket.row_ = row;
+        group_row = row;
+        ++partition.size_;
+        ++size_;
+      } else if (bucket.hash_val_ == hash_val && agg_func.is_same_group(*bucket.row_, *row)) {
+        group_row = bucket.row_;
+      } else {
+        pos = (pos + 1) & mask;
+      }
+    }
+  }
+  return ret;
+}
+
+int HashTable::get_all_rows(ResultRows &rows) const
+{
+  int ret = common::OB_SUCCESS;
+  for (int64_t i = 0; OB_SUCC(ret) && i < PARTITION_COUNT; ++i) {
+    const Partition &partition = partitions_[i];
+    for (int64_t j = 0; OB_SUCC(ret) && j < partition.nbuckets_; ++j) {
+      if (OB_NOT_NULL(partition.buckets_[j].row_)
+          && OB_FAIL(rows.push_back(partition.buckets_[j].row_))) {
+        LOG_WARN("fail to push back group row", K(ret));
+      }
+    }
+  }
+  return ret;
+}
+
 //When there's stored_row_ and reserved_cells_, use store_row's reserved_cells_ for calc hash.
 //Other, use row_ for calc hash
 uint64_t ObHashCols::inner_hash() const
@@ -28,7 +28,6 @@ typedef common::ObSEArray<common::ObColumnInfo, 4, common::ObIAllocator&> ObColI
 class ObAggregateFunction;
 class HashTable;
 class ObHashCols;
-class ObGbyHashCols;
 
 class ObColumnInfo
 {
@@ -47,35 +46,56 @@ public:
       N_COLLATION_TYPE, common::ObCharset::collation_name(cs_type_));
 };
 
+/*
+ * Open addressing hash table for hash group by. Groups are radix partitioned by the
+ * high bits of hash value, each partition is a small linear probing table which grows
+ * by itself, so a resize only rehashes one partition and probing stays in cache.
+ */
 class HashTable
 {
 public:
-  HashTable(common::ObIAllocator &allocator)
-        : allocator_(allocator),
-        buckets_(ObModIds::OB_SE_ARRAY_ENGINE, array_new_alloc_size),
-        nbuckets_(0),
-        buf_cnt_(0),
-        cur_(0)
-  {}
-
-  void reuse()
+  static const int64_t PARTITION_BITS = 4;
+  static const int64_t PARTITION_COUNT = 1L << PARTITION_BITS;
+  static const int64_t PARTITION_INIT_BUCKET_COUNT = 64;
+
+  struct Bucket
   {
-    cur_ = 0;
-  }
-  void reset()
+    uint64_t hash_val_;
+    ResultRow *row_;
+  };
+
+  struct Partition
+  {
+    Partition() : buckets_(NULL), nbuckets_(0), size_(0) {}
+    Bucket *buckets_;
+    int64_t nbuckets_;
+    int64_t size_;
+  };
+
+  HashTable(common::ObIAllocator &allocator)
+        : allocator_(allocator), size_(0) {}
+  ~HashTable() { reset(); }
+
+  void reset();
+  // find the group of row, row itself becomes the group row if not found
+  int get_or_insert(const uint64_t hash_val, ResultRow *row,
+                    ObAggregateFunction &agg_func, ResultRow *&group_row);
+  // push back group rows partition by partition
+  int get_all_rows(ResultRows &rows) const;
+  int64_t size() const { return size_; }
+
+private:
+  static int64_t get_partition_idx(const uint64_t hash_val)
   {
-    //buckets_.reset();
-    nbuckets_ = 0;
-    cur_ = 0;
+    return static_cast<int64_t>(hash_val >> (64 - PARTITION_BITS));
   }
+  int extend(Partition &partition);
 
-//protected:
-public:
+private:
   common::ObIAllocator &allocator_;
-  common::ObSEArray<ObGbyHashCols*, 1> buckets_;
-  int64_t nbuckets_;
-  int64_t buf_cnt_;
-  int64_t cur_;
+  Partition partitions_[PARTITION_COUNT];
+  int64_t size_;
+  DISALLOW_COPY_AND_ASSIGN(HashTable);
 };
 
 
@@ -138,6 +158,8 @@ public:
   int init(ObColInfoArray &group_col_idxs_);
 
   virtual int add_row(ResultRow *row);
+  // pre-aggregate row into its group as soon as it arrives
+  virtual int add_hash_row(ResultRow *row);
   virtual int handle_all_result(ResultRow *&row);
   virtual int handle_all_hash_result(ResultRows *rows);
   inline static bool is_int_int_out_of_range(int64_t val1, uint64_t val2, uint64_t res)
@@ -184,7 +206,6 @@ public:
       : row_(NULL),
         stored_row_(NULL),
         hash_col_idx_(NULL),
-        next_(NULL),
         hash_val_(0) {}
 
   ObHashCols(ResultRow *row,
@@ -192,7 +213,6 @@ public:
       : row_(row),
         stored_row_(NULL),
         hash_col_idx_(hash_col_idx),
-        next_(NULL),
         hash_val_(0) {}
 
   ~ObHashCols() {}
@@ -220,7 +240,6 @@ public:
 
   bool operator ==(const ObHashCols &other) const;
   void set_stored_row(const common::ObRowStore::StoredRow *stored_row);
-  ObHashCols *&next() { return *reinterpret_cast<ObHashCols **>(&next_); };
 
   TO_STRING_KV(K_(row), K_(hash_val));
 
@@ -228,22 +247,9 @@ public:
   ResultRow *row_;
   const common::ObRowStore::StoredRow *stored_row_;
   const common::ObIArray<common::ObColumnInfo> *hash_col_idx_;
-  void *next_;
   mutable uint64_t hash_val_;
 };
 
-class ObGbyHashCols : public ObHashCols
-{
-public:
-  ObGbyHashCols *&next() { return *reinterpret_cast<ObGbyHashCols **>(&next_); };
-public:
-  int64_t group_id_;
-};
-
-const int16_t BUCKET_BUF_SIZE = 1024;
-const int16_t BUCKET_SHIFT = 10;
-const int16_t BUCKET_MASK = 1023;
-
 class ObProxyAggOp : public ObProxyOperator
 {
 public:
@@ -322,17 +328,13 @@ class ObProxyHashAggOp : public ObProxyAggOp
 {
 public:
   ObProxyHashAggOp(ObProxyOpInput *input, common::ObIAllocator &allocator)
-    : ObProxyAggOp(input, allocator), result_rows_(NULL) {
+    : ObProxyAggOp(input, allocator) {
     set_op_type(PHY_HASH_AGG);
   }
 
   ~ObProxyHashAggOp() {};
 
-  virtual int init();
   virtual int handle_response_result(void *src, bool is_final, ObProxyResultResp *&result);
-
-private:
-  HashTable *result_rows_;
 };
 
 class ObProxyMergeAggOp : public ObProxyAggOp
@@ -108,16 +108,19 @@ int ObOperatorAsyncCommonTask::main_handler(int event, void *data)
     switch (event) {
       case VC_EVENT_READ_COMPLETE: {
         --target_task_count_;
-        if (OB_FAIL(ob_operator_->process_complete_data(data))) {
+        int64_t cont_index = 0; //TODO need to update pres->get_cont_index();
+        // clear the action before process, operator may start another round of task on it
+        if (OB_UNLIKELY(cont_index < 0) || OB_UNLIKELY(cont_index >= parallel_task_count_)) {
+          ret = OB_ERR_UNEXPECTED;
+          LOG_WARN("unexpected cont result", K(ob_operator_->op_name()), K(cont_index), K(parallel_task_count_), K(ret));
+        } else {
+          parallel_action_array_[cont_index] = NULL;
+        }
+        if (OB_FAIL(ret)) {
+          // do nothing
+        } else if (OB_FAIL(ob_operator_->process_complete_data(data))) {
           LOG_WARN("fail to handle parallel task complete", K(ret), K(ob_operator_->op_name()));
         } else {
-          int64_t cont_index = 0; //TODO need to update pres->get_cont_index();
-          if (OB_UNLIKELY(cont_index < 0) || OB_UNLIKELY(cont_index >= parallel_task_count_)) {
-            ret = OB_ERR_UNEXPECTED;
-            LOG_WARN("unexpected cont result", K(ob_operator_->op_name()), K(cont_index), K(parallel_task_count_), K(ret));
-          } else {
-            parallel_action_array_[cont_index] = NULL;
-          }
           if (target_task_count_ > 0) {
             event_ret = VC_EVENT_READ_READY;
           } else {
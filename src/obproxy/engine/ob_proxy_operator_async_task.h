@@ -38,6 +38,8 @@ public:
   int set_parallel_task_action(int64_t cont_index, event::ObAction *action);
   int init_async_task(event::ObContinuation *cont, event::ObEThread *submit_thread);
   void add_target_task_count() {} //TODO need to implement
+  // operator which starts another round of parallel task after its child completed
+  void inc_target_task_count() { ++target_task_count_; }
   event::ObContinuation *get_cb_cont() { return cb_cont_; }
   void destroy();
 
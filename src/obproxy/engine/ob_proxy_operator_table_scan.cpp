@@ -12,6 +12,7 @@
 
 #define USING_LOG_PREFIX PROXY
 
+#include <algorithm>
 #include "lib/oblog/ob_log_module.h"
 #include "ob_proxy_operator_table_scan.h"
 #include "lib/string/ob_sql_string.h"
@@ -26,6 +27,17 @@ namespace oceanbase {
 namespace obproxy {
 namespace engine {
 
+struct ObTopnKeyCmp
+{
+  explicit ObTopnKeyCmp(const bool is_asc) : is_asc_(is_asc) {}
+  bool operator()(const ObObj *l, const ObObj *r) const
+  {
+    const int cmp = l->compare(*r, l->get_collation_type());
+    return is_asc_ ? (cmp < 0) : (cmp > 0);
+  }
+  bool is_asc_;
+};
+
 int ObProxyTableScanOp::open(event::ObContinuation *cont, event::ObAction *&action, const int64_t timeout_ms)
 {
   child_cnt_ = 1; //fake child
@@ -149,7 +161,8 @@ int ObProxyTableScanOp::format_sql_header(ObSqlString &obj_sql_head)
   return ret;
 }
 
-int ObProxyTableScanOp::format_sql_tailer(ObSqlString &obj_sql_tail, bool is_oracle_mode)
+int ObProxyTableScanOp::format_sql_tailer(ObSqlString &obj_sql_tail, bool is_oracle_mode,
+                                          const int64_t limit, const ObString &topn_bound)
 {
   int ret = common::OB_SUCCESS;
   ObProxyTableScanInput* input = NULL;
@@ -164,9 +177,13 @@ int ObProxyTableScanOp::format_sql_tailer(ObSqlString &obj_sql_tail, bool is_ora
   }
 
   if(OB_SUCC(ret)) {
-    if (OB_SUCC(ret) && input->get_condition_exprs().count() > 0) {
+    const bool has_condition = input->get_condition_exprs().count() > 0;
+    if (OB_SUCC(ret) && (has_condition || !topn_bound.empty())) {
       obj_sql_tail.append(" WHERE ");
     }
+    if (has_condition && !topn_bound.empty()) {
+      obj_sql_tail.append("(");
+    }
     for (int64_t i = 0; OB_SUCC(ret) && i < input->get_condition_exprs().count(); i++) {
       if (OB_ISNULL(input->get_condition_exprs()[i])
           || OB_FAIL((int)(input->get_condition_exprs()[i]->to_sql_string(obj_sql_tail)))) {
@@ -175,6 +192,12 @@ int ObProxyTableScanOp::format_sql_tailer(ObSqlString &obj_sql_tail, bool is_ora
         break;
       }
     }
+    if (OB_SUCC(ret) && !topn_bound.empty()) {
+      if (has_condition) {
+        obj_sql_tail.append(") AND ");
+      }
+      obj_sql_tail.append(topn_bound.ptr(), topn_bound.length());
+    }
 
     /* GROUP BY col_a, col_b ORDER BY col_c, col_d */
     if (OB_SUCC(ret) && input->get_group_by_exprs().count() > 0) {
@@ -219,12 +242,11 @@ int ObProxyTableScanOp::format_sql_tailer(ObSqlString &obj_sql_tail, bool is_ora
       }
     }
 
-    int64_t value = -1;
-    if (OB_SUCC(ret) && !has_group_by && -1 != (value = input->get_op_top_value())) {
-      obj_sql_tail.append_fmt(" LIMIT %ld", value);
+    if (OB_SUCC(ret) && !has_group_by && -1 != limit) {
+      obj_sql_tail.append_fmt(" LIMIT %ld", limit);
       int64_t start = input->get_op_limit_value();
       int64_t offset = input->get_op_limit_value();
-      LOG_DEBUG("add LIMIT base on limit ", K(start), K(offset), K(value));
+      LOG_DEBUG("add LIMIT base on limit ", K(start), K(offset), K(limit));
     }
 
   }
@@ -248,90 +270,132 @@ int ObProxyTableScanOp::get_next_row()
   } else if (OB_ISNULL(operator_async_task_)) {
     ret = common::OB_INVALID_ARGUMENT;
     LOG_WARN("invalid input for ObProxyTableScanOp", K(ret));
+  } else if (input->get_phy_db_table_names().count()
+      != input->get_db_key_names().count()) {
+    ret = common::OB_ERROR;
+    LOG_WARN("inner error for sharding info", K(input->get_phy_db_table_names().count()),
+         K(input->get_db_key_names().count()));
+  } else {
+    LOG_DEBUG("input limit value:", K(input->get_op_limit_value()), K(input->get_op_offset_value()));
+
+    const int64_t count = input->get_db_key_names().count();
+    const int64_t limit = input->get_op_top_value();
+    common::ObSEArray<int64_t, 4> shard_indexes;
+
+    topn_batch_size_ = -1;
+    topn_shard_rows_.reset();
+    if (OB_NOT_NULL(input->get_topn_order_item()) && limit > 0 && count > 1) {
+      // a bit more than the average share of each shard, so the bound is usually
+      // established after the first round without any re-query
+      int64_t batch_size = (limit * 3 / 2 + count - 1) / count;
+      if (batch_size < TOPN_MIN_BATCH_SIZE) {
+        batch_size = TOPN_MIN_BATCH_SIZE;
+      }
+      if (batch_size < limit) {
+        topn_batch_size_ = batch_size;
+      }
+    }
+
+    for (int64_t i = 0; OB_SUCC(ret) && i < count; i++) {
+      if (OB_FAIL(shard_indexes.push_back(i))) {
+        LOG_WARN("fail to push back shard index", K(i), K(ret));
+      } else if (is_topn_first_round() && OB_FAIL(topn_shard_rows_.push_back(NULL))) {
+        LOG_WARN("fail to push back topn shard rows", K(i), K(ret));
+      }
+    }
+
+    if (OB_SUCC(ret)) {
+      LOG_DEBUG("table scan top-n first round", K(limit), K_(topn_batch_size), K(count));
+      if (OB_FAIL(send_sub_sql(shard_indexes, is_topn_first_round() ? topn_batch_size_ : limit,
+                               ObString()))) {
+        LOG_WARN("fail to send sub sql", K(ret));
+      }
+    }
   }
+  return ret;
+}
 
-  LOG_DEBUG("input limit value:", K(input->get_op_limit_value()), K(input->get_op_offset_value()));
+int ObProxyTableScanOp::send_sub_sql(const ObIArray<int64_t> &shard_indexes, const int64_t limit,
+                                     const ObString &topn_bound)
+{
+  int ret = common::OB_SUCCESS;
+  ObProxyTableScanInput* input = dynamic_cast<ObProxyTableScanInput*>(ObProxyOperator::get_input());
 
-  if (OB_SUCC(ret)) {
-    /* init object sql for select */
-    ObSqlString obj_sql_head;
-    ObSqlString obj_sql_tail;
-
-    if (OB_FAIL(format_sql_header(obj_sql_head))) {
-      LOG_WARN("inner error to format sql base on exprs");
-    } else if (input->get_phy_db_table_names().count()
-        != input->get_db_key_names().count()) {
-      ret = common::OB_ERROR;
-      LOG_WARN("inner error for sharding info", K(input->get_phy_db_table_names().count()),
-           K(input->get_db_key_names().count()));
-    } else {
-      common::ObSEArray<ObProxyParallelParam, 4> parallel_param;
-      //void *tmp_buf = NULL;
+  /* init object sql for select */
+  ObSqlString obj_sql_head;
+  ObSqlString obj_sql_tail;
 
-      int64_t count = input->get_db_key_names().count();
-      char *tmp_buf = NULL;
-      ObSqlString obj_sql; // a temp ObSqlString object to use
-      for (int64_t i = 0; i < count; i++) {
-        bool is_oracle_mode = input->get_db_key_names().at(i)->server_type_ == common::DB_OB_ORACLE;
-        obj_sql.reset();
-        obj_sql.append(input->get_normal_annotation_string());
-        /* Rewrite and add hint string */
-        obj_sql.append("SELECT ");
-        obj_sql.append(obj_sql_head.ptr());
-        obj_sql_tail.reuse();
-        if (OB_FAIL(format_sql_tailer(obj_sql_tail, is_oracle_mode))) {
-          LOG_WARN("inner error to format sql base on exprs");
-        } else if (OB_FAIL(rewrite_hint_table(input->get_hint_string(), obj_sql,
-            //TODO get origin table_name and db_name
-            input->get_logical_table_name(), input->get_logical_database_name(),
-            input->get_phy_db_table_names().at(i), input->get_db_key_names().at(i)->database_name_,
-            is_oracle_mode))) {
-          LOG_WARN("internal error in rewrite_hint_table", K(ret),
-              K(input->get_hint_string()));
-        } else if (input->get_db_key_names().at(i)->database_name_.length() <= 0
-                      || input->get_phy_db_table_names().at(i).length() <= 0) {
-          ret = common::OB_INVALID_ARGUMENT;
-          LOG_WARN("invilid table name or db_name", K(ret),
-                   K(input->get_db_key_names().at(i)->database_name_),
-                   K(input->get_phy_db_table_names().at(i)));
+  if (OB_ISNULL(input)) {
+    ret = common::OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid input for ObProxyTableScanOp", K(ret));
+  } else if (OB_FAIL(format_sql_header(obj_sql_head))) {
+    LOG_WARN("inner error to format sql base on exprs");
+  } else {
+    common::ObSEArray<ObProxyParallelParam, 4> parallel_param;
+
+    int64_t count = shard_indexes.count();
+    char *tmp_buf = NULL;
+    ObSqlString obj_sql; // a temp ObSqlString object to use
+    for (int64_t idx = 0; OB_SUCC(ret) && idx < count; idx++) {
+      const int64_t i = shard_indexes.at(idx);
+      bool is_oracle_mode = input->get_db_key_names().at(i)->server_type_ == common::DB_OB_ORACLE;
+      obj_sql.reset();
+      obj_sql.append(input->get_normal_annotation_string());
+      /* Rewrite and add hint string */
+      obj_sql.append("SELECT ");
+      obj_sql.append(obj_sql_head.ptr());
+      obj_sql_tail.reuse();
+      if (OB_FAIL(format_sql_tailer(obj_sql_tail, is_oracle_mode, limit, topn_bound))) {
+        LOG_WARN("inner error to format sql base on exprs");
+      } else if (OB_FAIL(rewrite_hint_table(input->get_hint_string(), obj_sql,
+          //TODO get origin table_name and db_name
+          input->get_logical_table_name(), input->get_logical_database_name(),
+          input->get_phy_db_table_names().at(i), input->get_db_key_names().at(i)->database_name_,
+          is_oracle_mode))) {
+        LOG_WARN("internal error in rewrite_hint_table", K(ret),
+            K(input->get_hint_string()));
+      } else if (input->get_db_key_names().at(i)->database_name_.length() <= 0
+                    || input->get_phy_db_table_names().at(i).length() <= 0) {
+        ret = common::OB_INVALID_ARGUMENT;
+        LOG_WARN("invilid table name or db_name", K(ret),
+                 K(input->get_db_key_names().at(i)->database_name_),
+                 K(input->get_phy_db_table_names().at(i)));
+      } else {
+        obj_sql.append(input->get_db_key_names().at(i)->database_name_.ptr(),
+                       input->get_db_key_names().at(i)->database_name_.length());
+        obj_sql.append(".");
+        obj_sql.append(input->get_phy_db_table_names().at(i).ptr(),
+                       input->get_phy_db_table_names().at(i).length());
+        LOG_DEBUG("sub_sql table info", K(input->get_db_key_names().at(i)->database_name_.ptr()),
+                   K(input->get_phy_db_table_names().at(i).ptr()));
+        obj_sql.append(obj_sql_tail.ptr(), obj_sql_tail.length());
+
+        if (OB_ISNULL(tmp_buf = (char *)allocator_.alloc(obj_sql.length() + 1))) {
+          ret = common::OB_ALLOCATE_MEMORY_FAILED;
+          LOG_WARN("no have enough memory to init", K(ret), K(op_name()), K(obj_sql.length() + 1));
         } else {
-          obj_sql.append(input->get_db_key_names().at(i)->database_name_.ptr(),
-                         input->get_db_key_names().at(i)->database_name_.length());
-          obj_sql.append(".");
-          obj_sql.append(input->get_phy_db_table_names().at(i).ptr(),
-                         input->get_phy_db_table_names().at(i).length());
-          LOG_DEBUG("sub_sql table info", K(input->get_db_key_names().at(i)->database_name_.ptr()),
-                     K(input->get_phy_db_table_names().at(i).ptr()));
-          obj_sql.append(obj_sql_tail.ptr(), obj_sql_tail.length());
-
-          if (OB_ISNULL(tmp_buf = (char *)allocator_.alloc(obj_sql.length() + 1))) {
-            ret = common::OB_ALLOCATE_MEMORY_FAILED;
-            LOG_WARN("no have enough memory to init", K(ret), K(op_name()), K(obj_sql.length() + 1));
-          }
-
           MEMCPY(tmp_buf, obj_sql.ptr(), obj_sql.length());
           tmp_buf[obj_sql.length()] = '\0';
 
           ObProxyParallelParam param;
           param.shard_conn_ = input->get_db_key_names().at(i);
-          //char* tmp_p = obj_sql.ptr();
           param.request_sql_.assign(tmp_buf, static_cast<ObString::obstr_size_t>(obj_sql.length()));
           LOG_DEBUG("sub_sql and len:", K(param.request_sql_), K(obj_sql.length()));
           parallel_param.push_back(param);
         }
       }
+    }
 
-      if (OB_SUCC(ret)) {
-        for (int64_t i = 0; i < count; i++) {
-          LOG_DEBUG("sub_sql before send", K(i), K(&parallel_param.at(i).request_sql_),
-                    K(parallel_param.at(i).request_sql_), K(parallel_param.at(i).shard_conn_->database_name_));
-        }
-        if (OB_FAIL(get_global_parallel_processor().open(*operator_async_task_, operator_async_task_->parallel_action_array_[0],
-                  parallel_param, &allocator_, timeout_ms_))) {
-          LOG_WARN("fail to op parallel processor", K(parallel_param));
-        } else {
-          set_sub_sql_count(count);
-        }
+    if (OB_SUCC(ret)) {
+      for (int64_t i = 0; i < count; i++) {
+        LOG_DEBUG("sub_sql before send", K(i), K(&parallel_param.at(i).request_sql_),
+                  K(parallel_param.at(i).request_sql_), K(parallel_param.at(i).shard_conn_->database_name_));
+      }
+      if (OB_FAIL(get_global_parallel_processor().open(*operator_async_task_, operator_async_task_->parallel_action_array_[0],
+                parallel_param, &allocator_, timeout_ms_))) {
+        LOG_WARN("fail to op parallel processor", K(parallel_param));
+      } else {
+        set_sub_sql_count(count);
       }
     }
   }
@@ -503,6 +567,16 @@ int ObProxyTableScanOp::process_ready_data(void *data, int &event)
   } else if (OB_ISNULL(res = reinterpret_cast<executor::ObProxyParallelResp*>(data))) {
     ret = OB_INVALID_ARGUMENT;
     LOG_WARN("invalid input, pres type is not match", K(ret), KP(data));
+  } else if (is_topn_first_round()) {
+    if (OB_FAIL(handle_topn_result(res, false, result))) {
+      LOG_WARN("fail to handle top-n result", "op_name", op_name(), K(ret));
+    } else if (OB_ISNULL(result)) {
+      event = VC_EVENT_CONT;
+    } else {
+      // only error packet is passed through in the first round
+      result_ = result;
+      event = VC_EVENT_READ_COMPLETE;
+    }
   } else if (OB_FAIL(handle_result(res, false, result))) {
     LOG_WARN("fail to handle result", "op_name", op_name(), K(ret));
   } else if (OB_ISNULL(result)) {
@@ -529,8 +603,16 @@ int ObProxyTableScanOp::process_complete_data(void *data)
   } else if (OB_ISNULL(res = reinterpret_cast<executor::ObProxyParallelResp*>(data))) {
     ret = OB_INVALID_ARGUMENT;
     LOG_WARN("invalid input, pres type is not match", K(ret));
+  } else if (is_topn_first_round()) {
+    if (OB_FAIL(handle_topn_result(res, true, result))) {
+      LOG_WARN("fail to handle top-n result", K(ret));
+    }
   } else if (OB_FAIL(handle_result(res, true, result))) {
     LOG_WARN("fail to handle result", K(ret));
+  }
+
+  if (OB_FAIL(ret)) {
+    // do nothing
   } else if (OB_ISNULL(result)) {
     ret = OB_ERR_UNEXPECTED;
     LOG_WARN("reulst is NULL, something error", K(ret));
@@ -542,6 +624,234 @@ int ObProxyTableScanOp::process_complete_data(void *data)
   return ret;
 }
 
+int ObProxyTableScanOp::handle_topn_result(void *data, bool is_final, ObProxyResultResp *&result)
+{
+  int ret = OB_SUCCESS;
+  ObProxyResultResp *res = NULL;
+  result = NULL;
+  if (OB_FAIL(handle_result(data, is_final, res))) {
+    LOG_WARN("fail to handle result", K(ret));
+  } else if (OB_NOT_NULL(res) && res->is_resultset_resp()) {
+    const int64_t idx = res->get_result_idx();
+    if (OB_UNLIKELY(idx < 0) || OB_UNLIKELY(idx >= topn_shard_rows_.count())) {
+      ret = OB_ERR_UNEXPECTED;
+      LOG_WARN("unexpected result index", K(idx), "shard_count", topn_shard_rows_.count(), K(ret));
+    } else {
+      topn_shard_rows_.at(idx) = &res->get_result_rows();
+      res = NULL;
+    }
+  }
+
+  if (OB_FAIL(ret)) {
+    // do nothing
+  } else if (OB_NOT_NULL(res)) {
+    // error packet or ok packet, no need to go on
+    topn_batch_size_ = -1;
+    result = res;
+  } else if (is_final && OB_FAIL(finish_topn_first_round(result))) {
+    LOG_WARN("fail to finish top-n first round", K(ret));
+  }
+  return ret;
+}
+
+int ObProxyTableScanOp::finish_topn_first_round(ObProxyResultResp *&result)
+{
+  int ret = OB_SUCCESS;
+  ObProxyTableScanInput* input = dynamic_cast<ObProxyTableScanInput*>(ObProxyOperator::get_input());
+  ObProxyOrderItem *order_item = NULL;
+  int64_t key_index = -1;
+  ObObj *bound = NULL;
+  ResultRows *rows = NULL;
+  void *tmp_buf = NULL;
+  common::ObSEArray<int64_t, 4> shard_indexes;
+  ObSqlString bound_sql;
+
+  if (OB_ISNULL(input) || OB_ISNULL(order_item = input->get_topn_order_item())
+      || OB_ISNULL(result_fields_)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("invalid top-n state", KP(input), KP(order_item), KP_(result_fields), K(ret));
+  } else if (OB_FAIL(get_topn_key_index(order_item->expr_, *result_fields_, key_index))) {
+    LOG_WARN("fail to get top-n key index", K(ret));
+  } else if (key_index >= 0
+             && OB_FAIL(calc_topn_bound(topn_shard_rows_, key_index, input->get_op_top_value(),
+                                        order_item->order_direction_ <= NULLS_LAST_ASC, bound))) {
+    LOG_WARN("fail to calc top-n bound", K(key_index), K(ret));
+  } else if (OB_ISNULL(tmp_buf = allocator_.alloc(sizeof(ResultRows)))) {
+    ret = common::OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("no have enough memory to init", K(ret), K(op_name()), K(sizeof(ResultRows)));
+  } else {
+    rows = new (tmp_buf) ResultRows(array_new_alloc_size, allocator_);
+    const bool is_asc = order_item->order_direction_ <= NULLS_LAST_ASC;
+    for (int64_t i = 0; OB_SUCC(ret) && i < topn_shard_rows_.count(); i++) {
+      ResultRows *shard_rows = topn_shard_rows_.at(i);
+      bool need_requery = false;
+      if (OB_ISNULL(shard_rows)) {
+        ret = OB_ERR_UNEXPECTED;
+        LOG_WARN("shard result of first round is NULL", K(i), K(ret));
+      } else {
+        need_requery = need_topn_requery(*shard_rows, topn_batch_size_, key_index, bound, is_asc);
+      }
+
+      if (OB_FAIL(ret)) {
+        // do nothing
+      } else if (need_requery) {
+        // all rows of this shard will come again from the second round
+        if (OB_FAIL(shard_indexes.push_back(i))) {
+          LOG_WARN("fail to push back shard index", K(i), K(ret));
+        }
+      } else {
+        for (int64_t j = 0; OB_SUCC(ret) && j < shard_rows->count(); j++) {
+          if (OB_FAIL(rows->push_back(shard_rows->at(j)))) {
+            LOG_WARN("fail to push back row", K(ret));
+          }
+        }
+      }
+    }
+  }
+
+  if (OB_SUCC(ret) && NULL != bound && shard_indexes.count() > 0) {
+    // (col IS NULL OR col <= bound), null is kept for it may sort before the bound
+    char buf[TOPN_BOUND_BUF_LEN];
+    const int64_t buf_len = TOPN_BOUND_BUF_LEN;
+    int64_t pos = 0;
+    if (OB_FAIL(bound->print_sql_literal(buf, buf_len, pos))) {
+      LOG_WARN("fail to print bound", KPC(bound), K(ret));
+    } else if (OB_FAIL(bound_sql.append("("))
+               || OB_FAIL(order_item->expr_->to_sql_string(bound_sql))
+               || OB_FAIL(bound_sql.append(" IS NULL OR "))
+               || OB_FAIL(order_item->expr_->to_sql_string(bound_sql))
+               || OB_FAIL(bound_sql.append_fmt(" %s %.*s)",
+                       order_item->order_direction_ <= NULLS_LAST_ASC ? "<=" : ">=",
+                       static_cast<int>(pos), buf))) {
+      LOG_WARN("fail to build top-n bound", K(ret));
+    }
+  }
+
+  topn_batch_size_ = -1;
+  if (OB_SUCC(ret)) {
+    LOG_DEBUG("table scan top-n first round finished", K(key_index), KPC(bound),
+              "settled_rows", rows->count(), "requery_count", shard_indexes.count(), K(bound_sql));
+    if (shard_indexes.count() > 0) {
+      if (OB_FAIL(send_sub_sql(shard_indexes, input->get_op_top_value(), bound_sql.string()))) {
+        LOG_WARN("fail to send top-n second round", K(ret));
+      } else {
+        operator_async_task_->inc_target_task_count();
+      }
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    // the settled rows, passed to the parent as a ready result when there is a second round
+    if (OB_FAIL(packet_result_set(result, rows, get_result_fields()))) {
+      LOG_WARN("fail to packet resultset", K(op_name()), K(ret));
+    } else if (OB_ISNULL(result)) {
+      ret = common::OB_ERR_UNEXPECTED;
+      LOG_WARN("packet_result_set success but res is NULL", K(ret));
+    } else {
+      result->set_result_sum(get_sub_sql_count());
+    }
+  }
+  return ret;
+}
+
+int ObProxyTableScanOp::get_topn_key_index(ObProxyExpr *key_expr, const ResultFields &fields,
+                                           int64_t &key_index)
+{
+  int ret = OB_SUCCESS;
+  ObProxyExprShardingConst *column_expr = dynamic_cast<ObProxyExprShardingConst*>(key_expr);
+  key_index = -1;
+  if (OB_ISNULL(column_expr) || OB_UNLIKELY(!column_expr->is_column_)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("top-n sort key is not a column", KP(key_expr), K(ret));
+  } else {
+    // t.c1 or `c1`
+    ObString column_name = column_expr->get_object().get_string();
+    const char *dot = NULL;
+    while (NULL != (dot = column_name.find('.'))) {
+      column_name = column_name.after(dot);
+    }
+    if (column_name.length() > 2 && '`' == column_name[0] && '`' == column_name[column_name.length() - 1]) {
+      column_name.assign_ptr(column_name.ptr() + 1, column_name.length() - 2);
+    }
+
+    // the output index counts from the end of row, for '*' can be the first select expr,
+    // the original column name of the field must be the sort key
+    const int64_t column_count = fields.count();
+    const int64_t index = key_expr->get_index();
+    if (index >= 0 && index < column_count) {
+      key_index = column_count - 1 - index;
+      const ObString &org_name = fields.at(key_index).org_cname_;
+      if (!org_name.empty() && 0 != org_name.case_compare(column_name)) {
+        key_index = -1;
+      }
+    }
+    for (int64_t i = column_count - 1; key_index < 0 && i >= 0; i--) {
+      if (0 == fields.at(i).org_cname_.case_compare(column_name)) {
+        key_index = i;
+      }
+    }
+    if (key_index < 0) {
+      LOG_DEBUG("sort key is not found in result fields", K(column_name), K(index), K(column_count));
+    }
+  }
+  return ret;
+}
+
+int ObProxyTableScanOp::calc_topn_bound(const common::ObIArray<ResultRows*> &shard_rows_array,
+                                        const int64_t key_index, const int64_t limit,
+                                        const bool is_asc, ObObj *&bound)
+{
+  int ret = OB_SUCCESS;
+  common::ObSEArray<ObObj*, 4> keys;
+  bool is_valid = true;
+  bound = NULL;
+
+  for (int64_t i = 0; OB_SUCC(ret) && is_valid && i < shard_rows_array.count(); i++) {
+    ResultRows *shard_rows = shard_rows_array.at(i);
+    for (int64_t j = 0; OB_SUCC(ret) && is_valid && NULL != shard_rows && j < shard_rows->count(); j++) {
+      ObObj *key = NULL;
+      if (OB_ISNULL(shard_rows->at(j)) || key_index < 0 || key_index >= shard_rows->at(j)->count()) {
+        ret = OB_ERR_UNEXPECTED;
+        LOG_WARN("invalid row of first round", K(i), K(j), K(key_index), K(ret));
+      } else if (FALSE_IT(key = shard_rows->at(j)->at(key_index))) {
+      } else if (!key->is_integer_type() && !key->is_number()) {
+        // proxy and server may compare other types (null, float, string) differently,
+        // so no bound for them, and the full shards are queried again without bound
+        is_valid = false;
+      } else if (OB_FAIL(keys.push_back(key))) {
+        LOG_WARN("fail to push back key", K(ret));
+      }
+    }
+  }
+
+  if (OB_SUCC(ret) && is_valid && limit > 0 && keys.count() >= limit) {
+    ObObj **first = &keys.at(0);
+    std::nth_element(first, first + limit - 1, first + keys.count(), ObTopnKeyCmp(is_asc));
+    bound = keys.at(limit - 1);
+  }
+  return ret;
+}
+
+bool ObProxyTableScanOp::need_topn_requery(const ResultRows &shard_rows, const int64_t batch_size,
+                                           const int64_t key_index, const ObObj *bound,
+                                           const bool is_asc)
+{
+  bool bret = false;
+  // a short batch is all rows of the shard
+  if (shard_rows.count() >= batch_size) {
+    if (NULL == bound) {
+      bret = true;
+    } else {
+      // rows after the last one are not before it, the shard is settled if its last key
+      // reaches the bound, the rows tied with the bound are not needed either
+      const ObObj *last = shard_rows.at(shard_rows.count() - 1)->at(key_index);
+      const int cmp = last->compare(*bound, last->get_collation_type());
+      bret = is_asc ? (cmp < 0) : (cmp > 0);
+    }
+  }
+  return bret;
+}
+
 }
 }
 }
@@ -26,8 +26,12 @@ namespace engine {
 class ObProxyTableScanOp : public ObProxyOperator
 {
 public:
+  static const int64_t TOPN_MIN_BATCH_SIZE = 16;
+  static const int64_t TOPN_BOUND_BUF_LEN = 128;
+
   ObProxyTableScanOp(ObProxyOpInput *input, common::ObIAllocator &allocator)
-    : ObProxyOperator(input, allocator), sub_sql_count_(0) {
+    : ObProxyOperator(input, allocator), sub_sql_count_(0), topn_batch_size_(-1),
+      topn_shard_rows_(array_new_alloc_size, allocator) {
     set_op_type(PHY_TABLE_SCAN);
   }
 
@@ -44,7 +48,9 @@ public:
       bool is_oracle_mode);
 
   virtual int format_sql_header(ObSqlString &sql_header); /* sql: SELECT ... FROM */
-  virtual int format_sql_tailer(ObSqlString &sql_header, bool is_oracle_mode); /* sql: WHERE ... GROUP BY ORDER BY LIMIT */
+  /* sql: WHERE ... GROUP BY ORDER BY LIMIT */
+  virtual int format_sql_tailer(ObSqlString &sql_header, bool is_oracle_mode, const int64_t limit,
+                                const common::ObString &topn_bound);
 
   virtual int handle_result(void *src, bool is_final, ObProxyResultResp *&result);
   virtual int handle_response_result(void *src, bool is_final, ObProxyResultResp *&result);
@@ -53,8 +59,36 @@ public:
 
   int64_t get_sub_sql_count() { return sub_sql_count_; }
   void set_sub_sql_count(int64_t count) { sub_sql_count_ = count; }
+
+  // position of the top-n sort key column in result row, -1 if not found
+  static int get_topn_key_index(ObProxyExpr *key_expr, const ResultFields &fields, int64_t &key_index);
+  // the limit-th key of all first round rows, NULL if any key can not be a bound
+  static int calc_topn_bound(const common::ObIArray<ResultRows*> &shard_rows_array,
+                             const int64_t key_index, const int64_t limit,
+                             const bool is_asc, common::ObObj *&bound);
+  // whether the shard may have more rows before the bound
+  static bool need_topn_requery(const ResultRows &shard_rows, const int64_t batch_size,
+                                const int64_t key_index, const common::ObObj *bound,
+                                const bool is_asc);
+
+protected:
+  int send_sub_sql(const common::ObIArray<int64_t> &shard_indexes, const int64_t limit,
+                   const common::ObString &topn_bound);
+  bool is_topn_first_round() const { return topn_batch_size_ > 0; }
+  int handle_topn_result(void *data, bool is_final, ObProxyResultResp *&result);
+  int finish_topn_first_round(ObProxyResultResp *&result);
+
 protected:
   int64_t sub_sql_count_;
+  /*
+   * Progressive top-n of 'ORDER BY col LIMIT m, n' across shards:
+   * the first round fetches only topn_batch_size_ rows from each shard and keeps them in
+   * topn_shard_rows_. Then the (m+n)-th key of all fetched rows is the bound, the shards
+   * which returned a full batch and whose last key is still before the bound are queried
+   * again with 'col <= bound' (or '>=' for desc), the others are already settled.
+   */
+  int64_t topn_batch_size_;
+  common::ObSEArray<ResultRows*, 4, common::ObIAllocator&> topn_shard_rows_;
 };
 
 class ObProxyTableScanInput : public ObProxyOpInput
@@ -71,7 +105,8 @@ public:
       having_exprs_(NULL),
       order_by_exprs_(ObModIds::OB_SE_ARRAY_ENGINE, array_new_alloc_size),
       hint_string_(),
-      normal_annotation_string_()
+      normal_annotation_string_(),
+      topn_order_item_(NULL)
   {}
 
   ObProxyTableScanInput(const common::ObString &logical_table_name,
@@ -97,7 +132,8 @@ public:
         having_exprs_(having_exprs),
         order_by_exprs_(order_by_exprs),
         hint_string_(hint_string),
-        normal_annotation_string_(normal_annotation_string)
+        normal_annotation_string_(normal_annotation_string),
+        topn_order_item_(NULL)
   {
   }
 
@@ -169,6 +205,13 @@ public:
     return normal_annotation_string_;
   }
 
+  void set_topn_order_item(ObProxyOrderItem *order_item) {
+    topn_order_item_ = order_item;
+  }
+  ObProxyOrderItem* get_topn_order_item() {
+    return topn_order_item_;
+  }
+
 protected:
   common::ObString logical_table_name_;
   common::ObString logical_database_name_;
@@ -181,6 +224,8 @@ protected:
   common::ObSEArray<ObProxyExpr*, 4> order_by_exprs_;
   common::ObString hint_string_;
   common::ObString normal_annotation_string_;
+  // set when the sort key can be pushed down progressively, see ObProxyTableScanOp
+  ObProxyOrderItem *topn_order_item_;
 };
 
 }
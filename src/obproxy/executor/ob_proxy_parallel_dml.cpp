@@ -0,0 +1,563 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "ob_proxy_parallel_dml.h"
+#include "ob_proxy_parallel_execute_cont.h"
+#include "rpc/obmysql/packet/ompk_ok.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obmysql;
+using namespace oceanbase::obproxy::obutils;
+using namespace oceanbase::obproxy::dbconfig;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace executor
+{
+
+void ObProxyDmlSplitResult::reset()
+{
+  head_.reset();
+  tail_.reset();
+  column_name_.reset();
+  columns_.reset();
+  items_.reset();
+}
+
+bool ObProxyDmlSplitter::is_ident_char(const char c)
+{
+  return isalnum(static_cast<unsigned char>(c)) || '_' == c || '$' == c;
+}
+
+int64_t ObProxyDmlSplitter::skip_space(const char *ptr, const int64_t len, int64_t pos)
+{
+  while (pos < len && isspace(static_cast<unsigned char>(ptr[pos]))) {
+    ++pos;
+  }
+  return pos;
+}
+
+// if pos is the start of a quoted string or comment, return the pos after it,
+// else return pos itself
+int64_t ObProxyDmlSplitter::skip_quote_or_comment(const char *ptr, const int64_t len, int64_t pos)
+{
+  const char c = ptr[pos];
+  if ('\'' == c || '"' == c || '`' == c) {
+    ++pos;
+    while (pos < len && c != ptr[pos]) {
+      if ('\\' == ptr[pos] && '`' != c) {
+        ++pos;
+      }
+      ++pos;
+    }
+    // skip the close quote
+    pos = std::min(pos + 1, len);
+  } else if ('/' == c && pos + 1 < len && '*' == ptr[pos + 1]) {
+    pos += 2;
+    while (pos + 1 < len && !('*' == ptr[pos] && '/' == ptr[pos + 1])) {
+      ++pos;
+    }
+    pos = std::min(pos + 2, len);
+  } else if (('-' == c && pos + 1 < len && '-' == ptr[pos + 1]) || '#' == c) {
+    while (pos < len && '\n' != ptr[pos]) {
+      ++pos;
+    }
+  }
+  return pos;
+}
+
+// pos must point to '(', return the pos of matched ')', or len if not found
+int64_t ObProxyDmlSplitter::find_matched_paren(const char *ptr, const int64_t len, int64_t pos)
+{
+  int64_t depth = 0;
+  int64_t ret_pos = len;
+  while (pos < len && len == ret_pos) {
+    const int64_t next_pos = skip_quote_or_comment(ptr, len, pos);
+    if (next_pos != pos) {
+      pos = next_pos;
+    } else {
+      if ('(' == ptr[pos]) {
+        ++depth;
+      } else if (')' == ptr[pos] && 0 == --depth) {
+        ret_pos = pos;
+      }
+      ++pos;
+    }
+  }
+  return ret_pos;
+}
+
+bool ObProxyDmlSplitter::is_keyword_at(const char *ptr, const int64_t len, const int64_t pos, const char *keyword)
+{
+  const int64_t keyword_len = static_cast<int64_t>(strlen(keyword));
+  return pos + keyword_len <= len
+         && (0 == pos || !is_ident_char(ptr[pos - 1]))
+         && 0 == strncasecmp(ptr + pos, keyword, keyword_len)
+         && (pos + keyword_len == len || !is_ident_char(ptr[pos + keyword_len]));
+}
+
+int ObProxyDmlSplitter::split_by_comma(const char *ptr, const int64_t start, const int64_t end,
+                                       ObIArray<ObString> &values)
+{
+  int ret = OB_SUCCESS;
+  int64_t depth = 0;
+  int64_t item_start = start;
+  int64_t pos = start;
+  while (OB_SUCC(ret) && pos <= end) {
+    const int64_t next_pos = (pos < end) ? skip_quote_or_comment(ptr, end, pos) : pos;
+    if (next_pos != pos) {
+      pos = next_pos;
+    } else {
+      if (pos == end || (0 == depth && ',' == ptr[pos])) {
+        ObString value(pos - item_start, ptr + item_start);
+        value = value.trim();
+        if (OB_UNLIKELY(value.empty())) {
+          ret = OB_ERR_PARSER_SYNTAX;
+          LOG_DEBUG("empty value in list", K(start), K(end), K(ret));
+        } else if (OB_FAIL(values.push_back(value))) {
+          LOG_WARN("fail to push back value", K(value), K(ret));
+        }
+        item_start = pos + 1;
+      } else if ('(' == ptr[pos]) {
+        ++depth;
+      } else if (')' == ptr[pos]) {
+        --depth;
+      }
+      ++pos;
+    }
+  }
+  return ret;
+}
+
+int ObProxyDmlSplitter::split_insert_values(const ObString &sql, ObProxyDmlSplitResult &result)
+{
+  int ret = OB_SUCCESS;
+  const char *ptr = sql.ptr();
+  const int64_t len = sql.length();
+  int64_t pos = 0;
+  int64_t values_pos = -1;
+  int64_t column_start = -1;
+  int64_t column_end = -1;
+
+  result.reset();
+  // find the top level 'values' keyword, the last parenthesis before it is the column list
+  while (pos < len && values_pos < 0) {
+    const int64_t next_pos = skip_quote_or_comment(ptr, len, pos);
+    if (next_pos != pos) {
+      pos = next_pos;
+    } else if ('(' == ptr[pos]) {
+      column_start = pos;
+      column_end = find_matched_paren(ptr, len, pos);
+      pos = column_end + 1;
+    } else if (is_keyword_at(ptr, len, pos, "VALUES")) {
+      values_pos = pos + 6;
+    } else if (is_keyword_at(ptr, len, pos, "VALUE")) {
+      values_pos = pos + 5;
+    } else {
+      ++pos;
+    }
+  }
+
+  if (values_pos < 0) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_DEBUG("no values clause in sql", K(sql), K(ret));
+  } else if (column_start >= 0 && column_end < len
+             && OB_FAIL(split_by_comma(ptr, column_start + 1, column_end, result.columns_))) {
+    LOG_DEBUG("fail to split column list", K(sql), K(ret));
+  } else {
+    pos = skip_space(ptr, len, values_pos);
+    result.head_.assign_ptr(ptr, static_cast<ObString::obstr_size_t>(pos));
+    bool is_end = false;
+    while (OB_SUCC(ret) && !is_end) {
+      int64_t row_end = 0;
+      if (pos >= len || '(' != ptr[pos]) {
+        ret = OB_ERR_PARSER_SYNTAX;
+        LOG_DEBUG("row must start with '('", K(pos), K(sql), K(ret));
+      } else if ((row_end = find_matched_paren(ptr, len, pos)) >= len) {
+        ret = OB_ERR_PARSER_SYNTAX;
+        LOG_DEBUG("row is not closed", K(pos), K(sql), K(ret));
+      } else if (OB_FAIL(result.items_.push_back(ObString(row_end + 1 - pos, ptr + pos)))) {
+        LOG_WARN("fail to push back row", K(ret));
+      } else {
+        pos = skip_space(ptr, len, row_end + 1);
+        if (pos < len && ',' == ptr[pos]) {
+          pos = skip_space(ptr, len, pos + 1);
+        } else {
+          is_end = true;
+          result.tail_.assign_ptr(ptr + row_end + 1, static_cast<ObString::obstr_size_t>(len - row_end - 1));
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+// the in list is split only when it is a conjunct of where clause, with
+// 'c1 in (1, 2) or c2 = 3' rows out of the list are also hit, and each sub sql
+// on its shard would do more than the original sql, keep serial then
+int ObProxyDmlSplitter::split_in_list(const ObString &sql, ObProxyDmlSplitResult &result)
+{
+  int ret = OB_SUCCESS;
+  const char *ptr = sql.ptr();
+  const int64_t len = sql.length();
+  int64_t pos = 0;
+  int64_t depth = 0;
+  bool has_where = false;
+  bool has_or = false;
+  bool found = false;
+
+  result.reset();
+  while (OB_SUCC(ret) && pos < len && !has_or) {
+    const int64_t next_pos = skip_quote_or_comment(ptr, len, pos);
+    if (next_pos != pos) {
+      pos = next_pos;
+    } else if ('(' == ptr[pos]) {
+      ++depth;
+      ++pos;
+    } else if (')' == ptr[pos]) {
+      --depth;
+      ++pos;
+    } else if (0 != depth) {
+      ++pos;
+    } else if (!has_where) {
+      has_where = is_keyword_at(ptr, len, pos, "WHERE");
+      ++pos;
+    } else if (is_or_at(ptr, len, pos)) {
+      has_or = true;
+    } else if (found || !is_keyword_at(ptr, len, pos, "IN")) {
+      ++pos;
+    } else {
+      // column before 'in', like c1, t.c1 or `c1`
+      int64_t name_end = pos;
+      while (name_end > 0 && isspace(static_cast<unsigned char>(ptr[name_end - 1]))) {
+        --name_end;
+      }
+      int64_t name_start = name_end;
+      while (name_start > 0 && (is_ident_char(ptr[name_start - 1]) || '`' == ptr[name_start - 1])) {
+        --name_start;
+      }
+      ObString column_name(name_end - name_start, ptr + name_start);
+      const int64_t open_pos = skip_space(ptr, len, pos + 2);
+      if ('`' == column_name[0] && column_name.length() > 2) {
+        column_name.assign_ptr(column_name.ptr() + 1, column_name.length() - 2);
+      }
+      pos += 2;
+      if (column_name.empty()
+          || 0 == column_name.case_compare("NOT")
+          || is_negated(ptr, name_start)
+          || open_pos >= len || '(' != ptr[open_pos]) {
+        // not in or not a value list, continue
+      } else {
+        const int64_t close_pos = find_matched_paren(ptr, len, open_pos);
+        const int64_t first_pos = skip_space(ptr, len, open_pos + 1);
+        if (close_pos >= len) {
+          ret = OB_ERR_PARSER_SYNTAX;
+          LOG_DEBUG("in list is not closed", K(sql), K(ret));
+        } else if (is_keyword_at(ptr, len, first_pos, "SELECT")) {
+          // sub query, continue
+          pos = close_pos + 1;
+        } else if (OB_FAIL(split_by_comma(ptr, open_pos + 1, close_pos, result.items_))) {
+          LOG_DEBUG("fail to split in list", K(sql), K(ret));
+        } else {
+          // go on to check the rest of where clause
+          found = true;
+          result.column_name_ = column_name;
+          result.head_.assign_ptr(ptr, static_cast<ObString::obstr_size_t>(open_pos + 1));
+          result.tail_.assign_ptr(ptr + close_pos, static_cast<ObString::obstr_size_t>(len - close_pos));
+          pos = close_pos + 1;
+        }
+      }
+    }
+  }
+
+  if (OB_SUCC(ret) && (!found || has_or)) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_DEBUG("no in list to split", K(found), K(has_or), K(sql), K(ret));
+    result.reset();
+  }
+  return ret;
+}
+
+// 'or', 'xor' and '||', '||' may be concat with PIPES_AS_CONCAT, treat it as 'or' anyway
+bool ObProxyDmlSplitter::is_or_at(const char *ptr, const int64_t len, const int64_t pos)
+{
+  return is_keyword_at(ptr, len, pos, "OR")
+         || is_keyword_at(ptr, len, pos, "XOR")
+         || ('|' == ptr[pos] && pos + 1 < len && '|' == ptr[pos + 1]);
+}
+
+// whether the column starting at @name_start is after 'not' or '!'
+bool ObProxyDmlSplitter::is_negated(const char *ptr, const int64_t name_start)
+{
+  int64_t pos = name_start;
+  while (pos > 0 && isspace(static_cast<unsigned char>(ptr[pos - 1]))) {
+    --pos;
+  }
+  return (pos > 0 && '!' == ptr[pos - 1])
+         || (pos >= 3 && is_keyword_at(ptr, pos, pos - 3, "NOT"));
+}
+
+int ObProxyDmlSplitter::split_row_values(const ObString &row, ObIArray<ObString> &values)
+{
+  int ret = OB_SUCCESS;
+  const int64_t len = row.length();
+  if (OB_UNLIKELY(len < 2) || '(' != row[0] || ')' != row[len - 1]) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid row", K(row), K(ret));
+  } else {
+    ret = split_by_comma(row.ptr(), 1, len - 1, values);
+  }
+  return ret;
+}
+
+int ObProxyDmlSplitter::build_sql(const ObProxyDmlSplitResult &result,
+                                  const ObIArray<int64_t> &item_indexes,
+                                  ObSqlString &sql)
+{
+  int ret = OB_SUCCESS;
+  sql.reuse();
+  if (OB_UNLIKELY(item_indexes.empty())) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("item indexes is empty", K(ret));
+  } else if (OB_FAIL(sql.append(result.head_))) {
+    LOG_WARN("fail to append head", K(ret));
+  }
+  for (int64_t i = 0; OB_SUCC(ret) && i < item_indexes.count(); ++i) {
+    const int64_t index = item_indexes.at(i);
+    if (OB_UNLIKELY(index < 0) || OB_UNLIKELY(index >= result.items_.count())) {
+      ret = OB_INVALID_ARGUMENT;
+      LOG_WARN("invalid item index", K(index), "item_count", result.items_.count(), K(ret));
+    } else if (i > 0 && OB_FAIL(sql.append(", ", 2))) {
+      LOG_WARN("fail to append separator", K(ret));
+    } else if (OB_FAIL(sql.append(result.items_.at(index)))) {
+      LOG_WARN("fail to append item", K(index), K(ret));
+    }
+  }
+  if (OB_SUCC(ret) && OB_FAIL(sql.append(result.tail_))) {
+    LOG_WARN("fail to append tail", K(ret));
+  }
+  return ret;
+}
+
+bool ObProxyDmlSplitter::get_column_value(const ObString &text, SqlColumnValue &value)
+{
+  bool bret = false;
+  const int64_t len = text.length();
+  value.reset();
+  if (len >= 2 && ('\'' == text[0] || '"' == text[0]) && text[0] == text[len - 1]) {
+    char buf[OBPROXY_MAX_STRING_VALUE_LENGTH];
+    int64_t pos = 0;
+    // the shard is calculated by the value the server sees, longer value would be truncated
+    if (unescape_string(ObString(len - 2, text.ptr() + 1), text[0],
+                        buf, OBPROXY_MAX_STRING_VALUE_LENGTH, pos)) {
+      value.value_type_ = TOKEN_STR_VAL;
+      value.column_value_.set(ObString(pos, buf));
+      bret = true;
+    }
+  } else if (len > 0 && len < 20) {
+    char buf[32];
+    char *end = NULL;
+    MEMCPY(buf, text.ptr(), len);
+    buf[len] = '\0';
+    errno = 0;
+    const int64_t int_value = strtoll(buf, &end, 10);
+    if (0 == errno && end == buf + len && end != buf) {
+      value.value_type_ = TOKEN_INT_VAL;
+      value.column_int_value_ = int_value;
+      value.column_value_.set_integer(int_value);
+      bret = true;
+    }
+  }
+  return bret;
+}
+
+// unescape the content of a quoted literal as mysql does:
+//   '\n', '\t', ... are special chars, '\%' and '\_' keep the backslash,
+//   other '\x' is 'x', and two quotes is one quote
+bool ObProxyDmlSplitter::unescape_string(const ObString &text, const char quote,
+                                         char *buf, const int64_t buf_len, int64_t &pos)
+{
+  bool bret = true;
+  const char *ptr = text.ptr();
+  const int64_t len = text.length();
+  pos = 0;
+  for (int64_t i = 0; bret && i < len; ++i) {
+    char c = ptr[i];
+    bool keep_backslash = false;
+    if ('\\' == c) {
+      if (++i >= len) {
+        bret = false;
+      } else {
+        c = ptr[i];
+        switch (c) {
+          case '0':
+            c = '\0';
+            break;
+          case 'b':
+            c = '\b';
+            break;
+          case 'n':
+            c = '\n';
+            break;
+          case 'r':
+            c = '\r';
+            break;
+          case 't':
+            c = '\t';
+            break;
+          case 'Z':
+            c = '\032';
+            break;
+          case '%':
+          case '_':
+            keep_backslash = true;
+            break;
+          default:
+            break;
+        }
+      }
+    } else if (quote == c) {
+      // the quote inside literal must be doubled
+      if (++i >= len || quote != ptr[i]) {
+        bret = false;
+      }
+    }
+    if (bret && keep_backslash) {
+      if (pos < buf_len) {
+        buf[pos++] = '\\';
+      } else {
+        bret = false;
+      }
+    }
+    if (bret) {
+      if (pos < buf_len) {
+        buf[pos++] = c;
+      } else {
+        bret = false;
+      }
+    }
+  }
+  return bret;
+}
+
+bool ObProxyDmlSplitter::has_order_by_or_limit(const ObString &sql)
+{
+  bool bret = false;
+  const char *ptr = sql.ptr();
+  const int64_t len = sql.length();
+  int64_t pos = 0;
+  int64_t depth = 0;
+  while (!bret && pos < len) {
+    const int64_t next_pos = skip_quote_or_comment(ptr, len, pos);
+    if (next_pos != pos) {
+      pos = next_pos;
+    } else {
+      if ('(' == ptr[pos]) {
+        ++depth;
+      } else if (')' == ptr[pos]) {
+        --depth;
+      } else if (0 != depth) {
+        // sub query
+      } else if (is_keyword_at(ptr, len, pos, "LIMIT")) {
+        bret = true;
+      } else if (is_keyword_at(ptr, len, pos, "ORDER")) {
+        bret = is_keyword_at(ptr, len, skip_space(ptr, len, pos + 5), "BY");
+      }
+      ++pos;
+    }
+  }
+  return bret;
+}
+
+ObProxyParallelDmlPlan::~ObProxyParallelDmlPlan()
+{
+  for (int64_t i = 0; i < parallel_param_.count(); ++i) {
+    if (NULL != parallel_param_.at(i).shard_conn_) {
+      parallel_param_.at(i).shard_conn_->dec_ref();
+      parallel_param_.at(i).shard_conn_ = NULL;
+    }
+  }
+  parallel_param_.reset();
+  allocator_ = NULL;
+}
+
+int ObProxyParallelDmlPlan::add_sub_sql(ObShardConnector *shard_conn, const ObString &sql)
+{
+  int ret = OB_SUCCESS;
+  char *buf = NULL;
+  if (OB_ISNULL(shard_conn) || OB_UNLIKELY(sql.empty())) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", KP(shard_conn), K(sql), K(ret));
+  } else if (OB_ISNULL(allocator_)) {
+    ret = OB_NOT_INIT;
+    LOG_WARN("allocator is null", K(ret));
+  } else if (OB_ISNULL(buf = static_cast<char *>(allocator_->alloc(sql.length())))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc mem", "alloc_size", sql.length(), K(ret));
+  } else {
+    MEMCPY(buf, sql.ptr(), sql.length());
+    ObProxyParallelParam param;
+    param.shard_conn_ = shard_conn;
+    param.request_sql_.assign_ptr(buf, sql.length());
+    if (OB_FAIL(parallel_param_.push_back(param))) {
+      LOG_WARN("fail to push back parallel param", K(ret));
+    } else {
+      shard_conn->inc_ref();
+    }
+  }
+  return ret;
+}
+
+int ObProxyParallelDmlPlan::handle_resp(ObProxyParallelResp &resp)
+{
+  int ret = OB_SUCCESS;
+  ++finish_count_;
+  if (resp.is_ok_resp()) {
+    OMPKOK ok_packet;
+    if (OB_FAIL(resp.get_ok_packet(ok_packet))) {
+      LOG_WARN("fail to get ok packet", K(ret));
+    } else {
+      const uint64_t last_insert_id = ok_packet.get_last_insert_id();
+      const int64_t warnings = static_cast<int64_t>(warnings_) + ok_packet.get_warnings();
+      affected_rows_ += static_cast<int64_t>(ok_packet.get_affected_rows());
+      if (0 != last_insert_id && (0 == last_insert_id_ || last_insert_id < last_insert_id_)) {
+        last_insert_id_ = last_insert_id;
+      }
+      warnings_ = static_cast<uint16_t>(std::min(warnings, static_cast<int64_t>(UINT16_MAX)));
+      server_status_ |= ok_packet.get_server_status().flags_;
+    }
+  } else if (resp.is_error_resp()) {
+    if (!is_error()) {
+      char *buf = NULL;
+      const ObString err_msg = resp.get_err_msg();
+      err_code_ = resp.get_err_code();
+      if (!err_msg.empty() && OB_NOT_NULL(buf = static_cast<char *>(allocator_->alloc(err_msg.length())))) {
+        MEMCPY(buf, err_msg.ptr(), err_msg.length());
+        err_msg_.assign_ptr(buf, err_msg.length());
+      }
+    }
+    LOG_WARN("sub sql of parallel dml failed", "cont_index", resp.get_cont_index(),
+             "err_code", resp.get_err_code(), "err_msg", resp.get_err_msg());
+  } else {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("unexpected resultset for dml", "cont_index", resp.get_cont_index(), K(ret));
+  }
+  return ret;
+}
+
+} // end of namespace executor
+} // end of namespace obproxy
+} // end of namespace oceanbase
@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_PARALLEL_DML_H
+#define OBPROXY_PARALLEL_DML_H
+
+#include "lib/string/ob_string.h"
+#include "lib/string/ob_sql_string.h"
+#include "lib/container/ob_se_array.h"
+#include "lib/allocator/ob_allocator.h"
+#include "obutils/ob_proxy_sql_parser.h"
+#include "ob_proxy_parallel_processor.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace executor
+{
+class ObProxyParallelResp;
+
+/*
+ * Text level split result of a multi-row dml:
+ *   insert into t(c1, c2) values (1, 'a'), (2, 'b') on duplicate key update ...
+ *   |-------------- head_ -------|- items_ ------||--------- tail_ ----------|
+ *
+ *   delete from t where c1 in (1, 2, 3) and ...
+ *   |-------- head_ ----------||items_||- tail_ -|
+ */
+class ObProxyDmlSplitResult
+{
+public:
+  ObProxyDmlSplitResult() { reset(); }
+  ~ObProxyDmlSplitResult() {}
+  void reset();
+
+  TO_STRING_KV(K_(head), K_(tail), K_(column_name), "column_count", columns_.count(),
+               "item_count", items_.count());
+
+public:
+  common::ObString head_;
+  common::ObString tail_;
+  // column of the in list
+  common::ObString column_name_;
+  // column list of insert
+  common::ObSEArray<common::ObString, 8> columns_;
+  // rows of insert or values of in list
+  common::ObSEArray<common::ObString, 64> items_;
+};
+
+class ObProxyDmlSplitter
+{
+public:
+  // split 'insert/replace ... values (...), (...) ...'
+  static int split_insert_values(const common::ObString &sql, ObProxyDmlSplitResult &result);
+  // split the first 'col in (v1, v2, ...)' of where clause, which must not have a top level 'or'
+  static int split_in_list(const common::ObString &sql, ObProxyDmlSplitResult &result);
+  // split '(v1, v2, ...)' into values
+  static int split_row_values(const common::ObString &row, common::ObIArray<common::ObString> &values);
+  // head + items[indexes] + tail
+  static int build_sql(const ObProxyDmlSplitResult &result,
+                       const common::ObIArray<int64_t> &item_indexes,
+                       common::ObSqlString &sql);
+  // only int and string literal can be used to calculate shard, string literal is unescaped
+  static bool get_column_value(const common::ObString &text, obutils::SqlColumnValue &value);
+  // whether the sql has a top level 'order by' or 'limit' clause
+  static bool has_order_by_or_limit(const common::ObString &sql);
+
+private:
+  static bool is_ident_char(const char c);
+  static int64_t skip_space(const char *ptr, const int64_t len, int64_t pos);
+  static int64_t skip_quote_or_comment(const char *ptr, const int64_t len, int64_t pos);
+  static int64_t find_matched_paren(const char *ptr, const int64_t len, int64_t pos);
+  static bool is_keyword_at(const char *ptr, const int64_t len, const int64_t pos, const char *keyword);
+  static bool is_or_at(const char *ptr, const int64_t len, const int64_t pos);
+  static bool is_negated(const char *ptr, const int64_t name_start);
+  static bool unescape_string(const common::ObString &text, const char quote,
+                              char *buf, const int64_t buf_len, int64_t &pos);
+  static int split_by_comma(const char *ptr, const int64_t start, const int64_t end,
+                            common::ObIArray<common::ObString> &values);
+};
+
+/*
+ * A multi-row dml which is split by shard, each sub sql is executed
+ * by parallel execute cont, and the ok packets are merged into one.
+ */
+class ObProxyParallelDmlPlan
+{
+public:
+  explicit ObProxyParallelDmlPlan(common::ObIAllocator *allocator)
+    : allocator_(allocator), parallel_param_(), affected_rows_(0), last_insert_id_(0),
+      warnings_(0), server_status_(0), finish_count_(0), err_code_(0), err_msg_() {}
+  ~ObProxyParallelDmlPlan();
+
+  // take the ref of shard_conn
+  int add_sub_sql(dbconfig::ObShardConnector *shard_conn, const common::ObString &sql);
+  int handle_resp(ObProxyParallelResp &resp);
+
+  common::ObIAllocator *get_allocator() const { return allocator_; }
+  common::ObIArray<ObProxyParallelParam> &get_parallel_param() { return parallel_param_; }
+  int64_t get_sub_sql_count() const { return parallel_param_.count(); }
+  int64_t get_affected_rows() const { return affected_rows_; }
+  uint64_t get_last_insert_id() const { return last_insert_id_; }
+  uint16_t get_warnings() const { return warnings_; }
+  uint16_t get_server_status() const { return server_status_; }
+  bool is_error() const { return 0 != err_code_; }
+  int get_err_code() const { return err_code_; }
+  const common::ObString &get_err_msg() const { return err_msg_; }
+
+  TO_STRING_KV("sub_sql_count", parallel_param_.count(), K_(affected_rows), K_(last_insert_id),
+               K_(warnings), K_(server_status), K_(finish_count), K_(err_code), K_(err_msg));
+
+private:
+  common::ObIAllocator *allocator_;
+  common::ObSEArray<ObProxyParallelParam, 4> parallel_param_;
+  int64_t affected_rows_;
+  // the smallest non-zero last insert id of sub sqls, it is the id of the first inserted row
+  uint64_t last_insert_id_;
+  uint16_t warnings_;
+  uint16_t server_status_;
+  int64_t finish_count_;
+  // the first error of sub sql
+  int err_code_;
+  common::ObString err_msg_;
+  DISALLOW_COPY_AND_ASSIGN(ObProxyParallelDmlPlan);
+};
+
+} // end of namespace executor
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+#endif // OBPROXY_PARALLEL_DML_H
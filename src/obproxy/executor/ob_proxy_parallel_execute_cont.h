@@ -40,6 +40,8 @@ public:
   bool is_resultset_resp() const { return resp_->is_resultset_resp(); }
   uint16_t get_err_code() const { return resp_->get_err_code(); }
   common::ObString get_err_msg() const {return resp_->get_err_msg(); }
+  int get_affected_rows(int64_t &affected_rows) { return resp_->get_affected_rows(affected_rows); }
+  int get_ok_packet(obmysql::OMPKOK &ok_packet) { return resp_->get_ok_packet(ok_packet); }
 
   ObMysqlField *get_field() const { return rs_fetcher_->get_field(); }
   int64_t get_column_count() { return column_count_; }
@@ -15,6 +15,7 @@
 
 #include "utils/ob_proxy_lib.h"
 #include "iocore/eventsystem/ob_thread_allocator.h"
+#include "lib/allocator/ob_hugepage_arena.h"
 
 namespace oceanbase
 {
@@ -29,6 +30,8 @@ namespace event
 #define DEFAULT_BUFFER_ALIGNMENT     16
 #define DEFAULT_BUFFER_BASE_SHIFT    7
 #define DEFAULT_BUFFER_BASE_SIZE     (1 << DEFAULT_BUFFER_BASE_SHIFT)
+// smaller ranges are copied rather than shared by cloned blocks
+#define MIN_SHARE_BLOCK_BYTES        512
 
 /**
  * These are defines so that code that used 2
@@ -65,7 +68,7 @@ public:
       ret = op_thread_fixed_mem_alloc(buf_allocator_[buffer_size_to_index(size)], get_8k_block_allocator());
     } else if (size < DEFAULT_MAX_BUFFER_SIZE) {
       ret = buf_allocator_[buffer_size_to_index(next_pow2(size))].alloc_void();
-    } else {
+    } else if (NULL == (ret = common::ObHugePageArena::get_instance().alloc(size, DEFAULT_BUFFER_ALIGNMENT))) {
       ret = common::ob_malloc_align(DEFAULT_BUFFER_ALIGNMENT, size,
                                     common::ObModIds::OB_LARGE_IO_BUFFER);
     }
@@ -78,6 +81,8 @@ public:
       op_thread_fixed_mem_free(buf_allocator_[buffer_size_to_index(size)], ptr, get_8k_block_allocator());
     } else if (size < DEFAULT_MAX_BUFFER_SIZE) {
       buf_allocator_[buffer_size_to_index(next_pow2(size))].free_void(ptr);
+    } else if (common::ObHugePageArena::get_instance().contains(ptr)) {
+      common::ObHugePageArena::get_instance().free(ptr);
     } else {
       common::ob_free_align(ptr);
     }
@@ -17,6 +17,7 @@
 #include <sys/eventfd.h>
 #endif
 #include "lib/profile/ob_trace_id.h"
+#include "lib/cpu/ob_numa_node.h"
 
 using namespace oceanbase::common;
 
@@ -31,8 +32,12 @@ ObEThread::ObEThread()
       ethreads_to_be_signalled_count_(0),
       id_(NO_ETHREAD_ID),
       event_types_(0),
+      numa_node_id_(-1),
       stack_start_(0),
       signal_hook_(NULL),
+      wakeup_pending_(false),
+      signal_sent_count_(0),
+      signal_saved_count_(0),
       ep_(NULL),
       net_handler_(NULL),
       net_poll_(NULL),
@@ -64,8 +69,12 @@ ObEThread::ObEThread(const ObThreadType att, const int64_t anid)
       ethreads_to_be_signalled_count_(0),
       id_(anid),
       event_types_(0),
+      numa_node_id_(-1),
       stack_start_(0),
       signal_hook_(NULL),
+      wakeup_pending_(false),
+      signal_sent_count_(0),
+      signal_saved_count_(0),
       ep_(NULL),
       net_handler_(NULL),
       net_poll_(NULL),
@@ -97,8 +106,12 @@ ObEThread::ObEThread(const ObThreadType att, ObEvent *e)
       ethreads_to_be_signalled_count_(0),
       id_(NO_ETHREAD_ID),
       event_types_(0),
+      numa_node_id_(-1),
       stack_start_(0),
       signal_hook_(NULL),
+      wakeup_pending_(false),
+      signal_sent_count_(0),
+      signal_saved_count_(0),
       ep_(NULL),
       net_handler_(NULL),
       net_poll_(NULL),
@@ -324,6 +337,9 @@ inline void ObEThread::dequeue_local_event(Que(ObEvent, link_) &negative_queue)
 // If successful, call the continuation, otherwise put the event back into the queue.
 void ObEThread::execute()
 {
+  if (numa_node_id_ >= 0) {
+    set_thread_numa_node(numa_node_id_);
+  }
   switch (tt_) {
     case REGULAR: {
       Que(ObEvent, link_) negative_queue;
@@ -355,6 +371,9 @@ void ObEThread::execute()
           }
         } while (done_one);
 
+        //2.1 fire the expired timers
+        timer_wheel_.advance(cur_time_);
+
         //3. execute any negative (poll) events
         if (NULL != negative_queue.head_) {
           if (ethreads_to_be_signalled_count_ > 0) {
@@ -383,7 +402,7 @@ void ObEThread::execute()
 
         //4. wait for the appropriate event
         } else {
-          next_time = event_queue_.earliest_timeout();
+          next_time = std::min(event_queue_.earliest_timeout(), timer_wheel_.earliest_timeout());
           sleep_time = next_time - cur_time_;
 
           if (sleep_time > THREAD_MAX_HEARTBEAT_MSECONDS * HRTIME_MSECOND) {
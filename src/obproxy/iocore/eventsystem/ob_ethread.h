@@ -34,6 +34,7 @@
 #include "iocore/eventsystem/ob_thread.h"
 #include "iocore/eventsystem/ob_priority_event_queue.h"
 #include "iocore/eventsystem/ob_protected_queue.h"
+#include "iocore/eventsystem/ob_timer_wheel.h"
 #include "lib/container/ob_vector.h"
 
 namespace oceanbase
@@ -299,6 +300,11 @@ public:
   void execute();
   void free_event(ObEvent &e);
 
+  // wake this thread up through signal_hook_, at most one signal is in
+  // flight until this thread calls clear_wakeup()
+  int wakeup();
+  void clear_wakeup() { ATOMIC_STORE(&wakeup_pending_, false); }
+
   bool is_event_thread_type(const ObEventThreadType et) { return !!(event_types_ & (1 << et)); }
   void set_event_thread_type(const ObEventThreadType et) { event_types_ |= (1 << et); }
 
@@ -331,18 +337,30 @@ public:
 
   // Block of memory to allocate thread specific data e.g. stat system arrays.
   char thread_private_[MAX_THREAD_DATA_SIZE];
+  // other threads push to event_queue_external_, keep it off the cache line
+  // of the stat arrays at the end of thread_private_
+  char thread_private_pad_[CACHE_ALIGN_SIZE];
 
   ObProtectedQueue event_queue_external_;
   ObPriorityEventQueue event_queue_;
+  // per connection timeouts, only armed and fired by this thread
+  ObTimerWheel timer_wheel_;
 
   ObEThread **ethreads_to_be_signalled_;
   int64_t ethreads_to_be_signalled_count_;
 
   int64_t id_;
   int64_t event_types_;
+  // numa node the thread is bound to, -1 means not bound
+  int64_t numa_node_id_;
   int64_t stack_start_; // statck start pos, used to minitor stack size
 
   int (*signal_hook_)(ObEThread &);
+  // set by the producer which calls signal_hook_, and cleared by this thread
+  // after it drains the hook, other producers skip the syscall in between
+  volatile bool wakeup_pending_;
+  volatile int64_t signal_sent_count_;
+  volatile int64_t signal_saved_count_;
 
 #if OB_HAVE_EVENTFD
   int evfd_;
@@ -471,6 +489,24 @@ inline ObEvent *ObEThread::schedule_every(
   return event;
 }
 
+inline int ObEThread::wakeup()
+{
+  int ret = common::OB_SUCCESS;
+  if (NULL != signal_hook_) {
+    if (!ATOMIC_LOAD(&wakeup_pending_) && ATOMIC_BCAS(&wakeup_pending_, false, true)) {
+      if (OB_FAIL(signal_hook_(*this))) {
+        // nothing is in flight, so the next producer must signal again
+        clear_wakeup();
+      } else {
+        (void)ATOMIC_AAF(&signal_sent_count_, 1);
+      }
+    } else {
+      (void)ATOMIC_AAF(&signal_saved_count_, 1);
+    }
+  }
+  return ret;
+}
+
 inline int ObEThread::schedule(ObEvent &event, const bool fast_signal)
 {
   int ret = common::OB_SUCCESS;
@@ -15,6 +15,7 @@
 #include "iocore/eventsystem/ob_event_system.h"
 #include <unistd.h>
 #include "utils/ob_cpu_affinity.h"
+#include "lib/cpu/ob_numa_node.h"
 
 using namespace oceanbase::common;
 
@@ -139,7 +140,8 @@ int64_t ObEventProcessor::get_cpu_count()
 }
 
 int ObEventProcessor::start(const int64_t net_thread_count, const int64_t stacksize,
-    const bool enable_cpu_topology/*false*/, const bool automatic_match_work_thread/*true*/)
+    const bool enable_cpu_topology/*false*/, const bool automatic_match_work_thread/*true*/,
+    const bool enable_numa_affinity/*false*/)
 {
   int ret = OB_SUCCESS;
   char thr_name[MAX_THREAD_NAME_LENGTH];
@@ -173,9 +175,12 @@ int ObEventProcessor::start(const int64_t net_thread_count, const int64_t stacks
     }
 
     bool bind_cpu = false;
+    bool bind_numa = false;
     ObCpuTopology::CoreInfo *core_info = NULL;
+    ObCpuTopology::NodeInfo *node_info = NULL;
     int64_t core_number = 0;
     int64_t cpu_number = 0;
+    int64_t node_number = 0;
     if (OB_SUCC(ret)) {
       if (enable_cpu_topology) {
         if (OB_ISNULL(cpu_topology = new (std::nothrow) ObCpuTopology())) {
@@ -193,6 +198,27 @@ int ObEventProcessor::start(const int64_t net_thread_count, const int64_t stacks
           } else {
             PROXY_NET_LOG(INFO, "we can't bind cpu to work thread", K(core_number), K(cpu_number), K_(event_thread_count));
           }
+
+          node_number = cpu_topology->get_node_number();
+          if (bind_cpu && enable_numa_affinity && node_number > 1) {
+            // node ids from lscpu may be sparse, every node in [0, node_number) must have cores
+            int64_t empty_node_id = -1;
+            ObCpuTopology::NodeInfo *tmp_node_info = NULL;
+            for (int64_t i = 0; i < node_number && empty_node_id < 0; ++i) {
+              if (OB_ISNULL(tmp_node_info = cpu_topology->get_node_info(i))
+                  || OB_UNLIKELY(tmp_node_info->core_number_ <= 0)) {
+                empty_node_id = i;
+              }
+            }
+            if (empty_node_id >= 0) {
+              PROXY_NET_LOG(WARN, "numa node has no core, we will not group work threads by numa node",
+                            K(empty_node_id), K(node_number), K_(event_thread_count));
+            } else {
+              bind_numa = true;
+              cpu_topology->publish_numa_node_map(true);
+              PROXY_NET_LOG(INFO, "we will group work threads by numa node", K(node_number), K_(event_thread_count));
+            }
+          }
         }
 
         if (OB_FAIL(ret)) {
@@ -208,8 +234,20 @@ int ObEventProcessor::start(const int64_t net_thread_count, const int64_t stacks
 
       int64_t core_id = -1;
       int64_t cpu_id = -1;
+      int64_t node_id = -1;
+      int64_t idx_in_node = -1;
 
       for (int64_t i = 0; i < event_thread_count_ && OB_SUCC(ret); ++i) {
+        if (bind_numa) {
+          // threads are split into node_number continuous groups, one group per node,
+          // thread i is the idx_in_node-th thread of its node
+          node_id = i * node_number / event_thread_count_;
+          idx_in_node = i - (node_id * event_thread_count_ + node_number - 1) / node_number;
+          all_event_threads_[i]->numa_node_id_ = node_id;
+          if (0 == i) {
+            set_thread_numa_node(node_id);
+          }
+        }
         int32_t length = snprintf(thr_name, sizeof(thr_name), "[ET_NET %ld]", i);
         if (OB_UNLIKELY(length <= 0) || OB_UNLIKELY(length >= static_cast<int32_t>(sizeof(thr_name)))) {
           ret = OB_SIZE_OVERFLOW;
@@ -218,15 +256,31 @@ int ObEventProcessor::start(const int64_t net_thread_count, const int64_t stacks
           LOG_WARN("fail to start event thread", K(thr_name), K(ret));
         } else {
           if (bind_cpu) {
-            core_id = i % core_number;
-            if (OB_ISNULL(core_info = cpu_topology->get_core_info(core_id))) {
+            if (bind_numa) {
+              if (OB_ISNULL(node_info = cpu_topology->get_node_info(node_id))
+                  || OB_UNLIKELY(node_info->core_number_ <= 0)) {
+                ret = OB_ENTRY_NOT_EXIST;
+                LOG_WARN("fail to get node_info", K(node_id), K(ret));
+              } else {
+                core_id = node_info->cores_[idx_in_node % node_info->core_number_];
+              }
+            } else {
+              core_id = i % core_number;
+            }
+            if (OB_FAIL(ret)) {
+              // do nothing
+            } else if (OB_ISNULL(core_info = cpu_topology->get_core_info(core_id))) {
               ret = OB_ENTRY_NOT_EXIST;
               LOG_WARN("fail to get core_info", K(core_info), K(core_id), K(ret));
             } else if (OB_UNLIKELY(core_info->cpu_number_ <= 0)) {
               ret = OB_ERR_UNEXPECTED;
               LOG_WARN("fail to get core_info", K(core_info->cpu_number_), K(core_id), K(ret));
             } else {
-              cpu_id =  (i / core_number) % (core_info->cpu_number_);
+              if (bind_numa) {
+                cpu_id = (idx_in_node / node_info->core_number_) % (core_info->cpu_number_);
+              } else {
+                cpu_id =  (i / core_number) % (core_info->cpu_number_);
+              }
               if (0 == i) {
                 if (OB_FAIL(cpu_topology->bind_cpu(core_info->cpues_[cpu_id], pthread_self()))) {
                   LOG_WARN("fail to bind_cpu", K(core_id), K(cpu_id), "thread_id", pthread_self());
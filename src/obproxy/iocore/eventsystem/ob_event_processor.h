@@ -274,11 +274,14 @@ public:
    *
    * @param net_thread_count
    * @param stacksize
+   * @param enable_numa_affinity  with cpu topology, group threads by numa
+   *                              node and keep object pool memory node local
    *
    * @return 0 if successful, and a negative value otherwise.
    */
   virtual int start(const int64_t net_thread_count, const int64_t stacksize = DEFAULT_STACKSIZE,
-                    const bool enable_cpu_topology = false, const bool automatic_match_work_thread = true);
+                    const bool enable_cpu_topology = false, const bool automatic_match_work_thread = true,
+                    const bool enable_numa_affinity = false);
 
   /**
    * Stop the ObEventProcessor. Attempts to stop the ObEventProcessor and
@@ -252,6 +252,41 @@ int ObMIOBuffer::write(ObIOBufferReader *r, const int64_t towrite_len,
   return ret;
 }
 
+int ObMIOBuffer::write(ObIOBufferBlock *b, const char *src_buf, const int64_t towrite_len,
+                       int64_t &written_len, int64_t &shared_len)
+{
+  int ret = OB_SUCCESS;
+  ObIOBufferBlock *bb = NULL;
+  written_len = 0;
+  shared_len = 0;
+
+  if (OB_ISNULL(b) || OB_ISNULL(src_buf) || OB_UNLIKELY(towrite_len <= 0)
+      || OB_UNLIKELY(src_buf < b->start()) || OB_UNLIKELY(src_buf + towrite_len > b->end())) {
+    ret = OB_INVALID_ARGUMENT;
+    PROXY_EVENT_LOG(WARN, "invalid argument", K(b), KP(src_buf), K(towrite_len), K(ret));
+  } else if (towrite_len < MIN_SHARE_BLOCK_BYTES) {
+    if (OB_FAIL(write(src_buf, towrite_len, written_len))) {
+      PROXY_EVENT_LOG(WARN, "failed to write data", K(towrite_len), K(ret));
+    }
+  } else if (OB_ISNULL(bb = b->clone())) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    PROXY_EVENT_LOG(ERROR, "failed to allocate memory for iobuffer block", K(ret));
+  } else {
+    bb->start_ = const_cast<char *>(src_buf);
+    bb->end_ = bb->start_ + towrite_len;
+    bb->buf_end_ = bb->end_;
+    if (OB_FAIL(append_block(bb))) {
+      bb->free();
+      PROXY_EVENT_LOG(WARN, "failed to append block", K(bb), K(ret));
+    } else {
+      written_len = towrite_len;
+      shared_len = towrite_len;
+    }
+  }
+
+  return ret;
+}
+
 char *ObIOBufferReader::copy(char *dest_buf, const int64_t copy_len,
                              const int64_t start_offset)
 {
@@ -752,6 +752,25 @@ public:
   int write(ObIOBufferReader *r, const int64_t towrite_len, int64_t &written_len,
             const int64_t start_offset = 0);
 
+  /**
+   * Add towrite_len bytes starting at src_buf, which must lie in the readable
+   * data of block b, to this buffer. A range of at least MIN_SHARE_BLOCK_BYTES
+   * is added by reference like write(ObIOBufferReader *), a clone of b
+   * narrowed to the range shares the data with b. A smaller range is copied,
+   * so that transforms handing over many small pieces do not build long block
+   * chains. shared_len returns the bytes added by reference.
+   *
+   * @param b
+   * @param src_buf
+   * @param towrite_len
+   * @param written_len
+   * @param shared_len
+   *
+   * @return
+   */
+  int write(ObIOBufferBlock *b, const char *src_buf, const int64_t towrite_len,
+            int64_t &written_len, int64_t &shared_len);
+
   /**
    * Same functionality as write but for the one small difference. The
    * space available in the last block is taken from the original and
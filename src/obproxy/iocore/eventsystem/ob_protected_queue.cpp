@@ -53,9 +53,7 @@ void ObProtectedQueue::enqueue(ObEvent *e, const bool fast_signal)
           LOG_WARN("fail to do signal, it should not happened", K(ret));
         }
         if (fast_signal) {
-          if (NULL != e_ethread->signal_hook_) {
-            e_ethread->signal_hook_(*e_ethread);
-          }
+          e_ethread->wakeup();
         }
       } else {
         bool need_break = false;
@@ -67,9 +65,8 @@ void ObProtectedQueue::enqueue(ObEvent *e, const bool fast_signal)
 #endif
         if (!need_break) {
           if (fast_signal) {
-            if (NULL != e_ethread->signal_hook_) {
-              e_ethread->signal_hook_(*e_ethread);
-            }
+            // flush_signals() will find the wakeup still pending and skip it
+            e_ethread->wakeup();
           }
 
           int64_t &count = inserting_thread->ethreads_to_be_signalled_count_;
@@ -137,9 +134,7 @@ void flush_signals(ObEThread *thr)
         if (OB_FAIL(thr->ethreads_to_be_signalled_[i]->event_queue_external_.signal())) {
           LOG_WARN("failed to do signal, it should not happened", K(ret));
         }
-        if (NULL != thr->ethreads_to_be_signalled_[i]->signal_hook_) {
-          thr->ethreads_to_be_signalled_[i]->signal_hook_(*(thr->ethreads_to_be_signalled_[i]));
-        }
+        thr->ethreads_to_be_signalled_[i]->wakeup();
         thr->ethreads_to_be_signalled_[i] = NULL;
       }
     }
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY_EVENT
+
+#include "iocore/eventsystem/ob_timer_wheel.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace event
+{
+
+ObTimerWheel::ObTimerWheel()
+  : current_tick_(get_hrtime_internal() / WHEEL_TICK), entry_count_(0)
+{
+}
+
+void ObTimerWheel::insert(ObTimerWheelEntry &entry)
+{
+  // round up, an entry never fires before its timeout
+  int64_t expire_tick = (entry.timeout_at_ + WHEEL_TICK - 1) / WHEEL_TICK;
+  if (expire_tick < current_tick_) {
+    expire_tick = current_tick_;
+  }
+  const int64_t delta = expire_tick - current_tick_;
+  int32_t level = 0;
+  while (level < WHEEL_LEVEL_COUNT - 1 && delta >= (1L << ((level + 1) * WHEEL_SLOT_BITS))) {
+    ++level;
+  }
+  if (delta >= (1L << (WHEEL_LEVEL_COUNT * WHEEL_SLOT_BITS))) {
+    // beyond the wheel, wait in the farthest slot
+    expire_tick = current_tick_ + (1L << (WHEEL_LEVEL_COUNT * WHEEL_SLOT_BITS)) - 1;
+  }
+  entry.level_ = level;
+  entry.slot_ = static_cast<int32_t>((expire_tick >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK);
+  slots_[level][entry.slot_].enqueue(&entry);
+}
+
+void ObTimerWheel::arm(ObTimerWheelEntry &entry, const ObHRTime timeout_at)
+{
+  if (entry.is_armed()) {
+    cancel(entry);
+  }
+  entry.timeout_at_ = timeout_at;
+  insert(entry);
+  ++entry_count_;
+}
+
+void ObTimerWheel::cancel(ObTimerWheelEntry &entry)
+{
+  if (ObTimerWheelEntry::EXPIRED == entry.level_) {
+    expired_list_.remove(&entry);
+    entry.level_ = ObTimerWheelEntry::NOT_ARMED;
+    --entry_count_;
+  } else if (entry.is_armed()) {
+    slots_[entry.level_][entry.slot_].remove(&entry);
+    entry.level_ = ObTimerWheelEntry::NOT_ARMED;
+    --entry_count_;
+  }
+}
+
+void ObTimerWheel::cascade(const int64_t level)
+{
+  const int64_t slot = (current_tick_ >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+  Que(ObTimerWheelEntry, link_) q = slots_[level][slot];
+  slots_[level][slot].reset();
+
+  ObTimerWheelEntry *entry = NULL;
+  while (NULL != (entry = q.dequeue())) {
+    insert(*entry);
+  }
+  if (0 == slot && level + 1 < WHEEL_LEVEL_COUNT) {
+    cascade(level + 1);
+  }
+}
+
+int64_t ObTimerWheel::advance(const ObHRTime now)
+{
+  int64_t fired_count = 0;
+  const int64_t now_tick = now / WHEEL_TICK;
+  ObTimerWheelEntry *entry = NULL;
+
+  if (0 == entry_count_) {
+    if (now_tick >= current_tick_) {
+      current_tick_ = now_tick + 1;
+    }
+  } else {
+    while (current_tick_ <= now_tick) {
+      const int64_t slot = current_tick_ & WHEEL_SLOT_MASK;
+      if (0 == slot) {
+        cascade(1);
+      }
+      while (NULL != (entry = slots_[0][slot].dequeue())) {
+        entry->level_ = ObTimerWheelEntry::EXPIRED;
+        expired_list_.enqueue(entry);
+      }
+      ++current_tick_;
+    }
+  }
+
+  // the handlers may arm or cancel any entry, the wheel is consistent now
+  while (NULL != (entry = expired_list_.dequeue())) {
+    entry->level_ = ObTimerWheelEntry::NOT_ARMED;
+    --entry_count_;
+    ++fired_count;
+    entry->handle_timeout(now);
+  }
+  return fired_count;
+}
+
+ObHRTime ObTimerWheel::earliest_timeout() const
+{
+  ObHRTime ret = HRTIME_FOREVER;
+  if (!expired_list_.empty()) {
+    ret = 0;
+  } else if (entry_count_ > 0) {
+    // the first non-empty slot of level 0, or the next cascade
+    int64_t tick = current_tick_;
+    bool found = false;
+    do {
+      found = !slots_[0][tick & WHEEL_SLOT_MASK].empty();
+      if (!found) {
+        ++tick;
+      }
+    } while (!found && 0 != (tick & WHEEL_SLOT_MASK));
+    ret = tick * WHEEL_TICK;
+  }
+  return ret;
+}
+
+} // end of namespace event
+} // end of namespace obproxy
+} // end of namespace oceanbase
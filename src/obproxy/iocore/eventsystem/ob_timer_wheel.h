@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_TIMER_WHEEL_H
+#define OBPROXY_TIMER_WHEEL_H
+
+#include "lib/atomic/ob_atomic.h"
+#include "lib/list/ob_intrusive_list.h"
+#include "lib/time/ob_hrtime.h"
+#include "lib/utility/ob_print_utils.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace event
+{
+class ObTimerWheel;
+
+// Embedded in the object which owns the timeout, armed and fired on one thread only
+class ObTimerWheelEntry
+{
+public:
+  ObTimerWheelEntry() : timeout_at_(0), level_(NOT_ARMED), slot_(0) {}
+  virtual ~ObTimerWheelEntry() {}
+
+  // called by the owner thread after the entry expires and is disarmed,
+  // it can arm the entry again
+  virtual void handle_timeout(const ObHRTime now) = 0;
+
+  bool is_armed() const { return NOT_ARMED != level_; }
+  ObHRTime get_timeout_at() const { return timeout_at_; }
+
+  TO_STRING_KV(K_(timeout_at), K_(level), K_(slot));
+
+public:
+  static const int32_t NOT_ARMED = -1;
+  static const int32_t EXPIRED = -2;
+
+  ObHRTime timeout_at_;
+  int32_t level_;
+  int32_t slot_;
+  LINK(ObTimerWheelEntry, link_);
+};
+
+/*
+ * Hierarchical timing wheel, arm, cancel and re-arm are O(1). Level 0 has
+ * one slot per tick, each slot of level N covers all slots of level N - 1,
+ * and entries are moved down one level when the wheel turns to their slot.
+ * Entries beyond the last level wait in its farthest slot and are placed
+ * again each time the slot is turned to.
+ */
+class ObTimerWheel
+{
+public:
+  static const int64_t WHEEL_LEVEL_COUNT = 4;
+  static const int64_t WHEEL_SLOT_BITS = 6;
+  static const int64_t WHEEL_SLOT_COUNT = 1 << WHEEL_SLOT_BITS;
+  static const int64_t WHEEL_SLOT_MASK = WHEEL_SLOT_COUNT - 1;
+  static const int64_t WHEEL_TICK = HRTIME_MSECONDS(10);
+
+  ObTimerWheel();
+  ~ObTimerWheel() {}
+
+  // arm or re-arm @entry to fire no earlier than @timeout_at
+  void arm(ObTimerWheelEntry &entry, const ObHRTime timeout_at);
+  void cancel(ObTimerWheelEntry &entry);
+  // turn the wheel to @now and fire all the expired entries
+  int64_t advance(const ObHRTime now);
+  // the time advance() should be called next, HRTIME_FOREVER if nothing is armed
+  ObHRTime earliest_timeout() const;
+  int64_t get_entry_count() const { return entry_count_; }
+
+  TO_STRING_KV(K_(current_tick), K_(entry_count));
+
+private:
+  void insert(ObTimerWheelEntry &entry);
+  void cascade(const int64_t level);
+
+private:
+  // all ticks before it are done
+  int64_t current_tick_;
+  int64_t entry_count_;
+  Que(ObTimerWheelEntry, link_) slots_[WHEEL_LEVEL_COUNT][WHEEL_SLOT_COUNT];
+  // expired entries waiting to be fired
+  Que(ObTimerWheelEntry, link_) expired_list_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObTimerWheel);
+};
+
+} // end of namespace event
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+#endif // OBPROXY_TIMER_WHEEL_H
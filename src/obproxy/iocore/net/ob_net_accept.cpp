@@ -13,6 +13,7 @@
 #include "iocore/net/ob_net_accept.h"
 #include "iocore/net/ob_net.h"
 #include "iocore/net/ob_event_io.h"
+#include "lib/cpu/ob_numa_node.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obproxy::event;
@@ -368,14 +369,24 @@ inline ObEThread *ObNetAccept::get_schedule_ethread()
   ObEThread *target_ethread = NULL;
   int64_t min_conn_cnt = -1;
   int64_t tmp_cnt = -1;
+  int64_t node_id = numa_node_id_;
+  bool need_retry = true;
 
-  for (int64_t i = 0; i < net_thread_count; ++i) {
-    NET_THREAD_READ_DYN_SUM(netthreads[i], NET_CLIENT_CONNECTIONS_CURRENTLY_OPEN, tmp_cnt);
-    if (0 == i || tmp_cnt < min_conn_cnt) {
-      min_conn_cnt = tmp_cnt;
-      target_ethread = netthreads[i];
+  while (need_retry) {
+    for (int64_t i = 0; i < net_thread_count; ++i) {
+      if (node_id >= 0 && netthreads[i]->numa_node_id_ != node_id) {
+        continue;
+      }
+      NET_THREAD_READ_DYN_SUM(netthreads[i], NET_CLIENT_CONNECTIONS_CURRENTLY_OPEN, tmp_cnt);
+      if (NULL == target_ethread || tmp_cnt < min_conn_cnt) {
+        min_conn_cnt = tmp_cnt;
+        target_ethread = netthreads[i];
+      }
+      tmp_cnt = -1;
     }
-    tmp_cnt = -1;
+    // no ethread on this node now, serve this connection on any node
+    need_retry = (NULL == target_ethread && node_id >= 0);
+    node_id = -1;
   }
   return target_ethread;
 }
@@ -508,6 +519,7 @@ int ObNetAccept::accept_fast_event(int event, void *ep)
             PROXY_NET_LOG(ERROR, "fail to start ObEventIO", K(con.addr_), K(con.fd_), K(ret));
           } else {
             vc->nh_->open_list_.enqueue(vc);
+            vc->schedule_inactivity_timer();
 #ifdef USE_EDGE_TRIGGER
             // Set the vc as triggered and place it in the read ready queue in case
             // there is already data on the socket.
@@ -648,6 +660,13 @@ int ObNetAccept::accept_loop_event(int event, ObEvent *e)
   } else if (OB_FAIL(pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL))) {
     PROXY_NET_LOG(WARN, "fail to do pthread_setcanceltype PTHREAD_CANCEL_ASYNCHRONOUS", K(ret));
   } else {
+    if (numa_node_id_ >= 0) {
+      int tmp_ret = OB_SUCCESS;
+      if (OB_SUCCESS != (tmp_ret = bind_thread_to_numa_node(numa_node_id_))) {
+        PROXY_NET_LOG(WARN, "fail to bind accept thread to numa node, accept on any cpu",
+                      K_(numa_node_id), K(tmp_ret));
+      }
+    }
     // current thread maybe pthread_cancel in other place, we need register its free func
     pthread_cleanup_push(free_netaccept, static_cast<void *>(this));
     while (do_blocking_accept() >= 0) { }
@@ -669,6 +688,7 @@ ObNetAccept::ObNetAccept()
       packet_mark_(0),
       packet_tos_(0),
       etype_(ET_CALL),
+      numa_node_id_(-1),
       is_inited_(false),
       period_(0),
       epoll_vc_(NULL),
@@ -117,6 +117,9 @@ public:
   uint32_t packet_mark_;
   uint32_t packet_tos_;
   event::ObEventThreadType etype_;
+  // numa node of dedicated accept thread, the accepted connections are only
+  // scheduled to ethreads on this node, -1 means any node
+  int64_t numa_node_id_;
 
 private:
   bool is_inited_;
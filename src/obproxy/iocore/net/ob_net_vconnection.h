@@ -461,7 +461,7 @@ public:
 
   // for OBAPI
   bool get_is_force_timeout() const { return is_force_timeout_; }
-  void set_is_force_timeout(const bool force_timeout) { is_force_timeout_ = force_timeout;}
+  virtual void set_is_force_timeout(const bool force_timeout) { is_force_timeout_ = force_timeout;}
 
 public:
   // Structure holding user options
@@ -12,6 +12,8 @@
 
 #define USING_LOG_PREFIX PROXY_NET
 
+#include <openssl/rand.h>
+#include <openssl/hmac.h>
 #include "iocore/net/ob_ssl_processor.h"
 #include "iocore/eventsystem/ob_ethread.h"
 #include "lib/ob_errno.h"
@@ -52,11 +54,177 @@ int ObSSLProcessor::init()
   } else {
     ssl_ctx_ = ssl_ctx;
     SSL_CTX_set_verify(ssl_ctx_, SSL_VERIFY_PEER, NULL);
+    // resume with tickets only, no session is kept in ssl ctx, the server
+    // side is stateless and the client side is cached by ourselves
+    SSL_CTX_set_session_id_context(ssl_ctx_, reinterpret_cast<const unsigned char *>("obproxy"),
+                                   static_cast<unsigned int>(strlen("obproxy")));
+    SSL_CTX_set_session_cache_mode(ssl_ctx_, SSL_SESS_CACHE_BOTH | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(ssl_ctx_, ObSSLProcessor::new_session_callback);
+    SSL_CTX_set_tlsext_ticket_key_cb(ssl_ctx_, ObSSLProcessor::ticket_key_callback);
+    if (OB_FAIL(rotate_ticket_key_if_needed(true))) {
+      LOG_WARN("fail to generate ssl ticket key", K(ret));
+    }
+  }
+
+  return ret;
+}
+
+int ObSSLProcessor::rotate_ticket_key_if_needed(const bool force)
+{
+  int ret = OB_SUCCESS;
+  const int64_t now = ObTimeUtility::current_time();
+  const int64_t rotate_interval = get_global_proxy_config().ssl_ticket_key_rotate_interval;
+  bool need_rotate = force;
+  if (!need_rotate) {
+    DRWLock::RDLockGuard guard(ticket_key_lock_);
+    need_rotate = (now - ticket_keys_[current_ticket_key_].create_time_us_ >= rotate_interval);
   }
 
+  if (need_rotate) {
+    DRWLock::WRLockGuard guard(ticket_key_lock_);
+    // check again, another thread may have rotated it
+    if (force || now - ticket_keys_[current_ticket_key_].create_time_us_ >= rotate_interval) {
+      const int64_t next_ticket_key = (current_ticket_key_ + 1) % TICKET_KEY_COUNT;
+      ObSSLTicketKey &key = ticket_keys_[next_ticket_key];
+      if (OB_SSL_SUCC_RET != RAND_bytes(key.name_, ObSSLTicketKey::TICKET_KEY_NAME_LEN)
+          || OB_SSL_SUCC_RET != RAND_bytes(key.aes_key_, ObSSLTicketKey::TICKET_KEY_LEN)
+          || OB_SSL_SUCC_RET != RAND_bytes(key.hmac_key_, ObSSLTicketKey::TICKET_KEY_LEN)) {
+        ret = OB_SSL_ERROR;
+        // never match a ticket with a half generated key
+        key.create_time_us_ = 0;
+        LOG_WARN("fail to generate ssl ticket key", K(ret));
+      } else {
+        key.create_time_us_ = now;
+        current_ticket_key_ = next_ticket_key;
+        LOG_INFO("succ to rotate ssl ticket key", K_(current_ticket_key), K(rotate_interval));
+      }
+    }
+  }
   return ret;
 }
 
+int ObSSLProcessor::ticket_key_callback(SSL *ssl, unsigned char *key_name, unsigned char *iv,
+                                        EVP_CIPHER_CTX *cipher_ctx, HMAC_CTX *hmac_ctx, int enc)
+{
+  UNUSED(ssl);
+  // -1 fails the handshake, 0 ignores the ticket and does a full handshake,
+  // 1 accepts the ticket and 2 accepts it and issues a new one
+  int cb_ret = -1;
+  int ret = OB_SUCCESS;
+  ObSSLProcessor &processor = g_ssl_processor;
+  if (1 == enc) {
+    if (OB_FAIL(processor.rotate_ticket_key_if_needed(false))) {
+      // keep using the current key
+      LOG_WARN("fail to rotate ssl ticket key", K(ret));
+    }
+    DRWLock::RDLockGuard guard(processor.ticket_key_lock_);
+    const ObSSLTicketKey &key = processor.ticket_keys_[processor.current_ticket_key_];
+    if (OB_SSL_SUCC_RET != RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc()))) {
+      LOG_WARN("fail to generate ssl ticket iv");
+    } else if (OB_SSL_SUCC_RET != EVP_EncryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), NULL, key.aes_key_, iv)) {
+      LOG_WARN("fail to init ssl ticket encryption");
+    } else if (OB_SSL_SUCC_RET != HMAC_Init_ex(hmac_ctx, key.hmac_key_, ObSSLTicketKey::TICKET_KEY_LEN,
+                                               EVP_sha256(), NULL)) {
+      LOG_WARN("fail to init ssl ticket hmac");
+    } else {
+      MEMCPY(key_name, key.name_, ObSSLTicketKey::TICKET_KEY_NAME_LEN);
+      cb_ret = 1;
+    }
+  } else {
+    DRWLock::RDLockGuard guard(processor.ticket_key_lock_);
+    cb_ret = 0;
+    for (int64_t i = 0; 0 == cb_ret && i < TICKET_KEY_COUNT; ++i) {
+      const ObSSLTicketKey &key = processor.ticket_keys_[i];
+      if (key.create_time_us_ > 0
+          && 0 == MEMCMP(key_name, key.name_, ObSSLTicketKey::TICKET_KEY_NAME_LEN)) {
+        if (OB_SSL_SUCC_RET != HMAC_Init_ex(hmac_ctx, key.hmac_key_, ObSSLTicketKey::TICKET_KEY_LEN,
+                                            EVP_sha256(), NULL)) {
+          cb_ret = -1;
+          LOG_WARN("fail to init ssl ticket hmac");
+        } else if (OB_SSL_SUCC_RET != EVP_DecryptInit_ex(cipher_ctx, EVP_aes_256_cbc(), NULL, key.aes_key_, iv)) {
+          cb_ret = -1;
+          LOG_WARN("fail to init ssl ticket decryption");
+        } else {
+          cb_ret = (i == processor.current_ticket_key_) ? 1 : 2;
+        }
+      }
+    }
+  }
+  return cb_ret;
+}
+
+int ObSSLProcessor::new_session_callback(SSL *ssl, SSL_SESSION *session)
+{
+  // 1 means we take the reference of session
+  int cb_ret = 0;
+  int ret = OB_SUCCESS;
+  // only server links set the remote address
+  const sockaddr *addr = static_cast<const sockaddr *>(SSL_get_app_data(ssl));
+  if (NULL != addr) {
+    if (OB_FAIL(g_ssl_processor.save_client_session(*addr, session))) {
+      LOG_WARN("fail to save ssl client session", K(ret));
+    } else {
+      cb_ret = 1;
+    }
+  }
+  return cb_ret;
+}
+
+int ObSSLProcessor::save_client_session(const sockaddr &addr, SSL_SESSION *session)
+{
+  int ret = OB_SUCCESS;
+  ObIpEndpoint endpoint(addr);
+  if (OB_ISNULL(session) || OB_UNLIKELY(!endpoint.is_valid())) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(session), K(endpoint), K(ret));
+  } else {
+    SSL_SESSION *old_session = NULL;
+    {
+      DRWLock::WRLockGuard guard(client_session_lock_);
+      ObSSLClientSession &item = client_sessions_[endpoint.hash() % CLIENT_SESSION_CACHE_SIZE];
+      old_session = item.session_;
+      item.addr_ = endpoint;
+      item.session_ = session;
+    }
+    if (NULL != old_session) {
+      SSL_SESSION_free(old_session);
+    }
+  }
+  return ret;
+}
+
+void ObSSLProcessor::set_client_session(SSL *ssl, const sockaddr &addr)
+{
+  if (NULL != ssl && get_global_proxy_config().enable_ssl_session_resumption) {
+    ObIpEndpoint endpoint(addr);
+    SSL_set_app_data(ssl, const_cast<sockaddr *>(&addr));
+    DRWLock::RDLockGuard guard(client_session_lock_);
+    const ObSSLClientSession &item = client_sessions_[endpoint.hash() % CLIENT_SESSION_CACHE_SIZE];
+    // the session ref is added by SSL_set_session
+    if (NULL != item.session_ && ops_ip_addr_port_eq(item.addr_, addr)
+        && OB_SSL_SUCC_RET != SSL_set_session(ssl, item.session_)) {
+      LOG_WARN("fail to set ssl client session", K(endpoint));
+    }
+  }
+}
+
+bool ObSSLProcessor::is_ktls_enabled(SSL *ssl)
+{
+  bool bret = false;
+#if OB_HAVE_KTLS
+  // non application records of tls1.3 can not be read by plain read, which
+  // are only sent by the observer, e.g. new session ticket
+  bret = NULL != ssl
+         && BIO_get_ktls_send(SSL_get_wbio(ssl))
+         && BIO_get_ktls_recv(SSL_get_rbio(ssl))
+         && !SSL_has_pending(ssl)
+         && (SSL_is_server(ssl) || TLS1_3_VERSION != SSL_version(ssl));
+#else
+  UNUSED(ssl);
+#endif
+  return bret;
+}
+
 void *ObSSLProcessor::malloc_for_ssl(size_t size)
 {
   void *ptr = NULL;
@@ -221,6 +389,17 @@ SSL* ObSSLProcessor::create_new_ssl()
 {
   SSL *new_ssl = NULL;
   new_ssl = SSL_new(ssl_ctx_);
+  if (NULL != new_ssl) {
+    const ObProxyConfig &config = get_global_proxy_config();
+    if (!config.enable_ssl_session_resumption) {
+      SSL_set_options(new_ssl, SSL_OP_NO_TICKET);
+    }
+#if OB_HAVE_KTLS
+    if (config.enable_ktls) {
+      SSL_set_options(new_ssl, SSL_OP_ENABLE_KTLS);
+    }
+#endif
+  }
 
   return new_ssl;
 }
@@ -17,10 +17,19 @@
 #include <openssl/err.h>
 
 #include "iocore/eventsystem/ob_lock.h"
+#include "iocore/net/ob_inet.h"
 #include "lib/lock/ob_drw_lock.h"
 
 #define OB_SSL_SUCC_RET 1
 
+// kernel tls needs openssl built with ktls, the record keys are handed to the
+// socket by openssl itself after the handshake
+#if defined(SSL_OP_ENABLE_KTLS)
+#define OB_HAVE_KTLS 1
+#else
+#define OB_HAVE_KTLS 0
+#endif
+
 namespace oceanbase
 {
 namespace obproxy
@@ -28,14 +37,33 @@ namespace obproxy
 namespace net
 {
 
+struct ObSSLTicketKey
+{
+  static const int64_t TICKET_KEY_NAME_LEN = 16;
+  static const int64_t TICKET_KEY_LEN = 32;
+
+  unsigned char name_[TICKET_KEY_NAME_LEN];
+  unsigned char aes_key_[TICKET_KEY_LEN];
+  unsigned char hmac_key_[TICKET_KEY_LEN];
+  int64_t create_time_us_;
+};
+
 class ObSSLProcessor
 {
 public:
-  ObSSLProcessor() : ssl_ctx_(NULL), ssl_inited_(false) {}
+  ObSSLProcessor() : ssl_ctx_(NULL), ssl_inited_(false), current_ticket_key_(0)
+  {
+    memset(ticket_keys_, 0, sizeof(ticket_keys_));
+    memset(client_sessions_, 0, sizeof(client_sessions_));
+  }
   ~ObSSLProcessor() {}
   int init();
   SSL* create_new_ssl();
   void release_ssl(SSL* ssl, const bool can_shutdown_ssl);
+  // resume the session cached for @addr, the new session will be saved for @addr too
+  void set_client_session(SSL *ssl, const sockaddr &addr);
+  // whether both directions of @ssl are done by kernel, then plain read and write work
+  static bool is_ktls_enabled(SSL *ssl);
   void openssl_lock(int n);
   void openssl_unlock(int n);
   bool is_client_ssl_supported();
@@ -53,14 +81,39 @@ private:
   int update_key_from_dbmesh(const common::ObString &ca,
                              const common::ObString &public_key,
                              const common::ObString &private_key);
+  int rotate_ticket_key_if_needed(const bool force);
+  int save_client_session(const sockaddr &addr, SSL_SESSION *session);
+
 private:
+  static int ticket_key_callback(SSL *ssl, unsigned char *key_name, unsigned char *iv,
+                                 EVP_CIPHER_CTX *cipher_ctx, HMAC_CTX *hmac_ctx, int enc);
+  static int new_session_callback(SSL *ssl, SSL_SESSION *session);
   static void *malloc_for_ssl(size_t num);
   static void *realloc_for_ssl(void *p, size_t num);
   static void free_for_ssl(void *str);
 
 private:
+  static const int64_t TICKET_KEY_COUNT = 2;
+  static const int64_t CLIENT_SESSION_CACHE_SIZE = 1024;
+
+  struct ObSSLClientSession
+  {
+    ObIpEndpoint addr_;
+    SSL_SESSION *session_;
+  };
+
   SSL_CTX *ssl_ctx_;
   bool ssl_inited_;
+
+  // shared by all net threads, tickets encrypted by the previous key are
+  // still accepted and renewed with the current one
+  common::DRWLock ticket_key_lock_;
+  int64_t current_ticket_key_;
+  ObSSLTicketKey ticket_keys_[TICKET_KEY_COUNT];
+
+  // sessions of server links, one per observer address
+  common::DRWLock client_session_lock_;
+  ObSSLClientSession client_sessions_[CLIENT_SESSION_CACHE_SIZE];
 };
 
 extern ObSSLProcessor g_ssl_processor;
@@ -41,6 +41,9 @@ static inline int net_signal_hook_callback(ObEThread &thread)
   if (OB_FAIL(ret)) {
     PROXY_NET_LOG(WARN, "fail to read from net", K(counter), K(count), K(ret));
   }
+  // after the read, a producer that finds it pending has its event drained
+  // before the next epoll_wait, later ones will write again
+  thread.clear_wakeup();
   return ret;
 }
 
@@ -264,60 +267,23 @@ int ObInactivityCop::check_inactivity(int event, ObEvent *e)
       }
     }
 
-    // Copy the list and use pop() to catch any closes caused by callbacks.
-    forl_LL(ObUnixNetVConnection, vc, nh.open_list_) {
-      if (vc->thread_ == ethread) {
-        if (ObUnixNetVConnection::VC_ACCEPT == vc->source_type_) {
-          ++total_connections_in_;
+    NET_THREAD_READ_DYN_SUM(ethread, NET_CLIENT_CONNECTIONS_CURRENTLY_OPEN, total_connections_in_);
+
+    // timeouts are fired by the timer wheel, only walk all the connections
+    // when they must time out at once or some were changed by other threads
+    if (ATOMIC_LOAD(&nh.cop_sweep_pending_)
+        || (info.graceful_exit_end_time_ > 0 && info.graceful_exit_end_time_ < now)) {
+      ATOMIC_STORE(&nh.cop_sweep_pending_, false);
+      // Copy the list and use pop() to catch any closes caused by callbacks.
+      forl_LL(ObUnixNetVConnection, vc, nh.open_list_) {
+        if (vc->thread_ == ethread) {
+          nh.cop_list_.push(vc);
         }
-        nh.cop_list_.push(vc);
       }
-    }
-
-    ObUnixNetVConnection *vc = NULL;
-    ObHRTime diff = 0;
-
-    int close_ret = OB_SUCCESS;
-    while ((NULL != (vc = nh.cop_list_.pop())) && OB_SUCC(ret)) {
-      // If we cannot get the lock don't stop just keep cleaning
-      MUTEX_TRY_LOCK(lock, vc->mutex_, ethread);
-      if (!lock.is_locked()) {
-        NET_INCREMENT_DYN_STAT(INACTIVITY_COP_LOCK_ACQUIRE_FAILURE);
-      } else if (vc->closed_) {
-        if (OB_UNLIKELY(OB_SUCCESS != (close_ret = vc->close()))) {
-          PROXY_NET_LOG(WARN, "fail to close unix net vconnection", K(vc), K(close_ret));
-        }
-      } else {
-
-        if (vc->get_is_force_timeout()
-            || (info.graceful_exit_end_time_ > 0 && info.graceful_exit_end_time_ < now)) {
-          vc->next_inactivity_timeout_at_ = now; // force the connection timeout
-        }
-
-        // set a default inactivity timeout if one is not set
-        if (0 == vc->next_inactivity_timeout_at_ && default_inactivity_timeout_ > 0) {
-          PROXY_NET_LOG(DEBUG, "inactivity timeout not set, setting a default",
-                        K(vc), K(vc->source_type_), K(default_inactivity_timeout_));
-          vc->set_inactivity_timeout(HRTIME_SECONDS(default_inactivity_timeout_));
-          NET_INCREMENT_DYN_STAT(DEFAULT_INACTIVITY_TIMEOUT);
-        } else {
-          PROXY_NET_LOG(DEBUG, "inactivity timeout state", K(vc), K(vc->source_type_),
-                        "next_inactivity_timeout_at", hrtime_to_sec(vc->next_inactivity_timeout_at_),
-                        "inactivity_timeout_in", hrtime_to_sec(vc->inactivity_timeout_in_));
-        }
 
-        if (vc->next_inactivity_timeout_at_ > 0 && vc->next_inactivity_timeout_at_ <= now) {
-          if (nh.keep_alive_list_.in(vc)) {
-            // only stat if the connection is in keep-alive, there can be other inactivity timeouts
-            diff = (now - (vc->next_inactivity_timeout_at_ - vc->inactivity_timeout_in_)) / HRTIME_SECOND;
-            NET_SUM_DYN_STAT(KEEP_ALIVE_LRU_TIMEOUT_TOTAL, diff);
-            NET_INCREMENT_DYN_STAT(KEEP_ALIVE_LRU_TIMEOUT_COUNT);
-          }
-          PROXY_NET_LOG(DEBUG, "inactivity timeout state", K(vc), K(vc->source_type_), K(now),
-                        "next_inactivity_timeout_at", hrtime_to_sec(vc->next_inactivity_timeout_at_),
-                        "inactivity_timeout_in", hrtime_to_sec(vc->inactivity_timeout_in_));
-          vc->handle_event(EVENT_IMMEDIATE, e);
-        }
+      ObUnixNetVConnection *vc = NULL;
+      while (NULL != (vc = nh.cop_list_.pop())) {
+        vc->check_inactivity(now, *e);
       }
     }
 
@@ -417,7 +383,8 @@ int ObInactivityCop::keep_alive_lru(ObNetHandler &nh, const ObHRTime now, ObEven
 ObNetHandler::ObNetHandler()
     : ObContinuation(NULL),
       trigger_event_(NULL),
-      keep_alive_lru_size_(0)
+      keep_alive_lru_size_(0),
+      cop_sweep_pending_(false)
 {
   SET_HANDLER(reinterpret_cast<NetContHandler>(&ObNetHandler::start_net_event));
 }
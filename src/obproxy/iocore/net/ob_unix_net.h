@@ -31,6 +31,7 @@ typedef int (ObNetHandler::*NetContHandler)(int event, void *data);
 
 #define TRANSIENT_ACCEPT_ERROR_MESSAGE_EVERY      HRTIME_HOURS(24)
 #define NET_RETRY_DELAY                           HRTIME_MSECONDS(1)
+#define NET_INACTIVITY_CHECK_DELAY                HRTIME_SECONDS(1)
 #define NET_PERIOD                               -HRTIME_MSECONDS(1)
 #define ACCEPT_PERIOD                            -HRTIME_MSECONDS(1)
 
@@ -52,8 +53,10 @@ private:
   DISALLOW_COPY_AND_ASSIGN(ObNetPoll);
 };
 
-// One Inactivity cop runs on each thread once every second and
-// loops through the list of NetVCs and calls the timeouts
+// One Inactivity cop runs on each thread once every second. The timeouts of
+// NetVCs are fired by the timer wheel of their thread, the cop only loops
+// through all of them when they must time out at once or some of them were
+// changed by other threads, and closes the idle ones beyond the limit
 class ObInactivityCop : public event::ObContinuation
 {
 public:
@@ -65,6 +68,7 @@ public:
   void set_max_connections(const int64_t x) { max_connections_in_ = x; }
   void set_connections_per_thread(const int64_t x) { connections_per_thread_in_ = x; }
   void set_default_timeout(const int64_t x) { default_inactivity_timeout_ = x; }
+  int64_t get_default_timeout() const { return default_inactivity_timeout_; }
 
 private:
   int keep_alive_lru(ObNetHandler &nh, ObHRTime now, event::ObEvent *e);
@@ -103,6 +107,10 @@ public:
   Que(ObUnixNetVConnection, keep_alive_link_) keep_alive_list_;
 
   int64_t keep_alive_lru_size_;
+  // set by other threads, the inactivity cop will check all the connections
+  volatile bool cop_sweep_pending_;
+
+  void request_cop_sweep() { ATOMIC_STORE(&cop_sweep_pending_, true); }
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ObNetHandler);
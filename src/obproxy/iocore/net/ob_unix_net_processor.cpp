@@ -12,6 +12,7 @@
 
 #include "iocore/net/ob_unix_net_processor.h"
 #include "iocore/net/ob_net.h"
+#include "lib/cpu/ob_numa_node.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obproxy::event;
@@ -151,6 +152,10 @@ inline ObAction *ObUnixNetProcessor::accept_internal(ObContinuation &cont, int f
             } else if (OB_FAIL(net_accept->deep_copy(*na))) {
               PROXY_NET_LOG(ERROR, "fail to deep_copy ObNetAccept", K(i), K(ret));
             } else {
+              if (is_numa_local_alloc_enabled()) {
+                // accept threads are spread over numa nodes
+                net_accept->numa_node_id_ = (i - 1) % get_numa_node_count();
+              }
               ret_len = snprintf(thr_name, MAX_THREAD_NAME_LENGTH, "[ACCEPT %ld:%d]", i - 1,
                                  ops_ip_port_host_order(accept_ip));
               if (OB_UNLIKELY(ret_len <= 0) || OB_UNLIKELY(ret_len >= MAX_THREAD_NAME_LENGTH)) {
@@ -180,6 +185,9 @@ inline ObAction *ObUnixNetProcessor::accept_internal(ObContinuation &cont, int f
               ret = OB_SIZE_OVERFLOW;
               PROXY_NET_LOG(ERROR, "fail to snprintf thr_name", K(ret));
             } else {
+              if (is_numa_local_alloc_enabled()) {
+                na->numa_node_id_ = (accept_threads_ - 1) % get_numa_node_count();
+              }
               if (OB_FAIL(na->init_accept_loop(thr_name, opt.stacksize_))) {
                 PROXY_NET_LOG(ERROR, "fail to init_accept_loop", K(accept_ip));
                 delete na;
@@ -438,7 +438,7 @@ inline int ObUnixNetVConnection::close()
   int ret = OB_SUCCESS;
   PROXY_NET_LOG(DEBUG, "close connection", "vc: ", this);
 
-  if (using_ssl_) {
+  if (NULL != ssl_) {
     close_ssl();
   }
 
@@ -453,6 +453,9 @@ inline int ObUnixNetVConnection::close()
   next_inactivity_timeout_at_ = 0;
   reenable_read_time_at_ = 0;
   inactivity_timeout_in_ = 0;
+  if (inactivity_timer_.is_armed() && OB_LIKELY(NULL != thread_)) {
+    thread_->timer_wheel_.cancel(inactivity_timer_);
+  }
 
   if (NULL != active_timeout_action_) {
     if (OB_FAIL(active_timeout_action_->cancel(this))) {
@@ -794,6 +797,7 @@ ObUnixNetVConnection::ObUnixNetVConnection()
       active_timeout_action_(NULL),
       inactivity_timeout_in_(0),
       next_inactivity_timeout_at_(0),
+      inactivity_timer_(*this),
       reenable_read_time_at_(0),
       ep_(NULL),
       nh_(NULL),
@@ -832,6 +836,7 @@ inline void ObUnixNetVConnection::reenable(ObVIO *vio)
         ns.enabled_ = true;
         if (0 == next_inactivity_timeout_at_ && inactivity_timeout_in_ > 0) {
           next_inactivity_timeout_at_ = get_hrtime() + inactivity_timeout_in_;
+          schedule_inactivity_timer();
         }
 
         if (nh_->mutex_->thread_holding_ == &ethread) {
@@ -871,8 +876,8 @@ inline void ObUnixNetVConnection::reenable(ObVIO *vio)
               }
             }
 
-            if (NULL != nh_->trigger_event_ && NULL != nh_->trigger_event_->get_ethread().signal_hook_) {
-              nh_->trigger_event_->get_ethread().signal_hook_(nh_->trigger_event_->get_ethread());
+            if (NULL != nh_->trigger_event_) {
+              nh_->trigger_event_->get_ethread().wakeup();
             }
           /*
           } else {
@@ -914,6 +919,7 @@ void ObUnixNetVConnection::reenable_re(ObVIO *vio)
         get_net_state_by_vio(*vio).enabled_ = true;
         if (0 == next_inactivity_timeout_at_ && inactivity_timeout_in_ > 0) {
           next_inactivity_timeout_at_ = get_hrtime() + inactivity_timeout_in_;
+          schedule_inactivity_timer();
         }
 
         if (using_ssl_) {
@@ -1023,7 +1029,7 @@ void ObUnixNetVConnection::do_io_close(const int alerrno /* = -1 */)
   write_.vio_.nbytes_ = 0;
   write_.vio_.op_ = ObVIO::NONE;
   write_.vio_.cont_ = NULL;
-  if (using_ssl_) {
+  if (NULL != ssl_) {
     close_ssl();
   }
 
@@ -1047,6 +1053,11 @@ void ObUnixNetVConnection::do_io_close(const int alerrno /* = -1 */)
     if (OB_FAIL(close())) {
       PROXY_NET_LOG(WARN, "fail to close unix net vconnection", K(this), K(ret));
     }
+  } else if (thread_ == &ethread) {
+    // close it on next tick, out of the recursion
+    thread_->timer_wheel_.arm(inactivity_timer_, get_hrtime());
+  } else {
+    nh_->request_cop_sweep();
   }
 }
 
@@ -1396,6 +1407,8 @@ int ObUnixNetVConnection::accept_event(int event, ObEvent *e)
 
         if (inactivity_timeout_in_ > 0) {
           set_inactivity_timeout(inactivity_timeout_in_);
+        } else {
+          schedule_inactivity_timer();
         }
 
         if (active_timeout_in_ > 0) {
@@ -1451,6 +1464,8 @@ int ObUnixNetVConnection::main_event(int event, ObEvent *e)
         if (OB_FAIL(e->schedule_in(NET_RETRY_DELAY))) {
           PROXY_NET_LOG(WARN, "ObEvent fail to schedule_in", K(this), K(ret));
         }
+      } else if (EVENT_IMMEDIATE == event) {
+        thread_->timer_wheel_.arm(inactivity_timer_, get_hrtime() + NET_RETRY_DELAY);
       }
       event_ret = EVENT_CONT;
     } else if (e->cancelled_) {
@@ -1499,6 +1514,90 @@ int ObUnixNetVConnection::main_event(int event, ObEvent *e)
   return event_ret;
 }
 
+void ObInactivityTimer::handle_timeout(const ObHRTime now)
+{
+  if (OB_LIKELY(NULL != vc_.nh_) && OB_LIKELY(NULL != vc_.nh_->trigger_event_)) {
+    vc_.check_inactivity(now, *vc_.nh_->trigger_event_);
+  }
+}
+
+void ObUnixNetVConnection::schedule_inactivity_timer()
+{
+  if (OB_LIKELY(NULL != nh_) && OB_LIKELY(NULL != thread_)) {
+    if (thread_ != this_ethread()) {
+      // the timer wheel belongs to the thread of this vc
+      nh_->request_cop_sweep();
+    } else if (next_inactivity_timeout_at_ > 0) {
+      if (!inactivity_timer_.is_armed() || inactivity_timer_.get_timeout_at() > next_inactivity_timeout_at_) {
+        thread_->timer_wheel_.arm(inactivity_timer_, next_inactivity_timeout_at_);
+      }
+    } else if (!inactivity_timer_.is_armed()) {
+      // check later to set the default inactivity timeout
+      thread_->timer_wheel_.arm(inactivity_timer_, get_hrtime() + NET_INACTIVITY_CHECK_DELAY);
+    }
+  }
+}
+
+void ObUnixNetVConnection::check_inactivity(const ObHRTime now, ObEvent &e)
+{
+  int ret = OB_SUCCESS;
+  ObHotUpgraderInfo &info = get_global_hot_upgrade_info();
+  ObEThread *ethread = thread_;
+  ObNetHandler &nh = *nh_;
+
+  // If we cannot get the lock, try again later
+  MUTEX_TRY_LOCK(lock, mutex_, ethread);
+  if (!lock.is_locked()) {
+    NET_INCREMENT_DYN_STAT(INACTIVITY_COP_LOCK_ACQUIRE_FAILURE);
+    ethread->timer_wheel_.arm(inactivity_timer_, now + NET_RETRY_DELAY);
+  } else if (closed_) {
+    if (OB_FAIL(close())) {
+      PROXY_NET_LOG(WARN, "fail to close unix net vconnection", K(this), K(ret));
+    }
+  } else {
+    if (get_is_force_timeout()
+        || (info.graceful_exit_end_time_ > 0 && info.graceful_exit_end_time_ < now)) {
+      next_inactivity_timeout_at_ = now; // force the connection timeout
+    }
+
+    const int64_t default_inactivity_timeout = ethread->get_inactivity_cop().get_default_timeout();
+    if (0 == next_inactivity_timeout_at_) {
+      // set a default inactivity timeout if one is not set
+      if (default_inactivity_timeout > 0) {
+        PROXY_NET_LOG(DEBUG, "inactivity timeout not set, setting a default",
+                      K(this), K_(source_type), K(default_inactivity_timeout));
+        set_inactivity_timeout(HRTIME_SECONDS(default_inactivity_timeout));
+        NET_INCREMENT_DYN_STAT(DEFAULT_INACTIVITY_TIMEOUT);
+      }
+    } else if (next_inactivity_timeout_at_ > now) {
+      // pushed back by net activity since the timer was armed
+      ethread->timer_wheel_.arm(inactivity_timer_, next_inactivity_timeout_at_);
+    } else {
+      if (nh.keep_alive_list_.in(this)) {
+        // only stat if the connection is in keep-alive, there can be other inactivity timeouts
+        const ObHRTime diff = (now - (next_inactivity_timeout_at_ - inactivity_timeout_in_)) / HRTIME_SECOND;
+        NET_SUM_DYN_STAT(KEEP_ALIVE_LRU_TIMEOUT_TOTAL, diff);
+        NET_INCREMENT_DYN_STAT(KEEP_ALIVE_LRU_TIMEOUT_COUNT);
+      }
+      PROXY_NET_LOG(DEBUG, "inactivity timeout state", K(this), K_(source_type), K(now),
+                    "next_inactivity_timeout_at", hrtime_to_sec(next_inactivity_timeout_at_),
+                    "inactivity_timeout_in", hrtime_to_sec(inactivity_timeout_in_));
+      // check again if the timeout is not handled, this vc may be freed after handle_event
+      ethread->timer_wheel_.arm(inactivity_timer_, now + NET_INACTIVITY_CHECK_DELAY);
+      handle_event(EVENT_IMMEDIATE, &e);
+    }
+  }
+}
+
+void ObUnixNetVConnection::set_is_force_timeout(const bool force_timeout)
+{
+  ObNetVConnection::set_is_force_timeout(force_timeout);
+  if (force_timeout && OB_LIKELY(NULL != nh_)) {
+    // usually called by other threads
+    nh_->request_cop_sweep();
+  }
+}
+
 int ObUnixNetVConnection::connect_up(ObEThread &ethread, int fd)
 {
   int ret = OB_SUCCESS;
@@ -1539,6 +1638,7 @@ int ObUnixNetVConnection::connect_up(ObEThread &ethread, int fd)
       SET_HANDLER(&ObUnixNetVConnection::main_event);
       nh_ = &(thread_->get_net_handler());
       nh_->open_list_.enqueue(this);
+      schedule_inactivity_timer();
       action_.continuation_->handle_event(NET_EVENT_OPEN, this);
     }
   }
@@ -1625,6 +1725,9 @@ int ObUnixNetVConnection::ssl_init(const SSLType ssl_type)
     } else {
       using_ssl_ = true;
       ssl_type_ = ssl_type;
+      if (SSL_CLIENT == ssl_type_) {
+        g_ssl_processor.set_client_session(ssl_, get_remote_addr());
+      }
     }
   }
 
@@ -1697,6 +1800,7 @@ int ObUnixNetVConnection::ssl_server_handshake(ObEThread &thread)
     PROXY_NET_LOG(WARN, "ssl accepte failed", K(ret), K(tmp_code));
     read_signal_done(VC_EVENT_EOS);
   } else if (ssl_connected_) {
+    ssl_handshake_done();
     reenable(&read_.vio_);
   } else if (SSL_ERROR_WANT_READ == tmp_code || SSL_ERROR_WANT_WRITE == tmp_code) {
     read_.triggered_ = false;
@@ -1726,6 +1830,7 @@ int ObUnixNetVConnection::ssl_client_handshake(ObEThread &thread)
     PROXY_NET_LOG(WARN, "ssl connect failed", K(ret), K(tmp_code));
     write_signal_done(VC_EVENT_EOS);
   } else if (ssl_connected_) {
+    ssl_handshake_done();
     reenable(&write_.vio_);
   } else if (SSL_ERROR_WANT_READ == tmp_code || SSL_ERROR_WANT_WRITE == tmp_code) {
     read_.triggered_ = false;
@@ -1737,6 +1842,15 @@ int ObUnixNetVConnection::ssl_client_handshake(ObEThread &thread)
   return ret;
 }
 
+void ObUnixNetVConnection::ssl_handshake_done()
+{
+  if (ObSSLProcessor::is_ktls_enabled(ssl_)) {
+    // records are encrypted by kernel from now on, ssl_ is only kept for shutdown
+    using_ssl_ = false;
+    PROXY_NET_LOG(DEBUG, "ssl connection uses ktls", K_(ssl_type), "vc", this);
+  }
+}
+
 void ObUnixNetVConnection::handle_ssl_err_code(const int err_code)
 {
   switch(err_code) {
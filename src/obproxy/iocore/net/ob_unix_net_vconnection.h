@@ -17,6 +17,7 @@
 #include "iocore/net/ob_net_vconnection.h"
 #include "iocore/net/ob_net_state.h"
 #include "iocore/net/ob_connection.h"
+#include "iocore/eventsystem/ob_timer_wheel.h"
 
 namespace oceanbase
 {
@@ -27,6 +28,21 @@ namespace net
 
 class ObNetHandler;
 struct ObEventIO;
+class ObUnixNetVConnection;
+
+// Fires the inactivity check of one connection from the timer wheel of its thread
+class ObInactivityTimer : public event::ObTimerWheelEntry
+{
+public:
+  explicit ObInactivityTimer(ObUnixNetVConnection &vc) : vc_(vc) {}
+  virtual ~ObInactivityTimer() {}
+
+  virtual void handle_timeout(const ObHRTime now);
+
+private:
+  ObUnixNetVConnection &vc_;
+  DISALLOW_COPY_AND_ASSIGN(ObInactivityTimer);
+};
 
 class ObUnixNetVConnection : public ObNetVConnection
 {
@@ -74,6 +90,8 @@ public:
   virtual void set_inactivity_timeout(const ObHRTime timeout_in);
   virtual void cancel_inactivity_timeout();
 
+  virtual void set_is_force_timeout(const bool force_timeout);
+
   virtual void add_to_keep_alive_lru();
   virtual void remove_from_keep_alive_lru();
 
@@ -110,6 +128,12 @@ public:
   void write_to_net(event::ObEThread &thread);
   void read_from_net(event::ObEThread &thread);
 
+  // Make sure the inactivity timer fires no later than next_inactivity_timeout_at_,
+  // a timeout pushed back by net activity is found when the timer fires.
+  void schedule_inactivity_timer();
+  // time out the connection if it is inactive, called when its timer fires
+  void check_inactivity(const ObHRTime now, event::ObEvent &e);
+
 private:
   int start_event(int event, event::ObEvent *e);
 
@@ -171,6 +195,7 @@ public:
 
   ObHRTime inactivity_timeout_in_;
   ObHRTime next_inactivity_timeout_at_;
+  ObInactivityTimer inactivity_timer_;
 
   ObHRTime reenable_read_time_at_;
 
@@ -224,6 +249,7 @@ private:
   int ssl_start_handshake(event::ObEThread &thread);
   int ssl_server_handshake(event::ObEThread &thread);
   int ssl_client_handshake(event::ObEThread &thread);
+  void ssl_handshake_done();
   void handle_ssl_err_code(const int err_code);
   void handle_ssl_want_read();
   void handle_ssl_want_write();
@@ -269,6 +295,7 @@ inline void ObUnixNetVConnection::set_inactivity_timeout(const ObHRTime timeout)
   PROXY_NET_LOG(DEBUG, "set inactive timeout", K(timeout), K(this));
   inactivity_timeout_in_ = timeout;
   next_inactivity_timeout_at_ = event::get_hrtime() + timeout;
+  schedule_inactivity_timer();
 }
 
 inline void ObUnixNetVConnection::cancel_inactivity_timeout()
@@ -276,6 +303,7 @@ inline void ObUnixNetVConnection::cancel_inactivity_timeout()
   PROXY_NET_LOG(DEBUG, "cancel inactive timeout", K(this));
   inactivity_timeout_in_ = 0;
   next_inactivity_timeout_at_ = 0;
+  schedule_inactivity_timer();
 }
 
 inline int ObUnixNetVConnection::set_local_addr()
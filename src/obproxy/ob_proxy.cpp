@@ -36,6 +36,8 @@
 #include "obutils/ob_task_flow_controller.h"
 #include "obutils/ob_metadb_create_cont.h"
 #include "obutils/ob_tenant_stat_manager.h"
+#include "obutils/ob_sql_digest.h"
+#include "obutils/ob_monitor_binlog.h"
 #include "obutils/ob_proxy_config_processor.h"
 #include "dbconfig/ob_proxy_db_config_processor.h"
 #include "dbconfig/ob_proxy_inotify_processor.h"
@@ -72,6 +74,7 @@
 #include "cmd/ob_show_global_session_handler.h"
 #include "cmd/ob_kill_global_session_handler.h"
 #include "obutils/ob_session_pool_processor.h"
+#include "obutils/ob_server_prober.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::share;
@@ -315,12 +318,26 @@ int ObProxy::start()
       LOG_WARN("fail to start inotify watch sharding config", K(ret));
     } else if (OB_FAIL(config_->is_pool_mode && get_global_session_pool_processor().start_session_pool_task())) {
       LOG_WARN("fail to start_session_pool_task", K(ret));
+    } else if (OB_FAIL(get_global_server_prober().start_if_enabled())) {
+      LOG_WARN("fail to start server prober", K(ret));
     } else {
       // if fail to init prometheus, do not stop the startup of obproxy
       if (g_ob_prometheus_processor.start_prometheus_task()) {
         LOG_WARN("fail to start prometheus task");
       }
 
+      // sql digest is only for diagnosis, do not stop the startup of obproxy either
+      if (OB_SUCCESS != get_global_sql_digest_table().init(config_->sql_digest_item_limit)) {
+        LOG_WARN("fail to init sql digest table");
+      }
+
+      // text monitor logs are still printed when monitor binlog fails to init
+      if (config_->enable_monitor_binlog
+          && OB_SUCCESS != get_global_monitor_binlog().init(get_global_layout().get_log_dir(),
+                                                            config_->monitor_binlog_buffer_size)) {
+        LOG_WARN("fail to init monitor binlog");
+      }
+
       mysql_config_params_ = NULL;
       ob_print_mod_memory_usage();
       ObMemoryResourceTracker::dump();
@@ -868,6 +885,8 @@ int ObProxy::do_reload_config(obutils::ObProxyConfig &config)
       LOG_WARN("fail to update table processor check interval", K(ret));
     } else if (OB_FAIL(ObCacheCleaner::update_clean_interval())) {
       LOG_WARN("fail to update clean interval", K(ret));
+    } else if (OB_FAIL(get_global_server_prober().start_if_enabled())) {
+      LOG_WARN("fail to start server prober", K(ret));
     } else {/*do nothing*/}
   }
 
@@ -28,6 +28,7 @@
 #include "obutils/ob_async_common_task.h"
 
 #include "cmd/ob_show_sqlaudit_handler.h"
+#include "lib/allocator/ob_hugepage_arena.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::lib;
@@ -886,7 +887,8 @@ int ObProxyMain::do_monitor_mem()
 {
   int ret = OB_SUCCESS;
   ObProxyMain *proxy_main = ObProxyMain::get_instance();
-  int64_t mem_hold = get_memory_hold();
+  // hugepage arena is mapped directly, not counted by ob_malloc
+  int64_t mem_hold = get_memory_hold() + ObHugePageArena::get_instance().get_hold();
   uint64_t cur_pos = proxy_main->pos_ % HISTORY_MEMORY_RECORD_COUNT;
   LOG_DEBUG("MemoryMonitor", "current memory hold size", mem_hold, K(cur_pos));
   proxy_main->history_mem_size_[cur_pos] = mem_hold;
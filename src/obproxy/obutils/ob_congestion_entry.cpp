@@ -11,6 +11,7 @@
  */
 
 #define USING_LOG_PREFIX PROXY
+#include <math.h>
 #include "obutils/ob_congestion_entry.h"
 
 using namespace oceanbase::common;
@@ -84,12 +85,85 @@ int64_t ObFailHistory::regist_event(const int64_t t, const int64_t n)
   return events_;
 }
 
+void ObConcurrencyLimiter::reset()
+{
+  limit_ = INITIAL_LIMIT;
+  inflight_ = 0;
+  rejected_count_ = 0;
+  estimated_limit_ = static_cast<double>(INITIAL_LIMIT);
+  no_load_rtt_us_ = 0;
+  round_rtt_sum_us_ = 0;
+  round_samples_ = 0;
+  round_max_inflight_ = 0;
+}
+
+bool ObConcurrencyLimiter::try_acquire(const int64_t max_inflight)
+{
+  bool bret = false;
+  bool is_full = false;
+  while (!bret && !is_full) {
+    const int64_t inflight = ATOMIC_LOAD(&inflight_);
+    if (inflight >= max_inflight) {
+      is_full = true;
+      (void)ATOMIC_AAF(&rejected_count_, 1);
+    } else {
+      bret = ATOMIC_BCAS(&inflight_, inflight, inflight + 1);
+    }
+  }
+  return bret;
+}
+
+void ObConcurrencyLimiter::release(const int64_t rtt_us, const int64_t min_limit, const int64_t max_limit)
+{
+  const int64_t inflight = ATOMIC_FAA(&inflight_, -1);
+  if (rtt_us > 0 && OB_SUCCESS == lock_.trylock()) {
+    update_limit(rtt_us, inflight, min_limit, max_limit);
+    (void)lock_.unlock();
+  }
+}
+
+void ObConcurrencyLimiter::update_limit(const int64_t rtt_us, const int64_t inflight,
+                                        const int64_t min_limit, const int64_t max_limit)
+{
+  static const double RTT_TOLERANCE = 1.5;
+  // the no-load latency slowly follows the round latency, in case the server
+  // becomes slower for good
+  static const double NO_LOAD_RTT_DRIFT = 1000.0;
+
+  round_rtt_sum_us_ += rtt_us;
+  ++round_samples_;
+  round_max_inflight_ = std::max(round_max_inflight_, inflight);
+  if (round_samples_ >= limit_) {
+    const double round_rtt = static_cast<double>(round_rtt_sum_us_) / static_cast<double>(round_samples_);
+    if (0 == no_load_rtt_us_ || round_rtt < no_load_rtt_us_) {
+      no_load_rtt_us_ = round_rtt;
+    } else {
+      no_load_rtt_us_ += (round_rtt - no_load_rtt_us_) / NO_LOAD_RTT_DRIFT;
+    }
+
+    // nothing to learn when far below the limit
+    if (2 * round_max_inflight_ >= limit_) {
+      double gradient = RTT_TOLERANCE * no_load_rtt_us_ / round_rtt;
+      gradient = std::max(0.5, std::min(1.0, gradient));
+      estimated_limit_ = estimated_limit_ * gradient + sqrt(estimated_limit_);
+    }
+    estimated_limit_ = std::max(static_cast<double>(min_limit),
+                                std::min(static_cast<double>(max_limit), estimated_limit_));
+    ATOMIC_STORE(&limit_, static_cast<int64_t>(estimated_limit_));
+
+    round_rtt_sum_us_ = 0;
+    round_samples_ = 0;
+    round_max_inflight_ = 0;
+  }
+}
+
 ObCongestionEntry::ObCongestionEntry(const ObIpEndpoint &ip)
     : server_state_(ACTIVE), entry_state_(ENTRY_AVAIL), control_config_(NULL),zone_state_(NULL),
       last_dead_congested_(0), dead_congested_(0),
       last_alive_congested_(0),alive_congested_(0),
       stat_conn_failures_(0), stat_alive_failures_(0),
-      last_revalidate_time_us_(0), cr_version_(-1)
+      last_revalidate_time_us_(0), cr_version_(-1),
+      probe_fail_count_(0), probe_dead_congested_(0)
 {
   memset(&server_ip_, 0, sizeof(server_ip_));
   ops_ip_copy(server_ip_, ip);
@@ -266,7 +340,9 @@ int64_t ObCongestionEntry::to_string(char *buf, const int64_t buf_len) const
     databuff_printf(buf, buf_len, pos, "last_dead_congested=%s,", str_time);
   }
 
-  J_KV(K_(stat_alive_failures), K_(stat_conn_failures), K_(cr_version));
+  J_KV(K_(stat_alive_failures), K_(stat_conn_failures), K_(cr_version),
+       "concurrency_limit", concurrency_limiter_.limit_,
+       "inflight", concurrency_limiter_.inflight_);
   J_COMMA();
 
   databuff_printf(buf, buf_len, pos, "conn_last_fail_time=%ld, conn_failure_events=%ld, ",
@@ -445,6 +521,24 @@ void ObCongestionEntry::set_dead_congested_free()
   }
 }
 
+void ObCongestionEntry::set_probe_failed(const int64_t failure_threshold)
+{
+  if (ATOMIC_AAF(&probe_fail_count_, 1) >= failure_threshold && !is_dead_congested()) {
+    ATOMIC_STORE(&probe_dead_congested_, 1);
+    LOG_INFO("server probe failed", K_(probe_fail_count), K(failure_threshold));
+    set_dead_congested();
+  }
+}
+
+void ObCongestionEntry::set_probe_succeed()
+{
+  ATOMIC_STORE(&probe_fail_count_, 0);
+  // the server state is refreshed from the server table, keep its verdict
+  if (ATOMIC_BCAS(&probe_dead_congested_, 1, 0) && ACTIVE == server_state_) {
+    set_dead_congested_free();
+  }
+}
+
 
 } // end of namespace obutils
 } // end of namespace obproxy
@@ -13,6 +13,7 @@
 #ifndef OBPROXY_CONGESTION_ENTRY_H
 #define OBPROXY_CONGESTION_ENTRY_H
 
+#include "lib/lock/ob_spin_lock.h"
 #include "iocore/eventsystem/ob_event_system.h"
 #include "iocore/net/ob_inet.h"
 
@@ -223,6 +224,44 @@ struct ObFailHistory
   int64_t events_;
 };
 
+// Adaptive limit of the in-flight requests to one server, learned from the
+// server process time of its requests. The limit is updated once per round
+// of about limit responses: it grows by sqrt(limit) while the round latency
+// stays within the tolerance of the no-load latency, and is cut by their
+// ratio once the server queues requests, so a slow but alive server gets
+// less traffic long before it fails connections.
+struct ObConcurrencyLimiter
+{
+  static const int64_t INITIAL_LIMIT = 20;
+  // strong reads can not be sent to other replicas, they wait in the
+  // server queue instead, up to this many times the limit
+  static const int64_t STRONG_READ_OVERFLOW_FACTOR = 2;
+
+  ObConcurrencyLimiter() { reset(); }
+  void reset();
+
+  bool try_acquire(const int64_t max_inflight);
+  void acquire() { (void)ATOMIC_AAF(&inflight_, 1); }
+  // @rtt_us is the server process time of the request, 0 if not available
+  void release(const int64_t rtt_us, const int64_t min_limit, const int64_t max_limit);
+
+  volatile int64_t limit_;
+  volatile int64_t inflight_;
+  volatile int64_t rejected_count_;
+
+  // protected by lock_, samples are dropped when it is contended
+  common::ObSpinLock lock_;
+  double estimated_limit_;
+  double no_load_rtt_us_;
+  int64_t round_rtt_sum_us_;
+  int64_t round_samples_;
+  int64_t round_max_inflight_;
+
+private:
+  void update_limit(const int64_t rtt_us, const int64_t inflight,
+                    const int64_t min_limit, const int64_t max_limit);
+};
+
 struct ObCongestionEntry : public ObCongestionRefCnt
 {
   enum ObServerState
@@ -285,6 +324,9 @@ struct ObCongestionEntry : public ObCongestionRefCnt
   void set_dead_congested_free();
   void set_dead_failed_at(const ObHRTime t);
   void set_alive_failed_at(const ObHRTime t);
+  // fed by the server prober, dead congested set by probes is only freed by probes
+  void set_probe_failed(const int64_t failure_threshold);
+  void set_probe_succeed();
 
   // Connection controls
   bool alive_need_retry(const ObHRTime t);
@@ -335,6 +377,11 @@ struct ObCongestionEntry : public ObCongestionRefCnt
   int64_t last_revalidate_time_us_; // unit us
 
   int64_t cr_version_;
+
+  ObConcurrencyLimiter concurrency_limiter_;
+
+  volatile int64_t probe_fail_count_;
+  volatile int64_t probe_dead_congested_; // 0 | 1
 };
 
 inline bool ObCongestionEntry::alive_need_retry(const ObHRTime t)
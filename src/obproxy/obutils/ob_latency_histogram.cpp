@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "obutils/ob_latency_histogram.h"
+#include "lib/allocator/ob_malloc.h"
+#include "lib/time/ob_time_utility.h"
+#include "iocore/eventsystem/ob_ethread.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obproxy::event;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+
+const char *get_latency_type_name(const ObLatencyType type)
+{
+  const char *name = "UNKNOWN";
+  switch (type) {
+    case LATENCY_TOTAL:
+      name = "total";
+      break;
+    case LATENCY_SERVER:
+      name = "server";
+      break;
+    case LATENCY_ROUTE:
+      name = "route";
+      break;
+    case LATENCY_CONNECT:
+      name = "connect";
+      break;
+    default:
+      break;
+  }
+  return name;
+}
+
+int64_t ObLatencyHistogram::get_bucket_upper_value(const int64_t index)
+{
+  int64_t value = index;
+  if (index >= SUB_BUCKET_COUNT) {
+    const int64_t shift = index / SUB_BUCKET_COUNT - 1;
+    value = ((index - shift * SUB_BUCKET_COUNT + 1) << shift) - 1;
+  }
+  return value;
+}
+
+void ObLatencyHistogram::merge(const ObLatencyHistogram &other)
+{
+  // other may be written at the same time, a few lost or extra counts are fine
+  for (int64_t i = 0; i < BUCKET_COUNT; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  if (other.max_ > max_) {
+    max_ = other.max_;
+  }
+}
+
+void ObLatencyHistogram::subtract(const ObLatencyHistogram &base)
+{
+  // base is merged earlier, counts in flight then may make a bucket negative
+  int64_t top_index = -1;
+  for (int64_t i = 0; i < BUCKET_COUNT; ++i) {
+    buckets_[i] = std::max(buckets_[i] - base.buckets_[i], 0L);
+    if (buckets_[i] > 0) {
+      top_index = i;
+    }
+  }
+  count_ = std::max(count_ - base.count_, 0L);
+  sum_ = std::max(sum_ - base.sum_, 0L);
+  max_ = top_index < 0 ? 0 : std::min(get_bucket_upper_value(top_index), max_);
+}
+
+int64_t ObLatencyHistogram::get_percentile(const double percentile) const
+{
+  int64_t value = 0;
+  if (count_ > 0) {
+    int64_t target = static_cast<int64_t>(percentile / 100 * static_cast<double>(count_) + 0.5);
+    target = target < 1 ? 1 : target;
+    int64_t total = 0;
+    value = max_;
+    for (int64_t i = 0; i < BUCKET_COUNT; ++i) {
+      total += buckets_[i];
+      if (total >= target) {
+        const int64_t upper_value = get_bucket_upper_value(i);
+        value = upper_value < max_ ? upper_value : max_;
+        break;
+      }
+    }
+  }
+  return value;
+}
+
+ObLatencyHistogramItem::ObLatencyHistogramItem(const uint64_t hash, const ObString &cluster_name,
+                                               const ObString &tenant_name,
+                                               const ObProxyBasicStmtType stmt_type)
+  : hash_(hash), stmt_type_(stmt_type), cluster_name_len_(0), tenant_name_len_(0),
+    window_lock_(), window_start_time_(0)
+{
+  MEMSET(exported_values_, 0, sizeof(exported_values_));
+  MEMSET(stripes_, 0, sizeof(stripes_));
+  cluster_name_len_ = static_cast<int32_t>(std::min(static_cast<int64_t>(cluster_name.length()),
+                                                    OB_PROXY_MAX_CLUSTER_NAME_LENGTH));
+  tenant_name_len_ = static_cast<int32_t>(std::min(static_cast<int64_t>(tenant_name.length()),
+                                                   OB_MAX_TENANT_NAME_LENGTH));
+  MEMCPY(cluster_name_, cluster_name.ptr(), cluster_name_len_);
+  MEMCPY(tenant_name_, tenant_name.ptr(), tenant_name_len_);
+}
+
+void ObLatencyHistogramItem::destroy()
+{
+  for (int64_t i = 0; i < STRIPE_COUNT; ++i) {
+    if (NULL != stripes_[i]) {
+      stripes_[i]->~ObLatencyHistogramSet();
+      ob_free(stripes_[i]);
+      stripes_[i] = NULL;
+    }
+  }
+}
+
+ObLatencyHistogramSet *ObLatencyHistogramItem::get_or_create_stripe(const int64_t thread_id)
+{
+  ObLatencyHistogramSet *set = NULL;
+  if (OB_LIKELY(thread_id >= 0)) {
+    ObLatencyHistogramSet **slot = &stripes_[thread_id % STRIPE_COUNT];
+    if (OB_ISNULL(set = ATOMIC_LOAD(slot))) {
+      void *buf = ob_malloc(sizeof(ObLatencyHistogramSet), ObModIds::OB_PROXY_STAT);
+      if (OB_ISNULL(buf)) {
+        LOG_WARN("fail to alloc mem for latency histogram set", K(thread_id));
+      } else {
+        set = new (buf) ObLatencyHistogramSet();
+        if (!ATOMIC_BCAS(slot, NULL, set)) {
+          // other ethread of the same stripe created it
+          set->~ObLatencyHistogramSet();
+          ob_free(set);
+          set = ATOMIC_LOAD(slot);
+        }
+      }
+    }
+  }
+  return set;
+}
+
+void ObLatencyHistogramItem::merge(ObLatencyHistogramSet &set) const
+{
+  for (int64_t i = 0; i < STRIPE_COUNT; ++i) {
+    const ObLatencyHistogramSet *stripe = ATOMIC_LOAD(&stripes_[i]);
+    if (NULL != stripe) {
+      for (int64_t j = 0; j < LATENCY_MAX_TYPE; ++j) {
+        set.histograms_[j].merge(stripe->histograms_[j]);
+      }
+    }
+  }
+}
+
+void ObLatencyHistogramItem::merge_window(ObLatencyHistogramSet &set, const int64_t window_us)
+{
+  const int64_t now = ObTimeUtility::current_time();
+  ObSpinLockGuard guard(window_lock_);
+  for (int64_t i = 0; i < LATENCY_MAX_TYPE; ++i) {
+    set.histograms_[i].reset();
+  }
+  merge(set);
+  if (now - window_start_time_ >= window_us) {
+    window_bases_[0] = window_bases_[1];
+    window_bases_[1] = set;
+    window_start_time_ = now;
+  }
+  for (int64_t i = 0; i < LATENCY_MAX_TYPE; ++i) {
+    set.histograms_[i].subtract(window_bases_[0].histograms_[i]);
+  }
+}
+
+ObLatencyHistogramManager &get_global_latency_histogram_mgr()
+{
+  static ObLatencyHistogramManager g_latency_histogram_mgr;
+  return g_latency_histogram_mgr;
+}
+
+int ObLatencyHistogramManager::get_or_create_item(const ObString &cluster_name,
+                                                  const ObString &tenant_name,
+                                                  const ObProxyBasicStmtType stmt_type,
+                                                  ObLatencyHistogramItem *&item)
+{
+  int ret = OB_SUCCESS;
+  const uint64_t hash = cluster_name.hash(tenant_name.hash(static_cast<uint64_t>(stmt_type)));
+  ObLatencyHistogramItem *new_item = NULL;
+  item = NULL;
+  for (int64_t i = 0; OB_SUCC(ret) && NULL == item && i < TABLE_SIZE; ++i) {
+    ObLatencyHistogramItem **slot = &items_[(hash + i) % TABLE_SIZE];
+    ObLatencyHistogramItem *cur = ATOMIC_LOAD(slot);
+    if (NULL == cur) {
+      if (NULL == new_item) {
+        void *buf = NULL;
+        if (ATOMIC_AAF(&item_count_, 1) > MAX_ITEM_COUNT) {
+          (void)ATOMIC_AAF(&item_count_, -1);
+          (void)ATOMIC_AAF(&discard_count_, 1);
+          ret = OB_EXCEED_MEM_LIMIT;
+        } else if (OB_ISNULL(buf = ob_malloc(sizeof(ObLatencyHistogramItem), ObModIds::OB_PROXY_STAT))) {
+          (void)ATOMIC_AAF(&item_count_, -1);
+          ret = OB_ALLOCATE_MEMORY_FAILED;
+          LOG_WARN("fail to alloc mem for latency histogram item", K(ret));
+        } else {
+          new_item = new (buf) ObLatencyHistogramItem(hash, cluster_name, tenant_name, stmt_type);
+        }
+      }
+      if (OB_SUCC(ret)) {
+        if (ATOMIC_BCAS(slot, NULL, new_item)) {
+          item = new_item;
+          new_item = NULL;
+          LOG_INFO("succ to create latency histogram item", KPC(item));
+        } else if (OB_ISNULL(cur = ATOMIC_LOAD(slot))) {
+          ret = OB_ERR_UNEXPECTED;
+          LOG_WARN("slot is still empty after cas fail, it should not happen", K(i), K(ret));
+        } else if (cur->is_equal(hash, cluster_name, tenant_name, stmt_type)) {
+          // other one created the same key
+          item = cur;
+        }
+      }
+    } else if (cur->is_equal(hash, cluster_name, tenant_name, stmt_type)) {
+      item = cur;
+    }
+  }
+
+  if (NULL != new_item) {
+    new_item->~ObLatencyHistogramItem();
+    ob_free(new_item);
+    new_item = NULL;
+    (void)ATOMIC_AAF(&item_count_, -1);
+  }
+  if (OB_SUCC(ret) && OB_ISNULL(item)) {
+    ret = OB_EXCEED_MEM_LIMIT;
+    (void)ATOMIC_AAF(&discard_count_, 1);
+  }
+  return ret;
+}
+
+int ObLatencyHistogramManager::record(const ObString &cluster_name, const ObString &tenant_name,
+                                      const ObProxyBasicStmtType stmt_type,
+                                      const int64_t latencies[LATENCY_MAX_TYPE])
+{
+  int ret = OB_SUCCESS;
+  ObEThread *ethread = this_ethread();
+  ObLatencyHistogramItem *item = NULL;
+  ObLatencyHistogramSet *set = NULL;
+  if (OB_ISNULL(ethread) || OB_UNLIKELY(REGULAR != ethread->tt_)) {
+    // only regular ethreads record
+  } else if (OB_FAIL(get_or_create_item(cluster_name, tenant_name, stmt_type, item))) {
+    if (OB_EXCEED_MEM_LIMIT == ret) {
+      ret = OB_SUCCESS;
+    } else {
+      LOG_WARN("fail to get or create latency histogram item", K(cluster_name), K(tenant_name), K(ret));
+    }
+  } else if (OB_ISNULL(set = item->get_or_create_stripe(ethread->id_))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to get latency histogram set", "thread_id", ethread->id_, K(ret));
+  } else {
+    for (int64_t i = 0; i < LATENCY_MAX_TYPE; ++i) {
+      set->histograms_[i].record(latencies[i]);
+    }
+  }
+  return ret;
+}
+
+void ObLatencyHistogramManager::get_percentiles(const ObLatencyHistogram &histogram,
+                                                ObLatencyPercentiles &percentiles)
+{
+  percentiles.count_ = histogram.get_count();
+  percentiles.avg_ = histogram.get_count() > 0 ? histogram.get_sum() / histogram.get_count() : 0;
+  percentiles.p50_ = histogram.get_percentile(50.0);
+  percentiles.p90_ = histogram.get_percentile(90.0);
+  percentiles.p99_ = histogram.get_percentile(99.0);
+  percentiles.p999_ = histogram.get_percentile(99.9);
+  percentiles.max_ = histogram.get_max();
+}
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
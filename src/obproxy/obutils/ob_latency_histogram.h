@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_LATENCY_HISTOGRAM_H
+#define OBPROXY_LATENCY_HISTOGRAM_H
+
+#include "lib/string/ob_string.h"
+#include "lib/utility/ob_print_utils.h"
+#include "lib/lock/ob_spin_lock.h"
+#include "iocore/eventsystem/ob_event_processor.h"
+#include "utils/ob_proxy_lib.h"
+#include "opsql/parser/ob_proxy_parse_result.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+
+enum ObLatencyType
+{
+  LATENCY_TOTAL = 0,    // client observed, from request read to response written
+  LATENCY_SERVER,       // observer process time
+  LATENCY_ROUTE,        // cluster resource, partition location and congestion lookup
+  LATENCY_CONNECT,      // server connect time
+  LATENCY_MAX_TYPE
+};
+
+const char *get_latency_type_name(const ObLatencyType type);
+
+/*
+ * Log-linear histogram in us, like HdrHistogram: each power of two range is
+ * split into SUB_BUCKET_COUNT linear buckets, so the relative error of any
+ * percentile is no more than 1/SUB_BUCKET_COUNT, with a few hundred buckets
+ * from 1us to MAX_VALUE.
+ *
+ * Writers record with atomic adds, readers merge without any lock and may see
+ * a few counts in flight.
+ */
+class ObLatencyHistogram
+{
+public:
+  static const int64_t SUB_BUCKET_BITS = 3;
+  static const int64_t SUB_BUCKET_COUNT = 1L << SUB_BUCKET_BITS;
+  static const int64_t MAX_VALUE_BITS = 32; // about 71 minutes
+  static const int64_t MAX_VALUE = (1L << MAX_VALUE_BITS) - 1;
+  static const int64_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  ObLatencyHistogram() { reset(); }
+  ~ObLatencyHistogram() {}
+  void reset() { MEMSET(this, 0, sizeof(ObLatencyHistogram)); }
+
+  void record(const int64_t value)
+  {
+    const int64_t real_value = value < 0 ? 0 : (value > MAX_VALUE ? MAX_VALUE : value);
+    (void)ATOMIC_AAF(&buckets_[get_bucket_index(real_value)], 1);
+    (void)ATOMIC_AAF(&count_, 1);
+    (void)ATOMIC_AAF(&sum_, real_value);
+    int64_t max = ATOMIC_LOAD(&max_);
+    while (real_value > max && !ATOMIC_BCAS(&max_, max, real_value)) {
+      max = ATOMIC_LOAD(&max_);
+    }
+  }
+  void merge(const ObLatencyHistogram &other);
+  // leave what is recorded after @base, which is an earlier copy of this one,
+  // max becomes the upper value of the highest bucket left
+  void subtract(const ObLatencyHistogram &base);
+
+  // the highest value in the bucket where @percentile falls, no more than max
+  int64_t get_percentile(const double percentile) const;
+  int64_t get_count() const { return count_; }
+  int64_t get_sum() const { return sum_; }
+  int64_t get_max() const { return max_; }
+
+  static int64_t get_bucket_index(const int64_t value)
+  {
+    int64_t shift = 0;
+    if (value >= SUB_BUCKET_COUNT) {
+      shift = (63 - __builtin_clzll(static_cast<uint64_t>(value))) - SUB_BUCKET_BITS;
+    }
+    return shift * SUB_BUCKET_COUNT + (value >> shift);
+  }
+  static int64_t get_bucket_upper_value(const int64_t index);
+
+  TO_STRING_KV(K_(count), K_(sum), K_(max));
+
+private:
+  int64_t count_;
+  int64_t sum_;
+  int64_t max_;
+  int64_t buckets_[BUCKET_COUNT];
+};
+
+// all kinds of latency of one key
+struct ObLatencyHistogramSet
+{
+  ObLatencyHistogram histograms_[LATENCY_MAX_TYPE];
+};
+
+struct ObLatencyPercentiles
+{
+  ObLatencyPercentiles() { MEMSET(this, 0, sizeof(ObLatencyPercentiles)); }
+
+  int64_t count_;
+  int64_t avg_;
+  int64_t p50_;
+  int64_t p90_;
+  int64_t p99_;
+  int64_t p999_;
+  int64_t max_;
+  TO_STRING_KV(K_(count), K_(avg), K_(p50), K_(p90), K_(p99), K_(p999), K_(max));
+};
+
+class ObLatencyHistogramItem
+{
+public:
+  ObLatencyHistogramItem(const uint64_t hash, const common::ObString &cluster_name,
+                         const common::ObString &tenant_name, const ObProxyBasicStmtType stmt_type);
+  ~ObLatencyHistogramItem() { destroy(); }
+  void destroy();
+
+  bool is_equal(const uint64_t hash, const common::ObString &cluster_name,
+                const common::ObString &tenant_name, const ObProxyBasicStmtType stmt_type) const
+  {
+    return hash == hash_ && stmt_type == stmt_type_
+           && cluster_name == get_cluster_name() && tenant_name == get_tenant_name();
+  }
+
+  // ethreads share STRIPE_COUNT sets, so memory does not grow with thread count
+  ObLatencyHistogramSet *get_or_create_stripe(const int64_t thread_id);
+  // merge what all ethreads recorded since the item is created, without any lock
+  void merge(ObLatencyHistogramSet &set) const;
+  // set @set to what all ethreads recorded in the last one or two @window_us,
+  // the window moves on when it is read after @window_us
+  void merge_window(ObLatencyHistogramSet &set, const int64_t window_us);
+
+  common::ObString get_cluster_name() const { return common::ObString(cluster_name_len_, cluster_name_); }
+  common::ObString get_tenant_name() const { return common::ObString(tenant_name_len_, tenant_name_); }
+  ObProxyBasicStmtType get_stmt_type() const { return stmt_type_; }
+
+  TO_STRING_KV(K_(hash), "cluster_name", get_cluster_name(), "tenant_name", get_tenant_name(), K_(stmt_type));
+
+  static const int64_t STRIPE_COUNT = 8;
+  // p50, p90, p99 and p999 last exported to prometheus gauge, only used by prometheus sync task
+  static const int64_t EXPORT_PERCENTILE_COUNT = 4;
+  int64_t exported_values_[LATENCY_MAX_TYPE][EXPORT_PERCENTILE_COUNT];
+
+private:
+  uint64_t hash_;
+  ObProxyBasicStmtType stmt_type_;
+  int32_t cluster_name_len_;
+  int32_t tenant_name_len_;
+  char cluster_name_[OB_PROXY_MAX_CLUSTER_NAME_LENGTH];
+  char tenant_name_[common::OB_MAX_TENANT_NAME_LENGTH];
+  ObLatencyHistogramSet *stripes_[STRIPE_COUNT];
+  // readers of windows are serialized by window_lock_, writers never take it
+  common::ObSpinLock window_lock_;
+  int64_t window_start_time_;
+  // merged sets at the start of the last window and the current window
+  ObLatencyHistogramSet window_bases_[2];
+
+  DISALLOW_COPY_AND_ASSIGN(ObLatencyHistogramItem);
+};
+
+/*
+ * Latency histograms keyed by cluster, tenant and stmt type.
+ *
+ * Items live in an open addressing table and are never removed until exit, so
+ * recording is a lookup and a few atomic adds on the ethread's stripe, and
+ * readers (show command, prometheus sync) walk the table without locking.
+ * Memory is bounded by MAX_ITEM_COUNT items of STRIPE_COUNT lazily allocated
+ * sets, about 40MB at most.
+ */
+class ObLatencyHistogramManager
+{
+public:
+  static const int64_t MAX_ITEM_COUNT = 512;
+  // keep the table half empty, so probing stops soon
+  static const int64_t TABLE_SIZE = MAX_ITEM_COUNT * 2;
+
+  ObLatencyHistogramManager() : item_count_(0), discard_count_(0)
+  {
+    MEMSET(items_, 0, sizeof(items_));
+  }
+  ~ObLatencyHistogramManager() {}
+
+  // latency in us
+  int record(const common::ObString &cluster_name, const common::ObString &tenant_name,
+             const ObProxyBasicStmtType stmt_type, const int64_t latencies[LATENCY_MAX_TYPE]);
+
+  int64_t get_item_count() const { return ATOMIC_LOAD(&item_count_); }
+  int64_t get_discard_count() const { return ATOMIC_LOAD(&discard_count_); }
+  // items are never freed, it is safe to use them without reference
+  ObLatencyHistogramItem *get_item(const int64_t idx) const
+  {
+    return (idx >= 0 && idx < TABLE_SIZE) ? ATOMIC_LOAD(&items_[idx]) : NULL;
+  }
+
+  static void get_percentiles(const ObLatencyHistogram &histogram, ObLatencyPercentiles &percentiles);
+
+private:
+  int get_or_create_item(const common::ObString &cluster_name, const common::ObString &tenant_name,
+                         const ObProxyBasicStmtType stmt_type, ObLatencyHistogramItem *&item);
+
+private:
+  int64_t item_count_;
+  int64_t discard_count_;
+  ObLatencyHistogramItem *items_[TABLE_SIZE];
+
+  DISALLOW_COPY_AND_ASSIGN(ObLatencyHistogramManager);
+};
+
+ObLatencyHistogramManager &get_global_latency_histogram_mgr();
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
+#endif // OBPROXY_LATENCY_HISTOGRAM_H
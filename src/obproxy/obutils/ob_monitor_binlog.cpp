@@ -0,0 +1,549 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "obutils/ob_monitor_binlog.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "lib/allocator/ob_malloc.h"
+#include "lib/time/ob_time_utility.h"
+#include "lib/profile/ob_trace_id.h"
+#include "iocore/eventsystem/ob_ethread.h"
+#include "iocore/net/ob_inet.h"
+#include "obutils/ob_async_common_task.h"
+#include "obutils/ob_proxy_config.h"
+#include "utils/ob_proxy_lib.h"
+#include "utils/ob_proxy_monitor_utils.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obproxy::event;
+using namespace oceanbase::obproxy::net;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+static const char MONITOR_LOG_FILE_MAGIC[8] = {'O', 'B', 'P', 'M', 'O', 'N', 'L', 'G'};
+static const char *MONITOR_LOG_FILE_NAME = "obproxy_monitor.bin";
+
+const char *get_monitor_log_type_name(const ObMonitorLogType type)
+{
+  const char *name = "unknown";
+  switch (type) {
+    case MONITOR_LOG_DIGEST:
+      name = "digest";
+      break;
+    case MONITOR_LOG_SLOW:
+      name = "slow";
+      break;
+    case MONITOR_LOG_ERROR:
+      name = "error";
+      break;
+    default:
+      break;
+  }
+  return name;
+}
+
+void ObMonitorLogFileHeader::init()
+{
+  MEMSET(this, 0, sizeof(ObMonitorLogFileHeader));
+  MEMCPY(magic_, MONITOR_LOG_FILE_MAGIC, sizeof(magic_));
+  version_ = MONITOR_LOG_FILE_VERSION;
+  record_header_size_ = static_cast<int32_t>(sizeof(ObMonitorLogRecordHeader));
+  field_count_ = MONITOR_FIELD_MAX;
+}
+
+bool ObMonitorLogFileHeader::is_valid() const
+{
+  return 0 == MEMCMP(magic_, MONITOR_LOG_FILE_MAGIC, sizeof(magic_))
+         && MONITOR_LOG_FILE_VERSION == version_
+         && static_cast<int32_t>(sizeof(ObMonitorLogRecordHeader)) == record_header_size_
+         && MONITOR_FIELD_MAX == field_count_;
+}
+
+//---------------------- ObMonitorLogBuffer ----------------------//
+int ObMonitorLogBuffer::init(const int64_t capacity)
+{
+  int ret = OB_SUCCESS;
+  int64_t real_capacity = RECORD_ALIGN_SIZE;
+  while (real_capacity < capacity) {
+    real_capacity <<= 1;
+  }
+  if (OB_UNLIKELY(capacity <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(capacity), K(ret));
+  } else if (OB_ISNULL(data_ = static_cast<char *>(ob_malloc(real_capacity, ObModIds::OB_PROXY_FILE)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc mem for monitor log buffer", K(real_capacity), K(ret));
+  } else {
+    capacity_ = real_capacity;
+    write_pos_ = 0;
+    read_pos_ = 0;
+    drop_count_ = 0;
+  }
+  return ret;
+}
+
+void ObMonitorLogBuffer::destroy()
+{
+  if (NULL != data_) {
+    ob_free(data_);
+    data_ = NULL;
+  }
+  capacity_ = 0;
+  write_pos_ = 0;
+  read_pos_ = 0;
+}
+
+int64_t ObMonitorLogBuffer::get_record_length(const ObMonitorLogRecord &record, const ObMonitorLogType type)
+{
+  int64_t length = sizeof(ObMonitorLogRecordHeader);
+  for (int64_t i = 0; i < MONITOR_FIELD_MAX; ++i) {
+    if (MONITOR_FIELD_ERROR_MSG != i || MONITOR_LOG_ERROR == type) {
+      const int64_t max_length = (MONITOR_FIELD_SQL == i) ? PRINT_SQL_LEN : MAX_FIELD_LENGTH;
+      length += std::min(static_cast<int64_t>(record.fields_[i].length()), max_length);
+    }
+  }
+  return (length + RECORD_ALIGN_SIZE - 1) & ~(RECORD_ALIGN_SIZE - 1);
+}
+
+int ObMonitorLogBuffer::append(const ObMonitorLogType type, const int64_t timestamp_us,
+                               const ObMonitorLogRecord &record)
+{
+  int ret = OB_SUCCESS;
+  const int64_t length = get_record_length(record, type);
+  const int64_t read_pos = ATOMIC_LOAD(&read_pos_);
+  int64_t write_pos = write_pos_;
+  int64_t offset = write_pos & (capacity_ - 1);
+  const int64_t tail_length = capacity_ - offset;
+  const int64_t need_length = (tail_length < length) ? (tail_length + length) : length;
+
+  if (OB_ISNULL(data_)) {
+    ret = OB_NOT_INIT;
+  } else if (OB_UNLIKELY(write_pos + need_length - read_pos > capacity_)) {
+    ret = OB_SIZE_OVERFLOW;
+    (void)ATOMIC_AAF(&drop_count_, 1);
+  } else {
+    if (tail_length < length) {
+      ObMonitorLogRecordHeader *padding = reinterpret_cast<ObMonitorLogRecordHeader *>(data_ + offset);
+      padding->length_ = static_cast<uint32_t>(tail_length);
+      padding->type_ = MONITOR_LOG_PADDING;
+      write_pos += tail_length;
+      offset = 0;
+    }
+
+    ObMonitorLogRecordHeader *header = reinterpret_cast<ObMonitorLogRecordHeader *>(data_ + offset);
+    header->length_ = static_cast<uint32_t>(length);
+    header->type_ = static_cast<uint8_t>(type);
+    header->flags_ = record.flags_;
+    header->reserved_ = 0;
+    header->error_code_ = record.error_code_;
+    header->reserved2_ = 0;
+    header->timestamp_us_ = timestamp_us;
+    header->total_time_us_ = record.total_time_us_;
+    header->prepare_send_time_us_ = record.prepare_send_time_us_;
+    header->server_process_time_us_ = record.server_process_time_us_;
+    header->trace_id_[0] = record.trace_id_[0];
+    header->trace_id_[1] = record.trace_id_[1];
+    char *pos = data_ + offset + sizeof(ObMonitorLogRecordHeader);
+    for (int64_t i = 0; i < MONITOR_FIELD_MAX; ++i) {
+      int64_t field_length = 0;
+      if (MONITOR_FIELD_ERROR_MSG != i || MONITOR_LOG_ERROR == type) {
+        const int64_t max_length = (MONITOR_FIELD_SQL == i) ? PRINT_SQL_LEN : MAX_FIELD_LENGTH;
+        field_length = std::min(static_cast<int64_t>(record.fields_[i].length()), max_length);
+        if (field_length > 0) {
+          MEMCPY(pos, record.fields_[i].ptr(), field_length);
+          pos += field_length;
+        }
+      }
+      header->field_lengths_[i] = static_cast<uint16_t>(field_length);
+    }
+    // publish the record after it is written
+    ATOMIC_STORE(&write_pos_, write_pos + length);
+  }
+  return ret;
+}
+
+int64_t ObMonitorLogBuffer::consume(char *buf, const int64_t buf_len)
+{
+  int64_t copied_length = 0;
+  int64_t read_pos = read_pos_;
+  const int64_t write_pos = ATOMIC_LOAD(&write_pos_);
+  if (NULL != data_ && NULL != buf) {
+    while (read_pos < write_pos) {
+      const ObMonitorLogRecordHeader *header =
+          reinterpret_cast<const ObMonitorLogRecordHeader *>(data_ + (read_pos & (capacity_ - 1)));
+      const int64_t length = header->length_;
+      if (MONITOR_LOG_PADDING == header->type_) {
+        read_pos += length;
+      } else if (copied_length + length > buf_len) {
+        break;
+      } else {
+        MEMCPY(buf + copied_length, header, length);
+        copied_length += length;
+        read_pos += length;
+      }
+    }
+    // release the space after it is copied
+    ATOMIC_STORE(&read_pos_, read_pos);
+  }
+  return copied_length;
+}
+
+//---------------------- ObMonitorBinlog ----------------------//
+ObMonitorBinlog &get_global_monitor_binlog()
+{
+  static ObMonitorBinlog g_monitor_binlog;
+  return g_monitor_binlog;
+}
+
+ObMonitorBinlog::ObMonitorBinlog()
+  : is_inited_(false), fd_(-1), file_size_(0), thread_buffer_size_(0), flush_buf_(NULL),
+    flush_cont_(NULL), flush_lock_()
+{
+  file_path_[0] = '\0';
+  MEMSET(thread_buffers_, 0, sizeof(thread_buffers_));
+}
+
+int ObMonitorBinlog::init(const char *log_dir, const int64_t thread_buffer_size)
+{
+  int ret = OB_SUCCESS;
+  int64_t len = 0;
+  if (OB_UNLIKELY(is_inited_)) {
+    ret = OB_INIT_TWICE;
+    LOG_WARN("monitor binlog init twice", K(ret));
+  } else if (OB_ISNULL(log_dir) || OB_UNLIKELY(thread_buffer_size <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(log_dir), K(thread_buffer_size), K(ret));
+  } else if (OB_UNLIKELY((len = snprintf(file_path_, sizeof(file_path_), "%s/%s", log_dir, MONITOR_LOG_FILE_NAME)) <= 0)
+             || OB_UNLIKELY(len >= static_cast<int64_t>(sizeof(file_path_)))) {
+    ret = OB_SIZE_OVERFLOW;
+    LOG_WARN("fail to format monitor binlog file path", K(log_dir), K(ret));
+  } else if (OB_ISNULL(flush_buf_ = static_cast<char *>(ob_malloc(FLUSH_BUFFER_SIZE, ObModIds::OB_PROXY_FILE)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc mem for monitor binlog flush buffer", K(ret));
+  } else if (OB_FAIL(open_file())) {
+    LOG_WARN("fail to open monitor binlog file", K_(file_path), K(ret));
+  } else if (OB_ISNULL(flush_cont_ = ObAsyncCommonTask::create_and_start_repeat_task(
+                 FLUSH_INTERVAL_US, "monitor_binlog_flush_task", ObMonitorBinlog::do_flush_task, NULL, true))) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("fail to create and start monitor binlog flush task", K(ret));
+  } else {
+    thread_buffer_size_ = thread_buffer_size;
+    is_inited_ = true;
+    LOG_INFO("succ to init monitor binlog", K_(file_path), K_(thread_buffer_size));
+  }
+
+  if (OB_FAIL(ret)) {
+    destroy();
+  }
+  return ret;
+}
+
+void ObMonitorBinlog::destroy()
+{
+  if (NULL != flush_cont_) {
+    (void)ObAsyncCommonTask::destroy_repeat_task(flush_cont_);
+  }
+  if (is_inited_) {
+    (void)flush();
+  }
+  is_inited_ = false;
+  if (fd_ >= 0) {
+    (void)::close(fd_);
+    fd_ = -1;
+  }
+  if (NULL != flush_buf_) {
+    ob_free(flush_buf_);
+    flush_buf_ = NULL;
+  }
+  for (int64_t i = 0; i < MAX_EVENT_THREADS; ++i) {
+    if (NULL != thread_buffers_[i]) {
+      thread_buffers_[i]->~ObMonitorLogBuffer();
+      ob_free(thread_buffers_[i]);
+      thread_buffers_[i] = NULL;
+    }
+  }
+}
+
+ObMonitorLogBuffer *ObMonitorBinlog::get_or_create_thread_buffer(const int64_t thread_id)
+{
+  int ret = OB_SUCCESS;
+  ObMonitorLogBuffer *buffer = NULL;
+  if (OB_LIKELY(thread_id >= 0 && thread_id < MAX_EVENT_THREADS)
+      && OB_ISNULL(buffer = thread_buffers_[thread_id])) {
+    void *buf = ob_malloc(sizeof(ObMonitorLogBuffer), ObModIds::OB_PROXY_FILE);
+    if (OB_ISNULL(buf)) {
+      LOG_WARN("fail to alloc mem for monitor log buffer", K(thread_id));
+    } else {
+      buffer = new (buf) ObMonitorLogBuffer();
+      if (OB_FAIL(buffer->init(thread_buffer_size_))) {
+        LOG_WARN("fail to init monitor log buffer", K(thread_id), K(ret));
+        buffer->~ObMonitorLogBuffer();
+        ob_free(buffer);
+        buffer = NULL;
+      } else {
+        // only the owner ethread creates its buffer, store is enough
+        ATOMIC_STORE(&thread_buffers_[thread_id], buffer);
+      }
+    }
+  }
+  return buffer;
+}
+
+void ObMonitorBinlog::append(const ObMonitorLogType type, const ObMonitorLogRecord &record)
+{
+  ObEThread *ethread = this_ethread();
+  ObMonitorLogBuffer *buffer = NULL;
+  if (OB_LIKELY(is_inited_)
+      && OB_LIKELY(NULL != ethread) && OB_LIKELY(REGULAR == ethread->tt_)
+      && OB_LIKELY(NULL != (buffer = get_or_create_thread_buffer(ethread->id_)))) {
+    // a full buffer only drops the record, the drop count tells
+    (void)buffer->append(type, ObTimeUtility::current_time(), record);
+  }
+}
+
+int64_t ObMonitorBinlog::get_drop_count() const
+{
+  int64_t drop_count = 0;
+  for (int64_t i = 0; i < MAX_EVENT_THREADS; ++i) {
+    const ObMonitorLogBuffer *buffer = ATOMIC_LOAD(&thread_buffers_[i]);
+    if (NULL != buffer) {
+      drop_count += buffer->get_drop_count();
+    }
+  }
+  return drop_count;
+}
+
+int ObMonitorBinlog::do_flush_task()
+{
+  return get_global_monitor_binlog().flush();
+}
+
+int ObMonitorBinlog::flush()
+{
+  int ret = OB_SUCCESS;
+  ObSpinLockGuard guard(flush_lock_);
+  if (OB_ISNULL(flush_buf_)) {
+    ret = OB_NOT_INIT;
+  } else {
+    for (int64_t i = 0; OB_SUCC(ret) && i < MAX_EVENT_THREADS; ++i) {
+      ObMonitorLogBuffer *buffer = ATOMIC_LOAD(&thread_buffers_[i]);
+      int64_t length = 0;
+      while (OB_SUCC(ret) && NULL != buffer && (length = buffer->consume(flush_buf_, FLUSH_BUFFER_SIZE)) > 0) {
+        if (OB_FAIL(write_file(flush_buf_, length))) {
+          LOG_WARN("fail to write monitor binlog file", K_(file_path), K(length), K(ret));
+        }
+      }
+    }
+    if (OB_SUCC(ret) && OB_FAIL(rotate_file_if_needed())) {
+      LOG_WARN("fail to rotate monitor binlog file", K_(file_path), K(ret));
+    }
+  }
+  return ret;
+}
+
+int ObMonitorBinlog::open_file()
+{
+  int ret = OB_SUCCESS;
+  struct stat st;
+  if (OB_UNLIKELY((fd_ = ::open(file_path_, O_WRONLY | O_CREAT | O_APPEND, 0644)) < 0)) {
+    ret = OB_IO_ERROR;
+    LOG_WARN("fail to open monitor binlog file", K_(file_path), KERRMSGS, K(ret));
+  } else if (OB_UNLIKELY(0 != ::fstat(fd_, &st))) {
+    ret = OB_IO_ERROR;
+    LOG_WARN("fail to stat monitor binlog file", K_(file_path), KERRMSGS, K(ret));
+  } else {
+    file_size_ = st.st_size;
+    if (0 == file_size_) {
+      ObMonitorLogFileHeader file_header;
+      file_header.init();
+      ret = write_file(reinterpret_cast<const char *>(&file_header), sizeof(file_header));
+    }
+  }
+  return ret;
+}
+
+int ObMonitorBinlog::write_file(const char *buf, const int64_t len)
+{
+  int ret = OB_SUCCESS;
+  int64_t written = 0;
+  while (OB_SUCC(ret) && written < len) {
+    const ssize_t n = ::write(fd_, buf + written, len - written);
+    if (n < 0) {
+      if (EINTR != errno) {
+        ret = OB_IO_ERROR;
+        LOG_WARN("fail to write monitor binlog file", K_(file_path), KERRMSGS, K(ret));
+      }
+    } else {
+      written += n;
+    }
+  }
+  file_size_ += written;
+  return ret;
+}
+
+int ObMonitorBinlog::rotate_file_if_needed()
+{
+  int ret = OB_SUCCESS;
+  if (file_size_ >= get_global_proxy_config().max_log_file_size) {
+    char new_path[OB_MAX_FILE_NAME_LENGTH];
+    time_t now = time(NULL);
+    struct tm tm;
+    (void)localtime_r(&now, &tm);
+    const int64_t len = snprintf(new_path, sizeof(new_path), "%s.%04d%02d%02d%02d%02d%02d", file_path_,
+                                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+    if (OB_UNLIKELY(len <= 0) || OB_UNLIKELY(len >= static_cast<int64_t>(sizeof(new_path)))) {
+      ret = OB_SIZE_OVERFLOW;
+      LOG_WARN("fail to format rotated monitor binlog file path", K_(file_path), K(ret));
+    } else if (OB_UNLIKELY(0 != ::rename(file_path_, new_path))) {
+      ret = OB_IO_ERROR;
+      LOG_WARN("fail to rename monitor binlog file", K_(file_path), K(new_path), KERRMSGS, K(ret));
+    } else {
+      (void)::close(fd_);
+      fd_ = -1;
+      file_size_ = 0;
+      if (OB_FAIL(open_file())) {
+        LOG_WARN("fail to open monitor binlog file", K_(file_path), K(ret));
+      }
+    }
+  }
+  return ret;
+}
+
+//---------------------- ObMonitorBinlogDecoder ----------------------//
+int ObMonitorBinlogDecoder::decode_record(const char *data, const int64_t data_len, int64_t &pos,
+                                          const ObMonitorLogRecordHeader *&header,
+                                          ObString fields[MONITOR_FIELD_MAX])
+{
+  int ret = OB_SUCCESS;
+  header = NULL;
+  if (OB_ISNULL(data) || OB_UNLIKELY(pos < 0)) {
+    ret = OB_INVALID_ARGUMENT;
+  } else if (data_len - pos < static_cast<int64_t>(sizeof(ObMonitorLogRecordHeader))) {
+    ret = OB_ITER_END;
+  } else {
+    const ObMonitorLogRecordHeader *cur = reinterpret_cast<const ObMonitorLogRecordHeader *>(data + pos);
+    int64_t field_pos = pos + sizeof(ObMonitorLogRecordHeader);
+    if (data_len - pos < cur->length_) {
+      ret = OB_ITER_END;
+    } else if (OB_UNLIKELY(cur->type_ >= MONITOR_LOG_MAX_TYPE)
+               || OB_UNLIKELY(cur->length_ < sizeof(ObMonitorLogRecordHeader))
+               || OB_UNLIKELY(0 != cur->length_ % ObMonitorLogBuffer::RECORD_ALIGN_SIZE)) {
+      ret = OB_INVALID_DATA;
+      LOG_WARN("invalid monitor log record", K(pos), "type", cur->type_, "length", cur->length_, K(ret));
+    } else {
+      for (int64_t i = 0; OB_SUCC(ret) && i < MONITOR_FIELD_MAX; ++i) {
+        const int64_t field_length = cur->field_lengths_[i];
+        if (OB_UNLIKELY(field_pos + field_length > pos + cur->length_)) {
+          ret = OB_INVALID_DATA;
+          LOG_WARN("invalid monitor log field", K(pos), K(i), K(field_length), K(ret));
+        } else {
+          fields[i].assign_ptr(data + field_pos, static_cast<int32_t>(field_length));
+          field_pos += field_length;
+        }
+      }
+      if (OB_SUCC(ret)) {
+        header = cur;
+        pos += cur->length_;
+      }
+    }
+  }
+  return ret;
+}
+
+int ObMonitorBinlogDecoder::to_text(const ObMonitorLogRecordHeader &header, const ObString fields[MONITOR_FIELD_MAX],
+                                    char *buf, const int64_t buf_len, int64_t &pos)
+{
+  int ret = OB_SUCCESS;
+  const bool is_error_resp = 0 != (header.flags_ & MONITOR_FLAG_ERROR_RESP);
+  const bool is_enc_beyond_trust = 0 != (header.flags_ & MONITOR_FLAG_ENC_BEYOND_TRUST);
+  const time_t sec = static_cast<time_t>(header.timestamp_us_ / 1000000);
+  struct tm tm;
+  (void)localtime_r(&sec, &tm);
+
+  char error_code_str[OB_MAX_ERROR_CODE_LEN] = "\0";
+  if (is_error_resp) {
+    snprintf(error_code_str, OB_MAX_ERROR_CODE_LEN, "%d", header.error_code_);
+  }
+
+  char sql_buf[PRINT_SQL_LEN] = "\0";
+  int32_t sql_len = 0;
+  const ObString &sql = fields[MONITOR_FIELD_SQL];
+  if (!sql.empty()) {
+    (void)ObProxyMonitorUtils::sql_escape(sql.ptr(), sql.length(), sql_buf, PRINT_SQL_LEN, sql_len);
+  }
+
+  char ip_port_buf[INET6_ADDRPORTSTRLEN] = "\0";
+  const ObString &addr = fields[MONITOR_FIELD_SERVER_ADDR];
+  if (addr.length() > 0 && addr.length() <= static_cast<int32_t>(sizeof(ObIpEndpoint))) {
+    ObIpEndpoint server_addr;
+    MEMCPY(&server_addr, addr.ptr(), addr.length());
+    if (ops_is_ip(server_addr)) {
+      char ip_buf[INET6_ADDRSTRLEN] = "\0";
+      snprintf(ip_port_buf, INET6_ADDRPORTSTRLEN, "%s:%u", ops_ip_ntop(server_addr, ip_buf, INET6_ADDRSTRLEN),
+               ops_ip_port_host_order(server_addr));
+    }
+  }
+
+#define FIELD_PARAM(field) fields[field].length(), fields[field].ptr()
+  // keep the same as MONITOR_LOG_FORMAT in ob_mysql_sm.cpp
+  if (OB_FAIL(databuff_printf(buf, buf_len, pos,
+                              "%04d-%02d-%02d %02d:%02d:%02d.%06ld,"
+                              "%.*s,%.*s,%.*s,"
+                              "%.*s,%.*s:%.*s:%.*s,%.*s,"
+                              "%.*s,%.*s,%.*s,%.*s,%s,%s,%.*s,"
+                              "%ldus,%ldus,%dus,%ldus,"
+                              TRACE_ID_FORMAT ",%s,%s,"
+                              "%.*s,%s,%s",
+                              tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                              header.timestamp_us_ % 1000000,
+                              FIELD_PARAM(MONITOR_FIELD_LOGIC_TENANT),
+                              FIELD_PARAM(MONITOR_FIELD_ANT_TRACE_ID),
+                              FIELD_PARAM(MONITOR_FIELD_RPC_ID),
+                              FIELD_PARAM(MONITOR_FIELD_LOGIC_DATABASE),
+                              FIELD_PARAM(MONITOR_FIELD_CLUSTER),
+                              FIELD_PARAM(MONITOR_FIELD_TENANT),
+                              FIELD_PARAM(MONITOR_FIELD_DATABASE),
+                              FIELD_PARAM(MONITOR_FIELD_DATABASE_TYPE),
+                              FIELD_PARAM(MONITOR_FIELD_LOGIC_TABLE),
+                              FIELD_PARAM(MONITOR_FIELD_TABLE),
+                              FIELD_PARAM(MONITOR_FIELD_SQL_CMD),
+                              FIELD_PARAM(MONITOR_FIELD_STMT_TYPE),
+                              is_error_resp ? "failed" : "success",
+                              error_code_str,
+                              sql_len, sql_buf,
+                              header.total_time_us_, header.prepare_send_time_us_, 0,
+                              header.server_process_time_us_,
+                              header.trace_id_[0], header.trace_id_[1], "", "",
+                              FIELD_PARAM(MONITOR_FIELD_SHARD_NAME),
+                              is_enc_beyond_trust ? "1" : "0",
+                              ip_port_buf))) {
+    LOG_WARN("fail to print monitor log", K(ret));
+  } else if (MONITOR_LOG_ERROR == header.type_
+             && OB_FAIL(databuff_printf(buf, buf_len, pos, ",%.*s", FIELD_PARAM(MONITOR_FIELD_ERROR_MSG)))) {
+    LOG_WARN("fail to print monitor log error msg", K(ret));
+  } else if (OB_FAIL(databuff_printf(buf, buf_len, pos, "\n"))) {
+    LOG_WARN("fail to print monitor log end", K(ret));
+  }
+#undef FIELD_PARAM
+  return ret;
+}
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
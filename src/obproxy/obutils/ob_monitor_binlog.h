@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_MONITOR_BINLOG_H
+#define OBPROXY_MONITOR_BINLOG_H
+
+#include "lib/string/ob_string.h"
+#include "lib/utility/ob_print_utils.h"
+#include "lib/lock/ob_spin_lock.h"
+#include "iocore/eventsystem/ob_event_processor.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+class ObAsyncCommonTask;
+
+enum ObMonitorLogType
+{
+  MONITOR_LOG_DIGEST = 0,
+  MONITOR_LOG_SLOW,
+  MONITOR_LOG_ERROR,
+  MONITOR_LOG_MAX_TYPE,
+  // fills the tail of ring buffer, never written to file
+  MONITOR_LOG_PADDING = 0xFF
+};
+
+const char *get_monitor_log_type_name(const ObMonitorLogType type);
+
+// string fields of one monitor log, in the order they are printed
+enum ObMonitorLogField
+{
+  MONITOR_FIELD_LOGIC_TENANT = 0,
+  MONITOR_FIELD_ANT_TRACE_ID,
+  MONITOR_FIELD_RPC_ID,
+  MONITOR_FIELD_LOGIC_DATABASE,
+  MONITOR_FIELD_CLUSTER,
+  MONITOR_FIELD_TENANT,
+  MONITOR_FIELD_DATABASE,
+  MONITOR_FIELD_DATABASE_TYPE,
+  MONITOR_FIELD_LOGIC_TABLE,
+  MONITOR_FIELD_TABLE,
+  MONITOR_FIELD_SQL_CMD,
+  MONITOR_FIELD_STMT_TYPE,
+  MONITOR_FIELD_SQL,              // raw sql, escaped when decoded
+  MONITOR_FIELD_SHARD_NAME,
+  MONITOR_FIELD_SERVER_ADDR,      // raw sockaddr, printed as ip:port when decoded
+  MONITOR_FIELD_ERROR_MSG,
+  MONITOR_FIELD_MAX
+};
+
+enum ObMonitorLogFlag
+{
+  MONITOR_FLAG_ERROR_RESP = 1,
+  MONITOR_FLAG_ENC_BEYOND_TRUST = 1 << 1,
+  MONITOR_FLAG_WARN_LEVEL = 1 << 2,       // digest log printed as WARN, slow and error log always are
+};
+
+// what work thread fills on its stack, strings are only referenced
+struct ObMonitorLogRecord
+{
+  ObMonitorLogRecord() : flags_(0), error_code_(0), total_time_us_(0),
+                         prepare_send_time_us_(0), server_process_time_us_(0)
+  {
+    trace_id_[0] = 0;
+    trace_id_[1] = 0;
+  }
+
+  uint8_t flags_;
+  int32_t error_code_;
+  int64_t total_time_us_;
+  int64_t prepare_send_time_us_;
+  int64_t server_process_time_us_;
+  uint64_t trace_id_[2];
+  common::ObString fields_[MONITOR_FIELD_MAX];
+};
+
+/*
+ * Fixed layout of one record in buffer and file, followed by the string
+ * fields in ObMonitorLogField order, padded to 8 bytes.
+ */
+struct ObMonitorLogRecordHeader
+{
+  uint32_t length_;   // whole record, header included
+  uint8_t type_;      // ObMonitorLogType
+  uint8_t flags_;
+  uint16_t reserved_;
+  int32_t error_code_;
+  int32_t reserved2_;
+  int64_t timestamp_us_;
+  int64_t total_time_us_;
+  int64_t prepare_send_time_us_;
+  int64_t server_process_time_us_;
+  uint64_t trace_id_[2];
+  uint16_t field_lengths_[MONITOR_FIELD_MAX];
+};
+
+struct ObMonitorLogFileHeader
+{
+  static const int32_t MONITOR_LOG_FILE_VERSION = 1;
+
+  char magic_[8];
+  int32_t version_;
+  int32_t record_header_size_;
+  int32_t field_count_;
+  int32_t reserved_;
+
+  void init();
+  bool is_valid() const;
+};
+
+/*
+ * Single producer single consumer ring buffer, the producer is the work
+ * thread which owns it and the consumer is the flush task. Records never
+ * wrap around, the tail which can not hold a record is filled with padding.
+ */
+class ObMonitorLogBuffer
+{
+public:
+  static const int64_t RECORD_ALIGN_SIZE = 8;
+  // one field is cut to this, sql longer than PRINT_SQL_LEN is cut even shorter
+  static const int64_t MAX_FIELD_LENGTH = UINT16_MAX & ~(RECORD_ALIGN_SIZE - 1);
+
+  ObMonitorLogBuffer() : data_(NULL), capacity_(0), write_pos_(0), drop_count_(0), read_pos_(0) {}
+  ~ObMonitorLogBuffer() { destroy(); }
+
+  // @capacity will be rounded up to power of 2
+  int init(const int64_t capacity);
+  void destroy();
+
+  // called by owner thread only, fails if there is no room
+  int append(const ObMonitorLogType type, const int64_t timestamp_us, const ObMonitorLogRecord &record);
+  // called by flush task only, copy whole records into @buf and return the copied length
+  int64_t consume(char *buf, const int64_t buf_len);
+
+  int64_t get_drop_count() const { return ATOMIC_LOAD(&drop_count_); }
+  static int64_t get_record_length(const ObMonitorLogRecord &record, const ObMonitorLogType type);
+
+private:
+  char *data_;
+  int64_t capacity_;
+  // written by producer
+  int64_t write_pos_;
+  int64_t drop_count_;
+  // written by consumer, keep it away from producer's line
+  char padding_[CACHE_ALIGN_SIZE];
+  int64_t read_pos_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObMonitorLogBuffer);
+};
+
+/*
+ * Binary monitor log: work threads append fixed layout records into their
+ * own buffer instead of formatting text, and a background task copies them
+ * into log_dir/obproxy_monitor.bin. Use obproxy_monitor_log_decoder to
+ * turn the file into the text of obproxy_digest.log, obproxy_slow.log and
+ * obproxy_error.log.
+ */
+class ObMonitorBinlog
+{
+public:
+  static const int64_t FLUSH_INTERVAL_US = 100 * 1000; // 100ms
+  static const int64_t FLUSH_BUFFER_SIZE = 2 * 1024 * 1024;
+
+  ObMonitorBinlog();
+  ~ObMonitorBinlog() {}
+
+  int init(const char *log_dir, const int64_t thread_buffer_size);
+  void destroy();
+  bool is_inited() const { return is_inited_; }
+
+  // called by work threads, a full buffer drops the record
+  void append(const ObMonitorLogType type, const ObMonitorLogRecord &record);
+  int flush();
+  int64_t get_drop_count() const;
+
+  static int do_flush_task();
+
+private:
+  ObMonitorLogBuffer *get_or_create_thread_buffer(const int64_t thread_id);
+  int open_file();
+  int write_file(const char *buf, const int64_t len);
+  int rotate_file_if_needed();
+
+private:
+  bool is_inited_;
+  int fd_;
+  int64_t file_size_;
+  int64_t thread_buffer_size_;
+  char *flush_buf_;
+  ObAsyncCommonTask *flush_cont_;
+  common::ObSpinLock flush_lock_;
+  char file_path_[common::OB_MAX_FILE_NAME_LENGTH];
+  ObMonitorLogBuffer *thread_buffers_[event::MAX_EVENT_THREADS];
+
+  DISALLOW_COPY_AND_ASSIGN(ObMonitorBinlog);
+};
+
+ObMonitorBinlog &get_global_monitor_binlog();
+
+/*
+ * Turns records back into the text the monitor logs print, used by the
+ * decoder tool.
+ */
+class ObMonitorBinlogDecoder
+{
+public:
+  // @data holds whole records right after the file header,
+  // @pos is moved to the first record not decoded
+  static int decode_record(const char *data, const int64_t data_len, int64_t &pos,
+                           const ObMonitorLogRecordHeader *&header,
+                           common::ObString fields[MONITOR_FIELD_MAX]);
+  // print one record as a line of the text monitor log, '\n' included
+  static int to_text(const ObMonitorLogRecordHeader &header, const common::ObString fields[MONITOR_FIELD_MAX],
+                     char *buf, const int64_t buf_len, int64_t &pos);
+  // the level text log prints the record with, WARN records also go to the .wf file
+  static int32_t get_log_level(const ObMonitorLogRecordHeader &header)
+  {
+    return (MONITOR_LOG_DIGEST != header.type_ || 0 != (header.flags_ & MONITOR_FLAG_WARN_LEVEL))
+           ? OB_LOG_LEVEL_WARN : OB_LOG_LEVEL_INFO;
+  }
+};
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
+#endif // OBPROXY_MONITOR_BINLOG_H
@@ -856,7 +856,8 @@ int ObProxyLimitConfig::assign(ObProxyLimitConfig &other)
 }
 
 int ObProxyLimitConfig::calc(ObMysqlTransact::ObTransState &trans_state, const ObClientSessionInfo &cs_info,
-                             ObIAllocator *calc_allocator, bool &is_pass, ObString &limit_name)
+                             ObIAllocator *calc_allocator, ObProxyQosMatchContext &match_ctx,
+                             bool &is_pass, ObString &limit_name)
 {
   int ret = OB_SUCCESS;
   bool is_match = true;
@@ -868,7 +869,7 @@ int ObProxyLimitConfig::calc(ObMysqlTransact::ObTransState &trans_state, const O
     for (int64_t i = 0; OB_SUCC(ret) && is_match && i < cond_array_.count(); i++) {
       is_match = false;
       ObProxyQosCond *cond = cond_array_.at(i);
-      if (OB_FAIL(cond->calc(client_request, calc_allocator, is_match))) {
+      if (OB_FAIL(cond->calc(client_request, calc_allocator, match_ctx, is_match))) {
         LOG_WARN("fail to calc cond", KPC(cond), K(ret));
       }
     }
@@ -945,6 +946,7 @@ int ObProxyLimitControlConfig::calc(ObMysqlTransact::ObTransState &trans_state,
   if (OB_UNLIKELY(database_name.empty())) {
     cs_info.get_database_name(database_name);
   }
+  ObProxyQosMatchContext match_ctx(literal_matcher_, trans_state.trans_info_.client_request_.get_expr_sql());
 
   for (int64_t i = 0; OB_SUCC(ret) && is_pass && i < limit_config_array_.count(); i++) {
     ObProxyLimitConfig *limit_conf = limit_config_array_.at(i);
@@ -954,7 +956,7 @@ int ObProxyLimitControlConfig::calc(ObMysqlTransact::ObTransState &trans_state,
         && 0 == limit_conf->get_tenant_name().case_compare(tenant_name)
         && 0 == limit_conf->get_database_name().case_compare(database_name)
         && 0 == limit_conf->get_user_name().case_compare(user_name)) {
-      if (OB_FAIL(limit_conf->calc(trans_state, cs_info, calc_allocator, is_pass, limit_name))) {
+      if (OB_FAIL(limit_conf->calc(trans_state, cs_info, calc_allocator, match_ctx, is_pass, limit_name))) {
         LOG_WARN("fail to calc limit conf", KPC(limit_conf), K(ret));
       }
     }
@@ -1096,11 +1098,53 @@ int ObProxyLimitControlConfig::parse_config_spec(Value &json_value)
   if (OB_SUCC(ret) && NULL != json_limiter) {
     if (OB_FAIL(parse_limit_conf(*json_limiter))) {
       LOG_WARN("fail to parse limit conf", K(ret));
+    } else if (OB_FAIL(build_literal_matcher())) {
+      LOG_WARN("fail to build literal matcher", K(ret));
     }
   }
   return ret;
 }
 
+int ObProxyLimitControlConfig::build_literal_matcher()
+{
+  int ret = OB_SUCCESS;
+
+  if (OB_FAIL(literal_matcher_.init(allocator_))) {
+    LOG_WARN("fail to init literal matcher", K(ret));
+  }
+
+  for (int64_t i = 0; OB_SUCC(ret) && i < limit_config_array_.count(); i++) {
+    ObIArray<ObProxyQosCond*> &cond_array = limit_config_array_.at(i)->get_cond_array();
+    for (int64_t j = 0; OB_SUCC(ret) && j < cond_array.count(); j++) {
+      ObProxyQosCond *cond = cond_array.at(j);
+      const ObString literal = cond->get_scan_literal();
+      int64_t literal_id = -1;
+      if (literal.empty()) {
+        // the cond does not look into the sql
+      } else if (OB_FAIL(literal_matcher_.add_literal(literal, literal_id))) {
+        if (OB_SIZE_OVERFLOW == ret) {
+          // the cond matches by itself as before
+          ret = OB_SUCCESS;
+        } else {
+          LOG_WARN("fail to add literal", K(literal), K(ret));
+        }
+      } else {
+        cond->set_literal_id(literal_id);
+      }
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    if (OB_FAIL(literal_matcher_.build())) {
+      LOG_WARN("fail to build literal matcher", K(ret));
+    } else {
+      LOG_DEBUG("succ to build literal matcher", K_(literal_matcher));
+    }
+  }
+
+  return ret;
+}
+
 int ObProxyLimitControlConfig::spec_to_json(ObSqlString &buf) const
 {
   int ret = OB_SUCCESS;
@@ -1188,6 +1232,12 @@ int ObProxyLimitControlConfig::assign(const ObProxyLimitControlConfig &other)
         limit_config_array_.push_back(limit_config);
       }
     }
+
+    if (OB_SUCC(ret)) {
+      if (OB_FAIL(build_literal_matcher())) {
+        LOG_WARN("fail to build literal matcher", K(ret));
+      }
+    }
   }
 
   return ret;
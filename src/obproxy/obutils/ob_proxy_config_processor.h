@@ -256,7 +256,8 @@ public:
   int handle_action();
   int64_t to_string(char *buf, const int64_t buf_len) const;
   int calc(proxy::ObMysqlTransact::ObTransState &trans_state, const proxy::ObClientSessionInfo &cs_info,
-           common::ObIAllocator *calc_allocator, bool &is_pass, common::ObString &limit_name);
+           common::ObIAllocator *calc_allocator, qos::ObProxyQosMatchContext &match_ctx,
+           bool &is_pass, common::ObString &limit_name);
 
   template<typename T, typename TA>
   int create_action_or_cond(TA *&action_or_cond)
@@ -325,10 +326,13 @@ private:
   int parse_limit_action(json::Value &json_value, ObProxyLimitConfig *limit_config);
   int parse_limit_rule(json::Value &json_value, ObProxyLimitConfig *limit_config);
   int parse_limit_conf(json::Value &json_value);
+  int build_literal_matcher();
 
 private:
   common::ObArenaAllocator allocator_;
   common::ObSEArray<ObProxyLimitConfig*, 4> limit_config_array_;
+  // literals of the conds of all limit configs, the sql is scanned once in calc
+  qos::ObProxyQosLiteralMatcher literal_matcher_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ObProxyLimitControlConfig);
@@ -146,8 +146,18 @@ int ObProxyConnNumCheckCont::handle_one_schema_key_num_check()
       int64_t cur_count = get_global_session_manager().get_current_session_conn_count(
                           schema_key_.dbkey_.config_string_,
                           common_addr);
-      if (cur_count < min_count) {
-        // less than min shoud create conn, only shard need create
+      // with adaptive sizing, the pool keeps the conn count it needs instead of min_count
+      int64_t target_count = min_count;
+      int64_t shrink_num = 0;
+      if (get_global_proxy_config().enable_session_pool_adaptive
+          && OB_SUCCESS != get_global_session_manager().calc_adaptive_conn_count(
+                              schema_key_.dbkey_.config_string_, common_addr, min_count, max_count,
+                              target_count, shrink_num)) {
+        target_count = min_count;
+        shrink_num = 0;
+      }
+      if (cur_count < target_count) {
+        // less than target shoud create conn, only shard need create
         if (TYPE_SHARD_CONNECTOR == schema_key_.get_connector_type()) {
           SchemaKeyConnInfo* schema_key_info = op_alloc(SchemaKeyConnInfo);
           if (OB_ISNULL(schema_key_info)) {
@@ -156,11 +166,11 @@ int ObProxyConnNumCheckCont::handle_one_schema_key_num_check()
           }
           schema_key_info->schema_key_ = schema_key_;
           schema_key_info->addr_ = addr_info->addr_;
-          schema_key_info->conn_count_ = min_count - cur_count;
+          schema_key_info->conn_count_ = target_count - cur_count;
           get_global_server_conn_job_list().push(schema_key_info);
           int32_t count = get_global_server_conn_job_list().count();
           LOG_DEBUG("add a server conn job", K(schema_key_), K(schema_key_info), KPC(schema_key_info),
-            K(cur_count), K(min_count), K(common_addr), K(count));
+            K(cur_count), K(min_count), K(target_count), K(common_addr), K(count));
         } else {
           LOG_DEBUG("not shard, do nothing", K(schema_key_));
         }
@@ -169,6 +179,11 @@ int ObProxyConnNumCheckCont::handle_one_schema_key_num_check()
         LOG_DEBUG("will do_close_extra_session_conn", K(schema_key_.dbkey_), K(common_addr),
           K(common_addr), K(cur_count - max_count));
         get_global_session_manager().do_close_extra_session_conn(schema_key_, common_addr, cur_count - max_count);
+      } else if (shrink_num > 0) {
+        // shrink idle conn step by step when load goes down
+        LOG_DEBUG("will shrink session pool", K(schema_key_.dbkey_), K(common_addr),
+          K(cur_count), K(target_count), K(shrink_num));
+        get_global_session_manager().do_close_extra_session_conn(schema_key_, common_addr, shrink_num);
       }
     }
   }
@@ -0,0 +1,283 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "obutils/ob_server_prober.h"
+#include "obutils/ob_async_common_task.h"
+#include "obutils/ob_congestion_manager.h"
+#include "obutils/ob_resource_pool_processor.h"
+#include "obutils/ob_proxy_config.h"
+#include "utils/ob_proxy_utils.h"
+#include "iocore/eventsystem/ob_event_system.h"
+#include "iocore/net/ob_socket_manager.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obproxy::event;
+using namespace oceanbase::obproxy::net;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+ObEventThreadType ET_PROBE = ET_CALL;
+ObServerProber g_server_prober;
+
+ObServerProber::ObServerProber()
+  : probe_cont_(NULL), is_starting_(false), is_thread_spawned_(false),
+    next_entry_idx_(0), entries_()
+{
+}
+
+void ObServerProber::destroy()
+{
+  if (NULL != probe_cont_) {
+    (void)ObAsyncCommonTask::destroy_repeat_task(probe_cont_);
+  }
+  for (int64_t i = 0; i < entries_.count(); ++i) {
+    entries_.at(i)->dec_ref();
+  }
+  entries_.reset();
+}
+
+int ObServerProber::start_if_enabled()
+{
+  int ret = OB_SUCCESS;
+  // config may be reloaded by several threads at the same time
+  if (get_global_proxy_config().enable_server_probe
+      && NULL == ATOMIC_LOAD(&probe_cont_)
+      && ATOMIC_BCAS(&is_starting_, false, true)) {
+    if (NULL == probe_cont_ && OB_FAIL(start())) {
+      LOG_WARN("fail to start server probe task", K(ret));
+    }
+    ATOMIC_STORE(&is_starting_, false);
+  }
+  return ret;
+}
+
+int ObServerProber::start()
+{
+  int ret = OB_SUCCESS;
+  const int64_t interval_us = ObRandomNumUtils::get_random_half_to_full(
+                              get_global_proxy_config().server_probe_interval);
+  if (OB_UNLIKELY(NULL != probe_cont_)) {
+    ret = OB_INIT_TWICE;
+    LOG_WARN("server probe task has already been started", K(ret));
+  } else if (!is_thread_spawned_
+             && OB_FAIL(g_event_processor.spawn_event_threads(1, "ET_PROBE", DEFAULT_STACKSIZE, ET_PROBE))) {
+    LOG_WARN("fail to spawn event thread for ET_PROBE", K(ret));
+  } else if (FALSE_IT(is_thread_spawned_ = true)) {
+  } else if (OB_ISNULL(probe_cont_ = ObAsyncCommonTask::create_and_start_repeat_task(interval_us,
+                       "server_probe_task",
+                       ObServerProber::do_probe_task,
+                       ObServerProber::update_probe_interval, false, ET_PROBE))) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("fail to create and start server probe task", K(ret));
+  } else {
+    LOG_INFO("succ to start server probe task", K(interval_us));
+  }
+  return ret;
+}
+
+int ObServerProber::do_probe_task()
+{
+  int ret = OB_SUCCESS;
+  ObProxyConfig &config = get_global_proxy_config();
+  ObServerProber &prober = get_global_server_prober();
+  if (config.enable_server_probe) {
+    if (OB_FAIL(prober.collect_entries())) {
+      LOG_WARN("fail to collect servers to probe", K(ret));
+    } else if (!prober.entries_.empty()) {
+      const int64_t probe_count = std::min(prober.entries_.count(),
+                                           std::min(static_cast<int64_t>(config.server_probe_max_count_per_round),
+                                                    MAX_PROBE_COUNT_PER_ROUND));
+      if (OB_FAIL(prober.probe_servers(probe_count, config.server_probe_timeout))) {
+        LOG_WARN("fail to probe servers", K(probe_count), K(ret));
+      }
+      prober.finish_probes(probe_count, config.server_probe_failure_threshold);
+    }
+  }
+  update_probe_interval();
+  return ret;
+}
+
+void ObServerProber::update_probe_interval()
+{
+  ObAsyncCommonTask *cont = get_global_server_prober().get_probe_cont();
+  if (OB_LIKELY(NULL != cont)) {
+    // jitter, so the probes of many proxies do not arrive at the same time
+    const int64_t interval_us = get_global_proxy_config().server_probe_interval;
+    cont->set_interval(interval_us / 2 + ObRandomNumUtils::get_random_half_to_full(interval_us));
+  }
+}
+
+int ObServerProber::collect_entries()
+{
+  int ret = OB_SUCCESS;
+  ObSEArray<ObClusterResource *, 8> cr_array;
+  ObResourcePoolProcessor &rp_processor = get_global_resource_pool_processor();
+  if (OB_FAIL(rp_processor.acquire_all_avail_cluster_resource(cr_array))) {
+    LOG_WARN("fail to acquire all cluster resource", K(ret));
+  } else {
+    ObEThread *ethread = this_ethread();
+    ObCongestionEntry *entry = NULL;
+    Iter it;
+    for (int64_t i = 0; OB_SUCC(ret) && i < cr_array.count(); ++i) {
+      ObCongestionManager &cm = cr_array.at(i)->congestion_manager_;
+      for (int64_t bucket = 0; OB_SUCC(ret) && bucket < cm.get_sub_part_count(); ++bucket) {
+        // skip the busy buckets, they will be probed in the next rounds
+        MUTEX_TRY_LOCK(lock_bucket, cm.lock_for_key(bucket), ethread);
+        if (lock_bucket.is_locked()) {
+          entry = cm.first_entry(bucket, it);
+          while (OB_SUCC(ret) && NULL != entry) {
+            // servers known dead from the server table need no probe
+            if (entry->is_entry_avail()
+                && (ObCongestionEntry::ACTIVE == entry->server_state_
+                    || ObCongestionEntry::ACTIVE_CONGESTED == entry->server_state_)) {
+              entry->inc_ref();
+              if (OB_FAIL(entries_.push_back(entry))) {
+                LOG_WARN("fail to push back congestion entry", K(ret));
+                entry->dec_ref();
+              }
+            }
+            entry = cm.next_entry(bucket, it);
+          }
+        }
+      }
+    }
+  }
+  for (int64_t i = 0; i < cr_array.count(); ++i) {
+    rp_processor.release_cluster_resource(cr_array.at(i));
+  }
+  return ret;
+}
+
+void ObServerProber::start_probe(ObProbeItem &item)
+{
+  int ret = OB_SUCCESS;
+  ObNetVCOptions options;
+  options.f_blocking_connect_ = false;
+  options.f_blocking_ = false;
+  item.state_ = PROBE_CONNECTING;
+  if (OB_FAIL(item.con_.open(options))) {
+    // such as running out of fds, nothing to do with the server
+    LOG_WARN("fail to open probe connection", K(ret));
+    item.state_ = PROBE_LOCAL_FAIL;
+  } else if (OB_FAIL(item.con_.connect(*item.entry_->get_ip(), options))) {
+    LOG_DEBUG("fail to connect server", "server", item.entry_->server_ip_, K(ret));
+    item.state_ = PROBE_FAIL;
+  }
+}
+
+void ObServerProber::handle_probe_event(ObProbeItem &item, const int16_t revents)
+{
+  int ret = OB_SUCCESS;
+  if (PROBE_CONNECTING == item.state_) {
+    int32_t optval = -1;
+    int32_t optlen = sizeof(int32_t);
+    if (OB_FAIL(ObSocketManager::getsockopt(item.con_.fd_, SOL_SOCKET, SO_ERROR,
+                                            reinterpret_cast<void *>(&optval), &optlen))) {
+      LOG_WARN("fail to get probe connection error", K(ret));
+      item.state_ = PROBE_LOCAL_FAIL;
+    } else if (0 != optval) {
+      // refused or unreachable
+      item.state_ = PROBE_FAIL;
+    } else if (revents & POLLOUT) {
+      item.state_ = PROBE_WAIT_HANDSHAKE;
+    }
+  } else if (PROBE_WAIT_HANDSHAKE == item.state_) {
+    // the server sends the handshake packet, or an error packet when it is
+    // overloaded, right after accepting the connection
+    char buf[64];
+    int64_t count = 0;
+    if (OB_FAIL(ObSocketManager::read(item.con_.fd_, buf, sizeof(buf), count))) {
+      if (OB_SYS_EAGAIN != ret) {
+        item.state_ = PROBE_FAIL;
+      }
+    } else {
+      item.state_ = (count > 0 ? PROBE_SUCC : PROBE_FAIL);
+    }
+  }
+}
+
+int ObServerProber::probe_servers(const int64_t probe_count, const int64_t timeout_us)
+{
+  int ret = OB_SUCCESS;
+  const int64_t entry_count = entries_.count();
+  for (int64_t i = 0; i < probe_count; ++i) {
+    items_[i].entry_ = entries_.at((next_entry_idx_ + i) % entry_count);
+    start_probe(items_[i]);
+  }
+  next_entry_idx_ = (next_entry_idx_ + probe_count) % entry_count;
+
+  struct pollfd poll_fds[MAX_PROBE_COUNT_PER_ROUND];
+  int64_t poll_items[MAX_PROBE_COUNT_PER_ROUND];
+  const int64_t deadline = ObTimeUtility::current_time() + timeout_us;
+  bool is_done = false;
+  while (OB_SUCC(ret) && !is_done) {
+    int64_t poll_count = 0;
+    for (int64_t i = 0; i < probe_count; ++i) {
+      if (PROBE_CONNECTING == items_[i].state_ || PROBE_WAIT_HANDSHAKE == items_[i].state_) {
+        poll_fds[poll_count].fd = items_[i].con_.fd_;
+        poll_fds[poll_count].events = static_cast<int16_t>(
+            PROBE_CONNECTING == items_[i].state_ ? (POLLOUT | POLLERR) : (POLLIN | POLLERR));
+        poll_fds[poll_count].revents = 0;
+        poll_items[poll_count] = i;
+        ++poll_count;
+      }
+    }
+    const int64_t remain_ms = (deadline - ObTimeUtility::current_time()) / 1000;
+    int64_t event_count = 0;
+    if (0 == poll_count || remain_ms <= 0) {
+      is_done = true;
+    } else if (OB_FAIL(ObSocketManager::poll(poll_fds, poll_count, static_cast<int>(remain_ms), event_count))) {
+      // poll is retried on EINTR inside, the pending probes are not the servers' fault
+      LOG_WARN("fail to poll probe connections", K(poll_count), K(ret));
+      for (int64_t i = 0; i < poll_count; ++i) {
+        items_[poll_items[i]].state_ = PROBE_LOCAL_FAIL;
+      }
+    } else {
+      for (int64_t i = 0; i < poll_count; ++i) {
+        if (0 != poll_fds[i].revents) {
+          handle_probe_event(items_[poll_items[i]], poll_fds[i].revents);
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+void ObServerProber::finish_probes(const int64_t probe_count, const int64_t failure_threshold)
+{
+  for (int64_t i = 0; i < probe_count; ++i) {
+    ObProbeItem &item = items_[i];
+    if (PROBE_SUCC == item.state_) {
+      item.entry_->set_probe_succeed();
+    } else if (PROBE_LOCAL_FAIL != item.state_) {
+      // not answered in time is a failure too
+      item.entry_->set_probe_failed(failure_threshold);
+    }
+    (void)item.con_.close();
+    item.entry_ = NULL;
+    item.state_ = PROBE_FAIL;
+  }
+  for (int64_t i = 0; i < entries_.count(); ++i) {
+    entries_.at(i)->dec_ref();
+  }
+  entries_.reuse();
+}
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_SERVER_PROBER_H
+#define OBPROXY_SERVER_PROBER_H
+
+#include "lib/container/ob_se_array.h"
+#include "iocore/eventsystem/ob_event.h"
+#include "iocore/net/ob_connection.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+class ObAsyncCommonTask;
+struct ObCongestionEntry;
+
+extern event::ObEventThreadType ET_PROBE;
+
+/*
+ * Probes the alive servers in the congestion managers of all clusters off the
+ * request path, on a thread of its own. A probe connects to the server and
+ * waits for its mysql handshake packet, all the probes of one round are done
+ * in parallel by one poll. Servers which fail server_probe_failure_threshold
+ * probes in a row are set dead congested before any user request hits them,
+ * and set free again by the first succeeded probe.
+ */
+class ObServerProber
+{
+public:
+  static const int64_t MAX_PROBE_COUNT_PER_ROUND = 1024;
+
+  ObServerProber();
+  ~ObServerProber() { destroy(); }
+  void destroy();
+
+  // the probe thread is spawned only when enable_server_probe is first turned on,
+  // called at startup and on every config reload
+  int start_if_enabled();
+  static int do_probe_task();
+  static void update_probe_interval();
+  ObAsyncCommonTask *get_probe_cont() { return probe_cont_; }
+
+private:
+  enum ObProbeState
+  {
+    PROBE_CONNECTING = 0,
+    PROBE_WAIT_HANDSHAKE,
+    PROBE_SUCC,
+    PROBE_FAIL,
+    // the probe could not be done for errors of proxy itself, no verdict
+    PROBE_LOCAL_FAIL,
+  };
+
+  struct ObProbeItem
+  {
+    ObProbeItem() : entry_(NULL), con_(), state_(PROBE_FAIL) {}
+
+    ObCongestionEntry *entry_;
+    net::ObConnection con_;
+    ObProbeState state_;
+  };
+
+  int start();
+  int collect_entries();
+  int probe_servers(const int64_t probe_count, const int64_t timeout_us);
+  void start_probe(ObProbeItem &item);
+  void handle_probe_event(ObProbeItem &item, const int16_t revents);
+  void finish_probes(const int64_t probe_count, const int64_t failure_threshold);
+
+private:
+  ObAsyncCommonTask *probe_cont_;
+  bool is_starting_;
+  bool is_thread_spawned_;
+  // round robin over all the servers when they can not be probed in one round
+  int64_t next_entry_idx_;
+  common::ObSEArray<ObCongestionEntry *, 64> entries_;
+  ObProbeItem items_[MAX_PROBE_COUNT_PER_ROUND];
+
+  DISALLOW_COPY_AND_ASSIGN(ObServerProber);
+};
+
+extern ObServerProber g_server_prober;
+inline ObServerProber &get_global_server_prober()
+{
+  return g_server_prober;
+}
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+#endif // OBPROXY_SERVER_PROBER_H
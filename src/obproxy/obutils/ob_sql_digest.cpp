@@ -0,0 +1,619 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "obutils/ob_sql_digest.h"
+#include <algorithm>
+#include "lib/allocator/ob_malloc.h"
+#include "lib/time/ob_time_utility.h"
+
+using namespace oceanbase::common;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+
+// FNV-1a, fed char by char while normalizing
+static const uint64_t FINGERPRINT_HASH_BASIS = 14695981039346656037UL;
+static const uint64_t FINGERPRINT_HASH_PRIME = 1099511628211UL;
+
+class ObFingerprintWriter
+{
+public:
+  ObFingerprintWriter(char *buf, const int64_t buf_len)
+    : buf_(buf), buf_len_(buf_len), pos_(0), hash_(FINGERPRINT_HASH_BASIS),
+      last_char_('\0'), prev_char_('\0'), has_pending_space_(false), has_pending_comma_(false),
+      is_last_param_(false), is_last_param_row_(false), row_state_(ROW_NONE) {}
+
+  void put_space()
+  {
+    // spaces only matter after a word
+    if (ROW_NONE == row_state_ || ROW_PARAM == row_state_) {
+      has_pending_space_ = true;
+    }
+  }
+  void put_char(const char c)
+  {
+    flush_row();
+    if (has_pending_comma_) {
+      has_pending_comma_ = false;
+      has_pending_space_ = false;
+      write(',');
+    }
+    if (has_pending_space_) {
+      has_pending_space_ = false;
+      // only words need a space between them
+      if (is_word_char(last_char_) && is_word_char(c)) {
+        write(' ');
+      }
+    }
+    write(c);
+    is_last_param_ = false;
+    is_last_param_row_ = false;
+  }
+  void put_comma()
+  {
+    if (ROW_PARAM == row_state_ || (is_last_param_ && !has_pending_comma_)) {
+      // wait for the next token, to fold the literal list
+      has_pending_comma_ = true;
+    } else if (ROW_NONE == row_state_ && is_last_param_row_) {
+      // wait for the next row, to fold the literal rows
+      row_state_ = ROW_COMMA;
+    } else {
+      put_char(',');
+    }
+  }
+  void put_open()
+  {
+    if (ROW_COMMA == row_state_) {
+      row_state_ = ROW_OPEN;
+    } else {
+      put_char('(');
+    }
+  }
+  void put_close()
+  {
+    if (ROW_PARAM == row_state_ && !has_pending_comma_) {
+      // the same as the last row, "(?),(?)" is folded into "(?)"
+      row_state_ = ROW_NONE;
+      has_pending_space_ = false;
+    } else {
+      const bool is_param_row = ROW_NONE == row_state_ && is_last_param_ && !has_pending_comma_ && '(' == prev_char_;
+      put_char(')');
+      is_last_param_row_ = is_param_row;
+    }
+  }
+  void put_param()
+  {
+    if (ROW_OPEN == row_state_) {
+      row_state_ = ROW_PARAM;
+    } else if (has_pending_comma_) {
+      // "?,?" is folded into "?"
+      has_pending_comma_ = false;
+      has_pending_space_ = false;
+    } else if (ROW_PARAM == row_state_) {
+      // already held
+    } else if (!is_last_param_) {
+      put_char('?');
+      is_last_param_ = true;
+    }
+  }
+  // whether a '-' here is the sign of a literal, not a minus operator
+  bool is_operand_expected() const
+  {
+    return has_pending_comma_
+           || ROW_COMMA == row_state_ || ROW_OPEN == row_state_
+           || (ROW_NONE == row_state_ && !is_word_char(last_char_) && ')' != last_char_);
+  }
+  void finish()
+  {
+    flush_row();
+    if (has_pending_comma_) {
+      has_pending_comma_ = false;
+      write(',');
+    }
+    if (buf_len_ > 0) {
+      buf_[pos_] = '\0';
+    }
+  }
+  int64_t get_length() const { return pos_; }
+  uint64_t get_hash() const { return hash_; }
+
+  static bool is_ident_char(const char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+           || '_' == c || '$' == c || static_cast<unsigned char>(c) >= 0x80;
+  }
+  static bool is_word_char(const char c) { return is_ident_char(c) || '?' == c || '`' == c || '"' == c; }
+
+private:
+  // a row after a literal row, held until it turns out to be a literal row too
+  enum ObRowState
+  {
+    ROW_NONE = 0,
+    ROW_COMMA,    // ","
+    ROW_OPEN,     // ",("
+    ROW_PARAM,    // ",(?"
+  };
+
+  // the row is not a literal row, write what has been held
+  void flush_row()
+  {
+    if (ROW_NONE != row_state_) {
+      const ObRowState row_state = row_state_;
+      row_state_ = ROW_NONE;
+      write(',');
+      if (ROW_COMMA != row_state) {
+        write('(');
+        is_last_param_ = false;
+        if (ROW_PARAM == row_state) {
+          write('?');
+          is_last_param_ = true;
+        }
+      }
+      is_last_param_row_ = false;
+    }
+  }
+  void write(const char c)
+  {
+    hash_ = (hash_ ^ static_cast<unsigned char>(c)) * FINGERPRINT_HASH_PRIME;
+    if (pos_ < buf_len_ - 1) {
+      buf_[pos_++] = c;
+    }
+    prev_char_ = last_char_;
+    last_char_ = c;
+  }
+
+private:
+  char *buf_;
+  const int64_t buf_len_;
+  int64_t pos_;
+  uint64_t hash_;
+  char last_char_;
+  char prev_char_;
+  bool has_pending_space_;
+  bool has_pending_comma_;
+  bool is_last_param_;
+  // the last written is a row of literals, "(?)"
+  bool is_last_param_row_;
+  ObRowState row_state_;
+};
+
+static inline bool is_space_char(const char c)
+{
+  return ' ' == c || '\t' == c || '\n' == c || '\r' == c || '\f' == c;
+}
+
+static inline bool is_number_start(const char *pos, const char *end)
+{
+  return (pos[0] >= '0' && pos[0] <= '9') || ('.' == pos[0] && pos + 1 < end && pos[1] >= '0' && pos[1] <= '9');
+}
+
+uint64_t ObSqlFingerprint::calc(const ObString &sql, const bool is_ansi_quotes,
+                                char *buf, const int64_t buf_len, int64_t &length)
+{
+  ObFingerprintWriter writer(buf, buf_len);
+  const char *pos = sql.ptr();
+  const char *end = sql.ptr() + std::min(static_cast<int64_t>(sql.length()), MAX_SCAN_LENGTH);
+  while (NULL != pos && pos < end) {
+    const char c = *pos;
+    if (is_space_char(c)) {
+      writer.put_space();
+      ++pos;
+    } else if ('/' == c && pos + 1 < end && '*' == pos[1]) {
+      // comment and hint
+      pos += 2;
+      while (pos < end && !('*' == pos[0] && pos + 1 < end && '/' == pos[1])) {
+        ++pos;
+      }
+      pos = (pos < end) ? pos + 2 : end;
+      writer.put_space();
+    } else if ('#' == c || ('-' == c && pos + 1 < end && '-' == pos[1]
+                            && (pos + 2 == end || ' ' == pos[2] || '\t' == pos[2]))) {
+      while (pos < end && '\n' != *pos) {
+        ++pos;
+      }
+      writer.put_space();
+    } else if ('\'' == c || ('"' == c && !is_ansi_quotes)) {
+      // string literal, with backslash escape and doubled quote
+      ++pos;
+      while (pos < end) {
+        if ('\\' == *pos) {
+          pos += 2;
+        } else if (c == *pos) {
+          if (pos + 1 < end && c == pos[1]) {
+            pos += 2;
+          } else {
+            ++pos;
+            break;
+          }
+        } else {
+          ++pos;
+        }
+      }
+      pos = std::min(pos, end);
+      writer.put_param();
+    } else if ('`' == c || '"' == c) {
+      // quoted identifier is kept as it is
+      writer.put_char(c);
+      ++pos;
+      while (pos < end && c != *pos) {
+        writer.put_char(*pos);
+        ++pos;
+      }
+      if (pos < end) {
+        writer.put_char(c);
+        ++pos;
+      }
+    } else if ('-' == c && writer.is_operand_expected()) {
+      // "-1" is the same as "1", keep the minus if a literal does not follow
+      const char *next = pos + 1;
+      while (next < end && is_space_char(*next)) {
+        ++next;
+      }
+      if (next < end && is_number_start(next, end)) {
+        pos = next;
+      } else {
+        writer.put_char(c);
+        ++pos;
+      }
+    } else if (is_number_start(pos, end)) {
+      // number, hex and float included
+      ++pos;
+      while (pos < end && (ObFingerprintWriter::is_ident_char(*pos) || '.' == *pos
+                           || (('+' == *pos || '-' == *pos) && ('e' == pos[-1] || 'E' == pos[-1])))) {
+        ++pos;
+      }
+      writer.put_param();
+    } else if ('?' == c) {
+      writer.put_param();
+      ++pos;
+    } else if (ObFingerprintWriter::is_ident_char(c)) {
+      while (pos < end && ObFingerprintWriter::is_ident_char(*pos)) {
+        const char word_char = *pos;
+        writer.put_char((word_char >= 'A' && word_char <= 'Z') ? static_cast<char>(word_char + ('a' - 'A')) : word_char);
+        ++pos;
+      }
+    } else if (',' == c) {
+      writer.put_comma();
+      ++pos;
+    } else if ('(' == c) {
+      writer.put_open();
+      ++pos;
+    } else if (')' == c) {
+      writer.put_close();
+      ++pos;
+    } else if (';' == c) {
+      // the ending semicolon means nothing
+      ++pos;
+    } else {
+      writer.put_char(c);
+      ++pos;
+    }
+  }
+  writer.finish();
+  length = writer.get_length();
+  return writer.get_hash();
+}
+
+int ObSqlDigestPartition::init(const int64_t capacity)
+{
+  int ret = OB_SUCCESS;
+  const int64_t bucket_count = capacity * 2;
+  if (OB_UNLIKELY(capacity <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(capacity), K(ret));
+  } else if (OB_ISNULL(items_ = static_cast<ObSqlDigestItem *>(
+                                  ob_malloc(sizeof(ObSqlDigestItem) * capacity, ObModIds::OB_PROXY_STAT)))
+             || OB_ISNULL(buckets_ = static_cast<int32_t *>(
+                                       ob_malloc(sizeof(int32_t) * bucket_count, ObModIds::OB_PROXY_STAT)))
+             || OB_ISNULL(heap_ = static_cast<int32_t *>(
+                                    ob_malloc(sizeof(int32_t) * capacity, ObModIds::OB_PROXY_STAT)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc mem for sql digest partition", K(capacity), K(ret));
+    destroy();
+  } else {
+    for (int64_t i = 0; i < bucket_count; ++i) {
+      buckets_[i] = -1;
+    }
+    capacity_ = static_cast<int32_t>(capacity);
+    bucket_count_ = static_cast<int32_t>(bucket_count);
+    count_ = 0;
+  }
+  return ret;
+}
+
+void ObSqlDigestPartition::destroy()
+{
+  if (NULL != items_) {
+    ob_free(items_);
+    items_ = NULL;
+  }
+  if (NULL != buckets_) {
+    ob_free(buckets_);
+    buckets_ = NULL;
+  }
+  if (NULL != heap_) {
+    ob_free(heap_);
+    heap_ = NULL;
+  }
+  capacity_ = 0;
+  bucket_count_ = 0;
+  count_ = 0;
+}
+
+int32_t ObSqlDigestPartition::find_item(const uint64_t hash, const ObString &tenant_name,
+                                        const ObString &database_name) const
+{
+  int32_t idx = buckets_[hash % bucket_count_];
+  while (idx >= 0
+         && !(items_[idx].hash_ == hash
+              && items_[idx].get_tenant_name() == tenant_name
+              && items_[idx].get_database_name() == database_name)) {
+    idx = items_[idx].next_;
+  }
+  return idx;
+}
+
+void ObSqlDigestPartition::link_item(const int32_t idx)
+{
+  int32_t &head = buckets_[items_[idx].hash_ % bucket_count_];
+  items_[idx].next_ = head;
+  head = idx;
+}
+
+void ObSqlDigestPartition::unlink_item(const int32_t idx)
+{
+  int32_t *cur = &buckets_[items_[idx].hash_ % bucket_count_];
+  while (*cur >= 0 && *cur != idx) {
+    cur = &items_[*cur].next_;
+  }
+  if (*cur == idx) {
+    *cur = items_[idx].next_;
+  }
+  items_[idx].next_ = -1;
+}
+
+void ObSqlDigestPartition::swap_heap(const int32_t pos1, const int32_t pos2)
+{
+  const int32_t idx = heap_[pos1];
+  heap_[pos1] = heap_[pos2];
+  heap_[pos2] = idx;
+  items_[heap_[pos1]].heap_pos_ = pos1;
+  items_[heap_[pos2]].heap_pos_ = pos2;
+}
+
+void ObSqlDigestPartition::sift_up(int32_t pos)
+{
+  while (pos > 0) {
+    const int32_t parent = (pos - 1) / 2;
+    if (items_[heap_[parent]].weight_ <= items_[heap_[pos]].weight_) {
+      break;
+    }
+    swap_heap(parent, pos);
+    pos = parent;
+  }
+}
+
+void ObSqlDigestPartition::sift_down(int32_t pos)
+{
+  while (true) {
+    int32_t min_pos = pos;
+    const int32_t left = pos * 2 + 1;
+    const int32_t right = left + 1;
+    if (left < count_ && items_[heap_[left]].weight_ < items_[heap_[min_pos]].weight_) {
+      min_pos = left;
+    }
+    if (right < count_ && items_[heap_[right]].weight_ < items_[heap_[min_pos]].weight_) {
+      min_pos = right;
+    }
+    if (min_pos == pos) {
+      break;
+    }
+    swap_heap(pos, min_pos);
+    pos = min_pos;
+  }
+}
+
+void ObSqlDigestPartition::record(const uint64_t hash, const ObString &fingerprint,
+                                  const ObString &tenant_name, const ObString &database_name,
+                                  const ObSqlDigestStat &stat)
+{
+  // weight by time, so both the frequent and the slow fingerprints stay
+  const int64_t weight = stat.total_time_us_ + 1;
+  const int64_t now = ObTimeUtility::current_time();
+  ObSpinLockGuard guard(lock_);
+  if (OB_LIKELY(NULL != items_)) {
+    int32_t idx = find_item(hash, tenant_name, database_name);
+    if (idx < 0) {
+      int64_t inherit_weight = 0;
+      if (count_ < capacity_) {
+        idx = count_;
+        heap_[count_] = idx;
+        items_[idx].reset();
+        items_[idx].heap_pos_ = count_;
+        ++count_;
+      } else {
+        // replace the least one
+        idx = heap_[0];
+        inherit_weight = items_[idx].weight_;
+        unlink_item(idx);
+        const int32_t heap_pos = items_[idx].heap_pos_;
+        items_[idx].reset();
+        items_[idx].heap_pos_ = heap_pos;
+      }
+      ObSqlDigestItem &item = items_[idx];
+      item.hash_ = hash;
+      item.weight_ = inherit_weight;
+      item.weight_error_ = inherit_weight;
+      item.first_seen_time_ = now;
+      item.fingerprint_len_ = static_cast<int32_t>(std::min(static_cast<int64_t>(fingerprint.length()),
+                                                            ObSqlFingerprint::MAX_FINGERPRINT_LENGTH));
+      item.tenant_name_len_ = static_cast<int32_t>(std::min(static_cast<int64_t>(tenant_name.length()),
+                                                            OB_MAX_TENANT_NAME_LENGTH));
+      item.database_name_len_ = static_cast<int32_t>(std::min(static_cast<int64_t>(database_name.length()),
+                                                              OB_MAX_DATABASE_NAME_LENGTH));
+      MEMCPY(item.fingerprint_, fingerprint.ptr(), item.fingerprint_len_);
+      MEMCPY(item.tenant_name_, tenant_name.ptr(), item.tenant_name_len_);
+      MEMCPY(item.database_name_, database_name.ptr(), item.database_name_len_);
+      link_item(idx);
+    }
+
+    ObSqlDigestItem &item = items_[idx];
+    item.weight_ += weight;
+    item.last_seen_time_ = now;
+    item.stat_.exec_count_ += stat.exec_count_;
+    item.stat_.error_count_ += stat.error_count_;
+    item.stat_.route_miss_count_ += stat.route_miss_count_;
+    item.stat_.total_time_us_ += stat.total_time_us_;
+    item.stat_.server_time_us_ += stat.server_time_us_;
+    item.stat_.request_bytes_ += stat.request_bytes_;
+    item.stat_.response_bytes_ += stat.response_bytes_;
+    if (stat.max_time_us_ > item.stat_.max_time_us_) {
+      item.stat_.max_time_us_ = stat.max_time_us_;
+    }
+    // new item is added as a leaf, others only grow
+    sift_up(item.heap_pos_);
+    sift_down(item.heap_pos_);
+  }
+}
+
+int64_t ObSqlDigestPartition::copy_items(ObSqlDigestItem *items, const int64_t max_count)
+{
+  int64_t copy_count = 0;
+  ObSpinLockGuard guard(lock_);
+  for (int32_t i = 0; i < count_ && copy_count < max_count; ++i) {
+    items[copy_count++] = items_[i];
+  }
+  return copy_count;
+}
+
+bool ObSqlDigestPartition::export_item(ObSqlDigestItem &item)
+{
+  bool bret = false;
+  ObSpinLockGuard guard(lock_);
+  const int32_t idx = (NULL == items_) ? -1 : find_item(item.hash_, item.get_tenant_name(), item.get_database_name());
+  if (idx >= 0 && items_[idx].stat_.exec_count_ != items_[idx].exported_stat_.exec_count_) {
+    ObSqlDigestItem &cur_item = items_[idx];
+    item.stat_ = cur_item.stat_;
+    item.stat_.exec_count_ -= cur_item.exported_stat_.exec_count_;
+    item.stat_.error_count_ -= cur_item.exported_stat_.error_count_;
+    item.stat_.route_miss_count_ -= cur_item.exported_stat_.route_miss_count_;
+    item.stat_.total_time_us_ -= cur_item.exported_stat_.total_time_us_;
+    item.stat_.server_time_us_ -= cur_item.exported_stat_.server_time_us_;
+    item.stat_.request_bytes_ -= cur_item.exported_stat_.request_bytes_;
+    item.stat_.response_bytes_ -= cur_item.exported_stat_.response_bytes_;
+    cur_item.exported_stat_ = cur_item.stat_;
+    bret = true;
+  }
+  return bret;
+}
+
+ObSqlDigestTable &get_global_sql_digest_table()
+{
+  static ObSqlDigestTable g_sql_digest_table;
+  return g_sql_digest_table;
+}
+
+int ObSqlDigestTable::init(const int64_t item_limit)
+{
+  int ret = OB_SUCCESS;
+  const int64_t partition_capacity = (item_limit + PARTITION_COUNT - 1) / PARTITION_COUNT;
+  if (OB_UNLIKELY(is_inited_)) {
+    ret = OB_INIT_TWICE;
+    LOG_WARN("sql digest table init twice", K(ret));
+  } else if (OB_UNLIKELY(item_limit <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(item_limit), K(ret));
+  } else {
+    for (int64_t i = 0; OB_SUCC(ret) && i < PARTITION_COUNT; ++i) {
+      if (OB_FAIL(partitions_[i].init(partition_capacity))) {
+        LOG_WARN("fail to init sql digest partition", K(i), K(partition_capacity), K(ret));
+      }
+    }
+    if (OB_SUCC(ret)) {
+      item_limit_ = partition_capacity * PARTITION_COUNT;
+      is_inited_ = true;
+      LOG_INFO("succ to init sql digest table", K_(item_limit), "item_size", sizeof(ObSqlDigestItem));
+    } else {
+      destroy();
+    }
+  }
+  return ret;
+}
+
+void ObSqlDigestTable::destroy()
+{
+  for (int64_t i = 0; i < PARTITION_COUNT; ++i) {
+    partitions_[i].destroy();
+  }
+  item_limit_ = 0;
+  is_inited_ = false;
+}
+
+void ObSqlDigestTable::record(const ObString &sql, const bool is_ansi_quotes, const ObString &tenant_name,
+                              const ObString &database_name, const ObSqlDigestStat &stat)
+{
+  if (OB_LIKELY(is_inited_) && !sql.empty()) {
+    char fingerprint_buf[ObSqlFingerprint::MAX_FINGERPRINT_LENGTH];
+    int64_t fingerprint_len = 0;
+    uint64_t hash = ObSqlFingerprint::calc(sql, is_ansi_quotes, fingerprint_buf,
+                                           ObSqlFingerprint::MAX_FINGERPRINT_LENGTH, fingerprint_len);
+    hash = database_name.hash(tenant_name.hash(hash));
+    ObString fingerprint(fingerprint_len, fingerprint_buf);
+    // partition by the high bits, chains by the low bits
+    partitions_[(hash >> 32) % PARTITION_COUNT].record(hash, fingerprint, tenant_name, database_name, stat);
+  }
+}
+
+struct ObSqlDigestWeightCmp
+{
+  bool operator()(const ObSqlDigestItem &left, const ObSqlDigestItem &right) const
+  {
+    return left.weight_ > right.weight_;
+  }
+};
+
+int64_t ObSqlDigestTable::copy_items(ObSqlDigestItem *items, const int64_t top_count, const bool is_export)
+{
+  int64_t count = 0;
+  if (is_inited_ && NULL != items && top_count > 0) {
+    for (int64_t i = 0; i < PARTITION_COUNT; ++i) {
+      count += partitions_[i].copy_items(items + count, item_limit_ - count);
+    }
+    if (count > top_count) {
+      std::nth_element(items, items + top_count - 1, items + count, ObSqlDigestWeightCmp());
+      count = top_count;
+    }
+    if (is_export) {
+      int64_t export_count = 0;
+      for (int64_t i = 0; i < count; ++i) {
+        if (partitions_[(items[i].hash_ >> 32) % PARTITION_COUNT].export_item(items[i])) {
+          if (export_count != i) {
+            items[export_count] = items[i];
+          }
+          ++export_count;
+        }
+      }
+      count = export_count;
+    }
+  }
+  return count;
+}
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_SQL_DIGEST_H
+#define OBPROXY_SQL_DIGEST_H
+
+#include "lib/string/ob_string.h"
+#include "lib/lock/ob_spin_lock.h"
+#include "lib/utility/ob_print_utils.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace obutils
+{
+
+class ObSqlFingerprint
+{
+public:
+  static const int64_t MAX_FINGERPRINT_LENGTH = 256;
+  // longer sql is identified by its head
+  static const int64_t MAX_SCAN_LENGTH = 64 * 1024;
+
+  // Normalize @sql into its fingerprint: comments removed, spaces collapsed,
+  // identifiers and keywords lower cased, literals and their leading minus
+  // replaced with '?', literal lists like "in (1, 2, 3)" folded into "in(?)"
+  // and literal rows like "values (1, 2), (3, 4)" folded into "values(?)".
+  // With @is_ansi_quotes, as in oracle mode or sql_mode ANSI_QUOTES, "..." is
+  // an identifier and kept as it is, else a string literal.
+  // The returned hash covers the whole fingerprint, @buf only keeps its head.
+  static uint64_t calc(const common::ObString &sql, const bool is_ansi_quotes,
+                       char *buf, const int64_t buf_len, int64_t &length);
+};
+
+struct ObSqlDigestStat
+{
+  ObSqlDigestStat() { reset(); }
+  void reset() { MEMSET(this, 0, sizeof(ObSqlDigestStat)); }
+
+  int64_t exec_count_;
+  int64_t error_count_;
+  int64_t route_miss_count_;
+  int64_t total_time_us_;
+  int64_t max_time_us_;
+  int64_t server_time_us_;
+  int64_t request_bytes_;
+  int64_t response_bytes_;
+
+  TO_STRING_KV(K_(exec_count), K_(error_count), K_(route_miss_count), K_(total_time_us),
+               K_(max_time_us), K_(server_time_us), K_(request_bytes), K_(response_bytes));
+};
+
+struct ObSqlDigestItem
+{
+  ObSqlDigestItem() { reset(); }
+  void reset() { MEMSET(this, 0, sizeof(ObSqlDigestItem)); }
+
+  common::ObString get_fingerprint() const { return common::ObString(fingerprint_len_, fingerprint_); }
+  common::ObString get_tenant_name() const { return common::ObString(tenant_name_len_, tenant_name_); }
+  common::ObString get_database_name() const { return common::ObString(database_name_len_, database_name_); }
+
+  TO_STRING_KV(K_(hash), K_(weight), K_(weight_error), "tenant_name", get_tenant_name(),
+               "database_name", get_database_name(), "fingerprint", get_fingerprint(), K_(stat));
+
+  uint64_t hash_;
+  // space saving counter, total time in us, over estimated by at most weight_error_
+  int64_t weight_;
+  int64_t weight_error_;
+  int64_t first_seen_time_;
+  int64_t last_seen_time_;
+  int32_t next_;
+  int32_t heap_pos_;
+  int32_t fingerprint_len_;
+  int32_t tenant_name_len_;
+  int32_t database_name_len_;
+  char fingerprint_[ObSqlFingerprint::MAX_FINGERPRINT_LENGTH];
+  char tenant_name_[common::OB_MAX_TENANT_NAME_LENGTH];
+  char database_name_[common::OB_MAX_DATABASE_NAME_LENGTH];
+  ObSqlDigestStat stat_;
+  // what prometheus sync task has exported
+  ObSqlDigestStat exported_stat_;
+};
+
+/*
+ * Fingerprint statistics of one partition, bounded by space saving: when it
+ * is full, the item with the least weight is replaced by the new fingerprint,
+ * which inherits the weight, so the heavy fingerprints always stay.
+ */
+class ObSqlDigestPartition
+{
+public:
+  ObSqlDigestPartition()
+    : lock_(), capacity_(0), count_(0), bucket_count_(0), items_(NULL), buckets_(NULL), heap_(NULL) {}
+  ~ObSqlDigestPartition() { destroy(); }
+
+  int init(const int64_t capacity);
+  void destroy();
+
+  void record(const uint64_t hash, const common::ObString &fingerprint,
+              const common::ObString &tenant_name, const common::ObString &database_name,
+              const ObSqlDigestStat &stat);
+  // copy at most @max_count items into @items
+  int64_t copy_items(ObSqlDigestItem *items, const int64_t max_count);
+  // turn the copied @item into its stat since last export, return false if
+  // it has not been executed since then or has been replaced
+  bool export_item(ObSqlDigestItem &item);
+
+private:
+  int32_t find_item(const uint64_t hash, const common::ObString &tenant_name,
+                    const common::ObString &database_name) const;
+  void link_item(const int32_t idx);
+  void unlink_item(const int32_t idx);
+  void sift_up(int32_t pos);
+  void sift_down(int32_t pos);
+  void swap_heap(const int32_t pos1, const int32_t pos2);
+
+private:
+  common::ObSpinLock lock_;
+  int32_t capacity_;
+  int32_t count_;
+  int32_t bucket_count_;
+  ObSqlDigestItem *items_;
+  int32_t *buckets_;
+  // min heap of item index by weight
+  int32_t *heap_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObSqlDigestPartition);
+};
+
+class ObSqlDigestTable
+{
+public:
+  static const int64_t PARTITION_COUNT = 16;
+
+  ObSqlDigestTable() : is_inited_(false), item_limit_(0) {}
+  ~ObSqlDigestTable() { destroy(); }
+
+  int init(const int64_t item_limit);
+  void destroy();
+  bool is_inited() const { return is_inited_; }
+  int64_t get_item_limit() const { return item_limit_; }
+
+  void record(const common::ObString &sql, const bool is_ansi_quotes, const common::ObString &tenant_name,
+              const common::ObString &database_name, const ObSqlDigestStat &stat);
+  // copy the @top_count heaviest items into @items, whose size is no less than
+  // item limit, for export only the ones executed since last export are kept,
+  // with the stat since then
+  int64_t copy_items(ObSqlDigestItem *items, const int64_t top_count, const bool is_export = false);
+
+private:
+  bool is_inited_;
+  int64_t item_limit_;
+  ObSqlDigestPartition partitions_[PARTITION_COUNT];
+
+  DISALLOW_COPY_AND_ASSIGN(ObSqlDigestTable);
+};
+
+ObSqlDigestTable &get_global_sql_digest_table();
+
+} // end of namespace obutils
+} // end of namespace obproxy
+} // end of namespace oceanbase
+#endif // OBPROXY_SQL_DIGEST_H
@@ -0,0 +1,587 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "opsql/func_expr_resolver/proxy_expr/ob_proxy_shard_rule_evaluator.h"
+#include "utils/ob_proxy_utils.h"
+#include "dbconfig/ob_proxy_db_config_info.h"
+
+namespace oceanbase
+{
+using namespace common;
+namespace obproxy
+{
+using namespace obutils;
+using namespace dbconfig;
+namespace opsql
+{
+
+int ObProxyShardRuleEvaluator::compile(ObProxyExpr *expr, ObIAllocator &allocator,
+                                       ObProxyShardRuleEvaluator *&evaluator)
+{
+  int ret = OB_SUCCESS;
+  void *buf = NULL;
+  ObProxyShardRuleEvaluator *tmp_evaluator = NULL;
+  evaluator = NULL;
+  if (OB_ISNULL(expr)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K(expr), K(ret));
+  } else if (OB_ISNULL(buf = allocator.alloc(sizeof(ObProxyShardRuleEvaluator)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc shard rule evaluator", K(ret));
+  } else {
+    tmp_evaluator = new (buf) ObProxyShardRuleEvaluator();
+    if (OB_FAIL(tmp_evaluator->compile_expr(expr, allocator))) {
+      LOG_DEBUG("shard rule expr can not be compiled", K(ret));
+    } else if (tmp_evaluator->column_name_.empty()) {
+      // rule without column is rare, leave it to expr
+      ret = OB_NOT_SUPPORTED;
+    } else {
+      tmp_evaluator->recognize_pattern();
+      evaluator = tmp_evaluator;
+      LOG_DEBUG("succ to compile shard rule expr", KPC(evaluator));
+    }
+
+    if (OB_FAIL(ret)) {
+      tmp_evaluator->~ObProxyShardRuleEvaluator();
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::add_op(const ObProxyShardRuleOpType type, const int64_t int_value,
+                                      const ObString &str_value)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(op_count_ >= MAX_OP_COUNT)) {
+    ret = OB_NOT_SUPPORTED;
+    LOG_DEBUG("too many ops in shard rule expr", K_(op_count), K(ret));
+  } else {
+    ObProxyShardRuleOp &op = ops_[op_count_++];
+    op.type_ = type;
+    op.int_value_ = int_value;
+    op.str_value_ = str_value;
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::compile_expr(ObProxyExpr *expr, ObIAllocator &allocator)
+{
+  int ret = OB_SUCCESS;
+  const int64_t start = op_count_;
+  if (OB_ISNULL(expr)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("expr is null, unexpected", K(ret));
+  } else {
+    switch (expr->get_expr_type()) {
+      case OB_PROXY_EXPR_TYPE_COLUMN: {
+        const ObString &column_name = static_cast<ObProxyExprColumn *>(expr)->get_column_name();
+        if (column_name_.empty()) {
+          column_name_ = column_name;
+        } else if (0 != column_name_.case_compare(column_name)) {
+          ret = OB_NOT_SUPPORTED;
+        }
+        if (OB_SUCC(ret)) {
+          ret = add_op(OP_COLUMN);
+        }
+        break;
+      }
+      case OB_PROXY_EXPR_TYPE_CONST: {
+        const ObObj &obj = static_cast<ObProxyExprConst *>(expr)->get_object();
+        if (obj.is_int()) {
+          ret = add_op(OP_INT, obj.get_int());
+        } else if (obj.is_varchar()) {
+          ret = add_op(OP_STR, 0, obj.get_varchar());
+        } else {
+          ret = OB_NOT_SUPPORTED;
+        }
+        break;
+      }
+      case OB_PROXY_EXPR_TYPE_FUNC_HASH:
+      case OB_PROXY_EXPR_TYPE_FUNC_SUBSTR:
+      case OB_PROXY_EXPR_TYPE_FUNC_TOINT:
+      case OB_PROXY_EXPR_TYPE_FUNC_DIV:
+      case OB_PROXY_EXPR_TYPE_FUNC_ADD:
+      case OB_PROXY_EXPR_TYPE_FUNC_SUB:
+      case OB_PROXY_EXPR_TYPE_FUNC_MUL: {
+        ObSEArray<ObProxyExpr *, 4> &param_array = static_cast<ObProxyFuncExpr *>(expr)->get_param_array();
+        const int64_t param_count = param_array.count();
+        ObProxyShardRuleOpType op_type = OP_INT;
+        switch (expr->get_expr_type()) {
+          case OB_PROXY_EXPR_TYPE_FUNC_HASH:
+            op_type = (1 == param_count) ? OP_HASH : OP_HASH2;
+            ret = (1 == param_count || 2 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          case OB_PROXY_EXPR_TYPE_FUNC_SUBSTR:
+            op_type = (2 == param_count) ? OP_SUBSTR2 : OP_SUBSTR3;
+            ret = (2 == param_count || 3 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          case OB_PROXY_EXPR_TYPE_FUNC_TOINT:
+            op_type = OP_TOINT;
+            ret = (1 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          case OB_PROXY_EXPR_TYPE_FUNC_DIV:
+            op_type = OP_DIV;
+            ret = (2 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          case OB_PROXY_EXPR_TYPE_FUNC_ADD:
+            op_type = OP_ADD;
+            ret = (2 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          case OB_PROXY_EXPR_TYPE_FUNC_SUB:
+            op_type = OP_SUB;
+            ret = (2 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+          default:
+            op_type = OP_MUL;
+            ret = (2 == param_count) ? OB_SUCCESS : OB_NOT_SUPPORTED;
+            break;
+        }
+
+        for (int64_t i = 0; OB_SUCC(ret) && i < param_count; ++i) {
+          ret = compile_expr(param_array.at(i), allocator);
+        }
+
+        if (OB_SUCC(ret) && OB_SUCC(add_op(op_type))) {
+          // hash depends on physic size and elastic flag, it is never folded
+          if (OP_HASH != op_type && OP_HASH2 != op_type) {
+            ret = fold_const(start, allocator);
+          }
+        }
+        break;
+      }
+      default:
+        // concat, testload, split and alias are left to expr
+        ret = OB_NOT_SUPPORTED;
+        break;
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::fold_const(const int64_t start, ObIAllocator &allocator)
+{
+  int ret = OB_SUCCESS;
+  bool is_const = true;
+  for (int64_t i = start; is_const && i < op_count_; ++i) {
+    is_const = (OP_COLUMN != ops_[i].type_);
+  }
+
+  if (is_const) {
+    ObProxyShardRuleValue stack[MAX_STACK_DEPTH];
+    int64_t depth = 0;
+    ObProxyShardRuleCalcCtx ctx(0, TESTLOAD_NON, false);
+    const int tmp_ret = execute(ops_ + start, op_count_ - start, NULL, ctx, stack, depth);
+    if (OB_NOT_SUPPORTED == tmp_ret) {
+      ret = tmp_ret;
+    } else if (OB_SUCCESS != tmp_ret || 1 != depth) {
+      // keep the ops, the same error will be returned when calc
+    } else if (stack[0].is_int_) {
+      op_count_ = start;
+      ret = add_op(OP_INT, stack[0].int_value_);
+    } else {
+      char *buf = NULL;
+      const ObString &str = stack[0].str_value_;
+      if (OB_ISNULL(buf = static_cast<char *>(allocator.alloc(str.length())))) {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+        LOG_WARN("fail to alloc const str", "len", str.length(), K(ret));
+      } else {
+        MEMCPY(buf, str.ptr(), str.length());
+        op_count_ = start;
+        ret = add_op(OP_STR, 0, ObString(str.length(), buf));
+      }
+    }
+  }
+  return ret;
+}
+
+void ObProxyShardRuleEvaluator::recognize_pattern()
+{
+  int64_t pos = 0;
+  pattern_ = PATTERN_GENERIC;
+  if (op_count_ >= 2 && OP_COLUMN == ops_[0].type_) {
+    if (OP_INT == ops_[1].type_ && op_count_ >= 3 && OP_SUBSTR2 == ops_[2].type_) {
+      substr_start_ = ops_[1].int_value_;
+      substr_len_ = -1;
+      pos = 3;
+    } else if (OP_INT == ops_[1].type_ && op_count_ >= 4 && OP_INT == ops_[2].type_
+               && ops_[2].int_value_ > 0 && OP_SUBSTR3 == ops_[3].type_) {
+      substr_start_ = ops_[1].int_value_;
+      substr_len_ = ops_[2].int_value_;
+      pos = 4;
+    } else {
+      pos = 1;
+    }
+
+    if (pos + 1 == op_count_ && OP_HASH == ops_[pos].type_) {
+      hash_num_ = -1;
+      pattern_ = (1 == pos) ? PATTERN_HASH : PATTERN_HASH_SUBSTR;
+    } else if (pos + 2 == op_count_ && OP_INT == ops_[pos].type_ && ops_[pos].int_value_ >= 0
+               && OP_HASH2 == ops_[pos + 1].type_) {
+      // negative n is left to generic program, hash_num_ -1 means physic size
+      hash_num_ = ops_[pos].int_value_;
+      pattern_ = (1 == pos) ? PATTERN_HASH : PATTERN_HASH_SUBSTR;
+    }
+  }
+}
+
+int ObProxyShardRuleEvaluator::find_column(const SqlFieldResult &sql_result, const SqlField *&field) const
+{
+  int ret = OB_SUCCESS;
+  field = NULL;
+  for (int64_t i = 0; OB_SUCC(ret) && i < sql_result.field_num_; ++i) {
+    const SqlField &tmp_field = sql_result.fields_.at(i);
+    if (0 == tmp_field.column_name_.string_.case_compare(column_name_)) {
+      if (NULL == field) {
+        field = &tmp_field;
+      } else {
+        // several conditions on rule column, leave it to expr
+        ret = OB_NOT_SUPPORTED;
+      }
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    if (NULL == field) {
+      ret = OB_EXPR_COLUMN_NOT_EXIST;
+    } else if (field->column_values_.empty()) {
+      ret = OB_NOT_SUPPORTED;
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::calc_index(const SqlFieldResult &sql_result, const ObProxyShardRuleCalcCtx &ctx,
+                                          int64_t &index) const
+{
+  int ret = OB_SUCCESS;
+  const SqlField *field = NULL;
+  if (OB_SUCC(find_column(sql_result, field))) {
+    // every value is calculated like expr does, the first one is the result
+    int64_t tmp_index = 0;
+    for (int64_t i = 0; OB_SUCC(ret) && i < field->column_values_.count(); ++i) {
+      if (OB_SUCC(calc_value(&field->column_values_.at(i), ctx, tmp_index)) && 0 == i) {
+        index = tmp_index;
+      }
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::calc_index_array(const SqlFieldResult &sql_result, const ObProxyShardRuleCalcCtx &ctx,
+                                                ObIArray<int64_t> &index_array) const
+{
+  int ret = OB_SUCCESS;
+  const SqlField *field = NULL;
+  if (OB_SUCC(find_column(sql_result, field))) {
+    int64_t index = 0;
+    for (int64_t i = 0; OB_SUCC(ret) && i < field->column_values_.count(); ++i) {
+      if (OB_FAIL(calc_value(&field->column_values_.at(i), ctx, index))) {
+        // do nothing
+      } else if (OB_FAIL(index_array.push_back(index))) {
+        LOG_WARN("fail to push back index", K(ret));
+      }
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::calc_value(const SqlColumnValue *column_value, const ObProxyShardRuleCalcCtx &ctx,
+                                          int64_t &index) const
+{
+  int ret = OB_SUCCESS;
+  if (PATTERN_HASH == pattern_) {
+    ret = calc_hash_column(*column_value, ctx, index);
+  } else if (PATTERN_HASH_SUBSTR == pattern_) {
+    ret = calc_hash_substr(*column_value, ctx, index);
+  } else {
+    ObProxyShardRuleValue stack[MAX_STACK_DEPTH];
+    int64_t depth = 0;
+    if (OB_FAIL(execute(ops_, op_count_, column_value, ctx, stack, depth))) {
+      // do nothing
+    } else if (OB_UNLIKELY(1 != depth)) {
+      ret = OB_ERR_UNEXPECTED;
+      LOG_WARN("unexpected stack depth", K(depth), K(ret));
+    } else {
+      ret = get_int(stack[0], index);
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::calc_hash_column(const SqlColumnValue &column_value,
+                                                const ObProxyShardRuleCalcCtx &ctx,
+                                                int64_t &index) const
+{
+  int ret = OB_SUCCESS;
+  const int64_t num = hash_num_ >= 0 ? hash_num_ : ctx.physic_size_;
+  if (TOKEN_INT_VAL == column_value.value_type_ && ctx.is_elastic_index_) {
+    index = column_value.column_int_value_;
+  } else if (TOKEN_INT_VAL == column_value.value_type_ && 0 != num) {
+    // integer key, the most common case
+    index = column_value.column_int_value_ % num;
+  } else {
+    ObProxyShardRuleValue value;
+    if (OB_SUCC(get_column_value(column_value, value))) {
+      ret = hash(value, num, ctx, index);
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::calc_hash_substr(const SqlColumnValue &column_value,
+                                                const ObProxyShardRuleCalcCtx &ctx,
+                                                int64_t &index) const
+{
+  int ret = OB_SUCCESS;
+  ObProxyShardRuleValue value;
+  ObString str;
+  ObString result;
+  if (OB_FAIL(get_column_value(column_value, value))) {
+    // do nothing
+  } else if (OB_FAIL(get_str(value, str))) {
+    // do nothing
+  } else if (OB_UNLIKELY(str.empty())) {
+    ret = OB_EXPR_CALC_ERROR;
+    LOG_WARN("substr first parm is emtpy", K(ret));
+  } else if (OB_FAIL(substr(str, substr_start_, substr_len_, result))) {
+    // do nothing
+  } else {
+    value.is_int_ = false;
+    value.str_value_ = result;
+    ret = hash(value, hash_num_ >= 0 ? hash_num_ : ctx.physic_size_, ctx, index);
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::execute(const ObProxyShardRuleOp *ops, const int64_t op_count,
+                                       const SqlColumnValue *column_value,
+                                       const ObProxyShardRuleCalcCtx &ctx,
+                                       ObProxyShardRuleValue *stack, int64_t &depth)
+{
+  int ret = OB_SUCCESS;
+  depth = 0;
+  for (int64_t i = 0; OB_SUCC(ret) && i < op_count; ++i) {
+    const ObProxyShardRuleOp &op = ops[i];
+    int64_t param_count = 0;
+    switch (op.type_) {
+      case OP_COLUMN:
+      case OP_INT:
+      case OP_STR:
+        param_count = 0;
+        break;
+      case OP_HASH:
+      case OP_TOINT:
+        param_count = 1;
+        break;
+      case OP_SUBSTR3:
+        param_count = 3;
+        break;
+      default:
+        param_count = 2;
+        break;
+    }
+
+    if (OB_UNLIKELY(depth < param_count) || OB_UNLIKELY(0 == param_count && depth >= MAX_STACK_DEPTH)) {
+      ret = OB_NOT_SUPPORTED;
+      LOG_WARN("invalid shard rule program", K(depth), K(param_count), K(op), K(ret));
+    } else {
+      const int64_t base = depth - param_count;
+      ObProxyShardRuleValue &value = stack[base];
+      switch (op.type_) {
+        case OP_COLUMN:
+          if (OB_ISNULL(column_value)) {
+            ret = OB_ERR_UNEXPECTED;
+            LOG_WARN("column value is null", K(ret));
+          } else {
+            ret = get_column_value(*column_value, value);
+          }
+          break;
+        case OP_INT:
+          value.is_int_ = true;
+          value.int_value_ = op.int_value_;
+          break;
+        case OP_STR:
+          value.is_int_ = false;
+          value.str_value_ = op.str_value_;
+          break;
+        case OP_HASH:
+        case OP_HASH2: {
+          int64_t index = 0;
+          int64_t num = ctx.physic_size_;
+          if (OB_FAIL(hash(value, -1, ctx, index))) {
+            // do nothing
+          } else if (OP_HASH2 == op.type_ && OB_FAIL(get_int(stack[base + 1], num))) {
+            // do nothing
+          } else if (!ctx.is_elastic_index_) {
+            if (0 == num) {
+              ret = OB_EXPR_CALC_ERROR;
+              LOG_WARN("num is 0", K(ret));
+            } else {
+              index = index % num;
+            }
+          }
+          if (OB_SUCC(ret)) {
+            value.is_int_ = true;
+            value.int_value_ = index;
+          }
+          break;
+        }
+        case OP_SUBSTR2:
+        case OP_SUBSTR3: {
+          ObString str;
+          ObString result;
+          int64_t start_pos = 0;
+          int64_t substr_len = -1;
+          if (OB_FAIL(get_str(value, str))) {
+            // do nothing
+          } else if (OB_UNLIKELY(str.empty())) {
+            ret = OB_EXPR_CALC_ERROR;
+            LOG_WARN("substr first parm is emtpy", K(ret));
+          } else if (OB_FAIL(get_int(stack[base + 1], start_pos))) {
+            // do nothing
+          } else if (OP_SUBSTR3 == op.type_ && OB_FAIL(get_int(stack[base + 2], substr_len))) {
+            // do nothing
+          } else if (OP_SUBSTR3 == op.type_ && substr_len <= 0) {
+            ret = OB_INVALID_ARGUMENT_FOR_SUBSTR;
+            LOG_WARN("substr function param 3 is less than 1", K(ret));
+          } else if (OB_SUCC(substr(str, start_pos, substr_len, result))) {
+            value.is_int_ = false;
+            value.str_value_ = result;
+          }
+          break;
+        }
+        case OP_TOINT: {
+          int64_t int_value = 0;
+          if (OB_SUCC(get_int(value, int_value))) {
+            value.is_int_ = true;
+            value.int_value_ = int_value;
+          }
+          break;
+        }
+        default: {
+          const ObProxyShardRuleValue &right = stack[base + 1];
+          if (!value.is_int_ || !right.is_int_) {
+            // number arithmetic, leave it to expr
+            ret = OB_NOT_SUPPORTED;
+          } else if (0 == right.int_value_) {
+            ret = OB_EXPR_CALC_ERROR;
+            LOG_WARN("div failed, num2 is 0", K(ret));
+          } else if (OP_DIV == op.type_) {
+            value.int_value_ = value.int_value_ / right.int_value_;
+          } else if (OP_ADD == op.type_) {
+            value.int_value_ = value.int_value_ + right.int_value_;
+          } else if (OP_SUB == op.type_) {
+            value.int_value_ = value.int_value_ - right.int_value_;
+          } else {
+            value.int_value_ = value.int_value_ * right.int_value_;
+          }
+          break;
+        }
+      }
+
+      if (OB_SUCC(ret)) {
+        depth = base + 1;
+      }
+    }
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::get_column_value(const SqlColumnValue &column_value, ObProxyShardRuleValue &value)
+{
+  int ret = OB_SUCCESS;
+  if (TOKEN_INT_VAL == column_value.value_type_) {
+    value.is_int_ = true;
+    value.int_value_ = column_value.column_int_value_;
+  } else if (TOKEN_STR_VAL == column_value.value_type_) {
+    value.is_int_ = false;
+    value.str_value_ = column_value.column_value_.string_;
+  } else {
+    ret = OB_ERR_COULUMN_VALUE_NOT_MATCH;
+    LOG_WARN("sql_column_value value type invalid", K(column_value.value_type_));
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::get_int(ObProxyShardRuleValue &value, int64_t &int_value)
+{
+  int ret = OB_SUCCESS;
+  if (value.is_int_) {
+    int_value = value.int_value_;
+  } else if (OB_FAIL(get_int_value(value.str_value_, int_value))) {
+    LOG_WARN("get int value failed", K(value.str_value_), K(ret));
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::get_str(ObProxyShardRuleValue &value, ObString &str_value)
+{
+  int ret = OB_SUCCESS;
+  if (value.is_int_) {
+    const int64_t len = snprintf(value.buf_, INT_STR_BUF_LEN, "%ld", value.int_value_);
+    str_value.assign_ptr(value.buf_, static_cast<ObString::obstr_size_t>(len));
+  } else {
+    str_value = value.str_value_;
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::hash(ObProxyShardRuleValue &value, const int64_t num,
+                                    const ObProxyShardRuleCalcCtx &ctx, int64_t &index)
+{
+  int ret = OB_SUCCESS;
+  if (!value.is_int_ && testload_need_handle_special_char(ctx.test_load_type_)) {
+    ObShardRule::handle_special_char(value.str_value_.ptr(), value.str_value_.length());
+  }
+
+  if (OB_FAIL(get_int(value, index))) {
+    // do nothing
+  } else if (num < 0 || ctx.is_elastic_index_) {
+    // mod by caller or no mod for elastic index
+  } else if (0 == num) {
+    ret = OB_EXPR_CALC_ERROR;
+    LOG_WARN("num is 0", K(ret));
+  } else {
+    index = index % num;
+  }
+  return ret;
+}
+
+int ObProxyShardRuleEvaluator::substr(const ObString &value, int64_t start_pos, int64_t substr_len,
+                                      ObString &result)
+{
+  int ret = OB_SUCCESS;
+  const int64_t value_length = value.length();
+  if (start_pos < 0) {
+    start_pos = value_length + start_pos + 1;
+  }
+
+  if (-1 == substr_len || start_pos + substr_len - 1 > value_length) {
+    substr_len = value_length - start_pos + 1;
+  }
+
+  if (start_pos <= 0 || start_pos > value_length || substr_len <= 0 || substr_len > value_length
+      || start_pos + substr_len - 1 > value_length) {
+    ret = OB_INVALID_ARGUMENT_FOR_SUBSTR;
+    LOG_WARN("column value length does not match", K(start_pos),
+             K(substr_len), K(value_length), K(value), K(ret));
+  } else {
+    result.assign_ptr(value.ptr() + start_pos - 1, static_cast<int32_t>(substr_len));
+  }
+  return ret;
+}
+
+} // end opsql
+} // end obproxy
+} // end oceanbase
@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OB_PROXY_SHARD_RULE_EVALUATOR_H
+#define OB_PROXY_SHARD_RULE_EVALUATOR_H
+
+#include "opsql/func_expr_resolver/proxy_expr/ob_proxy_expr.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace opsql
+{
+
+/*
+ * A shard rule expr compiled into a flat postfix program when dbconfig is loaded.
+ *
+ *   hash(substr(col, 2, 3), 16)  ==>  COLUMN, INT 2, INT 3, SUBSTR3, INT 16, HASH2
+ *
+ * Sub trees without column are folded into constants, and the two common shapes
+ * hash(col[, n]) and hash(substr(col, a[, b])[, n]) are evaluated directly. The
+ * evaluation works on a small fixed stack, so it needs no allocator and no ObObj.
+ *
+ * Only one column is allowed, each value of the column gives one result.
+ * OB_NOT_SUPPORTED is returned when the value needs the generic expr (number
+ * arithmetic for example), the caller should calc with ObProxyExpr then.
+ */
+class ObProxyShardRuleEvaluator
+{
+public:
+  static const int64_t MAX_OP_COUNT = 16;
+  static const int64_t MAX_STACK_DEPTH = 8;
+  static const int64_t INT_STR_BUF_LEN = 32;
+
+  enum ObProxyShardRuleOpType
+  {
+    OP_COLUMN = 0,
+    OP_INT,
+    OP_STR,
+    OP_HASH,     // hash(x) % physic_size
+    OP_HASH2,    // hash(x, n) % n
+    OP_SUBSTR2,
+    OP_SUBSTR3,
+    OP_TOINT,
+    OP_DIV,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+  };
+
+  enum ObProxyShardRulePattern
+  {
+    PATTERN_GENERIC = 0,
+    PATTERN_HASH,         // hash(col[, n])
+    PATTERN_HASH_SUBSTR,  // hash(substr(col, a[, b])[, n])
+  };
+
+  struct ObProxyShardRuleOp
+  {
+    ObProxyShardRuleOp() : type_(OP_INT), int_value_(0), str_value_() {}
+    TO_STRING_KV(K_(type), K_(int_value), K_(str_value));
+
+    ObProxyShardRuleOpType type_;
+    int64_t int_value_;
+    common::ObString str_value_;
+  };
+
+  struct ObProxyShardRuleValue
+  {
+    ObProxyShardRuleValue() : is_int_(true), int_value_(0), str_value_() {}
+
+    bool is_int_;
+    int64_t int_value_;
+    common::ObString str_value_;
+    // holds the string of an int value converted by substr
+    char buf_[INT_STR_BUF_LEN];
+  };
+
+  struct ObProxyShardRuleCalcCtx
+  {
+    ObProxyShardRuleCalcCtx(const int64_t physic_size, const dbconfig::ObTestLoadType type,
+                            const bool is_elastic_index)
+      : physic_size_(physic_size), test_load_type_(type), is_elastic_index_(is_elastic_index) {}
+
+    int64_t physic_size_;
+    dbconfig::ObTestLoadType test_load_type_;
+    bool is_elastic_index_;
+  };
+
+public:
+  ObProxyShardRuleEvaluator()
+    : pattern_(PATTERN_GENERIC), op_count_(0), hash_num_(-1),
+      substr_start_(0), substr_len_(-1), column_name_() {}
+  ~ObProxyShardRuleEvaluator() {}
+
+  // OB_NOT_SUPPORTED means expr can not be compiled, just use the expr
+  static int compile(ObProxyExpr *expr, common::ObIAllocator &allocator,
+                     ObProxyShardRuleEvaluator *&evaluator);
+
+  // index of the first value of rule column
+  int calc_index(const obutils::SqlFieldResult &sql_result, const ObProxyShardRuleCalcCtx &ctx,
+                 int64_t &index) const;
+  // index of each value of rule column
+  int calc_index_array(const obutils::SqlFieldResult &sql_result, const ObProxyShardRuleCalcCtx &ctx,
+                       common::ObIArray<int64_t> &index_array) const;
+
+  TO_STRING_KV(K_(pattern), K_(op_count), K_(hash_num), K_(substr_start), K_(substr_len),
+               K_(column_name));
+
+private:
+  int compile_expr(ObProxyExpr *expr, common::ObIAllocator &allocator);
+  int fold_const(const int64_t start, common::ObIAllocator &allocator);
+  int add_op(const ObProxyShardRuleOpType type, const int64_t int_value = 0,
+             const common::ObString &str_value = common::ObString());
+  void recognize_pattern();
+
+  int find_column(const obutils::SqlFieldResult &sql_result, const obutils::SqlField *&field) const;
+  int calc_value(const obutils::SqlColumnValue *column_value, const ObProxyShardRuleCalcCtx &ctx,
+                 int64_t &index) const;
+  int calc_hash_column(const obutils::SqlColumnValue &column_value, const ObProxyShardRuleCalcCtx &ctx,
+                       int64_t &index) const;
+  int calc_hash_substr(const obutils::SqlColumnValue &column_value, const ObProxyShardRuleCalcCtx &ctx,
+                       int64_t &index) const;
+
+  static int execute(const ObProxyShardRuleOp *ops, const int64_t op_count,
+                     const obutils::SqlColumnValue *column_value,
+                     const ObProxyShardRuleCalcCtx &ctx,
+                     ObProxyShardRuleValue *stack, int64_t &depth);
+  static int get_column_value(const obutils::SqlColumnValue &column_value, ObProxyShardRuleValue &value);
+  static int get_int(ObProxyShardRuleValue &value, int64_t &int_value);
+  static int get_str(ObProxyShardRuleValue &value, common::ObString &str_value);
+  static int hash(ObProxyShardRuleValue &value, const int64_t num, const ObProxyShardRuleCalcCtx &ctx,
+                  int64_t &index);
+  static int substr(const common::ObString &value, int64_t start_pos, int64_t substr_len,
+                    common::ObString &result);
+
+private:
+  ObProxyShardRulePattern pattern_;
+  int64_t op_count_;
+  // -1 means hash by physic size
+  int64_t hash_num_;
+  int64_t substr_start_;
+  // -1 means to the end
+  int64_t substr_len_;
+  common::ObString column_name_;
+  ObProxyShardRuleOp ops_[MAX_OP_COUNT];
+
+  DISALLOW_COPY_AND_ASSIGN(ObProxyShardRuleEvaluator);
+};
+
+} // end opsql
+} // end obproxy
+} // end oceanbase
+
+#endif // OB_PROXY_SHARD_RULE_EVALUATOR_H
@@ -18,6 +18,7 @@
 #include "engine/ob_proxy_operator_table_scan.h"
 #include "engine/ob_proxy_operator_projection.h"
 #include "obutils/ob_proxy_stmt.h"
+#include "obutils/ob_proxy_config.h"
 
 using namespace oceanbase::obproxy::engine;
 using namespace oceanbase::common;
@@ -343,6 +344,23 @@ int ObShardingSelectLogPlan::analyze_order_by_clause()
         LOG_WARN("not support", K(ret), K(*expr));
       }
     }
+
+    // order by one plain column with limit, table scan can fetch it progressively
+    if (OB_SUCC(ret) && select_stmt->limit_start_ > 0
+        && get_global_proxy_config().enable_sharding_topn_pushdown
+        && 1 == order_by_expr_array->count()
+        && 0 == table_scan_input->get_group_by_exprs().count()) {
+      ObProxyOrderItem *order_item = order_by_expr_array->at(0);
+      ObProxyExprShardingConst *column_expr = dynamic_cast<ObProxyExprShardingConst*>(order_item->expr_);
+      bool has_agg = false;
+      for (int64_t i = 0; !has_agg && i < select_stmt->select_exprs_.count(); i++) {
+        has_agg = select_stmt->select_exprs_.at(i)->has_agg();
+      }
+      if (!has_agg && NULL != column_expr && column_expr->is_column_
+          && !column_expr->has_alias() && !column_expr->is_alias_) {
+        table_scan_input->set_topn_order_item(order_item);
+      }
+    }
   }
   return ret;
 }
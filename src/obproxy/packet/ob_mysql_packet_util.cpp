@@ -157,13 +157,17 @@ int ObMysqlPacketUtil::encode_err_packet(ObMIOBuffer &write_buf, uint8_t &seq,
 int ObMysqlPacketUtil::encode_ok_packet(ObMIOBuffer &write_buf, uint8_t &seq,
                                         const int64_t affected_rows,
                                         const ObMySQLCapabilityFlags &capability,
-                                        uint16_t status_flag /* 0 */)
+                                        uint16_t status_flag /* 0 */,
+                                        const uint64_t last_insert_id /* 0 */,
+                                        const uint16_t warnings /* 0 */)
 {
   int ret = OB_SUCCESS;
 
   OMPKOK ok_packet;
   ok_packet.set_seq(seq++);
   ok_packet.set_affected_rows(static_cast<uint64_t>(affected_rows));
+  ok_packet.set_last_insert_id(last_insert_id);
+  ok_packet.set_warnings(warnings);
   ok_packet.set_capability(capability);
   ObServerStatusFlags server_status(status_flag);
   ok_packet.set_server_status(server_status);
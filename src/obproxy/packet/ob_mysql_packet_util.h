@@ -88,7 +88,9 @@ public:
                               uint8_t &seq,
                               const int64_t affected_rows,
                               const obmysql::ObMySQLCapabilityFlags &capability,
-                              uint16_t status_flag = 0);
+                              uint16_t status_flag = 0,
+                              const uint64_t last_insert_id = 0,
+                              const uint16_t warnings = 0);
   static int encode_kv_resultset(event::ObMIOBuffer &write_buf,
                                  uint8_t &seq,
                                  const obmysql::ObMySQLField &field,
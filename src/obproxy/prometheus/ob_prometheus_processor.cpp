@@ -15,6 +15,7 @@
 #include "prometheus/ob_prometheus_processor.h"
 #include "prometheus/ob_prometheus_utils.h"
 #include "prometheus/ob_prometheus_convert.h"
+#include "prometheus/ob_sql_prometheus.h"
 #include "obutils/ob_proxy_table_processor_utils.h"
 #include "obutils/ob_proxy_config.h"
 #include "utils/ob_proxy_monitor_utils.h"
@@ -184,6 +185,20 @@ int ObPrometheusProcessor::do_prometheus_sync_task()
   max_idle_period = max_idle_period == 0 ? 1 : max_idle_period;
   bool need_expire_metric = need_expire_metric_;
 
+  if (get_global_proxy_config().enable_latency_histogram) {
+    int tmp_ret = OB_SUCCESS;
+    if (OB_UNLIKELY(OB_SUCCESS != (tmp_ret = ObSQLPrometheus::sync_latency_histogram()))) {
+      LOG_WARN("fail to sync latency histogram", K(tmp_ret));
+    }
+  }
+
+  if (get_global_proxy_config().enable_sql_digest) {
+    int tmp_ret = OB_SUCCESS;
+    if (OB_UNLIKELY(OB_SUCCESS != (tmp_ret = ObSQLPrometheus::sync_sql_digest()))) {
+      LOG_WARN("fail to sync sql digest", K(tmp_ret));
+    }
+  }
+
   ObPrometheusFamilyHashTable::iterator family_iter = family_hash_.begin();
   ObPrometheusFamilyHashTable::iterator family_last = family_hash_.end();
   for (; family_iter != family_last; ++family_iter) {
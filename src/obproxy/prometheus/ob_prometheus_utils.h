@@ -39,6 +39,16 @@ namespace prometheus
 #define ENTRY_TOTAL "odp_entry_total"
 #define ENTRY_TOTAL_HELP "The num of entry lookup"
 
+#define LATENCY_QUANTILE "odp_sql_latency_quantile"
+#define LATENCY_QUANTILE_HELP "user request latency quantile in us"
+
+#define SQL_DIGEST_EXEC_TOTAL "odp_sql_digest_exec_total"
+#define SQL_DIGEST_EXEC_TOTAL_HELP "The num of user request per sql fingerprint"
+#define SQL_DIGEST_ERROR_TOTAL "odp_sql_digest_error_total"
+#define SQL_DIGEST_ERROR_TOTAL_HELP "The num of error response per sql fingerprint"
+#define SQL_DIGEST_TIME_TOTAL "odp_sql_digest_time_total"
+#define SQL_DIGEST_TIME_TOTAL_HELP "user request total time per sql fingerprint in us"
+
 #define LABEL_LOGIC_TENANT "logicTenant"
 #define LABEL_LOGIC_SCHEMA "logicSchema"
 #define LABEL_CLUSTER "cluster"
@@ -48,6 +58,10 @@ namespace prometheus
 #define LABEL_SQL_RESULT "sqlResult"
 #define LABEL_SQL_SLOW "slowQuery"
 #define LABEL_TIME_TYPE "timeType"
+#define LABEL_LATENCY_TYPE "latencyType"
+#define LABEL_QUANTILE "quantile"
+#define LABEL_DIGEST "digest"
+#define LABEL_DIGEST_TEXT "digestText"
 #define LABEL_SESSION_TYPE "sessionType"
 #define LABEL_SESSION_CLIENT "client"
 #define LABEL_SESSION_SERVER "server"
@@ -15,6 +15,8 @@
 #include "prometheus/ob_sql_prometheus.h"
 #include "prometheus/ob_prometheus_utils.h"
 #include "obutils/ob_proxy_config.h"
+#include "obutils/ob_latency_histogram.h"
+#include "obutils/ob_sql_digest.h"
 
 using namespace oceanbase::obproxy::proxy;
 using namespace oceanbase::obproxy::obutils;
@@ -90,6 +92,90 @@ int ObSQLPrometheus::handle_prometheus(const ObClientSessionInfo &cs_info,
   return ret;
 }
 
+int ObSQLPrometheus::sync_latency_histogram()
+{
+  int ret = OB_SUCCESS;
+  static const char *QUANTILE_NAMES[ObLatencyHistogramItem::EXPORT_PERCENTILE_COUNT] = {"0.5", "0.9", "0.99", "0.999"};
+  ObLatencyHistogramManager &mgr = get_global_latency_histogram_mgr();
+  ObVector<ObPrometheusLabel> &label_vector = ObProxyPrometheusUtils::get_thread_label_vector();
+  for (int64_t i = 0; OB_SUCC(ret) && i < ObLatencyHistogramManager::TABLE_SIZE; ++i) {
+    ObLatencyHistogramItem *item = mgr.get_item(i);
+    if (NULL != item) {
+      ObLatencyHistogramSet set;
+      item->merge_window(set, get_global_proxy_config().latency_histogram_window);
+      for (int64_t type = 0; OB_SUCC(ret) && type < LATENCY_MAX_TYPE; ++type) {
+        ObLatencyPercentiles percentiles;
+        ObLatencyHistogramManager::get_percentiles(set.histograms_[type], percentiles);
+        const int64_t values[ObLatencyHistogramItem::EXPORT_PERCENTILE_COUNT] = {
+          percentiles.p50_, percentiles.p90_, percentiles.p99_, percentiles.p999_};
+        for (int64_t j = 0; OB_SUCC(ret) && j < ObLatencyHistogramItem::EXPORT_PERCENTILE_COUNT; ++j) {
+          // gauge accumulates what is handled, so only the change is pushed
+          const int64_t delta = values[j] - item->exported_values_[type][j];
+          if (0 != delta) {
+            label_vector.reset();
+            ObProxyPrometheusUtils::build_label(label_vector, LABEL_CLUSTER, item->get_cluster_name());
+            ObProxyPrometheusUtils::build_label(label_vector, LABEL_TENANT, item->get_tenant_name());
+            ObProxyPrometheusUtils::build_label(label_vector, LABEL_SQL_TYPE,
+                                                get_print_stmt_name(item->get_stmt_type()), false);
+            ObProxyPrometheusUtils::build_label(label_vector, LABEL_LATENCY_TYPE,
+                                                get_latency_type_name(static_cast<ObLatencyType>(type)), false);
+            ObProxyPrometheusUtils::build_label(label_vector, LABEL_QUANTILE, QUANTILE_NAMES[j], false);
+            if (OB_FAIL(g_ob_prometheus_processor.handle_gauge(LATENCY_QUANTILE, LATENCY_QUANTILE_HELP,
+                                                               label_vector, delta, false))) {
+              LOG_WARN("fail to handle gauge with LATENCY_QUANTILE", KPC(item), K(ret));
+            } else {
+              item->exported_values_[type][j] = values[j];
+            }
+          }
+        }
+      }
+    }
+  }
+  return ret;
+}
+
+int ObSQLPrometheus::sync_sql_digest()
+{
+  int ret = OB_SUCCESS;
+  ObSqlDigestTable &table = get_global_sql_digest_table();
+  ObSqlDigestItem *items = NULL;
+  if (!table.is_inited()) {
+    // do nothing
+  } else if (OB_ISNULL(items = static_cast<ObSqlDigestItem *>(
+                         ob_malloc(sizeof(ObSqlDigestItem) * table.get_item_limit(), ObModIds::OB_PROXY_STAT)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc mem for sql digest items", "item_limit", table.get_item_limit(), K(ret));
+  } else {
+    // bound the label cardinality, the digest text of the light ones is not exported
+    const int64_t count = table.copy_items(items, get_global_proxy_config().sql_digest_top_count, true);
+    ObVector<ObPrometheusLabel> &label_vector = ObProxyPrometheusUtils::get_thread_label_vector();
+    for (int64_t i = 0; OB_SUCC(ret) && i < count; ++i) {
+      const ObSqlDigestItem &item = items[i];
+      char digest_buf[32];
+      snprintf(digest_buf, sizeof(digest_buf), "%016lx", item.hash_);
+      label_vector.reset();
+      ObProxyPrometheusUtils::build_label(label_vector, LABEL_TENANT, item.get_tenant_name());
+      ObProxyPrometheusUtils::build_label(label_vector, LABEL_SCHEMA, item.get_database_name());
+      ObProxyPrometheusUtils::build_label(label_vector, LABEL_DIGEST, digest_buf);
+      ObProxyPrometheusUtils::build_label(label_vector, LABEL_DIGEST_TEXT, item.get_fingerprint());
+      if (OB_FAIL(g_ob_prometheus_processor.handle_counter(SQL_DIGEST_EXEC_TOTAL, SQL_DIGEST_EXEC_TOTAL_HELP,
+                                                           label_vector, item.stat_.exec_count_))) {
+        LOG_WARN("fail to handle counter with SQL_DIGEST_EXEC_TOTAL", K(item), K(ret));
+      } else if (OB_FAIL(g_ob_prometheus_processor.handle_counter(SQL_DIGEST_TIME_TOTAL, SQL_DIGEST_TIME_TOTAL_HELP,
+                                                                  label_vector, item.stat_.total_time_us_))) {
+        LOG_WARN("fail to handle counter with SQL_DIGEST_TIME_TOTAL", K(item), K(ret));
+      } else if (item.stat_.error_count_ > 0
+                 && OB_FAIL(g_ob_prometheus_processor.handle_counter(SQL_DIGEST_ERROR_TOTAL, SQL_DIGEST_ERROR_TOTAL_HELP,
+                                                                     label_vector, item.stat_.error_count_))) {
+        LOG_WARN("fail to handle counter with SQL_DIGEST_ERROR_TOTAL", K(item), K(ret));
+      }
+    }
+    ob_free(items);
+    items = NULL;
+  }
+  return ret;
+}
+
 int ObSQLPrometheus::handle_prometheus(const ObString &logic_tenant_name,
                                        const ObString &logic_database_name,
                                        const ObString &cluster_name,
@@ -37,6 +37,11 @@ public:
 
   static int handle_prometheus(const proxy::ObClientSessionInfo &cs_info,
                                const ObPrometheusMetrics metric, ...);
+
+  // export latency histogram percentiles as gauges, called by prometheus sync task
+  static int sync_latency_histogram();
+  // export what sql digest table recorded since last sync as counters
+  static int sync_sql_digest();
 private:
   static int handle_prometheus(const common::ObString &logic_tenant_name,
                                const common::ObString &logic_database_name,
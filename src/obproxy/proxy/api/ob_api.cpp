@@ -21,6 +21,7 @@
 #include "proxy/plugins/ob_mysql_response_prepare_transform_plugin.h"
 #include "proxy/plugins/ob_mysql_request_compress_transform_plugin.h"
 #include "proxy/plugins/ob_mysql_response_cursor_transform_plugin.h"
+#include "proxy/plugins/ob_mysql_response_cursor_prefetch_transform_plugin.h"
 #include "proxy/plugins/ob_mysql_response_prepare_execute_transform_plugin.h"
 
 /****************************************************************
@@ -455,6 +456,7 @@ int api_init()
           init_mysql_resposne_compress_transform();
           init_mysql_response_prepare_transform();
           init_mysql_response_cursor_transform();
+          init_mysql_response_cursor_prefetch_transform();
           init_mysql_response_prepare_execute_transform();
       // }
     }
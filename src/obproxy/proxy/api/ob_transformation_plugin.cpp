@@ -116,6 +116,7 @@ int64_t ObTransformationPlugin::produce(ObIOBufferReader *reader, const int64_t
                   this, sm_, bytes_written, write_length);
       } else {
         bytes_written_ += bytes_written; // So we can set BytesDone on set_output_complete().
+        sm_->trans_stats_.transform_shared_bytes_ += bytes_written; // write() shares the blocks
         DEBUG_API("ObTransformationPlugin=%p mysqlsm=%p write to ObMIOBuffer * %ld "
                   "bytes total bytes written %ld",
                   this, sm_, bytes_written, bytes_written_);
@@ -169,17 +169,27 @@ int ObClientMysqlResp::analyze_resp(const ObMySQLCmd cmd)
 }
 
 int ObClientMysqlResp::get_affected_rows(int64_t &affected_row)
+{
+  int ret = OB_SUCCESS;
+  OMPKOK src_ok;
+  if (OB_FAIL(get_ok_packet(src_ok))) {
+    LOG_WARN("fail to get ok packet", K(ret));
+  } else {
+    affected_row = static_cast<int64_t>(src_ok.get_affected_rows());
+  }
+
+  return ret;
+}
+
+int ObClientMysqlResp::get_ok_packet(OMPKOK &ok_packet)
 {
   int ret = OB_SUCCESS;
   if (is_ok_resp()) {
     if ((NULL != response_reader_) && (response_reader_->read_avail() > 0)) {
-      OMPKOK src_ok;
       ObMySQLCapabilityFlags cap(ObClientUtils::CAPABILITY_FLAGS);
       ObMysqlPacketReader pkt_reader;
-      if (OB_FAIL(pkt_reader.get_ok_packet(*response_reader_, 0, cap, src_ok))) {
+      if (OB_FAIL(pkt_reader.get_ok_packet(*response_reader_, 0, cap, ok_packet))) {
         LOG_WARN("fail to get ok packet", K(ret));
-      } else {
-        affected_row = static_cast<int64_t>(src_ok.get_affected_rows());
       }
     } else {
       ret = OB_INNER_STAT_ERROR;
@@ -19,6 +19,10 @@
 
 namespace oceanbase
 {
+namespace obmysql
+{
+class OMPKOK;
+}
 namespace obproxy
 {
 namespace proxy
@@ -69,6 +73,7 @@ public:
   uint16_t get_err_code() const { return mysql_resp_.get_analyze_result().get_error_code(); }
   common::ObString get_err_msg() const {return mysql_resp_.get_analyze_result().get_error_pkt().get_message();}
   int get_affected_rows(int64_t &affected_row);
+  int get_ok_packet(obmysql::OMPKOK &ok_packet);
 
   int get_resultset_fetcher(ObResultSetFetcher *&result);
   event::ObMIOBuffer *get_resp_miobuf() { return response_buf_; }
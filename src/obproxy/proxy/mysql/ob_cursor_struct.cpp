@@ -13,6 +13,8 @@
 #define USING_LOG_PREFIX PROXY
 #include "proxy/mysql/ob_cursor_struct.h"
 #include "iocore/eventsystem/ob_buf_allocator.h"
+#include "rpc/obmysql/ob_mysql_util.h"
+#include "proxy/mysqllib/ob_mysql_common_define.h"
 
 using namespace oceanbase::common;
 
@@ -27,7 +29,10 @@ DEF_TO_STRING(ObCursorIdAddr)
 {
   int64_t pos = 0;
   J_OBJ_START();
-  J_KV(KP(this), K_(cursor_id), K_(addr));
+  J_KV(KP(this), K_(cursor_id), K_(addr), K_(fetch_rows), K_(is_prefetching),
+       "server_status", server_status_.flags_, K_(prefetch_row_count),
+       K_(avg_row_len), K_(prefetch_head_len), K_(prefetch_buf_size), K_(prefetch_pos),
+       K_(prefetch_len));
   J_OBJ_END();
   return pos;
 }
@@ -58,10 +63,128 @@ int ObCursorIdAddr::alloc_cursor_id_addr(uint32_t cursor_id, const struct sockad
 void ObCursorIdAddr::destroy()
 {
   LOG_INFO("cursor id addr will be destroyed", KPC(this));
+  reset_prefetch();
   int64_t total_len = sizeof(ObCursorIdAddr);
   op_fixed_mem_free(this, total_len);
 }
 
+int ObCursorIdAddr::expand_buf(char *&buf, int64_t &buf_size, const int64_t data_pos,
+                               const int64_t data_len, const int64_t need_len)
+{
+  int ret = OB_SUCCESS;
+  int64_t new_size = (buf_size < MIN_PREFETCH_BUF_SIZE ? MIN_PREFETCH_BUF_SIZE : buf_size);
+  while (new_size < data_len + need_len) {
+    new_size *= 2;
+  }
+  if (new_size == buf_size) {
+    MEMMOVE(buf, buf + data_pos, data_len);
+  } else {
+    char *new_buf = NULL;
+    if (OB_ISNULL(new_buf = static_cast<char *>(op_fixed_mem_alloc(new_size)))) {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      LOG_WARN("fail to alloc mem for cursor prefetch buf", K(new_size), K(ret));
+    } else {
+      if (NULL != buf) {
+        MEMCPY(new_buf, buf + data_pos, data_len);
+        op_fixed_mem_free(buf, buf_size);
+      }
+      buf = new_buf;
+      buf_size = new_size;
+    }
+  }
+  return ret;
+}
+
+int ObCursorIdAddr::alloc_prefetch_head(const int64_t pkt_len, char *&pkt_buf)
+{
+  int ret = OB_SUCCESS;
+  pkt_buf = NULL;
+  if (OB_UNLIKELY(pkt_len < MYSQL_NET_HEADER_LENGTH)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid head packet len", K(pkt_len), K(ret));
+  } else if (prefetch_head_len_ + pkt_len > prefetch_head_buf_size_
+             && OB_FAIL(expand_buf(prefetch_head_buf_, prefetch_head_buf_size_, 0,
+                                   prefetch_head_len_, pkt_len))) {
+    LOG_WARN("fail to expand prefetch head buf", K(pkt_len), K(ret));
+  } else {
+    pkt_buf = prefetch_head_buf_ + prefetch_head_len_;
+    prefetch_head_len_ += pkt_len;
+  }
+  return ret;
+}
+
+int ObCursorIdAddr::alloc_prefetch_row(const int64_t pkt_len, char *&pkt_buf)
+{
+  int ret = OB_SUCCESS;
+  pkt_buf = NULL;
+  if (OB_UNLIKELY(pkt_len < MYSQL_NET_HEADER_LENGTH)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid row packet len", K(pkt_len), K(ret));
+  } else if (prefetch_len_ + pkt_len > prefetch_buf_size_) {
+    // the served rows at the head are dropped
+    const int64_t data_len = prefetch_len_ - prefetch_pos_;
+    if (OB_FAIL(expand_buf(prefetch_buf_, prefetch_buf_size_, prefetch_pos_, data_len, pkt_len))) {
+      LOG_WARN("fail to expand prefetch buf", K(pkt_len), K(ret));
+    } else {
+      prefetch_pos_ = 0;
+      prefetch_len_ = data_len;
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    pkt_buf = prefetch_buf_ + prefetch_len_;
+    prefetch_len_ += pkt_len;
+    // a row larger than 16MB is split into several packets, count it at its last packet
+    if (pkt_len - MYSQL_NET_HEADER_LENGTH < MYSQL_PACKET_MAX_LENGTH) {
+      ++prefetch_row_count_;
+    }
+    avg_row_len_ = (0 == avg_row_len_) ? pkt_len : (avg_row_len_ * 7 + pkt_len) / 8;
+  }
+  return ret;
+}
+
+int ObCursorIdAddr::pop_prefetch_row(const char *&pkt_buf, int64_t &pkt_len)
+{
+  int ret = OB_SUCCESS;
+  if (OB_UNLIKELY(!has_prefetch_rows())
+      || OB_UNLIKELY(prefetch_len_ - prefetch_pos_ < MYSQL_NET_HEADER_LENGTH)) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_WARN("no prefetch row left", KPC(this), K(ret));
+  } else {
+    uint32_t payload_len = 0;
+    const char *pos = prefetch_buf_ + prefetch_pos_;
+    obmysql::ObMySQLUtil::get_uint3(pos, payload_len);
+    pkt_buf = prefetch_buf_ + prefetch_pos_;
+    pkt_len = MYSQL_NET_HEADER_LENGTH + payload_len;
+    prefetch_pos_ += pkt_len;
+    if (payload_len < MYSQL_PACKET_MAX_LENGTH) {
+      --prefetch_row_count_;
+    }
+  }
+  return ret;
+}
+
+void ObCursorIdAddr::reset_prefetch()
+{
+  fetch_rows_ = 0;
+  is_prefetching_ = false;
+  server_status_.flags_ = 0;
+  if (NULL != prefetch_head_buf_) {
+    op_fixed_mem_free(prefetch_head_buf_, prefetch_head_buf_size_);
+    prefetch_head_buf_ = NULL;
+  }
+  prefetch_head_buf_size_ = 0;
+  prefetch_head_len_ = 0;
+  if (NULL != prefetch_buf_) {
+    op_fixed_mem_free(prefetch_buf_, prefetch_buf_size_);
+    prefetch_buf_ = NULL;
+  }
+  prefetch_buf_size_ = 0;
+  prefetch_pos_ = 0;
+  prefetch_len_ = 0;
+  prefetch_row_count_ = 0;
+}
+
 int ObCursorIdPair::alloc_cursor_id_pair(uint32_t client_cursor_id, uint32_t server_cursor_id, ObCursorIdPair *&cursor_id_pair)
 {
   int ret = OB_SUCCESS;
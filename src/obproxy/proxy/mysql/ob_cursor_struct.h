@@ -15,6 +15,7 @@
 
 #include "lib/hash/ob_build_in_hashmap.h"
 #include "iocore/net/ob_inet.h"
+#include "rpc/obmysql/ob_mysql_packet.h"
 
 namespace oceanbase
 {
@@ -29,9 +30,17 @@ namespace proxy
 class ObCursorIdAddr
 {
 public:
-  ObCursorIdAddr() : cursor_id_(0), addr_() {}
+  static const int64_t MIN_PREFETCH_BUF_SIZE = 4 * 1024;
+
+  ObCursorIdAddr() : cursor_id_(0), addr_(), fetch_rows_(0), is_prefetching_(false),
+                     server_status_(), prefetch_row_count_(0), avg_row_len_(0),
+                     prefetch_head_buf_(NULL), prefetch_head_buf_size_(0), prefetch_head_len_(0),
+                     prefetch_buf_(NULL), prefetch_buf_size_(0), prefetch_pos_(0), prefetch_len_(0) {}
   ObCursorIdAddr(uint32_t cursor_id, const sockaddr &addr)
-      : cursor_id_(cursor_id), addr_(addr) {}
+      : cursor_id_(cursor_id), addr_(addr), fetch_rows_(0), is_prefetching_(false),
+        server_status_(), prefetch_row_count_(0), avg_row_len_(0),
+        prefetch_head_buf_(NULL), prefetch_head_buf_size_(0), prefetch_head_len_(0),
+        prefetch_buf_(NULL), prefetch_buf_size_(0), prefetch_pos_(0), prefetch_len_(0) {}
   ~ObCursorIdAddr() {}
 
   static int alloc_cursor_id_addr(uint32_t cursor_id, const struct sockaddr &addr, ObCursorIdAddr *&cursor_id_addr);
@@ -43,13 +52,67 @@ public:
   net::ObIpEndpoint &get_addr() { return addr_; }
   void set_addr(const struct sockaddr &addr) { addr_.assign(addr); }
 
+  // the rows asked by the current COM_STMT_FETCH of client, 0 if it can not be prefetched
+  uint32_t get_fetch_rows() const { return fetch_rows_; }
+  void set_fetch_rows(const uint32_t fetch_rows) { fetch_rows_ = fetch_rows; }
+  // the current fetch sent to server asks more rows than client does
+  bool is_prefetching() const { return is_prefetching_; }
+  void set_prefetching(const bool is_prefetching) { is_prefetching_ = is_prefetching; }
+  // status flags in the eof packet of the last prefetching fetch
+  void set_server_status(const obmysql::ObServerStatusFlags server_status) { server_status_ = server_status; }
+  obmysql::ObServerStatusFlags get_server_status() const { return server_status_; }
+  bool is_server_cursor_exhausted() const
+  {
+    return 1 == server_status_.status_flags_.OB_SERVER_STATUS_LAST_ROW_SENT;
+  }
+
+  // the resultset header, field and eof packets of the last prefetching fetch,
+  // they are replayed before the prefetched rows
+  const char *get_prefetch_head() const { return prefetch_head_buf_; }
+  int64_t get_prefetch_head_len() const { return prefetch_head_len_; }
+  void reuse_prefetch_head() { prefetch_head_len_ = 0; }
+  // reserve @pkt_len bytes at the tail for one head packet
+  int alloc_prefetch_head(const int64_t pkt_len, char *&pkt_buf);
+
+  // rows fetched from server ahead of client, kept as whole mysql packets in arrival order
+  bool has_prefetch_rows() const { return prefetch_row_count_ > 0; }
+  int64_t get_prefetch_row_count() const { return prefetch_row_count_; }
+  int64_t get_prefetch_len() const { return prefetch_len_ - prefetch_pos_; }
+  int64_t get_avg_row_len() const { return avg_row_len_; }
+  // reserve @pkt_len bytes at the tail for one row packet
+  int alloc_prefetch_row(const int64_t pkt_len, char *&pkt_buf);
+  // take the row packet at the head, valid until the next alloc_prefetch_row,
+  // a row larger than 16MB is taken packet by packet
+  int pop_prefetch_row(const char *&pkt_buf, int64_t &pkt_len);
+  // drop the prefetched rows and free the buffers, when the cursor is drained, reopened or destroyed
+  void reset_prefetch();
+
   int64_t to_string(char *buf, const int64_t buf_len) const;
 
 public:
   uint32_t cursor_id_; // client cursor id
   net::ObIpEndpoint addr_;
 
+  uint32_t fetch_rows_;
+  bool is_prefetching_;
+  obmysql::ObServerStatusFlags server_status_;
+  int64_t prefetch_row_count_;
+  int64_t avg_row_len_;
+  char *prefetch_head_buf_;
+  int64_t prefetch_head_buf_size_;
+  int64_t prefetch_head_len_;
+  char *prefetch_buf_;
+  int64_t prefetch_buf_size_;
+  int64_t prefetch_pos_;
+  int64_t prefetch_len_;
+
   LINK(ObCursorIdAddr, cursor_id_addr_link_);
+
+private:
+  // make room for @need_len more bytes after the @data_len bytes at @data_pos,
+  // the data is moved to the head of the buffer
+  static int expand_buf(char *&buf, int64_t &buf_size, const int64_t data_pos,
+                        const int64_t data_len, const int64_t need_len);
 };
 
 // cursor_id ----> ObCursorIdAddr
@@ -64,7 +64,7 @@ ObMysqlClientSession::ObMysqlClientSession()
       vc_ready_killed_(false), is_waiting_trans_first_request_(false),
       is_need_send_trace_info_(true), is_already_send_trace_info_(false),
       is_first_handle_close_request_(true), is_in_trans_for_close_request_(false),
-      need_delete_cluster_(false), is_first_dml_sql_got_(false),
+      is_local_infile_pending_(false), need_delete_cluster_(false), is_first_dml_sql_got_(false),
       cluster_resource_(NULL), dummy_entry_(NULL), is_need_update_dummy_entry_(false),
       dummy_ldc_(),  dummy_entry_valid_time_ns_(0), server_state_version_(0),
       inner_request_param_(NULL), tcp_init_cwnd_set_(false), half_close_(false),
@@ -73,12 +73,13 @@ ObMysqlClientSession::ObMysqlClientSession()
       client_vc_(NULL), in_list_stat_(LIST_INIT), current_tid_(-1),
       cs_id_(0), proxy_sessid_(0), bound_ss_(NULL), cur_ss_(NULL), lii_ss_(NULL), last_bound_ss_(NULL), read_buffer_(NULL),
       buffer_reader_(NULL), mysql_sm_(NULL), read_state_(MCS_INIT), ka_vio_(NULL),
-      server_ka_vio_(NULL), trace_stats_(NULL), select_plan_(NULL), ps_cache_(),
+      server_ka_vio_(NULL), trace_stats_(NULL), select_plan_(NULL), parallel_dml_plan_(NULL), ps_cache_(),
       ps_id_(0), cursor_id_(CURSOR_ID_START), text_ps_cache_(), using_ldg_(false)
 {
   SET_HANDLER(&ObMysqlClientSession::main_handler);
-  bool enable_session_pool = get_global_proxy_config().is_pool_mode
-                             && get_global_proxy_config().enable_session_pool_for_no_sharding;
+  bool enable_session_pool = (get_global_proxy_config().is_pool_mode
+                              && get_global_proxy_config().enable_session_pool_for_no_sharding)
+                             || get_global_proxy_config().enable_server_session_multiplex;
   set_session_pool_client(enable_session_pool);
   can_server_session_release_ = true;
 }
@@ -118,6 +119,7 @@ void ObMysqlClientSession::destroy()
   buffer_reader_ = NULL;
 
   set_sharding_select_log_plan(NULL);
+  set_parallel_dml_plan(NULL);
 
 #ifdef USE_MYSQL_DEBUG_LISTS
   mutex_acquire(&g_debug_cs_list_mutex);
@@ -150,6 +152,7 @@ void ObMysqlClientSession::destroy()
   is_already_send_trace_info_ = false;
   is_first_handle_close_request_ = true;
   is_in_trans_for_close_request_ = false;
+  is_local_infile_pending_ = false;
   is_first_dml_sql_got_ = false;
 
   schema_key_.reset();
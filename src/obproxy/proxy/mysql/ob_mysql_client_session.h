@@ -26,6 +26,7 @@
 #include "rpc/obmysql/packet/ompk_handshake.h"
 #include "optimizer/ob_sharding_select_log_plan.h"
 #include "optimizer/ob_proxy_optimizer_processor.h"
+#include "executor/ob_proxy_parallel_dml.h"
 
 namespace oceanbase
 {
@@ -239,6 +240,8 @@ public:
   bool is_first_handle_close_request() const { return is_first_handle_close_request_; }
   void set_in_trans_for_close_request(bool is_in_trans_for_close_request) { is_in_trans_for_close_request_ = is_in_trans_for_close_request; }
   bool is_in_trans_for_close_request() const { return is_in_trans_for_close_request_; }
+  void set_local_infile_pending(bool is_local_infile_pending) { is_local_infile_pending_ = is_local_infile_pending; }
+  bool is_local_infile_pending() const { return is_local_infile_pending_; }
 
   bool enable_analyze_internal_cmd() const { return session_info_.enable_analyze_internal_cmd(); }
   bool is_metadb_user() const { return session_info_.is_metadb_user(); }
@@ -263,6 +266,19 @@ public:
   
     select_plan_ = plan;
   }
+  executor::ObProxyParallelDmlPlan* get_parallel_dml_plan() const { return parallel_dml_plan_; }
+  void set_parallel_dml_plan(executor::ObProxyParallelDmlPlan *plan) {
+    if (NULL != parallel_dml_plan_) {
+      common::ObIAllocator *allocator = parallel_dml_plan_->get_allocator();
+      parallel_dml_plan_->~ObProxyParallelDmlPlan();
+      if (NULL != allocator) {
+        optimizer::get_global_optimizer_processor().free_allocator(allocator);
+      }
+      parallel_dml_plan_ = NULL;
+    }
+
+    parallel_dml_plan_ = plan;
+  }
 
   bool can_direct_ok() const { return can_direct_ok_; }
   void set_can_direct_ok(bool val) { can_direct_ok_ = val; }
@@ -334,6 +350,9 @@ public:
   bool is_already_send_trace_info_;
   bool is_first_handle_close_request_;
   bool is_in_trans_for_close_request_;
+  // server has asked for the file of LOAD DATA LOCAL INFILE, the next data
+  // from client is the file, not a command
+  bool is_local_infile_pending_;
   bool need_delete_cluster_;
   bool is_first_dml_sql_got_;//default false, will route with merge status careless
                              //it is true after user first dml sql arrived.
@@ -428,6 +447,7 @@ private:
   ObSessionStats session_stats_;
   ObTraceStats *trace_stats_;
   optimizer::ObShardingSelectLogPlan *select_plan_;
+  executor::ObProxyParallelDmlPlan *parallel_dml_plan_;
   ObBasePsEntryCache ps_cache_;
   uint32_t ps_id_;
   uint32_t cursor_id_;
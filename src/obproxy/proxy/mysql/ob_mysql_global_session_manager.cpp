@@ -188,6 +188,7 @@ int ObMysqlServerSessionList::add_server_session(ObMysqlServerSession* server_se
       ret = OB_SUCCESS;
       ATOMIC_INC(&total_count_);
       ATOMIC_INC(&create_count_);
+      adaptive_stat_.on_connect(server_session->connect_time_us_);
       LOG_DEBUG("succ add to local_ip_pool_", K(total_count_), K(server_session->ss_id_),
                 K(server_session->auth_user_), K(server_session->server_ip_), K(local_ip));
     }
@@ -377,6 +378,36 @@ int64_t ObMysqlServerSessionListPool::get_current_session_conn_count(
   return conn_count;
 }
 
+void ObMysqlServerSessionListPool::record_acquire_wait(const ObCommonAddr& key,
+                                                       const int64_t wait_time_us)
+{
+  ObMysqlServerSessionList* ss_list = NULL;
+  if (OB_SUCCESS == accquire_server_seession_list(key, ss_list)) {
+    ss_list->adaptive_stat_.on_wait(wait_time_us);
+    ss_list->dec_ref();
+  }
+}
+
+int ObMysqlServerSessionListPool::calc_adaptive_conn_count(const ObCommonAddr& key,
+    const int64_t min_conn, const int64_t max_conn,
+    int64_t &target_conn, int64_t &shrink_num)
+{
+  int ret = OB_SUCCESS;
+  ObMysqlServerSessionList* ss_list = NULL;
+  if (OB_FAIL(accquire_server_seession_list(key, ss_list))) {
+    LOG_DEBUG("server session list not exist", K(key), K(ret));
+  } else {
+    ObMysqlSessionPoolAdaptiveStat &stat = ss_list->adaptive_stat_;
+    const int64_t using_count = ss_list->total_count_ - ss_list->free_count_;
+    target_conn = stat.calc_target_conn(ObTimeUtility::current_time(), using_count, min_conn, max_conn);
+    shrink_num = stat.calc_shrink_num(ss_list->total_count_, ss_list->free_count_);
+    LOG_DEBUG("calc adaptive conn count", K(key), K(target_conn), K(shrink_num),
+              K(ss_list->total_count_), K(ss_list->free_count_));
+    ss_list->dec_ref();
+  }
+  return ret;
+}
+
 int64_t ObMysqlServerSessionListPool::incr_client_session_count()
 {
   int64_t old_count = client_session_count_;
@@ -446,9 +477,13 @@ int ObMysqlServerSessionListPool::accquire_server_seession_list(const ObCommonAd
   if (OB_SUCC(ret)) {
     if (OB_FAIL(accquire_server_seession_list(key, ss_list))) {
     } else if (NULL != (server_session = (ObMysqlServerSession*)ss_list->acquire_from_list())) {
+      server_session->acquire_time_ = ObTimeUtility::current_time();
       LOG_DEBUG("acquire_session succ", K(schema_key_.dbkey_),
                 K(key), K(client_session_count_), KP(server_session));
     }
+    if (new_client && NULL != ss_list) {
+      ss_list->adaptive_stat_.on_acquire(NULL != server_session);
+    }
     if (new_client && (OB_FAIL(ret) || NULL == server_session)) {
       ret = OB_SUCCESS;
       decr_client_session_count(); //before has inc, when get fail or null should decr
@@ -484,6 +519,9 @@ int ObMysqlServerSessionListPool::release_session(ObMysqlServerSession &ss)
   decr_client_session_count();
   if (OB_FAIL(accquire_server_seession_list(key, ss_list))) {
   } else {
+    if (ss.acquire_time_ > 0) {
+      ss_list->adaptive_stat_.on_release(ss.last_active_time_ - ss.acquire_time_);
+    }
     int64_t max_count = ObMysqlSessionUtils::get_session_max_conn(schema_key_);
     if (ss_list->total_count_ <= max_count) {
       ret = ss_list->release_to_list(ss);
@@ -918,6 +956,35 @@ int64_t ObMysqlGlobalSessionManager::get_current_session_conn_count(const common
   }
   return conn_count;
 }
+void ObMysqlGlobalSessionManager::record_acquire_wait(const common::ObString& dbkey,
+    const ObCommonAddr& common_addr,
+    const int64_t wait_time_us)
+{
+  ObMysqlServerSessionListPool* server_session_list_pool = get_server_session_list_pool(dbkey);
+  if (OB_NOT_NULL(server_session_list_pool)) {
+    server_session_list_pool->record_acquire_wait(common_addr, wait_time_us);
+    server_session_list_pool->dec_ref();
+  }
+}
+
+int ObMysqlGlobalSessionManager::calc_adaptive_conn_count(const common::ObString& dbkey,
+    const ObCommonAddr& common_addr,
+    const int64_t min_conn, const int64_t max_conn,
+    int64_t &target_conn, int64_t &shrink_num)
+{
+  int ret = OB_SUCCESS;
+  ObMysqlServerSessionListPool* server_session_list_pool = get_server_session_list_pool(dbkey);
+  if (OB_ISNULL(server_session_list_pool)) {
+    ret = OB_ENTRY_NOT_EXIST;
+    LOG_WARN("server_session_list_pool is null, should not here", K(dbkey), K(ret));
+  } else {
+    ret = server_session_list_pool->calc_adaptive_conn_count(common_addr, min_conn, max_conn,
+                                                             target_conn, shrink_num);
+    server_session_list_pool->dec_ref();
+  }
+  return ret;
+}
+
 int ObMysqlGlobalSessionManager::add_server_addr_if_not_exist(const ObProxySchemaKey& schema_key,
     const common::ObString& server_ip,
     int32_t server_port,
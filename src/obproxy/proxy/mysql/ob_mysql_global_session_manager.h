@@ -22,6 +22,7 @@
 #include "proxy/mysql/ob_mysql_server_session.h"
 #include "proxy/mysql/ob_mysql_session_manager.h"
 #include "proxy/mysql/ob_mysql_client_session.h"
+#include "proxy/mysql/ob_mysql_session_pool_adaptive.h"
 #include "obutils/ob_proxy_config.h"
 
 
@@ -95,6 +96,7 @@ public:
   int64_t create_count_;
   int64_t destroy_count_;
   int64_t last_log_time_;
+  ObMysqlSessionPoolAdaptiveStat adaptive_stat_;
   event::ObProxyMutex m_;
 public:
   LINK(ObMysqlServerSessionList, ip_hash_link_);
@@ -130,6 +132,9 @@ public:
   int64_t incr_client_session_count();
   int64_t decr_client_session_count();
   int64_t get_current_session_conn_count(const ObCommonAddr& key);
+  void record_acquire_wait(const ObCommonAddr& key, const int64_t wait_time_us);
+  int calc_adaptive_conn_count(const ObCommonAddr& key, const int64_t min_conn, const int64_t max_conn,
+                               int64_t &target_conn, int64_t &shrink_num);
   int add_server_addr_if_not_exist(const ObCommonAddr& common_addr);
   int add_server_addr_if_not_exist(const common::ObString& server_ip, int32_t server_port, bool is_physical);
   int remove_server_addr_if_exist(const common::ObString& server_ip, int32_t server_port, bool is_physical);
@@ -188,6 +193,13 @@ public:
     int64_t need_close_num);
   int64_t get_current_session_conn_count(const common::ObString& dbkey,
                                          const ObCommonAddr& common_addr);
+  // record the time a client waited for a free server session when pool is full
+  void record_acquire_wait(const common::ObString& dbkey, const ObCommonAddr& common_addr,
+                           const int64_t wait_time_us);
+  // only called by conn num check task, get the conn count the pool should keep
+  int calc_adaptive_conn_count(const common::ObString& dbkey, const ObCommonAddr& common_addr,
+                               const int64_t min_conn, const int64_t max_conn,
+                               int64_t &target_conn, int64_t &shrink_num);
   ObMysqlServerSessionListPool* get_server_session_list_pool(const common::ObString& dbkey);
 
   int add_schema_if_not_exist(const ObProxySchemaKey& schema_key,
@@ -26,6 +26,7 @@
 #include "iocore/net/ob_ssl_processor.h"
 #include "obutils/ob_proxy_config.h"
 #include "dbconfig/ob_proxy_db_config_processor.h"
+#include "lib/allocator/ob_hugepage_arena.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obproxy::event;
@@ -161,20 +162,31 @@ int ObMysqlProxyServerMain::start_mysql_proxy_server(const ObMysqlConfigParams &
 int ObMysqlProxyServerMain::start_processor_threads(const ObMysqlConfigParams &config_params)
 {
   int ret = OB_SUCCESS;
+  int tmp_ret = OB_SUCCESS;
   int64_t stack_size = config_params.stack_size_;
   int64_t event_threads = config_params.work_thread_num_;
   int64_t task_threads = config_params.task_thread_num_;
   bool enable_cpu_topology = config_params.enable_cpu_topology_;
+  bool enable_numa_affinity = config_params.enable_numa_affinity_;
   bool automatic_match_work_thread = config_params.automatic_match_work_thread_;
   int64_t blocking_threads = config_params.block_thread_num_; //thread for blocking task
   int64_t grpc_threads = config_params.grpc_thread_num_;
   int64_t grpc_watch_threads = 1;
+  const int64_t hugepage_arena_size = get_global_proxy_config().hugepage_arena_size;
   if (OB_UNLIKELY(stack_size <= 0) || OB_UNLIKELY(event_threads <= 0)
       || OB_UNLIKELY(task_threads <= 0)) {
     ret = OB_INVALID_CONFIG;
     LOG_WARN("invalid variable", K(stack_size), K(event_threads), K(task_threads), K(ret));
+  } else if (hugepage_arena_size > 0
+             && OB_SUCCESS != (tmp_ret = ObHugePageArena::get_instance().init(hugepage_arena_size))) {
+    // not fatal, io buffers and object pool chunks just come from ob_malloc
+    LOG_WARN("fail to init hugepage arena", K(hugepage_arena_size), K(tmp_ret));
+  }
+
+  if (OB_FAIL(ret)) {
   } else if (OB_FAIL(g_event_processor.start(static_cast<int>(event_threads), stack_size,
-                                             enable_cpu_topology, automatic_match_work_thread))) {
+                                             enable_cpu_topology, automatic_match_work_thread,
+                                             enable_numa_affinity))) {
     LOG_ERROR("fail to start event processor", K(stack_size), K(event_threads), K(ret));
   } else if (OB_FAIL(g_net_processor.start())) {
     LOG_ERROR("fail to start net processor", K(ret));
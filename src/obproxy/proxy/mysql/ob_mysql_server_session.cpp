@@ -64,6 +64,7 @@ int ObMysqlServerSession::new_connection(ObMysqlClientSession &client_session, O
     PROXY_SS_LOG(WARN, "init twice", K(is_inited_), K(ret));
   } else {
     client_session_ = &client_session;
+    last_cs_id_ = client_session.get_cs_id();
     server_vc_ = &new_vc;
     mutex_ = new_vc.mutex_;
 
@@ -109,8 +110,9 @@ int ObMysqlServerSession::new_connection(ObMysqlClientSession &client_session, O
           state_ = MSS_INIT;
           is_inited_ = true;
           if (is_pool_session_) {
-            ret = get_global_session_manager().add_server_session(*this);
             create_time_ = ObTimeUtility::current_time();
+            acquire_time_ = create_time_;
+            ret = get_global_session_manager().add_server_session(*this);
           }
         }
       } else {
@@ -189,13 +191,65 @@ void ObMysqlServerSession::reenable(ObVIO *vio)
   server_vc_->reenable(vio);
 }
 
+void ObMysqlServerSession::set_client_session(ObMysqlClientSession &client_session)
+{
+  if (is_pool_session_ && last_cs_id_ != client_session.get_cs_id()) {
+    // ps and cursor ids are allocated by each client session, the ones left by
+    // the last client mean nothing to this one, prepare them again when used
+    PROXY_SS_LOG(DEBUG, "pool session rebound to another client session",
+                 K_(ss_id), K_(last_cs_id), "cs_id", client_session.get_cs_id());
+    session_info_.destroy_ps_id_pair_map();
+    session_info_.destroy_cursor_id_pair_map();
+    session_info_.reset_text_ps_name_set();
+    session_info_.reset_server_ps_id();
+  }
+  last_cs_id_ = client_session.get_cs_id();
+  client_session_ = &client_session;
+}
+
+bool ObMysqlServerSession::is_bound_to_client() const
+{
+  return get_global_proxy_config().enable_server_session_multiplex && session_info_.has_client_state();
+}
+
+bool ObMysqlServerSession::is_create_temp_table(const ObString &sql)
+{
+  // CREATE [GLOBAL] TEMPORARY TABLE, look for the keyword before TABLE
+  static const int64_t MAX_WORD_COUNT = 16;
+  bool bret = false;
+  bool is_end = false;
+  const char *pos = sql.ptr();
+  const char *end = sql.ptr() + sql.length();
+  for (int64_t i = 0; !bret && !is_end && i < MAX_WORD_COUNT; ++i) {
+    while (pos < end && !isalnum(*pos) && '_' != *pos) {
+      ++pos;
+    }
+    const char *word = pos;
+    while (pos < end && (isalnum(*pos) || '_' == *pos)) {
+      ++pos;
+    }
+    const int64_t len = pos - word;
+    if (0 == len || (5 == len && 0 == strncasecmp(word, "table", 5))) {
+      is_end = true;
+    } else if (9 == len && 0 == strncasecmp(word, "temporary", 9)) {
+      bret = true;
+    }
+  }
+  return bret;
+}
+
 int ObMysqlServerSession::release()
 {
   int ret = OB_SUCCESS;
   PROXY_SS_LOG(DEBUG, "Releasing server session", K(server_trans_stat_));
   // Set our state to KA for stat issues
   state_ = MSS_KA_SHARED;
-  if (is_pool_session_) {
+  if (is_pool_session_ && is_bound_to_client()) {
+    // the state can not be cleared on server, it must not be seen by another client
+    PROXY_SS_LOG(DEBUG, "server session holds client state, close it instead of release to pool",
+                 K_(ss_id), K_(last_cs_id));
+    do_io_close();
+  } else if (is_pool_session_) {
     if (OB_NOT_NULL(client_session_)
         && !client_session_->get_session_info().is_sharding_user()
         && get_global_proxy_config().enable_no_sharding_skip_real_conn) {
@@ -87,9 +87,9 @@ public:
       : event::ObVConnection(NULL), server_sessid_(0), ss_id_(0), transact_count_(0),
         state_(MSS_INIT), server_trans_stat_(0),
         read_buffer_(NULL), is_pool_session_(false), has_global_session_lock_(false),
-        create_time_(0), last_active_time_(0),
+        create_time_(0), last_active_time_(0), acquire_time_(0), connect_time_us_(0),
         is_inited_(false), magic_(MYSQL_SS_MAGIC_DEAD), server_vc_(NULL),
-        buf_reader_(NULL), client_session_(NULL)
+        buf_reader_(NULL), client_session_(NULL), last_cs_id_(0)
   {
     memset(&local_ip_, 0, sizeof(local_ip_));
     memset(&server_ip_, 0, sizeof(server_ip_));
@@ -131,7 +131,11 @@ public:
   int release();
   net::ObNetVConnection *get_netvc() const { return server_vc_; }
 
-  void set_client_session(ObMysqlClientSession &client_session) { client_session_ = &client_session; }
+  void set_client_session(ObMysqlClientSession &client_session);
+  // with server session multiplex, a session holding state of its client is
+  // kept by that client and closed with it, it never goes to another client
+  bool is_bound_to_client() const;
+  static bool is_create_temp_table(const common::ObString &sql);
   void clear_client_session() { client_session_ = NULL; }
   ObMysqlClientSession *get_client_session() { return client_session_; }
   ObServerSessionInfo &get_session_info() { return session_info_; }
@@ -218,6 +222,10 @@ public:
   ObProxySchemaKey schema_key_;
   int64_t create_time_;
   int64_t last_active_time_;
+  // when the session was taken from the global session pool, used to get the hold time
+  int64_t acquire_time_;
+  // tcp connect time of this session, used by session pool adaptive sizing
+  int64_t connect_time_us_;
 
 private:
   static int64_t get_next_ss_id();
@@ -232,6 +240,8 @@ private:
 
   ObServerSessionInfo session_info_;
   ObMysqlClientSession *client_session_;
+  // the client session this pool session was last bound to
+  uint32_t last_cs_id_;
   DISALLOW_COPY_AND_ASSIGN(ObMysqlServerSession);
 };
 
@@ -0,0 +1,162 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+#include "proxy/mysql/ob_mysql_session_pool_adaptive.h"
+#include <math.h>
+#include "obutils/ob_proxy_config.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obproxy::obutils;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace proxy
+{
+const double ObMysqlSessionPoolAdaptiveStat::EWMA_ALPHA = 0.3;
+
+void ObMysqlSessionPoolAdaptiveStat::reset()
+{
+  acquire_count_ = 0;
+  acquire_miss_count_ = 0;
+  release_count_ = 0;
+  hold_time_us_ = 0;
+  wait_count_ = 0;
+  wait_time_us_ = 0;
+  connect_count_ = 0;
+  connect_time_us_ = 0;
+
+  last_calc_time_us_ = 0;
+  last_day_slot_ = -1;
+  last_acquire_count_ = 0;
+  last_release_count_ = 0;
+  last_hold_time_us_ = 0;
+  last_wait_count_ = 0;
+  last_wait_time_us_ = 0;
+  last_connect_count_ = 0;
+  last_connect_time_us_ = 0;
+  acquire_rate_ = 0;
+  wait_rate_ = 0;
+  avg_hold_time_us_ = 0;
+  avg_wait_time_us_ = 0;
+  avg_connect_time_us_ = 0;
+  target_conn_ = 0;
+  MEMSET(day_slot_target_, 0, sizeof(day_slot_target_));
+}
+
+int64_t ObMysqlSessionPoolAdaptiveStat::get_prewarm_conn(const int64_t now_us) const
+{
+  int64_t prewarm_conn = 0;
+  const int64_t prewarm_time_us = get_global_proxy_config().session_pool_adaptive_prewarm_time;
+  if (prewarm_time_us > 0) {
+    const int64_t slot_us = DAY_SLOT_SECONDS * 1000000;
+    const int64_t lookahead = std::min((prewarm_time_us + slot_us - 1) / slot_us, DAY_SLOT_COUNT - 1);
+    for (int64_t i = 1; i <= lookahead; ++i) {
+      prewarm_conn = std::max(prewarm_conn, day_slot_target_[get_day_slot(now_us + i * slot_us)]);
+    }
+  }
+  return prewarm_conn;
+}
+
+int64_t ObMysqlSessionPoolAdaptiveStat::calc_target_conn(const int64_t now_us, const int64_t using_count,
+                                                         const int64_t min_conn, const int64_t max_conn)
+{
+  const int64_t acquire_count = ATOMIC_LOAD(&acquire_count_);
+  const int64_t release_count = ATOMIC_LOAD(&release_count_);
+  const int64_t hold_time_us = ATOMIC_LOAD(&hold_time_us_);
+  const int64_t wait_count = ATOMIC_LOAD(&wait_count_);
+  const int64_t wait_time_us = ATOMIC_LOAD(&wait_time_us_);
+  const int64_t connect_count = ATOMIC_LOAD(&connect_count_);
+  const int64_t connect_time_us = ATOMIC_LOAD(&connect_time_us_);
+
+  if (last_calc_time_us_ > 0 && now_us > last_calc_time_us_) {
+    const bool is_first = (last_day_slot_ < 0);
+    const double interval_s = static_cast<double>(now_us - last_calc_time_us_) / 1000000;
+    const int64_t delta_release = release_count - last_release_count_;
+    const int64_t delta_wait = wait_count - last_wait_count_;
+    const int64_t delta_connect = connect_count - last_connect_count_;
+
+    acquire_rate_ = ewma(acquire_rate_, static_cast<double>(acquire_count - last_acquire_count_) / interval_s, is_first);
+    wait_rate_ = ewma(wait_rate_, static_cast<double>(delta_wait) / interval_s, is_first);
+    if (delta_release > 0) {
+      avg_hold_time_us_ = ewma(avg_hold_time_us_,
+          static_cast<double>(hold_time_us - last_hold_time_us_) / static_cast<double>(delta_release),
+          avg_hold_time_us_ <= 0);
+    }
+    if (delta_wait > 0) {
+      avg_wait_time_us_ = ewma(avg_wait_time_us_,
+          static_cast<double>(wait_time_us - last_wait_time_us_) / static_cast<double>(delta_wait),
+          avg_wait_time_us_ <= 0);
+    }
+    if (delta_connect > 0) {
+      avg_connect_time_us_ = ewma(avg_connect_time_us_,
+          static_cast<double>(connect_time_us - last_connect_time_us_) / static_cast<double>(delta_connect),
+          avg_connect_time_us_ <= 0);
+    }
+
+    // Little's law: L = lambda * W
+    const double busy_conn = acquire_rate_ * avg_hold_time_us_ / 1000000;
+    const double queue_conn = wait_rate_ * avg_wait_time_us_ / 1000000;
+    const double spare_conn = acquire_rate_ * avg_connect_time_us_ / 1000000;
+    const int64_t headroom = get_global_proxy_config().session_pool_adaptive_headroom;
+    int64_t target_conn = static_cast<int64_t>(
+        ceil((busy_conn + queue_conn) * static_cast<double>(100 + headroom) / 100 + spare_conn));
+
+    // remember the load of this time-of-day slot, older days fade out by 1/4 per day
+    const int64_t day_slot = get_day_slot(now_us);
+    if (day_slot != last_day_slot_) {
+      day_slot_target_[day_slot] = day_slot_target_[day_slot] * 3 / 4;
+      last_day_slot_ = day_slot;
+    }
+    day_slot_target_[day_slot] = std::max(day_slot_target_[day_slot], target_conn);
+
+    target_conn = std::max(target_conn, get_prewarm_conn(now_us));
+    target_conn = std::max(target_conn, using_count);
+    target_conn = std::max(target_conn, min_conn);
+    target_conn = std::min(target_conn, max_conn);
+    target_conn_ = target_conn;
+  } else {
+    // first round, only take a snapshot of the counters
+    target_conn_ = std::min(std::max(using_count, min_conn), max_conn);
+  }
+
+  last_calc_time_us_ = now_us;
+  last_acquire_count_ = acquire_count;
+  last_release_count_ = release_count;
+  last_hold_time_us_ = hold_time_us;
+  last_wait_count_ = wait_count;
+  last_wait_time_us_ = wait_time_us;
+  last_connect_count_ = connect_count;
+  last_connect_time_us_ = connect_time_us;
+  LOG_DEBUG("calc session pool target conn", K(using_count), K(min_conn), K(max_conn), K(*this));
+  return target_conn_;
+}
+
+int64_t ObMysqlSessionPoolAdaptiveStat::calc_shrink_num(const int64_t total_count,
+                                                        const int64_t free_count) const
+{
+  int64_t shrink_num = 0;
+  if (total_count > target_conn_ && free_count > 0) {
+    const int64_t ratio = get_global_proxy_config().session_pool_adaptive_shrink_ratio;
+    const int64_t extra_count = total_count - target_conn_;
+    // close only part of the extra idle connections each round, so a short dip does not drain the pool
+    shrink_num = std::max((extra_count * ratio + 99) / 100, 1L);
+    shrink_num = std::min(shrink_num, free_count);
+  }
+  return shrink_num;
+}
+
+} // end of namespace proxy
+} // end of namespace obproxy
+} // end of namespace oceanbase
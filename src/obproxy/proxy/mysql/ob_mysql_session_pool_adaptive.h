@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OB_MYSQL_SESSION_POOL_ADAPTIVE_H_
+#define OB_MYSQL_SESSION_POOL_ADAPTIVE_H_
+#include "lib/ob_define.h"
+#include "lib/atomic/ob_atomic.h"
+#include "lib/utility/ob_print_utils.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace proxy
+{
+/*
+ * Adaptive sizing state for one (schema, server) session list.
+ *
+ * Work threads only bump the atomic counters (on_acquire/on_release/on_connect/on_wait).
+ * The conn num check task calls calc_target_conn() periodically, which turns the counter
+ * deltas into smoothed rates and sizes the pool with Little's law:
+ *
+ *   busy_conn  = acquire_rate * avg_hold_time
+ *   queue_conn = wait_rate * avg_wait_time        (requests stalled in retry acquire)
+ *   spare_conn = acquire_rate * avg_connect_time  (arrivals while a new conn is connecting)
+ *   target     = (busy_conn + queue_conn) * (1 + headroom) + spare_conn
+ *
+ * The target of every time-of-day slot is remembered, so the pool can be prewarmed
+ * before the daily ramp starts; shrinking is done by calc_shrink_num() step by step.
+ */
+class ObMysqlSessionPoolAdaptiveStat
+{
+public:
+  static const int64_t DAY_SLOT_SECONDS = 15 * 60;
+  static const int64_t DAY_SLOT_COUNT = 24 * 3600 / DAY_SLOT_SECONDS;
+
+  ObMysqlSessionPoolAdaptiveStat() { reset(); }
+  ~ObMysqlSessionPoolAdaptiveStat() { }
+  void reset();
+
+  void on_acquire(const bool hit)
+  {
+    ATOMIC_INC(&acquire_count_);
+    if (!hit) {
+      ATOMIC_INC(&acquire_miss_count_);
+    }
+  }
+  void on_release(const int64_t hold_time_us)
+  {
+    if (hold_time_us > 0) {
+      ATOMIC_INC(&release_count_);
+      (void)ATOMIC_AAF(&hold_time_us_, hold_time_us);
+    }
+  }
+  void on_connect(const int64_t connect_time_us)
+  {
+    if (connect_time_us > 0) {
+      ATOMIC_INC(&connect_count_);
+      (void)ATOMIC_AAF(&connect_time_us_, connect_time_us);
+    }
+  }
+  void on_wait(const int64_t wait_time_us)
+  {
+    if (wait_time_us > 0) {
+      ATOMIC_INC(&wait_count_);
+      (void)ATOMIC_AAF(&wait_time_us_, wait_time_us);
+    }
+  }
+
+  // only called by the conn num check task
+  int64_t calc_target_conn(const int64_t now_us, const int64_t using_count,
+                           const int64_t min_conn, const int64_t max_conn);
+  int64_t calc_shrink_num(const int64_t total_count, const int64_t free_count) const;
+
+  int64_t get_target_conn() const { return target_conn_; }
+  int64_t get_acquire_rate() const { return static_cast<int64_t>(acquire_rate_); }
+  int64_t get_avg_hold_time_us() const { return static_cast<int64_t>(avg_hold_time_us_); }
+  int64_t get_avg_wait_time_us() const { return static_cast<int64_t>(avg_wait_time_us_); }
+  int64_t get_avg_connect_time_us() const { return static_cast<int64_t>(avg_connect_time_us_); }
+
+  TO_STRING_KV(K_(acquire_count), K_(acquire_miss_count), K_(release_count), K_(wait_count),
+               K_(connect_count), K_(acquire_rate), K_(wait_rate), K_(avg_hold_time_us),
+               K_(avg_wait_time_us), K_(avg_connect_time_us), K_(target_conn));
+
+private:
+  static double ewma(const double old_value, const double new_value, const bool is_first)
+  {
+    return is_first ? new_value : (old_value * (1 - EWMA_ALPHA) + new_value * EWMA_ALPHA);
+  }
+  static int64_t get_day_slot(const int64_t time_us)
+  {
+    return ((time_us / 1000000) % (24 * 3600)) / DAY_SLOT_SECONDS;
+  }
+  int64_t get_prewarm_conn(const int64_t now_us) const;
+
+private:
+  static const double EWMA_ALPHA;
+
+  // updated by work threads
+  volatile int64_t acquire_count_;
+  volatile int64_t acquire_miss_count_;
+  volatile int64_t release_count_;
+  volatile int64_t hold_time_us_;
+  volatile int64_t wait_count_;
+  volatile int64_t wait_time_us_;
+  volatile int64_t connect_count_;
+  volatile int64_t connect_time_us_;
+
+  // updated by conn num check task
+  int64_t last_calc_time_us_;
+  int64_t last_day_slot_;
+  int64_t last_acquire_count_;
+  int64_t last_release_count_;
+  int64_t last_hold_time_us_;
+  int64_t last_wait_count_;
+  int64_t last_wait_time_us_;
+  int64_t last_connect_count_;
+  int64_t last_connect_time_us_;
+  double acquire_rate_;
+  double wait_rate_;
+  double avg_hold_time_us_;
+  double avg_wait_time_us_;
+  double avg_connect_time_us_;
+  int64_t target_conn_;
+  int64_t day_slot_target_[DAY_SLOT_COUNT];
+};
+
+} // end of namespace proxy
+} // end of namespace obproxy
+} // end of namespace oceanbase
+#endif // OB_MYSQL_SESSION_POOL_ADAPTIVE_H_
@@ -51,6 +51,9 @@
 #include "cmd/ob_show_topology_handler.h"
 #include "cmd/ob_show_db_version_handler.h"
 #include "obutils/ob_tenant_stat_manager.h"
+#include "obutils/ob_latency_histogram.h"
+#include "obutils/ob_sql_digest.h"
+#include "obutils/ob_monitor_binlog.h"
 #include "prometheus/ob_net_prometheus.h"
 #include "prometheus/ob_sql_prometheus.h"
 #include "lib/profile/ob_trace_id.h"
@@ -64,6 +67,7 @@
 #include "optimizer/ob_proxy_optimizer_processor.h"
 #include "dbconfig/ob_proxy_pb_utils.h"
 #include "proxy/mysql/ob_mysql_global_session_manager.h"
+#include "executor/ob_proxy_parallel_execute_cont.h"
 
 using namespace oceanbase::share;
 using namespace oceanbase::common;
@@ -77,6 +81,7 @@ using namespace oceanbase::obproxy::qos;
 using namespace oceanbase::obproxy::dbconfig;
 using namespace oceanbase::obproxy::engine;
 using namespace oceanbase::obproxy::optimizer;
+using namespace oceanbase::obproxy::executor;
 
 namespace oceanbase
 {
@@ -721,7 +726,11 @@ int ObMysqlSM::state_client_request_read(int event, void *data)
                 callout_api_and_start_next_action(ObMysqlTransact::SM_ACTION_API_SEND_RESPONSE);
               }
             } else {
-              if (NULL == client_session_->get_sharding_select_log_plan()) {
+              if (NULL != client_session_->get_parallel_dml_plan()) {
+                if (OB_FAIL(setup_handle_parallel_dml())) {
+                  LOG_WARN("fail to setup handle parallel dml", K_(sm_id), K(ret));
+                }
+              } else if (NULL == client_session_->get_sharding_select_log_plan()) {
                 if (client_session_->get_session_info().is_oceanbase_server()) {
                   setup_get_cluster_resource();
                 } else {
@@ -885,6 +894,150 @@ int ObMysqlSM::state_handle_execute_plan(int event, void *data)
   return VC_EVENT_NONE;
 }
 
+int ObMysqlSM::setup_handle_parallel_dml()
+{
+  int ret = OB_SUCCESS;
+
+  LOG_DEBUG("setup handle parallel dml");
+  MYSQL_SM_SET_DEFAULT_HANDLER(&ObMysqlSM::state_handle_parallel_dml);
+
+  ObProxyParallelDmlPlan *plan = NULL;
+  int64_t total_len = client_buffer_reader_->read_avail();
+  if (total_len > trans_state_.trans_info_.client_request_.get_packet_meta().pkt_len_) {
+    total_len = trans_state_.trans_info_.client_request_.get_packet_meta().pkt_len_;
+  }
+
+  ObHRTime execute_timeout = client_session_->get_session_info().get_query_timeout();
+
+  // consume data in client buffer reader
+  if (OB_FAIL(client_buffer_reader_->consume(total_len))) {
+    LOG_WARN("fail to consume all", K_(sm_id), K(ret));
+  } else if (OB_ISNULL(plan = client_session_->get_parallel_dml_plan())) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("parallel dml plan should not be null", K_(sm_id), K(ret));
+  } else if (OB_NOT_NULL(pending_action_)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("pending_action must be NULL here", K_(pending_action), K_(sm_id), K(ret));
+  } else if (OB_FAIL(get_global_parallel_processor().open(*this, pending_action_, plan->get_parallel_param(),
+                                                          plan->get_allocator(), hrtime_to_msec(execute_timeout)))) {
+    LOG_WARN("fail to open parallel processor", K_(sm_id), KPC(plan), K(ret));
+  } else if (OB_ISNULL(pending_action_)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("pending action should not be null", K_(sm_id), K(ret));
+  } else {
+    LOG_DEBUG("succ to open parallel dml", K_(sm_id), KPC(plan));
+    client_session_->set_inactivity_timeout(execute_timeout);
+  }
+
+  return ret;
+}
+
+int ObMysqlSM::state_handle_parallel_dml(int event, void *data)
+{
+  int ret = OB_SUCCESS;
+
+  STATE_ENTER(ObMysqlSM::state_handle_parallel_dml, event);
+
+  ObProxyParallelDmlPlan *plan = client_session_->get_parallel_dml_plan();
+  ObProxyParallelResp *resp = NULL;
+
+  switch (event) {
+    case VC_EVENT_READ_READY:
+    case VC_EVENT_READ_COMPLETE:
+      if (OB_ISNULL(resp = reinterpret_cast<ObProxyParallelResp *>(data))) {
+        ret = OB_ERR_NULL_VALUE;
+        LOG_WARN("data is NULL", K_(sm_id), K(ret));
+      } else if (OB_ISNULL(plan)) {
+        ret = OB_ERR_UNEXPECTED;
+        LOG_WARN("parallel dml plan should not be null", K_(sm_id), K(ret));
+      } else if (OB_FAIL(plan->handle_resp(*resp))) {
+        LOG_WARN("fail to handle parallel dml resp, will disconnect", K_(sm_id), K(ret));
+      }
+
+      if (OB_NOT_NULL(resp)) {
+        op_free(resp);
+        resp = NULL;
+      }
+
+      if (VC_EVENT_READ_COMPLETE == event) {
+        pending_action_ = NULL;
+        if (OB_SUCC(ret)) {
+          if (OB_FAIL(process_parallel_dml_result(*plan))) {
+            LOG_WARN("fail to process parallel dml result, will disconnect", K_(sm_id), K(ret));
+          } else {
+            trans_state_.next_action_ = ObMysqlTransact::SM_ACTION_INTERNAL_NOOP;
+            callout_api_and_start_next_action(ObMysqlTransact::SM_ACTION_API_SEND_RESPONSE);
+          }
+        }
+      } else if (OB_FAIL(ret) && OB_NOT_NULL(pending_action_)) {
+        pending_action_->cancel();
+        pending_action_ = NULL;
+      }
+      break;
+    case VC_EVENT_EOS:
+    case VC_EVENT_ACTIVE_TIMEOUT:
+    case VC_EVENT_INACTIVITY_TIMEOUT:
+      pending_action_ = NULL;
+      LOG_WARN("handle parallel dml meet error, will disconnect", K_(sm_id),
+               "event", ObMysqlDebugNames::get_event_name(event), K(ret));
+      ret = OB_CONNECT_ERROR;
+      break;
+    case VC_EVENT_ERROR:
+      pending_action_ = NULL;
+      LOG_WARN("handle parallel dml meet error, will disconnect", K_(sm_id),
+               "event", ObMysqlDebugNames::get_event_name(event), K(ret));
+      ret = OB_ERR_UNEXPECTED;
+      break;
+    default: {
+      ret = OB_ERR_UNEXPECTED;
+      LOG_ERROR("Unexpected event", K_(sm_id), K(event), K(ret));
+      break;
+    }
+  }
+
+  if (OB_FAIL(ret)) {
+    trans_state_.free_internal_buffer();
+    trans_state_.inner_errcode_ = ret;
+    call_transact_and_set_next_state(ObMysqlTransact::handle_error_jump);
+  }
+
+  return VC_EVENT_NONE;
+}
+
+int ObMysqlSM::process_parallel_dml_result(ObProxyParallelDmlPlan &plan)
+{
+  int ret = OB_SUCCESS;
+
+  ObProxyMysqlRequest &client_request = trans_state_.trans_info_.client_request_;
+  uint8_t seq = static_cast<uint8_t>(client_request.get_packet_meta().pkt_seq_ + 1);
+  ObMIOBuffer *buf = NULL;
+
+  if (NULL != trans_state_.internal_buffer_) {
+    buf = trans_state_.internal_buffer_;
+  } else {
+    if (OB_FAIL(trans_state_.alloc_internal_buffer(MYSQL_BUFFER_SIZE))) {
+      LOG_WARN("fail to allocate internal buffer", K(ret));
+    } else {
+      buf = trans_state_.internal_buffer_;
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    if (plan.is_error()) {
+      // the sub sqls are auto committed separately, only the first error is returned
+      if (OB_FAIL(ObMysqlPacketUtil::encode_err_packet_buf(*buf, seq, plan.get_err_code(), plan.get_err_msg()))) {
+        LOG_WARN("fail to encode err pacekt buf", K(seq), K(plan), K(ret));
+      }
+    } else if (OB_FAIL(ObMysqlPacketUtil::encode_ok_packet(*buf, seq, plan.get_affected_rows(),
+                       client_session_->get_session_info().get_orig_capability_flags(),
+                       plan.get_server_status(), plan.get_last_insert_id(), plan.get_warnings()))) {
+      LOG_WARN("fail to encode ok packet", K(seq), K(plan), K(ret));
+    }
+  }
+
+  return ret;
+}
+
 int ObMysqlSM::process_executor_result(ObProxyResultResp *result_resp)
 {
   int ret = OB_SUCCESS;
@@ -1534,6 +1687,7 @@ inline int ObMysqlSM::init_request_content(ObRequestAnalyzeCtx &ctx)
     trans_state_.trans_info_.client_request_.set_user_identity(client_session_->get_user_identity());
 
     ctx.is_sharding_mode_ = client_session_->get_session_info().is_sharding_user();
+    ctx.is_local_infile_ = client_session_->is_local_infile_pending();
   }
 
   if (OB_SUCC(ret)) {
@@ -2012,6 +2166,11 @@ int ObMysqlSM::analyze_ps_execute_request()
       session_info.set_ps_entry(entry);
       session_info.set_client_ps_id(ps_id);
       client_request.set_ps_parse_result(&entry->get_base_ps_parse_result());
+      // the rows prefetched from the cursor of last execute are stale now
+      ObCursorIdAddr *cursor_id_addr = session_info.get_cursor_id_addr(ps_id);
+      if (NULL != cursor_id_addr) {
+        cursor_id_addr->reset_prefetch();
+      }
       // no need to analyze execute param value here,
       // will do analyze when needed before calculate partition id
     }
@@ -2126,7 +2285,18 @@ int ObMysqlSM::analyze_fetch_request()
     uint32_t cursor_id = 0;
     ObMySQLUtil::get_uint4(pos, cursor_id);
     session_info.set_client_cursor_id(cursor_id);
-    LOG_DEBUG("fetch cursor id", K(cursor_id));
+
+    // only the plain forward fetch of mysql mode can be served by prefetched rows,
+    // oracle mode fetch may carry orientation and offset after num_rows
+    uint32_t fetch_rows = 0;
+    ObCursorIdAddr *cursor_id_addr = NULL;
+    if (OB_SUCCESS == session_info.get_cursor_id_addr(cursor_id_addr) && NULL != cursor_id_addr) {
+      if (!session_info.is_oracle_mode() && MYSQL_NET_META_LENGTH + 8 == data.length()) {
+        ObMySQLUtil::get_uint4(pos, fetch_rows);
+      }
+      cursor_id_addr->set_fetch_rows(fetch_rows);
+    }
+    LOG_DEBUG("fetch cursor id", K(cursor_id), K(fetch_rows));
   }
 
   return ret;
@@ -2477,6 +2647,8 @@ int ObMysqlSM::state_observer_open(int event, void *data)
             session->get_session_info().set_shard_connector(shard_conn);
           }
 
+          session->connect_time_us_ = hrtime_to_usec(
+              milestone_diff(milestones_.server_connect_begin_, milestones_.server_connect_end_));
           if (OB_FAIL(session->new_connection(*client_session_, *(reinterpret_cast<ObNetVConnection *>(data))))) {
             LOG_WARN("fail to new server connection", K_(sm_id), K(ret));
           } else {
@@ -2964,6 +3136,10 @@ inline int ObMysqlSM::handle_first_normal_response_packet(ObMysqlAnalyzeStatus &
       LOG_DEBUG("handle_first_normal_response_packet", K(trans_state_.current_.state_),
                 K(is_in_trans_), K(is_autocommit_0), K(enable_extra_ok_packet_for_stats));
     }
+    // the file is streamed by the request tunnel, which has no compression
+    analyzer_.set_enable_local_infile(trans_state_.mysql_config_params_->enable_local_infile_stream_
+                                      && OB_MYSQL_COM_QUERY == trans_state_.trans_info_.sql_cmd_
+                                      && !client_session_->get_session_info().is_sharding_user());
     if (OB_FAIL(analyzer_.analyze_response(
           *server_buffer_reader_, result, &server_response, need_receive_completed))) {
       LOG_WARN("fail to analyze response", K(server_buffer_reader_), K(server_response),
@@ -4774,6 +4950,10 @@ inline int ObMysqlSM::do_internal_observer_open_event(int event, void* data)
   MYSQL_SM_SET_DEFAULT_HANDLER(&ObMysqlSM::state_observer_open);
 
   if (OB_SUCC(do_internal_observer_open())) {
+    if (start_acquire_server_session_time_ > 0 && OB_NOT_NULL(client_session_)) {
+      get_global_session_manager().record_acquire_wait(client_session_->schema_key_.dbkey_.config_string_,
+          client_session_->common_addr_, hrtime_to_usec(event::get_hrtime() - start_acquire_server_session_time_));
+    }
     retry_acquire_server_session_count_ = 0;
     start_acquire_server_session_time_ = 0;
   } else if (OB_SESSION_POOL_FULL_ERROR == ret) {
@@ -4823,6 +5003,8 @@ inline int ObMysqlSM::handle_retry_acquire_svr_session() {
                  "user_err_msg", trans_state_.mysql_errmsg_, K(ret));
       } else {
         LOG_WARN("fail to acquire svr session after retry", K(diff_time), K(retry_acquire_server_session_count_));
+        get_global_session_manager().record_acquire_wait(client_session_->schema_key_.dbkey_.config_string_,
+            client_session_->common_addr_, hrtime_to_usec(diff_time));
         retry_acquire_server_session_count_ = 0;
         start_acquire_server_session_time_ = 0;
         if (OB_FAIL(client_buffer_reader_->consume_all())) {
@@ -5112,7 +5294,8 @@ void ObMysqlSM::do_internal_request()
   bool send_response_direct = true;
 
   int64_t total_len = client_buffer_reader_->read_avail();
-  if (OB_UNLIKELY(OB_MYSQL_COM_STMT_CLOSE == trans_state_.trans_info_.sql_cmd_)
+  if (OB_UNLIKELY(OB_MYSQL_COM_STMT_CLOSE == trans_state_.trans_info_.sql_cmd_
+                  || OB_MYSQL_COM_STMT_FETCH == trans_state_.trans_info_.sql_cmd_)
           && OB_LIKELY(total_len > trans_state_.trans_info_.client_request_.get_packet_meta().pkt_len_)) {
     total_len = trans_state_.trans_info_.client_request_.get_packet_meta().pkt_len_;
   }
@@ -5222,6 +5405,18 @@ void ObMysqlSM::do_internal_request()
         break;
       }
 
+      case OB_MYSQL_COM_STMT_FETCH: {
+        // served by the rows prefetched from server cursor
+        ObCursorIdAddr *cursor_id_addr = NULL;
+        if (OB_FAIL(client_session_->get_session_info().get_cursor_id_addr(cursor_id_addr))) {
+          LOG_WARN("fail to get client cursor id addr", K_(sm_id), K(ret));
+        } else if (OB_FAIL(ObMysqlResponseBuilder::build_prefetched_fetch_resp(
+                *buf, trans_state_.trans_info_.client_request_, *cursor_id_addr))) {
+          LOG_WARN("[ObMysqlSM::do_internal_request] fail to build prefetched fetch resp", K_(sm_id), K(ret));
+        }
+        break;
+      }
+
       case OB_MYSQL_COM_QUERY:
       case OB_MYSQL_COM_SLEEP:
       case OB_MYSQL_COM_INIT_DB:
@@ -6143,6 +6338,7 @@ int ObMysqlSM::setup_client_transfer(ObMysqlVCType to_vc_type)
 
     if (OB_SUCC(ret)) {
       request_analyzer_.reset();
+      request_analyzer_.set_local_infile(client_session_->is_local_infile_pending());
       if (OB_FAIL(p->set_request_packet_analyzer(MYSQL_REQUEST, &request_analyzer_))) {
         LOG_WARN("failed to set_producer_packet_analyzer", K(p), K_(sm_id), K(ret));
       } else if (OB_FAIL(tunnel_.tunnel_run(p))) {
@@ -6299,6 +6495,15 @@ int ObMysqlSM::setup_server_request_send()
       milestones_.server_.reset();
       cmd_size_stats_.server_request_bytes_ = request_len;
       milestones_.server_.server_write_begin_ = get_based_hrtime();
+      if (ObMysqlTransact::SERVER_SEND_REQUEST == trans_state_.current_.send_action_) {
+        // requests in transaction skip the congestion lookup, count them here
+        (void)trans_state_.acquire_concurrency(true);
+        // temporary table lives as long as the server session
+        if (trans_state_.trans_info_.client_request_.get_parse_result().is_create_stmt()
+            && ObMysqlServerSession::is_create_temp_table(trans_state_.trans_info_.client_request_.get_sql())) {
+          server_session_->get_session_info().set_has_temp_table();
+        }
+      }
 
       if (0 == milestones_.server_first_write_begin_
           && (trans_state_.is_auth_request_
@@ -6676,7 +6881,10 @@ int ObMysqlSM::setup_cmd_complete()
     }
     client_session_->set_first_handle_close_request(true);
     client_session_->set_in_trans_for_close_request(false);
+    client_session_->set_local_infile_pending(
+        trans_state_.trans_info_.server_response_.get_analyze_result().is_local_infile_resp());
     client_session_->set_sharding_select_log_plan(NULL);
+    client_session_->set_parallel_dml_plan(NULL);
 
     if (OB_MYSQL_COM_HANDSHAKE == trans_state_.trans_info_.sql_cmd_) {
       // set inactivity timeout to connect_timeout after proxy send handshake
@@ -6697,7 +6905,8 @@ int ObMysqlSM::setup_cmd_complete()
       }
       clear_server_entry();
       // using session pool, when not in trans can relase server session to pool
-      if (get_global_proxy_config().need_release_after_tx) {
+      if (get_global_proxy_config().need_release_after_tx
+          || get_global_proxy_config().enable_server_session_multiplex) {
         if (need_release && can_server_session_release()) {
           ObMysqlServerSession * cur_ss = client_session_->get_server_session();
           // ObMysqlServerSession * lii_ss = client_session_->get_lii_server_session();
@@ -6785,7 +6994,11 @@ bool ObMysqlSM::can_server_session_release()
       client_session_->is_session_pool_client() &&
       client_session_->can_server_session_release_ &&
       is_allowed_state_ &&
-      !client_session_->get_session_info().is_trans_specified() && !is_in_trans) {
+      !client_session_->get_session_info().is_trans_specified() && !is_in_trans
+      // open cursors are fetched from the server session which executed them
+      && !client_session_->get_session_info().has_cursor_id_addr()
+      && (NULL == client_session_->get_server_session()
+          || !client_session_->get_server_session()->is_bound_to_client())) {
     result = true;
     LOG_DEBUG("can_server_session_release", K(result), K(trans_state_.current_.state_));
   }
@@ -7101,6 +7314,57 @@ inline void ObMysqlSM::update_monitor_stats(const ObString &logic_tenant_name,
   get_global_tenant_stat_mgr().revert_item(item);
 }
 
+inline void ObMysqlSM::update_latency_histogram(const ObString &cluster_name,
+                                                const ObString &tenant_name,
+                                                const ObProxyBasicStmtType stmt_type)
+{
+  int ret = OB_SUCCESS;
+  int64_t latencies[LATENCY_MAX_TYPE];
+  latencies[LATENCY_TOTAL] = hrtime_to_usec(cmd_time_stats_.request_total_time_);
+  latencies[LATENCY_SERVER] = hrtime_to_usec(cmd_time_stats_.server_process_request_time_);
+  latencies[LATENCY_ROUTE] = hrtime_to_usec(cmd_time_stats_.cluster_resource_create_time_
+                                            + cmd_time_stats_.pl_lookup_time_
+                                            + cmd_time_stats_.pl_process_time_
+                                            + cmd_time_stats_.congestion_control_time_
+                                            + cmd_time_stats_.congestion_process_time_);
+  latencies[LATENCY_CONNECT] = hrtime_to_usec(cmd_time_stats_.server_connect_time_);
+  if (OB_FAIL(get_global_latency_histogram_mgr().record(cluster_name, tenant_name, stmt_type, latencies))) {
+    LOG_WARN("fail to record latency histogram", K(cluster_name), K(tenant_name), K(stmt_type), K(ret));
+  }
+}
+
+inline void ObMysqlSM::update_sql_digest(const ObString &tenant_name,
+                                         const ObString &database_name,
+                                         const bool is_error_resp)
+{
+  ObString sql;
+  ObClientSessionInfo &cs_info = client_session_->get_session_info();
+  const ObMySQLCmd sql_cmd = trans_state_.trans_info_.sql_cmd_;
+  if (OB_MYSQL_COM_QUERY == sql_cmd || OB_MYSQL_COM_STMT_PREPARE_EXECUTE == sql_cmd) {
+    sql = trans_state_.trans_info_.client_request_.get_sql();
+  } else if (OB_MYSQL_COM_STMT_EXECUTE == sql_cmd && NULL != cs_info.get_ps_entry()) {
+    if (OB_SUCCESS != cs_info.get_ps_sql(sql)) {
+      sql.reset();
+    }
+  }
+
+  if (!sql.empty()) {
+    ObSqlDigestStat stat;
+    stat.exec_count_ = 1;
+    stat.error_count_ = is_error_resp ? 1 : 0;
+    stat.route_miss_count_ = trans_state_.trans_info_.server_response_.get_analyze_result().is_partition_hit() ? 0 : 1;
+    stat.total_time_us_ = hrtime_to_usec(cmd_time_stats_.request_total_time_);
+    stat.max_time_us_ = stat.total_time_us_;
+    stat.server_time_us_ = hrtime_to_usec(cmd_time_stats_.server_process_request_time_);
+    stat.request_bytes_ = cmd_size_stats_.client_request_bytes_;
+    stat.response_bytes_ = cmd_size_stats_.client_response_bytes_;
+    // "..." is an identifier in oracle mode or with ANSI_QUOTES
+    const bool is_ansi_quotes = cs_info.is_oracle_mode()
+                                || 0 != (cs_info.get_cached_variables().get_sql_mode() & SMO_ANSI_QUOTES);
+    get_global_sql_digest_table().record(sql, is_ansi_quotes, tenant_name, database_name, stat);
+  }
+}
+
 inline void ObMysqlSM::get_monitor_error_info(int32_t &error_code, ObString &error_msg, bool &is_error_resp)
 {
   const char *msg = NULL;
@@ -7208,7 +7472,9 @@ inline void ObMysqlSM::update_monitor_log()
         || is_error_resp
         || get_global_proxy_config().enable_monitor_stat
         || (get_global_proxy_config().enable_qos && OB_MYSQL_COM_QUERY == trans_state_.trans_info_.sql_cmd_)
-        || (get_global_proxy_config().enable_prometheus && g_ob_prometheus_processor.is_inited())) {
+        || (get_global_proxy_config().enable_prometheus && g_ob_prometheus_processor.is_inited())
+        || get_global_proxy_config().enable_latency_histogram
+        || get_global_proxy_config().enable_sql_digest) {
 
       ObClientSessionInfo &cs_info = client_session_->get_session_info();
       ObProxyMysqlRequest &client_request = trans_state_.trans_info_.client_request_;
@@ -7276,18 +7542,12 @@ inline void ObMysqlSM::update_monitor_log()
         }
 
         const char *stmt_type_str = "";
-        ObString new_sql;
-        char new_sql_buf[PRINT_SQL_LEN] = "\0";
+        ObString origin_sql;
         if (OB_MYSQL_COM_QUERY == trans_state_.trans_info_.sql_cmd_
             || OB_MYSQL_COM_STMT_PREPARE == trans_state_.trans_info_.sql_cmd_
             || OB_MYSQL_COM_STMT_PREPARE_EXECUTE == trans_state_.trans_info_.sql_cmd_) {
           stmt_type_str = get_print_stmt_name(stmt_type);
-
-          const ObString &origin_sql = trans_state_.trans_info_.get_print_sql();
-          int32_t new_sql_len = 0;
-          ObProxyMonitorUtils::sql_escape(origin_sql.ptr(), origin_sql.length(),
-                                          new_sql_buf, PRINT_SQL_LEN, new_sql_len);
-          new_sql.assign_ptr(new_sql_buf, new_sql_len);
+          origin_sql = trans_state_.trans_info_.get_print_sql();
         }
 
         const uint64_t *trace_id = ObCurTraceId::get();
@@ -7298,27 +7558,87 @@ inline void ObMysqlSM::update_monitor_log()
           snprintf(error_code_str, OB_MAX_ERROR_CODE_LEN, "%d", error_code);
         }
 
-        char ip_port_buff[INET6_ADDRPORTSTRLEN] = "\0";
+        const bool is_digest_warn = (slow_time_threshold > 0 && slow_time_threshold < cmd_time_stats_.request_total_time_)
+                                    || is_error_resp;
+        const bool is_digest_info = query_digest_time_threshold > 0
+                                    && query_digest_time_threshold < cmd_time_stats_.request_total_time_;
+        is_slow_query = slow_time_threshold > 0 && slow_time_threshold < cmd_time_stats_.request_total_time_;
         ObIpEndpoint &server_addr = trans_state_.server_info_.addr_;
-        if (ops_is_ip(server_addr)) {
-          char ip_buff_temp[INET6_ADDRSTRLEN] = "\0";
-          snprintf(ip_port_buff, INET6_ADDRPORTSTRLEN, "%s:%u", ops_ip_ntop(server_addr, ip_buff_temp, INET6_ADDRSTRLEN), ops_ip_port_host_order(server_addr));
-        }
+        ObMonitorBinlog &monitor_binlog = get_global_monitor_binlog();
+
+        if (monitor_binlog.is_inited()) {
+          // binary record keeps raw sql and address, they are formatted when decoded
+          ObMonitorLogRecord record;
+          record.flags_ = static_cast<uint8_t>((is_error_resp ? MONITOR_FLAG_ERROR_RESP : 0)
+                                               | (is_enc_beyond_trust ? MONITOR_FLAG_ENC_BEYOND_TRUST : 0)
+                                               | (is_digest_warn ? MONITOR_FLAG_WARN_LEVEL : 0));
+          record.error_code_ = error_code;
+          record.total_time_us_ = hrtime_to_usec(cmd_time_stats_.request_total_time_);
+          record.prepare_send_time_us_ = hrtime_to_usec(cmd_time_stats_.prepare_send_request_to_server_time_);
+          record.server_process_time_us_ = hrtime_to_usec(cmd_time_stats_.server_process_request_time_);
+          record.trace_id_[0] = trace_id_0;
+          record.trace_id_[1] = trace_id_1;
+          record.fields_[MONITOR_FIELD_LOGIC_TENANT] = logic_tenant_name;
+          record.fields_[MONITOR_FIELD_ANT_TRACE_ID] = ant_trace_id;
+          record.fields_[MONITOR_FIELD_RPC_ID] = rpc_id;
+          record.fields_[MONITOR_FIELD_LOGIC_DATABASE] = logic_database_name;
+          record.fields_[MONITOR_FIELD_CLUSTER] = cluster_name;
+          record.fields_[MONITOR_FIELD_TENANT] = tenant_name;
+          record.fields_[MONITOR_FIELD_DATABASE] = database_name;
+          record.fields_[MONITOR_FIELD_DATABASE_TYPE].assign_ptr(database_type_str,
+                                                                 static_cast<int32_t>(STRLEN(database_type_str)));
+          record.fields_[MONITOR_FIELD_LOGIC_TABLE] = logic_table_name;
+          record.fields_[MONITOR_FIELD_TABLE] = table_name;
+          record.fields_[MONITOR_FIELD_SQL_CMD].assign_ptr(sql_cmd, static_cast<int32_t>(STRLEN(sql_cmd)));
+          record.fields_[MONITOR_FIELD_STMT_TYPE].assign_ptr(stmt_type_str, static_cast<int32_t>(STRLEN(stmt_type_str)));
+          record.fields_[MONITOR_FIELD_SQL] = origin_sql;
+          record.fields_[MONITOR_FIELD_SHARD_NAME] = shard_name;
+          if (ops_is_ip(server_addr)) {
+            record.fields_[MONITOR_FIELD_SERVER_ADDR].assign_ptr(reinterpret_cast<const char *>(&server_addr),
+                                                                 static_cast<int32_t>(ops_ip_size(server_addr)));
+          }
+          record.fields_[MONITOR_FIELD_ERROR_MSG] = error_msg;
 
-        if ((slow_time_threshold > 0 && slow_time_threshold < cmd_time_stats_.request_total_time_)
-            || is_error_resp) {
-          _OBPROXY_DIGEST_LOG(WARN, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
-        } else if (query_digest_time_threshold > 0 && query_digest_time_threshold < cmd_time_stats_.request_total_time_) {
-          _OBPROXY_DIGEST_LOG(INFO, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
-        }
+          // the same as text log, digest log is printed as WARN or INFO, or not at all
+          if (is_digest_warn ? OB_MONITOR_LOG_NEED_TO_PRINT(WARN)
+                             : (is_digest_info && OB_MONITOR_LOG_NEED_TO_PRINT(INFO))) {
+            monitor_binlog.append(MONITOR_LOG_DIGEST, record);
+          }
+          if (is_slow_query && OB_MONITOR_LOG_NEED_TO_PRINT(WARN)) {
+            monitor_binlog.append(MONITOR_LOG_SLOW, record);
+          }
+          if (is_error_resp && OB_MONITOR_LOG_NEED_TO_PRINT(WARN)) {
+            monitor_binlog.append(MONITOR_LOG_ERROR, record);
+          }
+        } else {
+          ObString new_sql;
+          char new_sql_buf[PRINT_SQL_LEN] = "\0";
+          if (!origin_sql.empty()) {
+            int32_t new_sql_len = 0;
+            ObProxyMonitorUtils::sql_escape(origin_sql.ptr(), origin_sql.length(),
+                                            new_sql_buf, PRINT_SQL_LEN, new_sql_len);
+            new_sql.assign_ptr(new_sql_buf, new_sql_len);
+          }
 
-        if (slow_time_threshold > 0 && slow_time_threshold < cmd_time_stats_.request_total_time_) {
-          is_slow_query = true;
-          _OBPROXY_SLOW_LOG(WARN, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
-        }
+          char ip_port_buff[INET6_ADDRPORTSTRLEN] = "\0";
+          if (ops_is_ip(server_addr)) {
+            char ip_buff_temp[INET6_ADDRSTRLEN] = "\0";
+            snprintf(ip_port_buff, INET6_ADDRPORTSTRLEN, "%s:%u", ops_ip_ntop(server_addr, ip_buff_temp, INET6_ADDRSTRLEN), ops_ip_port_host_order(server_addr));
+          }
 
-        if (is_error_resp) {
-          _OBPROXY_ERROR_LOG(WARN, MONITOR_ERROR_LOG_FORMAT, MONITOR_ERROR_LOG_PARAM);
+          if (is_digest_warn) {
+            _OBPROXY_DIGEST_LOG(WARN, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
+          } else if (is_digest_info) {
+            _OBPROXY_DIGEST_LOG(INFO, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
+          }
+
+          if (is_slow_query) {
+            _OBPROXY_SLOW_LOG(WARN, MONITOR_LOG_FORMAT, MONITOR_LOG_PARAM);
+          }
+
+          if (is_error_resp) {
+            _OBPROXY_ERROR_LOG(WARN, MONITOR_ERROR_LOG_FORMAT, MONITOR_ERROR_LOG_PARAM);
+          }
         }
       }
 
@@ -7331,6 +7651,14 @@ inline void ObMysqlSM::update_monitor_log()
                              database_type, stmt_type, error_code_str);
       }
 
+      if (get_global_proxy_config().enable_latency_histogram) {
+        update_latency_histogram(cluster_name, tenant_name, stmt_type);
+      }
+
+      if (get_global_proxy_config().enable_sql_digest) {
+        update_sql_digest(tenant_name, database_name, is_error_resp);
+      }
+
       // Temporarily only supports OB_MYSQL_COM_QUERY
       // TODO: support ps sql
       if (get_global_proxy_config().enable_qos && OB_MYSQL_COM_QUERY == trans_state_.trans_info_.sql_cmd_) {
@@ -7392,6 +7720,8 @@ inline void ObMysqlSM::update_monitor_log()
 
 inline void ObMysqlSM::update_cmd_stats()
 {
+  trans_state_.release_concurrency(cmd_time_stats_.server_process_request_time_);
+
   trans_stats_.client_request_bytes_ += cmd_size_stats_.client_request_bytes_;
   trans_stats_.server_request_bytes_ += cmd_size_stats_.server_request_bytes_;
   trans_stats_.server_response_bytes_ += cmd_size_stats_.server_response_bytes_;
@@ -7564,7 +7894,10 @@ inline void ObMysqlSM::update_cmd_stats()
   if (trans_state_.need_sqlaudit()) {
     trans_state_.sqlaudit_record_queue_->enqueue(static_cast<int64_t>(sm_id_),
         milestones_.client_.client_begin_, cmd_time_stats_, trans_state_.server_info_.addr_,
-        trans_state_.trans_info_.get_print_sql(), trans_state_.trans_info_.sql_cmd_);
+        trans_state_.trans_info_.get_sql(), trans_state_.trans_info_.sql_cmd_,
+        trans_state_.trans_info_.client_request_.get_sql_id(),
+        get_route_type_string(trans_state_.pll_info_.route_.cur_chosen_route_type_),
+        cmd_size_stats_.client_request_bytes_, cmd_size_stats_.client_response_bytes_);
   }
 
   ObMysqlTransact::client_result_stat(trans_state_);
@@ -7606,6 +7939,17 @@ inline void ObMysqlSM::update_stats()
       MYSQL_SUM_TRANS_STAT(SERVER_REQUEST_TOTAL_SIZE, trans_stats_.server_request_bytes_);
       MYSQL_SUM_TRANS_STAT(SERVER_RESPONSE_TOTAL_SIZE, trans_stats_.server_response_bytes_);
     }
+    if (trans_stats_.transform_shared_bytes_ > 0) {
+      MYSQL_SUM_TRANS_STAT(TRANSFORM_SHARED_TOTAL_SIZE, trans_stats_.transform_shared_bytes_);
+    }
+    if (trans_stats_.compress_request_copied_bytes_ > 0 || trans_stats_.compress_request_shared_bytes_ > 0) {
+      MYSQL_SUM_TRANS_STAT(COMPRESS_REQUEST_COPIED_TOTAL_SIZE, trans_stats_.compress_request_copied_bytes_);
+      MYSQL_SUM_TRANS_STAT(COMPRESS_REQUEST_SHARED_TOTAL_SIZE, trans_stats_.compress_request_shared_bytes_);
+    }
+    if (trans_stats_.decompress_response_copied_bytes_ > 0 || trans_stats_.decompress_response_shared_bytes_ > 0) {
+      MYSQL_SUM_TRANS_STAT(DECOMPRESS_RESPONSE_COPIED_TOTAL_SIZE, trans_stats_.decompress_response_copied_bytes_);
+      MYSQL_SUM_TRANS_STAT(DECOMPRESS_RESPONSE_SHARED_TOTAL_SIZE, trans_stats_.decompress_response_shared_bytes_);
+    }
 
     // time
     MYSQL_SUM_TRANS_STAT(TOTAL_CLIENT_REQUEST_READ_TIME, trans_stats_.client_process_request_time_);
@@ -153,6 +153,9 @@ public:
   int setup_handle_execute_plan();
   int state_handle_execute_plan(int event, void *data);
   int process_executor_result(engine::ObProxyResultResp *result_resp);
+  int setup_handle_parallel_dml();
+  int state_handle_parallel_dml(int event, void *data);
+  int process_parallel_dml_result(executor::ObProxyParallelDmlPlan &plan);
   int build_executor_resp(event::ObMIOBuffer *write_buf, uint8_t &seq, engine::ObProxyResultResp *result_resp);
 
   int handle_shard_request(bool &need_direct_response_for_dml);
@@ -392,6 +395,9 @@ private:
                             const common::DBServerType database_type,
                             const ObProxyBasicStmtType stmt_type,
                             char *error_code_str);
+  void update_latency_histogram(const ObString &cluster_name, const ObString &tenant_name,
+                                const ObProxyBasicStmtType stmt_type);
+  void update_sql_digest(const ObString &tenant_name, const ObString &database_name, const bool is_error_resp);
 
   int handle_limit(bool &need_direct_response_for_client);
   int handle_ldg(bool &need_direct_response_for_client);
@@ -83,7 +83,9 @@ int64_t ObTransactionStat::to_string(char *buf, const int64_t buf_len) const
   J_OBJ_START();
   J_KV(K_(client_requests), K_(server_responses), K_(pl_lookup_retries), K_(server_retries),
        K_(client_request_bytes), K_(server_request_bytes), K_(server_response_bytes),
-       K_(client_response_bytes));
+       K_(client_response_bytes), K_(transform_shared_bytes),
+       K_(compress_request_copied_bytes), K_(compress_request_shared_bytes),
+       K_(decompress_response_copied_bytes), K_(decompress_response_shared_bytes));
   J_COMMA();
   TO_STRING_TIME_US(client_transaction_idle_time_);
   TO_STRING_TIME_US(client_process_request_time_);
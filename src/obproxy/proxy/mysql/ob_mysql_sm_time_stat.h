@@ -223,6 +223,14 @@ struct ObTransactionStat
   int64_t server_response_bytes_;
   int64_t client_response_bytes_;
 
+  // bytes handed over between transform stages, always by cloned blocks
+  int64_t transform_shared_bytes_;
+  // payload bytes of compressed requests and responses, copied or shared
+  int64_t compress_request_copied_bytes_;
+  int64_t compress_request_shared_bytes_;
+  int64_t decompress_response_copied_bytes_;
+  int64_t decompress_response_shared_bytes_;
+
   ObHRTime client_transaction_idle_time_;
   ObHRTime client_process_request_time_;//client_request_read+server_request_write
   ObHRTime client_request_read_time_;
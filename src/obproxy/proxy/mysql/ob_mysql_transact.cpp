@@ -127,6 +127,42 @@ bool ObMysqlTransact::ObTransState::is_for_update_sql(common::ObString src_sql)
   return bret;
 }
 
+bool ObMysqlTransact::ObTransState::acquire_concurrency(const bool force)
+{
+  bool bret = true;
+  if (NULL == concurrency_entry_
+      && NULL != congestion_entry_
+      && get_global_proxy_config().enable_concurrency_limit) {
+    ObConcurrencyLimiter &limiter = congestion_entry_->concurrency_limiter_;
+    if (force) {
+      limiter.acquire();
+    } else {
+      int64_t max_inflight = ATOMIC_LOAD(&limiter.limit_);
+      if (pll_info_.is_strong_read()) {
+        max_inflight *= ObConcurrencyLimiter::STRONG_READ_OVERFLOW_FACTOR;
+      }
+      bret = limiter.try_acquire(max_inflight);
+    }
+    if (bret) {
+      congestion_entry_->inc_ref();
+      concurrency_entry_ = congestion_entry_;
+    }
+  }
+  return bret;
+}
+
+void ObMysqlTransact::ObTransState::release_concurrency(const ObHRTime server_process_time)
+{
+  if (NULL != concurrency_entry_) {
+    ObProxyConfig &config = get_global_proxy_config();
+    concurrency_entry_->concurrency_limiter_.release(hrtime_to_usec(server_process_time),
+                                                      config.concurrency_limit_min,
+                                                      config.concurrency_limit_max);
+    concurrency_entry_->dec_ref();
+    concurrency_entry_ = NULL;
+  }
+}
+
 ObConsistencyLevel ObMysqlTransact::ObTransState::get_trans_consistency_level(
     ObClientSessionInfo &cs_info)
 {
@@ -808,6 +844,33 @@ void ObMysqlTransact::handle_fetch_request(ObTransState &s)
   TRANSACT_RETURN(SM_ACTION_SEND_ERROR_NOOP, NULL);
 }
 
+bool ObMysqlTransact::is_prefetched_fetch_request(ObTransState &s)
+{
+  bool bret = false;
+  ObCursorIdAddr *cursor_id_addr = NULL;
+  if (obmysql::OB_MYSQL_COM_STMT_FETCH == s.trans_info_.sql_cmd_
+      && OB_SUCCESS == get_client_session_info(s).get_cursor_id_addr(cursor_id_addr)
+      && NULL != cursor_id_addr) {
+    // the server cursor is ahead of client, rows left must be served before fetching again
+    bret = cursor_id_addr->has_prefetch_rows();
+  }
+  return bret;
+}
+
+uint32_t ObMysqlTransact::get_cursor_prefetch_rows(ObTransState &s, const ObCursorIdAddr &cursor_id_addr)
+{
+  const int64_t fetch_rows = cursor_id_addr.get_fetch_rows();
+  const int64_t buffer_size = s.mysql_config_params_->cursor_prefetch_buffer_size_;
+  int64_t multiple = s.mysql_config_params_->cursor_prefetch_multiple_;
+  if (buffer_size <= 0) {
+    multiple = 1;
+  } else if (fetch_rows > 0 && cursor_id_addr.get_avg_row_len() > 0) {
+    // keep the rows buffered in buffer_size by the row length seen before
+    multiple = std::min(multiple, 1 + buffer_size / (cursor_id_addr.get_avg_row_len() * fetch_rows));
+  }
+  return static_cast<uint32_t>(std::min(fetch_rows * multiple, static_cast<int64_t>(UINT32_MAX)));
+}
+
 void ObMysqlTransact::handle_request(ObTransState &s)
 {
   s.sm_->trans_stats_.client_requests_ += 1;
@@ -825,6 +888,9 @@ void ObMysqlTransact::handle_request(ObTransState &s)
     } else {
       TRANSACT_RETURN(SM_ACTION_INTERNAL_REQUEST, handle_internal_request);
     }
+  } else if (is_prefetched_fetch_request(s)) {
+    LOG_DEBUG("fetch is served by the prefetched rows of cursor");
+    TRANSACT_RETURN(SM_ACTION_INTERNAL_REQUEST, handle_internal_request);
   } else if (is_internal_request(s)) {
     if (s.trans_info_.client_request_.get_parse_result().is_internal_select()) {
       MYSQL_INCREMENT_TRANS_STAT(CLIENT_USE_LOCAL_SESSION_STATE_REQUESTS);
@@ -1337,6 +1403,16 @@ void ObMysqlTransact::handle_congestion_control_lookup(ObTransState &s)
           CONGEST_INCREMENT_DYN_STAT(alive_congested_stat);
           s.current_.state_ = ObMysqlTransact::ALIVE_CONGESTED;
           handle_response(s);
+        } else if (!s.acquire_concurrency(s.force_retry_congested_)) {
+          // over the concurrency limit, try other replicas like an alive congested server,
+          // it will be forced to use when all the replicas are congested
+          ObProxyMutex *mutex_ = s.sm_->mutex_;
+          CONGEST_INCREMENT_DYN_STAT(concurrency_limited_stat);
+          LOG_DEBUG("target server is over concurrency limit", "addr", s.server_info_.addr_,
+                    "limit", cgt_entry->concurrency_limiter_.limit_,
+                    "inflight", cgt_entry->concurrency_limiter_.inflight_);
+          s.current_.state_ = ObMysqlTransact::ALIVE_CONGESTED;
+          handle_response(s);
         } else {
           start_access_control(s); // continue
         }
@@ -1862,6 +1938,20 @@ inline int ObMysqlTransact::build_oceanbase_user_request(
           LOG_WARN("fail to get server cursor id", K(client_cursor_id), K(ret));
         } else {
           client_buffer_reader->replace(reinterpret_cast<const char*>(&server_cursor_id), sizeof(server_cursor_id), MYSQL_NET_META_LENGTH);
+          // ask more rows than client does, the extra rows are buffered by the response cursor prefetch plugin
+          ObCursorIdAddr *cursor_id_addr = NULL;
+          if (OB_SUCCESS == cs_info.get_cursor_id_addr(cursor_id_addr) && NULL != cursor_id_addr) {
+            uint32_t prefetch_rows = 0;
+            if (PROTOCOL_NORMAL == ob_proxy_protocol) {
+              prefetch_rows = get_cursor_prefetch_rows(s, *cursor_id_addr);
+            }
+            cursor_id_addr->set_prefetching(prefetch_rows > cursor_id_addr->get_fetch_rows());
+            if (cursor_id_addr->is_prefetching()) {
+              client_buffer_reader->replace(reinterpret_cast<const char*>(&prefetch_rows), sizeof(prefetch_rows),
+                                            MYSQL_NET_META_LENGTH + sizeof(server_cursor_id));
+              LOG_DEBUG("prefetch cursor rows", K(prefetch_rows), KPC(cursor_id_addr));
+            }
+          }
         }
       } else if (obmysql::OB_MYSQL_COM_STMT_CLOSE == s.trans_info_.client_request_.get_packet_meta().cmd_) {
         ObServerSessionInfo &ss_info = get_server_session_info(s);
@@ -1932,13 +2022,17 @@ inline int ObMysqlTransact::build_oceanbase_user_request(
                 }
               }
 
+              int64_t shared_len = 0;
               if (OB_SUCC(ret)) {
                 if (OB_FAIL(ObProto20Utils::consume_and_compress_data(
                             request_buffer_reader, write_buffer, client_request_len, compress_seq, compress_seq,
                             s.sm_->get_server_session()->get_next_server_request_id(),
                             s.sm_->get_server_session()->get_server_sessid(),
-                            is_last_packet, need_reroute, &extro_info))) {
+                            is_last_packet, need_reroute, &extro_info, &shared_len))) {
                   LOG_ERROR("fail to consume_and_compress_data", K(ret));
+                } else {
+                  s.sm_->trans_stats_.compress_request_copied_bytes_ += client_request_len - shared_len;
+                  s.sm_->trans_stats_.compress_request_shared_bytes_ += shared_len;
                 }
               }
             } else {
@@ -1948,6 +2042,8 @@ inline int ObMysqlTransact::build_oceanbase_user_request(
                           request_buffer_reader, write_buffer, client_request_len, use_fast_compress,
                           compress_seq, is_checksum_on))) {
                 LOG_WARN("fail to consume_and_compress_data", K(ret));
+              } else {
+                s.sm_->trans_stats_.compress_request_copied_bytes_ += client_request_len;
               }
             }
 
@@ -3771,6 +3867,7 @@ void ObMysqlTransact::handle_oceanbase_retry_server_connection(ObTransState &s)
     s.sm_->trans_stats_.server_retries_ += 1;
     // reset error_type
     s.current_.error_type_ = MIN_RESP_ERROR;
+    s.release_concurrency(0);
     if (NULL != s.congestion_entry_) {
       s.congestion_entry_->dec_ref();
       s.congestion_entry_ = NULL;
@@ -3796,6 +3893,7 @@ void ObMysqlTransact::handle_oceanbase_retry_server_connection(ObTransState &s)
     s.sm_->trans_stats_.pl_lookup_retries_ += 1;
     // reset error_type
     s.current_.error_type_ = MIN_RESP_ERROR;
+    s.release_concurrency(0);
     if (NULL != s.congestion_entry_) {
       s.congestion_entry_->dec_ref();
       s.congestion_entry_ = NULL;
@@ -441,7 +441,10 @@ public:
       sql_cmd_ = obmysql::OB_MYSQL_COM_END;
     }
 
-    common::ObString get_print_sql()
+    common::ObString get_print_sql() { return get_sql(true); }
+
+    // the whole sql if is_print is false, login packets are never printed
+    common::ObString get_sql(const bool is_print = false)
     {
       common::ObString ret;
       switch (sql_cmd_) {
@@ -452,7 +455,7 @@ public:
           ret = common::ObString::make_string("OB_MYSQL_COM_LOGIN");
           break;
         default:
-          ret = client_request_.get_print_sql();
+          ret = is_print ? client_request_.get_print_sql() : client_request_.get_sql();
           break;
       }
       return ret;
@@ -510,6 +513,7 @@ public:
           congestion_lookup_success_(false),
           force_retry_congested_(false),
           is_congestion_entry_updated_(false),
+          concurrency_entry_(NULL),
           api_mysql_sm_shutdown_(false),
           api_server_addr_set_(false),
           sqlaudit_record_queue_(NULL)
@@ -609,6 +613,12 @@ public:
       arena_.reuse();
     }
 
+    // count the request into the in-flight requests of the target server,
+    // return false if the server is over its adaptive concurrency limit
+    bool acquire_concurrency(const bool force);
+    // @server_process_time is the latency sample, 0 if the request was not answered
+    void release_concurrency(const ObHRTime server_process_time);
+
     void set_alive_failed()
     {
       if (OB_LIKELY(NULL != congestion_entry_)
@@ -696,6 +706,7 @@ public:
         is_trans_first_request_ = true;
         is_auth_request_ = false;
 
+        release_concurrency(0);
         if (NULL != congestion_entry_) {
           // if this trans succ, just set avlie this server;
           if (!is_congestion_entry_updated_) {
@@ -738,6 +749,7 @@ public:
         mysql_config_params_->dec_ref();
         mysql_config_params_ = NULL;
       }
+      release_concurrency(0);
       if (NULL != congestion_entry_) {
         congestion_entry_->dec_ref();
         congestion_entry_ = NULL;
@@ -818,6 +830,8 @@ public:
     bool force_retry_congested_;
 
     bool is_congestion_entry_updated_;
+    // holds a ref of the entry whose concurrency limiter counts this request
+    obutils::ObCongestionEntry *concurrency_entry_;
     bool api_mysql_sm_shutdown_;
     bool api_server_addr_set_;
 
@@ -833,6 +847,8 @@ public:
   static int set_server_ip_by_shard_conn(ObTransState &s, dbconfig::ObShardConnector* shard_conn);
   static void handle_oceanbase_request(ObTransState &s);
   static void handle_fetch_request(ObTransState &s);
+  static bool is_prefetched_fetch_request(ObTransState &s);
+  static uint32_t get_cursor_prefetch_rows(ObTransState &s, const ObCursorIdAddr &cursor_id_addr);
   static void handle_request(ObTransState &s);
   static int build_normal_login_request(ObTransState &s, event::ObIOBufferReader *&reader,
                                         int64_t &request_len);
@@ -355,7 +355,8 @@ inline int ObProto20Utils::fill_proto20_extro_info(ObMIOBuffer *write_buf, const
 }
 
 inline int ObProto20Utils::fill_proto20_payload(ObIOBufferReader *reader, ObMIOBuffer *write_buf,
-                                                const int64_t data_len, int64_t &payload_len, uint64_t &crc64)
+                                                const int64_t data_len, int64_t &payload_len, uint64_t &crc64,
+                                                int64_t &shared_len)
 {
   int ret = OB_SUCCESS;
 
@@ -368,6 +369,7 @@ inline int ObProto20Utils::fill_proto20_payload(ObIOBufferReader *reader, ObMIOB
 
   while (remain_len > 0 && OB_SUCC(ret)) {
     int64_t written_len = 0;
+    int64_t block_shared_len = 0;
     start = reader->start();
     block_read_avail = reader->block_read_avail();
     buf_len = (block_read_avail >= remain_len ? remain_len : block_read_avail);
@@ -375,13 +377,16 @@ inline int ObProto20Utils::fill_proto20_payload(ObIOBufferReader *reader, ObMIOB
 
     crc64 = ob_crc64(crc64, start, buf_len);
 
-    if (OB_FAIL(write_buf->write(start, buf_len, written_len))) {
+    // the payload is not changed, share it with the block of reader
+    if (OB_FAIL(write_buf->write(reader->block_, start, buf_len, written_len, block_shared_len))) {
       LOG_WARN("fail to write uncompress data", K(buf_len), K(ret));
     } else if (OB_UNLIKELY(written_len != buf_len)) {
       ret = OB_ERR_UNEXPECTED;
       LOG_WARN("fail to write uncompress data", K(written_len), K(buf_len), K(ret));
     } else if (OB_FAIL(reader->consume(buf_len))) {
       LOG_WARN("fail to consume", K(buf_len), K(ret));
+    } else {
+      shared_len += block_shared_len;
     }
   }
 
@@ -416,12 +421,14 @@ int ObProto20Utils::consume_and_compress_data(ObIOBufferReader *reader, ObMIOBuf
                                               const uint8_t packet_seq, const uint32_t request_id,
                                               const uint32_t connid, const bool is_last_packet,
                                               const bool is_need_reroute,
-                                              const ObIArray<ObObJKV> *extro_info)
+                                              const ObIArray<ObObJKV> *extro_info,
+                                              int64_t *shared_len)
 {
   int ret = OB_SUCCESS;
   uint64_t crc64 = 0;
   char *hdr_start = NULL;
   int64_t payload_len = 0;
+  int64_t payload_shared_len = 0;
   bool is_extro_info_exist = false;
 
   if (OB_ISNULL(reader) || OB_ISNULL(write_buf) || data_len > reader->read_avail()) {
@@ -435,7 +442,7 @@ int ObProto20Utils::consume_and_compress_data(ObIOBufferReader *reader, ObMIOBuf
   } else if (OB_NOT_NULL(extro_info)
              && OB_FAIL(fill_proto20_extro_info(write_buf, extro_info, payload_len, crc64, is_extro_info_exist))) {
     LOG_ERROR("fail to fill proto20 extro info", KPC(extro_info), K(ret));
-  } else if (OB_FAIL(fill_proto20_payload(reader, write_buf, data_len, payload_len, crc64))) {
+  } else if (OB_FAIL(fill_proto20_payload(reader, write_buf, data_len, payload_len, crc64, payload_shared_len))) {
     LOG_ERROR("fail to fill proto20 payload", K(data_len), K(crc64), K(ret));
   } else if (OB_FAIL(fill_proto20_tailer(write_buf, crc64))) {
     LOG_ERROR("fail to fill proto20 tailer", K(crc64), K(ret));
@@ -447,7 +454,11 @@ int ObProto20Utils::consume_and_compress_data(ObIOBufferReader *reader, ObMIOBuf
               K(packet_seq), K(request_id), K(connid), K(is_last_packet),
               K(is_need_reroute), K(ret));
   } else {
-    LOG_DEBUG("build mysql compress packet with ob20 succ", "origin len", data_len, K(compressed_seq), K(crc64));
+    if (NULL != shared_len) {
+      *shared_len = payload_shared_len;
+    }
+    LOG_DEBUG("build mysql compress packet with ob20 succ", "origin len", data_len,
+              K(payload_shared_len), K(compressed_seq), K(crc64));
   }
   return ret;
 }
@@ -45,10 +45,13 @@ public:
   static int analyze_one_compressed_packet(event::ObIOBufferReader &reader,
                                            ObMysqlCompressedOB20AnalyzeResult &result);
 
+  // the payload is shared with the blocks of reader instead of copied when it is
+  // large enough, shared_len returns the shared bytes if not NULL
   static int consume_and_compress_data(event::ObIOBufferReader *reader, event::ObMIOBuffer *write_buf,
                                        const int64_t data_len, const uint8_t compressed_seq, const uint8_t packet_seq,
                                        const uint32_t request_id, const uint32_t connid, const bool is_last_packet,
-                                       const bool is_need_reroute, const common::ObIArray<ObObJKV> *extro_info = NULL);
+                                       const bool is_need_reroute, const common::ObIArray<ObObJKV> *extro_info = NULL,
+                                       int64_t *shared_len = NULL);
 
 private:
   inline static int analyze_compressed_packet_header(const char *start, const int64_t len,
@@ -65,7 +68,8 @@ private:
                                             int64_t &payload_len, uint64_t &crc64, bool &is_extro_info_exist);
 
   inline static int fill_proto20_payload(event::ObIOBufferReader *reader, event::ObMIOBuffer *write_buf,
-                                         const int64_t data_len, int64_t &payload_len, uint64_t &crc64);
+                                         const int64_t data_len, int64_t &payload_len, uint64_t &crc64,
+                                         int64_t &shared_len);
 
   inline static int fill_proto20_tailer(event::ObMIOBuffer *write_buf, const uint64_t crc64);
 
@@ -93,6 +93,9 @@ void ObMysqlCompressAnalyzer::reset()
   last_packet_len_ = 0;
   last_packet_filled_len_ = 0;
   compressor_.reset();
+  curr_block_ = NULL;
+  copied_len_ = 0;
+  shared_len_ = 0;
 }
 
 int ObMysqlCompressAnalyzer::analyze_compressed_response_with_length(event::ObIOBufferReader &reader, uint64_t decompress_size)
@@ -122,6 +125,7 @@ int ObMysqlCompressAnalyzer::analyze_compressed_response_with_length(event::ObIO
   ObMysqlResp resp;
   while (OB_SUCC(ret) && NULL != block && decompress_size > 0) {
     resp_buf.assign_ptr(data, static_cast<int32_t>(data_size));
+    curr_block_ = block;
     if (OB_FAIL(analyze_compressed_response(resp_buf, resp))) {
       LOG_WARN("fail to analyze compressed response", K(ret));
     } else {
@@ -140,6 +144,7 @@ int ObMysqlCompressAnalyzer::analyze_compressed_response_with_length(event::ObIO
       }
     }
   }
+  curr_block_ = NULL;
   LOG_DEBUG("analyze compressed response with length finished", "decompress_size", decompress_size, K(resp));
 
   return ret;
@@ -169,6 +174,7 @@ int ObMysqlCompressAnalyzer::analyze_compressed_response(event::ObIOBufferReader
   ObString resp_buf;
   while (OB_SUCC(ret) && NULL != block && data_size > 0 && !resp.get_analyze_result().is_resp_completed()) {
     resp_buf.assign_ptr(data, static_cast<int32_t>(data_size));
+    curr_block_ = block;
     if (OB_FAIL(analyze_compressed_response(resp_buf, resp))) {
       LOG_WARN("fail to analyze compressed response", K(ret));
     } else {
@@ -188,6 +194,7 @@ int ObMysqlCompressAnalyzer::analyze_compressed_response(event::ObIOBufferReader
       }
     }
   }
+  curr_block_ = NULL;
   LOG_DEBUG("analyze compressed response finished", "data_size", reader.read_avail(), K(resp));
 
   return ret;
@@ -642,6 +649,7 @@ int ObMysqlCompressAnalyzer::decompress_data(const char *zprt, const int64_t zle
         } else {
           if (filled_len > 0) {
             out_buffer_->fill(filled_len);
+            copied_len_ += filled_len;
           }
           if (len > filled_len) { // complete
             stop = true;
@@ -649,19 +657,43 @@ int ObMysqlCompressAnalyzer::decompress_data(const char *zprt, const int64_t zle
         }
       }
     } else {
-      //uncompressed payload, just copy
-      //TODO:: this can do better, remove_append
-      if (OB_FAIL(out_buffer_->write(zprt, zlen, filled_len))) {
-        LOG_WARN("fail to write uncompressed payload", K(zlen), K(filled_len), K(ret));
-      } else if (OB_UNLIKELY(zlen != filled_len)) {
-        ret = OB_ERR_UNEXPECTED;
-        LOG_WARN("fail to write uncompressed payload", K(zlen), K(filled_len), K(ret));
+      //uncompressed payload, share it with the block if possible
+      if (zlen > 0 && OB_FAIL(write_uncompressed_payload(zprt, zlen))) {
+        LOG_WARN("fail to write uncompressed payload", K(zlen), K(ret));
       }
     }
   }
   return ret;
 }
 
+int ObMysqlCompressAnalyzer::write_uncompressed_payload(const char *buf, const int64_t len)
+{
+  int ret = OB_SUCCESS;
+  int64_t written_len = 0;
+  int64_t shared_len = 0;
+  if (OB_ISNULL(out_buffer_) || OB_ISNULL(buf) || OB_UNLIKELY(len <= 0)) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid argument", K_(out_buffer), KP(buf), K(len), K(ret));
+  } else if (NULL != curr_block_ && buf >= curr_block_->start() && buf + len <= curr_block_->end()) {
+    if (OB_FAIL(out_buffer_->write(curr_block_, buf, len, written_len, shared_len))) {
+      LOG_WARN("fail to write uncompressed payload", K(len), K(ret));
+    }
+  } else if (OB_FAIL(out_buffer_->write(buf, len, written_len))) {
+    LOG_WARN("fail to write uncompressed payload", K(len), K(ret));
+  }
+
+  if (OB_SUCC(ret)) {
+    if (OB_UNLIKELY(len != written_len)) {
+      ret = OB_ERR_UNEXPECTED;
+      LOG_WARN("fail to write uncompressed payload", K(len), K(written_len), K(ret));
+    } else {
+      shared_len_ += shared_len;
+      copied_len_ += (written_len - shared_len);
+    }
+  }
+  return ret;
+}
+
 int ObMysqlCompressAnalyzer::analyze_one_compressed_packet(ObIOBufferReader &reader,
                                                            ObMysqlCompressedAnalyzeResult &result)
 {
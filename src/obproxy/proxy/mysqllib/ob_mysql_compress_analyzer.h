@@ -43,7 +43,8 @@ public:
       enable_extra_ok_packet_for_stats_(false), is_last_packet_(false),
       is_stream_finished_(false), mode_(SIMPLE_MODE), remain_len_(0), header_buf_(),
       header_valid_len_(0), curr_compressed_header_(), out_buffer_(NULL), last_packet_buffer_(NULL),
-      last_packet_len_(0), last_packet_filled_len_(0), compressor_()
+      last_packet_len_(0), last_packet_filled_len_(0), compressor_(), curr_block_(NULL),
+      copied_len_(0), shared_len_(0)
       {}
   virtual ~ObMysqlCompressAnalyzer() { reset(); }
 
@@ -78,6 +79,10 @@ public:
 
   common::ObString get_last_packet_string();
 
+  // bytes written to out_buffer_ by copying or decompressing, and bytes shared
+  // with the blocks of the response without copying
+  int64_t get_copied_len() const { return copied_len_; }
+  int64_t get_shared_len() const { return shared_len_; }
 
 protected:
   // attention!! the buf can not cross two compressed packets
@@ -88,6 +93,7 @@ protected:
   virtual int analyze_one_compressed_packet(event::ObIOBufferReader &reader,
                                             ObMysqlCompressedAnalyzeResult &result);
   virtual bool is_last_packet(const ObMysqlCompressedAnalyzeResult &result);
+  int write_uncompressed_payload(const char *buf, const int64_t len);
 
 private:
   int do_analyze_last_compress_packet(ObMysqlResp &resp);
@@ -122,6 +128,11 @@ protected:
   int64_t last_packet_len_;
   int64_t last_packet_filled_len_;
   ObZlibStreamCompressor compressor_;
+  // the block of the reader being analyzed, NULL if the data is not in a block,
+  // the uncompressed payload in it is shared instead of copied
+  event::ObIOBufferBlock *curr_block_;
+  int64_t copied_len_;
+  int64_t shared_len_;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(ObMysqlCompressAnalyzer);
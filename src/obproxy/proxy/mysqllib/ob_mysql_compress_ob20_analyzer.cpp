@@ -173,7 +173,6 @@ inline int ObMysqlCompressOB20Analyzer::do_body_decode(const char *&payload_star
   uint32_t payload_remain_len = static_cast<uint32_t>(curr_compressed_ob20_header_.payload_len_ - payload_checked_len_);
 
   if (payload_remain_len > 0 && payload_len > 0) {
-    int64_t filled_len = 0;
     uint32_t body_len = static_cast<uint32_t>(payload_len <= payload_remain_len ? payload_len : payload_remain_len);
     crc64_ = ob_crc64(crc64_, payload_start, body_len); // actual is crc32
 
@@ -182,11 +181,8 @@ inline int ObMysqlCompressOB20Analyzer::do_body_decode(const char *&payload_star
     ObBufferReader buf_reader(buf);
     if (OB_FAIL(analyzer_.analyze_mysql_resp(buf_reader, result_, &resp))) {
       LOG_WARN("fail to analyze mysql resp", K(ret));
-    } else if (OB_FAIL(out_buffer_->write(payload_start, body_len, filled_len))) {
-      LOG_WARN("fail to write uncompressed payload", K(payload_len), K(filled_len), K(ret));
-    } else if (OB_UNLIKELY(body_len != filled_len)) {
-      ret = OB_ERR_UNEXPECTED;
-      LOG_WARN("fail to write uncompressed payload", K(payload_len), K(filled_len), K(ret));
+    } else if (OB_FAIL(write_uncompressed_payload(payload_start, body_len))) {
+      LOG_WARN("fail to write uncompressed payload", K(payload_len), K(body_len), K(ret));
     } else {
       payload_checked_len_ += body_len;
       payload_start += body_len;
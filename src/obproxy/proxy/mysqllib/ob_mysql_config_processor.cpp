@@ -46,6 +46,9 @@ ObMysqlConfigParams::ObMysqlConfigParams()
     default_buffer_water_mark_(0),
     tunnel_request_size_threshold_(0),
     request_buffer_length_(4096),
+    enable_local_infile_stream_(false),
+    cursor_prefetch_multiple_(1),
+    cursor_prefetch_buffer_size_(1024 * 1024),
 
     sock_recv_buffer_size_out_(0),
     sock_send_buffer_size_out_(0),
@@ -103,6 +106,7 @@ ObMysqlConfigParams::ObMysqlConfigParams()
     enable_report_session_stats_(false),
     enable_strict_stat_time_(true),
     enable_cpu_topology_(true),
+    enable_numa_affinity_(false),
     enable_trace_stats_(false),
     enable_partition_table_route_(false),
     enable_pl_route_(false),
@@ -134,6 +138,9 @@ int ObMysqlConfigParams::assign_config(const ObProxyConfig &proxy_config)
   CONFIG_ITEM_ASSIGN(default_buffer_water_mark);
   CONFIG_ITEM_ASSIGN(tunnel_request_size_threshold);
   CONFIG_ITEM_ASSIGN(request_buffer_length);
+  CONFIG_ITEM_ASSIGN(enable_local_infile_stream);
+  CONFIG_ITEM_ASSIGN(cursor_prefetch_multiple);
+  CONFIG_ITEM_ASSIGN(cursor_prefetch_buffer_size);
 
   CONFIG_ITEM_ASSIGN(sock_recv_buffer_size_out);
   CONFIG_ITEM_ASSIGN(sock_send_buffer_size_out);
@@ -196,6 +203,7 @@ int ObMysqlConfigParams::assign_config(const ObProxyConfig &proxy_config)
   CONFIG_ITEM_ASSIGN(enable_report_session_stats);
   CONFIG_ITEM_ASSIGN(enable_strict_stat_time);
   CONFIG_ITEM_ASSIGN(enable_cpu_topology);
+  CONFIG_ITEM_ASSIGN(enable_numa_affinity);
   CONFIG_ITEM_ASSIGN(enable_trace_stats);
   CONFIG_ITEM_ASSIGN(enable_partition_table_route);
   CONFIG_ITEM_ASSIGN(enable_pl_route);
@@ -295,6 +303,8 @@ DEF_TO_STRING(ObMysqlConfigParams)
        K_(flow_low_water_mark), K_(flow_consumer_reenable_threshold),
        K_(flow_event_queue_threshold), K_(default_buffer_water_mark),
        K_(tunnel_request_size_threshold), K_(request_buffer_length),
+       K_(enable_local_infile_stream), K_(cursor_prefetch_multiple),
+       K_(cursor_prefetch_buffer_size),
        K_(sock_recv_buffer_size_out), K_(sock_send_buffer_size_out),
        K_(server_tcp_keepidle), K_(server_tcp_keepintvl),
        K_(server_tcp_keepcnt), K_(server_tcp_user_timeout),
@@ -311,7 +321,7 @@ DEF_TO_STRING(ObMysqlConfigParams)
   J_COMMA();
   J_KV(K_(enable_trans_detail_stats), K_(enable_mysqlsm_info),
        K_(enable_report_session_stats), K_(enable_strict_stat_time),
-       K_(enable_cpu_topology), K_(internal_cmd_mem_limited), K_(enable_trace_stats),
+       K_(enable_cpu_topology), K_(enable_numa_affinity), K_(internal_cmd_mem_limited), K_(enable_trace_stats),
        K_(slow_transaction_time_threshold), K_(slow_proxy_process_time_threshold),
        K_(query_digest_time_threshold), K_(slow_query_time_threshold),
        K_(proxy_service_mode), K_(server_routing_mode), K_(proxy_id), K_(proxy_idc_name),
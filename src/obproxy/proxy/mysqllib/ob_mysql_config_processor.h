@@ -69,6 +69,9 @@ public:
   CfgInt default_buffer_water_mark_;
   CfgInt tunnel_request_size_threshold_;
   CfgInt request_buffer_length_;
+  CfgBool enable_local_infile_stream_;
+  CfgInt cursor_prefetch_multiple_;
+  CfgInt cursor_prefetch_buffer_size_;
 
   CfgInt sock_recv_buffer_size_out_;
   CfgInt sock_send_buffer_size_out_;
@@ -132,6 +135,7 @@ public:
   CfgBool enable_report_session_stats_;
   CfgBool enable_strict_stat_time_;
   CfgBool enable_cpu_topology_;
+  CfgBool enable_numa_affinity_;
   CfgBool enable_trace_stats_;
   CfgBool enable_partition_table_route_;
   CfgBool enable_pl_route_;
@@ -65,6 +65,7 @@ ObMysqlRequestAnalyzer::ObMysqlRequestAnalyzer()
       nbytes_analyze_(0),
       is_last_request_packet_(true),
       request_count_(0),
+      is_local_infile_(false),
       payload_offset_(0)
 {
   MEMSET(payload_length_buffer_, 0, MYSQL_NET_HEADER_LENGTH);
@@ -89,6 +90,10 @@ void ObMysqlRequestAnalyzer::analyze_request(const ObRequestAnalyzeCtx &ctx,
       if (OB_FAIL(handle_auth_request(*ctx.reader_, result))) {
         LOG_WARN("fail to handle auth request", K(ret));
       }
+    } else if (OB_UNLIKELY(ctx.is_local_infile_)) {
+      if (OB_FAIL(handle_local_infile_request(*ctx.reader_, result))) {
+        LOG_WARN("fail to handle local infile request", K(ret));
+      }
     } else {
       if (OB_FAIL(ObProxyParserUtils::analyze_one_packet(*ctx.reader_, result))) {
         LOG_WARN("fail to analyze one packet", K(ret));
@@ -97,7 +102,7 @@ void ObMysqlRequestAnalyzer::analyze_request(const ObRequestAnalyzeCtx &ctx,
 
     // 2. verify request's legality, just print WARN
     int64_t avail_bytes = ctx.reader_->read_avail();
-    if (avail_bytes >= MYSQL_NET_META_LENGTH) {
+    if (avail_bytes >= MYSQL_NET_META_LENGTH && !ctx.is_local_infile_) {
       if (avail_bytes > result.meta_.pkt_len_) {
         LOG_WARN("recevied more than one mysql packet at once, it is unexpected so far",
                  "first packet len(include packet header)", result.meta_.pkt_len_,
@@ -135,7 +140,14 @@ void ObMysqlRequestAnalyzer::analyze_request(const ObRequestAnalyzeCtx &ctx,
       }
 
       // 4. dispatch mysql packet by cmd type, and parse mysql request
-      if (ANALYZE_DONE == status) {
+      if (OB_UNLIKELY(ctx.is_local_infile_)) {
+        // the file is never parsed nor buffered, all of its packets are streamed
+        // to server through the request tunnel with flow control
+        if (result.meta_.pkt_len_ > 0) {
+          status = ANALYZE_CONT;
+          client_request.set_large_request(true);
+        }
+      } else if (ANALYZE_DONE == status) {
         if (OB_FAIL(do_analyze_request(ctx, sql_cmd, auth_request, client_request, is_oracle_mode))) {
           if (OB_ERR_PARSE_SQL == ret) {
             //ob parse fail will not disconnect
@@ -182,7 +194,10 @@ int ObMysqlRequestAnalyzer::get_payload_length(const char *buffer)
   } else {
     payload_length = ob_uint3korr(buffer);
     packet_seq_ = ob_uint1korr(buffer + MYSQL_PAYLOAD_LENGTH_LENGTH);
-    if (MYSQL_PACKET_MAX_LENGTH == payload_length) {
+    if (OB_UNLIKELY(is_local_infile_)) {
+      // the file ends with an empty packet
+      is_last_request_packet_ = (0 == payload_length);
+    } else if (MYSQL_PACKET_MAX_LENGTH == payload_length) {
       is_last_request_packet_ = false;
     } else {
       ++request_count_;
@@ -323,6 +338,21 @@ void ObMysqlRequestAnalyzer::reuse()
   MEMSET(payload_length_buffer_, 0, MYSQL_NET_HEADER_LENGTH);
   payload_offset_ = 0;
   request_count_ = 0;
+  is_local_infile_ = false;
+}
+
+inline int ObMysqlRequestAnalyzer::handle_local_infile_request(ObIOBufferReader &reader,
+                                                                ObMysqlAnalyzeResult &result)
+{
+  int ret = OB_SUCCESS;
+  if (OB_FAIL(ObProxyParserUtils::analyze_one_packet_only_header(reader, result))) {
+    LOG_WARN("fail to analyze one packet only header", K(ret));
+  } else {
+    // the packets of file have no cmd, the final response of the file is
+    // the response of LOAD DATA statement
+    result.meta_.cmd_ = OB_MYSQL_COM_QUERY;
+  }
+  return ret;
 }
 
 inline int ObMysqlRequestAnalyzer::handle_auth_request(ObIOBufferReader &reader,
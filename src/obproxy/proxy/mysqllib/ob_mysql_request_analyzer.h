@@ -64,6 +64,8 @@ struct ObRequestAnalyzeCtx
   int64_t large_request_threshold_len_;
   int64_t request_buffer_length_;
   bool using_ldg_;
+  // the data from client is the file of LOAD DATA LOCAL INFILE
+  bool is_local_infile_;
 };
 
 class ObMysqlRequestAnalyzer
@@ -76,6 +78,8 @@ public:
   uint8_t get_packet_seq() const { return packet_seq_; }
   void reset() { reuse(); }
   void reuse();
+  // the file of LOAD DATA LOCAL INFILE is sent as many packets, ends with an empty one
+  void set_local_infile(const bool is_local_infile) { is_local_infile_ = is_local_infile; }
 
   static void analyze_request(const ObRequestAnalyzeCtx &ctx,
                               ObMysqlAuthRequest &auth_request,
@@ -121,6 +125,7 @@ private:
 
   // handle auth reqeust packet
   static int handle_auth_request(event::ObIOBufferReader &reader, ObMysqlAnalyzeResult &result);
+  static int handle_local_infile_request(event::ObIOBufferReader &reader, ObMysqlAnalyzeResult &result);
 
   // dispatch mysql pkt according to cmd type, and then parse each other
   static int do_analyze_request(const ObRequestAnalyzeCtx &ctx,
@@ -152,6 +157,7 @@ private:
   int64_t nbytes_analyze_;         // total bytes already analyze
   bool is_last_request_packet_;    // whether is mysql last package
   int64_t request_count_;
+  bool is_local_infile_;
 
   char payload_length_buffer_[MYSQL_NET_HEADER_LENGTH];
   int64_t payload_offset_;
@@ -152,6 +152,7 @@ inline bool ObMysqlPacketMetaAnalyzer::is_need_reserve_packet(ObRespResult &resu
 ObRespResult::ObRespResult()
     : is_compress_(false),
       enable_extra_ok_packet_for_stats_(false),
+      enable_local_infile_(false),
       cmd_(OB_MYSQL_COM_END),
       mysql_mode_(UNDEFINED_MYSQL_PROTOCOL_MODE),
       resp_type_(MAX_RESP_TYPE),
@@ -301,6 +302,13 @@ int ObRespResult::is_resp_finished(bool &finished, ObMysqlRespEndingType &ending
         } else if (MAX_RESP_TYPE == resp_type_) {
           // have not read resp type, as read data len less than MYSQL_PACKET_HEADER(4)
           finished = false;
+        } else if (LOCAL_INFILE_RESP_TYPE == resp_type_ && enable_local_infile_) {
+          // server waits for the file now, no more packet follows until the client
+          // sends the file, and the final ok or error packet is read as a new response
+          if (1 == pkt_cnt_[LOCAL_INFILE_ENDING_TYPE]) {
+            finished = true;
+            ending_type = LOCAL_INFILE_ENDING_TYPE;
+          }
         } else {
           ret = OB_NOT_SUPPORTED;
           LOG_WARN("infile not supported now", K(ret));
@@ -793,8 +801,13 @@ inline int ObMysqlRespAnalyzer::analyze_resp_pkt(
     }
     case LOCAL_INFILE_ENDING_TYPE: {
       if (OB_UNLIKELY(LOCAL_INFILE_RESP_TYPE == result.get_resp_type())) {
-        ret = OB_NOT_SUPPORTED;
-        LOG_WARN("local infile not support now!", K(ret));
+        if (result.is_local_infile_enabled()) {
+          // the file and the final response are on the same server session
+          result.set_trans_state(IN_TRANS_STATE_BY_PARSE);
+        } else {
+          ret = OB_NOT_SUPPORTED;
+          LOG_WARN("local infile not support now!", K(ret));
+        }
         result.inc_pkt_cnt(LOCAL_INFILE_ENDING_TYPE);
       }
       break;
@@ -823,6 +836,70 @@ inline int ObMysqlRespAnalyzer::analyze_resp_pkt(
   return ret;
 }
 
+// between the first eof packet and the ending eof or error packet of a result set,
+// all packets are rows except the eof and error packet
+inline bool ObMysqlRespAnalyzer::is_in_row_pkts(ObRespResult &result) const
+{
+  return (skip_row_pkts_
+          && READ_HEADER == state_
+          && meta_analyzer_.empty()
+          && !is_in_multi_pkt_
+          && RESULT_SET_RESP_TYPE == result.get_resp_type()
+          && (OB_MYSQL_COM_QUERY == result.get_cmd()
+              || OB_MYSQL_COM_STMT_EXECUTE == result.get_cmd()
+              || OB_MYSQL_COM_STMT_FETCH == result.get_cmd())
+          && 1 == result.get_pkt_cnt(EOF_PACKET_ENDING_TYPE)
+          && 0 == result.get_pkt_cnt(ERROR_PACKET_ENDING_TYPE));
+}
+
+// jump from header to header in the buffer, only the packet length and type are read.
+// stop before the first packet which is not a complete row and leave it to the state
+// machine, except a row that goes on in the next buffer, whose body is read as usual
+inline void ObMysqlRespAnalyzer::skip_row_pkts(ObBufferReader &buf_reader, ObRespResult &result)
+{
+  const char *start = buf_reader.get_ptr();
+  const char *end = start + buf_reader.get_remain_len();
+  const char *pos = start;
+  int32_t row_pkt_cnt = 0;
+  int64_t reserved_len = 0;
+  bool is_row_pkt = true;
+
+  while (is_row_pkt && end - pos > MYSQL_NET_HEADER_LENGTH) {
+    const uint32_t pkt_len = ob_uint3korr(pos);
+    const uint8_t pkt_type = static_cast<uint8_t>(pos[MYSQL_NET_HEADER_LENGTH]);
+    is_row_pkt = (pkt_len > 0
+                  && MYSQL_PACKET_MAX_LENGTH != pkt_len
+                  && MYSQL_ERR_PACKET_TYPE != pkt_type
+                  && !(MYSQL_EOF_PACKET_TYPE == pkt_type && pkt_len < 9));
+    if (is_row_pkt) {
+      const char *next_pos = pos + MYSQL_NET_HEADER_LENGTH + pkt_len;
+      if (OB_LIKELY(next_pos <= end)) {
+        // rows are small, pull in the headers several rows ahead
+        __builtin_prefetch(next_pos + ROW_PKTS_PREFETCH_DISTANCE);
+        pos = next_pos;
+        ++row_pkt_cnt;
+      } else {
+        meta_analyzer_.get_meta().pkt_len_ = pkt_len;
+        meta_analyzer_.get_meta().pkt_seq_ = ob_uint1korr(pos + 3);
+        meta_analyzer_.get_meta().pkt_type_ = pkt_type;
+        meta_analyzer_.set_cur_type(MAX_PACKET_ENDING_TYPE);
+        next_read_len_ = next_pos - end;
+        // same as read_pkt_type(), do not send the header alone
+        reserved_len = (end - pos > MYSQL_NET_HEADER_LENGTH + 1) ? 0 : (end - pos);
+        state_ = READ_BODY;
+        pos = end;
+        is_row_pkt = false;
+      }
+    }
+  }
+
+  if (pos > start) {
+    buf_reader.pos_ += pos - start;
+    result.add_all_pkt_cnt(row_pkt_cnt);
+    reserved_len_ = reserved_len;
+  }
+}
+
 int ObMysqlRespAnalyzer::analyze_mysql_resp(
     ObBufferReader &buf_reader,
     ObRespResult &result,
@@ -837,7 +914,11 @@ int ObMysqlRespAnalyzer::analyze_mysql_resp(
     while ((OB_SUCC(ret)) && !buf_reader.empty()) {
       switch (state_) {
         case READ_HEADER:
-          if (OB_FAIL(read_pkt_hdr(buf_reader))) {
+          if (is_in_row_pkts(result)) {
+            skip_row_pkts(buf_reader, result);
+          }
+          if (READ_HEADER == state_ && !buf_reader.empty()
+              && OB_FAIL(read_pkt_hdr(buf_reader))) {
             LOG_WARN("fail to read packet header", K(ret));
           }
           break;
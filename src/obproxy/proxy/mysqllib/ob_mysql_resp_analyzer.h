@@ -83,6 +83,7 @@ public:
 
   int32_t get_all_pkt_cnt() const { return all_pkt_cnt_; }
   void inc_all_pkt_cnt() { ++all_pkt_cnt_; }
+  void add_all_pkt_cnt(const int32_t cnt) { all_pkt_cnt_ += cnt; }
 
   int32_t get_expect_pkt_cnt() const { return expect_pkt_cnt_; }
   void set_expect_pkt_cnt(const int32_t expect_pkt_cnt) { expect_pkt_cnt_ = expect_pkt_cnt; }
@@ -110,9 +111,14 @@ public:
   bool is_extra_ok_packet_for_stats_enabled() const {
     return enable_extra_ok_packet_for_stats_;
   }
+
+  void set_enable_local_infile(const bool enable_local_infile) { enable_local_infile_ = enable_local_infile; }
+  bool is_local_infile_enabled() const { return enable_local_infile_; }
 private:
   bool is_compress_; //use for compress Protocol, not support now
   bool enable_extra_ok_packet_for_stats_;
+  // whether the LOCAL INFILE request of server is accepted as a complete response
+  bool enable_local_infile_;
   obmysql::ObMySQLCmd cmd_;
   ObMysqlProtocolMode mysql_mode_;
   ObMysqlRespType resp_type_;
@@ -196,7 +202,7 @@ class ObMysqlResp;
 class ObMysqlRespAnalyzer
 {
 public:
-  ObMysqlRespAnalyzer()  { reset(); }
+  ObMysqlRespAnalyzer() : skip_row_pkts_(true) { reset(); }
   ~ObMysqlRespAnalyzer() { reset(); }
   void reset();
 
@@ -208,6 +214,9 @@ public:
   bool is_oceanbase_mode() const { return OCEANBASE_MYSQL_PROTOCOL_MODE == mysql_mode_; }
   bool is_mysql_mode() const { return STANDARD_MYSQL_PROTOCOL_MODE == mysql_mode_; }
   bool need_wait_more_data() const { return (next_read_len_ > 0); }
+  // row packets are skipped by their lengths without the per packet state machine,
+  // the result is the same with the packet by packet analysis
+  void set_skip_row_pkts(const bool skip_row_pkts) { skip_row_pkts_ = skip_row_pkts; }
 
 private:
   int analyze_prepare_ok_pkt(ObRespResult &result);
@@ -220,11 +229,15 @@ private:
   int read_pkt_type(ObBufferReader &buf_reader, ObRespResult &result);
   int read_pkt_body(ObBufferReader &buf_reader, ObRespResult &result);
   int analyze_resp_pkt(ObRespResult &result, ObMysqlResp *resp);
+  bool is_in_row_pkts(ObRespResult &result) const;
+  void skip_row_pkts(ObBufferReader &buf_reader, ObRespResult &result);
 
   int build_packet_content(obutils::ObVariableLenBuffer<FIXED_MEMORY_BUFFER_SIZE> &content_buf);
 
 private:
   static const int64_t OK_PACKET_MAX_COPY_LEN = 20; // 9 + 9 + 2;
+  static const int64_t ROW_PKTS_PREFETCH_DISTANCE = 256;
+  bool skip_row_pkts_;
   bool is_in_multi_pkt_;
   bool cur_stmt_has_more_result_;
   ObMysqlResponseAnalyzerState state_;
@@ -242,6 +255,7 @@ inline void ObRespResult::reset()
 {
   is_compress_ = false;
   enable_extra_ok_packet_for_stats_ = false;
+  enable_local_infile_ = false;
   cmd_ = obmysql::OB_MYSQL_COM_END;
   mysql_mode_ = UNDEFINED_MYSQL_PROTOCOL_MODE;
   resp_type_ = MAX_RESP_TYPE;
@@ -60,6 +60,7 @@ struct ObRespAnalyzeResult
   bool is_ok_resp() const { return OK_PACKET_ENDING_TYPE == ending_type_; }
   bool is_eof_resp() const { return EOF_PACKET_ENDING_TYPE == ending_type_; }
   bool is_handshake_pkt() const { return HANDSHAKE_PACKET_ENDING_TYPE == ending_type_; }
+  bool is_local_infile_resp() const { return LOCAL_INFILE_ENDING_TYPE == ending_type_; }
   obmysql::OMPKError &get_error_pkt() { return error_pkt_; }
   const obmysql::OMPKError &get_error_pkt() const { return error_pkt_; }
   uint16_t get_error_code() const { return error_pkt_.get_err_code(); }
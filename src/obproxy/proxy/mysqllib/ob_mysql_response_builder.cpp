@@ -17,6 +17,7 @@
 #include "packet/ob_mysql_packet_writer.h"
 #include "packet/ob_mysql_packet_util.h"
 #include "proxy/mysqllib/ob_proxy_session_info.h"
+#include "proxy/mysql/ob_cursor_struct.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obmysql;
@@ -155,6 +156,77 @@ int ObMysqlResponseBuilder::build_select_route_addr_resp(ObMIOBuffer &mio_buf,
   }
   return ret;
 }
+
+int ObMysqlResponseBuilder::build_prefetched_fetch_resp(ObMIOBuffer &mio_buf,
+                                                        ObProxyMysqlRequest &client_request,
+                                                        ObCursorIdAddr &cursor_id_addr)
+{
+  int ret = OB_SUCCESS;
+  uint8_t seq = static_cast<uint8_t>(client_request.get_packet_meta().pkt_seq_ + 1);
+  const int64_t row_count = std::min(static_cast<int64_t>(cursor_id_addr.get_fetch_rows()),
+                                     cursor_id_addr.get_prefetch_row_count());
+
+  // replay the resultset header, fields and eof of the prefetching fetch
+  const char *pkt_buf = cursor_id_addr.get_prefetch_head();
+  const char *head_end = pkt_buf + cursor_id_addr.get_prefetch_head_len();
+  int64_t pkt_len = 0;
+  while (OB_SUCC(ret) && pkt_buf < head_end) {
+    uint32_t payload_len = 0;
+    const char *pos = pkt_buf;
+    ObMySQLUtil::get_uint3(pos, payload_len);
+    pkt_len = MYSQL_NET_HEADER_LENGTH + payload_len;
+    if (OB_FAIL(write_packet_with_seq(mio_buf, pkt_buf, pkt_len, seq))) {
+      LOG_WARN("fail to write prefetch head packet", K(pkt_len), K(ret));
+    } else {
+      pkt_buf += pkt_len;
+    }
+  }
+
+  int64_t served_count = 0;
+  while (OB_SUCC(ret) && served_count < row_count) {
+    if (OB_FAIL(cursor_id_addr.pop_prefetch_row(pkt_buf, pkt_len))) {
+      LOG_WARN("fail to pop prefetch row", K(served_count), K(row_count), K(ret));
+    } else if (OB_FAIL(write_packet_with_seq(mio_buf, pkt_buf, pkt_len, seq))) {
+      LOG_WARN("fail to write prefetch row", K(served_count), K(pkt_len), K(ret));
+    } else if (pkt_len - MYSQL_NET_HEADER_LENGTH < MYSQL_PACKET_MAX_LENGTH) {
+      ++served_count;
+    }
+  }
+
+  if (OB_SUCC(ret)) {
+    // the cursor is still open for client until the last prefetched row is served
+    ObServerStatusFlags status = cursor_id_addr.get_server_status();
+    if (cursor_id_addr.has_prefetch_rows() || !cursor_id_addr.is_server_cursor_exhausted()) {
+      status.status_flags_.OB_SERVER_STATUS_CURSOR_EXISTS = 1;
+      status.status_flags_.OB_SERVER_STATUS_LAST_ROW_SENT = 0;
+    }
+    if (OB_FAIL(ObMysqlPacketUtil::encode_eof_packet(mio_buf, seq, status.flags_))) {
+      LOG_WARN("fail to encode eof packet", K(seq), K(ret));
+    } else if (!cursor_id_addr.has_prefetch_rows()) {
+      cursor_id_addr.reset_prefetch();
+    }
+  }
+  return ret;
+}
+
+int ObMysqlResponseBuilder::write_packet_with_seq(ObMIOBuffer &mio_buf, const char *pkt_buf,
+                                                  const int64_t pkt_len, uint8_t &seq)
+{
+  int ret = OB_SUCCESS;
+  int64_t written_len = 0;
+  char header[MYSQL_NET_HEADER_LENGTH];
+  MEMCPY(header, pkt_buf, MYSQL_NET_HEADER_LENGTH);
+  header[MYSQL_NET_HEADER_LENGTH - 1] = static_cast<char>(seq);
+  if (OB_FAIL(mio_buf.write(header, MYSQL_NET_HEADER_LENGTH, written_len))) {
+    LOG_WARN("fail to write packet header", K(ret));
+  } else if (OB_FAIL(mio_buf.write(pkt_buf + MYSQL_NET_HEADER_LENGTH,
+                                   pkt_len - MYSQL_NET_HEADER_LENGTH, written_len))) {
+    LOG_WARN("fail to write packet payload", K(pkt_len), K(ret));
+  } else {
+    ++seq;
+  }
+  return ret;
+}
 } // end of namespace proxy
 } // end of namespace obproxy
 } // end of namespace oceanbase
@@ -26,6 +26,7 @@ namespace proxy
 {
 class ObClientSessionInfo;
 class ObProxyMysqlRequest;
+class ObCursorIdAddr;
 class ObMysqlResponseBuilder
 {
 public:
@@ -61,6 +62,16 @@ public:
                                        ObProxyMysqlRequest &client_request,
                                        ObClientSessionInfo &info,
                                        const bool is_in_trans);
+
+  // response of COM_STMT_FETCH from the rows prefetched in @cursor_id_addr
+  static int build_prefetched_fetch_resp(event::ObMIOBuffer &mio_buf,
+                                         ObProxyMysqlRequest &client_request,
+                                         ObCursorIdAddr &cursor_id_addr);
+
+private:
+  // write one whole mysql packet with its seq replaced by @seq
+  static int write_packet_with_seq(event::ObMIOBuffer &mio_buf, const char *pkt_buf,
+                                   const int64_t pkt_len, uint8_t &seq);
 };
 
 inline int ObMysqlResponseBuilder::build_start_trans_resp(event::ObMIOBuffer &mio_buf,
@@ -80,6 +80,12 @@ public:
     set_server_cmd(cmd, mode, enable_extra_ok_packet_for_stats, true);
   }
 
+  //add for ut
+  void set_skip_row_pkts(const bool skip_row_pkts) { analyzer_.set_skip_row_pkts(skip_row_pkts); }
+
+  // must be called after set_server_cmd, which resets it
+  void set_enable_local_infile(const bool enable_local_infile) { result_.set_enable_local_infile(enable_local_infile); }
+
   inline obmysql::ObMySQLCmd get_server_cmd() const { return result_.get_cmd(); }
 
   inline bool is_trans_completed() const { return !is_in_trans_; }
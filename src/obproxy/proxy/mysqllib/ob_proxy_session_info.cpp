@@ -37,7 +37,8 @@ const int64_t SESSION_ITEM_NUM = 256;
 ObServerSessionInfo::ObServerSessionInfo() :
     cap_(0), compatible_capability_(0), checksum_switch_(CHECKSUM_ON), is_inited_(false),
     server_type_(DB_OB_MYSQL), shard_conn_(NULL),
-    ps_id_(0), ps_id_pair_map_(), cursor_id_pair_map_(), allocator_(), text_ps_name_set_()
+    ps_id_(0), ps_id_pair_map_(), cursor_id_pair_map_(), allocator_(), text_ps_name_set_(),
+    has_temp_table_(false)
 {
   const int BUCKET_SIZE = 8;
   text_ps_name_set_.create(BUCKET_SIZE);
@@ -121,6 +122,7 @@ void ObServerSessionInfo::reset()
   compatible_capability_.capability_ = 0;
   checksum_switch_ = CHECKSUM_ON;
   text_ps_name_set_.reuse();
+  has_temp_table_ = false;
 }
 
 void ObServerSessionInfo::destroy_ps_id_pair_map()
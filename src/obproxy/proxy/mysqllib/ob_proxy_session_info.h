@@ -234,6 +234,15 @@ public:
   }
   void destroy_cursor_id_pair_map();
   int add_text_ps_name(const uint32_t text_ps_name_id);
+  void reset_text_ps_name_set() { text_ps_name_set_.reuse(); }
+  void set_has_temp_table() { has_temp_table_ = true; }
+  // prepared statements, user variables and temporary tables are created by the
+  // bound client, they can not be cleared without closing the server session
+  bool has_client_state() const
+  {
+    return ps_id_pair_map_.count() > 0 || cursor_id_pair_map_.count() > 0
+           || text_ps_name_set_.size() > 0 || get_user_var_version() > 0 || has_temp_table_;
+  }
 
   int get_database_name(ObString &database_name) const;
   int set_database_name(const common::ObString &database_name, const bool is_string_to_lower_case);
@@ -276,6 +285,7 @@ private:
   ObCursorIdPairMap cursor_id_pair_map_;
   common::ObArenaAllocator allocator_;
   common::hash::ObHashSet<uint32_t> text_ps_name_set_;
+  bool has_temp_table_;
 
   DISALLOW_COPY_AND_ASSIGN(ObServerSessionInfo);
 };
@@ -761,6 +771,8 @@ public:
     }
   }
   void destroy_cursor_id_addr_map();
+  bool has_cursor_id_addr() const { return cursor_id_addr_map_.count() > 0; }
+  bool is_session_pool_client() const { return is_session_pool_client_; }
 
   int add_ps_id_addrs(ObPsIdAddrs *ps_id_addrs) {
     return ps_id_addrs_map_.unique_set(ps_id_addrs);
@@ -858,7 +858,8 @@ inline int ObProxySessionInfoHandler::handle_common_var(
     bool is_equal = false;
     if (client_info.is_sharding_user() && get_global_proxy_config().is_pool_mode) {
       LOG_WARN("sharding_user with pool should not enter here");
-    } else if (!client_info.is_sharding_user() && get_global_proxy_config().is_pool_mode) {
+    } else if (!client_info.is_sharding_user()
+               && (get_global_proxy_config().is_pool_mode || client_info.is_session_pool_client())) {
     } else if (OB_FAIL(client_info.is_equal_with_snapshot(str_kv.key_, str_kv.value_, is_equal))) {
       // maybe observer has upgraded
       if (OB_UNLIKELY(OB_ERR_SYS_VARIABLE_UNKNOWN == ret)) {
@@ -126,6 +126,7 @@ int ObMysqlRequestCompressTransformPlugin::build_compressed_packet(bool is_last_
 {
   int ret = OB_SUCCESS;
   int64_t read_avail = local_reader_->read_avail() ;
+  int64_t shared_len = 0;
   const bool use_fast_compress = true;
   const bool is_checksum_on = true;
   const bool is_need_reroute = false; //large request don't save, so can't reroute;
@@ -155,7 +156,7 @@ int ObMysqlRequestCompressTransformPlugin::build_compressed_packet(bool is_last_
       if (OB_FAIL(ObProto20Utils::consume_and_compress_data(local_reader_,
                   mio_buffer_, local_reader_->read_avail(), compressed_seq_,
                   compressed_seq_, request_id_, sm_->get_server_session()->get_server_sessid(),
-                  is_last_segment, is_need_reroute, &extro_info))) {
+                  is_last_segment, is_need_reroute, &extro_info, &shared_len))) {
         PROXY_API_LOG(WARN, "fail to consume and compress data with OB20", K(ret));
       }
     }
@@ -170,6 +171,8 @@ int ObMysqlRequestCompressTransformPlugin::build_compressed_packet(bool is_last_
   if (OB_SUCC(ret)) {
     int64_t compressed_len = local_transfer_reader_->read_avail();
     sm_->get_server_session()->set_compressed_seq(compressed_seq_++);
+    sm_->trans_stats_.compress_request_copied_bytes_ += read_avail - shared_len;
+    sm_->trans_stats_.compress_request_shared_bytes_ += shared_len;
 
     PROXY_API_LOG(DEBUG, "build compressed packet succ", "origin len", read_avail,
                   "compressed len(include header)", compressed_len, K(ob_proxy_protocol), K(is_checksum_on));
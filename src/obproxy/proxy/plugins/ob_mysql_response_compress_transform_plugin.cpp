@@ -95,6 +95,8 @@ int ObMysqlResponseCompressTransformPlugin::consume(event::ObIOBufferReader *rea
     }
 
     int64_t plugin_decompress_response_begin = sm_->get_based_hrtime();
+    const int64_t copied_len = analyzer_->get_copied_len();
+    const int64_t shared_len = analyzer_->get_shared_len();
 
     read_avail = local_reader_->read_avail();
     if (OB_FAIL(analyzer_->analyze_response(*local_reader_, &server_response))) {
@@ -103,6 +105,8 @@ int ObMysqlResponseCompressTransformPlugin::consume(event::ObIOBufferReader *rea
       PROXY_API_LOG(WARN, "fail to consume", K(consume_size), K(ret));
     } else {
       consume_size = local_transfer_reader_->read_avail();
+      sm_->trans_stats_.decompress_response_copied_bytes_ += analyzer_->get_copied_len() - copied_len;
+      sm_->trans_stats_.decompress_response_shared_bytes_ += analyzer_->get_shared_len() - shared_len;
 
       int64_t plugin_decompress_response_end = sm_->get_based_hrtime();
       sm_->cmd_time_stats_.plugin_decompress_response_time_ +=
@@ -0,0 +1,357 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include "ob_mysql_response_cursor_prefetch_transform_plugin.h"
+#include "rpc/obmysql/packet/ompk_resheader.h"
+#include "packet/ob_mysql_packet_reader.h"
+#include "proxy/mysqllib/ob_proxy_session_info.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obmysql;
+using namespace oceanbase::obproxy::event;
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace proxy
+{
+
+ObCursorPrefetchRespHandler::ObCursorPrefetchRespHandler()
+  : state_(PREFETCH_HEADER), column_num_(0), field_count_(0), row_count_(0),
+    is_in_multi_pkt_(false), is_stash_multi_pkt_(false), has_stashed_(false), last_seq_(0)
+{
+}
+
+int ObCursorPrefetchRespHandler::handle_resp(ObIOBufferReader &output_reader,
+                                             ObIOBufferReader &analyze_reader,
+                                             ObCursorIdAddr &cursor_id_addr,
+                                             ObMIOBuffer &output)
+{
+  int ret = OB_SUCCESS;
+  int64_t write_size = 0;
+  ObMysqlAnalyzeResult result;
+
+  // analyze_reader is ahead of output_reader by the packets to output,
+  // the rows prefetched are consumed by both without output
+  while (OB_SUCC(ret) && analyze_reader.read_avail()) {
+    if (OB_FAIL(ObProxyParserUtils::analyze_one_packet(analyze_reader, result))) {
+      PROXY_API_LOG(ERROR, "fail to analyze one packet", K(ret));
+    } else if (ANALYZE_DONE != result.status_) {
+      break;
+    } else {
+      bool need_stash = false;
+      const int64_t pkt_len = result.meta_.pkt_len_;
+      if (OB_FAIL(handle_packet(result, analyze_reader, cursor_id_addr, need_stash))) {
+        PROXY_API_LOG(WARN, "fail to handle packet", K(pkt_len), K_(state), K(ret));
+      } else if (!need_stash) {
+        renumber_packet(result.meta_.pkt_seq_, analyze_reader);
+        if (OB_FAIL(analyze_reader.consume(pkt_len))) {
+          PROXY_API_LOG(ERROR, "fail to consume analyze reader", K(pkt_len), K(ret));
+        } else {
+          write_size += pkt_len;
+        }
+      } else if (OB_FAIL(flush_output(output_reader, output, write_size))) {
+        PROXY_API_LOG(WARN, "fail to flush output", K(write_size), K(ret));
+      } else if (OB_FAIL(stash_row_packet(pkt_len, output_reader, analyze_reader, cursor_id_addr))) {
+        PROXY_API_LOG(WARN, "fail to stash row packet", K(pkt_len), K(ret));
+      }
+      is_in_multi_pkt_ = (pkt_len - MYSQL_NET_HEADER_LENGTH == MYSQL_PACKET_MAX_LENGTH);
+    }
+  }
+
+  if (OB_SUCC(ret) && OB_FAIL(flush_output(output_reader, output, write_size))) {
+    PROXY_API_LOG(WARN, "fail to flush output", K(write_size), K(ret));
+  }
+  return ret;
+}
+
+int ObCursorPrefetchRespHandler::handle_packet(const ObMysqlAnalyzeResult &result,
+                                               ObIOBufferReader &analyze_reader,
+                                               ObCursorIdAddr &cursor_id_addr,
+                                               bool &need_stash)
+{
+  int ret = OB_SUCCESS;
+  const int64_t pkt_len = result.meta_.pkt_len_;
+  need_stash = false;
+
+  switch (state_) {
+    case PREFETCH_HEADER: {
+      OMPKResheader resultset_header;
+      packet::ObMysqlPacketReader pkt_reader;
+      cursor_id_addr.reuse_prefetch_head();
+      if (OB_FAIL(pkt_reader.get_packet(analyze_reader, resultset_header))) {
+        PROXY_API_LOG(WARN, "fail to get resultset header packet", K(ret));
+      } else if (OB_FAIL(save_head_packet(pkt_len, analyze_reader, cursor_id_addr))) {
+        PROXY_API_LOG(WARN, "fail to save resultset header packet", K(ret));
+      } else {
+        column_num_ = resultset_header.get_field_count();
+        state_ = (0 == column_num_ ? PREFETCH_EOF_FIRST : PREFETCH_FIELD);
+      }
+      break;
+    }
+    case PREFETCH_FIELD: {
+      if (OB_FAIL(save_head_packet(pkt_len, analyze_reader, cursor_id_addr))) {
+        PROXY_API_LOG(WARN, "fail to save field packet", K(ret));
+      } else if (!is_in_multi_pkt_ && ++field_count_ == column_num_) {
+        state_ = PREFETCH_EOF_FIRST;
+      }
+      break;
+    }
+    case PREFETCH_EOF_FIRST: {
+      if (OB_UNLIKELY(MYSQL_EOF_PACKET_TYPE != result.meta_.pkt_type_)) {
+        ret = OB_ERR_UNEXPECTED;
+        PROXY_API_LOG(WARN, "expected eof packet, but not", "type", result.meta_.pkt_type_, K(ret));
+      } else if (OB_FAIL(save_head_packet(pkt_len, analyze_reader, cursor_id_addr))) {
+        PROXY_API_LOG(WARN, "fail to save eof packet", K(ret));
+      } else {
+        state_ = PREFETCH_ROW;
+      }
+      break;
+    }
+    case PREFETCH_ROW: {
+      if (is_in_multi_pkt_) {
+        // the left part of a large row goes with its first part
+        need_stash = is_stash_multi_pkt_;
+      } else if (MYSQL_EOF_PACKET_TYPE == result.meta_.pkt_type_) {
+        if (OB_FAIL(handle_last_eof(pkt_len, analyze_reader, cursor_id_addr))) {
+          PROXY_API_LOG(WARN, "fail to handle last eof packet", K(ret));
+        }
+        state_ = PREFETCH_DONE;
+      } else if (MYSQL_ERR_PACKET_TYPE == result.meta_.pkt_type_) {
+        // rows stashed before are useless, the error goes to client
+        cursor_id_addr.reset_prefetch();
+        state_ = PREFETCH_DONE;
+      } else if (row_count_ < cursor_id_addr.get_fetch_rows()) {
+        ++row_count_;
+      } else {
+        need_stash = true;
+      }
+      is_stash_multi_pkt_ = need_stash;
+      break;
+    }
+    case PREFETCH_DONE:
+    default:
+      // such as the extra ok packet after eof, pass directly
+      break;
+  }
+  return ret;
+}
+
+int ObCursorPrefetchRespHandler::handle_last_eof(const int64_t pkt_len,
+                                                 ObIOBufferReader &analyze_reader,
+                                                 ObCursorIdAddr &cursor_id_addr)
+{
+  int ret = OB_SUCCESS;
+  // header, 0xfe, warning count(2), status flags(2)
+  static const int64_t STATUS_OFFSET = MYSQL_NET_HEADER_LENGTH + 3;
+  char eof_buf[STATUS_OFFSET + 2];
+  if (OB_UNLIKELY(pkt_len < STATUS_OFFSET + 2)) {
+    ret = OB_ERR_UNEXPECTED;
+    PROXY_API_LOG(WARN, "eof packet is too short", K(pkt_len), K(ret));
+  } else {
+    analyze_reader.copy(eof_buf, STATUS_OFFSET + 2, 0);
+    const char *pos = eof_buf + STATUS_OFFSET;
+    uint16_t status_flags = 0;
+    ObMySQLUtil::get_uint2(pos, status_flags);
+    ObServerStatusFlags server_status(status_flags);
+    cursor_id_addr.set_server_status(server_status);
+    cursor_id_addr.set_prefetching(false);
+    if (cursor_id_addr.has_prefetch_rows()) {
+      // client has not got all the rows server sent, the cursor is still open for it
+      server_status.status_flags_.OB_SERVER_STATUS_CURSOR_EXISTS = 1;
+      server_status.status_flags_.OB_SERVER_STATUS_LAST_ROW_SENT = 0;
+      analyze_reader.replace(reinterpret_cast<const char*>(&server_status.flags_),
+                             sizeof(server_status.flags_), STATUS_OFFSET);
+    } else {
+      cursor_id_addr.reset_prefetch();
+    }
+    PROXY_API_LOG(DEBUG, "cursor prefetch done", K_(row_count), K(cursor_id_addr));
+  }
+  return ret;
+}
+
+int ObCursorPrefetchRespHandler::save_head_packet(const int64_t pkt_len,
+                                                  ObIOBufferReader &analyze_reader,
+                                                  ObCursorIdAddr &cursor_id_addr)
+{
+  int ret = OB_SUCCESS;
+  char *pkt_buf = NULL;
+  if (OB_FAIL(cursor_id_addr.alloc_prefetch_head(pkt_len, pkt_buf))) {
+    PROXY_API_LOG(WARN, "fail to alloc prefetch head", K(pkt_len), K(ret));
+  } else {
+    analyze_reader.copy(pkt_buf, pkt_len, 0);
+  }
+  return ret;
+}
+
+int ObCursorPrefetchRespHandler::stash_row_packet(const int64_t pkt_len,
+                                                  ObIOBufferReader &output_reader,
+                                                  ObIOBufferReader &analyze_reader,
+                                                  ObCursorIdAddr &cursor_id_addr)
+{
+  int ret = OB_SUCCESS;
+  char *pkt_buf = NULL;
+  // output_reader is at the row after flush, both readers skip it
+  if (OB_FAIL(cursor_id_addr.alloc_prefetch_row(pkt_len, pkt_buf))) {
+    PROXY_API_LOG(WARN, "fail to alloc prefetch row", K(pkt_len), K(ret));
+  } else if (FALSE_IT(analyze_reader.copy(pkt_buf, pkt_len, 0))) {
+  } else if (OB_FAIL(analyze_reader.consume(pkt_len))) {
+    PROXY_API_LOG(ERROR, "fail to consume analyze reader", K(pkt_len), K(ret));
+  } else if (OB_FAIL(output_reader.consume(pkt_len))) {
+    PROXY_API_LOG(ERROR, "fail to consume output reader", K(pkt_len), K(ret));
+  } else {
+    has_stashed_ = true;
+  }
+  return ret;
+}
+
+void ObCursorPrefetchRespHandler::renumber_packet(const uint8_t pkt_seq, ObIOBufferReader &analyze_reader)
+{
+  if (has_stashed_) {
+    // client never sees the kept rows, the seq goes on from the last packet passed
+    const uint8_t seq = static_cast<uint8_t>(last_seq_ + 1);
+    analyze_reader.replace(reinterpret_cast<const char*>(&seq), sizeof(seq), MYSQL_NET_HEADER_LENGTH - 1);
+    last_seq_ = seq;
+  } else {
+    last_seq_ = pkt_seq;
+  }
+}
+
+int ObCursorPrefetchRespHandler::flush_output(ObIOBufferReader &output_reader, ObMIOBuffer &output,
+                                              int64_t &write_size)
+{
+  int ret = OB_SUCCESS;
+  if (write_size > 0) {
+    int64_t written_len = 0;
+    if (OB_FAIL(output.write(&output_reader, write_size, written_len, 0))
+        || OB_UNLIKELY(write_size != written_len)) {
+      ret = (OB_SUCCESS == ret ? OB_ERR_UNEXPECTED : ret);
+      PROXY_API_LOG(ERROR, "fail to write output", "expected size", write_size,
+                    "actual size", written_len, K(ret));
+    } else if (OB_FAIL(output_reader.consume(write_size))) {
+      PROXY_API_LOG(ERROR, "fail to consume output reader", K(write_size), K(ret));
+    } else {
+      write_size = 0;
+    }
+  }
+  return ret;
+}
+
+ObMysqlResponseCursorPrefetchTransformPlugin *ObMysqlResponseCursorPrefetchTransformPlugin::alloc(ObApiTransaction &transaction)
+{
+  return op_reclaim_alloc_args(ObMysqlResponseCursorPrefetchTransformPlugin, transaction);
+}
+
+ObMysqlResponseCursorPrefetchTransformPlugin::ObMysqlResponseCursorPrefetchTransformPlugin(ObApiTransaction &transaction)
+  : ObTransformationPlugin(transaction, ObTransformationPlugin::RESPONSE_TRANSFORMATION),
+    local_reader_(NULL), local_analyze_reader_(NULL), local_output_buffer_(NULL),
+    local_output_reader_(NULL), cursor_id_addr_(NULL), resp_handler_()
+{
+  PROXY_API_LOG(DEBUG, "ObMysqlResponseCursorPrefetchTransformPlugin born", K(this));
+}
+
+void ObMysqlResponseCursorPrefetchTransformPlugin::destroy()
+{
+  PROXY_API_LOG(DEBUG, "ObMysqlResponseCursorPrefetchTransformPlugin destroy", K(this));
+  ObTransformationPlugin::destroy();
+  if (NULL != local_output_buffer_) {
+    free_miobuffer(local_output_buffer_);
+    local_output_buffer_ = NULL;
+    local_output_reader_ = NULL;
+  }
+  op_reclaim_free(this);
+}
+
+int ObMysqlResponseCursorPrefetchTransformPlugin::consume(event::ObIOBufferReader *reader)
+{
+  PROXY_API_LOG(DEBUG, "ObMysqlResponseCursorPrefetchTransformPlugin::consume happen");
+  int ret = OB_SUCCESS;
+
+  if (NULL == local_reader_) {
+    local_reader_ = reader->clone();
+    local_analyze_reader_ = local_reader_->clone();
+  } else {
+    local_reader_->reserved_size_ = reader->reserved_size_;
+    local_analyze_reader_->reserved_size_ = reader->reserved_size_;
+  }
+
+  // the output only shares the blocks of the input
+  if (NULL == local_output_buffer_) {
+    if (OB_ISNULL(local_output_buffer_ = new_empty_miobuffer())) {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      PROXY_API_LOG(WARN, "fail to new miobuffer", K(ret));
+    } else if (OB_ISNULL(local_output_reader_ = local_output_buffer_->alloc_reader())) {
+      ret = OB_ERR_UNEXPECTED;
+      PROXY_API_LOG(WARN, "fail to alloc reader", K(ret));
+    }
+  }
+
+  if (OB_SUCC(ret) && !resp_handler_.is_done()) {
+    ObClientSessionInfo &cs_info = sm_->get_client_session()->get_session_info();
+    if (OB_FAIL(cs_info.get_cursor_id_addr(cursor_id_addr_))) {
+      PROXY_API_LOG(WARN, "fail to get cursor id addr", K(ret));
+    } else if (OB_ISNULL(cursor_id_addr_)) {
+      ret = OB_ERR_UNEXPECTED;
+      PROXY_API_LOG(WARN, "cursor id addr is null", K(ret));
+    }
+  }
+
+  if (OB_FAIL(ret)) {
+  } else if (OB_FAIL(resp_handler_.handle_resp(*local_reader_, *local_analyze_reader_,
+                                               *cursor_id_addr_, *local_output_buffer_))) {
+    PROXY_API_LOG(WARN, "fail to handle cursor prefetch response", K(ret));
+  } else {
+    const int64_t write_size = local_output_reader_->read_avail();
+    int64_t actual_size = 0;
+    if (write_size > 0) {
+      if (write_size != (actual_size = produce(local_output_reader_, write_size))) {
+        ret = OB_ERR_UNEXPECTED;
+        PROXY_API_LOG(ERROR, "fail to produce", "expected size", write_size,
+                      "actual size", actual_size, K(ret));
+      } else if (OB_FAIL(local_output_reader_->consume(write_size))) {
+        PROXY_API_LOG(ERROR, "fail to consume local output reader", K(write_size), K(ret));
+      }
+    }
+  }
+
+  if (OB_FAIL(ret)) {
+    if (NULL != cursor_id_addr_) {
+      cursor_id_addr_->reset_prefetch();
+    }
+    sm_->trans_state_.inner_errcode_ = ret;
+    // if failed, set state to INTERNAL_ERROR
+    sm_->trans_state_.current_.state_ = ObMysqlTransact::INTERNAL_ERROR;
+  }
+
+  return ret;
+}
+
+void ObMysqlResponseCursorPrefetchTransformPlugin::handle_input_complete()
+{
+  PROXY_API_LOG(DEBUG, "ObMysqlResponseCursorPrefetchTransformPlugin::handle_input_complete happen");
+  if (NULL != local_reader_) {
+    local_reader_->dealloc();
+    local_reader_ = NULL;
+  }
+
+  if (NULL != local_analyze_reader_) {
+    local_analyze_reader_->dealloc();
+    local_analyze_reader_ = NULL;
+  }
+
+  set_output_complete();
+}
+
+} // end of namespace proxy
+} // end of namespace obproxy
+} // end of namespace oceanbase
@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OBPROXY_MYSQL_RESPONSE_CURSOR_PREFETCH_TRANSFORM_PLUGIN_H
+#define OBPROXY_MYSQL_RESPONSE_CURSOR_PREFETCH_TRANSFORM_PLUGIN_H
+
+#include "proxy/api/ob_global_plugin.h"
+#include "proxy/api/ob_transformation_plugin.h"
+#include "proxy/mysql/ob_mysql_sm.h"
+#include "proxy/mysql/ob_cursor_struct.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace proxy
+{
+
+/*
+ * Splits the response of a prefetching COM_STMT_FETCH into the packets passed
+ * to client and the rows kept in the ObCursorIdAddr of the cursor. The packets
+ * after the first kept row are renumbered to follow the last packet passed, and
+ * the eof packet tells client the cursor is still open while kept rows are left.
+ */
+class ObCursorPrefetchRespHandler
+{
+public:
+  ObCursorPrefetchRespHandler();
+  ~ObCursorPrefetchRespHandler() {}
+
+  // handle the complete packets in @analyze_reader, @output_reader is at the same
+  // position, the packets passed to client are written from it into @output
+  int handle_resp(event::ObIOBufferReader &output_reader, event::ObIOBufferReader &analyze_reader,
+                  ObCursorIdAddr &cursor_id_addr, event::ObMIOBuffer &output);
+  bool is_done() const { return PREFETCH_DONE == state_; }
+
+private:
+  enum ObPrefetchState
+  {
+    PREFETCH_HEADER = 0,
+    PREFETCH_FIELD,
+    PREFETCH_EOF_FIRST,
+    PREFETCH_ROW,
+    PREFETCH_DONE
+  };
+
+  int handle_packet(const ObMysqlAnalyzeResult &result, event::ObIOBufferReader &analyze_reader,
+                    ObCursorIdAddr &cursor_id_addr, bool &need_stash);
+  int handle_last_eof(const int64_t pkt_len, event::ObIOBufferReader &analyze_reader,
+                      ObCursorIdAddr &cursor_id_addr);
+  int save_head_packet(const int64_t pkt_len, event::ObIOBufferReader &analyze_reader,
+                       ObCursorIdAddr &cursor_id_addr);
+  int stash_row_packet(const int64_t pkt_len, event::ObIOBufferReader &output_reader,
+                       event::ObIOBufferReader &analyze_reader, ObCursorIdAddr &cursor_id_addr);
+  void renumber_packet(const uint8_t pkt_seq, event::ObIOBufferReader &analyze_reader);
+  int flush_output(event::ObIOBufferReader &output_reader, event::ObMIOBuffer &output,
+                   int64_t &write_size);
+
+private:
+  ObPrefetchState state_;
+  uint64_t column_num_;
+  uint64_t field_count_;
+  int64_t row_count_;
+  // the last packet is a part of a row larger than 16MB
+  bool is_in_multi_pkt_;
+  bool is_stash_multi_pkt_;
+  // rows have been kept, the seq of the packets passed after them is rewritten
+  bool has_stashed_;
+  uint8_t last_seq_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObCursorPrefetchRespHandler);
+};
+
+/*
+ * The COM_STMT_FETCH sent to server asks cursor_prefetch_multiple times the rows
+ * client asks, this plugin passes the rows client asks and keeps the others in
+ * the ObCursorIdAddr of the cursor, the following fetches are answered by them
+ * without going to server.
+ */
+class ObMysqlResponseCursorPrefetchTransformPlugin : public ObTransformationPlugin
+{
+public:
+  static ObMysqlResponseCursorPrefetchTransformPlugin *alloc(ObApiTransaction &transaction);
+
+  explicit ObMysqlResponseCursorPrefetchTransformPlugin(ObApiTransaction &transaction);
+
+  virtual void destroy();
+
+  // this func can not consume the reader, super class will do it
+  virtual int consume(event::ObIOBufferReader *reader);
+
+  virtual void handle_input_complete();
+
+private:
+  event::ObIOBufferReader *local_reader_;
+  event::ObIOBufferReader *local_analyze_reader_;
+  event::ObMIOBuffer *local_output_buffer_;
+  event::ObIOBufferReader *local_output_reader_;
+  // looked up again in each consume, the cursor may be closed by others
+  ObCursorIdAddr *cursor_id_addr_;
+  ObCursorPrefetchRespHandler resp_handler_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObMysqlResponseCursorPrefetchTransformPlugin);
+};
+
+class ObMysqlResponseCursorPrefetchGlobalPlugin : public ObGlobalPlugin
+{
+public:
+  static ObMysqlResponseCursorPrefetchGlobalPlugin *alloc()
+  {
+    return op_reclaim_alloc(ObMysqlResponseCursorPrefetchGlobalPlugin);
+  }
+
+  ObMysqlResponseCursorPrefetchGlobalPlugin()
+  {
+    register_hook(HOOK_READ_RESPONSE);
+  }
+
+  virtual void destroy()
+  {
+    ObGlobalPlugin::destroy();
+    op_reclaim_free(this);
+  }
+
+  virtual void handle_read_response(ObApiTransaction &transaction)
+  {
+    ObTransactionPlugin *plugin = NULL;
+    ObCursorIdAddr *cursor_id_addr = NULL;
+
+    if (need_enable_plugin(transaction.get_sm(), cursor_id_addr)) {
+      plugin = ObMysqlResponseCursorPrefetchTransformPlugin::alloc(transaction);
+      if (NULL != plugin) {
+        transaction.add_plugin(plugin);
+        PROXY_API_LOG(DEBUG, "add ObMysqlResponseCursorPrefetchTransformPlugin", K(plugin));
+      } else {
+        cursor_id_addr->set_prefetching(false);
+        PROXY_API_LOG(ERROR, "fail to allocate memory for ObMysqlResponseCursorPrefetchTransformPlugin");
+      }
+    } else {
+      PROXY_API_LOG(DEBUG, "no need setup ObMysqlResponseCursorPrefetchTransformPlugin");
+    }
+
+    transaction.resume();
+  }
+
+  inline bool need_enable_plugin(ObMysqlSM *sm, ObCursorIdAddr *&cursor_id_addr) const
+  {
+    return (!sm->trans_state_.trans_info_.client_request_.is_internal_cmd()
+            && ObMysqlTransact::SERVER_SEND_REQUEST == sm->trans_state_.current_.send_action_
+            && obmysql::OB_MYSQL_COM_STMT_FETCH == sm->trans_state_.trans_info_.sql_cmd_
+            && sm->trans_state_.trans_info_.server_response_.get_analyze_result().is_resultset_resp()
+            && common::OB_SUCCESS == sm->get_client_session()->get_session_info().get_cursor_id_addr(cursor_id_addr)
+            && NULL != cursor_id_addr
+            && cursor_id_addr->is_prefetching());
+  }
+
+private:
+  DISALLOW_COPY_AND_ASSIGN(ObMysqlResponseCursorPrefetchGlobalPlugin);
+};
+
+void init_mysql_response_cursor_prefetch_transform()
+{
+  PROXY_API_LOG(INFO, "init mysql response cursor prefetch transformation plugin");
+  ObMysqlResponseCursorPrefetchGlobalPlugin *prefetch_transform = ObMysqlResponseCursorPrefetchGlobalPlugin::alloc();
+  UNUSED(prefetch_transform);
+}
+
+} // end of namespace proxy
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+#endif // OBPROXY_MYSQL_RESPONSE_CURSOR_PREFETCH_TRANSFORM_PLUGIN_H
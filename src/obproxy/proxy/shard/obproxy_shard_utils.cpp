@@ -25,6 +25,7 @@
 #include "optimizer/ob_sharding_select_log_plan.h"
 #include "obutils/ob_proxy_stmt.h"
 #include "optimizer/ob_proxy_optimizer_processor.h"
+#include "executor/ob_proxy_parallel_dml.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::obmysql;
@@ -32,6 +33,7 @@ using namespace oceanbase::obproxy::dbconfig;
 using namespace oceanbase::obproxy::obutils;
 using namespace oceanbase::sql;
 using namespace oceanbase::obproxy::optimizer;
+using namespace oceanbase::obproxy::executor;
 
 
 namespace oceanbase
@@ -41,6 +43,7 @@ namespace obproxy
 namespace proxy
 {
 static const char* DEFAULT_READ_CONSISTENCY = "STRONG";
+static const uint32_t PARSE_EXTRA_CHAR_NUM = 2;
 int ObProxyShardUtils::check_logic_database(ObMysqlTransact::ObTransState &trans_state,
                                             ObMysqlClientSession &client_session,
                                             const ObString &db_name)
@@ -233,15 +236,46 @@ int ObProxyShardUtils::rewrite_shard_request(ObClientSessionInfo &session_info,
                                              bool is_single_shard_db_table)
 {
   int ret = OB_SUCCESS;
+  common::ObSqlString new_sql;
+
+  if (OB_FAIL(build_shard_request_sql(session_info, client_request, table_name, database_name,
+                                      real_table_name, real_database_name,
+                                      is_single_shard_db_table, new_sql))) {
+    LOG_WARN("fail to build shard request sql", K(ret));
+  // 4. push reader forward by consuming old buffer and write new sql into buffer
+  } else if (OB_FAIL(client_buffer_reader.consume_all())) {
+    LOG_WARN("fail to consume all", K(ret));
+  } else {
+    ObMIOBuffer *writer = client_buffer_reader.mbuf_;
+    if (OB_ISNULL(writer)) {
+      ret = OB_ERR_UNEXPECTED;
+      LOG_WARN("unexpected null values ", K(writer), K(ret));
+      // no need compress here, if server session support comrpess, it will compress later
+    } else if (OB_FAIL(ObMysqlRequestBuilder::build_mysql_request(*writer, obmysql::OB_MYSQL_COM_QUERY, new_sql.string(), false, false))) {
+      LOG_WARN("fail to build_mysql_request", K(new_sql), K(ret));
+    } else if (OB_FAIL(ObProxySessionInfoHandler::rewrite_query_req_by_sharding(session_info, client_request, client_buffer_reader))) {
+      LOG_WARN("fail to rewrite_query_req_by_sharding", K(ret));
+    }
+  }
+
+  return ret;
+}
+
+int ObProxyShardUtils::build_shard_request_sql(ObClientSessionInfo &session_info,
+                                               ObProxyMysqlRequest &client_request,
+                                               const ObString &table_name, const ObString &database_name,
+                                               const ObString &real_table_name, const ObString &real_database_name,
+                                               bool is_single_shard_db_table,
+                                               common::ObSqlString &new_sql)
+{
+  int ret = OB_SUCCESS;
 
-  const uint32_t PARSE_EXTRA_CHAR_NUM = 2;
   uint64_t table_len = table_name.length();
   int64_t dml_tb_pos = client_request.get_parse_result().get_dbmesh_route_info().tb_pos_;
   uint64_t index_table_len = table_name.length();
   int64_t index_table_pos = client_request.get_parse_result().get_dbmesh_route_info().index_tb_pos_;
 
   ObString sql = client_request.get_parse_sql();
-  common::ObSqlString new_sql;
   const char *sql_ptr = sql.ptr();
   int64_t sql_len = sql.length();
 
@@ -329,22 +363,8 @@ int ObProxyShardUtils::rewrite_shard_request(ObClientSessionInfo &session_info,
   }
 
   copy_pos = table_pos + table_len;
-  new_sql.append(sql_ptr + copy_pos, sql_len - copy_pos - PARSE_EXTRA_CHAR_NUM);
-
-  // 4. push reader forward by consuming old buffer and write new sql into buffer
-  if (OB_FAIL(client_buffer_reader.consume_all())) {
-    LOG_WARN("fail to consume all", K(ret));
-  } else {
-    ObMIOBuffer *writer = client_buffer_reader.mbuf_;
-    if (OB_ISNULL(writer)) {
-      ret = OB_ERR_UNEXPECTED;
-      LOG_WARN("unexpected null values ", K(writer), K(ret));
-      // no need compress here, if server session support comrpess, it will compress later
-    } else if (OB_FAIL(ObMysqlRequestBuilder::build_mysql_request(*writer, obmysql::OB_MYSQL_COM_QUERY, new_sql.string(), false, false))) {
-      LOG_WARN("fail to build_mysql_request", K(new_sql), K(ret));
-    } else if (OB_FAIL(ObProxySessionInfoHandler::rewrite_query_req_by_sharding(session_info, client_request, client_buffer_reader))) {
-      LOG_WARN("fail to rewrite_query_req_by_sharding", K(ret));
-    }
+  if (OB_FAIL(new_sql.append(sql_ptr + copy_pos, sql_len - copy_pos - PARSE_EXTRA_CHAR_NUM))) {
+    LOG_WARN("fail to append sql", K(ret));
   }
 
   return ret;
@@ -1057,6 +1077,7 @@ int ObProxyShardUtils::handle_dml_request(ObMysqlClientSession &client_session,
   ObSEArray<ObShardConnector*, 4> shard_connector_array;
   ObSEArray<ObString, 4> physical_table_name_array;
   ObIAllocator *allocator = NULL;
+  int64_t dml_shard_count = 0;
 
   if (parse_result.is_show_create_table_stmt() || parse_result.is_desc_table_stmt()) {
     if (OB_FAIL(handle_other_real_info(db_info, client_session, trans_state, table_name,
@@ -1064,8 +1085,14 @@ int ObProxyShardUtils::handle_dml_request(ObMysqlClientSession &client_session,
                                        real_table_name, OB_MAX_TABLE_NAME_LENGTH))) {
       LOG_WARN("fail to handle other real info", K(ret), K(session_info), K(table_name));
     }
+  } else if (OB_FAIL(handle_parallel_dml_request(client_session, trans_state, table_name,
+                                                 db_info, dml_shard_count))) {
+    LOG_WARN("fail to handle parallel dml request", K(ret), K(table_name));
+  } else if (dml_shard_count > 1) {
+    // sub sqls will be executed by parallel dml plan, no need rewrite
   } else if ((parse_result.is_insert_stmt() || parse_result.is_replace_stmt()
-             || parse_result.is_update_stmt()) && parse_result.get_batch_insert_values_count() > 1) {
+             || parse_result.is_update_stmt()) && parse_result.get_batch_insert_values_count() > 1
+             && 1 != dml_shard_count) {
     ret = OB_ERR_BATCH_INSERT_FOUND;
     LOG_WARN("batch insert not supported in sharding sql", K(ret), K(parse_result.get_batch_insert_values_count()));
   } else if (is_scan_all && parse_result.is_select_stmt()) {
@@ -1125,6 +1152,8 @@ int ObProxyShardUtils::handle_dml_request(ObMysqlClientSession &client_session,
           }
         }
       }
+    } else if (dml_shard_count > 1) {
+      // do nothing
     } else if (OB_FAIL(rewrite_shard_request(session_info, client_request, client_buffer_reader,
                                         table_name, db_info.db_name_.config_string_, ObString::make_string(real_table_name),
                                         ObString::make_string(real_database_name), false))) {
@@ -1136,6 +1165,283 @@ int ObProxyShardUtils::handle_dml_request(ObMysqlClientSession &client_session,
   return ret;
 }
 
+// Multi-row insert/replace and update/delete with 'col in (...)' are split by shard,
+// the sub sqls are executed in parallel out of transaction.
+//   dml_shard_count = 0, can not be split, keep the old behavior
+//   dml_shard_count = 1, all rows are in the same shard, execute it as usual
+//   dml_shard_count > 1, parallel dml plan is set to client session
+int ObProxyShardUtils::handle_parallel_dml_request(ObMysqlClientSession &client_session,
+                                                   ObMysqlTransact::ObTransState &trans_state,
+                                                   const ObString &table_name,
+                                                   ObDbConfigLogicDb &db_info,
+                                                   int64_t &dml_shard_count)
+{
+  int ret = OB_SUCCESS;
+  ObClientSessionInfo &session_info = client_session.get_session_info();
+  ObProxyMysqlRequest &client_request = trans_state.trans_info_.client_request_;
+  ObSqlParseResult &parse_result = client_request.get_parse_result();
+  SqlFieldResult &sql_result = parse_result.get_sql_filed_result();
+  const bool is_insert = parse_result.is_insert_stmt() || parse_result.is_replace_stmt();
+  const bool is_update = parse_result.is_update_stmt() || parse_result.is_delete_stmt();
+  bool has_multi_value = false;
+  dml_shard_count = 0;
+
+  for (int64_t i = 0; !has_multi_value && i < sql_result.field_num_; ++i) {
+    has_multi_value = sql_result.fields_.at(i).column_values_.count() > 1;
+  }
+
+  if (!get_global_proxy_config().enable_sharding_parallel_dml
+      || db_info.is_single_shard_db_table()
+      || is_sharding_in_trans(session_info, trans_state)
+      || !((is_insert && parse_result.get_batch_insert_values_count() > 1)
+           || (is_update && has_multi_value))) {
+    // do nothing
+  } else {
+    ObString sql = client_request.get_parse_sql();
+    sql.assign_ptr(sql.ptr(), sql.length() - PARSE_EXTRA_CHAR_NUM);
+    ObProxyDmlSplitResult split_result;
+    ObSEArray<ObString, 8> row_values;
+    ObSEArray<SqlField, 5> orig_fields;
+    const int orig_field_num = sql_result.field_num_;
+    ObIAllocator *allocator = NULL;
+    ObSEArray<ObShardConnector*, 4> group_conns;
+    ObSEArray<ObString, 4> group_real_dbs;
+    ObSEArray<ObString, 4> group_real_tbs;
+    ObSEArray<int64_t, 64> item_groups;
+    bool can_split = true;
+    bool is_fields_changed = false;
+
+    if (OB_FAIL(is_insert ? ObProxyDmlSplitter::split_insert_values(sql, split_result)
+                          : ObProxyDmlSplitter::split_in_list(sql, split_result))) {
+      LOG_DEBUG("dml can not be split, keep serial", K(sql), K(ret));
+      can_split = false;
+      ret = OB_SUCCESS;
+    } else if (OB_UNLIKELY(is_insert && split_result.columns_.empty())) {
+      // insert without column list
+      can_split = false;
+    } else if (!is_insert && ObProxyDmlSplitter::has_order_by_or_limit(sql)) {
+      // the rows chosen by order by and limit depend on all shards, can not be split
+      LOG_DEBUG("update or delete with order by or limit, keep serial", K(sql));
+      can_split = false;
+    } else if (OB_FAIL(orig_fields.assign(sql_result.fields_))) {
+      LOG_WARN("fail to save sql fields", K(ret));
+    } else if (OB_FAIL(get_global_optimizer_processor().alloc_allocator(allocator))) {
+      LOG_WARN("alloc allocator failed", K(ret));
+    }
+
+    // route each row or each value in list
+    for (int64_t i = 0; OB_SUCC(ret) && can_split && i < split_result.items_.count(); ++i) {
+      const ObString &item = split_result.items_.at(i);
+      is_fields_changed = true;
+      row_values.reuse();
+      sql_result.fields_.reuse();
+      sql_result.field_num_ = 0;
+      for (int64_t j = 0; OB_SUCC(ret) && j < orig_fields.count(); ++j) {
+        SqlField field;
+        field = orig_fields.at(j);
+        if (OB_FAIL(sql_result.fields_.push_back(field))) {
+          LOG_WARN("fail to push back field", K(ret));
+        }
+      }
+      sql_result.field_num_ = static_cast<int>(sql_result.fields_.count());
+
+      if (OB_FAIL(ret)) {
+      } else if (is_insert) {
+        if (OB_FAIL(ObProxyDmlSplitter::split_row_values(item, row_values))
+            || row_values.count() != split_result.columns_.count()) {
+          LOG_DEBUG("row values not match columns, keep serial", K(item), K(ret));
+          can_split = false;
+          ret = OB_SUCCESS;
+        }
+      } else if (OB_FAIL(row_values.push_back(item))) {
+        LOG_WARN("fail to push back item", K(ret));
+      }
+
+      for (int64_t j = 0; OB_SUCC(ret) && can_split && j < row_values.count(); ++j) {
+        ObString column_name = is_insert ? split_result.columns_.at(j) : split_result.column_name_;
+        SqlColumnValue column_value;
+        if ('`' == column_name[0] && column_name.length() > 2) {
+          column_name.assign_ptr(column_name.ptr() + 1, column_name.length() - 2);
+        }
+        int64_t field_index = -1;
+        for (int64_t k = 0; field_index < 0 && k < sql_result.fields_.count(); ++k) {
+          if (0 == sql_result.fields_.at(k).column_name_.string_.case_compare(column_name)) {
+            field_index = k;
+          }
+        }
+        if (ObProxyDmlSplitter::get_column_value(row_values.at(j), column_value)) {
+          if (field_index >= 0) {
+            SqlField &field = sql_result.fields_.at(field_index);
+            field.column_values_.reuse();
+            if (OB_FAIL(field.column_values_.push_back(column_value))) {
+              LOG_WARN("fail to push back column value", K(ret));
+            }
+          } else {
+            SqlField field;
+            field.column_name_.set(column_name);
+            if (OB_FAIL(field.column_values_.push_back(column_value))) {
+              LOG_WARN("fail to push back column value", K(ret));
+            } else if (OB_FAIL(sql_result.fields_.push_back(field))) {
+              LOG_WARN("fail to push back field", K(ret));
+            } else {
+              ++sql_result.field_num_;
+            }
+          }
+        } else if (!is_insert) {
+          // the value of in list is not literal
+          can_split = false;
+        } else if (field_index >= 0) {
+          // the value of first row must not be used, routing fails if it is a shard key
+          if (OB_FAIL(sql_result.fields_.remove(field_index))) {
+            LOG_WARN("fail to remove field", K(field_index), K(ret));
+          } else {
+            --sql_result.field_num_;
+          }
+        }
+      }
+
+      if (OB_SUCC(ret) && can_split) {
+        ObShardConnector *shard_conn = NULL;
+        char real_table_name[OB_MAX_TABLE_NAME_LENGTH];
+        char real_database_name[OB_MAX_DATABASE_NAME_LENGTH];
+        int64_t group_index = -1;
+        if (OB_FAIL(get_real_info(db_info, table_name, parse_result, shard_conn,
+                                  real_database_name, OB_MAX_DATABASE_NAME_LENGTH,
+                                  real_table_name, OB_MAX_TABLE_NAME_LENGTH,
+                                  NULL, NULL, NULL, false))) {
+          LOG_DEBUG("fail to route row, keep serial", K(item), K(ret));
+          can_split = false;
+          ret = OB_SUCCESS;
+        } else if (OB_ISNULL(shard_conn)) {
+          can_split = false;
+        } else {
+          const ObString real_db = ObString::make_string(real_database_name);
+          const ObString real_tb = ObString::make_string(real_table_name);
+          for (int64_t k = 0; group_index < 0 && k < group_conns.count(); ++k) {
+            if (*group_conns.at(k) == *shard_conn
+                && group_real_dbs.at(k) == real_db && group_real_tbs.at(k) == real_tb) {
+              group_index = k;
+            }
+          }
+          if (group_index < 0) {
+            ObString db_str;
+            ObString tb_str;
+            group_index = group_conns.count();
+            if (OB_FAIL(ob_write_string(*allocator, real_db, db_str))
+                || OB_FAIL(ob_write_string(*allocator, real_tb, tb_str))) {
+              LOG_WARN("fail to write string", K(ret));
+            } else if (OB_FAIL(group_conns.push_back(shard_conn))) {
+              LOG_WARN("fail to push back shard conn", K(ret));
+            } else {
+              // take the ref of shard_conn
+              shard_conn = NULL;
+              if (OB_FAIL(group_real_dbs.push_back(db_str))
+                  || OB_FAIL(group_real_tbs.push_back(tb_str))) {
+                LOG_WARN("fail to push back real name", K(ret));
+              }
+            }
+          }
+          if (OB_SUCC(ret) && OB_FAIL(item_groups.push_back(group_index))) {
+            LOG_WARN("fail to push back item group", K(ret));
+          }
+        }
+
+        if (NULL != shard_conn) {
+          shard_conn->dec_ref();
+          shard_conn = NULL;
+        }
+      }
+    }
+
+    // restore the sql fields
+    if (is_fields_changed) {
+      int tmp_ret = OB_SUCCESS;
+      sql_result.fields_.reuse();
+      for (int64_t i = 0; OB_SUCCESS == tmp_ret && i < orig_fields.count(); ++i) {
+        SqlField field;
+        field = orig_fields.at(i);
+        if (OB_SUCCESS != (tmp_ret = sql_result.fields_.push_back(field))) {
+          LOG_WARN("fail to restore sql field", K(i), K(tmp_ret));
+        }
+      }
+      if (OB_SUCCESS == tmp_ret) {
+        sql_result.field_num_ = orig_field_num;
+      } else {
+        sql_result.field_num_ = static_cast<int>(sql_result.fields_.count());
+        if (OB_SUCC(ret)) {
+          ret = tmp_ret;
+        }
+      }
+    }
+
+    if (OB_SUCC(ret) && can_split) {
+      dml_shard_count = group_conns.count();
+    }
+
+    if (OB_SUCC(ret) && dml_shard_count > 1) {
+      ObProxyParallelDmlPlan *plan = NULL;
+      void *ptr = NULL;
+      ObSqlString shard_sql;
+      ObSqlString sub_sql;
+      ObProxyDmlSplitResult shard_split_result;
+      ObSEArray<int64_t, 64> item_indexes;
+      if (OB_ISNULL(ptr = allocator->alloc(sizeof(ObProxyParallelDmlPlan)))) {
+        ret = OB_ALLOCATE_MEMORY_FAILED;
+        LOG_WARN("fail to alloc parallel dml plan", K(ret));
+      } else {
+        plan = new(ptr) ObProxyParallelDmlPlan(allocator);
+        client_session.set_parallel_dml_plan(plan);
+        // the allocator is owned by plan now
+        allocator = NULL;
+      }
+      for (int64_t i = 0; OB_SUCC(ret) && i < group_conns.count(); ++i) {
+        item_indexes.reuse();
+        shard_sql.reuse();
+        for (int64_t j = 0; OB_SUCC(ret) && j < item_groups.count(); ++j) {
+          if (i == item_groups.at(j) && OB_FAIL(item_indexes.push_back(j))) {
+            LOG_WARN("fail to push back item index", K(ret));
+          }
+        }
+        // rewrite logic name to real name, then keep the items of this shard
+        if (OB_FAIL(ret)) {
+        } else if (OB_FAIL(build_shard_request_sql(session_info, client_request, table_name,
+                                                   db_info.db_name_.config_string_,
+                                                   group_real_tbs.at(i), group_real_dbs.at(i),
+                                                   false, shard_sql))) {
+          LOG_WARN("fail to build shard request sql", K(ret));
+        } else if (OB_FAIL(is_insert ? ObProxyDmlSplitter::split_insert_values(shard_sql.string(), shard_split_result)
+                                     : ObProxyDmlSplitter::split_in_list(shard_sql.string(), shard_split_result))) {
+          LOG_WARN("fail to split shard sql", K(shard_sql), K(ret));
+        } else if (OB_UNLIKELY(shard_split_result.items_.count() != split_result.items_.count())) {
+          ret = OB_ERR_UNEXPECTED;
+          LOG_WARN("item count changed after rewrite", K(split_result), K(shard_split_result), K(ret));
+        } else if (OB_FAIL(ObProxyDmlSplitter::build_sql(shard_split_result, item_indexes, sub_sql))) {
+          LOG_WARN("fail to build sub sql", K(ret));
+        } else if (OB_FAIL(plan->add_sub_sql(group_conns.at(i), sub_sql.string()))) {
+          LOG_WARN("fail to add sub sql", K(sub_sql), K(ret));
+        } else {
+          LOG_DEBUG("parallel dml sub sql", "shard", group_conns.at(i)->shard_name_, K(sub_sql));
+        }
+      }
+      if (OB_FAIL(ret)) {
+        client_session.set_parallel_dml_plan(NULL);
+      }
+    }
+
+    for (int64_t i = 0; i < group_conns.count(); ++i) {
+      group_conns.at(i)->dec_ref();
+    }
+    group_conns.reset();
+
+    if (OB_NOT_NULL(allocator)) {
+      get_global_optimizer_processor().free_allocator(allocator);
+      allocator = NULL;
+    }
+  }
+
+  return ret;
+}
+
 int ObProxyShardUtils::update_sys_read_consistency_if_need(ObClientSessionInfo &session_info)
 {
   int ret = OB_SUCCESS;
@@ -1401,23 +1707,7 @@ int ObProxyShardUtils::get_db_version(const ObString &logic_tenant_name,
 
 int ObProxyShardUtils::get_all_database(const ObString &logic_tenant_name, ObArray<ObString> &db_names)
 {
-  int ret = OB_SUCCESS;
-  ObDbConfigLogicTenant *tenant_info = NULL;
-  ObDbConfigCache &dbconfig_cache = get_global_dbconfig_cache();
-  if (NULL != (tenant_info = dbconfig_cache.get_exist_tenant(logic_tenant_name))) {
-    obsys::CRLockGuard guard(dbconfig_cache.rwlock_);
-    ObDbConfigLogicTenant::LDHashMap &logic_db_map = tenant_info->ld_map_;
-    ObDbConfigLogicTenant::LDHashMap::iterator it = logic_db_map.begin();
-    ObDbConfigLogicTenant::LDHashMap::iterator it_end = logic_db_map.end();
-    for (; it != it_end; ++it) {
-      db_names.push_back(it->db_name_.config_string_);
-    }
-  }
-  if (NULL != tenant_info) {
-    tenant_info->dec_ref();
-    tenant_info = NULL;
-  }
-  return ret;
+  return get_global_dbconfig_cache().get_all_logic_db(logic_tenant_name, db_names);
 }
 
 int ObProxyShardUtils::get_all_schema_table(const ObString &logic_tenant_name, const ObString &logic_database_name, ObArray<ObString> &table_names)
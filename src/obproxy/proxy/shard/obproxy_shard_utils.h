@@ -107,6 +107,11 @@ private:
                                 ObIOBufferReader &client_buffer_reader,
                                 const common::ObString &table_name,
                                 dbconfig::ObDbConfigLogicDb &db_info);
+  static int handle_parallel_dml_request(ObMysqlClientSession &client_session,
+                                         ObMysqlTransact::ObTransState &trans_state,
+                                         const common::ObString &table_name,
+                                         dbconfig::ObDbConfigLogicDb &db_info,
+                                         int64_t &dml_shard_count);
   static int check_logic_database(ObMysqlTransact::ObTransState &trans_state,
                                   ObMysqlClientSession &client_session, const ObString &db_name);
   static void replace_oracle_table(ObSqlString &new_sql, const ObString &real_name,
@@ -118,6 +123,12 @@ private:
                                    const ObString &table_name, const ObString &database_name,
                                    const ObString &real_table_name, const ObString &real_database_name,
                                    bool is_single_shard_db_table);
+  static int build_shard_request_sql(ObClientSessionInfo &session_info,
+                                     ObProxyMysqlRequest &client_request,
+                                     const ObString &table_name, const ObString &database_name,
+                                     const ObString &real_table_name, const ObString &real_database_name,
+                                     bool is_single_shard_db_table,
+                                     common::ObSqlString &new_sql);
   static int testload_check_obparser_node_is_valid(const ParseNode *root, const ObItemType &type);
   static int testload_rewrite_name_base_on_parser_node(common::ObSqlString &new_sql,
                                    const char *new_name,
@@ -15,6 +15,7 @@
 #include "qos/ob_proxy_qos_action.h"
 #include "lib/utility/ob_print_utils.h"
 #include "qos/ob_proxy_qos_stat_processor.h"
+#include "lib/thread_local/ob_tsi_utils.h"
 
 namespace oceanbase
 {
@@ -40,119 +41,66 @@ int ObProxyQosActionBreaker::calc(bool &is_pass)
   return ret;
 }
 
-int ObProxyQosActionLimit::do_calc(bool &is_pass)
+void ObProxyQosActionLimit::set_limit_qps(int64_t limit_qps)
 {
-  int ret = OB_SUCCESS;
-  int debug_value = 0;
-
-  // 1. first, check whethere exceed next_free_token_micros
-  // 2. if exceeded, check over how much
-  //   2.1 if current time is between next_free_token_micros and next_free_token_micros + 1, consume the new token
-  //   2.2 if current time greater than next_free_token_micros + 1, consume the new token and save the other token
-  // 3. if not exceeded, consume one token
-  int64_t current_time_micros = hrtime_to_usec(get_hrtime_internal());
-  int64_t next_free_token_micros = next_free_token_micros_;
-  int64_t interval_per_request_micros = sec_to_usec(1) * LIMIT_ACTION_RATIO / limit_qps_;
-
-  int64_t max_token = limit_qps_ / LIMIT_ACTION_RATIO;
-  max_token = max_token < 1 ? 1 : max_token;
-
-  if (current_time_micros > next_free_token_micros) {
-    // case 2
-    if (current_time_micros < next_free_token_micros + interval_per_request_micros) {
-      // case 2.1
-      if (!ATOMIC_BCAS(&next_free_token_micros_, next_free_token_micros, next_free_token_micros + interval_per_request_micros)) {
-        // if update failed, maybe other update next_free_token_micros, re-call this func
-        ret = OB_EAGAIN;
-        debug_value = 1;
-      } else {
-        is_pass = true;
-        debug_value = 2;
-      }
-    } else {
-      // case 2.2
-      if (OB_SUCC(lock_.try_wrlock())) {
-        // record the token num before update time
-        int64_t first_last_token = token_;
-
-        int64_t next_free_token_micros = next_free_token_micros_;
-        if (current_time_micros >= next_free_token_micros + interval_per_request_micros) {
-          int64_t current_token_total = current_time_micros / interval_per_request_micros;
-          int64_t new_next_free_token_micros = (current_token_total + 1 ) * interval_per_request_micros;
-          if (!ATOMIC_BCAS(&next_free_token_micros_, next_free_token_micros, new_next_free_token_micros)) {
-            // if update failed, maybe case 2.1 is happening, re-call this func
-            ret = OB_EAGAIN;
-            debug_value = 3;
-          } else {
-            // because cross next_free_token_micros, so need add 1
-            int64_t add_token = current_token_total - next_free_token_micros / interval_per_request_micros + 1;
-
-            int64_t target_token = first_last_token + add_token;
-            target_token = target_token > max_token ? max_token : target_token;
-            // becaure consume one token, so sub 1
-            target_token -= 1;
-
-            int64_t new_token = 0;
-            int64_t last_token = 0;
-
-            do {
-              last_token = token_;
-              new_token = target_token - (first_last_token - last_token);
-
-              // just defence
-              if (OB_UNLIKELY(new_token < 0)) {
-                new_token = 0;
-              }
-            } while (!ATOMIC_BCAS(&token_, last_token, new_token));
-
-            is_pass = true;
-            debug_value = 4;
-            LOG_DEBUG("ObProxyQosActionLimit update token", K(new_token), K(first_last_token), K(last_token), K(ret));
-          }
-        } else {
-          debug_value = 5;
-          ret = OB_EAGAIN;
-        }
-
-        // release lock
-        lock_.wrunlock();
+  limit_qps_ = limit_qps * LIMIT_ACTION_RATIO;
+  if (limit_qps_ > 0) {
+    interval_ = HRTIME_SECOND * LIMIT_ACTION_RATIO / limit_qps_;
+    interval_ = interval_ < 1 ? 1 : interval_;
+
+    // the bucket holds the tokens of one second at most, at least one
+    int64_t max_token = limit_qps_ / LIMIT_ACTION_RATIO;
+    max_token = max_token < 1 ? 1 : max_token;
+    burst_time_ = max_token * interval_;
+
+    batch_count_ = LOCAL_TOKEN_TIME / interval_;
+    batch_count_ = batch_count_ < 1 ? 1 : batch_count_;
+  }
+}
+
+bool ObProxyQosActionLimit::take_local_token(ObLocalTokenSlot &slot, const ObHRTime now)
+{
+  bool bret = false;
+
+  if (now < ATOMIC_LOAD(&slot.expire_time_)) {
+    int64_t token = ATOMIC_LOAD(&slot.token_);
+    int64_t old_token = 0;
+    // the slot is shared only when thread ids collide, the cas hardly fails
+    while (!bret && token > 0) {
+      if (token == (old_token = ATOMIC_VCAS(&slot.token_, token, token - 1))) {
+        bret = true;
       } else {
-        debug_value = 6;
-        ret = OB_EAGAIN;
+        token = old_token;
       }
     }
-  } else {
-    // case 3
-    int64_t last_token = token_;
-    while (last_token > 0 && !ATOMIC_BCAS(&token_, last_token, last_token - 1)) {
-      PAUSE();
-      last_token = token_;
-    }
+  }
 
-    if (last_token <= 0) {
-      if (OB_SUCC(lock_.try_rdlock())) {
-        last_token = token_;
-        if (last_token > 0) {
-          debug_value = 7;
-          ret = OB_EAGAIN;
-        } else {
-          debug_value = 8;
-          is_pass = false;
-        }
-        lock_.rdunlock();
-      } else {
-        debug_value = 9;
-        ret = OB_EAGAIN;
-      }
+  return bret;
+}
+
+int64_t ObProxyQosActionLimit::take_bucket_token(const ObHRTime now, const int64_t count)
+{
+  int64_t token = 0;
+  bool is_done = false;
+  ObHRTime tat = ATOMIC_LOAD(&tat_);
+  ObHRTime old_tat = 0;
+
+  while (!is_done) {
+    const ObHRTime base = tat > now ? tat : now;
+    token = (now + burst_time_ - base) / interval_;
+    token = token > count ? count : token;
+    if (token <= 0) {
+      token = 0;
+      is_done = true;
+    } else if (tat == (old_tat = ATOMIC_VCAS(&tat_, tat, base + token * interval_))) {
+      is_done = true;
     } else {
-      debug_value = 10;
-      is_pass = true;
+      tat = old_tat;
+      PAUSE();
     }
   }
 
-  LOG_DEBUG("ObProxyQosActionLimit do calc end", K(debug_value), K(ret));
-
-  return ret;
+  return token;
 }
 
 int ObProxyQosActionLimit::calc(bool &is_pass)
@@ -163,8 +111,23 @@ int ObProxyQosActionLimit::calc(bool &is_pass)
   if (limit_qps_ <= 0) {
     is_pass = false;
   } else {
-    while (OB_EAGAIN == (ret = do_calc(is_pass))) {
-      PAUSE();
+    const ObHRTime now = get_hrtime_internal();
+    ObLocalTokenSlot &slot = slots_[get_itid() & (LOCAL_SLOT_COUNT - 1)];
+    if (!take_local_token(slot, now)) {
+      // tokens left after the lease go back to the bucket
+      const int64_t left_token = ATOMIC_TAS(&slot.token_, 0);
+      if (left_token > 0) {
+        (void)ATOMIC_FAA(&tat_, -left_token * interval_);
+      }
+
+      const int64_t token = take_bucket_token(now, batch_count_);
+      if (token <= 0) {
+        is_pass = false;
+      } else if (token > 1) {
+        ATOMIC_STORE(&slot.expire_time_, now + LOCAL_TOKEN_LEASE);
+        (void)ATOMIC_AAF(&slot.token_, token - 1);
+      }
+      LOG_DEBUG("ObProxyQosActionLimit take bucket token", K(left_token), K(token), K_(batch_count));
     }
   }
 
@@ -94,24 +94,54 @@ private:
   bool is_circuit_;
 };
 
+/*
+ * GCRA token bucket: tat_ is the time the bucket would be full again, a token
+ * moves it interval_ later and is refused when tat_ would go beyond now by more
+ * than a second of tokens. Each thread takes about LOCAL_TOKEN_TIME of tokens
+ * from the bucket in one CAS and spends them in its own slot, tokens not spent
+ * in LOCAL_TOKEN_LEASE go back to the bucket for other threads.
+ */
 class ObProxyQosActionLimit : public ObProxyQosAction
 {
 public:
   ObProxyQosActionLimit() : ObProxyQosAction(OB_PROXY_QOS_ACTION_TYPE_LIMIT),
-                            limit_qps_(-1), token_(0), next_free_token_micros_(0) {}
-  void set_limit_qps(int64_t limit_qps) { limit_qps_ = limit_qps * LIMIT_ACTION_RATIO; }
+                            limit_qps_(-1), interval_(0), burst_time_(0), batch_count_(1),
+                            tat_(0), slots_(NULL)
+  {
+    // slots_ starts at the first cache line in slot_buf_
+    slots_ = reinterpret_cast<ObLocalTokenSlot *>(
+        (reinterpret_cast<int64_t>(slot_buf_) + CACHE_ALIGN_SIZE - 1) & ~(CACHE_ALIGN_SIZE - 1));
+    MEMSET(slots_, 0, LOCAL_SLOT_COUNT * sizeof(ObLocalTokenSlot));
+  }
+  void set_limit_qps(int64_t limit_qps);
   int64_t get_limit_qps() const { return limit_qps_; }
 
   virtual int calc(bool &is_pass);
 
 private:
-  int do_calc(bool &is_pass);
+  static const int64_t LOCAL_SLOT_COUNT = 64;
+  static const ObHRTime LOCAL_TOKEN_TIME = HRTIME_MSECOND;
+  static const ObHRTime LOCAL_TOKEN_LEASE = 10 * HRTIME_MSECOND;
+
+  struct ObLocalTokenSlot
+  {
+    int64_t token_;
+    ObHRTime expire_time_;
+    char reserved_[CACHE_ALIGN_SIZE - sizeof(int64_t) - sizeof(ObHRTime)];
+  };
+
+  bool take_local_token(ObLocalTokenSlot &slot, const ObHRTime now);
+  int64_t take_bucket_token(const ObHRTime now, const int64_t count);
 
 private:
-  common::DRWLock lock_;
   int64_t limit_qps_; // limit threshold * 1000. so qps lower limit is 0.001/s
-  int64_t token_;
-  int64_t next_free_token_micros_;
+  ObHRTime interval_; // between two tokens
+  ObHRTime burst_time_;
+  int64_t batch_count_;
+  ObHRTime tat_;
+  char pad_[CACHE_ALIGN_SIZE];
+  char slot_buf_[(LOCAL_SLOT_COUNT + 1) * CACHE_ALIGN_SIZE];
+  ObLocalTokenSlot *slots_;
 };
 
 } // end qos
@@ -29,13 +29,14 @@ int64_t ObProxyQosCond::to_string(char *buf, int64_t buf_len) const
 {
   int64_t pos = 0;
   J_OBJ_START();
-  J_KV(K_(type));
+  J_KV(K_(type), K_(literal_id));
   J_OBJ_END();
   return pos;
 }
 
 int ObProxyQosCondNoWhere::calc(ObProxyMysqlRequest &client_request,
                                 ObIAllocator *allocator,
+                                ObProxyQosMatchContext &match_ctx,
                                 bool &is_match)
 {
   UNUSED(allocator);
@@ -44,14 +45,18 @@ int ObProxyQosCondNoWhere::calc(ObProxyMysqlRequest &client_request,
   ObString expr_sql = client_request.get_expr_sql();
 
   if (OB_LIKELY(!expr_sql.empty())) {
-    const char *expr_sql_str = expr_sql.ptr();
-    const char *pos = NULL;
-    if (NULL != (pos = strcasestr(expr_sql_str, "WHERE"))
-        && OB_LIKELY((pos - expr_sql_str) < expr_sql.length())) {
+    if (match_ctx.is_valid_literal(literal_id_)) {
       // this is NoWhere. so if have where, not match
-      is_match = false;
+      is_match = !match_ctx.has_literal(literal_id_);
     } else {
-      is_match = true;
+      const char *expr_sql_str = expr_sql.ptr();
+      const char *pos = NULL;
+      if (NULL != (pos = strcasestr(expr_sql_str, "WHERE"))
+          && OB_LIKELY((pos - expr_sql_str) < expr_sql.length())) {
+        is_match = false;
+      } else {
+        is_match = true;
+      }
     }
   } else {
     // if expr_sql is empry, no where. match
@@ -63,6 +68,7 @@ int ObProxyQosCondNoWhere::calc(ObProxyMysqlRequest &client_request,
 
 int ObProxyQosCondUseLike::calc(ObProxyMysqlRequest &client_request,
                                 ObIAllocator *allocator,
+                                ObProxyQosMatchContext &match_ctx,
                                 bool &is_match)
 {
   UNUSED(allocator);
@@ -71,13 +77,17 @@ int ObProxyQosCondUseLike::calc(ObProxyMysqlRequest &client_request,
   ObString expr_sql = client_request.get_expr_sql();
 
   if (OB_LIKELY(!expr_sql.empty())) {
-    const char *expr_sql_str = expr_sql.ptr();
-    const char *pos = NULL;
-    if (NULL != (pos = strcasestr(expr_sql_str, "LIKE"))
-        && OB_LIKELY((pos - expr_sql_str) < expr_sql.length())) {
-      is_match = true;
+    if (match_ctx.is_valid_literal(literal_id_)) {
+      is_match = match_ctx.has_literal(literal_id_);
     } else {
-      is_match = false;
+      const char *expr_sql_str = expr_sql.ptr();
+      const char *pos = NULL;
+      if (NULL != (pos = strcasestr(expr_sql_str, "LIKE"))
+          && OB_LIKELY((pos - expr_sql_str) < expr_sql.length())) {
+        is_match = true;
+      } else {
+        is_match = false;
+      }
     }
   } else {
     // if expr_sql is empry, no like. not match
@@ -89,9 +99,11 @@ int ObProxyQosCondUseLike::calc(ObProxyMysqlRequest &client_request,
 
 int ObProxyQosCondStmtType::calc(ObProxyMysqlRequest &client_request,
                                  ObIAllocator *allocator,
+                                 ObProxyQosMatchContext &match_ctx,
                                  bool &is_match)
 {
   UNUSED(allocator);
+  UNUSED(match_ctx);
   int ret = OB_SUCCESS;
 
   ObSqlParseResult &parse_result = client_request.get_parse_result();
@@ -132,8 +144,10 @@ int ObProxyQosCondTableName::init(const common::ObString &table_name_re, common:
 
 int ObProxyQosCondTableName::calc(ObProxyMysqlRequest &client_request,
                                   ObIAllocator *allocator,
+                                  ObProxyQosMatchContext &match_ctx,
                                   bool &is_match)
 {
+  UNUSED(match_ctx);
   int ret = OB_SUCCESS;
 
   // param empty means match all table
@@ -164,6 +178,8 @@ int ObProxyQosCondSQLMatch::init(const common::ObString &sql_re, common::ObIAllo
   } else {
     if (OB_FAIL(sql_re_.init(sql_re, OB_REG_ICASE, *allocator))) {
       LOG_WARN("fail to init sql re", K(sql_re), K(ret));
+    } else if (OB_FAIL(ObProxyQosLiteralMatcher::extract_regex_literal(sql_re, *allocator, sql_literal_))) {
+      LOG_WARN("fail to extract literal of sql re", K(sql_re), K(ret));
     }
   }
 
@@ -172,6 +188,7 @@ int ObProxyQosCondSQLMatch::init(const common::ObString &sql_re, common::ObIAllo
 
 int ObProxyQosCondSQLMatch::calc(ObProxyMysqlRequest &client_request,
                                  ObIAllocator *allocator,
+                                 ObProxyQosMatchContext &match_ctx,
                                  bool &is_match)
 {
   int ret = OB_SUCCESS;
@@ -183,7 +200,10 @@ int ObProxyQosCondSQLMatch::calc(ObProxyMysqlRequest &client_request,
     is_match = true;
   } else  {
     if (OB_LIKELY(!expr_sql.empty())) {
-      if (OB_FAIL(sql_re_.match(expr_sql, 0, is_match, *allocator))) {
+      if (match_ctx.is_valid_literal(literal_id_) && !match_ctx.has_literal(literal_id_)) {
+        // the regex can not match without the literal, skip it
+        is_match = false;
+      } else if (OB_FAIL(sql_re_.match(expr_sql, 0, is_match, *allocator))) {
         LOG_WARN("fail to match sql", K(expr_sql), K(ret));
       }
     } else {
@@ -196,9 +216,11 @@ int ObProxyQosCondSQLMatch::calc(ObProxyMysqlRequest &client_request,
 
 int ObProxyQosCondTestLoadTableName::calc(ObProxyMysqlRequest &client_request,
                                           ObIAllocator *allocator,
+                                          ObProxyQosMatchContext &match_ctx,
                                           bool &is_match)
 {
   UNUSED(allocator);
+  UNUSED(match_ctx);
   int ret = OB_SUCCESS;
 
   is_match = false;
@@ -15,6 +15,7 @@
 
 #include "proxy/mysqllib/ob_proxy_mysql_request.h"
 #include "common/expression/ob_expr_regexp_context.h"
+#include "qos/ob_proxy_qos_literal_matcher.h"
 
 namespace oceanbase
 {
@@ -36,30 +37,44 @@ typedef enum ObProxyQosCondType
 class ObProxyQosCond
 {
 public:
-  explicit ObProxyQosCond() : type_(OB_PROXY_QOS_COND_TYPE_NONE) {}
+  explicit ObProxyQosCond() : type_(OB_PROXY_QOS_COND_TYPE_NONE), literal_id_(-1) {}
   ~ObProxyQosCond() {}
 
   void set_cond_type(const ObProxyQosCondType type) { type_ = type; }
   ObProxyQosCondType get_cond_type() const { return type_; }
 
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match) = 0;
+  // the literal looked for in the sql by the literal matcher, empty if none
+  virtual common::ObString get_scan_literal() const { return common::ObString(); }
+  void set_literal_id(const int64_t literal_id) { literal_id_ = literal_id; }
+  int64_t get_literal_id() const { return literal_id_; }
+
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match) = 0;
 
   int64_t to_string(char *buf, int64_t buf_len) const;
 
 private:
   ObProxyQosCondType type_;
+
+protected:
+  int64_t literal_id_;
 };
 
 class ObProxyQosCondNoWhere : public ObProxyQosCond
 {
 public:
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  ObProxyQosCondNoWhere() { set_cond_type(OB_PROXY_QOS_COND_TYPE_NOWHERE); }
+  virtual common::ObString get_scan_literal() const { return common::ObString::make_string("where"); }
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 };
 
 class ObProxyQosCondUseLike : public ObProxyQosCond
 {
 public:
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  virtual common::ObString get_scan_literal() const { return common::ObString::make_string("like"); }
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 };
 
 typedef enum ObProxyQosCondStmtKind
@@ -74,13 +89,17 @@ class ObProxyQosCondStmtType : public ObProxyQosCond
 {
 public:
   ObProxyQosCondStmtType() :
-    stmt_type_(OBPROXY_T_INVALID), stmt_kind_(OB_PROXY_QOS_COND_STMT_KIND_INVALID) {}
+    stmt_type_(OBPROXY_T_INVALID), stmt_kind_(OB_PROXY_QOS_COND_STMT_KIND_INVALID)
+  {
+    set_cond_type(OB_PROXY_QOS_COND_TYPE_STMT_TYPE);
+  }
   void set_stmt_type(const ObProxyBasicStmtType stmt_type) { stmt_type_ = stmt_type; }
   ObProxyBasicStmtType get_stmt_type() const { return stmt_type_; }
 
   void set_stmt_kind(const ObProxyQosCondStmtKind stmt_kind) { stmt_kind_ = stmt_kind; }
 
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 
 private:
   ObProxyBasicStmtType stmt_type_;
@@ -90,9 +109,10 @@ private:
 class ObProxyQosCondTableName : public ObProxyQosCond
 {
 public:
-  ObProxyQosCondTableName() : is_param_empty_(false) {}
+  ObProxyQosCondTableName() : is_param_empty_(false) { set_cond_type(OB_PROXY_QOS_COND_TYPE_TABLE_NAME); }
   int init(const common::ObString &table_name_re, common::ObIAllocator *allocator);
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 
 private:
   common::ObExprRegexContext table_name_re_;
@@ -102,12 +122,16 @@ private:
 class ObProxyQosCondSQLMatch : public ObProxyQosCond
 {
 public:
-  ObProxyQosCondSQLMatch() : is_param_empty_(false) {}
+  ObProxyQosCondSQLMatch() : is_param_empty_(false) { set_cond_type(OB_PROXY_QOS_COND_TYPE_SQL_MATCH); }
   int init(const common::ObString &sql_re, common::ObIAllocator *allocator);
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  // the sql can not match if the literal required by the regex is not in it
+  virtual common::ObString get_scan_literal() const { return sql_literal_; }
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 
 private:
   common::ObExprRegexContext sql_re_;
+  common::ObString sql_literal_;
   bool is_param_empty_;
 };
 
@@ -115,7 +139,8 @@ class ObProxyQosCondTestLoadTableName : public ObProxyQosCond
 {
 public:
   ObProxyQosCondTestLoadTableName() {}
-  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator, bool &is_match);
+  virtual int calc(proxy::ObProxyMysqlRequest &client_request, common::ObIAllocator *allocator,
+                   ObProxyQosMatchContext &match_ctx, bool &is_match);
 };
 
 } // end qos
@@ -0,0 +1,377 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include "qos/ob_proxy_qos_literal_matcher.h"
+#include "lib/utility/ob_print_utils.h"
+#include <ctype.h>
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace qos
+{
+using namespace common;
+
+// the escapes which stand for one char of a class or for no char at all
+static const char *REGEX_NOARG_ESCAPES = "dDsSwWmMyYAZntrfvae";
+
+static bool skip_regex_bracket(const char *re, const int64_t len, int64_t &pos)
+{
+  bool bret = false;
+  int64_t i = pos + 1;
+  if (i < len && '^' == re[i]) {
+    ++i;
+  }
+  if (i < len && ']' == re[i]) {
+    ++i;
+  }
+  while (!bret && i < len) {
+    if ('\\' == re[i]) {
+      i += 2;
+    } else if ('[' == re[i] && i + 1 < len && (':' == re[i + 1] || '.' == re[i + 1] || '=' == re[i + 1])) {
+      // [:alpha:], [.x.] and [=x=]
+      const char end_char = re[i + 1];
+      i += 2;
+      while (i + 1 < len && !(end_char == re[i] && ']' == re[i + 1])) {
+        ++i;
+      }
+      i += 2;
+    } else if (']' == re[i]) {
+      pos = i + 1;
+      bret = true;
+    } else {
+      ++i;
+    }
+  }
+  return bret;
+}
+
+static bool skip_regex_group(const char *re, const int64_t len, int64_t &pos)
+{
+  bool bret = true;
+  int64_t depth = 0;
+  int64_t i = pos;
+  do {
+    if ('\\' == re[i]) {
+      i += 2;
+    } else if ('[' == re[i]) {
+      bret = skip_regex_bracket(re, len, i);
+    } else {
+      if ('(' == re[i]) {
+        ++depth;
+      } else if (')' == re[i]) {
+        --depth;
+      }
+      ++i;
+    }
+  } while (bret && depth > 0 && i < len);
+
+  if (bret && 0 == depth) {
+    pos = i;
+  } else {
+    bret = false;
+  }
+  return bret;
+}
+
+int ObProxyQosLiteralMatcher::extract_regex_literal(const ObString &regex, ObIAllocator &allocator,
+                                                    ObString &literal)
+{
+  int ret = OB_SUCCESS;
+  const char *re = regex.ptr();
+  const int64_t len = regex.length();
+  char *buf = NULL;
+  literal.reset();
+
+  if (len <= 0) {
+    // do nothing
+  } else if (OB_ISNULL(buf = static_cast<char *>(allocator.alloc(len * 2)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc literal buf", K(len), K(ret));
+  } else {
+    // embedded options and the director prefixes change how the rest is read
+    bool is_understood = !(len >= 2 && '(' == re[0] && '?' == re[1])
+                         && !(len >= 3 && 0 == MEMCMP(re, "***", 3));
+    char *run = buf;
+    char *best = buf + len;
+    int64_t run_len = 0;
+    int64_t best_len = 0;
+    int64_t i = 0;
+
+    while (is_understood && i < len) {
+      const char c = re[i];
+      bool is_break = true;
+      switch (c) {
+        case '|':
+          // any branch may match, no run is required
+          is_understood = false;
+          break;
+        case '*':
+        case '?':
+          // the atom before may be absent
+          run_len = run_len > 0 ? run_len - 1 : 0;
+          ++i;
+          break;
+        case '{':
+          run_len = run_len > 0 ? run_len - 1 : 0;
+          while (i < len && '}' != re[i]) {
+            ++i;
+          }
+          is_understood = (i < len);
+          ++i;
+          break;
+        case '(':
+          is_understood = skip_regex_group(re, len, i);
+          break;
+        case '[':
+          is_understood = skip_regex_bracket(re, len, i);
+          break;
+        case ')':
+          is_understood = false;
+          break;
+        case '\\':
+          if (i + 1 >= len) {
+            is_understood = false;
+          } else if (isalnum(static_cast<uint8_t>(re[i + 1]))) {
+            is_understood = (NULL != strchr(REGEX_NOARG_ESCAPES, re[i + 1]));
+            i += 2;
+          } else if (static_cast<uint8_t>(re[i + 1]) >= 0x80) {
+            i += 2;
+          } else {
+            run[run_len++] = re[i + 1];
+            is_break = false;
+            i += 2;
+          }
+          break;
+        case '.':
+        case '^':
+        case '$':
+        case '+':
+          ++i;
+          break;
+        default:
+          if (static_cast<uint8_t>(c) < 0x80) {
+            run[run_len++] = static_cast<char>(tolower(c));
+            is_break = false;
+          }
+          ++i;
+          break;
+      }
+
+      if (is_break || i >= len) {
+        if (run_len > best_len) {
+          MEMCPY(best, run, run_len);
+          best_len = run_len;
+        }
+        run_len = 0;
+      }
+    }
+
+    if (is_understood && best_len > 0) {
+      literal.assign_ptr(best, static_cast<int32_t>(best_len));
+    }
+  }
+
+  return ret;
+}
+
+int ObProxyQosLiteralMatcher::init(ObIAllocator &allocator)
+{
+  int ret = OB_SUCCESS;
+
+  if (OB_UNLIKELY(NULL != allocator_)) {
+    ret = OB_INIT_TWICE;
+    LOG_WARN("literal matcher init twice", K(ret));
+  } else {
+    allocator_ = &allocator;
+  }
+
+  return ret;
+}
+
+int ObProxyQosLiteralMatcher::add_literal(const ObString &literal, int64_t &literal_id)
+{
+  int ret = OB_SUCCESS;
+  char *buf = NULL;
+  literal_id = -1;
+
+  if (OB_ISNULL(allocator_)) {
+    ret = OB_NOT_INIT;
+    LOG_WARN("literal matcher not init", K(ret));
+  } else if (OB_UNLIKELY(is_built_)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("literal matcher is built", K(literal), K(ret));
+  } else if (OB_UNLIKELY(literal.empty())) {
+    ret = OB_INVALID_ARGUMENT;
+    LOG_WARN("invalid literal", K(literal), K(ret));
+  } else if (OB_ISNULL(buf = static_cast<char *>(allocator_->alloc(literal.length())))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    LOG_WARN("fail to alloc literal", K(literal), K(ret));
+  } else {
+    for (int32_t i = 0; OB_SUCC(ret) && i < literal.length(); ++i) {
+      if (OB_UNLIKELY(static_cast<uint8_t>(literal[i]) >= 0x80)) {
+        ret = OB_INVALID_ARGUMENT;
+        LOG_WARN("literal should be ascii", K(literal), K(ret));
+      } else {
+        buf[i] = static_cast<char>(tolower(literal[i]));
+      }
+    }
+
+    ObString lower_literal(literal.length(), buf);
+    for (int64_t i = 0; OB_SUCC(ret) && literal_id < 0 && i < literals_.count(); ++i) {
+      if (lower_literal == literals_.at(i)) {
+        literal_id = i;
+      }
+    }
+
+    if (OB_SUCC(ret) && literal_id < 0) {
+      if (literals_.count() >= MAX_LITERAL_COUNT) {
+        ret = OB_SIZE_OVERFLOW;
+        LOG_WARN("too many literals", K(literal), K(ret));
+      } else if (OB_FAIL(literals_.push_back(lower_literal))) {
+        LOG_WARN("fail to push back literal", K(literal), K(ret));
+      } else {
+        literal_id = literals_.count() - 1;
+      }
+    }
+  }
+
+  return ret;
+}
+
+int ObProxyQosLiteralMatcher::build()
+{
+  int ret = OB_SUCCESS;
+  int32_t *fail = NULL;
+  int32_t *queue = NULL;
+
+  if (OB_ISNULL(allocator_)) {
+    ret = OB_NOT_INIT;
+    LOG_WARN("literal matcher not init", K(ret));
+  } else if (OB_UNLIKELY(is_built_)) {
+    ret = OB_ERR_UNEXPECTED;
+    LOG_WARN("literal matcher is built", K(ret));
+  } else if (literals_.empty()) {
+    // nothing to match, conds fall back to their own way
+  } else {
+    MEMSET(class_map_, 0, sizeof(class_map_));
+    class_count_ = 1;
+    int64_t max_state_count = 1;
+    for (int64_t i = 0; i < literals_.count(); ++i) {
+      const ObString &literal = literals_.at(i);
+      for (int32_t j = 0; j < literal.length(); ++j) {
+        const uint8_t c = static_cast<uint8_t>(literal[j]);
+        if (0 == class_map_[c]) {
+          class_map_[c] = static_cast<uint8_t>(class_count_);
+          class_map_[toupper(c)] = static_cast<uint8_t>(class_count_);
+          ++class_count_;
+        }
+      }
+      max_state_count += literal.length();
+    }
+
+    const int64_t table_size = max_state_count * class_count_;
+    if (OB_ISNULL(next_ = static_cast<int32_t *>(allocator_->alloc(table_size * sizeof(int32_t))))
+        || OB_ISNULL(out_ = static_cast<int32_t *>(allocator_->alloc(max_state_count * sizeof(int32_t))))
+        || OB_ISNULL(out_link_ = static_cast<int32_t *>(allocator_->alloc(max_state_count * sizeof(int32_t))))
+        || OB_ISNULL(fail = static_cast<int32_t *>(allocator_->alloc(max_state_count * sizeof(int32_t))))
+        || OB_ISNULL(queue = static_cast<int32_t *>(allocator_->alloc(max_state_count * sizeof(int32_t))))) {
+      ret = OB_ALLOCATE_MEMORY_FAILED;
+      LOG_WARN("fail to alloc literal matcher table", K(max_state_count), K_(class_count), K(ret));
+    } else {
+      MEMSET(next_, -1, table_size * sizeof(int32_t));
+      MEMSET(out_, -1, max_state_count * sizeof(int32_t));
+      MEMSET(out_link_, 0, max_state_count * sizeof(int32_t));
+
+      // trie of the literals
+      state_count_ = 1;
+      for (int64_t i = 0; i < literals_.count(); ++i) {
+        const ObString &literal = literals_.at(i);
+        int32_t state = 0;
+        for (int32_t j = 0; j < literal.length(); ++j) {
+          int32_t &child = next_[state * class_count_ + class_map_[static_cast<uint8_t>(literal[j])]];
+          if (child < 0) {
+            child = static_cast<int32_t>(state_count_++);
+          }
+          state = child;
+        }
+        out_[state] = static_cast<int32_t>(i);
+      }
+
+      // fill the fail transitions breadth first, the row of the fail state
+      // is always complete as it is shallower
+      int64_t head = 0;
+      int64_t tail = 0;
+      fail[0] = 0;
+      queue[tail++] = 0;
+      while (head < tail) {
+        const int32_t state = queue[head++];
+        for (int64_t c = 0; c < class_count_; ++c) {
+          int32_t &child = next_[state * class_count_ + c];
+          const int32_t fail_next = (0 == state) ? 0 : next_[fail[state] * class_count_ + c];
+          if (child > 0) {
+            fail[child] = fail_next;
+            out_link_[child] = (out_[fail_next] >= 0) ? fail_next : out_link_[fail_next];
+            queue[tail++] = child;
+          } else {
+            child = fail_next;
+          }
+        }
+      }
+      is_built_ = true;
+    }
+
+    if (NULL != fail) {
+      allocator_->free(fail);
+    }
+    if (NULL != queue) {
+      allocator_->free(queue);
+    }
+  }
+
+  return ret;
+}
+
+void ObProxyQosLiteralMatcher::match(const ObString &text, uint64_t *hits) const
+{
+  if (is_built_) {
+    const char *pos = text.ptr();
+    const char *end = pos + text.length();
+    int32_t state = 0;
+    for (; pos < end; ++pos) {
+      state = goto_state(state, *pos);
+      if (OB_UNLIKELY(out_[state] >= 0 || out_link_[state] > 0)) {
+        for (int32_t s = state; s > 0; s = out_link_[s]) {
+          if (out_[s] >= 0) {
+            hits[out_[s] / 64] |= (1ULL << (out_[s] % 64));
+          }
+        }
+      }
+    }
+  }
+}
+
+int64_t ObProxyQosLiteralMatcher::to_string(char *buf, const int64_t buf_len) const
+{
+  int64_t pos = 0;
+  J_OBJ_START();
+  J_KV(K_(is_built), K_(class_count), K_(state_count), "literal_count", literals_.count());
+  J_OBJ_END();
+  return pos;
+}
+
+} // end qos
+} // end obproxy
+} // end oceanbase
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#ifndef OB_PROXY_QOS_LITERAL_MATCHER_H
+#define OB_PROXY_QOS_LITERAL_MATCHER_H
+
+#include "lib/string/ob_string.h"
+#include "lib/allocator/ob_allocator.h"
+#include "lib/container/ob_se_array.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+namespace qos
+{
+
+/*
+ * Case insensitive Aho-Corasick automaton over the ascii literals of all qos
+ * conds of a limit control config, one scan of the sql tells which literals
+ * appear in it. The goto function is a dense table indexed by byte class, the
+ * bytes not in any literal share class 0.
+ */
+class ObProxyQosLiteralMatcher
+{
+public:
+  static const int64_t MAX_LITERAL_COUNT = 1024;
+  static const int64_t HIT_WORD_COUNT = MAX_LITERAL_COUNT / 64;
+
+  ObProxyQosLiteralMatcher()
+    : is_built_(false), class_count_(0), state_count_(0),
+      next_(NULL), out_(NULL), out_link_(NULL), allocator_(NULL) {}
+  ~ObProxyQosLiteralMatcher() {}
+
+  int init(common::ObIAllocator &allocator);
+  // the same literal gets the same id, can not add after build
+  int add_literal(const common::ObString &literal, int64_t &literal_id);
+  int build();
+  // set bit literal_id in hits for each literal found in text
+  void match(const common::ObString &text, uint64_t *hits) const;
+
+  bool is_built() const { return is_built_; }
+  int64_t get_literal_count() const { return literals_.count(); }
+  int64_t get_state_count() const { return state_count_; }
+
+  // the longest run of ascii chars which every match of the regex contains,
+  // empty if there is no such run or the regex is beyond what is understood
+  static int extract_regex_literal(const common::ObString &regex, common::ObIAllocator &allocator,
+                                   common::ObString &literal);
+
+  int64_t to_string(char *buf, const int64_t buf_len) const;
+
+private:
+  int32_t goto_state(const int32_t state, const char c) const
+  {
+    return next_[state * class_count_ + class_map_[static_cast<uint8_t>(c)]];
+  }
+
+private:
+  bool is_built_;
+  int64_t class_count_;
+  int64_t state_count_;
+  uint8_t class_map_[256];
+  // next_[state * class_count_ + class], complete after build
+  int32_t *next_;
+  // the literal ends at the state, -1 if none
+  int32_t *out_;
+  // the nearest state on the fail chain with out_, 0 if none
+  int32_t *out_link_;
+  common::ObSEArray<common::ObString, 8> literals_;
+  common::ObIAllocator *allocator_;
+
+  DISALLOW_COPY_AND_ASSIGN(ObProxyQosLiteralMatcher);
+};
+
+// scans the sql on the first ask, the conds of all limit configs share the result
+class ObProxyQosMatchContext
+{
+public:
+  ObProxyQosMatchContext(const ObProxyQosLiteralMatcher &matcher, const common::ObString &text)
+    : matcher_(matcher), text_(text), is_scanned_(false) {}
+  ~ObProxyQosMatchContext() {}
+
+  bool is_valid_literal(const int64_t literal_id) const
+  {
+    return matcher_.is_built() && literal_id >= 0 && literal_id < matcher_.get_literal_count();
+  }
+
+  bool has_literal(const int64_t literal_id)
+  {
+    if (!is_scanned_) {
+      MEMSET(hits_, 0, sizeof(hits_));
+      matcher_.match(text_, hits_);
+      is_scanned_ = true;
+    }
+    return 0 != (hits_[literal_id / 64] & (1ULL << (literal_id % 64)));
+  }
+
+private:
+  const ObProxyQosLiteralMatcher &matcher_;
+  common::ObString text_;
+  bool is_scanned_;
+  uint64_t hits_[ObProxyQosLiteralMatcher::HIT_WORD_COUNT];
+
+  DISALLOW_COPY_AND_ASSIGN(ObProxyQosMatchContext);
+};
+
+} // end qos
+} // end obproxy
+} // end oceanbase
+
+#endif
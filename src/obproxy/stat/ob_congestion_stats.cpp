@@ -35,6 +35,9 @@ int register_congest_stats()
   } else if (OB_FAIL(g_stat_processor.register_raw_stat(congest_rsb, RECT_PROCESS, "alive_congested",
                      RECD_INT, alive_congested_stat, SYNC_SUM, RECP_NULL))) {
     PROXY_LOG(WARN, "fail to register alive_congested", K(ret));
+  } else if (OB_FAIL(g_stat_processor.register_raw_stat(congest_rsb, RECT_PROCESS, "concurrency_limited",
+                     RECD_INT, concurrency_limited_stat, SYNC_SUM, RECP_NULL))) {
+    PROXY_LOG(WARN, "fail to register concurrency_limited", K(ret));
   }
 
   return ret;
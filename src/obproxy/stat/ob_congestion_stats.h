@@ -33,6 +33,7 @@ extern ObRecRawStatBlock *congest_rsb;
 enum {
   dead_congested_stat,
   alive_congested_stat,
+  concurrency_limited_stat,
   congest_stat_count,
 };
 
@@ -291,6 +291,22 @@ int init_mysql_stats()
     MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "server_response_total_size",
                             RECD_INT, SERVER_RESPONSE_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
 
+    // transform copy stats
+    MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "transform_shared_total_size",
+                            RECD_INT, TRANSFORM_SHARED_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
+
+    MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "compress_request_copied_total_size",
+                            RECD_INT, COMPRESS_REQUEST_COPIED_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
+
+    MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "compress_request_shared_total_size",
+                            RECD_INT, COMPRESS_REQUEST_SHARED_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
+
+    MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "decompress_response_copied_total_size",
+                            RECD_INT, DECOMPRESS_RESPONSE_COPIED_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
+
+    MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "decompress_response_shared_total_size",
+                            RECD_INT, DECOMPRESS_RESPONSE_SHARED_TOTAL_SIZE, SYNC_SUM, RECP_NULL);
+
     // times
     MYSQL_REGISTER_RAW_STAT(mysql_rsb, RECT_PROCESS, "total_transactions_time",
                             RECD_INT, TOTAL_TRANSACTIONS_TIME, SYNC_SUM, RECP_PERSISTENT);
@@ -43,6 +43,13 @@ enum ObMysqlStats
   SERVER_REQUEST_TOTAL_SIZE,
   SERVER_RESPONSE_TOTAL_SIZE,
 
+  // copy stats of transforms, bytes copied or shared by cloned blocks
+  TRANSFORM_SHARED_TOTAL_SIZE,
+  COMPRESS_REQUEST_COPIED_TOTAL_SIZE,
+  COMPRESS_REQUEST_SHARED_TOTAL_SIZE,
+  DECOMPRESS_RESPONSE_COPIED_TOTAL_SIZE,
+  DECOMPRESS_RESPONSE_SHARED_TOTAL_SIZE,
+
   // time stats
   TOTAL_TRANSACTIONS_TIME,
   TOTAL_USER_TRANSACTIONS_TIME,
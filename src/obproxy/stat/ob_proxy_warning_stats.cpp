@@ -113,6 +113,9 @@ int init_warning_stats()
 
     PROXY_REGISTER_RAW_STAT(warning_rsb, RECT_PROCESS, "async_flush_log_speed",
                                          RECD_INT, ASYNC_FLUSH_LOG_SPEED, SYNC_SUM, RECP_NULL);
+
+    PROXY_REGISTER_RAW_STAT(warning_rsb, RECT_PROCESS, "dropped_sqlaudit_record_count",
+                                         RECD_INT, DROPPED_SQLAUDIT_RECORD_COUNT, SYNC_SUM, RECP_NULL);
   }
   return ret;
 }
@@ -55,6 +55,8 @@ enum ObWarningStats
   DROPPED_DEBUG_LOG_COUNT,
 
   ASYNC_FLUSH_LOG_SPEED,
+
+  DROPPED_SQLAUDIT_RECORD_COUNT,
   MAX_WARNING_STATS_COUNT
 };
 
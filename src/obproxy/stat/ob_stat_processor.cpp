@@ -22,6 +22,7 @@
 #include "utils/ob_proxy_utils.h"
 #include "proxy/client/ob_mysql_proxy.h"
 #include "stat/ob_proxy_warning_stats.h"
+#include "cmd/ob_show_sqlaudit_handler.h"
 
 using namespace oceanbase::common;
 using namespace oceanbase::share;
@@ -167,7 +168,7 @@ int ObSessionStatTableSync::sync(int event, ObEvent *e)
 ObStatProcessor::ObStatProcessor()
     : is_inited_(false), is_first_register_(true), mysql_proxy_(NULL),
       stat_table_cont_(NULL), stat_dump_cont_(NULL),
-      record_count_(0), proxy_port_(0)
+      record_count_(0), sync_epoch_(0), proxy_port_(0)
 {
   MEMSET(proxy_ip_, 0, sizeof(proxy_ip_));
 }
@@ -320,9 +321,12 @@ ObRecRawStatBlock *ObStatProcessor::allocate_raw_stat_block(const int64_t num_st
         rsb->xflush_log_head_ = xflush_log_head;
         rsb->global_ = reinterpret_cast<ObRecRawStat **>(allocator_.alloc_aligned(num_stats * sizeof(ObRecRawStat *)));
         rsb->global_record_ = reinterpret_cast<ObRecRecord **>(allocator_.alloc_aligned(num_stats * sizeof(ObRecRecord *)));
-        if (NULL != rsb->global_ && NULL != rsb->global_record_) {
+        rsb->snapshot_ = reinterpret_cast<ObRecRawStat *>(allocator_.alloc_aligned(num_stats * sizeof(ObRecRawStat)));
+        rsb->snapshot_epoch_ = -1;
+        if (NULL != rsb->global_ && NULL != rsb->global_record_ && NULL != rsb->snapshot_) {
           memset(rsb->global_, 0, num_stats * sizeof(ObRecRawStat *));
           memset(rsb->global_record_, 0, num_stats * sizeof(ObRecRecord *));
+          memset(rsb->snapshot_, 0, num_stats * sizeof(ObRecRawStat));
           all_blocks_.push(rsb);
         } else {
           rsb = NULL;
@@ -471,6 +475,14 @@ int ObStatProcessor::exec_raw_stat_sync_cbs()
   PROXY_SET_GLOBAL_DYN_STAT(DROPPED_DEBUG_LOG_COUNT, ObLogger::get_logger().get_dropped_debug_log_count());
   PROXY_SET_GLOBAL_DYN_STAT(ASYNC_FLUSH_LOG_SPEED, ObLogger::get_logger().get_async_flush_log_speed());
 
+  ObSqlauditRecordQueue *sqlaudit_queue = get_global_sqlaudit_processor().acquire();
+  if (NULL != sqlaudit_queue) {
+    PROXY_SET_GLOBAL_DYN_STAT(DROPPED_SQLAUDIT_RECORD_COUNT, sqlaudit_queue->get_drop_count());
+    (void)get_global_sqlaudit_processor().release(sqlaudit_queue);
+  }
+
+  // thread stats are summed at most once per block in this round
+  (void)ATOMIC_FAA(&sync_epoch_, 1);
   ObRecRecord *r = all_records_.head();
   while (OB_SUCC(ret) && NULL != r) {
     if (OB_FAIL(mutex_acquire(&r->mutex_))) {
@@ -777,10 +789,27 @@ bool ObStatProcessor::set_rec_data_from_float(
   return bret;
 }
 
+void ObStatProcessor::get_thread_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id, ObRecRawStat &total)
+{
+  ObRecRawStat *tlp = NULL;
+  total.sum_ = 0;
+  total.count_ = 0;
+  for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
+    tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
+    total.sum_ += tlp->sum_;
+    total.count_ += tlp->count_;
+  }
+
+  for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
+    tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
+    total.sum_ += tlp->sum_;
+    total.count_ += tlp->count_;
+  }
+}
+
 int ObStatProcessor::get_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id, ObRecRawStat &total)
 {
   int ret = OB_SUCCESS;
-  ObRecRawStat *tlp = NULL;
   total.sum_ = 0;
   total.count_ = 0;
 
@@ -788,22 +817,12 @@ int ObStatProcessor::get_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id
     ret = OB_INVALID_ARGUMENT;
     LOG_WARN("invalid rsb or id", K(rsb), K(id), K(ret));
   } else {
-    // get global values
-    total.sum_ = rsb->global_[id]->sum_;
-    total.count_ = rsb->global_[id]->count_;
-
-    // get thread local values
-    for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
-      tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
-      total.sum_ += tlp->sum_;
-      total.count_ += tlp->count_;
-    }
-
-    for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
-      tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
-      total.sum_ += tlp->sum_;
-      total.count_ += tlp->count_;
-    }
+    // global values already include the thread values of the last sync,
+    // so only add what threads have done since then
+    ObRecRawStat thread_total;
+    get_thread_raw_stat_total(rsb, id, thread_total);
+    total.sum_ = rsb->global_[id]->sum_ + thread_total.sum_ - rsb->global_[id]->last_sum_;
+    total.count_ = rsb->global_[id]->count_ + thread_total.count_ - rsb->global_[id]->last_count_;
 
     if (total.sum_ < 0) { // Assure that we stay positive
       total.sum_ = 0;
@@ -813,10 +832,37 @@ int ObStatProcessor::get_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id
   return ret;
 }
 
+// sum every stat of the block thread by thread, each thread block is read
+// sequentially instead of walking all threads once per stat
+void ObStatProcessor::aggregate_raw_stat_block(ObRecRawStatBlock *rsb)
+{
+  ObRecRawStat *snapshot = rsb->snapshot_;
+  ObRecRawStat *tlp = NULL;
+  for (int64_t id = 0; id < rsb->max_stats_; ++id) {
+    snapshot[id].sum_ = 0;
+    snapshot[id].count_ = 0;
+  }
+
+  for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
+    tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_);
+    for (int64_t id = 0; id < rsb->max_stats_; ++id) {
+      snapshot[id].sum_ += tlp[id].sum_;
+      snapshot[id].count_ += tlp[id].count_;
+    }
+  }
+
+  for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
+    tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_);
+    for (int64_t id = 0; id < rsb->max_stats_; ++id) {
+      snapshot[id].sum_ += tlp[id].sum_;
+      snapshot[id].count_ += tlp[id].count_;
+    }
+  }
+}
+
 int ObStatProcessor::sync_raw_stat_to_global(ObRecRawStatBlock *rsb, const int64_t id)
 {
   int ret = OB_SUCCESS;
-  ObRecRawStat *tlp = NULL;
   ObRecRawStat total;
   total.sum_ = 0;
   total.count_ = 0;
@@ -824,49 +870,45 @@ int ObStatProcessor::sync_raw_stat_to_global(ObRecRawStatBlock *rsb, const int64
   if (OB_UNLIKELY(!check_argument(rsb, id))) {
     ret = OB_INVALID_ARGUMENT;
     LOG_WARN("invalid rsb or id", K(rsb), K(id), K(ret));
-  } else {
-    // sum_ the thread local values
-    for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
-      tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
-      total.sum_ += tlp->sum_;
-      total.count_ += tlp->count_;
-    }
 
-    for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
-      tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
-      total.sum_ += tlp->sum_;
-      total.count_ += tlp->count_;
+    // lock so the setting of the globals and last values are atomic
+  } else if (OB_FAIL(mutex_acquire(&(rsb->mutex_)))) {
+    LOG_ERROR("fail to acquire mutex", K(ret));
+  } else {
+    const int64_t sync_epoch = ATOMIC_LOAD(&g_stat_processor.sync_epoch_);
+    if (rsb->snapshot_epoch_ != sync_epoch) {
+      aggregate_raw_stat_block(rsb);
+      rsb->snapshot_epoch_ = sync_epoch;
     }
+    total.sum_ = rsb->snapshot_[id].sum_;
+    total.count_ = rsb->snapshot_[id].count_;
 
     if (total.sum_ < 0) { // Assure that we stay positive
       total.sum_ = 0;
     }
 
-    // lock so the setting of the globals and last values are atomic
-    if (OB_FAIL(mutex_acquire(&(rsb->mutex_)))) {
-      LOG_ERROR("fail to acquire mutex", K(ret));
-    } else {
-      // get the delta from the last sync
-      ObRecRawStat delta;
-      delta.sum_ = total.sum_ - rsb->global_[id]->last_sum_;
-      delta.count_ = total.count_ - rsb->global_[id]->last_count_;
-
-      // increment the global values by the delta
-      (void)ATOMIC_FAA(&(rsb->global_[id]->sum_), delta.sum_);
-      (void)ATOMIC_FAA(&(rsb->global_[id]->count_), delta.count_);
-
-      // set the new totals as the last values seen
-      (void)ATOMIC_SET(&(rsb->global_[id]->last_sum_), total.sum_);
-      (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), total.count_);
-      if (OB_FAIL(mutex_release(&(rsb->mutex_)))) {
-        LOG_ERROR("fail to release mutex", K(ret));
-      }
+    // get the delta from the last sync
+    ObRecRawStat delta;
+    delta.sum_ = total.sum_ - rsb->global_[id]->last_sum_;
+    delta.count_ = total.count_ - rsb->global_[id]->last_count_;
+
+    // increment the global values by the delta
+    (void)ATOMIC_FAA(&(rsb->global_[id]->sum_), delta.sum_);
+    (void)ATOMIC_FAA(&(rsb->global_[id]->count_), delta.count_);
+
+    // set the new totals as the last values seen
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_sum_), total.sum_);
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), total.count_);
+    if (OB_FAIL(mutex_release(&(rsb->mutex_)))) {
+      LOG_ERROR("fail to release mutex", K(ret));
     }
   }
 
   return ret;
 }
 
+// thread cells are only written by their own thread, so clearing rebases the
+// last sync values on the current thread totals instead of zeroing the cells
 int ObStatProcessor::clear_raw_stat(ObRecRawStatBlock *rsb, const int64_t id)
 {
   int ret = OB_SUCCESS;
@@ -880,26 +922,15 @@ int ObStatProcessor::clear_raw_stat(ObRecRawStatBlock *rsb, const int64_t id)
   } else if (OB_FAIL(mutex_acquire(&(rsb->mutex_)))){
     LOG_ERROR("fail to acquire mutex", K(ret));
   } else {
+    ObRecRawStat thread_total;
+    get_thread_raw_stat_total(rsb, id, thread_total);
+    rsb->snapshot_epoch_ = -1;
     (void)ATOMIC_SET(&(rsb->global_[id]->sum_), 0L);
-    (void)ATOMIC_SET(&(rsb->global_[id]->last_sum_), 0L);
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_sum_), thread_total.sum_);
     (void)ATOMIC_SET(&(rsb->global_[id]->count_), 0L);
-    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), 0L);
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), thread_total.count_);
     if (OB_FAIL(mutex_release(&(rsb->mutex_)))) {
       LOG_ERROR("fail to release mutex", K(ret));
-    } else {
-      // reset the local stats
-      ObRecRawStat *tlp = NULL;
-      for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->sum_), 0L);
-        (void)ATOMIC_SET(&(tlp->count_), 0L);
-      }
-
-      for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->sum_), 0L);
-        (void)ATOMIC_SET(&(tlp->count_), 0L);
-      }
     }
   }
 
@@ -918,22 +949,13 @@ int ObStatProcessor::clear_raw_stat_sum(ObRecRawStatBlock *rsb, const int64_t id
   } else if (OB_FAIL(mutex_acquire(&(rsb->mutex_)))){
     LOG_ERROR("fail to acquire mutex", K(ret));
   } else {
-    (void)ATOMIC_SET(&(rsb->global_[id]->count_), 0L);
-    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), 0L);
+    ObRecRawStat thread_total;
+    get_thread_raw_stat_total(rsb, id, thread_total);
+    rsb->snapshot_epoch_ = -1;
+    (void)ATOMIC_SET(&(rsb->global_[id]->sum_), 0L);
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_sum_), thread_total.sum_);
     if (OB_FAIL(mutex_release(&(rsb->mutex_)))) {
       LOG_ERROR("fail to release mutex", K(ret));
-    } else {
-      // reset the local stats
-      ObRecRawStat *tlp = NULL;
-      for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->sum_), 0L);
-      }
-
-      for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->sum_), 0L);
-      }
     }
   }
 
@@ -952,22 +974,13 @@ int ObStatProcessor::clear_raw_stat_count(ObRecRawStatBlock *rsb, const int64_t
   } else if (OB_FAIL(mutex_acquire(&(rsb->mutex_)))){
     LOG_ERROR("fail to acquire mutex", K(ret));
   } else {
+    ObRecRawStat thread_total;
+    get_thread_raw_stat_total(rsb, id, thread_total);
+    rsb->snapshot_epoch_ = -1;
     (void)ATOMIC_SET(&(rsb->global_[id]->count_), 0L);
-    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), 0L);
+    (void)ATOMIC_SET(&(rsb->global_[id]->last_count_), thread_total.count_);
     if (OB_FAIL(mutex_release(&(rsb->mutex_)))) {
       LOG_ERROR("fail to release mutex", K(ret));
-    } else {
-      // reset the local stats
-      ObRecRawStat *tlp = NULL;
-      for (int64_t i = 0; i < g_event_processor.event_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_event_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->count_), 0L);
-      }
-
-      for (int64_t i = 0; i < g_event_processor.dedicate_thread_count_; ++i) {
-        tlp = reinterpret_cast<ObRecRawStat *>(reinterpret_cast<char *>(g_event_processor.all_dedicate_threads_[i]) + rsb->ethr_stat_offset_) + id;
-        (void)ATOMIC_SET(&(tlp->count_), 0L);
-      }
     }
   }
 
@@ -81,6 +81,12 @@ union ObRecData
 };
 
 // RawStat Structures
+//
+// Each ethread has one ObRecRawStat per stat in its thread_private_ block, and
+// it is the only writer of it (except the atomic ones such as per-thread conn
+// count). Clear and set never touch thread cells, they move the global baseline
+// (last_sum_/last_count_) instead, and thread_private_ is padded away from the
+// ethread fields other threads write, so the hot path never shares a cache line.
 struct ObRecRawStat
 {
   ObRecRawStat() { ob_zero(*this); }
@@ -90,8 +96,8 @@ struct ObRecRawStat
   volatile int64_t count_;
 
   // XXX - these will waist some space because they are only needed for the globals
-  volatile int64_t last_sum_;   // value from the last global sync
-  volatile int64_t last_count_; // value from the last global sync
+  volatile int64_t last_sum_;   // thread total of the last global sync
+  volatile int64_t last_count_; // thread total of the last global sync
 };
 
 // WARNING!  It's advised that developers do not modify the contents of
@@ -114,6 +120,9 @@ struct ObRecRawStatBlock
   int64_t num_stats_;            // number of stats in this block
   int64_t max_stats_;            // maximum number of stats for this block
   const char *xflush_log_head_;  // for xflush log
+  // thread totals of all stats, summed in one pass per sync epoch
+  ObRecRawStat *snapshot_;
+  int64_t snapshot_epoch_;
   ObMutex mutex_;
   LINK(ObRecRawStatBlock, link_);
 };
@@ -522,6 +531,8 @@ private:
   static bool set_rec_data_from_float(ObRecDataType data_type, ObRecData &data_dst, float data_float);
 
   static int get_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id, ObRecRawStat &total);
+  static void get_thread_raw_stat_total(ObRecRawStatBlock *rsb, const int64_t id, ObRecRawStat &total);
+  static void aggregate_raw_stat_block(ObRecRawStatBlock *rsb);
   static int sync_raw_stat_to_global(ObRecRawStatBlock *rsb, const int64_t id);
   static int clear_raw_stat(ObRecRawStatBlock *rsb, const int64_t id);
   static int clear_raw_stat_sum(ObRecRawStatBlock *rsb, const int64_t id);
@@ -583,6 +594,9 @@ private:
 
   ASLL(ObRecRecord, link_) all_records_;
   volatile int64_t record_count_;
+  // bumped by each exec_raw_stat_sync_cbs(), thread stats of a block are summed
+  // once per epoch no matter how many records of it are synced
+  volatile int64_t sync_epoch_;
 
   ASLL(ObRecRawStatBlock, link_) all_blocks_;
 
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define USING_LOG_PREFIX PROXY
+
+#include <getopt.h>
+#include <stdio.h>
+#include "lib/oblog/ob_log.h"
+#include "obutils/ob_monitor_binlog.h"
+
+using namespace oceanbase::common;
+using namespace oceanbase::obproxy::obutils;
+
+static const int64_t READ_BUFFER_SIZE = 4 * 1024 * 1024;
+static const int64_t LINE_BUFFER_SIZE = 64 * 1024;
+
+static void print_usage(const char *prog)
+{
+  fprintf(stderr,
+          "Usage: %s -f monitor_binlog_file [-t digest|slow|error] [-w]\n"
+          "  decode obproxy_monitor.bin into the text of obproxy digest, slow or error log\n"
+          "  -w only prints the records of WARN level, as the .wf file of text log\n",
+          prog);
+}
+
+static int parse_type(const char *str, int64_t &type)
+{
+  int ret = OB_SUCCESS;
+  type = MONITOR_LOG_MAX_TYPE;
+  for (int64_t i = 0; i < MONITOR_LOG_MAX_TYPE; ++i) {
+    if (0 == strcasecmp(str, get_monitor_log_type_name(static_cast<ObMonitorLogType>(i)))) {
+      type = i;
+    }
+  }
+  if (MONITOR_LOG_MAX_TYPE == type) {
+    ret = OB_INVALID_ARGUMENT;
+  }
+  return ret;
+}
+
+static int decode_file(FILE *file, const int64_t type, const bool is_warn_only, char *data, char *line)
+{
+  int ret = OB_SUCCESS;
+  ObMonitorLogFileHeader file_header;
+  if (1 != fread(&file_header, sizeof(file_header), 1, file) || !file_header.is_valid()) {
+    ret = OB_INVALID_DATA;
+    fprintf(stderr, "invalid monitor binlog file header\n");
+  } else {
+    int64_t data_len = 0;
+    bool is_eof = false;
+    while (OB_SUCC(ret) && !is_eof) {
+      const size_t read_len = fread(data + data_len, 1, READ_BUFFER_SIZE - data_len, file);
+      is_eof = (0 == read_len);
+      data_len += read_len;
+
+      int64_t pos = 0;
+      const ObMonitorLogRecordHeader *header = NULL;
+      ObString fields[MONITOR_FIELD_MAX];
+      while (OB_SUCC(ret) && OB_SUCC(ObMonitorBinlogDecoder::decode_record(data, data_len, pos, header, fields))) {
+        int64_t line_pos = 0;
+        if ((MONITOR_LOG_MAX_TYPE != type && type != header->type_)
+            || (is_warn_only && OB_LOG_LEVEL_WARN != ObMonitorBinlogDecoder::get_log_level(*header))) {
+          // skip
+        } else if (OB_FAIL(ObMonitorBinlogDecoder::to_text(*header, fields, line, LINE_BUFFER_SIZE, line_pos))) {
+          fprintf(stderr, "fail to print monitor log record, ret=%d\n", ret);
+        } else {
+          fwrite(line, 1, line_pos, stdout);
+        }
+      }
+      if (OB_ITER_END == ret) {
+        ret = OB_SUCCESS;
+        // keep the partial record for next read
+        MEMMOVE(data, data + pos, data_len - pos);
+        data_len -= pos;
+      } else if (OB_FAIL(ret)) {
+        fprintf(stderr, "fail to decode monitor binlog record, ret=%d\n", ret);
+      }
+    }
+    if (OB_SUCC(ret) && data_len > 0) {
+      fprintf(stderr, "ignore %ld bytes of incomplete record at the end of file\n", data_len);
+    }
+  }
+  return ret;
+}
+
+int main(int argc, char *argv[])
+{
+  int ret = OB_SUCCESS;
+  const char *file_path = NULL;
+  int64_t type = MONITOR_LOG_MAX_TYPE;
+  bool is_warn_only = false;
+  int c = 0;
+  while (OB_SUCC(ret) && -1 != (c = getopt(argc, argv, "f:t:wh"))) {
+    switch (c) {
+      case 'f':
+        file_path = optarg;
+        break;
+      case 't':
+        ret = parse_type(optarg, type);
+        break;
+      case 'w':
+        is_warn_only = true;
+        break;
+      default:
+        ret = OB_INVALID_ARGUMENT;
+        break;
+    }
+  }
+
+  FILE *file = NULL;
+  char *data = NULL;
+  char *line = NULL;
+  OB_LOGGER.set_log_level("ERROR");
+  if (OB_FAIL(ret) || OB_ISNULL(file_path)) {
+    ret = OB_INVALID_ARGUMENT;
+    print_usage(argv[0]);
+  } else if (OB_ISNULL(file = fopen(file_path, "r"))) {
+    ret = OB_IO_ERROR;
+    fprintf(stderr, "fail to open %s: %s\n", file_path, strerror(errno));
+  } else if (OB_ISNULL(data = static_cast<char *>(malloc(READ_BUFFER_SIZE)))
+             || OB_ISNULL(line = static_cast<char *>(malloc(LINE_BUFFER_SIZE)))) {
+    ret = OB_ALLOCATE_MEMORY_FAILED;
+    fprintf(stderr, "fail to alloc memory\n");
+  } else {
+    ret = decode_file(file, type, is_warn_only, data, line);
+  }
+
+  if (NULL != file) {
+    fclose(file);
+  }
+  if (NULL != data) {
+    free(data);
+  }
+  if (NULL != line) {
+    free(line);
+  }
+  return OB_SUCCESS == ret ? 0 : 1;
+}
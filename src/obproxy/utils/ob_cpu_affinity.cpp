@@ -13,6 +13,7 @@
 #define USING_LOG_PREFIX PROXY
 #include "utils/ob_proxy_lib.h"
 #include "utils/ob_cpu_affinity.h"
+#include "lib/cpu/ob_numa_node.h"
 
 using namespace oceanbase::common;
 
@@ -25,11 +26,17 @@ ObCpuTopology::ObCpuTopology()
     : is_inited_(false),
       core_number_(0),
       cpu_number_(0),
-      cores_()
+      node_number_(0),
+      cores_(),
+      nodes_()
 {
   for (int64_t i = 0; i < MAX_CORE_NUMBER; i++) {
+    cores_[i].node_id_ = 0;
     cores_[i].cpu_number_ = 0;
   }
+  for (int64_t i = 0; i < MAX_NODE_NUMBER; i++) {
+    nodes_[i].core_number_ = 0;
+  }
 }
 
 int ObCpuTopology::init()
@@ -46,9 +53,11 @@ int ObCpuTopology::init()
     char buf[BUFSIZ];
     int64_t cpu_id = 0;
     int64_t core_id = 0;
+    int64_t node_id = 0;
 
     char *p = NULL;
     char *p_core = NULL;
+    char *p_node = NULL;
 
     while ((NULL != fgets(buf, BUFSIZ, fp)) && OB_SUCC(ret)) {
       if (buf[0] == '#') {
@@ -64,17 +73,35 @@ int ObCpuTopology::init()
       *p = '\0';
       core_id = atoll(p_core);
 
+      // CPU,Core,Socket,Node,...
+      node_id = 0;
+      if (NULL != (p = strchr(p + 1, ','))) {
+        p_node = p + 1;
+        if (NULL != (p = strchr(p_node, ','))) {
+          *p = '\0';
+        }
+        node_id = atoll(p_node);
+      }
+
       if (core_id + 1 > core_number_) {
         core_number_ = core_id + 1;
       }
 
       ++cpu_number_;
 
-      if (OB_LIKELY(core_number_ < MAX_CORE_NUMBER)) {
+      if (OB_LIKELY(core_number_ < MAX_CORE_NUMBER) && OB_LIKELY(node_id >= 0)
+          && OB_LIKELY(node_id < MAX_NODE_NUMBER)) {
+        if (0 == cores_[core_id].cpu_number_) {
+          cores_[core_id].node_id_ = node_id;
+          nodes_[node_id].cores_[nodes_[node_id].core_number_++] = core_id;
+          if (node_id + 1 > node_number_) {
+            node_number_ = node_id + 1;
+          }
+        }
         cores_[core_id].cpues_[(cores_[core_id].cpu_number_++) % MAX_CPU_NUMBER_PER_CORE] = cpu_id;
       } else {
         ret = OB_SIZE_OVERFLOW;
-        LOG_ERROR("too many cores", K(core_number_), K(ret));
+        LOG_ERROR("too many cores or nodes", K(core_number_), K(node_id), K(ret));
       }
     }
 
@@ -86,7 +113,7 @@ int ObCpuTopology::init()
         j = 0;
         n = cores_[i].cpu_number_;
         for (j = 0; j < n; j++) {
-          _LOG_INFO("core_id:%3ld => cpu_id:%3ld", i, cores_[i].cpues_[j]);
+          _LOG_INFO("node_id:%2ld core_id:%3ld => cpu_id:%3ld", cores_[i].node_id_, i, cores_[i].cpues_[j]);
         }
       }
     }
@@ -119,6 +146,34 @@ ObCpuTopology::CoreInfo *ObCpuTopology::get_core_info(const int64_t core_id)
   return core_info;
 }
 
+ObCpuTopology::NodeInfo *ObCpuTopology::get_node_info(const int64_t node_id)
+{
+  NodeInfo *node_info = NULL;
+  if (node_id >= 0 && node_id < node_number_) {
+    node_info = &nodes_[node_id];
+  }
+  return node_info;
+}
+
+void ObCpuTopology::publish_numa_node_map(const bool enable_local_alloc)
+{
+  ObNumaNodeMap &map = g_numa_node_map;
+  int64_t cpu_count = 0;
+  for (int64_t i = 0; i < core_number_; i++) {
+    for (int64_t j = 0; j < cores_[i].cpu_number_ && j < MAX_CPU_NUMBER_PER_CORE; j++) {
+      const int64_t cpu_id = cores_[i].cpues_[j];
+      if (cpu_id >= 0 && cpu_id < ObNumaNodeMap::MAX_CPU_COUNT) {
+        map.cpu_node_[cpu_id] = static_cast<int16_t>(cores_[i].node_id_);
+        cpu_count = std::max(cpu_count, cpu_id + 1);
+      }
+    }
+  }
+  map.cpu_count_ = cpu_count;
+  map.enable_local_alloc_ = enable_local_alloc;
+  ATOMIC_STORE(&map.node_count_, node_number_);
+  LOG_INFO("succ to publish numa node map", K_(node_number), K(cpu_count), K(enable_local_alloc));
+}
+
 int ObCpuTopology::bind_cpu(const int64_t cpu_id, const pthread_t thread_id)
 {
   int ret = OB_SUCCESS;
@@ -60,28 +60,42 @@ class ObCpuTopology
 public:
   static const int64_t MAX_CPU_NUMBER_PER_CORE = 4;
   static const int64_t MAX_CORE_NUMBER = 128;
+  static const int64_t MAX_NODE_NUMBER = 8;
 
 public:
   struct CoreInfo
   {
+    int64_t node_id_;
     int64_t cpu_number_;
     int64_t cpues_[MAX_CPU_NUMBER_PER_CORE];
   };
 
+  struct NodeInfo
+  {
+    int64_t core_number_;
+    int64_t cores_[MAX_CORE_NUMBER];
+  };
+
   ObCpuTopology();
   ~ObCpuTopology() { }
 
   int init();
   int64_t get_core_number() const;
   int64_t get_cpu_number() const;
+  int64_t get_node_number() const { return node_number_; }
   CoreInfo *get_core_info(const int64_t core_id);
+  NodeInfo *get_node_info(const int64_t node_id);
+  // publish cpu => node map to common::g_numa_node_map, which is used by object pool
+  void publish_numa_node_map(const bool enable_local_alloc);
   int bind_cpu(const int64_t cpu_id, const pthread_t thread_id);
 
 private:
   bool is_inited_;
   int64_t core_number_;
   int64_t cpu_number_;
+  int64_t node_number_;
   CoreInfo cores_[MAX_CORE_NUMBER];
+  NodeInfo nodes_[MAX_NODE_NUMBER];
 
   DISALLOW_COPY_AND_ASSIGN(ObCpuTopology);
 };
@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include "obutils/ob_congestion_entry.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+
+static const int64_t MIN_LIMIT = 5;
+static const int64_t MAX_LIMIT = 1000;
+static const int64_t NO_LOAD_RTT_US = 1000;
+// gtest takes the expected value by reference
+static const int64_t INITIAL_LIMIT = ObConcurrencyLimiter::INITIAL_LIMIT;
+
+class TestConcurrencyLimiter : public ::testing::Test
+{
+public:
+  // fill the limit, then release all requests with the same rtt, which is one round
+  void run_full_round(const int64_t rtt_us, const int64_t max_limit = MAX_LIMIT)
+  {
+    const int64_t limit = limiter_.limit_;
+    for (int64_t i = 0; i < limit; ++i) {
+      ASSERT_TRUE(limiter_.try_acquire(limit));
+    }
+    ASSERT_FALSE(limiter_.try_acquire(limit));
+    ASSERT_EQ(limit, limiter_.inflight_);
+    for (int64_t i = 0; i < limit; ++i) {
+      limiter_.release(rtt_us, MIN_LIMIT, max_limit);
+    }
+    ASSERT_EQ(0, limiter_.inflight_);
+    ASSERT_EQ(0, limiter_.round_samples_);
+  }
+
+  // one request at a time for a round
+  void run_idle_round(const int64_t rtt_us)
+  {
+    const int64_t limit = limiter_.limit_;
+    for (int64_t i = 0; i < limit; ++i) {
+      ASSERT_TRUE(limiter_.try_acquire(limit));
+      limiter_.release(rtt_us, MIN_LIMIT, MAX_LIMIT);
+    }
+    ASSERT_EQ(0, limiter_.inflight_);
+    ASSERT_EQ(0, limiter_.round_samples_);
+  }
+
+public:
+  ObConcurrencyLimiter limiter_;
+};
+
+TEST_F(TestConcurrencyLimiter, test_acquire_release)
+{
+  ASSERT_EQ(INITIAL_LIMIT, limiter_.limit_);
+  ASSERT_TRUE(limiter_.try_acquire(2));
+  ASSERT_TRUE(limiter_.try_acquire(2));
+  ASSERT_FALSE(limiter_.try_acquire(2));
+  ASSERT_FALSE(limiter_.try_acquire(1));
+  ASSERT_EQ(2, limiter_.rejected_count_);
+  // requests in transaction are counted without limit
+  limiter_.acquire();
+  ASSERT_EQ(3, limiter_.inflight_);
+
+  // no server process time, the limit learns nothing
+  limiter_.release(0, MIN_LIMIT, MAX_LIMIT);
+  limiter_.release(0, MIN_LIMIT, MAX_LIMIT);
+  limiter_.release(0, MIN_LIMIT, MAX_LIMIT);
+  ASSERT_EQ(0, limiter_.inflight_);
+  ASSERT_EQ(0, limiter_.round_samples_);
+  ASSERT_EQ(INITIAL_LIMIT, limiter_.limit_);
+  ASSERT_TRUE(limiter_.try_acquire(1));
+  ASSERT_EQ(2, limiter_.rejected_count_);
+}
+
+TEST_F(TestConcurrencyLimiter, test_grow)
+{
+  double estimated_limit = static_cast<double>(INITIAL_LIMIT);
+  // the round is not over before limit responses
+  ASSERT_TRUE(limiter_.try_acquire(limiter_.limit_));
+  limiter_.release(NO_LOAD_RTT_US, MIN_LIMIT, MAX_LIMIT);
+  ASSERT_EQ(1, limiter_.round_samples_);
+  ASSERT_EQ(INITIAL_LIMIT, limiter_.limit_);
+  limiter_.reset();
+
+  // grows by sqrt(limit) each round while the latency stays flat
+  for (int64_t i = 0; i < 5; ++i) {
+    run_full_round(NO_LOAD_RTT_US);
+    estimated_limit += sqrt(estimated_limit);
+    ASSERT_EQ(static_cast<int64_t>(estimated_limit), limiter_.limit_);
+  }
+  ASSERT_DOUBLE_EQ(static_cast<double>(NO_LOAD_RTT_US), limiter_.no_load_rtt_us_);
+
+  // still growing within 1.5 times of the no-load latency
+  const int64_t old_limit = limiter_.limit_;
+  run_full_round(NO_LOAD_RTT_US * 14 / 10);
+  ASSERT_GT(limiter_.limit_, old_limit);
+}
+
+TEST_F(TestConcurrencyLimiter, test_cut)
+{
+  for (int64_t i = 0; i < 5; ++i) {
+    run_full_round(NO_LOAD_RTT_US);
+  }
+
+  // the server queues requests, the limit is cut by the latency ratio
+  int64_t old_limit = limiter_.limit_;
+  double old_estimated_limit = limiter_.estimated_limit_;
+  run_full_round(NO_LOAD_RTT_US * 2);
+  double gradient = 1.5 * limiter_.no_load_rtt_us_ / static_cast<double>(NO_LOAD_RTT_US * 2);
+  ASSERT_LT(gradient, 1.0);
+  ASSERT_DOUBLE_EQ(old_estimated_limit * gradient + sqrt(old_estimated_limit), limiter_.estimated_limit_);
+  ASSERT_LT(limiter_.limit_, old_limit);
+
+  // never cut below half in one round
+  old_limit = limiter_.limit_;
+  old_estimated_limit = limiter_.estimated_limit_;
+  run_full_round(NO_LOAD_RTT_US * 100);
+  ASSERT_DOUBLE_EQ(old_estimated_limit * 0.5 + sqrt(old_estimated_limit), limiter_.estimated_limit_);
+  ASSERT_LT(limiter_.limit_, old_limit);
+  ASSERT_GE(limiter_.limit_, old_limit / 2);
+
+  // the no-load latency only drifts slowly, the limit keeps falling to the min
+  for (int64_t i = 0; i < 20; ++i) {
+    run_full_round(NO_LOAD_RTT_US * 100);
+  }
+  ASSERT_EQ(MIN_LIMIT, limiter_.limit_);
+  ASSERT_LT(limiter_.no_load_rtt_us_, static_cast<double>(NO_LOAD_RTT_US * 5));
+
+  // and grows back once the server recovers
+  for (int64_t i = 0; i < 5; ++i) {
+    old_limit = limiter_.limit_;
+    run_full_round(NO_LOAD_RTT_US);
+    ASSERT_GT(limiter_.limit_, old_limit);
+  }
+}
+
+TEST_F(TestConcurrencyLimiter, test_idle)
+{
+  run_full_round(NO_LOAD_RTT_US);
+  const int64_t limit = limiter_.limit_;
+  const double estimated_limit = limiter_.estimated_limit_;
+
+  // far below the limit, neither fast nor slow responses move it
+  run_idle_round(NO_LOAD_RTT_US / 2);
+  run_idle_round(NO_LOAD_RTT_US * 100);
+  ASSERT_EQ(limit, limiter_.limit_);
+  ASSERT_DOUBLE_EQ(estimated_limit, limiter_.estimated_limit_);
+  // but the no-load latency is learned from them
+  ASSERT_LT(limiter_.no_load_rtt_us_, static_cast<double>(NO_LOAD_RTT_US));
+}
+
+TEST_F(TestConcurrencyLimiter, test_max_limit)
+{
+  const int64_t max_limit = 30;
+  for (int64_t i = 0; i < 10; ++i) {
+    run_full_round(NO_LOAD_RTT_US, max_limit);
+    ASSERT_LE(limiter_.limit_, max_limit);
+  }
+  ASSERT_EQ(max_limit, limiter_.limit_);
+
+  limiter_.reset();
+  ASSERT_EQ(INITIAL_LIMIT, limiter_.limit_);
+  ASSERT_EQ(0, limiter_.inflight_);
+  ASSERT_EQ(0, limiter_.rejected_count_);
+  ASSERT_DOUBLE_EQ(0, limiter_.no_load_rtt_us_);
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "proxy/plugins/ob_mysql_response_cursor_prefetch_transform_plugin.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obmysql;
+using namespace event;
+using namespace proxy;
+
+static const int64_t ROW_COUNT = 5;
+// autocommit, cursor exists, last row sent
+static const uint16_t LAST_EOF_STATUS = 0x0002 | 0x0040 | 0x0080;
+
+class TestCursorPrefetchTransform : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    input_ = new_miobuffer(DEFAULT_LARGE_BUFFER_SIZE);
+    output_ = new_empty_miobuffer();
+    ASSERT_TRUE(NULL != input_);
+    ASSERT_TRUE(NULL != output_);
+    output_reader_ = input_->alloc_reader();
+    analyze_reader_ = output_reader_->clone();
+    client_reader_ = output_->alloc_reader();
+    resp_len_ = 0;
+    cursor_id_addr_.set_prefetching(true);
+  }
+
+  virtual void TearDown()
+  {
+    cursor_id_addr_.reset_prefetch();
+    free_miobuffer(input_);
+    free_miobuffer(output_);
+  }
+
+  void add_packet(const uint8_t seq, const char *payload, const int64_t payload_len)
+  {
+    char *pos = resp_ + resp_len_;
+    pos[0] = static_cast<char>(payload_len & 0xFF);
+    pos[1] = static_cast<char>((payload_len >> 8) & 0xFF);
+    pos[2] = static_cast<char>((payload_len >> 16) & 0xFF);
+    pos[3] = static_cast<char>(seq);
+    MEMCPY(pos + MYSQL_NET_HEADER_LENGTH, payload, payload_len);
+    resp_len_ += MYSQL_NET_HEADER_LENGTH + payload_len;
+  }
+
+  // resultset header, one field, eof, rows with value 'a', 'b', ... and the last eof
+  void build_fetch_resp()
+  {
+    const char header[] = {0x01};
+    const char field[] = {0x03, 'd', 'e', 'f', 0x00, 0x00, 0x00, 0x01, 'c'};
+    const char eof[] = {static_cast<char>(0xFE), 0x00, 0x00, 0x02, 0x00};
+    const char last_eof[] = {static_cast<char>(0xFE), 0x00, 0x00,
+                             static_cast<char>(LAST_EOF_STATUS & 0xFF),
+                             static_cast<char>(LAST_EOF_STATUS >> 8)};
+    uint8_t seq = 1;
+    add_packet(seq++, header, sizeof(header));
+    add_packet(seq++, field, sizeof(field));
+    add_packet(seq++, eof, sizeof(eof));
+    for (int64_t i = 0; i < ROW_COUNT; ++i) {
+      const char row[] = {0x01, static_cast<char>('a' + i)};
+      add_packet(seq++, row, sizeof(row));
+    }
+    add_packet(seq++, last_eof, sizeof(last_eof));
+  }
+
+  // the response arrives in pieces split at @split_pos
+  void transform(const int64_t split_pos)
+  {
+    int64_t written_len = 0;
+    ASSERT_EQ(OB_SUCCESS, input_->write(resp_, split_pos, written_len));
+    ASSERT_EQ(OB_SUCCESS, handler_.handle_resp(*output_reader_, *analyze_reader_, cursor_id_addr_, *output_));
+    ASSERT_FALSE(handler_.is_done());
+    ASSERT_EQ(OB_SUCCESS, input_->write(resp_ + split_pos, resp_len_ - split_pos, written_len));
+    ASSERT_EQ(OB_SUCCESS, handler_.handle_resp(*output_reader_, *analyze_reader_, cursor_id_addr_, *output_));
+    ASSERT_TRUE(handler_.is_done());
+    ASSERT_EQ(0, analyze_reader_->read_avail());
+    ASSERT_EQ(0, output_reader_->read_avail());
+  }
+
+  // check the packets client receives, the seq goes on one by one from 1
+  void check_client_resp(const int64_t row_count, const uint16_t eof_status)
+  {
+    const int64_t len = client_reader_->read_avail();
+    char buf[sizeof(resp_)];
+    ASSERT_LE(len, static_cast<int64_t>(sizeof(buf)));
+    client_reader_->copy(buf, len, 0);
+
+    int64_t pkt_count = 0;
+    const char *pos = buf;
+    const char *last_pkt = NULL;
+    while (pos < buf + len) {
+      const int64_t payload_len = static_cast<uint8_t>(pos[0]);
+      ASSERT_EQ(static_cast<uint8_t>(pkt_count + 1), static_cast<uint8_t>(pos[3]));
+      if (pkt_count >= 3 && pkt_count < 3 + row_count) {
+        // rows
+        ASSERT_EQ(2, payload_len);
+        ASSERT_EQ('a' + pkt_count - 3, pos[MYSQL_NET_HEADER_LENGTH + 1]);
+      }
+      last_pkt = pos;
+      pos += MYSQL_NET_HEADER_LENGTH + payload_len;
+      ++pkt_count;
+    }
+    ASSERT_EQ(3 + row_count + 1, pkt_count);
+    ASSERT_EQ(static_cast<char>(0xFE), last_pkt[MYSQL_NET_HEADER_LENGTH]);
+    const uint16_t status = static_cast<uint16_t>(static_cast<uint8_t>(last_pkt[MYSQL_NET_HEADER_LENGTH + 3])
+                                                  | (static_cast<uint8_t>(last_pkt[MYSQL_NET_HEADER_LENGTH + 4]) << 8));
+    ASSERT_EQ(eof_status, status);
+  }
+
+public:
+  ObMIOBuffer *input_;
+  ObMIOBuffer *output_;
+  ObIOBufferReader *output_reader_;
+  ObIOBufferReader *analyze_reader_;
+  ObIOBufferReader *client_reader_;
+  ObCursorIdAddr cursor_id_addr_;
+  ObCursorPrefetchRespHandler handler_;
+  char resp_[1024];
+  int64_t resp_len_;
+};
+
+TEST_F(TestCursorPrefetchTransform, test_stash_rows)
+{
+  cursor_id_addr_.set_fetch_rows(2);
+  build_fetch_resp();
+  // split in the middle of the last row
+  transform(resp_len_ - 12);
+
+  // the eof follows the last row sent, the cursor stays open for the stashed rows
+  check_client_resp(2, 0x0002 | 0x0040);
+  ASSERT_EQ(ROW_COUNT - 2, cursor_id_addr_.get_prefetch_row_count());
+  ASSERT_FALSE(cursor_id_addr_.is_prefetching());
+  ASSERT_TRUE(cursor_id_addr_.is_server_cursor_exhausted());
+  ASSERT_EQ(3 * MYSQL_NET_HEADER_LENGTH + 1 + 9 + 5, cursor_id_addr_.get_prefetch_head_len());
+
+  // stashed rows keep the server seq, they are renumbered when served
+  const char *pkt_buf = NULL;
+  int64_t pkt_len = 0;
+  for (int64_t i = 2; i < ROW_COUNT; ++i) {
+    ASSERT_EQ(OB_SUCCESS, cursor_id_addr_.pop_prefetch_row(pkt_buf, pkt_len));
+    ASSERT_EQ(MYSQL_NET_HEADER_LENGTH + 2, pkt_len);
+    ASSERT_EQ(4 + i, pkt_buf[3]);
+    ASSERT_EQ('a' + i, pkt_buf[MYSQL_NET_HEADER_LENGTH + 1]);
+  }
+  ASSERT_FALSE(cursor_id_addr_.has_prefetch_rows());
+}
+
+TEST_F(TestCursorPrefetchTransform, test_no_stash)
+{
+  cursor_id_addr_.set_fetch_rows(ROW_COUNT);
+  build_fetch_resp();
+  transform(3);
+
+  // all rows go to client, the eof is passed as server sends it
+  check_client_resp(ROW_COUNT, LAST_EOF_STATUS);
+  ASSERT_FALSE(cursor_id_addr_.has_prefetch_rows());
+  ASSERT_FALSE(cursor_id_addr_.is_prefetching());
+  ASSERT_EQ(0, cursor_id_addr_.get_prefetch_head_len());
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "dbconfig/ob_proxy_db_config_info.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obsys;
+using namespace dbconfig;
+
+static const ObString TENANT_NAME = ObString::make_string("tenant");
+static const ObString DB_NAME = ObString::make_string("db");
+
+class TestDbConfigSnapshot : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    tenant_info_ = NULL;
+    reader_snapshot_ = NULL;
+    reader_db_info_ = NULL;
+    new_db_info_ = NULL;
+    is_reader_entered_ = false;
+    is_reader_released_ = false;
+    is_published_ = false;
+  }
+
+  virtual void TearDown()
+  {
+    // the snapshot refs go first, then the tenant releases its dbs
+    if (NULL != cache_.snapshot_) {
+      op_free(cache_.snapshot_);
+      cache_.snapshot_ = NULL;
+    }
+    if (NULL != tenant_info_) {
+      ASSERT_EQ(tenant_info_, cache_.lt_map_.remove(TENANT_NAME));
+      tenant_info_->dec_ref();
+      tenant_info_ = NULL;
+    }
+  }
+
+  void add_tenant()
+  {
+    ASSERT_TRUE(NULL != (tenant_info_ = op_alloc(ObDbConfigLogicTenant)));
+    tenant_info_->set_tenant_name(TENANT_NAME);
+    CWLockGuard guard(cache_.rwlock_);
+    ASSERT_EQ(OB_SUCCESS, cache_.lt_map_.unique_set(tenant_info_));
+    tenant_info_->inc_ref();
+  }
+
+  // as update_db_info does, the new db info replaces the old one as a whole
+  ObDbConfigLogicDb *replace_db()
+  {
+    ObDbConfigLogicDb *db_info = op_alloc(ObDbConfigLogicDb);
+    if (NULL != db_info) {
+      db_info->set_db_name(DB_NAME);
+      CWLockGuard guard(cache_.rwlock_);
+      ObDbConfigLogicDb *cur_db_info = tenant_info_->ld_map_.remove(DB_NAME);
+      if (NULL != cur_db_info) {
+        cur_db_info->dec_ref();
+      }
+      if (OB_SUCCESS == tenant_info_->ld_map_.unique_set(db_info)) {
+        db_info->inc_ref();
+      }
+      if (OB_SUCCESS != cache_.publish_snapshot()) {
+        db_info = NULL;
+      }
+    }
+    return db_info;
+  }
+
+  // enter the critical section and hold the current snapshot till released
+  static void *do_read(void *arg)
+  {
+    TestDbConfigSnapshot *test = static_cast<TestDbConfigSnapshot *>(arg);
+    CriticalGuard(test->cache_.qsync_);
+    const ObDbConfigSnapshot *snapshot = ATOMIC_LOAD(&test->cache_.snapshot_);
+    const ObDbConfigSnapshot::ObDbConfigSnapshotTenant *tenant = snapshot->get_tenant(TENANT_NAME);
+    ATOMIC_STORE(&test->reader_snapshot_, snapshot);
+    ATOMIC_STORE(&test->is_reader_entered_, true);
+    while (!ATOMIC_LOAD(&test->is_reader_released_)) {
+      usleep(1000);
+    }
+    // the old snapshot and its db are still alive here
+    if (NULL != tenant) {
+      ATOMIC_STORE(&test->reader_db_info_, snapshot->get_db(*tenant, DB_NAME));
+    }
+    return NULL;
+  }
+
+  static void *do_replace(void *arg)
+  {
+    TestDbConfigSnapshot *test = static_cast<TestDbConfigSnapshot *>(arg);
+    ATOMIC_STORE(&test->new_db_info_, test->replace_db());
+    ATOMIC_STORE(&test->is_published_, true);
+    return NULL;
+  }
+
+public:
+  ObDbConfigCache cache_;
+  ObDbConfigLogicTenant *tenant_info_;
+  const ObDbConfigSnapshot *reader_snapshot_;
+  ObDbConfigLogicDb *reader_db_info_;
+  ObDbConfigLogicDb *new_db_info_;
+  bool is_reader_entered_;
+  bool is_reader_released_;
+  bool is_published_;
+};
+
+TEST_F(TestDbConfigSnapshot, test_publish)
+{
+  ASSERT_FALSE(cache_.is_tenant_exist(TENANT_NAME));
+  add_tenant();
+  // lookups only see the published maps
+  ASSERT_FALSE(cache_.is_tenant_exist(TENANT_NAME));
+
+  ObDbConfigLogicDb *db_info = replace_db();
+  ASSERT_TRUE(NULL != db_info);
+  ASSERT_EQ(1, cache_.get_snapshot_version());
+  ASSERT_TRUE(cache_.is_tenant_exist(TENANT_NAME));
+  // held by ld_map_ and the snapshot
+  ASSERT_EQ(2, db_info->ref_count_);
+
+  ObDbConfigLogicDb *found = cache_.get_exist_db_info(TENANT_NAME, DB_NAME);
+  ASSERT_EQ(db_info, found);
+  ASSERT_EQ(3, db_info->ref_count_);
+  found->dec_ref();
+  ASSERT_TRUE(NULL == cache_.get_exist_db_info(TENANT_NAME, ObString::make_string("no_db")));
+}
+
+TEST_F(TestDbConfigSnapshot, test_swap_under_reader)
+{
+  add_tenant();
+  ObDbConfigLogicDb *old_db_info = replace_db();
+  ASSERT_TRUE(NULL != old_db_info);
+  // held by the test to watch the snapshot release it
+  old_db_info->inc_ref();
+  const ObDbConfigSnapshot *old_snapshot = cache_.snapshot_;
+
+  pthread_t reader;
+  pthread_t writer;
+  ASSERT_EQ(0, pthread_create(&reader, NULL, do_read, this));
+  while (!ATOMIC_LOAD(&is_reader_entered_)) {
+    usleep(1000);
+  }
+  ASSERT_EQ(old_snapshot, reader_snapshot_);
+  ASSERT_EQ(0, pthread_create(&writer, NULL, do_replace, this));
+
+  // the new snapshot is served at once, but the old one waits for the reader
+  while (2 != cache_.get_snapshot_version()) {
+    usleep(1000);
+  }
+  ObDbConfigLogicDb *found = cache_.get_exist_db_info(TENANT_NAME, DB_NAME);
+  ASSERT_TRUE(NULL != found);
+  ASSERT_NE(old_db_info, found);
+  found->dec_ref();
+  usleep(100 * 1000);
+  ASSERT_FALSE(ATOMIC_LOAD(&is_published_));
+  // removed from ld_map_, still held by the old snapshot
+  ASSERT_EQ(2, old_db_info->ref_count_);
+
+  ATOMIC_STORE(&is_reader_released_, true);
+  ASSERT_EQ(0, pthread_join(reader, NULL));
+  ASSERT_EQ(0, pthread_join(writer, NULL));
+  ASSERT_TRUE(ATOMIC_LOAD(&is_published_));
+  ASSERT_EQ(old_db_info, reader_db_info_);
+  ASSERT_EQ(new_db_info_, cache_.snapshot_->get_db(0));
+
+  // the old snapshot is freed after the reader left
+  ASSERT_EQ(1, old_db_info->ref_count_);
+  old_db_info->dec_ref();
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -882,6 +882,56 @@ TEST_F(TestEThread, is_or_set_event_thread_type)
   ethread->set_event_thread_type((ObEventThreadType)ET_CALL);
 }
 
+static int64_t test_signal_count = 0;
+static int test_signal_ret = OB_SUCCESS;
+
+static int test_signal_hook(ObEThread &ethread)
+{
+  UNUSED(ethread);
+  ++test_signal_count;
+  return test_signal_ret;
+}
+
+TEST_F(TestEThread, wakeup_coalescing)
+{
+  LOG_DEBUG("wakeup coalescing");
+  ObEThread *ethread = new ObEThread();
+  ASSERT_TRUE(NULL != ethread);
+  ethread->signal_hook_ = test_signal_hook;
+  test_signal_count = 0;
+  test_signal_ret = OB_SUCCESS;
+
+  // only the first producer signals until the thread clears the flag
+  ASSERT_EQ(OB_SUCCESS, ethread->wakeup());
+  ASSERT_EQ(OB_SUCCESS, ethread->wakeup());
+  ASSERT_EQ(OB_SUCCESS, ethread->wakeup());
+  ASSERT_EQ(1, test_signal_count);
+  ASSERT_EQ(1, ethread->signal_sent_count_);
+  ASSERT_EQ(2, ethread->signal_saved_count_);
+  ASSERT_TRUE(ethread->wakeup_pending_);
+
+  ethread->clear_wakeup();
+  ASSERT_EQ(OB_SUCCESS, ethread->wakeup());
+  ASSERT_EQ(2, test_signal_count);
+  ASSERT_EQ(2, ethread->signal_sent_count_);
+
+  // a failed signal leaves nothing in flight, the next producer signals again
+  ethread->clear_wakeup();
+  test_signal_ret = OB_ERR_SYS;
+  ASSERT_EQ(OB_ERR_SYS, ethread->wakeup());
+  ASSERT_FALSE(ethread->wakeup_pending_);
+  ASSERT_EQ(2, ethread->signal_sent_count_);
+  test_signal_ret = OB_SUCCESS;
+  ASSERT_EQ(OB_SUCCESS, ethread->wakeup());
+  ASSERT_EQ(4, test_signal_count);
+  ASSERT_EQ(3, ethread->signal_sent_count_);
+  ASSERT_EQ(2, ethread->signal_saved_count_);
+  ASSERT_TRUE(ethread->wakeup_pending_);
+
+  ethread->signal_hook_ = NULL;
+  delete ethread;
+}
+
 TEST_F(TestEThread, schedule_imm)
 {
   LOG_DEBUG("schedule_imm");
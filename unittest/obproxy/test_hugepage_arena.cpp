@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include <sys/time.h>
+#include "lib/allocator/ob_hugepage_arena.h"
+#include "lib/allocator/ob_malloc.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+
+static const int64_t MB = 1024L * 1024L;
+
+TEST(TestHugePageArena, test_block_size)
+{
+  ASSERT_EQ(4096, ObHugePageArena::get_block_size(1));
+  ASSERT_EQ(4096, ObHugePageArena::get_block_size(4096));
+  ASSERT_EQ(16384, ObHugePageArena::get_block_size(8193));
+  ASSERT_EQ(2 * MB, ObHugePageArena::get_block_size(2 * MB));
+  ASSERT_EQ(0, ObHugePageArena::get_block_size(2 * MB + 1));
+}
+
+TEST(TestHugePageArena, test_alloc_free)
+{
+  ObHugePageArena arena;
+  ASSERT_TRUE(NULL == arena.alloc(8192, 16));
+  ASSERT_EQ(OB_SUCCESS, arena.init(4 * MB));
+  ASSERT_EQ(4 * MB, arena.get_limit());
+
+  void *ptr1 = arena.alloc(10000, 16);
+  ASSERT_TRUE(NULL != ptr1);
+  ASSERT_TRUE(arena.contains(ptr1));
+  ASSERT_EQ(0, reinterpret_cast<int64_t>(ptr1) % ObHugePageArena::MIN_BLOCK_SIZE);
+  ASSERT_EQ(2 * MB, arena.get_hold());
+  ASSERT_EQ(16384, arena.get_used());
+  MEMSET(ptr1, 'a', 10000);
+
+  // freed block is reused by the same size class
+  arena.free(ptr1);
+  ASSERT_EQ(0, arena.get_used());
+  ASSERT_EQ(ptr1, arena.alloc(16384, 16));
+
+  // too big or too aligned goes to ob_malloc
+  ASSERT_TRUE(NULL == arena.alloc(2 * MB + 1, 16));
+  ASSERT_TRUE(NULL == arena.alloc(4096, 8192));
+  int64_t stack_value = 0;
+  ASSERT_FALSE(arena.contains(&stack_value));
+
+  // the tail of first segment is carved into free blocks, nothing is lost
+  void *ptr2 = arena.alloc(2 * MB, 16);
+  ASSERT_TRUE(NULL != ptr2);
+  ASSERT_EQ(4 * MB, arena.get_hold());
+  ASSERT_EQ(0, reinterpret_cast<int64_t>(ptr2) % ObHugePageArena::SEGMENT_SIZE);
+  ASSERT_TRUE(NULL != arena.alloc(MB, 16));
+
+  // arena is used up
+  ASSERT_TRUE(NULL == arena.alloc(2 * MB, 16));
+  arena.destroy();
+}
+
+// io buffer like workload: a window of 16KB blocks, each one is filled before free
+TEST(TestHugePageArena, test_performance)
+{
+  static const int64_t BLOCK_SIZE = 16 * 1024;
+  static const int64_t WINDOW = 1024;
+  static const int64_t LOOP_COUNT = 200;
+  void *blocks[WINDOW];
+  struct timeval time_begin, time_end;
+  ObHugePageArena arena;
+  ASSERT_EQ(OB_SUCCESS, arena.init(64 * MB));
+
+  for (int64_t use_arena = 0; use_arena < 2; ++use_arena) {
+    gettimeofday(&time_begin, NULL);
+    for (int64_t i = 0; i < LOOP_COUNT; ++i) {
+      for (int64_t j = 0; j < WINDOW; ++j) {
+        blocks[j] = use_arena ? arena.alloc(BLOCK_SIZE, 16) : ob_malloc_align(16, BLOCK_SIZE, ObModIds::TEST);
+        ASSERT_TRUE(NULL != blocks[j]);
+        MEMSET(blocks[j], static_cast<int>(i), BLOCK_SIZE);
+      }
+      for (int64_t j = 0; j < WINDOW; ++j) {
+        if (use_arena) {
+          arena.free(blocks[j]);
+        } else {
+          ob_free_align(blocks[j]);
+        }
+      }
+    }
+    gettimeofday(&time_end, NULL);
+    const int64_t cost_us = 1000000 * (time_end.tv_sec - time_begin.tv_sec) + time_end.tv_usec - time_begin.tv_usec;
+    OB_LOG(INFO, "hugepage arena performance", K(use_arena), K(cost_us),
+           "MB/s", (0 == cost_us) ? 0 : BLOCK_SIZE * WINDOW * LOOP_COUNT / cost_us,
+           "hugetlb_segment_count", arena.get_hugetlb_segment_count());
+  }
+  arena.destroy();
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -680,6 +680,60 @@ TEST_F(TestIOBuffer, test_OBMIOBufferReader_replace)
   buffer_ptr_ = NULL;
 }
 
+TEST_F(TestIOBuffer, test_ObMIOBuffer_write_block_share)
+{
+  LOG_DEBUG("test_ObMIOBuffer_write_block_share");
+  const int64_t data_len = MIN_SHARE_BLOCK_BYTES * 4;
+  ObMIOBuffer *src_buf = new_miobuffer(DEFAULT_LARGE_BUFFER_SIZE);
+  ObMIOBuffer *dst_buf = new_miobuffer(DEFAULT_LARGE_BUFFER_SIZE);
+  ASSERT_TRUE(NULL != src_buf && NULL != dst_buf);
+  ObIOBufferReader *src_reader = src_buf->alloc_reader();
+  ObIOBufferReader *dst_reader = dst_buf->alloc_reader();
+  ASSERT_TRUE(NULL != src_reader && NULL != dst_reader);
+
+  char *data = new char[data_len];
+  for (int64_t i = 0; i < data_len; ++i) {
+    data[i] = static_cast<char>('a' + i % 26);
+  }
+  int64_t written_len = 0;
+  int64_t shared_len = 0;
+  ASSERT_EQ(OB_SUCCESS, src_buf->write(data, data_len, written_len));
+  ASSERT_EQ(data_len, written_len);
+  ObIOBufferBlock *block = src_reader->block_;
+
+  // out of the block
+  ASSERT_EQ(OB_INVALID_ARGUMENT, dst_buf->write(block, block->start() + 1, data_len, written_len, shared_len));
+
+  // small range is copied
+  ASSERT_EQ(OB_SUCCESS, dst_buf->write(block, block->start(), 10, written_len, shared_len));
+  ASSERT_EQ(10, written_len);
+  ASSERT_EQ(0, shared_len);
+
+  // large range shares the data
+  const int64_t big_len = MIN_SHARE_BLOCK_BYTES * 2;
+  ASSERT_EQ(OB_SUCCESS, dst_buf->write(block, block->start() + 10, big_len, written_len, shared_len));
+  ASSERT_EQ(big_len, written_len);
+  ASSERT_EQ(big_len, shared_len);
+  ASSERT_EQ(block->start() + 10, dst_buf->writer_->start());
+  ASSERT_EQ(0, dst_buf->writer_->write_avail());
+
+  // write after the shared block goes to a new block
+  ASSERT_EQ(OB_SUCCESS, dst_buf->write(data, 5, written_len));
+  ASSERT_EQ(10 + big_len + 5, dst_reader->read_avail());
+
+  // the shared data is kept after the source is consumed and freed
+  ASSERT_EQ(OB_SUCCESS, src_reader->consume_all());
+  free_miobuffer(src_buf);
+  char *out = new char[10 + big_len + 5];
+  dst_reader->copy(out, 10 + big_len + 5, 0);
+  ASSERT_EQ(0, memcmp(out, data, 10 + big_len));
+  ASSERT_EQ(0, memcmp(out + 10 + big_len, data, 5));
+
+  delete []out;
+  delete []data;
+  free_miobuffer(dst_buf);
+}
+
 } // end of namespace obproxy
 } // end of namespace oceanbase
 
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "obutils/ob_latency_histogram.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+
+// gtest takes the expected value by reference
+static const int64_t MAX_VALUE = ObLatencyHistogram::MAX_VALUE;
+
+TEST(TestLatencyHistogram, test_bucket_index)
+{
+  for (int64_t i = 0; i < 2 * ObLatencyHistogram::SUB_BUCKET_COUNT; ++i) {
+    ASSERT_EQ(i, ObLatencyHistogram::get_bucket_index(i));
+    ASSERT_EQ(i, ObLatencyHistogram::get_bucket_upper_value(i));
+  }
+  ASSERT_EQ(ObLatencyHistogram::BUCKET_COUNT - 1,
+            ObLatencyHistogram::get_bucket_index(ObLatencyHistogram::MAX_VALUE));
+  // every value falls in a bucket no wider than 1/SUB_BUCKET_COUNT of it
+  for (int64_t value = 1; value < ObLatencyHistogram::MAX_VALUE; value = value * 3 / 2 + 1) {
+    const int64_t index = ObLatencyHistogram::get_bucket_index(value);
+    const int64_t upper_value = ObLatencyHistogram::get_bucket_upper_value(index);
+    ASSERT_GE(upper_value, value);
+    ASSERT_LE(upper_value - value, value / ObLatencyHistogram::SUB_BUCKET_COUNT);
+    ASSERT_LT(ObLatencyHistogram::get_bucket_upper_value(index - 1), value);
+  }
+}
+
+TEST(TestLatencyHistogram, test_percentile)
+{
+  ObLatencyHistogram histogram;
+  ASSERT_EQ(0, histogram.get_percentile(99.0));
+  for (int64_t i = 1; i <= 10000; ++i) {
+    histogram.record(i);
+  }
+  ObLatencyHistogram other;
+  other.record(-1);
+  other.record(ObLatencyHistogram::MAX_VALUE + 1);
+  histogram.merge(other);
+
+  ASSERT_EQ(10002, histogram.get_count());
+  ASSERT_EQ(MAX_VALUE, histogram.get_max());
+  ASSERT_NEAR(5000, histogram.get_percentile(50.0), 5000 / ObLatencyHistogram::SUB_BUCKET_COUNT);
+  ASSERT_NEAR(9900, histogram.get_percentile(99.0), 9900 / ObLatencyHistogram::SUB_BUCKET_COUNT);
+  ASSERT_EQ(MAX_VALUE, histogram.get_percentile(100.0));
+}
+
+TEST(TestLatencyHistogram, test_subtract)
+{
+  ObLatencyHistogram histogram;
+  for (int64_t i = 1; i <= 100; ++i) {
+    histogram.record(i);
+  }
+  ObLatencyHistogram base = histogram;
+  for (int64_t i = 0; i < 10; ++i) {
+    histogram.record(10);
+  }
+  histogram.subtract(base);
+  ASSERT_EQ(10, histogram.get_count());
+  ASSERT_EQ(100, histogram.get_sum());
+  // max is what is left, not the max ever recorded
+  ASSERT_EQ(10, histogram.get_max());
+  ASSERT_EQ(10, histogram.get_percentile(99.0));
+
+  histogram.subtract(histogram);
+  ASSERT_EQ(0, histogram.get_count());
+  ASSERT_EQ(0, histogram.get_max());
+  ASSERT_EQ(0, histogram.get_percentile(50.0));
+}
+
+TEST(TestLatencyHistogram, test_window)
+{
+  ObLatencyHistogramItem item(0, ObString::make_string("cluster"), ObString::make_string("tenant"), OBPROXY_T_SELECT);
+  // threads share stripes
+  ObLatencyHistogramSet *stripes[ObLatencyHistogramItem::STRIPE_COUNT * 4];
+  for (int64_t i = 0; i < ObLatencyHistogramItem::STRIPE_COUNT * 4; ++i) {
+    stripes[i] = item.get_or_create_stripe(i);
+    ASSERT_TRUE(NULL != stripes[i]);
+    ASSERT_EQ(stripes[i % ObLatencyHistogramItem::STRIPE_COUNT], stripes[i]);
+  }
+
+  const int64_t WINDOW_US = 3600L * 1000 * 1000;
+  ObLatencyHistogramSet set;
+  for (int64_t i = 0; i < 100; ++i) {
+    stripes[0]->histograms_[LATENCY_TOTAL].record(100);
+  }
+  item.merge_window(set, WINDOW_US);
+  ASSERT_EQ(100, set.histograms_[LATENCY_TOTAL].get_count());
+
+  // the window moves on, the old latency is out of the last window
+  for (int64_t i = 0; i < 10; ++i) {
+    stripes[1]->histograms_[LATENCY_TOTAL].record(5000);
+  }
+  ObLatencyHistogramSet window_set;
+  item.merge_window(window_set, 0);
+  ASSERT_EQ(10, window_set.histograms_[LATENCY_TOTAL].get_count());
+  ASSERT_NEAR(5000, window_set.histograms_[LATENCY_TOTAL].get_percentile(50.0),
+              5000 / ObLatencyHistogram::SUB_BUCKET_COUNT);
+  ObLatencyHistogramSet empty_set;
+  item.merge_window(empty_set, WINDOW_US);
+  ASSERT_EQ(10, empty_set.histograms_[LATENCY_TOTAL].get_count());
+  item.merge_window(empty_set, 0);
+  ASSERT_EQ(0, empty_set.histograms_[LATENCY_TOTAL].get_count());
+
+  // all since the item is created
+  ObLatencyHistogramSet all_set;
+  item.merge(all_set);
+  ASSERT_EQ(110, all_set.histograms_[LATENCY_TOTAL].get_count());
+  ASSERT_EQ(5000, all_set.histograms_[LATENCY_TOTAL].get_max());
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "obutils/ob_monitor_binlog.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+
+static void fill_record(ObMonitorLogRecord &record)
+{
+  record.flags_ = MONITOR_FLAG_ERROR_RESP;
+  record.error_code_ = 1064;
+  record.total_time_us_ = 1500;
+  record.prepare_send_time_us_ = 20;
+  record.server_process_time_us_ = 1200;
+  record.trace_id_[0] = 0x1234;
+  record.trace_id_[1] = 0xabcd;
+  record.fields_[MONITOR_FIELD_CLUSTER] = ObString::make_string("cluster");
+  record.fields_[MONITOR_FIELD_TENANT] = ObString::make_string("tenant");
+  record.fields_[MONITOR_FIELD_DATABASE] = ObString::make_string("db");
+  record.fields_[MONITOR_FIELD_SQL_CMD] = ObString::make_string("COM_QUERY");
+  record.fields_[MONITOR_FIELD_STMT_TYPE] = ObString::make_string("SELECT");
+  record.fields_[MONITOR_FIELD_SQL] = ObString::make_string("select 1,\n2");
+  record.fields_[MONITOR_FIELD_ERROR_MSG] = ObString::make_string("syntax error");
+}
+
+TEST(TestMonitorBinlog, test_buffer_wrap)
+{
+  ObMonitorLogBuffer buffer;
+  ObMonitorLogRecord record;
+  fill_record(record);
+  const int64_t length = ObMonitorLogBuffer::get_record_length(record, MONITOR_LOG_DIGEST);
+  ASSERT_EQ(0, length % ObMonitorLogBuffer::RECORD_ALIGN_SIZE);
+  ASSERT_EQ(OB_SUCCESS, buffer.init(length * 3));
+
+  char buf[4096];
+  int64_t total_count = 0;
+  for (int64_t round = 0; round < 10; ++round) {
+    int64_t count = 0;
+    while (OB_SUCCESS == buffer.append(MONITOR_LOG_DIGEST, round, record)) {
+      ++count;
+    }
+    ASSERT_GT(count, 0);
+    total_count += count;
+    const int64_t copied_length = buffer.consume(buf, sizeof(buf));
+    ASSERT_EQ(count * length, copied_length);
+
+    int64_t pos = 0;
+    const ObMonitorLogRecordHeader *header = NULL;
+    ObString fields[MONITOR_FIELD_MAX];
+    for (int64_t i = 0; i < count; ++i) {
+      ASSERT_EQ(OB_SUCCESS, ObMonitorBinlogDecoder::decode_record(buf, copied_length, pos, header, fields));
+      ASSERT_EQ(round, header->timestamp_us_);
+      ASSERT_EQ(record.fields_[MONITOR_FIELD_SQL], fields[MONITOR_FIELD_SQL]);
+      // error msg is only kept in error log
+      ASSERT_TRUE(fields[MONITOR_FIELD_ERROR_MSG].empty());
+    }
+    ASSERT_EQ(OB_ITER_END, ObMonitorBinlogDecoder::decode_record(buf, copied_length, pos, header, fields));
+  }
+  ASSERT_EQ(10, buffer.get_drop_count());
+  ASSERT_GE(total_count, 10);
+}
+
+TEST(TestMonitorBinlog, test_to_text)
+{
+  ObMonitorLogBuffer buffer;
+  ObMonitorLogRecord record;
+  fill_record(record);
+  ASSERT_EQ(OB_SUCCESS, buffer.init(4096));
+  ASSERT_EQ(OB_SUCCESS, buffer.append(MONITOR_LOG_ERROR, 0, record));
+
+  char buf[4096];
+  const int64_t copied_length = buffer.consume(buf, sizeof(buf));
+  int64_t pos = 0;
+  const ObMonitorLogRecordHeader *header = NULL;
+  ObString fields[MONITOR_FIELD_MAX];
+  ASSERT_EQ(OB_SUCCESS, ObMonitorBinlogDecoder::decode_record(buf, copied_length, pos, header, fields));
+  ASSERT_EQ(MONITOR_LOG_ERROR, header->type_);
+
+  char text[4096];
+  int64_t text_pos = 0;
+  ASSERT_EQ(OB_SUCCESS, ObMonitorBinlogDecoder::to_text(*header, fields, text, sizeof(text), text_pos));
+  // skip the time, which depends on local time zone
+  const char *body = strchr(text, ',') + 1;
+  ASSERT_STREQ(",,,,cluster:tenant:db,,,,COM_QUERY,SELECT,failed,1064,select 1%2C%0A2,"
+               "1500us,20us,0us,1200us,Y1234-ABCD,,,,0,,syntax error\n", body);
+}
+
+TEST(TestMonitorBinlog, test_log_level)
+{
+  ObMonitorLogBuffer buffer;
+  ObMonitorLogRecord record;
+  fill_record(record);
+  ASSERT_EQ(OB_SUCCESS, buffer.init(4096));
+  // a digest of INFO level, a digest of WARN level and a slow log
+  record.flags_ = 0;
+  ASSERT_EQ(OB_SUCCESS, buffer.append(MONITOR_LOG_DIGEST, 0, record));
+  record.flags_ = MONITOR_FLAG_WARN_LEVEL;
+  ASSERT_EQ(OB_SUCCESS, buffer.append(MONITOR_LOG_DIGEST, 0, record));
+  record.flags_ = 0;
+  ASSERT_EQ(OB_SUCCESS, buffer.append(MONITOR_LOG_SLOW, 0, record));
+
+  char buf[4096];
+  const int64_t copied_length = buffer.consume(buf, sizeof(buf));
+  int64_t pos = 0;
+  const ObMonitorLogRecordHeader *header = NULL;
+  ObString fields[MONITOR_FIELD_MAX];
+  const int32_t expected_levels[] = {OB_LOG_LEVEL_INFO, OB_LOG_LEVEL_WARN, OB_LOG_LEVEL_WARN};
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_EQ(OB_SUCCESS, ObMonitorBinlogDecoder::decode_record(buf, copied_length, pos, header, fields));
+    ASSERT_EQ(expected_levels[i], ObMonitorBinlogDecoder::get_log_level(*header));
+  }
+  ASSERT_EQ(OB_ITER_END, ObMonitorBinlogDecoder::decode_record(buf, copied_length, pos, header, fields));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
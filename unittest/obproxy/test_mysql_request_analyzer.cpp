@@ -17,9 +17,13 @@
 #include <gtest/gtest.h>
 #include "lib/objectpool/ob_concurrency_objpool.h"
 #include "obproxy/proxy/mysqllib/ob_mysql_request_analyzer.h"
+#include "obproxy/proxy/mysqllib/ob_mysql_transaction_analyzer.h"
+#include "obproxy/proxy/mysqllib/ob_mysql_response.h"
 
 using namespace oceanbase;
 using namespace oceanbase::common;
+using namespace oceanbase::obmysql;
+using namespace oceanbase::obproxy::event;
 using namespace oceanbase::obproxy::obutils;
 using namespace oceanbase::obproxy::proxy;
 
@@ -747,6 +751,106 @@ TEST_F(TestEvent, test_analyze_16m_0b_in_one_buffer)
   free(tmp_buf);
 }
 
+TEST_F(TestEvent, test_analyze_local_infile_packets)
+{
+  // three packets of file and the empty packet, each one is received by 3 bytes
+  const int32_t packet_lens[] = {100, 8192, 1, 0};
+  const int64_t packet_count = sizeof(packet_lens) / sizeof(packet_lens[0]);
+  int64_t total_len = 0;
+  for (int64_t i = 0; i < packet_count; ++i) {
+    total_len += MYSQL_NET_HEADER_LENGTH + packet_lens[i];
+  }
+  char *tmp_buf = (char *) malloc(total_len);
+  int64_t pos = 0;
+  for (int64_t i = 0; i < packet_count; ++i) {
+    ob_int3store(tmp_buf + pos, packet_lens[i]);
+    tmp_buf[pos + 3] = static_cast<char>(i + 2);
+    MEMSET(tmp_buf + pos + MYSQL_NET_HEADER_LENGTH, 'a', packet_lens[i]);
+    pos += MYSQL_NET_HEADER_LENGTH + packet_lens[i];
+  }
+
+  bool is_finish = false;
+  ObRequestBuffer buffer;
+  request_analyzer_->set_local_infile(true);
+  for (pos = 0; pos < total_len; pos += 3) {
+    buffer.assign_ptr(tmp_buf + pos, static_cast<int32_t>(std::min(3L, total_len - pos)));
+    ASSERT_EQ(OB_SUCCESS, request_analyzer_->is_request_finished(buffer, is_finish));
+    ASSERT_EQ(pos + 3 >= total_len, is_finish);
+  }
+  ASSERT_EQ(packet_count + 1, request_analyzer_->get_packet_seq());
+
+  // more than one packet is an error out of local infile
+  request_analyzer_->reuse();
+  buffer.assign_ptr(tmp_buf, static_cast<int32_t>(total_len));
+  ASSERT_NE(OB_SUCCESS, request_analyzer_->is_request_finished(buffer, is_finish));
+
+  buffer.reset();
+  free(tmp_buf);
+}
+
+TEST_F(TestEvent, test_local_infile_flow)
+{
+  // LOCAL INFILE request of 'a.txt', the file of 5 bytes, the empty packet and the final ok
+  const char infile_resp[] = {0x06, 0x00, 0x00, 0x01, static_cast<char>(0xFB), 'a', '.', 't', 'x', 't'};
+  const char file_req[] = {0x05, 0x00, 0x00, 0x02, '1', ',', '2', '\n', '3',
+                           0x00, 0x00, 0x00, 0x03};
+  const char ok_resp[] = {0x07, 0x00, 0x00, 0x04, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00};
+  ObMysqlTransactionAnalyzer trans_analyzer;
+  ObMysqlResp resp;
+  ObRespBuffer resp_buf;
+
+  // the option is off, LOCAL INFILE is rejected as before
+  trans_analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, STANDARD_MYSQL_PROTOCOL_MODE, false, false);
+  resp_buf.assign_ptr(infile_resp, sizeof(infile_resp));
+  ASSERT_EQ(OB_NOT_SUPPORTED, trans_analyzer.analyze_trans_response(resp_buf, &resp));
+
+  // 1. the LOCAL INFILE request completes the response, and keeps the server session
+  trans_analyzer.reset();
+  resp.reset();
+  trans_analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, STANDARD_MYSQL_PROTOCOL_MODE, false, false);
+  trans_analyzer.set_enable_local_infile(true);
+  ASSERT_EQ(OB_SUCCESS, trans_analyzer.analyze_trans_response(resp_buf, &resp));
+  ASSERT_TRUE(trans_analyzer.is_resp_completed());
+  ASSERT_FALSE(trans_analyzer.is_trans_completed());
+  ASSERT_TRUE(resp.get_analyze_result().is_local_infile_resp());
+
+  // 2. the file is streamed, the request ends only on the empty packet
+  bool is_finish = false;
+  ObRequestBuffer req_buf;
+  request_analyzer_->set_local_infile(true);
+  req_buf.assign_ptr(file_req, MYSQL_NET_HEADER_LENGTH + 5);
+  ASSERT_EQ(OB_SUCCESS, request_analyzer_->is_request_finished(req_buf, is_finish));
+  ASSERT_FALSE(is_finish);
+  req_buf.assign_ptr(file_req + MYSQL_NET_HEADER_LENGTH + 5, MYSQL_NET_HEADER_LENGTH);
+  ASSERT_EQ(OB_SUCCESS, request_analyzer_->is_request_finished(req_buf, is_finish));
+  ASSERT_TRUE(is_finish);
+  ASSERT_EQ(3, request_analyzer_->get_packet_seq());
+
+  // the analyzer of the file never parses it, the response is of COM_QUERY
+  ObMysqlAnalyzeResult result;
+  ObIOBufferReader *reader = NULL;
+  ObMIOBuffer *buffer = new_miobuffer(DEFAULT_LARGE_BUFFER_SIZE);
+  int64_t written_len = 0;
+  ASSERT_TRUE(NULL != buffer);
+  reader = buffer->alloc_reader();
+  ASSERT_EQ(OB_SUCCESS, buffer->write(file_req, sizeof(file_req), written_len));
+  ASSERT_EQ(OB_SUCCESS, ObMysqlRequestAnalyzer::handle_local_infile_request(*reader, result));
+  ASSERT_EQ(OB_MYSQL_COM_QUERY, result.meta_.cmd_);
+  ASSERT_EQ(MYSQL_NET_HEADER_LENGTH + 5, result.meta_.pkt_len_);
+  free_miobuffer(buffer);
+
+  // 3. the final ok is read as a new response, which ends the statement
+  trans_analyzer.reset();
+  resp.reset();
+  trans_analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, STANDARD_MYSQL_PROTOCOL_MODE, false, false);
+  resp_buf.assign_ptr(ok_resp, sizeof(ok_resp));
+  ASSERT_EQ(OB_SUCCESS, trans_analyzer.analyze_trans_response(resp_buf, &resp));
+  ASSERT_TRUE(trans_analyzer.is_resp_completed());
+  ASSERT_TRUE(trans_analyzer.is_trans_completed());
+  ASSERT_TRUE(resp.get_analyze_result().is_ok_resp());
+  ASSERT_FALSE(resp.get_analyze_result().is_local_infile_resp());
+}
+
 int main(int argc, char **argv)
 {
   oceanbase::common::ObLogger::get_logger().set_log_level("INFO");
@@ -28,7 +28,7 @@ static const int64_t DEFAULT_PKT_LEN = 1024;
 class TestMysqlTransactionAnalyzer : public ::testing::Test
 {
 public:
-   int covert_hex_to_string(const char *hex_str, int64_t len, char *str);
+   static int covert_hex_to_string(const char *hex_str, int64_t len, char *str);
    void analyze_mysql_response(ObMysqlTransactionAnalyzer &trans_analyzer,
                                const char* hex, int64_t len, bool trans_end);
    void analyze_mysql_response(ObMysqlTransactionAnalyzer &trans_analyzer,
@@ -719,6 +719,97 @@ TEST_F(TestMysqlTransactionAnalyzer, test_OB_MYSQL_COM_QUERY_select_great_than_1
   analyze_mysql_response(trans_analyzer, hex_commit, true);
 };
 
+
+// column count, column definition and the first eof packet of "select * from t3"
+static const char *RESULTSET_HEAD_HEX = "0100000101"
+                                        "28000002036465660a6d795f746573745f64620274330274330270"
+                                        "6b02706b0c3f000b000000030350000000"
+                                        "05000003fe00002300";
+static const char *RESULTSET_TAIL_HEX = "05000004fe00002200";
+
+static int64_t make_resultset(char *buf, const int64_t row_cnt)
+{
+  char hex_buf[DEFAULT_PKT_LEN];
+  int64_t pos = strlen(RESULTSET_HEAD_HEX) / 2;
+  TestMysqlTransactionAnalyzer::covert_hex_to_string(RESULTSET_HEAD_HEX, strlen(RESULTSET_HEAD_HEX), hex_buf);
+  MEMCPY(buf, hex_buf, pos);
+  for (int64_t i = 0; i < row_cnt; ++i) {
+    // rows beginning with the bytes of ok, eof, local infile and null, and long rows
+    const uint32_t pkt_len = static_cast<uint32_t>(1 + (i * 7) % 300);
+    const uint8_t first_bytes[] = {0x00, 0xfe, 0xfb, 0x01};
+    uint8_t first_byte = first_bytes[i % 4];
+    if (0xfe == first_byte && pkt_len < 9) {
+      first_byte = 0x02;
+    }
+    buf[pos] = static_cast<char>(pkt_len & 0xff);
+    buf[pos + 1] = static_cast<char>((pkt_len >> 8) & 0xff);
+    buf[pos + 2] = static_cast<char>((pkt_len >> 16) & 0xff);
+    buf[pos + 3] = static_cast<char>(i & 0xff);
+    buf[pos + 4] = static_cast<char>(first_byte);
+    memset(buf + pos + 5, 'a', pkt_len - 1);
+    pos += MYSQL_NET_HEADER_LENGTH + pkt_len;
+  }
+  TestMysqlTransactionAnalyzer::covert_hex_to_string(RESULTSET_TAIL_HEX, strlen(RESULTSET_TAIL_HEX), hex_buf);
+  MEMCPY(buf + pos, hex_buf, strlen(RESULTSET_TAIL_HEX) / 2);
+  pos += strlen(RESULTSET_TAIL_HEX) / 2;
+  return pos;
+}
+
+TEST_F(TestMysqlTransactionAnalyzer, test_skip_row_pkts)
+{
+  static const int64_t ROW_CNT = 2000;
+  char *buf = new char[ROW_CNT * 310 + DEFAULT_PKT_LEN];
+  const int64_t total_len = make_resultset(buf, ROW_CNT);
+  const int64_t chunk_lens[] = {1, 3, 5, 6, 64, 301, 8192, total_len};
+
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(chunk_lens) / sizeof(chunk_lens[0])); ++i) {
+    ObMysqlTransactionAnalyzer analyzer;
+    ObMysqlTransactionAnalyzer skip_analyzer;
+    analyzer.set_skip_row_pkts(false);
+    analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, OCEANBASE_MYSQL_PROTOCOL_MODE, false, false);
+    skip_analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, OCEANBASE_MYSQL_PROTOCOL_MODE, false, false);
+    for (int64_t pos = 0; pos < total_len; pos += chunk_lens[i]) {
+      ObString resp_str;
+      resp_str.assign(buf + pos, static_cast<int32_t>(std::min(chunk_lens[i], total_len - pos)));
+      ObMysqlResp resp;
+      ObMysqlResp skip_resp;
+      ASSERT_EQ(OB_SUCCESS, analyzer.analyze_trans_response(resp_str, &resp));
+      ASSERT_EQ(OB_SUCCESS, skip_analyzer.analyze_trans_response(resp_str, &skip_resp));
+      ASSERT_EQ(analyzer.is_resp_completed(), skip_analyzer.is_resp_completed());
+      ASSERT_EQ(analyzer.is_trans_completed(), skip_analyzer.is_trans_completed());
+      ASSERT_EQ(resp.get_analyze_result().reserved_len_, skip_resp.get_analyze_result().reserved_len_);
+    }
+    ASSERT_FALSE(skip_analyzer.is_resp_completed());
+    // the extra ok packet
+    const char *hex_ok = "0700000500000002000000";
+    analyze_mysql_response(skip_analyzer, hex_ok, true);
+  }
+
+  // compare the throughput of the two ways, 8KB a time as read from the net
+  static const int64_t BENCH_ROW_CNT = 200000;
+  static const int64_t BENCH_ROUND = 20;
+  char *bench_buf = new char[BENCH_ROW_CNT * 310 + DEFAULT_PKT_LEN];
+  const int64_t bench_len = make_resultset(bench_buf, BENCH_ROW_CNT);
+  for (int64_t skip = 0; skip < 2; ++skip) {
+    const int64_t begin = ObTimeUtility::current_time();
+    for (int64_t round = 0; round < BENCH_ROUND; ++round) {
+      ObMysqlTransactionAnalyzer analyzer;
+      analyzer.set_skip_row_pkts(1 == skip);
+      analyzer.set_server_cmd(OB_MYSQL_COM_QUERY, OCEANBASE_MYSQL_PROTOCOL_MODE, false, false);
+      for (int64_t pos = 0; pos < bench_len; pos += 8192) {
+        ObString resp_str;
+        resp_str.assign(bench_buf + pos, static_cast<int32_t>(std::min(8192L, bench_len - pos)));
+        ASSERT_EQ(OB_SUCCESS, analyzer.analyze_trans_response(resp_str));
+      }
+    }
+    const int64_t cost_us = std::max(ObTimeUtility::current_time() - begin, 1L);
+    printf("skip_row_pkts=%ld, %ld bytes, %ld rows, %ld MB/s\n", skip, bench_len * BENCH_ROUND,
+           BENCH_ROW_CNT * BENCH_ROUND, bench_len * BENCH_ROUND / cost_us);
+  }
+  delete []bench_buf;
+  delete []buf;
+}
+
 }
 }
 }
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "executor/ob_proxy_parallel_dml.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+using namespace executor;
+
+class TestParallelDmlSplitter : public ::testing::Test
+{
+public:
+  void build(const ObProxyDmlSplitResult &result, const int64_t *indexes,
+             const int64_t count, ObSqlString &sql)
+  {
+    ObSEArray<int64_t, 4> item_indexes;
+    for (int64_t i = 0; i < count; ++i) {
+      ASSERT_EQ(OB_SUCCESS, item_indexes.push_back(indexes[i]));
+    }
+    ASSERT_EQ(OB_SUCCESS, ObProxyDmlSplitter::build_sql(result, item_indexes, sql));
+  }
+};
+
+TEST_F(TestParallelDmlSplitter, test_split_insert)
+{
+  ObProxyDmlSplitResult result;
+  ObString sql = ObString::make_string(
+      "insert into t1(`id`, name) values (1, 'a,)'), (2, func(3, 4)),(3, \"c\") on duplicate key update name = 'x'");
+  ASSERT_EQ(OB_SUCCESS, ObProxyDmlSplitter::split_insert_values(sql, result));
+  ASSERT_EQ(2, result.columns_.count());
+  ASSERT_TRUE(result.columns_.at(0) == ObString::make_string("`id`"));
+  ASSERT_TRUE(result.columns_.at(1) == ObString::make_string("name"));
+  ASSERT_EQ(3, result.items_.count());
+  ASSERT_TRUE(result.items_.at(0) == ObString::make_string("(1, 'a,)')"));
+  ASSERT_TRUE(result.items_.at(1) == ObString::make_string("(2, func(3, 4))"));
+  ASSERT_TRUE(result.items_.at(2) == ObString::make_string("(3, \"c\")"));
+
+  ObSqlString new_sql;
+  const int64_t indexes[] = {2, 0};
+  build(result, indexes, 2, new_sql);
+  ASSERT_STREQ("insert into t1(`id`, name) values (3, \"c\"), (1, 'a,)') on duplicate key update name = 'x'",
+               new_sql.ptr());
+
+  ObSEArray<ObString, 4> values;
+  ASSERT_EQ(OB_SUCCESS, ObProxyDmlSplitter::split_row_values(result.items_.at(1), values));
+  ASSERT_EQ(2, values.count());
+  ASSERT_TRUE(values.at(1) == ObString::make_string("func(3, 4)"));
+}
+
+TEST_F(TestParallelDmlSplitter, test_split_insert_fail)
+{
+  ObProxyDmlSplitResult result;
+  ObString sql = ObString::make_string("insert into t1(id) select id from t2");
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, ObProxyDmlSplitter::split_insert_values(sql, result));
+  sql = ObString::make_string("insert into t1(id) values (1), (2");
+  ASSERT_NE(OB_SUCCESS, ObProxyDmlSplitter::split_insert_values(sql, result));
+  // 'values' in string or comment is not keyword
+  sql = ObString::make_string("insert /* values */ into t1(id) select 'values' from t2");
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, ObProxyDmlSplitter::split_insert_values(sql, result));
+}
+
+TEST_F(TestParallelDmlSplitter, test_split_in_list)
+{
+  ObProxyDmlSplitResult result;
+  ObString sql = ObString::make_string(
+      "delete from t1 where c2 not in (7, 8) and c3 in (select 1) and t1.`c1` IN ( 1, '2', 3 ) and c4 = 'in (9)'");
+  ASSERT_EQ(OB_SUCCESS, ObProxyDmlSplitter::split_in_list(sql, result));
+  ASSERT_TRUE(result.column_name_ == ObString::make_string("c1"));
+  ASSERT_EQ(3, result.items_.count());
+  ASSERT_TRUE(result.items_.at(1) == ObString::make_string("'2'"));
+
+  ObSqlString new_sql;
+  const int64_t indexes[] = {1};
+  build(result, indexes, 1, new_sql);
+  ASSERT_STREQ("delete from t1 where c2 not in (7, 8) and c3 in (select 1) and t1.`c1` IN ('2') and c4 = 'in (9)'",
+               new_sql.ptr());
+
+  sql = ObString::make_string("update t1 set c2 = 1 where c1 = 1");
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, ObProxyDmlSplitter::split_in_list(sql, result));
+
+  // 'or' in sub expression or literal does not matter
+  sql = ObString::make_string("delete from t1 where (c2 = 1 or c2 = 2) and c1 in (1, 2) and c3 = 'a or b' order by c1");
+  ASSERT_EQ(OB_SUCCESS, ObProxyDmlSplitter::split_in_list(sql, result));
+  ASSERT_EQ(2, result.items_.count());
+}
+
+TEST_F(TestParallelDmlSplitter, test_split_in_list_not_conjunct)
+{
+  // the in list is not a conjunct of where clause, keep serial
+  const char *sqls[] = {
+    "delete from t1 where c1 in (1, 2) or c2 = 3",
+    "delete from t1 where c2 = 3 OR c1 in (1, 2)",
+    "update t1 set c3 = 1 where c1 in (1, 2) xor c2 = 3",
+    "delete from t1 where c2 = 3 || c1 in (1, 2)",
+    "delete from t1 where not c1 in (1, 2)",
+    "delete from t1 where !c1 in (1, 2)",
+  };
+  ObProxyDmlSplitResult result;
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(sqls) / sizeof(sqls[0])); ++i) {
+    ASSERT_EQ(OB_ENTRY_NOT_EXIST, ObProxyDmlSplitter::split_in_list(ObString::make_string(sqls[i]), result)) << sqls[i];
+    ASSERT_EQ(0, result.items_.count());
+  }
+}
+
+TEST_F(TestParallelDmlSplitter, test_column_value)
+{
+  SqlColumnValue value;
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(ObString::make_string("-12"), value));
+  ASSERT_EQ(TOKEN_INT_VAL, value.value_type_);
+  ASSERT_EQ(-12, value.column_int_value_);
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(ObString::make_string("'abc'"), value));
+  ASSERT_EQ(TOKEN_STR_VAL, value.value_type_);
+  ASSERT_TRUE(value.column_value_.string_ == ObString::make_string("abc"));
+  ASSERT_FALSE(ObProxyDmlSplitter::get_column_value(ObString::make_string("1.5"), value));
+  ASSERT_FALSE(ObProxyDmlSplitter::get_column_value(ObString::make_string("now()"), value));
+
+  // shard is calculated by the unescaped value
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(ObString::make_string("'it''s'"), value));
+  ASSERT_TRUE(value.column_value_.string_ == ObString::make_string("it's"));
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(ObString::make_string("'a\\'b\\\\c\\nd'"), value));
+  ASSERT_TRUE(value.column_value_.string_ == ObString::make_string("a'b\\c\nd"));
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(ObString::make_string("\"a\\%b\\xc\""), value));
+  ASSERT_TRUE(value.column_value_.string_ == ObString::make_string("a\\%bxc"));
+  ASSERT_FALSE(ObProxyDmlSplitter::get_column_value(ObString::make_string("'a'b'"), value));
+
+  ObSqlString long_value;
+  ASSERT_EQ(OB_SUCCESS, long_value.append("'"));
+  for (int64_t i = 0; i < OBPROXY_MAX_STRING_VALUE_LENGTH; ++i) {
+    ASSERT_EQ(OB_SUCCESS, long_value.append("a"));
+  }
+  ASSERT_EQ(OB_SUCCESS, long_value.append("'"));
+  ASSERT_TRUE(ObProxyDmlSplitter::get_column_value(long_value.string(), value));
+  ASSERT_EQ(OB_SUCCESS, long_value.append("'a'"));
+  ASSERT_FALSE(ObProxyDmlSplitter::get_column_value(long_value.string(), value));
+}
+
+TEST_F(TestParallelDmlSplitter, test_order_by_or_limit)
+{
+  ASSERT_TRUE(ObProxyDmlSplitter::has_order_by_or_limit(
+      ObString::make_string("delete from t1 where c1 in (1, 2) limit 1")));
+  ASSERT_TRUE(ObProxyDmlSplitter::has_order_by_or_limit(
+      ObString::make_string("update t1 set c2 = 1 where c1 in (1, 2) ORDER\n BY c3")));
+  ASSERT_FALSE(ObProxyDmlSplitter::has_order_by_or_limit(
+      ObString::make_string("delete from t1 where c1 in (1, 2) and c2 in (select c2 from t2 order by c2 limit 1)")));
+  ASSERT_FALSE(ObProxyDmlSplitter::has_order_by_or_limit(
+      ObString::make_string("update t1 set `limit` = 'order by' where c1 in (1, 2) and order_id = 1 /* limit */")));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "engine/ob_proxy_operator_agg.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace engine;
+
+class TestHashTable : public ::testing::Test
+{
+public:
+  TestHashTable()
+    : allocator_(ObModIds::TEST), select_exprs_(),
+      group_col_idxs_(array_new_alloc_size, allocator_),
+      agg_func_(allocator_, select_exprs_), hash_table_(allocator_) {}
+
+  virtual void SetUp()
+  {
+    // group by the only column
+    common::ObColumnInfo col_info;
+    col_info.index_ = 0;
+    ASSERT_EQ(OB_SUCCESS, group_col_idxs_.push_back(col_info));
+    ASSERT_EQ(OB_SUCCESS, agg_func_.init(group_col_idxs_));
+  }
+
+  ResultRow *make_row(const int64_t value)
+  {
+    ResultRow *row = new (allocator_.alloc(sizeof(ResultRow))) ResultRow(array_new_alloc_size, allocator_);
+    ObObj *obj = new (allocator_.alloc(sizeof(ObObj))) ObObj();
+    obj->set_int(value);
+    EXPECT_EQ(OB_SUCCESS, row->push_back(obj));
+    return row;
+  }
+
+  // return the group row of value
+  ResultRow *insert(const uint64_t hash_val, const int64_t value)
+  {
+    ResultRow *group_row = NULL;
+    EXPECT_EQ(OB_SUCCESS, hash_table_.get_or_insert(hash_val, make_row(value), agg_func_, group_row));
+    return group_row;
+  }
+
+  static int64_t get_value(const ResultRow *row)
+  {
+    return row->at(0)->get_int();
+  }
+
+  static uint64_t make_hash(const int64_t partition_idx, const uint64_t low_bits)
+  {
+    return (static_cast<uint64_t>(partition_idx) << (64 - HashTable::PARTITION_BITS)) | low_bits;
+  }
+
+public:
+  ObArenaAllocator allocator_;
+  ObSEArray<ObProxyExpr*, 4> select_exprs_;
+  ObColInfoArray group_col_idxs_;
+  ObAggregateFunction agg_func_;
+  HashTable hash_table_;
+};
+
+TEST_F(TestHashTable, test_extend)
+{
+  const int64_t count = HashTable::PARTITION_INIT_BUCKET_COUNT * 16;
+  ResultRow *group_rows[count];
+
+  // all groups in one partition, it is extended several times
+  for (int64_t i = 0; i < count; ++i) {
+    group_rows[i] = insert(make_hash(3, i * 7), i);
+    ASSERT_TRUE(NULL != group_rows[i]);
+    ASSERT_EQ(i, get_value(group_rows[i]));
+    ASSERT_EQ(i + 1, hash_table_.size());
+  }
+
+  // the groups are still found after rehash
+  for (int64_t i = 0; i < count; ++i) {
+    ASSERT_EQ(group_rows[i], insert(make_hash(3, i * 7), i));
+  }
+  ASSERT_EQ(count, hash_table_.size());
+
+  ResultRows rows(array_new_alloc_size, allocator_);
+  ASSERT_EQ(OB_SUCCESS, hash_table_.get_all_rows(rows));
+  ASSERT_EQ(count, rows.count());
+  int64_t value_sum = 0;
+  for (int64_t i = 0; i < rows.count(); ++i) {
+    value_sum += get_value(rows.at(i));
+  }
+  ASSERT_EQ(count * (count - 1) / 2, value_sum);
+
+  hash_table_.reset();
+  ASSERT_EQ(0, hash_table_.size());
+  rows.reuse();
+  ASSERT_EQ(OB_SUCCESS, hash_table_.get_all_rows(rows));
+  ASSERT_EQ(0, rows.count());
+}
+
+TEST_F(TestHashTable, test_collision)
+{
+  const uint64_t last_bucket = HashTable::PARTITION_INIT_BUCKET_COUNT - 1;
+
+  // same hash value, different groups
+  ResultRow *row1 = insert(make_hash(0, last_bucket), 1);
+  ResultRow *row2 = insert(make_hash(0, last_bucket), 2);
+  ASSERT_NE(row1, row2);
+  ASSERT_EQ(2, get_value(row2));
+
+  // same bucket, different hash value, the probe wraps around to the first bucket
+  ResultRow *row3 = insert(make_hash(0, last_bucket + HashTable::PARTITION_INIT_BUCKET_COUNT), 3);
+  ASSERT_NE(row1, row3);
+  ASSERT_NE(row2, row3);
+  ASSERT_EQ(3, hash_table_.size());
+
+  // same group with the same hash value is found after probing
+  ASSERT_EQ(row1, insert(make_hash(0, last_bucket), 1));
+  ASSERT_EQ(row2, insert(make_hash(0, last_bucket), 2));
+  ASSERT_EQ(row3, insert(make_hash(0, last_bucket + HashTable::PARTITION_INIT_BUCKET_COUNT), 3));
+  // same group value with another hash value is another group
+  ASSERT_NE(row1, insert(make_hash(0, 0), 1));
+  ASSERT_EQ(4, hash_table_.size());
+
+  // all groups collide until extended
+  for (int64_t i = 10; i < 10 + HashTable::PARTITION_INIT_BUCKET_COUNT; ++i) {
+    ASSERT_EQ(i, get_value(insert(make_hash(0, last_bucket), i)));
+  }
+  ASSERT_EQ(row1, insert(make_hash(0, last_bucket), 1));
+  ASSERT_EQ(row2, insert(make_hash(0, last_bucket), 2));
+  ASSERT_EQ(4 + HashTable::PARTITION_INIT_BUCKET_COUNT, hash_table_.size());
+}
+
+TEST_F(TestHashTable, test_partition)
+{
+  // the smallest and largest hash value of each partition
+  for (int64_t i = HashTable::PARTITION_COUNT - 1; i >= 0; --i) {
+    ASSERT_TRUE(NULL != insert(make_hash(i, 0), i * 2));
+    ASSERT_TRUE(NULL != insert(make_hash(i, UINT64_MAX >> HashTable::PARTITION_BITS), i * 2 + 1));
+  }
+  ASSERT_EQ(HashTable::PARTITION_COUNT * 2, hash_table_.size());
+
+  // same value in adjacent partitions are different groups
+  ResultRow *row = insert(make_hash(1, 0), 2);
+  ASSERT_EQ(row, insert(make_hash(1, 0), 2));
+  ASSERT_NE(row, insert(make_hash(0, UINT64_MAX >> HashTable::PARTITION_BITS), 2));
+  ASSERT_EQ(HashTable::PARTITION_COUNT * 2 + 1, hash_table_.size());
+
+  // group rows are pushed back partition by partition
+  ResultRows rows(array_new_alloc_size, allocator_);
+  ASSERT_EQ(OB_SUCCESS, hash_table_.get_all_rows(rows));
+  ASSERT_EQ(HashTable::PARTITION_COUNT * 2 + 1, rows.count());
+  // partition 0 holds 0, 1 and the extra 2, partition i holds 2i and 2i+1
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_GE(2, get_value(rows.at(i)));
+  }
+  for (int64_t i = 3; i < rows.count(); ++i) {
+    ASSERT_EQ((i - 1) / 2, get_value(rows.at(i)) / 2);
+  }
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
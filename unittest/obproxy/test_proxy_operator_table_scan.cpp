@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "engine/ob_proxy_operator_table_scan.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obmysql;
+using namespace engine;
+
+static const int64_t NULL_KEY = INT64_MIN;
+static const int64_t BATCH_SIZE = 3;
+
+class TestTableScanTopn : public ::testing::Test
+{
+public:
+  TestTableScanTopn()
+    : allocator_(ObModIds::TEST), shard_rows_array_(array_new_alloc_size, allocator_) {}
+
+  // one shard of first round, the key is the only column
+  void add_shard(const int64_t *keys, const int64_t count)
+  {
+    ResultRows *rows = new (allocator_.alloc(sizeof(ResultRows))) ResultRows(array_new_alloc_size, allocator_);
+    for (int64_t i = 0; i < count; ++i) {
+      ResultRow *row = new (allocator_.alloc(sizeof(ResultRow))) ResultRow(array_new_alloc_size, allocator_);
+      ObObj *obj = new (allocator_.alloc(sizeof(ObObj))) ObObj();
+      if (NULL_KEY == keys[i]) {
+        obj->set_null();
+      } else {
+        obj->set_int(keys[i]);
+      }
+      ASSERT_EQ(OB_SUCCESS, row->push_back(obj));
+      ASSERT_EQ(OB_SUCCESS, rows->push_back(row));
+    }
+    ASSERT_EQ(OB_SUCCESS, shard_rows_array_.push_back(rows));
+  }
+
+  ObObj *calc_bound(const int64_t limit, const bool is_asc)
+  {
+    ObObj *bound = NULL;
+    EXPECT_EQ(OB_SUCCESS, ObProxyTableScanOp::calc_topn_bound(shard_rows_array_, 0, limit, is_asc, bound));
+    return bound;
+  }
+
+  bool need_requery(const int64_t shard_idx, const ObObj *bound, const bool is_asc)
+  {
+    return ObProxyTableScanOp::need_topn_requery(*shard_rows_array_.at(shard_idx), BATCH_SIZE,
+                                                 0, bound, is_asc);
+  }
+
+public:
+  ObArenaAllocator allocator_;
+  ObSEArray<ResultRows*, 4, ObIAllocator&> shard_rows_array_;
+};
+
+TEST_F(TestTableScanTopn, test_key_index)
+{
+  ResultFields fields(array_new_alloc_size, allocator_);
+  const char *names[] = {"id", "c1", "C2", ""};
+  for (int64_t i = 0; i < 4; ++i) {
+    ObMySQLField field;
+    field.org_cname_ = ObString::make_string(names[i]);
+    ASSERT_EQ(OB_SUCCESS, fields.push_back(field));
+  }
+
+  ObProxyExprShardingConst key_expr;
+  ObObj name_obj;
+  int64_t key_index = -1;
+  key_expr.set_is_column(true);
+
+  // the output index counts from the end of row
+  name_obj.set_varchar(ObString::make_string("t.c1"));
+  key_expr.set_object(name_obj);
+  key_expr.set_index(2);
+  ASSERT_EQ(OB_SUCCESS, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+  ASSERT_EQ(1, key_index);
+
+  // the column at the output index is another one, find the key by name
+  key_expr.set_index(3);
+  ASSERT_EQ(OB_SUCCESS, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+  ASSERT_EQ(1, key_index);
+  name_obj.set_varchar(ObString::make_string("`c2`"));
+  key_expr.set_object(name_obj);
+  key_expr.set_index(-1);
+  ASSERT_EQ(OB_SUCCESS, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+  ASSERT_EQ(2, key_index);
+
+  // expression column without original name is trusted by its output index
+  name_obj.set_varchar(ObString::make_string("c3"));
+  key_expr.set_object(name_obj);
+  key_expr.set_index(0);
+  ASSERT_EQ(OB_SUCCESS, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+  ASSERT_EQ(3, key_index);
+  key_expr.set_index(4);
+  ASSERT_EQ(OB_SUCCESS, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+  ASSERT_EQ(-1, key_index);
+
+  key_expr.set_is_column(false);
+  ASSERT_EQ(OB_INVALID_ARGUMENT, ObProxyTableScanOp::get_topn_key_index(&key_expr, fields, key_index));
+}
+
+TEST_F(TestTableScanTopn, test_asc_bound)
+{
+  const int64_t shard0[] = {1, 2, 3};
+  const int64_t shard1[] = {10, 11, 12};
+  const int64_t shard2[] = {0};
+  add_shard(shard0, 3);
+  add_shard(shard1, 3);
+  add_shard(shard2, 1);
+
+  // 0, 1, 2, 3, 10 ...
+  ObObj *bound = calc_bound(5, true);
+  ASSERT_TRUE(NULL != bound);
+  ASSERT_EQ(10, bound->get_int());
+  ASSERT_TRUE(need_requery(0, bound, true));
+  ASSERT_FALSE(need_requery(1, bound, true));
+  // a short batch is settled
+  ASSERT_FALSE(need_requery(2, bound, true));
+
+  // fewer rows than limit, no bound, all full shards are queried again
+  ASSERT_TRUE(NULL == calc_bound(8, true));
+  ASSERT_TRUE(need_requery(0, NULL, true));
+  ASSERT_TRUE(need_requery(1, NULL, true));
+  ASSERT_FALSE(need_requery(2, NULL, true));
+}
+
+TEST_F(TestTableScanTopn, test_desc_bound)
+{
+  const int64_t shard0[] = {12, 11, 10};
+  const int64_t shard1[] = {3, 2, 1};
+  add_shard(shard0, 3);
+  add_shard(shard1, 3);
+
+  // 12, 11, 10, 3
+  ObObj *bound = calc_bound(4, false);
+  ASSERT_TRUE(NULL != bound);
+  ASSERT_EQ(3, bound->get_int());
+  ASSERT_TRUE(need_requery(0, bound, false));
+  ASSERT_FALSE(need_requery(1, bound, false));
+}
+
+TEST_F(TestTableScanTopn, test_tie_bound)
+{
+  const int64_t shard0[] = {1, 2, 2};
+  const int64_t shard1[] = {2, 2, 2};
+  const int64_t shard2[] = {1, 1, 1};
+  add_shard(shard0, 3);
+  add_shard(shard1, 3);
+  add_shard(shard2, 3);
+
+  // 1, 1, 1, 1, 2 ..., the shards ending with the bound have enough rows
+  ObObj *bound = calc_bound(5, true);
+  ASSERT_EQ(2, bound->get_int());
+  ASSERT_FALSE(need_requery(0, bound, true));
+  ASSERT_FALSE(need_requery(1, bound, true));
+  ASSERT_TRUE(need_requery(2, bound, true));
+
+  bound = calc_bound(4, true);
+  ASSERT_EQ(1, bound->get_int());
+  ASSERT_FALSE(need_requery(2, bound, true));
+}
+
+TEST_F(TestTableScanTopn, test_desc_tie_bound)
+{
+  const int64_t shard0[] = {5, 5, 5};
+  const int64_t shard1[] = {6, 5, 5};
+  const int64_t shard2[] = {9, 8, 7};
+  add_shard(shard0, 3);
+  add_shard(shard1, 3);
+  add_shard(shard2, 3);
+
+  // 9, 8, 7, 6, 5 ...
+  ObObj *bound = calc_bound(5, false);
+  ASSERT_EQ(5, bound->get_int());
+  ASSERT_FALSE(need_requery(0, bound, false));
+  ASSERT_FALSE(need_requery(1, bound, false));
+  ASSERT_TRUE(need_requery(2, bound, false));
+}
+
+TEST_F(TestTableScanTopn, test_null_key)
+{
+  const int64_t shard0[] = {NULL_KEY, 1, 2};
+  const int64_t shard1[] = {3, 4, 5};
+  const int64_t shard2[] = {NULL_KEY};
+  add_shard(shard0, 3);
+  add_shard(shard1, 3);
+  add_shard(shard2, 1);
+
+  // proxy does not compare null as server does, no bound
+  ASSERT_TRUE(NULL == calc_bound(2, true));
+  ASSERT_TRUE(NULL == calc_bound(2, false));
+  ASSERT_TRUE(need_requery(0, NULL, true));
+  ASSERT_TRUE(need_requery(1, NULL, false));
+  ASSERT_FALSE(need_requery(2, NULL, true));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -220,6 +220,52 @@ TEST_F(TestProxySessionInfo, extract_variable_reset_sql_func)
   ASSERT_EQ(sql_reset, ObString::make_string("SET @@tx_isolation = 'READ-COMMITTED', @yyy = 0;"));
 
 }
+
+TEST_F(TestProxySessionInfo, cursor_prefetch_buf)
+{
+  ObCursorIdAddr cursor_id_addr;
+  char *pkt_buf = NULL;
+  const char *row_buf = NULL;
+  int64_t pkt_len = 0;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, cursor_id_addr.alloc_prefetch_row(2, pkt_buf));
+  ASSERT_EQ(OB_ENTRY_NOT_EXIST, cursor_id_addr.pop_prefetch_row(row_buf, pkt_len));
+
+  // rows of payload 100, 200, 300, ..., pop some while pushing to make the buffer compact and grow
+  int64_t pushed = 0;
+  int64_t popped = 0;
+  for (int64_t i = 1; i <= 64; ++i) {
+    const int64_t payload_len = i * 100;
+    ASSERT_EQ(OB_SUCCESS, cursor_id_addr.alloc_prefetch_row(payload_len + 4, pkt_buf));
+    pkt_buf[0] = static_cast<char>(payload_len & 0xFF);
+    pkt_buf[1] = static_cast<char>((payload_len >> 8) & 0xFF);
+    pkt_buf[2] = 0;
+    pkt_buf[3] = static_cast<char>(i);
+    memset(pkt_buf + 4, static_cast<int>(i), payload_len);
+    ++pushed;
+    if (0 == i % 3) {
+      ASSERT_EQ(OB_SUCCESS, cursor_id_addr.pop_prefetch_row(row_buf, pkt_len));
+      ++popped;
+      ASSERT_EQ(popped * 100 + 4, pkt_len);
+      ASSERT_EQ(static_cast<char>(popped), row_buf[3]);
+      ASSERT_EQ(static_cast<char>(popped), row_buf[pkt_len - 1]);
+    }
+  }
+  ASSERT_EQ(pushed - popped, cursor_id_addr.get_prefetch_row_count());
+  while (cursor_id_addr.has_prefetch_rows()) {
+    ASSERT_EQ(OB_SUCCESS, cursor_id_addr.pop_prefetch_row(row_buf, pkt_len));
+    ++popped;
+    ASSERT_EQ(popped * 100 + 4, pkt_len);
+    ASSERT_EQ(static_cast<char>(popped), row_buf[4]);
+  }
+  ASSERT_EQ(pushed, popped);
+  ASSERT_EQ(0, cursor_id_addr.get_prefetch_len());
+
+  ASSERT_EQ(OB_SUCCESS, cursor_id_addr.alloc_prefetch_head(10, pkt_buf));
+  ASSERT_EQ(10, cursor_id_addr.get_prefetch_head_len());
+  cursor_id_addr.reset_prefetch();
+  ASSERT_EQ(0, cursor_id_addr.get_prefetch_head_len());
+  ASSERT_TRUE(NULL == cursor_id_addr.prefetch_buf_);
+}
 }//end of obproxy
 }//end of oceanbase
 
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "opsql/func_expr_parser/ob_func_expr_parser.h"
+#include "opsql/func_expr_resolver/ob_func_expr_resolver.h"
+#include "opsql/func_expr_resolver/proxy_expr/ob_proxy_shard_rule_evaluator.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+using namespace opsql;
+using namespace dbconfig;
+
+static const char *COLUMN_NAME = "user_id";
+
+struct RuleCase
+{
+  const char *rule_;
+  // number arithmetic on string value is left to expr
+  bool has_arith_;
+};
+
+struct ValueCase
+{
+  bool is_int_;
+  int64_t int_value_;
+  const char *str_value_;
+};
+
+static const RuleCase RULES[] = {
+  {"hash(user_id)", false},
+  {"hash(user_id, 16)", false},
+  {"hash(user_id, 0)", false},
+  {"hash(user_id, -5)", false},
+  {"hash(substr(user_id, 2, 3))", false},
+  {"hash(substr(user_id, 2))", false},
+  {"hash(substr(user_id, -3), 16)", false},
+  {"hash(substr(user_id, 2, 0))", false},
+  {"toint(substr(user_id, 2))", false},
+  {"hash(toint(substr(user_id, -2)))", false},
+  {"div(user_id, 10)", true},
+  {"div(user_id, 0)", true},
+  {"hash(div(user_id, 100), 8)", true},
+};
+
+static const ValueCase VALUES[] = {
+  {true, 0, NULL},
+  {true, 7, NULL},
+  {true, 123456789, NULL},
+  {true, -1, NULL},
+  {true, -17, NULL},
+  {true, -123456789, NULL},
+  {false, 0, "123456"},
+  {false, 0, "-42"},
+  {false, 0, "abc123"},
+  {false, 0, "0012"},
+  {false, 0, "x"},
+};
+
+static const int64_t PHYSIC_SIZES[] = {16, 100, 3, 0};
+
+static const ObTestLoadType TESTLOAD_TYPES[] = {
+  TESTLOAD_NON, TESTLOAD_ALIPAY, TESTLOAD_MIRROR, TESTLOAD_ALIPAY_COMPATIBLE, TESTLOAD_MIRROR_COMPATIBLE
+};
+
+class TestShardRuleEvaluator : public ::testing::Test
+{
+public:
+  TestShardRuleEvaluator() : allocator_(ObModIds::TEST) {}
+
+  // the same way as dbconfig loads the shard rule
+  void compile(const char *rule, ObProxyExpr *&expr, ObProxyShardRuleEvaluator *&evaluator)
+  {
+    ObArenaAllocator parser_allocator(ObModIds::TEST);
+    ObFuncExprParser parser(parser_allocator, SHARDING_EXPR_FUNC_PARSE_MODE);
+    ObFuncExprParseResult result;
+    ObProxyExprFactory factory(allocator_);
+    ObFuncExprResolverContext ctx(&allocator_, &factory);
+    ObFuncExprResolver resolver(ctx);
+    expr = NULL;
+    evaluator = NULL;
+    ASSERT_EQ(OB_SUCCESS, parser.parse(ObString::make_string(rule), result)) << rule;
+    ASSERT_EQ(OB_SUCCESS, resolver.resolve(result.param_node_, expr)) << rule;
+    ASSERT_EQ(OB_SUCCESS, ObProxyShardRuleEvaluator::compile(expr, allocator_, evaluator)) << rule;
+    ASSERT_TRUE(NULL != evaluator) << rule;
+  }
+
+  static void add_value(SqlField &field, const ValueCase &value)
+  {
+    SqlColumnValue column_value;
+    if (value.is_int_) {
+      column_value.value_type_ = TOKEN_INT_VAL;
+      column_value.column_int_value_ = value.int_value_;
+      column_value.column_value_.set_integer(value.int_value_);
+    } else {
+      column_value.value_type_ = TOKEN_STR_VAL;
+      column_value.column_value_.set(ObString::make_string(value.str_value_));
+    }
+    ASSERT_EQ(OB_SUCCESS, field.column_values_.push_back(column_value));
+  }
+
+  // testload modifies string value in place, every calc has its own sql result
+  static void build_sql_result(const ValueCase *values, const int64_t count, SqlFieldResult &sql_result)
+  {
+    SqlField field;
+    sql_result.reset();
+    field.column_name_.set(ObString::make_string(COLUMN_NAME));
+    for (int64_t i = 0; i < count; ++i) {
+      add_value(field, values[i]);
+    }
+    ASSERT_EQ(OB_SUCCESS, sql_result.fields_.push_back(field));
+    sql_result.field_num_ = 1;
+  }
+
+  // as ObShardRule::get_physic_index does with the expr
+  int calc_by_expr(ObProxyExpr *expr, const ValueCase *values, const int64_t count,
+                   const int64_t physic_size, const ObTestLoadType type, const bool is_elastic_index,
+                   ObIArray<int64_t> &index_array)
+  {
+    int ret = OB_SUCCESS;
+    SqlFieldResult sql_result;
+    ObSEArray<ObObj, 4> result_array;
+    build_sql_result(values, count, sql_result);
+    ObProxyExprCtx expr_ctx(physic_size, type, is_elastic_index, &allocator_);
+    ObProxyExprCalcItem calc_item(&sql_result);
+    if (OB_SUCC(expr->calc(expr_ctx, calc_item, result_array))) {
+      for (int64_t i = 0; OB_SUCC(ret) && i < result_array.count(); ++i) {
+        ObObj tmp_obj;
+        int64_t index = -1;
+        if (OB_SUCC(ObProxyFuncExpr::get_int_obj(result_array.at(i), tmp_obj))
+            && OB_SUCC(tmp_obj.get_int(index))) {
+          ret = index_array.push_back(index);
+        }
+      }
+    }
+    return ret;
+  }
+
+  int calc_by_evaluator(ObProxyShardRuleEvaluator *evaluator, const ValueCase *values, const int64_t count,
+                        const int64_t physic_size, const ObTestLoadType type, const bool is_elastic_index,
+                        ObIArray<int64_t> &index_array)
+  {
+    SqlFieldResult sql_result;
+    build_sql_result(values, count, sql_result);
+    ObProxyShardRuleEvaluator::ObProxyShardRuleCalcCtx rule_ctx(physic_size, type, is_elastic_index);
+    return evaluator->calc_index_array(sql_result, rule_ctx, index_array);
+  }
+
+  void check_same(const RuleCase &rule_case, ObProxyExpr *expr, ObProxyShardRuleEvaluator *evaluator,
+                  const ValueCase *values, const int64_t count, const int64_t physic_size,
+                  const ObTestLoadType type, const bool is_elastic_index)
+  {
+    ObSEArray<int64_t, 4> expr_array;
+    ObSEArray<int64_t, 4> evaluator_array;
+    const int expr_ret = calc_by_expr(expr, values, count, physic_size, type, is_elastic_index, expr_array);
+    const int evaluator_ret = calc_by_evaluator(evaluator, values, count, physic_size, type,
+                                                is_elastic_index, evaluator_array);
+    bool has_str = false;
+    for (int64_t i = 0; i < count; ++i) {
+      has_str = has_str || !values[i].is_int_;
+    }
+    const char *value = values[0].is_int_ ? "int" : values[0].str_value_;
+    if (OB_NOT_SUPPORTED == evaluator_ret) {
+      ASSERT_TRUE(rule_case.has_arith_ && has_str) << rule_case.rule_ << " " << value;
+    } else {
+      ASSERT_EQ(expr_ret, evaluator_ret) << rule_case.rule_ << " " << value << " " << values[0].int_value_
+                                         << " size " << physic_size << " type " << type
+                                         << " elastic " << is_elastic_index;
+      if (OB_SUCCESS == expr_ret) {
+        ASSERT_EQ(expr_array.count(), evaluator_array.count()) << rule_case.rule_;
+        for (int64_t i = 0; i < expr_array.count(); ++i) {
+          ASSERT_EQ(expr_array.at(i), evaluator_array.at(i)) << rule_case.rule_ << " " << value << " "
+                                                             << values[0].int_value_ << " size " << physic_size
+                                                             << " type " << type
+                                                             << " elastic " << is_elastic_index;
+        }
+      }
+    }
+  }
+
+public:
+  ObArenaAllocator allocator_;
+};
+
+TEST_F(TestShardRuleEvaluator, test_same_as_expr)
+{
+  const int64_t rule_count = sizeof(RULES) / sizeof(RULES[0]);
+  const int64_t value_count = sizeof(VALUES) / sizeof(VALUES[0]);
+  for (int64_t r = 0; r < rule_count; ++r) {
+    ObProxyExpr *expr = NULL;
+    ObProxyShardRuleEvaluator *evaluator = NULL;
+    compile(RULES[r].rule_, expr, evaluator);
+    for (int64_t v = 0; v < value_count; ++v) {
+      for (int64_t s = 0; s < static_cast<int64_t>(sizeof(PHYSIC_SIZES) / sizeof(PHYSIC_SIZES[0])); ++s) {
+        for (int64_t t = 0; t < static_cast<int64_t>(sizeof(TESTLOAD_TYPES) / sizeof(TESTLOAD_TYPES[0])); ++t) {
+          check_same(RULES[r], expr, evaluator, &VALUES[v], 1, PHYSIC_SIZES[s], TESTLOAD_TYPES[t], false);
+          check_same(RULES[r], expr, evaluator, &VALUES[v], 1, PHYSIC_SIZES[s], TESTLOAD_TYPES[t], true);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(TestShardRuleEvaluator, test_multi_value)
+{
+  const ValueCase values[] = {{true, 7, NULL}, {true, -17, NULL}, {false, 0, "abc123"}};
+  const int64_t rule_count = sizeof(RULES) / sizeof(RULES[0]);
+  for (int64_t r = 0; r < rule_count; ++r) {
+    ObProxyExpr *expr = NULL;
+    ObProxyShardRuleEvaluator *evaluator = NULL;
+    compile(RULES[r].rule_, expr, evaluator);
+    check_same(RULES[r], expr, evaluator, values, 3, 16, TESTLOAD_NON, false);
+    check_same(RULES[r], expr, evaluator, values, 3, 16, TESTLOAD_ALIPAY, false);
+    check_same(RULES[r], expr, evaluator, values, 3, 16, TESTLOAD_NON, true);
+  }
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
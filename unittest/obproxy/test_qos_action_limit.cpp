@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "qos/ob_proxy_qos_action.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace qos;
+
+static const int64_t THREAD_COUNT = 4;
+static const ObHRTime RUN_TIME = HRTIME_SECOND;
+
+struct TestLimitCaller
+{
+  ObProxyQosActionLimit *limit_;
+  ObHRTime end_time_;
+  int64_t pass_count_;
+  int64_t call_count_;
+};
+
+static int64_t drain_bucket(ObProxyQosActionLimit &limit)
+{
+  int64_t pass_count = 0;
+  bool is_pass = true;
+  while (is_pass) {
+    EXPECT_EQ(OB_SUCCESS, limit.calc(is_pass));
+    pass_count += is_pass ? 1 : 0;
+  }
+  return pass_count;
+}
+
+static void *call_limit(void *arg)
+{
+  TestLimitCaller *caller = static_cast<TestLimitCaller *>(arg);
+  bool is_pass = false;
+  while (get_hrtime_internal() < caller->end_time_) {
+    for (int64_t i = 0; i < 100; ++i) {
+      caller->limit_->calc(is_pass);
+      caller->pass_count_ += is_pass ? 1 : 0;
+    }
+    caller->call_count_ += 100;
+  }
+  return NULL;
+}
+
+TEST(TestQosActionLimit, test_burst)
+{
+  ObProxyQosActionLimit zero_limit;
+  bool is_pass = true;
+  zero_limit.set_limit_qps(0);
+  ASSERT_EQ(OB_SUCCESS, zero_limit.calc(is_pass));
+  ASSERT_FALSE(is_pass);
+
+  // a full bucket holds the tokens of one second
+  ObProxyQosActionLimit limit;
+  limit.set_limit_qps(100);
+  ASSERT_LE(100, drain_bucket(limit));
+  const ObHRTime drain_time = get_hrtime_internal();
+  ASSERT_GE(1, drain_bucket(limit));
+
+  // one token every 10ms
+  usleep(50 * 1000);
+  const int64_t pass_count = drain_bucket(limit);
+  ASSERT_LE(4, pass_count);
+  ASSERT_GE((get_hrtime_internal() - drain_time) / (10 * HRTIME_MSECOND) + 1, pass_count);
+}
+
+TEST(TestQosActionLimit, test_multi_thread_qps)
+{
+  const int64_t limit_qps = 500000;
+  ObProxyQosActionLimit limit;
+  limit.set_limit_qps(limit_qps);
+  drain_bucket(limit);
+
+  TestLimitCaller callers[THREAD_COUNT];
+  pthread_t tids[THREAD_COUNT];
+  const ObHRTime start_time = get_hrtime_internal();
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    callers[i].limit_ = &limit;
+    callers[i].end_time_ = start_time + RUN_TIME;
+    callers[i].pass_count_ = 0;
+    callers[i].call_count_ = 0;
+    pthread_create(&tids[i], NULL, call_limit, &callers[i]);
+  }
+
+  int64_t pass_count = 0;
+  int64_t call_count = 0;
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    pthread_join(tids[i], NULL);
+    pass_count += callers[i].pass_count_;
+    call_count += callers[i].call_count_;
+  }
+  const ObHRTime cost = get_hrtime_internal() - start_time;
+  const int64_t expect_count = limit_qps * cost / HRTIME_SECOND;
+
+  printf("limit qps:%ld, thread count:%ld, pass count:%ld, call count:%ld, cost per call:%ldns\n",
+         limit_qps, THREAD_COUNT, pass_count, call_count,
+         cost * THREAD_COUNT / (call_count > 0 ? call_count : 1));
+  ASSERT_GE(expect_count * 105 / 100, pass_count);
+  if (call_count > expect_count * 2) {
+    ASSERT_LE(expect_count * 95 / 100, pass_count);
+  }
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
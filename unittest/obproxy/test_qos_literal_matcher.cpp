@@ -0,0 +1,187 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "qos/ob_proxy_qos_literal_matcher.h"
+#include "common/expression/ob_expr_regexp_context.h"
+#include "lib/allocator/page_arena.h"
+#include "lib/time/ob_time_utility.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace qos;
+
+TEST(TestQosLiteralMatcher, test_extract_regex_literal)
+{
+  const char *cases[][2] = {
+    {"select .* from t1", " from t1"},
+    {"^UPDATE\\s+users SET", "users set"},
+    {"abc\\.def*g", "abc.de"},
+    {"fo{2}bar", "bar"},
+    {"x(a|b)yz", "yz"},
+    {"[a-z]+_tbl", "_tbl"},
+    {"[]abc]xyz", "xyz"},
+    {"delete[[:space:]]+from", "delete"},
+    {"a|b", ""},
+    {"(?i)select", ""},
+    {"***=select", ""},
+    {"\\x41bc", ""},
+    {"(unbalanced", ""},
+  };
+  ObArenaAllocator allocator;
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(cases) / sizeof(cases[0])); ++i) {
+    ObString literal;
+    ASSERT_EQ(OB_SUCCESS, ObProxyQosLiteralMatcher::extract_regex_literal(
+        ObString::make_string(cases[i][0]), allocator, literal));
+    ASSERT_EQ(ObString::make_string(cases[i][1]), literal) << cases[i][0];
+  }
+}
+
+TEST(TestQosLiteralMatcher, test_match)
+{
+  ObArenaAllocator allocator;
+  ObProxyQosLiteralMatcher matcher;
+  const char *literals[] = {"he", "she", "his", "hers", "where", "like"};
+  int64_t literal_id = -1;
+  ASSERT_EQ(OB_SUCCESS, matcher.init(allocator));
+  for (int64_t i = 0; i < 6; ++i) {
+    ASSERT_EQ(OB_SUCCESS, matcher.add_literal(ObString::make_string(literals[i]), literal_id));
+    ASSERT_EQ(i, literal_id);
+  }
+  ASSERT_EQ(OB_SUCCESS, matcher.add_literal(ObString::make_string("SHE"), literal_id));
+  ASSERT_EQ(1, literal_id);
+  ASSERT_EQ(OB_SUCCESS, matcher.build());
+  ASSERT_TRUE(matcher.is_built());
+  ASSERT_NE(OB_SUCCESS, matcher.add_literal(ObString::make_string("new"), literal_id));
+
+  uint64_t hits[ObProxyQosLiteralMatcher::HIT_WORD_COUNT];
+  MEMSET(hits, 0, sizeof(hits));
+  matcher.match(ObString::make_string("USHERS"), hits);
+  ASSERT_EQ(0xbUL, hits[0]);
+
+  ObProxyQosMatchContext match_ctx(matcher, ObString::make_string("select * from t1 Where c1 LIKE 'a%'"));
+  ASSERT_TRUE(match_ctx.is_valid_literal(4));
+  ASSERT_FALSE(match_ctx.is_valid_literal(6));
+  ASSERT_TRUE(match_ctx.has_literal(4));
+  ASSERT_TRUE(match_ctx.has_literal(5));
+  ASSERT_FALSE(match_ctx.has_literal(2));
+}
+
+TEST(TestQosLiteralMatcher, test_prefilter_100_rules)
+{
+  static const int64_t RULE_COUNT = 100;
+  static const int64_t SQL_COUNT = 1000;
+  ObArenaAllocator allocator;
+  ObArenaAllocator calc_allocator;
+  ObProxyQosLiteralMatcher matcher;
+  ObExprRegexContext regexes[RULE_COUNT];
+  int64_t literal_ids[RULE_COUNT];
+  char buf[256];
+
+  ASSERT_EQ(OB_SUCCESS, matcher.init(allocator));
+  for (int64_t i = 0; i < RULE_COUNT; ++i) {
+    switch (i % 4) {
+      case 0:
+        snprintf(buf, sizeof(buf), "^select .* from t_%ld where", i);
+        break;
+      case 1:
+        snprintf(buf, sizeof(buf), "update t_%ld set c[0-9]+ =", i);
+        break;
+      case 2:
+        snprintf(buf, sizeof(buf), "delete from t_%ld ", i);
+        break;
+      default:
+        snprintf(buf, sizeof(buf), "insert into t_%ld\\(", i);
+        break;
+    }
+    ObString regex = ObString::make_string(buf);
+    ObString literal;
+    ASSERT_EQ(OB_SUCCESS, regexes[i].init(regex, OB_REG_ICASE, allocator));
+    ASSERT_EQ(OB_SUCCESS, ObProxyQosLiteralMatcher::extract_regex_literal(regex, allocator, literal));
+    ASSERT_FALSE(literal.empty());
+    ASSERT_EQ(OB_SUCCESS, matcher.add_literal(literal, literal_ids[i]));
+  }
+  ASSERT_EQ(OB_SUCCESS, matcher.build());
+
+  char *sqls[SQL_COUNT];
+  for (int64_t i = 0; i < SQL_COUNT; ++i) {
+    const int64_t table_id = (i * 7) % (RULE_COUNT * 2);
+    switch (i % 4) {
+      case 0:
+        snprintf(buf, sizeof(buf), "SELECT c1, c2 FROM t_%ld WHERE c1 = %ld AND c2 LIKE 'abc%%'", table_id, i);
+        break;
+      case 1:
+        snprintf(buf, sizeof(buf), "UPDATE t_%ld SET c2 = %ld WHERE c1 = %ld", table_id, i, i);
+        break;
+      case 2:
+        snprintf(buf, sizeof(buf), "DELETE FROM t_%ld WHERE c1 IN (%ld, %ld)", table_id, i, i + 1);
+        break;
+      default:
+        snprintf(buf, sizeof(buf), "INSERT INTO t_%ld(c1, c2) VALUES (%ld, 'xyz')", table_id, i);
+        break;
+    }
+    sqls[i] = static_cast<char *>(allocator.alloc(strlen(buf) + 1));
+    ASSERT_TRUE(NULL != sqls[i]);
+    MEMCPY(sqls[i], buf, strlen(buf) + 1);
+  }
+
+  // every rule runs its regex on every sql
+  int64_t regex_match_count = 0;
+  int64_t start_time = ObTimeUtility::current_time();
+  for (int64_t i = 0; i < SQL_COUNT; ++i) {
+    ObString sql = ObString::make_string(sqls[i]);
+    for (int64_t j = 0; j < RULE_COUNT; ++j) {
+      bool is_match = false;
+      ASSERT_EQ(OB_SUCCESS, regexes[j].match(sql, 0, is_match, calc_allocator));
+      regex_match_count += is_match ? 1 : 0;
+    }
+    calc_allocator.reset();
+  }
+  const int64_t regex_cost = ObTimeUtility::current_time() - start_time;
+
+  // one scan per sql, the regex only runs on the rules whose literal is hit
+  int64_t prefilter_match_count = 0;
+  int64_t confirm_count = 0;
+  start_time = ObTimeUtility::current_time();
+  for (int64_t i = 0; i < SQL_COUNT; ++i) {
+    ObString sql = ObString::make_string(sqls[i]);
+    ObProxyQosMatchContext match_ctx(matcher, sql);
+    for (int64_t j = 0; j < RULE_COUNT; ++j) {
+      bool is_match = false;
+      if (match_ctx.has_literal(literal_ids[j])) {
+        ++confirm_count;
+        ASSERT_EQ(OB_SUCCESS, regexes[j].match(sql, 0, is_match, calc_allocator));
+      }
+      prefilter_match_count += is_match ? 1 : 0;
+    }
+    calc_allocator.reset();
+  }
+  const int64_t prefilter_cost = ObTimeUtility::current_time() - start_time;
+
+  ASSERT_EQ(regex_match_count, prefilter_match_count);
+  printf("rule count:%ld, sql count:%ld, match count:%ld, regex cost:%ldus, "
+         "prefilter cost:%ldus, regex confirm count:%ld, state count:%ld\n",
+         RULE_COUNT, SQL_COUNT, regex_match_count, regex_cost,
+         prefilter_cost, confirm_count, matcher.get_state_count());
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,228 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <sys/resource.h>
+#include "obutils/ob_server_prober.h"
+#include "obutils/ob_congestion_entry.h"
+#include "obutils/ob_proxy_config.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace net;
+using namespace obutils;
+
+static const int64_t PROBE_TIMEOUT_US = 200 * 1000;
+
+// a local server accepts conn_count_ connections, the first silent_count_
+// ones get no handshake packet, and each is held until the prober closes it
+struct ObProbeListener
+{
+  ObProbeListener() : fd_(-1), conn_count_(0), silent_count_(0), tid_()
+  {
+    memset(&addr_, 0, sizeof(addr_));
+  }
+
+  void start(const int64_t conn_count, const int64_t silent_count, const bool is_listen = true)
+  {
+    socklen_t len = sizeof(addr_);
+    addr_.sin_family = AF_INET;
+    addr_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr_.sin_port = 0;
+    conn_count_ = conn_count;
+    silent_count_ = silent_count;
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_LE(0, fd_);
+    ASSERT_EQ(0, ::bind(fd_, reinterpret_cast<sockaddr *>(&addr_), sizeof(addr_)));
+    ASSERT_EQ(0, ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr_), &len));
+    if (is_listen) {
+      ASSERT_EQ(0, ::listen(fd_, 16));
+      ASSERT_EQ(0, pthread_create(&tid_, NULL, serve, this));
+    } else {
+      // nobody listens on the port, connect is refused
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  void stop()
+  {
+    if (fd_ >= 0) {
+      pthread_join(tid_, NULL);
+      ::close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  static void *serve(void *arg)
+  {
+    ObProbeListener *listener = static_cast<ObProbeListener *>(arg);
+    // a mysql handshake packet header and protocol version
+    const char handshake[] = {0x4a, 0x00, 0x00, 0x00, 0x0a};
+    char buf[16];
+    for (int64_t i = 0; i < listener->conn_count_; ++i) {
+      int fd = ::accept(listener->fd_, NULL, NULL);
+      if (fd >= 0) {
+        if (i >= listener->silent_count_) {
+          (void)::write(fd, handshake, sizeof(handshake));
+        }
+        while (::read(fd, buf, sizeof(buf)) > 0) {
+        }
+        ::close(fd);
+      }
+    }
+    return NULL;
+  }
+
+  int fd_;
+  int64_t conn_count_;
+  int64_t silent_count_;
+  pthread_t tid_;
+  sockaddr_in addr_;
+};
+
+class TestServerProber : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    prober_ = new ObServerProber();
+    listener_count_ = 0;
+  }
+
+  virtual void TearDown()
+  {
+    for (int64_t i = 0; i < listener_count_; ++i) {
+      listeners_[i].stop();
+    }
+    delete prober_;
+    for (int64_t i = 0; i < listener_count_; ++i) {
+      entries_[i]->dec_ref();
+    }
+  }
+
+  ObCongestionEntry *add_server(const int64_t conn_count, const int64_t silent_count,
+                                const bool is_listen = true)
+  {
+    ObProbeListener &listener = listeners_[listener_count_];
+    listener.start(conn_count, silent_count, is_listen);
+    ObIpEndpoint ip(*reinterpret_cast<sockaddr *>(&listener.addr_));
+    ObCongestionEntry *entry = op_alloc_args(ObCongestionEntry, ip);
+    // held by the test
+    entry->inc_ref();
+    entries_[listener_count_++] = entry;
+    return entry;
+  }
+
+  // as do_probe_task does with the collected entries
+  void probe_round(const int64_t failure_threshold)
+  {
+    for (int64_t i = 0; i < listener_count_; ++i) {
+      entries_[i]->inc_ref();
+      ASSERT_EQ(OB_SUCCESS, prober_->entries_.push_back(entries_[i]));
+    }
+    ASSERT_EQ(OB_SUCCESS, prober_->probe_servers(listener_count_, PROBE_TIMEOUT_US));
+    prober_->finish_probes(listener_count_, failure_threshold);
+    ASSERT_TRUE(prober_->entries_.empty());
+  }
+
+public:
+  ObServerProber *prober_;
+  ObProbeListener listeners_[4];
+  ObCongestionEntry *entries_[4];
+  int64_t listener_count_;
+};
+
+TEST_F(TestServerProber, test_start_if_enabled)
+{
+  // no probe thread nor task while enable_server_probe is off
+  ASSERT_FALSE(get_global_proxy_config().enable_server_probe);
+  ASSERT_EQ(OB_SUCCESS, prober_->start_if_enabled());
+  ASSERT_TRUE(NULL == prober_->probe_cont_);
+  ASSERT_FALSE(prober_->is_thread_spawned_);
+  ASSERT_FALSE(prober_->is_starting_);
+}
+
+TEST_F(TestServerProber, test_probe)
+{
+  ObCongestionEntry *alive = add_server(1, 0);
+  ObCongestionEntry *silent = add_server(1, 1);
+  ObCongestionEntry *refused = add_server(0, 0, false);
+
+  // every probe failure counts, but they are under the threshold
+  probe_round(2);
+  ASSERT_EQ(0, alive->probe_fail_count_);
+  ASSERT_EQ(1, silent->probe_fail_count_);
+  ASSERT_EQ(1, refused->probe_fail_count_);
+  ASSERT_FALSE(alive->is_dead_congested());
+  ASSERT_FALSE(silent->is_dead_congested());
+  ASSERT_FALSE(refused->is_dead_congested());
+}
+
+TEST_F(TestServerProber, test_dead_and_recover)
+{
+  // the server holds the first two connections without handshake, and answers the third
+  ObCongestionEntry *entry = add_server(3, 2);
+
+  probe_round(2);
+  ASSERT_EQ(1, entry->probe_fail_count_);
+  ASSERT_FALSE(entry->is_dead_congested());
+  probe_round(2);
+  ASSERT_EQ(2, entry->probe_fail_count_);
+  ASSERT_TRUE(entry->is_dead_congested());
+  ASSERT_EQ(1, entry->probe_dead_congested_);
+
+  // freed by the first succeeded probe
+  probe_round(2);
+  ASSERT_EQ(0, entry->probe_fail_count_);
+  ASSERT_FALSE(entry->is_dead_congested());
+  ASSERT_EQ(0, entry->probe_dead_congested_);
+}
+
+TEST_F(TestServerProber, test_local_failure)
+{
+  ObCongestionEntry *entry = add_server(0, 0, false);
+
+  // no fd left for the probe connection, the refused server gets no verdict
+  struct rlimit old_limit;
+  struct rlimit limit;
+  ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &old_limit));
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_LE(0, fd);
+  ::close(fd);
+  limit = old_limit;
+  limit.rlim_cur = fd;
+  ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &limit));
+  probe_round(1);
+  ASSERT_EQ(0, setrlimit(RLIMIT_NOFILE, &old_limit));
+  ASSERT_EQ(0, entry->probe_fail_count_);
+  ASSERT_FALSE(entry->is_dead_congested());
+
+  probe_round(1);
+  ASSERT_EQ(1, entry->probe_fail_count_);
+  ASSERT_TRUE(entry->is_dead_congested());
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#define protected public
+#include <gtest/gtest.h>
+#include "proxy/mysql/ob_mysql_client_session.h"
+#include "proxy/mysql/ob_mysql_server_session.h"
+#include "proxy/mysql/ob_prepare_statement_struct.h"
+#include "obutils/ob_proxy_config.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace proxy;
+using namespace obutils;
+
+class TestServerSessionMultiplex : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    get_global_proxy_config().enable_server_session_multiplex = true;
+    client_session1_.cs_id_ = 1;
+    client_session2_.cs_id_ = 2;
+    server_session_.is_pool_session_ = true;
+  }
+
+  virtual void TearDown()
+  {
+    get_global_proxy_config().enable_server_session_multiplex = false;
+    server_session_.session_info_.reset();
+  }
+
+  void add_ps(const uint32_t client_ps_id, const uint32_t server_ps_id)
+  {
+    ObPsIdPair *ps_id_pair = NULL;
+    ASSERT_EQ(OB_SUCCESS, ObPsIdPair::alloc_ps_id_pair(client_ps_id, server_ps_id, ps_id_pair));
+    ASSERT_EQ(OB_SUCCESS, server_session_.session_info_.add_ps_id_pair(ps_id_pair));
+  }
+
+public:
+  ObMysqlClientSession client_session1_;
+  ObMysqlClientSession client_session2_;
+  ObMysqlServerSession server_session_;
+};
+
+TEST_F(TestServerSessionMultiplex, test_rebind_clean_session)
+{
+  ObServerSessionInfo &info = server_session_.session_info_;
+  server_session_.set_client_session(client_session1_);
+  ASSERT_FALSE(info.has_client_state());
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+
+  // statement prepared and closed by client 1, nothing left on server
+  add_ps(1, 100);
+  ASSERT_TRUE(server_session_.is_bound_to_client());
+  info.remove_ps_id_pair(1);
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+
+  server_session_.set_client_session(client_session2_);
+  ASSERT_EQ(&client_session2_, server_session_.get_client_session());
+  ASSERT_EQ(2U, server_session_.last_cs_id_);
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+}
+
+TEST_F(TestServerSessionMultiplex, test_rebind_prepared_statement)
+{
+  ObServerSessionInfo &info = server_session_.session_info_;
+  server_session_.set_client_session(client_session1_);
+  add_ps(1, 100);
+  add_ps(2, 101);
+  ASSERT_EQ(OB_SUCCESS, info.add_text_ps_name(7));
+
+  // the same client keeps its statements
+  server_session_.set_client_session(client_session1_);
+  ASSERT_EQ(100U, info.get_server_ps_id(1));
+  ASSERT_TRUE(info.is_server_text_ps_name_exist(7));
+  ASSERT_TRUE(server_session_.is_bound_to_client());
+
+  // without multiplex the session goes back to pool as before
+  get_global_proxy_config().enable_server_session_multiplex = false;
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+  get_global_proxy_config().enable_server_session_multiplex = true;
+
+  // another client never sees the ids of client 1
+  server_session_.set_client_session(client_session2_);
+  ASSERT_FALSE(info.is_ps_id_pair_exist(1));
+  ASSERT_FALSE(info.is_ps_id_pair_exist(2));
+  ASSERT_FALSE(info.is_server_text_ps_name_exist(7));
+  ASSERT_EQ(0U, info.get_server_ps_id());
+}
+
+TEST_F(TestServerSessionMultiplex, test_rebind_user_var_and_temp_table)
+{
+  ObServerSessionInfo &info = server_session_.session_info_;
+  server_session_.set_client_session(client_session1_);
+
+  // user variables can only be set to null on server, the session stays with client 1
+  info.set_user_var_version(1);
+  ASSERT_TRUE(server_session_.is_bound_to_client());
+  info.set_user_var_version(0);
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+
+  info.set_has_temp_table();
+  ASSERT_TRUE(server_session_.is_bound_to_client());
+  // the state is not cleared by rebinding, so such session is never released to pool
+  server_session_.set_client_session(client_session2_);
+  ASSERT_TRUE(server_session_.is_bound_to_client());
+  info.reset();
+  ASSERT_FALSE(server_session_.is_bound_to_client());
+}
+
+TEST_F(TestServerSessionMultiplex, test_create_temp_table)
+{
+  ASSERT_TRUE(ObMysqlServerSession::is_create_temp_table(ObString::make_string(
+      "create temporary table t1 (c1 int)")));
+  ASSERT_TRUE(ObMysqlServerSession::is_create_temp_table(ObString::make_string(
+      "  CREATE /* hint */ GLOBAL Temporary TABLE t1 as select 1")));
+  ASSERT_FALSE(ObMysqlServerSession::is_create_temp_table(ObString::make_string(
+      "create table temporary (c1 int)")));
+  ASSERT_FALSE(ObMysqlServerSession::is_create_temp_table(ObString::make_string(
+      "create table t1 (temporary int)")));
+  ASSERT_FALSE(ObMysqlServerSession::is_create_temp_table(ObString::make_string(
+      "create table temporary_t1 (c1 int)")));
+  ASSERT_FALSE(ObMysqlServerSession::is_create_temp_table(ObString()));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
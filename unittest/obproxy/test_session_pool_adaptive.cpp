@@ -0,0 +1,107 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#define protected public
+#include <gtest/gtest.h>
+#include "proxy/mysql/ob_mysql_session_pool_adaptive.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace proxy;
+
+class TestSessionPoolAdaptive : public ::testing::Test
+{
+public:
+  // one second of load: acquire_count acquires, each hold hold_us and every
+  // tenth acquire opens a new conn which costs connect_us
+  void feed(ObMysqlSessionPoolAdaptiveStat &stat, const int64_t acquire_count,
+            const int64_t hold_us, const int64_t connect_us)
+  {
+    for (int64_t i = 0; i < acquire_count; ++i) {
+      stat.on_acquire(0 != i % 10);
+      stat.on_release(hold_us);
+      if (0 == i % 10) {
+        stat.on_connect(connect_us);
+      }
+    }
+  }
+};
+
+static const int64_t BASE_TIME_US = 1000L * 1000000;
+
+TEST_F(TestSessionPoolAdaptive, test_first_round)
+{
+  ObMysqlSessionPoolAdaptiveStat stat;
+  feed(stat, 1000, 10000, 1000);
+  // first round only takes the snapshot
+  ASSERT_EQ(3, stat.calc_target_conn(BASE_TIME_US, 3, 0, 100));
+  ASSERT_EQ(2, stat.calc_target_conn(BASE_TIME_US, 0, 2, 100));
+}
+
+TEST_F(TestSessionPoolAdaptive, test_little_law)
+{
+  ObMysqlSessionPoolAdaptiveStat stat;
+  stat.calc_target_conn(BASE_TIME_US, 0, 0, 100);
+  feed(stat, 1000, 10000, 1000);
+  // busy = 1000/s * 10ms = 10, headroom 20% => 12, spare = 1000/s * 1ms = 1
+  ASSERT_EQ(13, stat.calc_target_conn(BASE_TIME_US + 1000000, 0, 0, 100));
+  ASSERT_EQ(1000, stat.get_acquire_rate());
+  ASSERT_EQ(10000, stat.get_avg_hold_time_us());
+  ASSERT_EQ(1000, stat.get_avg_connect_time_us());
+
+  // clamp by max conn and keep the conn in use
+  feed(stat, 1000, 10000, 1000);
+  ASSERT_EQ(5, stat.calc_target_conn(BASE_TIME_US + 2000000, 0, 0, 5));
+  feed(stat, 1000, 10000, 1000);
+  ASSERT_EQ(30, stat.calc_target_conn(BASE_TIME_US + 3000000, 30, 0, 100));
+}
+
+TEST_F(TestSessionPoolAdaptive, test_shrink)
+{
+  ObMysqlSessionPoolAdaptiveStat stat;
+  stat.calc_target_conn(BASE_TIME_US, 0, 0, 100);
+  feed(stat, 1000, 10000, 1000);
+  ASSERT_EQ(13, stat.calc_target_conn(BASE_TIME_US + 1000000, 0, 0, 100));
+  // extra = 27, shrink 25% each round
+  ASSERT_EQ(7, stat.calc_shrink_num(40, 30));
+  ASSERT_EQ(2, stat.calc_shrink_num(40, 2));
+  ASSERT_EQ(1, stat.calc_shrink_num(14, 10));
+  ASSERT_EQ(0, stat.calc_shrink_num(13, 10));
+  ASSERT_EQ(0, stat.calc_shrink_num(40, 0));
+}
+
+TEST_F(TestSessionPoolAdaptive, test_prewarm)
+{
+  ObMysqlSessionPoolAdaptiveStat stat;
+  const int64_t slot_us = ObMysqlSessionPoolAdaptiveStat::DAY_SLOT_SECONDS * 1000000;
+  const int64_t peak_time_us = BASE_TIME_US + 10 * slot_us;
+  stat.calc_target_conn(peak_time_us - 1000000, 0, 0, 100);
+  feed(stat, 1000, 10000, 1000);
+  ASSERT_EQ(13, stat.calc_target_conn(peak_time_us, 0, 0, 100));
+
+  // one day later, idle right before the peak slot
+  const int64_t next_day_us = peak_time_us + 24L * 3600 * 1000000 - slot_us;
+  ASSERT_EQ(13, stat.calc_target_conn(next_day_us, 0, 0, 100));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "obutils/ob_sql_digest.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obutils;
+
+static ObString calc_fingerprint(const char *sql, char *buf, uint64_t &hash, const bool is_ansi_quotes = false)
+{
+  int64_t length = 0;
+  hash = ObSqlFingerprint::calc(ObString::make_string(sql), is_ansi_quotes, buf,
+                                ObSqlFingerprint::MAX_FINGERPRINT_LENGTH, length);
+  return ObString(static_cast<int32_t>(length), buf);
+}
+
+TEST(TestSqlDigest, test_fingerprint)
+{
+  const char *cases[][2] = {
+    {"SELECT * FROM t1 WHERE id = 1", "select*from t1 where id=?"},
+    {"select  *\n from t1 where id='a''b' ;", "select*from t1 where id=?"},
+    {"select /*+ index(t1 i1) */ c1 from t1 where c2 in (1, 2, 3)", "select c1 from t1 where c2 in(?)"},
+    {"insert into t1 (c1, c2) values (1, 'x'), (2, \"y\")", "insert into t1(c1,c2)values(?)"},
+    {"insert into t1 values (1, now()), (2, now())", "insert into t1 values(?,now()),(?,now())"},
+    {"insert into t1 values (1), (2, now())", "insert into t1 values(?),(?,now())"},
+    {"select c1 from t1 where (c1, c2) in ((1, 2), (3, 4)) and c3 in (select 1)",
+     "select c1 from t1 where(c1,c2)in((?))and c3 in(select ?)"},
+    {"select c1 from `T1` where c2 > -1.5e+3 -- tail", "select c1 from `T1` where c2>?"},
+    {"select c1 - 1, c2 from t1 where c3 in (-1, - 2) limit 1", "select c1-?,c2 from t1 where c3 in(?)limit ?"},
+    {"select a, 1, b from t1 where c = ?", "select a,?,b from t1 where c=?"},
+  };
+  char buf[ObSqlFingerprint::MAX_FINGERPRINT_LENGTH];
+  for (int64_t i = 0; i < static_cast<int64_t>(sizeof(cases) / sizeof(cases[0])); ++i) {
+    uint64_t hash = 0;
+    ASSERT_EQ(ObString::make_string(cases[i][1]), calc_fingerprint(cases[i][0], buf, hash)) << cases[i][0];
+  }
+
+  uint64_t hash1 = 0;
+  uint64_t hash2 = 0;
+  calc_fingerprint("select c1 from t1 where c2 in (1,2)", buf, hash1);
+  calc_fingerprint("SELECT c1 FROM t1 WHERE c2 IN ('a', 'b', 'c', 'd')", buf, hash2);
+  ASSERT_EQ(hash1, hash2);
+  calc_fingerprint("insert into t1 values (1, 2)", buf, hash1);
+  calc_fingerprint("insert into t1 values (-1, 2), (3, 'a'), (5, 6)", buf, hash2);
+  ASSERT_EQ(hash1, hash2);
+}
+
+TEST(TestSqlDigest, test_fingerprint_ansi_quotes)
+{
+  char buf[ObSqlFingerprint::MAX_FINGERPRINT_LENGTH];
+  uint64_t hash = 0;
+  // "..." is a string literal in mysql mode
+  ASSERT_EQ(ObString::make_string("select*from t1 where c1=?"),
+            calc_fingerprint("select * from t1 where c1 = \"a\"", buf, hash, false));
+  // and an identifier in oracle mode or with ANSI_QUOTES
+  ASSERT_EQ(ObString::make_string("select*from \"T1\" where \"C1\"=?"),
+            calc_fingerprint("select * from \"T1\" where \"C1\" = 'a'", buf, hash, true));
+}
+
+TEST(TestSqlDigest, test_space_saving)
+{
+  ObSqlDigestTable table;
+  const int64_t item_limit = ObSqlDigestTable::PARTITION_COUNT * 4;
+  ASSERT_EQ(OB_SUCCESS, table.init(item_limit));
+  ObSqlDigestStat stat;
+  stat.exec_count_ = 1;
+  char sql[64];
+  // one heavy fingerprint among many light ones
+  for (int64_t i = 0; i < 1000; ++i) {
+    stat.total_time_us_ = 1000;
+    table.record(ObString::make_string("select * from heavy where id = 1"), false,
+                 ObString::make_string("tenant"), ObString::make_string("db"), stat);
+    stat.total_time_us_ = 1;
+    snprintf(sql, sizeof(sql), "select * from light_%ld", i);
+    table.record(ObString::make_string(sql), false, ObString::make_string("tenant"), ObString::make_string("db"), stat);
+  }
+
+  ObSqlDigestItem items[item_limit];
+  const int64_t count = table.copy_items(items, item_limit);
+  ASSERT_LE(count, item_limit);
+  bool found = false;
+  for (int64_t i = 0; i < count; ++i) {
+    if (ObString::make_string("select*from heavy where id=?") == items[i].get_fingerprint()) {
+      found = true;
+      ASSERT_EQ(1000, items[i].stat_.exec_count_);
+      ASSERT_EQ(1000 * 1000, items[i].stat_.total_time_us_);
+    }
+  }
+  ASSERT_TRUE(found);
+
+  // the heaviest one comes first
+  ASSERT_EQ(1, table.copy_items(items, 1));
+  ASSERT_EQ(ObString::make_string("select*from heavy where id=?"), items[0].get_fingerprint());
+  table.destroy();
+}
+
+TEST(TestSqlDigest, test_export_top)
+{
+  ObSqlDigestTable table;
+  const int64_t item_limit = ObSqlDigestTable::PARTITION_COUNT * 4;
+  ASSERT_EQ(OB_SUCCESS, table.init(item_limit));
+  ObSqlDigestStat stat;
+  stat.exec_count_ = 1;
+  char sql[64];
+  for (int64_t i = 0; i < 10; ++i) {
+    stat.total_time_us_ = (i + 1) * 100;
+    snprintf(sql, sizeof(sql), "select * from t_%ld", i);
+    table.record(ObString::make_string(sql), false, ObString::make_string("tenant"), ObString::make_string("db"), stat);
+  }
+
+  ObSqlDigestItem items[item_limit];
+  ASSERT_EQ(3, table.copy_items(items, 3, true));
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_GE(items[i].stat_.total_time_us_, 800);
+    ASSERT_EQ(1, items[i].stat_.exec_count_);
+  }
+  // nothing new since last export
+  ASSERT_EQ(0, table.copy_items(items, 3, true));
+
+  // the items not exported keep their stat till they are in top
+  stat.total_time_us_ = 10000;
+  table.record(ObString::make_string("select * from t_0"), false, ObString::make_string("tenant"),
+               ObString::make_string("db"), stat);
+  ASSERT_EQ(1, table.copy_items(items, 3, true));
+  ASSERT_EQ(ObString::make_string("select*from t_0"), items[0].get_fingerprint());
+  ASSERT_EQ(2, items[0].stat_.exec_count_);
+  ASSERT_EQ(10100, items[0].stat_.total_time_us_);
+  table.destroy();
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
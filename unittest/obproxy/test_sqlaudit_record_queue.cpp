@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include "cmd/ob_show_sqlaudit_handler.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace obmysql;
+using namespace net;
+using namespace proxy;
+
+static const int64_t MEMORY_SIZE = 2 * 1024 * 1024;
+static const int64_t SQL_LENGTH = 1000;
+
+class TestSqlauditRecordQueue : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    MEMSET(sql_buf_, 'a', sizeof(sql_buf_));
+  }
+
+  void enqueue(ObSqlauditRecordQueue &queue, const int64_t count, const int64_t sm_id)
+  {
+    ObCmdTimeStat cmd_time_stat;
+    ObIpEndpoint ip;
+    ObString sql(static_cast<int32_t>(sizeof(sql_buf_)), sql_buf_);
+    for (int64_t i = 0; i < count; ++i) {
+      queue.enqueue(sm_id, 0, cmd_time_stat, ip, sql, OB_MYSQL_COM_QUERY,
+                    ObString::make_string("sql_id"), ObString::make_string("route"), 1, 1);
+    }
+  }
+
+  // all records are read in the order of audit_id
+  void collect(ObSqlauditRecordQueue::Iterator &it, int64_t &count, int64_t &last_audit_id)
+  {
+    ObSqlauditRecord *record = NULL;
+    count = 0;
+    last_audit_id = -1;
+    ASSERT_EQ(OB_SUCCESS, it.open(ObString()));
+    ASSERT_FALSE(it.is_overlap());
+    while (NULL != (record = it.next())) {
+      if (count > 0) {
+        ASSERT_GT(record->audit_id_, last_audit_id);
+      }
+      last_audit_id = record->audit_id_;
+      ++count;
+    }
+  }
+
+  struct ObEnqueueArg
+  {
+    TestSqlauditRecordQueue *test_;
+    ObSqlauditRecordQueue *queue_;
+    int64_t count_;
+  };
+
+  static void *do_enqueue(void *arg)
+  {
+    ObEnqueueArg *enqueue_arg = static_cast<ObEnqueueArg *>(arg);
+    enqueue_arg->test_->enqueue(*enqueue_arg->queue_, enqueue_arg->count_, 2);
+    return NULL;
+  }
+
+  // enqueue in a new thread, which finds all rings claimed
+  void enqueue_in_late_thread(ObSqlauditRecordQueue &queue, const int64_t count)
+  {
+    pthread_t tid;
+    ObEnqueueArg arg = {this, &queue, count};
+    ASSERT_EQ(0, pthread_create(&tid, NULL, do_enqueue, &arg));
+    ASSERT_EQ(0, pthread_join(tid, NULL));
+  }
+
+public:
+  char sql_buf_[SQL_LENGTH];
+};
+
+TEST_F(TestSqlauditRecordQueue, test_ring_wrap)
+{
+  ObSqlauditRecordQueue queue;
+  ASSERT_EQ(OB_SUCCESS, queue.init(MEMORY_SIZE, 1));
+  ASSERT_EQ(MEMORY_SIZE / 2, queue.rings_[0].capacity_);
+
+  // the ring holds about 700 records, so it wraps several times
+  const int64_t total_count = 3000;
+  enqueue(queue, total_count, 1);
+  ASSERT_GT(queue.rings_[0].tail_, 2 * queue.rings_[0].capacity_);
+  ASSERT_EQ(0, queue.rings_[1].tail_);
+  ASSERT_EQ(0, queue.get_drop_count());
+
+  // only the newest records are left, and no one is broken
+  int64_t count = 0;
+  int64_t last_audit_id = 0;
+  ObSqlauditRecordQueue::Iterator all_it(queue, -1, total_count);
+  collect(all_it, count, last_audit_id);
+  ASSERT_GT(count, 0);
+  ASSERT_LT(count, queue.rings_[0].capacity_ / SQL_LENGTH);
+  ASSERT_EQ(total_count - 1, last_audit_id);
+
+  ObSqlauditRecordQueue::Iterator last_it(queue, -1, 10);
+  collect(last_it, count, last_audit_id);
+  ASSERT_EQ(10, count);
+  ASSERT_EQ(total_count - 1, last_audit_id);
+
+  // the overwritten records are gone
+  ObSqlauditRecordQueue::Iterator first_it(queue, 0, 10);
+  collect(first_it, count, last_audit_id);
+  ASSERT_EQ(0, count);
+}
+
+TEST_F(TestSqlauditRecordQueue, test_shared_ring_and_drop)
+{
+  ObSqlauditRecordQueue queue;
+  ASSERT_EQ(OB_SUCCESS, queue.init(MEMORY_SIZE, 1));
+
+  // the only ring is claimed by this thread, the late thread writes the shared ring
+  enqueue(queue, 1, 1);
+  enqueue_in_late_thread(queue, 10);
+  ASSERT_EQ(1, queue.claimed_ring_count_);
+  ASSERT_LT(0, queue.rings_[1].tail_);
+  ASSERT_EQ(0, queue.get_drop_count());
+
+  // the late thread never waits for the busy shared ring
+  ASSERT_EQ(OB_SUCCESS, queue.shared_ring_lock_.lock());
+  enqueue_in_late_thread(queue, 5);
+  ASSERT_EQ(OB_SUCCESS, queue.shared_ring_lock_.unlock());
+  ASSERT_EQ(5, queue.get_drop_count());
+  ASSERT_EQ(1, queue.claimed_ring_count_);
+
+  int64_t count = 0;
+  int64_t last_audit_id = 0;
+  ObSqlauditRecordQueue::Iterator it(queue, -1, 100);
+  collect(it, count, last_audit_id);
+  ASSERT_EQ(11, count);
+  ASSERT_EQ(10, last_audit_id);
+
+  ObSqlauditRecordQueue::Iterator sm_it(queue, 2);
+  collect(sm_it, count, last_audit_id);
+  ASSERT_EQ(10, count);
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,254 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <openssl/hmac.h>
+#include "iocore/net/ob_ssl_processor.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace net;
+
+static const int64_t TICKET_KEY_NAME_LEN = ObSSLTicketKey::TICKET_KEY_NAME_LEN;
+static const int64_t TICKET_BUF_LEN = 128;
+static const char TICKET_DATA[] = "the ssl session encrypted in ticket";
+
+// HMAC_CTX and SSL_SESSION are opaque since openssl 1.1
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+static HMAC_CTX *new_hmac_ctx()
+{
+  HMAC_CTX *ctx = static_cast<HMAC_CTX *>(OPENSSL_malloc(sizeof(HMAC_CTX)));
+  if (NULL != ctx) {
+    HMAC_CTX_init(ctx);
+  }
+  return ctx;
+}
+
+static void free_hmac_ctx(HMAC_CTX *ctx)
+{
+  HMAC_CTX_cleanup(ctx);
+  OPENSSL_free(ctx);
+}
+
+static void set_session_version(SSL_SESSION *session) { session->ssl_version = TLS1_2_VERSION; }
+#else
+static HMAC_CTX *new_hmac_ctx() { return HMAC_CTX_new(); }
+static void free_hmac_ctx(HMAC_CTX *ctx) { HMAC_CTX_free(ctx); }
+static void set_session_version(SSL_SESSION *session) { SSL_SESSION_set_protocol_version(session, TLS1_2_VERSION); }
+#endif
+
+// what openssl keeps in a session ticket: key name, iv, encrypted data and the mac
+struct ObTestTicket
+{
+  ObTestTicket() : data_len_(0), mac_len_(0)
+  {
+    memset(key_name_, 0, sizeof(key_name_));
+    memset(iv_, 0, sizeof(iv_));
+    memset(data_, 0, sizeof(data_));
+    memset(mac_, 0, sizeof(mac_));
+  }
+
+  unsigned char key_name_[TICKET_KEY_NAME_LEN];
+  unsigned char iv_[EVP_MAX_IV_LENGTH];
+  unsigned char data_[TICKET_BUF_LEN];
+  int data_len_;
+  unsigned char mac_[EVP_MAX_MD_SIZE];
+  unsigned int mac_len_;
+};
+
+class TestSSLSessionResumption : public ::testing::Test
+{
+public:
+  virtual void SetUp()
+  {
+    SSL_library_init();
+    cipher_ctx_ = EVP_CIPHER_CTX_new();
+    hmac_ctx_ = new_hmac_ctx();
+    ssl_ctx_ = SSL_CTX_new(SSLv23_client_method());
+    ASSERT_TRUE(NULL != cipher_ctx_);
+    ASSERT_TRUE(NULL != hmac_ctx_);
+    ASSERT_TRUE(NULL != ssl_ctx_);
+  }
+
+  virtual void TearDown()
+  {
+    for (int64_t i = 0; i < ObSSLProcessor::CLIENT_SESSION_CACHE_SIZE; ++i) {
+      ObSSLProcessor::ObSSLClientSession &item = g_ssl_processor.client_sessions_[i];
+      if (NULL != item.session_) {
+        SSL_SESSION_free(item.session_);
+        item.session_ = NULL;
+      }
+    }
+    SSL_CTX_free(ssl_ctx_);
+    free_hmac_ctx(hmac_ctx_);
+    EVP_CIPHER_CTX_free(cipher_ctx_);
+  }
+
+  // as openssl does when it issues a ticket
+  int seal_ticket(ObTestTicket &ticket)
+  {
+    int cb_ret = ObSSLProcessor::ticket_key_callback(NULL, ticket.key_name_, ticket.iv_,
+                                                     cipher_ctx_, hmac_ctx_, 1);
+    int final_len = 0;
+    if (cb_ret > 0) {
+      EXPECT_EQ(OB_SSL_SUCC_RET, EVP_EncryptUpdate(cipher_ctx_, ticket.data_, &ticket.data_len_,
+                                                   reinterpret_cast<const unsigned char *>(TICKET_DATA),
+                                                   static_cast<int>(sizeof(TICKET_DATA))));
+      EXPECT_EQ(OB_SSL_SUCC_RET, EVP_EncryptFinal_ex(cipher_ctx_, ticket.data_ + ticket.data_len_, &final_len));
+      ticket.data_len_ += final_len;
+      EXPECT_EQ(OB_SSL_SUCC_RET, HMAC_Update(hmac_ctx_, ticket.data_, ticket.data_len_));
+      EXPECT_EQ(OB_SSL_SUCC_RET, HMAC_Final(hmac_ctx_, ticket.mac_, &ticket.mac_len_));
+    }
+    return cb_ret;
+  }
+
+  // as openssl does when client resumes by a ticket, the data must be the same as sealed
+  int open_ticket(ObTestTicket &ticket)
+  {
+    unsigned char data[TICKET_BUF_LEN];
+    unsigned char mac[EVP_MAX_MD_SIZE];
+    unsigned int mac_len = 0;
+    int data_len = 0;
+    int final_len = 0;
+    int cb_ret = ObSSLProcessor::ticket_key_callback(NULL, ticket.key_name_, ticket.iv_,
+                                                     cipher_ctx_, hmac_ctx_, 0);
+    if (cb_ret > 0) {
+      EXPECT_EQ(OB_SSL_SUCC_RET, HMAC_Update(hmac_ctx_, ticket.data_, ticket.data_len_));
+      EXPECT_EQ(OB_SSL_SUCC_RET, HMAC_Final(hmac_ctx_, mac, &mac_len));
+      EXPECT_EQ(ticket.mac_len_, mac_len);
+      EXPECT_EQ(0, MEMCMP(ticket.mac_, mac, mac_len));
+      EXPECT_EQ(OB_SSL_SUCC_RET, EVP_DecryptUpdate(cipher_ctx_, data, &data_len, ticket.data_, ticket.data_len_));
+      EXPECT_EQ(OB_SSL_SUCC_RET, EVP_DecryptFinal_ex(cipher_ctx_, data + data_len, &final_len));
+      EXPECT_EQ(static_cast<int>(sizeof(TICKET_DATA)), data_len + final_len);
+      EXPECT_EQ(0, MEMCMP(TICKET_DATA, data, sizeof(TICKET_DATA)));
+    }
+    return cb_ret;
+  }
+
+  // SSL_set_session refuses a session without protocol version
+  SSL_SESSION *alloc_session()
+  {
+    SSL_SESSION *session = SSL_SESSION_new();
+    if (NULL != session) {
+      set_session_version(session);
+    }
+    return session;
+  }
+
+  // the resumed session of a new server link to @addr
+  SSL_SESSION *get_resumed_session(const ObIpEndpoint &addr)
+  {
+    SSL_SESSION *session = NULL;
+    SSL *ssl = SSL_new(ssl_ctx_);
+    if (NULL != ssl) {
+      g_ssl_processor.set_client_session(ssl, addr.sa_);
+      session = SSL_get_session(ssl);
+      EXPECT_EQ(&addr.sa_, SSL_get_app_data(ssl));
+      SSL_free(ssl);
+    }
+    return session;
+  }
+
+public:
+  EVP_CIPHER_CTX *cipher_ctx_;
+  HMAC_CTX *hmac_ctx_;
+  SSL_CTX *ssl_ctx_;
+};
+
+TEST_F(TestSSLSessionResumption, test_ticket_key_rotation)
+{
+  ObTestTicket old_ticket;
+  ObTestTicket new_ticket;
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.rotate_ticket_key_if_needed(true));
+  const int64_t key_idx = g_ssl_processor.current_ticket_key_;
+  // not rotated before the interval
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.rotate_ticket_key_if_needed(false));
+  ASSERT_EQ(key_idx, g_ssl_processor.current_ticket_key_);
+
+  ASSERT_EQ(1, seal_ticket(old_ticket));
+  ASSERT_EQ(0, MEMCMP(g_ssl_processor.ticket_keys_[key_idx].name_, old_ticket.key_name_, TICKET_KEY_NAME_LEN));
+  ASSERT_EQ(1, open_ticket(old_ticket));
+
+  // the ticket of the previous key is accepted and renewed
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.rotate_ticket_key_if_needed(true));
+  ASSERT_NE(key_idx, g_ssl_processor.current_ticket_key_);
+  ASSERT_EQ(2, open_ticket(old_ticket));
+  ASSERT_EQ(1, seal_ticket(new_ticket));
+  ASSERT_NE(0, MEMCMP(old_ticket.key_name_, new_ticket.key_name_, TICKET_KEY_NAME_LEN));
+  ASSERT_EQ(1, open_ticket(new_ticket));
+
+  // two rotations later, the ticket is ignored and a full handshake follows
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.rotate_ticket_key_if_needed(true));
+  ASSERT_EQ(key_idx, g_ssl_processor.current_ticket_key_);
+  ASSERT_EQ(0, open_ticket(old_ticket));
+  ASSERT_EQ(2, open_ticket(new_ticket));
+
+  // a half generated key never matches
+  g_ssl_processor.ticket_keys_[key_idx].create_time_us_ = 0;
+  MEMCPY(old_ticket.key_name_, g_ssl_processor.ticket_keys_[key_idx].name_, TICKET_KEY_NAME_LEN);
+  ASSERT_EQ(0, open_ticket(old_ticket));
+}
+
+TEST_F(TestSSLSessionResumption, test_client_session_cache)
+{
+  ObIpEndpoint addr;
+  ObIpEndpoint other_addr;
+  ops_ip4_set(addr, htonl(INADDR_LOOPBACK), htons(2881));
+  ASSERT_TRUE(NULL == get_resumed_session(addr));
+
+  SSL_SESSION *session = alloc_session();
+  ASSERT_TRUE(NULL != session);
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.save_client_session(addr.sa_, session));
+  ASSERT_EQ(session, get_resumed_session(addr));
+
+  // another address in the same slot never resumes the session
+  const int64_t slot = addr.hash() % ObSSLProcessor::CLIENT_SESSION_CACHE_SIZE;
+  for (in_port_t port = 2882; port < 65535; ++port) {
+    ops_ip4_set(other_addr, htonl(INADDR_LOOPBACK), htons(port));
+    if (slot == static_cast<int64_t>(other_addr.hash() % ObSSLProcessor::CLIENT_SESSION_CACHE_SIZE)) {
+      break;
+    }
+  }
+  ASSERT_EQ(slot, static_cast<int64_t>(other_addr.hash() % ObSSLProcessor::CLIENT_SESSION_CACHE_SIZE));
+  ASSERT_TRUE(NULL == get_resumed_session(other_addr));
+
+  // a new session of the address replaces the old one
+  SSL_SESSION *new_session = alloc_session();
+  ASSERT_TRUE(NULL != new_session);
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.save_client_session(addr.sa_, new_session));
+  ASSERT_EQ(new_session, get_resumed_session(addr));
+
+  // the slot is taken by the other address at last
+  SSL_SESSION *other_session = alloc_session();
+  ASSERT_TRUE(NULL != other_session);
+  ASSERT_EQ(OB_SUCCESS, g_ssl_processor.save_client_session(other_addr.sa_, other_session));
+  ASSERT_EQ(other_session, get_resumed_session(other_addr));
+  ASSERT_TRUE(NULL == get_resumed_session(addr));
+
+  ObIpEndpoint invalid_addr;
+  ASSERT_EQ(OB_INVALID_ARGUMENT, g_ssl_processor.save_client_session(addr.sa_, NULL));
+  ASSERT_EQ(OB_INVALID_ARGUMENT, g_ssl_processor.save_client_session(invalid_addr.sa_, other_session));
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
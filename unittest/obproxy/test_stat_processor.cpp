@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#define private public
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include "iocore/eventsystem/ob_ethread.h"
+#include "iocore/eventsystem/ob_event_processor.h"
+#include "stat/ob_stat_processor.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace event;
+
+static const int64_t THREAD_COUNT = 2;
+static const int64_t STAT_COUNT = 2;
+static const int64_t INC_COUNT = 10000;
+
+// the owner thread bumps its stat cells, each by one per round
+static void *inc_stat_cells(void *arg)
+{
+  ObRecRawStat *thread_stats = static_cast<ObRecRawStat *>(arg);
+  for (int64_t i = 0; i < INC_COUNT; ++i) {
+    for (int64_t id = 0; id < STAT_COUNT; ++id) {
+      thread_stats[id].sum_ += id + 1;
+      thread_stats[id].count_ += 1;
+    }
+  }
+  return NULL;
+}
+
+TEST(TestStatProcessor, test_thread_private_padding)
+{
+  const int64_t private_end = offsetof(ObEThread, thread_private_) + ObEThread::MAX_THREAD_DATA_SIZE;
+  // nothing written by other threads within a cache line of the stat cells
+  ASSERT_GE(static_cast<int64_t>(offsetof(ObEThread, event_queue_external_)) - private_end,
+            static_cast<int64_t>(CACHE_ALIGN_SIZE));
+}
+
+TEST(TestStatProcessor, test_sync_epoch)
+{
+  char *ethread_bufs[THREAD_COUNT];
+  ObRecRawStat *thread_stats[THREAD_COUNT];
+  pthread_t tids[THREAD_COUNT];
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    ethread_bufs[i] = static_cast<char *>(ob_malloc_align(CACHE_ALIGN_SIZE, sizeof(ObEThread), ObModIds::TEST));
+    ASSERT_TRUE(NULL != ethread_bufs[i]);
+    MEMSET(ethread_bufs[i], 0, sizeof(ObEThread));
+    g_event_processor.all_event_threads_[i] = reinterpret_cast<ObEThread *>(ethread_bufs[i]);
+    thread_stats[i] = reinterpret_cast<ObRecRawStat *>(ethread_bufs[i] + offsetof(ObEThread, thread_private_));
+  }
+  g_event_processor.event_thread_count_ = THREAD_COUNT;
+
+  ObRecRawStat globals[STAT_COUNT];
+  ObRecRawStat *global_ptrs[STAT_COUNT];
+  ObRecRawStat snapshot[STAT_COUNT];
+  MEMSET(globals, 0, sizeof(globals));
+  for (int64_t id = 0; id < STAT_COUNT; ++id) {
+    global_ptrs[id] = &globals[id];
+  }
+  ObRecRawStatBlock rsb;
+  rsb.ethr_stat_offset_ = offsetof(ObEThread, thread_private_);
+  rsb.global_ = global_ptrs;
+  rsb.max_stats_ = STAT_COUNT;
+  rsb.num_stats_ = STAT_COUNT;
+  rsb.snapshot_ = snapshot;
+  rsb.snapshot_epoch_ = -1;
+
+  // every thread only writes its own cells
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    ASSERT_EQ(0, pthread_create(&tids[i], NULL, inc_stat_cells, thread_stats[i]));
+  }
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    ASSERT_EQ(0, pthread_join(tids[i], NULL));
+  }
+
+  // all stats of the block are summed once in the new epoch
+  (void)ATOMIC_FAA(&g_stat_processor.sync_epoch_, 1);
+  ObRecRawStat total;
+  for (int64_t id = 0; id < STAT_COUNT; ++id) {
+    ASSERT_EQ(OB_SUCCESS, ObStatProcessor::sync_raw_stat_to_global(&rsb, id));
+    ASSERT_EQ(g_stat_processor.sync_epoch_, rsb.snapshot_epoch_);
+    ASSERT_EQ(THREAD_COUNT * INC_COUNT * (id + 1), globals[id].sum_);
+    ASSERT_EQ(THREAD_COUNT * INC_COUNT, globals[id].count_);
+    ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, id, total));
+    ASSERT_EQ(globals[id].sum_, total.sum_);
+  }
+
+  // a sync in the same epoch reuses the snapshot, the next epoch sums again
+  thread_stats[0][0].sum_ += 5;
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::sync_raw_stat_to_global(&rsb, 0));
+  ASSERT_EQ(THREAD_COUNT * INC_COUNT, globals[0].sum_);
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(THREAD_COUNT * INC_COUNT + 5, total.sum_);
+  (void)ATOMIC_FAA(&g_stat_processor.sync_epoch_, 1);
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::sync_raw_stat_to_global(&rsb, 0));
+  ASSERT_EQ(THREAD_COUNT * INC_COUNT + 5, globals[0].sum_);
+  ASSERT_EQ(THREAD_COUNT * INC_COUNT, globals[0].count_);
+
+  for (int64_t i = 0; i < THREAD_COUNT; ++i) {
+    g_event_processor.all_event_threads_[i] = NULL;
+    ob_free_align(ethread_bufs[i]);
+  }
+  g_event_processor.event_thread_count_ = 0;
+}
+
+TEST(TestStatProcessor, test_clear_raw_stat)
+{
+  char *ethread_buf = static_cast<char *>(ob_malloc_align(CACHE_ALIGN_SIZE, sizeof(ObEThread), ObModIds::TEST));
+  ASSERT_TRUE(NULL != ethread_buf);
+  MEMSET(ethread_buf, 0, sizeof(ObEThread));
+  g_event_processor.all_event_threads_[0] = reinterpret_cast<ObEThread *>(ethread_buf);
+  g_event_processor.event_thread_count_ = 1;
+
+  ObRecRawStat global;
+  ObRecRawStat *global_ptr = &global;
+  ObRecRawStatBlock rsb;
+  rsb.ethr_stat_offset_ = offsetof(ObEThread, thread_private_);
+  rsb.global_ = &global_ptr;
+  rsb.max_stats_ = 1;
+  rsb.num_stats_ = 1;
+  rsb.snapshot_epoch_ = -1;
+  ObRecRawStat *thread_stat = reinterpret_cast<ObRecRawStat *>(ethread_buf + rsb.ethr_stat_offset_);
+  ObRecRawStat total;
+
+  // 100 and 7 synced to global, the thread has done 10 and 3 since then
+  global.sum_ = 100;
+  global.count_ = 7;
+  global.last_sum_ = 4;
+  global.last_count_ = 1;
+  thread_stat->sum_ = 14;
+  thread_stat->count_ = 4;
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(110, total.sum_);
+  ASSERT_EQ(10, total.count_);
+
+  // clearing sum keeps count, the baseline cleared count_ here by mistake
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::clear_raw_stat_sum(&rsb, 0));
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(0, total.sum_);
+  ASSERT_EQ(10, total.count_);
+  // the thread cell is not written by the clearing thread
+  ASSERT_EQ(14, thread_stat->sum_);
+  thread_stat->sum_ += 5;
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(5, total.sum_);
+
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::set_raw_stat_sum(&rsb, 0, 50));
+  thread_stat->sum_ += 2;
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(52, total.sum_);
+  ASSERT_EQ(10, total.count_);
+
+  // and clearing count keeps sum
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::clear_raw_stat_count(&rsb, 0));
+  thread_stat->count_ += 1;
+  ASSERT_EQ(OB_SUCCESS, ObStatProcessor::get_raw_stat_total(&rsb, 0, total));
+  ASSERT_EQ(52, total.sum_);
+  ASSERT_EQ(1, total.count_);
+
+  g_event_processor.all_event_threads_[0] = NULL;
+  g_event_processor.event_thread_count_ = 0;
+  ob_free_align(ethread_buf);
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2021 OceanBase
+ * OceanBase Database Proxy(ODP) is licensed under Mulan PubL v2.
+ * You can use this software according to the terms and conditions of the Mulan PubL v2.
+ * You may obtain a copy of Mulan PubL v2 at:
+ *          http://license.coscl.org.cn/MulanPubL-2.0
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PubL v2 for more details.
+ */
+
+#include <gtest/gtest.h>
+#include "iocore/eventsystem/ob_timer_wheel.h"
+
+namespace oceanbase
+{
+namespace obproxy
+{
+using namespace common;
+using namespace event;
+
+class TestTimerEntry : public ObTimerWheelEntry
+{
+public:
+  TestTimerEntry() : fired_at_(0), fired_count_(0) {}
+  virtual void handle_timeout(const ObHRTime now)
+  {
+    fired_at_ = now;
+    ++fired_count_;
+  }
+
+  ObHRTime fired_at_;
+  int64_t fired_count_;
+};
+
+static ObHRTime align_now()
+{
+  return get_hrtime_internal() / ObTimerWheel::WHEEL_TICK * ObTimerWheel::WHEEL_TICK;
+}
+
+TEST(TestTimerWheel, test_arm_cancel)
+{
+  static const int64_t ENTRY_COUNT = 20000;
+  ObTimerWheel wheel;
+  TestTimerEntry *entries = new TestTimerEntry[ENTRY_COUNT];
+  const ObHRTime start = align_now();
+  srand(1);
+  for (int64_t i = 0; i < ENTRY_COUNT; ++i) {
+    // from a few ticks to all levels
+    const ObHRTime delay = HRTIME_MSECONDS(rand() % 5000) * ((0 == i % 7) ? 100 : 1);
+    wheel.arm(entries[i], start + delay);
+  }
+  for (int64_t i = 0; i < ENTRY_COUNT; i += 3) {
+    wheel.cancel(entries[i]);
+    ASSERT_FALSE(entries[i].is_armed());
+  }
+  for (int64_t i = 1; i < ENTRY_COUNT; i += 5) {
+    wheel.arm(entries[i], start + HRTIME_MSECONDS(rand() % 3000));
+  }
+
+  for (ObHRTime now = start; now <= start + HRTIME_SECONDS(600); now += HRTIME_MSECONDS(7)) {
+    wheel.advance(now);
+  }
+  ASSERT_EQ(0, wheel.get_entry_count());
+  ASSERT_EQ(HRTIME_FOREVER, wheel.earliest_timeout());
+  for (int64_t i = 0; i < ENTRY_COUNT; ++i) {
+    if (0 == i % 3 && 1 != i % 5) {
+      ASSERT_EQ(0, entries[i].fired_count_);
+    } else {
+      ASSERT_EQ(1, entries[i].fired_count_);
+      ASSERT_GE(entries[i].fired_at_, entries[i].get_timeout_at());
+      ASSERT_LE(entries[i].fired_at_, entries[i].get_timeout_at() + 2 * ObTimerWheel::WHEEL_TICK);
+    }
+  }
+  delete [] entries;
+}
+
+TEST(TestTimerWheel, test_beyond_wheel)
+{
+  ObTimerWheel wheel;
+  TestTimerEntry entry;
+  const ObHRTime start = align_now();
+  const int64_t wheel_ticks = 1L << (ObTimerWheel::WHEEL_LEVEL_COUNT * ObTimerWheel::WHEEL_SLOT_BITS);
+  const ObHRTime timeout_at = start + (wheel_ticks + 100) * ObTimerWheel::WHEEL_TICK;
+  wheel.arm(entry, timeout_at);
+  ASSERT_EQ(0, wheel.advance(start + wheel_ticks * ObTimerWheel::WHEEL_TICK));
+  ASSERT_TRUE(entry.is_armed());
+  ASSERT_EQ(0, wheel.advance(timeout_at - ObTimerWheel::WHEEL_TICK));
+  ASSERT_EQ(1, wheel.advance(timeout_at));
+  ASSERT_EQ(1, entry.fired_count_);
+}
+
+TEST(TestTimerWheel, test_idle_cost)
+{
+  // idle connections only cost the re-arm on activity, not a walk every second
+  static const int64_t ENTRY_COUNT = 200000;
+  ObTimerWheel wheel;
+  TestTimerEntry *entries = new TestTimerEntry[ENTRY_COUNT];
+  ObHRTime now = align_now();
+  for (int64_t i = 0; i < ENTRY_COUNT; ++i) {
+    wheel.arm(entries[i], now + HRTIME_SECONDS(1800));
+  }
+
+  const ObHRTime begin = get_hrtime_internal();
+  for (int64_t i = 0; i < 100 * 60; ++i) {
+    now += HRTIME_MSECONDS(10);
+    wheel.advance(now);
+  }
+  const ObHRTime advance_cost = get_hrtime_internal() - begin;
+  for (int64_t i = 0; i < ENTRY_COUNT; ++i) {
+    wheel.arm(entries[i], now + HRTIME_SECONDS(1800));
+  }
+  const ObHRTime rearm_cost = get_hrtime_internal() - begin - advance_cost;
+  printf("%ld idle entries, one minute of ticks cost %ldus, re-arm cost %ldns per entry\n",
+         ENTRY_COUNT, hrtime_to_usec(advance_cost), rearm_cost / ENTRY_COUNT);
+  ASSERT_EQ(ENTRY_COUNT, wheel.get_entry_count());
+  for (int64_t i = 0; i < ENTRY_COUNT; ++i) {
+    wheel.cancel(entries[i]);
+  }
+  ASSERT_EQ(0, wheel.get_entry_count());
+  delete [] entries;
+}
+
+} // end of namespace obproxy
+} // end of namespace oceanbase
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}